@@ -73,6 +73,17 @@ bool gosExitGameOS() {
     return g_gos_exit_game_os;
 }
 
+static bool g_gos_headless = false;
+
+void gosSetHeadless(bool headless) {
+    g_gos_headless = headless;
+}
+
+bool __stdcall gos_IsHeadless()
+{
+    return g_gos_headless;
+}
+
 float frameRate = 30.0f; // apparently tiny geometry needs this
 
 __int64 __stdcall GetCycles()
@@ -129,113 +140,6 @@ double __stdcall gos_GetHiResTime()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-static const int g_hepsStackSize = 128;
-static gos_Heap* g_heapsStack[g_hepsStackSize];
-static int g_heapStackPointer = -1;
-
-////////////////////////////////////////////////////////////////////////////////
-HGOSHEAP __stdcall gos_CreateMemoryHeap(char const* HeapName, DWORD MaximumSize/* = 0*/, HGOSHEAP parentHeap/* = ParentClientHeap*/)
-{
-    gos_Heap* pheap = new gos_Heap();
-    memset(pheap, 0, sizeof(gos_Heap));
-    pheap->pParent = parentHeap;
-    pheap->Magic = (DWORD)(reinterpret_cast<size_t>(HeapName) & 0xffffffff);
-    if(HeapName) {
-        strncpy(pheap->Name, HeapName, sizeof(pheap->Name)-1);
-        pheap->Name[sizeof(pheap->Name)-1] = '\0';
-    }
-
-#ifdef LAB_ONLY
-    pheap->BytesAllocated = 0;
-    pheap->MaximumSize = MaximumSize;
-#endif
-
-    return pheap;
-}
-void __stdcall gos_DestroyMemoryHeap(HGOSHEAP Heap, bool shouldBeEmpty/* = true*/)
-{
-    // shouldBeEmpty ?? should Instances be zero or what?
-    delete Heap;
-    Heap = nullptr;
-}
-void __stdcall gos_PushCurrentHeap(HGOSHEAP Heap)
-{
-    gosASSERT(g_heapStackPointer < g_hepsStackSize);
-    g_heapsStack[++g_heapStackPointer] = Heap;
-}
-void __stdcall gos_PopCurrentHeap()
-{
-    gosASSERT(g_heapStackPointer >= 0 && g_heapStackPointer < g_hepsStackSize);
-    g_heapsStack[g_heapStackPointer--] = nullptr;
-}
-
-HGOSHEAP __stdcall gos_GetCurrentHeap()
-{
-    if(g_heapStackPointer == -1)
-        return NULL;
-    return g_heapsStack[g_heapStackPointer];
-}
-
-void __stdcall gos_WalkMemoryHeap(HGOSHEAP pHeap, bool vociferous/* = false*/)
-{
-
-}
-
-////////////////////////////////////////////////////////////////////////////////
-void* operator new(size_t sz) {
-    return gos_Malloc(sz, NULL);
-}
-void operator delete(void* ptr)
-#ifndef PLATFORM_WINDOWS
-noexcept 
-#endif
-{
-    gos_Free(ptr);
-}
-
-void* __cdecl operator new[](size_t size, HGOSHEAP Heap)
-{
-    return malloc(size);
-}
-
-void* __stdcall gos_Malloc(size_t bytes, HGOSHEAP Heap/* = 0*/)
-{
-    // FIXME: TODO: !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-    // FIXME: TODO: each malloc should record memory allocation for current heap on a stack
-    // FIXME: TODO: so that when Heap destroy() is called all memory will be freed
-
-    /*
-    gosHeap* heap = NULL;
-
-    if(Heap) {
-        heap = (gosHeap*)Heap;
-    } else { 
-        heap = gos_GetCurrentHeap();
-    }
-
-    if(heap)
-        heap->BytesAllocated += bytes;
-
-    if(bytes > 1024*1024)
-    {
-        PAUSE((""));
-    }
-    */
-    return malloc(bytes);
-}
-void __stdcall gos_Free(void* ptr)
-{
-    /*
-    gosHeap* heap = (gosHeap*)gos_GetCurrentHeap();
-    if(Heap) {
-        gosHeap* heap = (gosHeap*)Heap;
-        heap->BytesAllocated -= // ??? ;
-    }
-    */
-    free(ptr);
-}
-////////////////////////////////////////////////////////////////////////////////
-
 void __stdcall gos_srand(unsigned int seed)
 {
     return srand(seed);
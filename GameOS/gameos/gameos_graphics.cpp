@@ -6,6 +6,7 @@
 #include "gameos.hpp"
 #include "font3d.hpp"
 #include "gos_font.h"
+#include "gos_cmdbuffer.h"
 
 #ifdef LINUX_BUILD
 #include <cstdarg>
@@ -645,6 +646,135 @@ void gosMesh::drawIndexed(HGOSBUFFER ib, HGOSBUFFER vb, HGOSVERTEXDECLARATION vd
 
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Ring buffer which batched draws stream their vertices / indices through.
+// With ARB_buffer_storage it stays persistently mapped and is split in chunks,
+// each guarded by a fence, so that we never write over data GPU may still read,
+// otherwise every write maps just the needed range unsynchronized and buffer is
+// orphaned on wrap (GL 3.0 minimum, so we can't rely on the former).
+class gosStreamBuffer {
+    public:
+        static gosStreamBuffer* make(GLenum target, uint32_t size) {
+
+            gosStreamBuffer* sb = new gosStreamBuffer(target, size);
+
+            glGenBuffers(1, &sb->buffer_);
+            glBindBuffer(target, sb->buffer_);
+
+            if(GLEW_ARB_buffer_storage && GLEW_ARB_sync) {
+                const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                glBufferStorage(target, size, NULL, flags);
+                sb->persistent_ptr_ = (uint8_t*)glMapBufferRange(target, 0, size, flags);
+            }
+
+            if(!sb->persistent_ptr_)
+                glBufferData(target, size, NULL, GL_STREAM_DRAW);
+
+            glBindBuffer(target, 0);
+            CHECK_GL_ERROR;
+
+            return sb;
+        }
+
+        static void destroy(gosStreamBuffer* sb) {
+            gosASSERT(sb);
+            for(int i=0; i<NUM_CHUNKS; ++i) {
+                if(sb->fences_[i])
+                    glDeleteSync(sb->fences_[i]);
+            }
+            if(sb->persistent_ptr_) {
+                glBindBuffer(sb->target_, sb->buffer_);
+                glUnmapBuffer(sb->target_);
+                glBindBuffer(sb->target_, 0);
+            }
+            glDeleteBuffers(1, &sb->buffer_);
+            delete sb;
+        }
+
+        uint32_t getMaxWriteSize() const { return size_ / NUM_CHUNKS; }
+        GLuint getBuffer() const { return buffer_; }
+        bool isPersistent() const { return persistent_ptr_ != NULL; }
+
+        // returns where to write num_bytes, *offset receives position of the data in buffer
+        void* map(uint32_t num_bytes, uint32_t alignment, uint32_t* offset) {
+            gosASSERT(num_bytes > 0 && num_bytes <= getMaxWriteSize());
+            gosASSERT(!mapped_);
+
+            uint32_t start = ((head_ + alignment - 1) / alignment) * alignment;
+            bool wrap = start + num_bytes > size_;
+            if(wrap)
+                start = 0;
+
+            head_ = start + num_bytes;
+            *offset = start;
+
+            if(persistent_ptr_) {
+                // fence chunks we are leaving (all draws using them were already issued)
+                // and wait until GPU is done with the ones we are entering
+                const int last_chunk = (int)((start + num_bytes - 1) / getMaxWriteSize());
+                while(cur_chunk_ != last_chunk) {
+                    fences_[cur_chunk_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                    cur_chunk_ = (cur_chunk_ + 1) % NUM_CHUNKS;
+                    waitChunk(cur_chunk_);
+                }
+                return persistent_ptr_ + start;
+            }
+
+            glBindBuffer(target_, buffer_);
+            if(wrap)
+                glBufferData(target_, size_, NULL, GL_STREAM_DRAW);
+            void* ptr = glMapBufferRange(target_, start, num_bytes,
+                    GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+            gosASSERT(ptr);
+            mapped_ = true;
+            return ptr;
+        }
+
+        void unmap() {
+            if(!mapped_)
+                return;
+            glUnmapBuffer(target_);
+            glBindBuffer(target_, 0);
+            mapped_ = false;
+        }
+
+    private:
+        static const int NUM_CHUNKS = 4;
+
+        gosStreamBuffer(GLenum target, uint32_t size)
+            : target_(target)
+            , buffer_(0)
+            , size_(size)
+            , head_(0)
+            , persistent_ptr_(NULL)
+            , cur_chunk_(0)
+            , mapped_(false)
+        {
+            memset(fences_, 0, sizeof(fences_));
+        }
+
+        void waitChunk(int chunk) {
+            if(!fences_[chunk])
+                return;
+            GLenum rv;
+            do {
+                rv = glClientWaitSync(fences_[chunk], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            } while(rv == GL_TIMEOUT_EXPIRED);
+            gosASSERT(rv != GL_WAIT_FAILED);
+            glDeleteSync(fences_[chunk]);
+            fences_[chunk] = 0;
+        }
+
+        GLenum target_;
+        GLuint buffer_;
+        uint32_t size_;
+        uint32_t head_;
+        uint8_t* persistent_ptr_;
+        int cur_chunk_;
+        GLsync fences_[NUM_CHUNKS];
+        bool mapped_;
+};
+
 
 
 class gosTexture {
@@ -707,6 +837,7 @@ class gosTexture {
         }
 
         bool createHardwareTexture();
+        bool createHardwareTexture(const Image& img);
 
         ~gosTexture() {
 
@@ -862,6 +993,14 @@ static gos_TextureFormat convertIfNecessary(Image& img, gos_TextureFormat gos_fo
     return gos_format;
 }
 
+// image must already have gone through convertIfNecessary
+bool gosTexture::createHardwareTexture(const Image& img) {
+
+    TexFormat tf = img.getFormat() == FORMAT_RGB8 ? TF_RGB8 : TF_RGBA8;
+    tex_ = create2DTexture(img.getWidth(), img.getHeight(), tf, img.getPixels());
+    return tex_.isValid();
+}
+
 bool gosTexture::createHardwareTexture() {
 
     if(!is_from_memory_) {
@@ -948,6 +1087,8 @@ class gosFont {
         uint32_t decRef() { gosASSERT(ref_count_>0); return --ref_count_; }
 
     private:
+        friend class gosNullRenderer;
+
         static uint32_t destroy(gosFont* font);
         gosFont():font_name_(0), font_id_(0), tex_id_(0), ref_count_(1) {};
         ~gosFont();
@@ -1079,13 +1220,16 @@ class gosRenderer {
             // FIXME: bad use object list, with stable ids
             // to not waste space
             gosASSERT(textureList_.size() > texture_id);
+            // recorded draws may still use it
+            flush();
             delete textureList_[texture_id];
             textureList_[texture_id] = 0;
         }
 
         uint32_t getFlagsFromStates()
         {
-            return curStates_[gos_State_AlphaTest] ? SHADER_FLAG_INDEX_TO_MASK(gosGLOBAL_SHADER_FLAGS::ALPHA_TEST) : 0;
+            // states of the draw which is going to be issued, curStates_ are only updated on flush
+            return renderStates_[gos_State_AlphaTest] ? SHADER_FLAG_INDEX_TO_MASK(gosGLOBAL_SHADER_FLAGS::ALPHA_TEST) : 0;
         }
 
         gosRenderMaterial* getRenderMaterial(const char* name) {
@@ -1164,6 +1308,8 @@ class gosRenderer {
 		void drawIndexedTris(HGOSBUFFER ib, HGOSBUFFER vb, HGOSVERTEXDECLARATION vdecl, const float* mvp);
 		void drawIndexedTris(HGOSBUFFER ib, HGOSBUFFER vb, HGOSVERTEXDECLARATION vdecl);
         void drawText(const char* text);
+        // draws recorded after this are not reordered with ones before
+        void drawBarrier() { cmd_buffer_->barrier(); }
 
         void beginFrame();
         void endFrame();
@@ -1178,6 +1324,12 @@ class gosRenderer {
         void setBreakOnDrawCall(bool b_break) { break_on_draw_call_ = b_break; }
         bool getBreakOnDrawCall() { return break_on_draw_call_; }
         void setBreakDrawCall(uint32_t num) { break_draw_call_num_ = num; }
+        void setSortDrawCalls(bool b_sort) { sort_draw_calls_ = b_sort; }
+        bool getSortDrawCalls() { return sort_draw_calls_; }
+        void captureFrame(const char* fname);
+        // immediate draws recorded / GL draws issued for them in last frame
+        uint32_t getNumRecordedDrawCalls() { return last_num_recorded_; }
+        uint32_t getNumBatches() { return last_num_batches_; }
 
         graphics::RenderContextHandle getRenderContextHandle() { return ctx_h_; }
 
@@ -1193,6 +1345,10 @@ class gosRenderer {
         bool beforeDrawCall();
         void afterDrawCall();
 
+        uint32_t getMaterialId(gosRenderMaterial* material) const;
+        void recordDraw(gosCommandBuffer::PrimType prim, gosRenderMaterial* material, gos_VERTEX* vertices, int num_vertices, WORD* indices = NULL, int num_indices = 0);
+        void drawBatch(const gosCommandBuffer::Batch& batch);
+
         // render target size
         int width_;
         int height_;
@@ -1258,11 +1414,18 @@ class gosRenderer {
 
 		vec4 render_viewport_;
         
-        gosMesh* quads_;
-        gosMesh* tris_;
-        gosMesh* indexed_tris_;
-        gosMesh* lines_;
-        gosMesh* points_;
+        // immediate draws are recorded here and drawn on flush()
+        gosCommandBuffer* cmd_buffer_;
+        gosStreamBuffer* stream_vb_;
+        gosStreamBuffer* stream_ib_;
+        bool sort_draw_calls_;
+        uint32_t num_recorded_;
+        uint32_t num_batches_;
+        uint32_t last_num_recorded_;
+        uint32_t last_num_batches_;
+        gosCommandBuffer* frame_capture_;
+        char* frame_capture_fname_;
+
         gosMesh* text_;
         gosRenderMaterial* basic_material_;
         gosRenderMaterial* basic_tex_material_;
@@ -1280,6 +1443,13 @@ class gosRenderer {
 
 const std::string gosRenderer::s_Foreground = std::string("Foreground");
 
+// same limit as per draw mesh capacity used to have
+static const int MAX_DRAW_VERTICES = 1024*10;
+static const uint32_t MAX_RECORDED_VERTICES = 1024*64;
+static const uint32_t MAX_RECORDED_INDICES = 1024*96;
+static const uint32_t STREAM_VB_SIZE = 4*1024*1024;
+static const uint32_t STREAM_IB_SIZE = 1024*1024;
+
 static GLuint gVAO = 0;
 
 void gosRenderer::init() {
@@ -1299,16 +1469,17 @@ void gosRenderer::init() {
     // setup viewport
     setupViewport(true, 1.0f, true, 0, 0.0f, 0.0f, 1.0f, 1.0f);
 
-    quads_ = gosMesh::makeMesh(PRIMITIVE_TRIANGLELIST, 1024*10);
-    gosASSERT(quads_);
-    tris_ = gosMesh::makeMesh(PRIMITIVE_TRIANGLELIST, 1024*10);
-    gosASSERT(tris_);
-    indexed_tris_ = gosMesh::makeMesh(PRIMITIVE_TRIANGLELIST, 1024*10, 1024*10);
-    gosASSERT(indexed_tris_);
-    lines_ = gosMesh::makeMesh(PRIMITIVE_LINELIST, 1024*10);
-    gosASSERT(lines_);
-    points_= gosMesh::makeMesh(PRIMITIVE_POINTLIST, 1024*10);
-    gosASSERT(points_);
+    cmd_buffer_ = new gosCommandBuffer(MAX_RECORDED_VERTICES, MAX_RECORDED_INDICES);
+    stream_vb_ = gosStreamBuffer::make(GL_ARRAY_BUFFER, STREAM_VB_SIZE);
+    stream_ib_ = gosStreamBuffer::make(GL_ELEMENT_ARRAY_BUFFER, STREAM_IB_SIZE);
+    SPEW(("GRAPHICS", "Streaming batched draws through %s buffers\n",
+                stream_vb_->isPersistent() ? "persistently mapped" : "mapped"));
+    sort_draw_calls_ = true;
+    num_recorded_ = num_batches_ = 0;
+    last_num_recorded_ = last_num_batches_ = 0;
+    frame_capture_ = NULL;
+    frame_capture_fname_ = NULL;
+
     text_ = gosMesh::makeMesh(PRIMITIVE_TRIANGLELIST, 4024 * 6);
     gosASSERT(text_);
 
@@ -1371,11 +1542,8 @@ void gosRenderer::init() {
 
 void gosRenderer::destroy() {
 
-    gosMesh::destroy(quads_);
-    gosMesh::destroy(tris_);
-    gosMesh::destroy(indexed_tris_);
-    gosMesh::destroy(lines_);
-    gosMesh::destroy(points_);
+    flush();
+
     gosMesh::destroy(text_);
 
     for(size_t i=0; i<fontList_.size(); i++) {
@@ -1394,6 +1562,13 @@ void gosRenderer::destroy() {
     }
     textureList_.clear();
 
+    // fonts and textures flush on delete, so keep these till the end
+    delete cmd_buffer_;
+    delete frame_capture_;
+    delete[] frame_capture_fname_;
+    gosStreamBuffer::destroy(stream_vb_);
+    gosStreamBuffer::destroy(stream_ib_);
+
     glDeleteVertexArrays(1, &gVAO);
 
 }
@@ -1585,10 +1760,26 @@ void gosRenderer::beginFrame()
 {
     glBindVertexArray(gVAO);
     num_draw_calls_ = 0;
+    num_recorded_ = 0;
+    num_batches_ = 0;
 }
 
 void gosRenderer::endFrame()
 {
+    flush();
+
+    last_num_recorded_ = num_recorded_;
+    last_num_batches_ = num_batches_;
+
+    if(frame_capture_) {
+        if(frame_capture_->save(frame_capture_fname_))
+            SPEW(("GRAPHICS", "Saved %d draw calls to %s\n", frame_capture_->getNumCommands(), frame_capture_fname_));
+        delete frame_capture_;
+        delete[] frame_capture_fname_;
+        frame_capture_ = NULL;
+        frame_capture_fname_ = NULL;
+    }
+
     // check for file changes every half second
     static uint64_t last_check_time = timing::get_wall_time_ms();
     if(timing::get_wall_time_ms() - last_check_time > 500)
@@ -1604,6 +1795,9 @@ void gosRenderer::handleEvents()
 {
     if(pendingRequest) {
 
+        // recorded draws were issued with old projection
+        flush();
+
         width_ = reqWidth;
         height_ = reqHeight;
 
@@ -1675,47 +1869,39 @@ gosRenderMaterial* gosRenderer::selectLightedRenderMaterial(const RenderState& r
     }
 }
 
-void gosRenderer::drawQuads(gos_VERTEX* vertices, int count) {
-    gosASSERT(vertices);
-
-    if(beforeDrawCall()) return;
+uint32_t gosRenderer::getMaterialId(gosRenderMaterial* material) const
+{
+    std::vector<gosRenderMaterial*>::const_iterator it = std::find(materialList_.begin(), materialList_.end(), material);
+    gosASSERT(it != materialList_.end());
+    return (uint32_t)(it - materialList_.begin());
+}
 
-    int num_quads = count / 4;
-    int num_vertices = num_quads * 6;
+void gosRenderer::recordDraw(gosCommandBuffer::PrimType prim, gosRenderMaterial* material, gos_VERTEX* vertices, int num_vertices, WORD* indices, int num_indices)
+{
+    gosASSERT(num_vertices <= MAX_DRAW_VERTICES && num_indices <= MAX_DRAW_VERTICES);
 
-    if(quads_->getNumVertices() + num_vertices > quads_->getVertexCapacity()) {
-        applyRenderStates();
-        gosRenderMaterial* mat = selectBasicRenderMaterial(curStates_);
-        gosASSERT(mat);
+    if(!cmd_buffer_->hasRoomFor(num_vertices, num_indices))
+        flush();
 
-        mat->setTransform(projection_);
-        mat->setFogColor(fog_color_);
-        quads_->draw(mat);
-        quads_->rewind();
-    } 
+    cmd_buffer_->record(prim, getMaterialId(material), renderStates_, vertices, num_vertices, indices, num_indices);
+    num_recorded_++;
+}
 
-    gosASSERT(quads_->getNumVertices() + num_vertices <= quads_->getVertexCapacity());
-    for(int i=0; i<count;i+=4) {
+void gosRenderer::drawQuads(gos_VERTEX* vertices, int count) {
+    gosASSERT(vertices);
 
-        quads_->addVertices(vertices + 4*i + 0, 1);
-        quads_->addVertices(vertices + 4*i + 1, 1);
-        quads_->addVertices(vertices + 4*i + 2, 1);
+    if(beforeDrawCall()) return;
 
-        quads_->addVertices(vertices + 4*i + 0, 1);
-        quads_->addVertices(vertices + 4*i + 2, 1);
-        quads_->addVertices(vertices + 4*i + 3, 1);
-    }
+    const int num_vertices = (count / 4) * 6;
+    gosASSERT(num_vertices <= MAX_DRAW_VERTICES);
 
-    // for now draw anyway because no render state saved for draw calls
-    applyRenderStates();
+    if(!cmd_buffer_->hasRoomFor(num_vertices, 0))
+        flush();
 
-    gosRenderMaterial* mat = selectBasicRenderMaterial(curStates_);
+    gosRenderMaterial* mat = selectBasicRenderMaterial(renderStates_);
     gosASSERT(mat);
-
-    mat->setTransform(projection_);
-    mat->setFogColor(fog_color_);
-    quads_->draw(mat);
-    quads_->rewind();
+    cmd_buffer_->recordQuads(getMaterialId(mat), renderStates_, vertices, count);
+    num_recorded_++;
 
     afterDrawCall();
 }
@@ -1725,23 +1911,7 @@ void gosRenderer::drawLines(gos_VERTEX* vertices, int count) {
 
     if(beforeDrawCall()) return;
 
-    if(lines_->getNumVertices() + count > lines_->getVertexCapacity()) {
-        applyRenderStates();
-        basic_material_->setTransform(projection_);
-        basic_material_->setFogColor(fog_color_);
-        lines_->draw(basic_material_);
-        lines_->rewind();
-    }
-
-    gosASSERT(lines_->getNumVertices() + count <= lines_->getVertexCapacity());
-    lines_->addVertices(vertices, count);
-
-    // for now draw anyway because no render state saved for draw calls
-    applyRenderStates();
-    basic_material_->setTransform(projection_);
-    basic_material_->setFogColor(fog_color_);
-    lines_->draw(basic_material_);
-    lines_->rewind();
+    recordDraw(gosCommandBuffer::PT_LINES, basic_material_, vertices, count);
 
     afterDrawCall();
 }
@@ -1751,21 +1921,7 @@ void gosRenderer::drawPoints(gos_VERTEX* vertices, int count) {
 
     if(beforeDrawCall()) return;
 
-    if(points_->getNumVertices() + count > points_->getVertexCapacity()) {
-        applyRenderStates();
-        basic_material_->setTransform(projection_);
-		basic_material_->setFogColor(fog_color_);
-        points_->draw(basic_material_);
-        points_->rewind();
-    } 
-
-    gosASSERT(points_->getNumVertices() + count <= points_->getVertexCapacity());
-    points_->addVertices(vertices, count);
-
-    // for now draw anyway because no render state saved for draw calls
-    applyRenderStates();
-    points_->draw(basic_material_);
-    points_->rewind();
+    recordDraw(gosCommandBuffer::PT_POINTS, basic_material_, vertices, count);
 
     afterDrawCall();
 }
@@ -1777,31 +1933,9 @@ void gosRenderer::drawTris(gos_VERTEX* vertices, int count) {
 
     if(beforeDrawCall()) return;
 
-    if(tris_->getNumVertices() + count > tris_->getVertexCapacity()) {
-        applyRenderStates();
-
-        gosRenderMaterial* mat = selectBasicRenderMaterial(curStates_);
-        gosASSERT(mat);
-
-        mat->setTransform(projection_);
-		mat->setFogColor(fog_color_);
-        tris_->draw(mat);
-        tris_->rewind();
-    } 
-
-    gosASSERT(tris_->getNumVertices() + count <= tris_->getVertexCapacity());
-    tris_->addVertices(vertices, count);
-
-    // for now draw anyway because no render state saved for draw calls
-    applyRenderStates();
-
-    gosRenderMaterial* mat = selectBasicRenderMaterial(curStates_);
+    gosRenderMaterial* mat = selectBasicRenderMaterial(renderStates_);
     gosASSERT(mat);
-
-    mat->setTransform(projection_);
-    mat->setFogColor(fog_color_);
-    tris_->draw(mat);
-    tris_->rewind();
+    recordDraw(gosCommandBuffer::PT_TRIS, mat, vertices, count);
 
     afterDrawCall();
 }
@@ -1813,37 +1947,67 @@ void gosRenderer::drawIndexedTris(gos_VERTEX* vertices, int num_vertices, WORD*
 
     if(beforeDrawCall()) return;
 
-    bool not_enough_vertices = indexed_tris_->getNumVertices() + num_vertices > indexed_tris_->getVertexCapacity();
-    bool not_enough_indices = indexed_tris_->getNumIndices() + num_indices > indexed_tris_->getIndexCapacity();
-    if(not_enough_vertices || not_enough_indices){
-        applyRenderStates();
+    gosRenderMaterial* mat = selectBasicRenderMaterial(renderStates_);
+    gosASSERT(mat);
+    recordDraw(gosCommandBuffer::PT_INDEXED_TRIS, mat, vertices, num_vertices, indices, num_indices);
 
-        gosRenderMaterial* mat = selectBasicRenderMaterial(curStates_);
-        gosASSERT(mat);
+    afterDrawCall();
+}
 
-        mat->setTransform(projection_);
-		mat->setFogColor(fog_color_);
-        indexed_tris_->drawIndexed(mat);
-        indexed_tris_->rewind();
-    } 
+void gosRenderer::drawBatch(const gosCommandBuffer::Batch& batch)
+{
+    gosRenderMaterial* material = materialList_[batch.material_];
+    const bool indexed = batch.prim_ == gosCommandBuffer::PT_INDEXED_TRIS;
 
-    gosASSERT(indexed_tris_->getNumVertices() + num_vertices <= indexed_tris_->getVertexCapacity());
-    gosASSERT(indexed_tris_->getNumIndices() + num_indices <= indexed_tris_->getIndexCapacity());
-    indexed_tris_->addVertices(vertices, num_vertices);
-    indexed_tris_->addIndices(indices, num_indices);
+    uint32_t vb_offset = 0;
+    uint32_t ib_offset = 0;
+    gos_VERTEX* pvertices = (gos_VERTEX*)stream_vb_->map(batch.num_vertices_ * sizeof(gos_VERTEX), sizeof(gos_VERTEX), &vb_offset);
+    uint32_t* pindices = indexed ?
+        (uint32_t*)stream_ib_->map(batch.num_indices_ * sizeof(uint32_t), sizeof(uint32_t), &ib_offset) : NULL;
 
-    // for now draw anyway because no render state saved for draw calls
-    applyRenderStates();
+    // indices are made absolute, so vertex attributes always start at buffer beginning
+    const uint32_t base_vertex = vb_offset / sizeof(gos_VERTEX);
+    cmd_buffer_->gatherBatch(batch, pvertices, pindices, base_vertex);
 
-    gosRenderMaterial* mat = selectBasicRenderMaterial(curStates_);
-    gosASSERT(mat);
+    stream_vb_->unmap();
+    if(indexed)
+        stream_ib_->unmap();
 
-    mat->setTransform(projection_);
-    mat->setFogColor(fog_color_);
-    indexed_tris_->drawIndexed(mat);
-    indexed_tris_->rewind();
+    material->setTransform(projection_);
+    material->setFogColor(fog_color_);
+    material->apply();
+    material->setSamplerUnit(gosMesh::s_tex1, 0);
 
-    afterDrawCall();
+	glBindBuffer(GL_ARRAY_BUFFER, stream_vb_->getBuffer());
+    CHECK_GL_ERROR;
+
+    material->applyVertexDeclaration();
+    CHECK_GL_ERROR;
+
+    switch(batch.prim_) {
+        case gosCommandBuffer::PT_POINTS:
+            glDrawArrays(GL_POINTS, base_vertex, batch.num_vertices_);
+            break;
+        case gosCommandBuffer::PT_LINES:
+            glDrawArrays(GL_LINES, base_vertex, batch.num_vertices_);
+            break;
+        case gosCommandBuffer::PT_TRIS:
+            glDrawArrays(GL_TRIANGLES, base_vertex, batch.num_vertices_);
+            break;
+        case gosCommandBuffer::PT_INDEXED_TRIS:
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, stream_ib_->getBuffer());
+            glDrawElements(GL_TRIANGLES, batch.num_indices_, GL_UNSIGNED_INT, BUFFER_OFFSET(ib_offset));
+            break;
+        default:
+            gosASSERT(0 && "Wrong primitive type");
+    }
+    CHECK_GL_ERROR;
+
+    material->endVertexDeclaration();
+    material->end();
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
 void gosRenderer::drawIndexedTris(HGOSBUFFER ib, HGOSBUFFER vb, HGOSVERTEXDECLARATION vdecl, const float* mvp)
@@ -1853,6 +2017,7 @@ void gosRenderer::drawIndexedTris(HGOSBUFFER ib, HGOSBUFFER vb, HGOSVERTEXDECLAR
 
     if(beforeDrawCall()) return;
 
+    flush();
     applyRenderStates();
 
     gosRenderMaterial* mat = selectLightedRenderMaterial(curStates_);
@@ -1883,6 +2048,7 @@ void gosRenderer::drawIndexedTris(HGOSBUFFER ib, HGOSBUFFER vb, HGOSVERTEXDECLAR
 
     if(beforeDrawCall()) return;
 
+    flush();
     applyRenderStates();
 
 	// maybe getCurMaterial->set.... to not set it from outer code?
@@ -2015,6 +2181,9 @@ void gosRenderer::drawText(const char* text) {
 
     if(beforeDrawCall()) return;
 
+    // text sets per draw uniforms, so it is not recorded
+    flush();
+
     const int count = (int)strlen(text);  
 /*
     if(text_->getNumVertices() + count > text_->getCapacity()) {
@@ -2102,7 +2271,7 @@ void gosRenderer::drawText(const char* text) {
     }
     // FIXME: save states before messing with it, because user code can set its ow and does not know that something was changed by us
     
-    int prev_texture = getRenderState(gos_State_Texture);
+    int prev_texture = renderStates_[gos_State_Texture];
     
     // All states are set by client code
     // so we only set font texture
@@ -2139,8 +2308,187 @@ void gosRenderer::drawText(const char* text) {
     afterDrawCall();
 }
 
+// Issues everything recorded since last flush. Called at the end of frame and
+// before anything which talks to GL directly or changes resources recorded draws
+// depend on (text, hardware buffer draws, external materials, texture updates...)
 void gosRenderer::flush()
 {
+    if(cmd_buffer_->empty())
+        return;
+
+    if(frame_capture_)
+        frame_capture_->append(*cmd_buffer_);
+
+    const uint32_t max_batch_vertices = stream_vb_->getMaxWriteSize() / sizeof(gos_VERTEX);
+    const uint32_t max_batch_indices = stream_ib_->getMaxWriteSize() / sizeof(uint32_t);
+    const std::vector<gosCommandBuffer::Batch>& batches =
+        cmd_buffer_->build(sort_draw_calls_, max_batch_vertices, max_batch_indices);
+
+    // batches are drawn with states they were recorded with, client's pending states are kept as is
+    RenderState pending_states;
+    memcpy(pending_states, renderStates_, sizeof(RenderState));
+
+    uint32_t applied_state = 0xffffffff;
+    for(size_t i=0; i<batches.size(); ++i) {
+        const gosCommandBuffer::Batch& b = batches[i];
+        if(b.state_ != applied_state) {
+            memcpy(renderStates_, cmd_buffer_->getState(b.state_), sizeof(RenderState));
+            applyRenderStates();
+            applied_state = b.state_;
+        }
+        drawBatch(b);
+    }
+
+    memcpy(renderStates_, pending_states, sizeof(RenderState));
+
+    num_batches_ += (uint32_t)batches.size();
+    cmd_buffer_->reset();
+}
+
+void gosRenderer::captureFrame(const char* fname)
+{
+    gosASSERT(fname);
+    if(frame_capture_)
+        return;
+    frame_capture_ = new gosCommandBuffer(MAX_RECORDED_VERTICES, MAX_RECORDED_INDICES);
+    frame_capture_fname_ = new char[strlen(fname) + 1];
+    strcpy(frame_capture_fname_, fname);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Used instead of gosRenderer when running headless: there is no GL context,
+// so textures are only kept as sizes plus a system memory copy created on first
+// lock, fonts only need their glyph metrics (for text measuring), everything
+// which would draw is simply dropped by gos_* entry points
+struct gosNullTexture {
+    gos_TextureFormat format_;
+    int w_;
+    int h_;
+    BYTE* pdata_;
+};
+
+class gosNullRenderer {
+    public:
+        gosNullRenderer(int w, int h) {
+            width_ = w;
+            height_ = h;
+            viewportTop_ = viewportLeft_ = 0.0f;
+            viewportBottom_ = viewportRight_ = 1.0f;
+            render_viewport_ = vec4(0, 0, (float)w, (float)h);
+            memset(&curTextAttribs_, 0, sizeof(curTextAttribs_));
+            // keep 0 as INVALID_TEXTURE_ID, same as real renderer does
+            textureList_.push_back(NULL);
+        }
+
+        ~gosNullRenderer() {
+            for(size_t i=0; i<textureList_.size(); ++i)
+                deleteTexture((DWORD)i);
+            for(size_t i=0; i<fontList_.size(); ++i)
+                delete fontList_[i];
+        }
+
+        DWORD addTexture(gos_TextureFormat fmt, int w, int h) {
+            gosNullTexture* ptex = new gosNullTexture();
+            ptex->format_ = fmt;
+            ptex->w_ = w > 0 ? w : 1;
+            ptex->h_ = h > 0 ? h : 1;
+            ptex->pdata_ = NULL;
+            textureList_.push_back(ptex);
+            return (DWORD)(textureList_.size()-1);
+        }
+
+        gosNullTexture* getTexture(DWORD texture_id) {
+            gosASSERT(texture_id != INVALID_TEXTURE_ID && textureList_.size() > texture_id);
+            gosASSERT(textureList_[texture_id] != 0);
+            return textureList_[texture_id];
+        }
+
+        void deleteTexture(DWORD texture_id) {
+            gosASSERT(textureList_.size() > texture_id);
+            gosNullTexture* ptex = textureList_[texture_id];
+            if(ptex) {
+                delete[] ptex->pdata_;
+                delete ptex;
+                textureList_[texture_id] = 0;
+            }
+        }
+
+        gosFont* findFont(const char* font_id) {
+            for(size_t i=0; i<fontList_.size(); ++i)
+                if(0 == strcmp(fontList_[i]->getId(), font_id))
+                    return fontList_[i];
+            return NULL;
+        }
+
+        void addFont(gosFont* font) {
+            gosASSERT(font);
+            fontList_.push_back(font);
+        }
+
+        void deleteFont(gosFont* font) {
+            std::vector<gosFont*>::iterator it = std::find(fontList_.begin(), fontList_.end(), font);
+            if(it != fontList_.end() && 0 == gosFont::destroy(font))
+                fontList_.erase(it);
+        }
+
+        gosTextAttribs& getTextAttributes() { return curTextAttribs_; }
+
+        void setScreenMode(DWORD width, DWORD height) {
+            width_ = width;
+            height_ = height;
+        }
+
+        void setupViewport(float top, float left, float bottom, float right) {
+            viewportTop_ = top;
+            viewportLeft_ = left;
+            viewportBottom_ = bottom;
+            viewportRight_ = right;
+        }
+
+        void getViewportTransform(float* viewMulX, float* viewMulY, float* viewAddX, float* viewAddY) {
+            gosASSERT(viewMulX && viewMulY && viewAddX && viewAddY);
+            *viewMulX = (viewportRight_ - viewportLeft_)*width_;
+            *viewMulY = (viewportBottom_ - viewportTop_)*height_;
+            *viewAddX = viewportLeft_ * width_;
+            *viewAddY = viewportTop_ * height_;
+        }
+
+        void setRenderViewport(const vec4& vp) { render_viewport_ = vp; }
+        vec4 getRenderViewport() { return render_viewport_; }
+
+    private:
+        std::vector<gosNullTexture*> textureList_;
+        std::vector<gosFont*> fontList_;
+        gosTextAttribs curTextAttribs_;
+
+        int width_;
+        int height_;
+        float viewportTop_;
+        float viewportLeft_;
+        float viewportBottom_;
+        float viewportRight_;
+        vec4 render_viewport_;
+};
+
+static gosNullRenderer* g_gos_null_renderer = NULL;
+
+void gos_CreateNullRenderer(int w, int h) {
+    gosASSERT(!g_gos_renderer && !g_gos_null_renderer);
+    g_gos_null_renderer = new gosNullRenderer(w, h);
+}
+
+void gos_DestroyNullRenderer() {
+    delete g_gos_null_renderer;
+    g_gos_null_renderer = NULL;
+}
+
+// only header is needed, null renderer never looks at pixels
+static bool getTGASize(const BYTE* pdata, DWORD size, int* w, int* h) {
+    if(!pdata || size < 18)
+        return false;
+    *w = pdata[12] | (pdata[13] << 8);
+    *h = pdata[14] | (pdata[15] << 8);
+    return true;
 }
 
 void gos_CreateRenderer(graphics::RenderContextHandle ctx_h, graphics::RenderWindowHandle win_h, int w, int h) {
@@ -2204,12 +2552,16 @@ gosFont* gosFont::load(const char* fontFile) {
     formatted_len = S_snprintf(glyphName, glyphNameSize, "%s/%s%s", dir, fname, glyph_ext);
 	gosASSERT(formatted_len <= glyphNameSize - 1);
 
-    gosTexture* ptex = new gosTexture(gos_Texture_Alpha, textureName, 0, NULL, 0, false);
-    if(!ptex || !ptex->createHardwareTexture()) {
-        STOP(("Failed to create font texture: %s\n", textureName));
-    }
+    // headless: only glyph metrics are needed
+    DWORD tex_id = INVALID_TEXTURE_ID;
+    if(getGosRenderer()) {
+        gosTexture* ptex = new gosTexture(gos_Texture_Alpha, textureName, 0, NULL, 0, false);
+        if(!ptex || !ptex->createHardwareTexture()) {
+            STOP(("Failed to create font texture: %s\n", textureName));
+        }
 
-    DWORD tex_id = getGosRenderer()->addTexture(ptex);
+        tex_id = getGosRenderer()->addTexture(ptex);
+    }
 
     gosFont* font = new gosFont();
     if(!gos_load_glyphs(glyphName, font->gi_)) {
@@ -2282,37 +2634,63 @@ const gosGlyphMetrics& gosFont::getGlyphMetrics(int c) const {
 //
 void _stdcall gos_DrawLines(gos_VERTEX* Vertices, int NumVertices)
 {
-    gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer)
+        return;
     g_gos_renderer->drawLines(Vertices, NumVertices);
 }
 void _stdcall gos_DrawPoints(gos_VERTEX* Vertices, int NumVertices)
 {
-    gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer)
+        return;
     g_gos_renderer->drawPoints(Vertices, NumVertices);
 }
 
 bool g_disable_quads = true;
 void _stdcall gos_DrawQuads(gos_VERTEX* Vertices, int NumVertices)
 {
-    gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer)
+        return;
     if(g_disable_quads == false )
         g_gos_renderer->drawQuads(Vertices, NumVertices);
 }
 void _stdcall gos_DrawTriangles(gos_VERTEX* Vertices, int NumVertices)
 {
-    gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer)
+        return;
     g_gos_renderer->drawTris(Vertices, NumVertices);
 }
+void _stdcall gos_DrawBarrier()
+{
+    if(!g_gos_renderer)
+        return;
+    g_gos_renderer->drawBarrier();
+}
 
 void __stdcall gos_GetViewport( float* pViewportMulX, float* pViewportMulY, float* pViewportAddX, float* pViewportAddY )
 {
-    gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer) {
+        gosASSERT(g_gos_null_renderer);
+        g_gos_null_renderer->getViewportTransform(pViewportMulX, pViewportMulY, pViewportAddX, pViewportAddY);
+        return;
+    }
     g_gos_renderer->getViewportTransform(pViewportMulX, pViewportMulY, pViewportAddX, pViewportAddY);
 }
 
 HGOSFONT3D __stdcall gos_LoadFont( const char* FontFile, DWORD StartLine/* = 0*/, int CharCount/* = 256*/, DWORD TextureHandle/*=0*/)
 {
 
+    if(!g_gos_renderer) {
+        gosASSERT(g_gos_null_renderer);
+        gosFont* font = g_gos_null_renderer->findFont(FontFile);
+        if(!font) {
+            font = gosFont::load(FontFile);
+            g_gos_null_renderer->addFont(font);
+        } else {
+            font->addRef();
+        }
+        return font;
+    }
+
     gosFont* font = getGosRenderer()->findFont(FontFile);
     if(!font) {
         font = gosFont::load(FontFile);
@@ -2328,6 +2706,10 @@ void __stdcall gos_DeleteFont( HGOSFONT3D FontHandle )
 {
     gosASSERT(FontHandle);
     gosFont* font = FontHandle;
+    if(!g_gos_renderer) {
+        g_gos_null_renderer->deleteFont(font);
+        return;
+    }
     getGosRenderer()->deleteFont(font);
 }
 
@@ -2340,6 +2722,10 @@ DWORD __stdcall gos_NewEmptyTexture( gos_TextureFormat Format, const char* Name,
         h = HeightWidth >> 16;
         w = HeightWidth & 0xffff;
     }
+
+    if(!g_gos_renderer)
+        return g_gos_null_renderer->addTexture(Format, w, h);
+
     gosTexture* ptex = new gosTexture(Format, Hints, w, h, Name);
 
     if(!ptex->createHardwareTexture()) {
@@ -2353,6 +2739,15 @@ DWORD __stdcall gos_NewTextureFromMemory( gos_TextureFormat Format, const char*
 {
     gosASSERT(pFunc == 0);
 
+    if(!g_gos_renderer) {
+        int w = 0, h = 0;
+        if(!getTGASize(pBitmap, Size, &w, &h)) {
+            STOP(("Failed to create texture\n"));
+            return INVALID_TEXTURE_ID;
+        }
+        return g_gos_null_renderer->addTexture(Format, w, h);
+    }
+
     gosTexture* ptex = new gosTexture(Format, FileName, Hints, pBitmap, Size, true);
     if(!ptex->createHardwareTexture()) {
         STOP(("Failed to create texture\n"));
@@ -2362,8 +2757,120 @@ DWORD __stdcall gos_NewTextureFromMemory( gos_TextureFormat Format, const char*
     return g_gos_renderer->addTexture(ptex);
 }
 
+struct gosDecodedTexture {
+    Image img_;
+    gos_TextureFormat format_;
+    char* filename_;
+};
+
+HGOSDECODEDTEXTURE __stdcall gos_DecodeTextureFromMemory( gos_TextureFormat Format, const char* FileName, BYTE* pBitmap, DWORD Size)
+{
+    gosDecodedTexture* decoded = new gosDecodedTexture();
+    if(!decoded->img_.loadTGA(pBitmap, Size)) {
+        SPEW(("DBG", "failed to decode texture from data, filename: %s\n", FileName ? FileName : "NO FILENAME"));
+        delete decoded;
+        return NULL;
+    }
+
+    // runs on loader threads, leave it to the synchronous path to STOP
+    FORMAT img_fmt = decoded->img_.getFormat();
+    if(img_fmt != FORMAT_RGB8 && img_fmt != FORMAT_RGBA8) {
+        SPEW(("DBG", "unsupported texture format when decoding %s\n", FileName ? FileName : "NO FILENAME"));
+        delete decoded;
+        return NULL;
+    }
+
+    decoded->format_ = convertIfNecessary(decoded->img_, Format);
+
+    decoded->filename_ = NULL;
+    if(FileName) {
+        decoded->filename_ = new char[strlen(FileName)+1];
+        strcpy(decoded->filename_, FileName);
+    }
+
+    return decoded;
+}
+
+DWORD __stdcall gos_NewTextureFromDecoded( HGOSDECODEDTEXTURE Decoded, DWORD Hints/*=0*/)
+{
+    gosASSERT(Decoded);
+
+    if(!g_gos_renderer) {
+        DWORD handle = g_gos_null_renderer->addTexture(Decoded->format_, Decoded->img_.getWidth(), Decoded->img_.getHeight());
+        gos_FreeDecodedTexture(Decoded);
+        return handle;
+    }
+
+    gosTexture* ptex = new gosTexture(Decoded->format_, Decoded->filename_, Hints, NULL, 0, true);
+    if(!ptex->createHardwareTexture(Decoded->img_)) {
+        delete ptex;
+        gos_FreeDecodedTexture(Decoded);
+        STOP(("Failed to create texture\n"));
+        return INVALID_TEXTURE_ID;
+    }
+
+    gos_FreeDecodedTexture(Decoded);
+
+    return g_gos_renderer->addTexture(ptex);
+}
+
+void __stdcall gos_FreeDecodedTexture( HGOSDECODEDTEXTURE Decoded )
+{
+    if(Decoded) {
+        delete[] Decoded->filename_;
+        delete Decoded;
+    }
+}
+
+void __stdcall gos_GetDecodedTextureLowMip( HGOSDECODEDTEXTURE Decoded, DWORD Size, DWORD* pARGB )
+{
+    gosASSERT(Decoded && Size && pARGB);
+
+    const Image& img = Decoded->img_;
+    const int w = img.getWidth();
+    const int h = img.getHeight();
+    const int pixel_size = img.getFormat() == FORMAT_RGBA8 ? 4 : 3;
+    const BYTE* pixels = img.getPixels();
+
+    for(DWORD dy = 0; dy < Size; ++dy) {
+        // every texel covers at least one source pixel, also when image is smaller than the mip
+        int y0 = (int)(dy * h / Size);
+        int y1 = (int)((dy + 1) * h / Size);
+        if(y1 <= y0)
+            y1 = y0 + 1;
+        for(DWORD dx = 0; dx < Size; ++dx) {
+            int x0 = (int)(dx * w / Size);
+            int x1 = (int)((dx + 1) * w / Size);
+            if(x1 <= x0)
+                x1 = x0 + 1;
+
+            DWORD r = 0, g = 0, b = 0, a = 0;
+            for(int y = y0; y < y1; ++y) {
+                const BYTE* p = pixels + (y * w + x0) * pixel_size;
+                for(int x = x0; x < x1; ++x, p += pixel_size) {
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                    a += pixel_size == 4 ? p[3] : 0xff;
+                }
+            }
+            const DWORD n = (DWORD)((y1 - y0) * (x1 - x0));
+            pARGB[dy * Size + dx] = ((a / n) << 24) | ((r / n) << 16) | ((g / n) << 8) | (b / n);
+        }
+    }
+}
+
 DWORD __stdcall gos_NewTextureFromFile( gos_TextureFormat Format, const char* FileName, DWORD Hints/*=0*/, gos_RebuildFunction pFunc/*=0*/, void *pInstance/*=0*/)
 {
+    if(!g_gos_renderer) {
+        Image img;
+        if(!img.loadFromFile(FileName)) {
+            STOP(("Failed to create texture\n"));
+            return INVALID_TEXTURE_ID;
+        }
+        return g_gos_null_renderer->addTexture(Format, img.getWidth(), img.getHeight());
+    }
+
     gosTexture* ptex = new gosTexture(Format, FileName, Hints, NULL, 0, false);
     if(!ptex->createHardwareTexture()) {
         STOP(("Failed to create texture\n"));
@@ -2373,6 +2880,10 @@ DWORD __stdcall gos_NewTextureFromFile( gos_TextureFormat Format, const char* Fi
 }
 void __stdcall gos_DestroyTexture( DWORD Handle )
 {
+    if(!g_gos_renderer) {
+        g_gos_null_renderer->deleteTexture(Handle);
+        return;
+    }
     g_gos_renderer->deleteTexture(Handle);
 }
 
@@ -2384,6 +2895,24 @@ void __stdcall gos_LockTexture( DWORD Handle, DWORD MipMapSize, bool ReadOnly, T
     gosASSERT(MipMapSize == 0);
     int mip_level = 0; //func(MipMapSize);
 
+    if(!g_gos_renderer) {
+        // contents are undefined, same as for a freshly created texture
+        gosNullTexture* ptex = g_gos_null_renderer->getTexture(Handle);
+        if(!ptex->pdata_) {
+            ptex->pdata_ = new BYTE[ptex->w_ * ptex->h_ * sizeof(DWORD)];
+            memset(ptex->pdata_, 0, ptex->w_ * ptex->h_ * sizeof(DWORD));
+        }
+        TextureInfo->pTexture = (DWORD*)ptex->pdata_;
+        TextureInfo->Width = ptex->w_;
+        TextureInfo->Height = ptex->h_;
+        TextureInfo->Pitch = ptex->w_;
+        TextureInfo->Type = ptex->format_;
+        return;
+    }
+
+    // draws recorded so far must see old contents
+    g_gos_renderer->flush();
+
     gosTextureInfo info;
     int pitch = 0;
     gosTexture* ptex = g_gos_renderer->getTexture(Handle);
@@ -2401,6 +2930,11 @@ void __stdcall gos_LockTexture( DWORD Handle, DWORD MipMapSize, bool ReadOnly, T
 
 void __stdcall gos_UnLockTexture( DWORD Handle )
 {
+    if(!g_gos_renderer)
+        return;
+
+    g_gos_renderer->flush();
+
     gosTexture* ptex = g_gos_renderer->getTexture(Handle);
     ptex->Unlock();
 
@@ -2409,19 +2943,22 @@ void __stdcall gos_UnLockTexture( DWORD Handle )
 
 void __stdcall gos_PushRenderStates()
 {
-    gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer)
+        return;
     g_gos_renderer->pushRenderStates();
 } 
 
 void __stdcall gos_PopRenderStates()
 {
-    gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer)
+        return;
     g_gos_renderer->popRenderStates();
 }
 
 void __stdcall gos_RenderIndexedArray( gos_VERTEX* pVertexArray, DWORD NumberVertices, WORD* lpwIndices, DWORD NumberIndices )
 {
-    gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer)
+        return;
     g_gos_renderer->drawIndexedTris(pVertexArray, NumberVertices, lpwIndices, NumberIndices);
 }
 
@@ -2432,19 +2969,22 @@ void __stdcall gos_RenderIndexedArray( gos_VERTEX_2UV* pVertexArray, DWORD Numbe
 
 void __stdcall gos_RenderIndexedArray(HGOSBUFFER ib, HGOSBUFFER vb, HGOSVERTEXDECLARATION vdecl, const float* mvp)
 {
-    gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer)
+        return;
     g_gos_renderer->drawIndexedTris(ib, vb, vdecl, mvp);
 }
 
 void __stdcall gos_RenderIndexedArray(HGOSBUFFER ib, HGOSBUFFER vb, HGOSVERTEXDECLARATION vdecl)
 {
-    gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer)
+        return;
     g_gos_renderer->drawIndexedTris(ib, vb, vdecl);
 }
 
 void __stdcall gos_SetRenderState( gos_RenderState RenderState, int Value )
 {
-    gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer)
+        return;
     // gos_BlendDecal mode is not suported (currently texture color always modulated with vertex color)
     //gosASSERT(RenderState!=gos_State_TextureMapBlend || (Value == gos_BlendDecal));
     g_gos_renderer->setRenderState(RenderState, Value);
@@ -2452,31 +2992,39 @@ void __stdcall gos_SetRenderState( gos_RenderState RenderState, int Value )
 
 void __stdcall gos_SetScreenMode( DWORD Width, DWORD Height, DWORD bitDepth/*=16*/, DWORD Device/*=0*/, bool disableZBuffer/*=0*/, bool AntiAlias/*=0*/, bool RenderToVram/*=0*/, bool GotoFullScreen/*=0*/, int DirtyRectangle/*=0*/, bool GotoWindowMode/*=0*/, bool EnableStencil/*=0*/, DWORD Renderer/*=0*/)
 {
-    gosASSERT(g_gos_renderer);
     gosASSERT((GotoFullScreen && !GotoWindowMode) || (!GotoFullScreen&&GotoWindowMode) || (!GotoFullScreen&&!GotoWindowMode));
+    if(!g_gos_renderer) {
+        g_gos_null_renderer->setScreenMode(Width, Height);
+        return;
+    }
 
     g_gos_renderer->setScreenMode(Width, Height, bitDepth, GotoFullScreen, AntiAlias);
 }
 
 void __stdcall gos_SetupViewport( bool FillZ, float ZBuffer, bool FillBG, DWORD BGColor, float top, float left, float bottom, float right, bool ClearStencil/*=0*/, DWORD StencilValue/*=0*/)
 {
-    gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer) {
+        g_gos_null_renderer->setupViewport(top, left, bottom, right);
+        return;
+    }
     g_gos_renderer->setupViewport(FillZ, ZBuffer, FillBG, BGColor, top, left, bottom, right, ClearStencil, StencilValue);
 }
 
 
 void __stdcall gos_SetRenderViewport(float x, float y, float w, float h)
 {
-    gosASSERT(g_gos_renderer);
 	//glViewport(x, y, w, h);
+    if(!g_gos_renderer) {
+        g_gos_null_renderer->setRenderViewport(vec4(x, y, w, h));
+        return;
+    }
 	g_gos_renderer->setRenderViewport(vec4(x, y, w, h));
 }
 
 void __stdcall gos_GetRenderViewport(float* x, float* y, float* w, float* h)
 {
     gosASSERT(x && y && w && h);
-    gosASSERT(g_gos_renderer);
-	vec4 vp = g_gos_renderer->getRenderViewport();
+	vec4 vp = g_gos_renderer ? g_gos_renderer->getRenderViewport() : g_gos_null_renderer->getRenderViewport();
 	*x = vp.x;
 	*y = vp.y;
 	*w = vp.z;
@@ -2505,14 +3053,16 @@ void __stdcall gos_TextDraw( const char *Message, ... )
 
     va_end(ap);
 
-    gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer)
+        return;
     g_gos_renderer->drawText(text);
 }
 
 void __stdcall gos_TextDrawBackground( int Left, int Top, int Right, int Bottom, DWORD Color )
 {
     // TODO: Is it correctly Implemented?
-    gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer)
+        return;
 
     //PAUSE((""));
 
@@ -2544,9 +3094,7 @@ void __stdcall gos_TextDrawBackground( int Left, int Top, int Right, int Bottom,
 
 void __stdcall gos_TextSetAttributes( HGOSFONT3D FontHandle, DWORD Foreground, float Size, bool WordWrap, bool Proportional, bool Bold, bool Italic, DWORD WrapType/*=0*/, bool DisableEmbeddedCodes/*=0*/)
 {
-    gosASSERT(g_gos_renderer);
-
-    gosTextAttribs& ta = g_gos_renderer->getTextAttributes();
+    gosTextAttribs& ta = g_gos_renderer ? g_gos_renderer->getTextAttributes() : g_gos_null_renderer->getTextAttributes();
     ta.FontHandle = FontHandle;
     ta.Foreground = Foreground;
     ta.Size = Size;
@@ -2560,13 +3108,15 @@ void __stdcall gos_TextSetAttributes( HGOSFONT3D FontHandle, DWORD Foreground, f
 
 void __stdcall gos_TextSetPosition( int XPosition, int YPosition )
 {
-    gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer)
+        return;
     g_gos_renderer->setTextPos(XPosition, YPosition);
 }
 
 void __stdcall gos_TextSetRegion( int Left, int Top, int Right, int Bottom )
 {
-    gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer)
+        return;
     g_gos_renderer->setTextRegion(Left, Top, Right, Bottom);
 }
 
@@ -2592,7 +3142,7 @@ void __stdcall gos_TextStringLength( DWORD* Width, DWORD* Height, const char *fm
 	size_t len = strlen(text);
     text[len] = '\0';
 
-    const gosTextAttribs& ta = g_gos_renderer->getTextAttributes();
+    const gosTextAttribs& ta = g_gos_renderer ? g_gos_renderer->getTextAttributes() : g_gos_null_renderer->getTextAttributes();
     const gosFont* font = ta.FontHandle;
     gosASSERT(font);
 
@@ -2631,8 +3181,11 @@ size_t __stdcall gos_GetMachineInformation( MachineInfo mi, int Param1/*=0*/, in
     if(mi == gos_Info_NumberDevices)
         return 1;
     if(mi == gos_Info_GetDeviceName)
-        return (size_t)glGetString(GL_RENDERER);
+        return g_gos_renderer ? (size_t)glGetString(GL_RENDERER) : (size_t)"null renderer";
     if(mi == gos_Info_ValidMode) {
+        if(!g_gos_renderer)
+            return 1;
+
         int xres = Param2;
         int yres = Param3;
         int bpp = Param4;
@@ -2646,18 +3199,23 @@ size_t __stdcall gos_GetMachineInformation( MachineInfo mi, int Param1/*=0*/, in
 
 int gos_GetWindowDisplayIndex()
 {   
-    gosASSERT(g_gos_renderer);
-    
+    if(!g_gos_renderer)
+        return 0;
+
     return graphics::get_window_display_index(g_gos_renderer->getRenderContextHandle());
 }
 
 int gos_GetNumDisplayModes(int DisplayIndex)
 {
+    if(!g_gos_renderer)
+        return 0;
     return graphics::get_num_display_modes(DisplayIndex);
 }
 
 bool gos_GetDisplayModeByIndex(int DisplayIndex, int ModeIndex, int* XRes, int* YRes, int* BitDepth)
 {
+    if(!g_gos_renderer)
+        return false;
     return graphics::get_display_mode_by_index(DisplayIndex, ModeIndex, XRes, YRes, BitDepth);
 }
 
@@ -2700,6 +3258,17 @@ GLenum getGLBufferUsage(gosBUFFER_USAGE usage)
 
 gosBuffer* __stdcall gos_CreateBuffer(gosBUFFER_TYPE type, gosBUFFER_USAGE usage, int element_size, uint32_t count, void* buffer_data)
 {
+    if(!g_gos_renderer) {
+        // headless: callers only need a handle which knows its size
+        gosBuffer* pbuffer = new gosBuffer();
+        pbuffer->buffer_ = 0;
+        pbuffer->element_size_ = element_size;
+        pbuffer->count_ = count;
+        pbuffer->type_ = type;
+        pbuffer->usage_ = usage;
+        return pbuffer;
+    }
+
 	GLenum gl_target = getGLBufferType(type);
 	GLenum gl_usage = getGLBufferUsage(usage);
 
@@ -2732,15 +3301,18 @@ uint32_t gos_GetBufferSizeBytes(HGOSBUFFER buffer)
 void __stdcall gos_DestroyBuffer(gosBuffer* buffer)
 {
 	gosASSERT(buffer);
-    gosASSERT(g_gos_renderer);
-	bool rv = g_gos_renderer->deleteBuffer(buffer);
-    (void)rv;
+    if(g_gos_renderer) {
+        bool rv = g_gos_renderer->deleteBuffer(buffer);
+        (void)rv;
+    }
 	delete buffer;
 }
 
 void __stdcall gos_BindBufferBase(gosBuffer* buffer, uint32_t slot)
 {
 	gosASSERT(buffer);
+    if(!g_gos_renderer)
+        return;
 
 	GLenum gl_target = getGLBufferType(buffer->type_);
 	glBindBufferBase(gl_target, slot, buffer->buffer_);
@@ -2750,6 +3322,8 @@ void __stdcall gos_UpdateBuffer(HGOSBUFFER buffer, void* data, size_t offset, si
 {
 	gosASSERT(buffer);
     gosASSERT(buffer->element_size_ * buffer->count_ >= num_bytes);
+    if(!g_gos_renderer)
+        return;
 	GLenum gl_target = getGLBufferType(buffer->type_);
     glBindBuffer(gl_target, buffer->buffer_);
 	glBufferData(gl_target, num_bytes, data, GL_DYNAMIC_DRAW);
@@ -2759,18 +3333,19 @@ void __stdcall gos_UpdateBuffer(HGOSBUFFER buffer, void* data, size_t offset, si
 HGOSVERTEXDECLARATION __stdcall gos_CreateVertexDeclaration(gosVERTEX_FORMAT_RECORD* records, int count)
 {
 	gosASSERT(records && count > 0);
-    gosASSERT(g_gos_renderer);
 	gosVertexDeclaration* vdecl = gosVertexDeclaration::create(records, count);
-	g_gos_renderer->addVertexDeclaration(vdecl);
+    if(g_gos_renderer)
+        g_gos_renderer->addVertexDeclaration(vdecl);
 	return vdecl;
 }
 
 void __stdcall gos_DestroyVertexDeclaration(HGOSVERTEXDECLARATION vdecl)
 {
 	gosASSERT(vdecl);
-    gosASSERT(g_gos_renderer);
-	bool rv = g_gos_renderer->deleteVertexDeclaration(vdecl);
-    (void)rv;
+    if(g_gos_renderer) {
+        bool rv = g_gos_renderer->deleteVertexDeclaration(vdecl);
+        (void)rv;
+    }
 	gosVertexDeclaration::destroy(vdecl);
 
 }
@@ -2778,7 +3353,8 @@ void __stdcall gos_DestroyVertexDeclaration(HGOSVERTEXDECLARATION vdecl)
 HGOSRENDERMATERIAL __stdcall gos_getRenderMaterial(const char* material)
 {
 	gosASSERT(material);
-	gosASSERT(g_gos_renderer);
+    if(!g_gos_renderer)
+        return NULL;
 	return g_gos_renderer->getRenderMaterial(material);
 }
 
@@ -2786,6 +3362,9 @@ void __stdcall gos_ApplyRenderMaterial(HGOSRENDERMATERIAL material)
 {
 	gosASSERT(material);
 
+	// binds its own program, so recorded draws have to go first
+	g_gos_renderer->flush();
+
 	//setup commoin stuff
 	gos_SetCommonMaterialParameters(material);
 
@@ -37,6 +37,16 @@ void gos_RenderUpdateDebugInput() {
                 g_gos_renderer->setNumDrawCallsToDraw(0);
             }
             break;
+        case KEY_S:
+            g_gos_renderer->setSortDrawCalls(!g_gos_renderer->getSortDrawCalls());
+            SPEW(("GRAPHICS", "Draw call sorting: %s, last frame: %d draw calls in %d batches\n",
+                        g_gos_renderer->getSortDrawCalls() ? "on" : "off",
+                        g_gos_renderer->getNumRecordedDrawCalls(), g_gos_renderer->getNumBatches()));
+            break;
+        case KEY_C:
+            // can be replayed with data_tools/drawbatchtest
+            g_gos_renderer->captureFrame("gos_frame.gcb");
+            break;
         case KEY_ESCAPE:
             g_gos_renderer->setBreakOnDrawCall(false);
             g_gos_renderer->setNumDrawCallsToDraw(0);
@@ -0,0 +1,831 @@
+#include "gameos.hpp"
+#include "memorymanager.hpp" // gos_Heap
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h> // offsetof
+#include <new>
+#include <mutex>
+#include <atomic>
+
+// Memory heaps
+//
+// Every heap owns an arena. Blocks up to gosLargestArenaBlock bytes come from
+// size class free lists which are refilled from big bump allocated regions,
+// larger blocks get pages of their own from the system allocator and are linked
+// into the heap so that they can be found and released with it.
+// Regions are never given back while heap is alive (freed blocks are reused by
+// the same heap). When heap is destroyed its regions go to a small pool the next
+// heaps take their regions from, so per mission heaps do not leave holes in the
+// process heap, the rest is given back to the system.
+//
+// Regions and large blocks are allocated in whole, aligned pages and a page map
+// tells which heap number owns each page, so gos_Free (and global operator
+// delete) finds the owner without taking any lock but the owner's arena lock.
+// Each block is preceded by gosBlockHeader, which tells the size class, so blocks
+// can be freed with any heap current. gos_Free only reads the header of pages a
+// live heap owns. Pages which were ours once stay marked released, so late frees
+// of blocks of released heaps are ignored instead of being passed to free().
+
+// 0 - all blocks use system allocator (accounting is still done per heap)
+#define GOS_USE_HEAP_ARENAS 1
+
+static const uint32_t gosBlockMagic = 0x48534f47; // 'GOSH'
+static const uint16_t gosLargeBlockClass = 0xffff;
+static const uint8_t gosBlockAllocated = 0xa1;
+static const uint8_t gosBlockFree = 0xfe;
+
+static const size_t gosLargestArenaBlock = 32768;
+static const int gosNumSizeClasses = 40;
+static const size_t gosRegionSize = 256*1024;
+static const int gosMaxPooledRegions = 16;
+
+static const int g_hepsStackSize = 128;
+static const int gosMaxHeaps = 256;
+
+#pragma pack(push,1)
+struct gosBlockHeader {
+    uint32_t magic_;
+    uint16_t class_;
+    uint8_t heap_;      // index in HeapList[]
+    uint8_t state_;
+    uint32_t size_;     // requested size
+    uint32_t check_;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(gosBlockHeader) == 16, "block header has to keep 16 byte alignment of blocks");
+
+// free blocks keep their header, link to next free block is stored in user area
+struct gosFreeBlock {
+    gosBlockHeader hdr_;
+    gosFreeBlock* next_;
+};
+
+struct gosLargeBlock {
+    gosLargeBlock* prev_;
+    gosLargeBlock* next_;
+    alignas(16) gosBlockHeader hdr_; // links are only 8 bytes with 32 bit pointers
+};
+
+static_assert(sizeof(gosLargeBlock) % 16 == 0 && offsetof(gosLargeBlock, hdr_) % 16 == 0,
+        "large block header has to keep 16 byte alignment of blocks");
+
+struct gosRegion {
+    gosRegion* next_;
+    size_t size_;
+};
+
+static const size_t gosRegionHeaderSize = (sizeof(gosRegion) + 15) & ~(size_t)15;
+
+// one per heap number, reused by heaps which get the same number
+struct gosHeapArena {
+    std::mutex lock_;
+    gos_Heap* heap_;    // NULL while no heap has this number
+    gosFreeBlock* free_[gosNumSizeClasses];
+    DWORD live_blocks_[gosNumSizeClasses];
+    gosRegion* regions_;
+    char* bump_;
+    char* bump_end_;
+    gosLargeBlock* large_;
+    DWORD num_large_;
+    bool over_budget_reported_;
+};
+
+HGOSHEAP HeapList[gosMaxHeaps];
+
+static std::mutex& getHeapListLock()
+{
+    // never destroyed: blocks may be freed by static destructors after exit() was called
+    static std::mutex* lock = new (malloc(sizeof(std::mutex))) std::mutex();
+    return *lock;
+}
+
+static gosHeapArena* getArenas()
+{
+    // never destroyed either, a free may be waiting on an arena lock while its heap is released
+    static gosHeapArena* arenas = new (malloc(sizeof(gosHeapArena) * gosMaxHeaps)) gosHeapArena[gosMaxHeaps];
+    return arenas;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Page map: owner of every page regions and large blocks were ever allocated in.
+// Two levels, leaves are allocated the first time one of their pages is ours and
+// are never freed. Only entries of pages being allocated or released change.
+
+static const int gosPageShift = 16;
+static const size_t gosPageSize = (size_t)1 << gosPageShift;
+static const int gosPageMapLeafBits = 16;
+static const int gosAddressBits = sizeof(void*) == 8 ? 48 : 32;
+static const size_t gosPageMapRootSize = (size_t)1 << (gosAddressBits - gosPageShift - gosPageMapLeafBits);
+
+static_assert(gosRegionSize % gosPageSize == 0, "regions have to be made of whole pages");
+
+static const int16_t gosForeignPage = 0;    // not ours, blocks there came from malloc
+static const int16_t gosReleasedPage = -1;  // was ours, heap number + 1 otherwise
+
+typedef std::atomic<int16_t> gosPageOwner;
+
+static std::atomic<gosPageOwner*> g_pageMap[gosPageMapRootSize];
+
+static inline int getPageOwner(const void* ptr)
+{
+    const uintptr_t page = reinterpret_cast<uintptr_t>(ptr) >> gosPageShift;
+    const uintptr_t root = page >> gosPageMapLeafBits;
+    if(root >= gosPageMapRootSize)
+        return gosForeignPage;
+    gosPageOwner* leaf = g_pageMap[root].load(std::memory_order_acquire);
+    if(!leaf)
+        return gosForeignPage;
+    return leaf[page & (((uintptr_t)1 << gosPageMapLeafBits) - 1)].load(std::memory_order_acquire);
+}
+
+static bool setPageOwner(const void* start, size_t bytes, int16_t owner)
+{
+    const uintptr_t first = reinterpret_cast<uintptr_t>(start) >> gosPageShift;
+    const uintptr_t last = (reinterpret_cast<uintptr_t>(start) + bytes - 1) >> gosPageShift;
+    for(uintptr_t page = first; page <= last; ++page) {
+        const uintptr_t root = page >> gosPageMapLeafBits;
+        gosASSERT(root < gosPageMapRootSize);
+        gosPageOwner* leaf = g_pageMap[root].load(std::memory_order_acquire);
+        if(!leaf) {
+            // all zero bits is gosForeignPage
+            gosPageOwner* fresh = (gosPageOwner*)calloc((size_t)1 << gosPageMapLeafBits, sizeof(gosPageOwner));
+            if(!fresh)
+                return false;
+            if(g_pageMap[root].compare_exchange_strong(leaf, fresh, std::memory_order_acq_rel))
+                leaf = fresh;
+            else
+                free(fresh);
+        }
+        leaf[page & (((uintptr_t)1 << gosPageMapLeafBits) - 1)].store(owner, std::memory_order_release);
+    }
+    return true;
+}
+
+// whole pages, so no page is shared with memory which is not ours
+static void* allocPages(size_t bytes)
+{
+    gosASSERT(bytes % gosPageSize == 0);
+#ifdef PLATFORM_WINDOWS
+    void* p = _aligned_malloc(bytes, gosPageSize);
+#else
+    void* p = NULL;
+    if(posix_memalign(&p, gosPageSize, bytes))
+        p = NULL;
+#endif
+    if(p && ((reinterpret_cast<uintptr_t>(p) + bytes - 1) >> (gosPageShift + gosPageMapLeafBits)) >= gosPageMapRootSize) {
+        SPEW(("GAMEOS_MEMORY", "allocPages: %p is out of page map range\n", p));
+#ifdef PLATFORM_WINDOWS
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+        p = NULL;
+    }
+    return p;
+}
+
+// pages stay marked released, see gos_Free
+static void freePages(void* p, size_t bytes)
+{
+    setPageOwner(p, bytes, gosReleasedPage);
+#ifdef PLATFORM_WINDOWS
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+static inline size_t getLargeBlockPages(size_t bytes)
+{
+    return (sizeof(gosLargeBlock) + bytes + gosPageSize - 1) & ~(gosPageSize - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Regions of released heaps, pool lock is taken last
+
+static gosRegion* g_regionPool = NULL;
+static int g_numPooledRegions = 0;
+
+static std::mutex& getPoolLock()
+{
+    static std::mutex* lock = new (malloc(sizeof(std::mutex))) std::mutex();
+    return *lock;
+}
+
+static gosRegion* takePooledRegion()
+{
+    std::lock_guard<std::mutex> guard(getPoolLock());
+    gosRegion* region = g_regionPool;
+    if(region) {
+        g_regionPool = region->next_;
+        g_numPooledRegions--;
+    }
+    return region;
+}
+
+static void poolRegion(gosRegion* region)
+{
+    setPageOwner(region, gosRegionSize, gosReleasedPage);
+    {
+        std::lock_guard<std::mutex> guard(getPoolLock());
+        if(g_numPooledRegions < gosMaxPooledRegions) {
+            region->next_ = g_regionPool;
+            g_regionPool = region;
+            g_numPooledRegions++;
+            return;
+        }
+    }
+    freePages(region, gosRegionSize);
+}
+
+static thread_local gos_Heap* g_heapsStack[g_hepsStackSize];
+static thread_local int g_heapStackPointer = -1;
+
+////////////////////////////////////////////////////////////////////////////////
+// Size classes: 16 byte steps up to 128 bytes, then 4 classes per power of two
+
+static inline int getSizeClass(size_t bytes)
+{
+    if(bytes <= 128)
+        return bytes ? (int)((bytes + 15) / 16) - 1 : 0;
+
+    int shift = 7;
+    while(((size_t)2 << shift) < bytes)
+        shift++;
+    return 8 + (shift - 7) * 4 + (int)((bytes - 1 - ((size_t)1 << shift)) >> (shift - 2));
+}
+
+static inline size_t getClassSize(int size_class)
+{
+    if(size_class < 8)
+        return (size_t)(size_class + 1) * 16;
+    const int shift = 7 + (size_class - 8) / 4;
+    const int step = (size_class - 8) % 4 + 1;
+    return ((size_t)1 << shift) + step * ((size_t)1 << (shift - 2));
+}
+
+static inline uint32_t makeCheck(const gosBlockHeader* hdr)
+{
+    return hdr->magic_ ^ hdr->size_ ^ ((uint32_t)hdr->class_ << 16) ^ ((uint32_t)hdr->heap_ << 8) ^
+        (uint32_t)(reinterpret_cast<uintptr_t>(hdr) >> 4);
+}
+
+static inline void setHeader(gosBlockHeader* hdr, uint16_t size_class, uint8_t heap, uint8_t state, size_t bytes)
+{
+    hdr->magic_ = gosBlockMagic;
+    hdr->class_ = size_class;
+    hdr->heap_ = heap;
+    hdr->state_ = state;
+    hdr->size_ = (uint32_t)bytes;
+    hdr->check_ = makeCheck(hdr);
+}
+
+static inline bool isValidHeader(const gosBlockHeader* hdr)
+{
+    if(hdr->magic_ != gosBlockMagic || hdr->check_ != makeCheck(hdr))
+        return false;
+    return hdr->class_ == gosLargeBlockClass || hdr->class_ < gosNumSizeClasses;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Arena, all functions expect arena lock to be held
+
+static void initArena(gosHeapArena* arena, gos_Heap* heap)
+{
+    arena->heap_ = heap;
+    memset(arena->free_, 0, sizeof(arena->free_));
+    memset(arena->live_blocks_, 0, sizeof(arena->live_blocks_));
+    arena->regions_ = NULL;
+    arena->bump_ = NULL;
+    arena->bump_end_ = NULL;
+    arena->large_ = NULL;
+    arena->num_large_ = 0;
+    arena->over_budget_reported_ = false;
+}
+
+// puts what is left of the current region to free lists, so nothing is wasted
+static void retireBumpRegion(gosHeapArena* arena, uint8_t heap)
+{
+    size_t left = arena->bump_end_ - arena->bump_;
+    for(int c = gosNumSizeClasses - 1; c >= 0 && left >= sizeof(gosBlockHeader) + 16; ) {
+        const size_t block_size = sizeof(gosBlockHeader) + getClassSize(c);
+        if(block_size > left) {
+            --c;
+            continue;
+        }
+        gosFreeBlock* fb = reinterpret_cast<gosFreeBlock*>(arena->bump_);
+        setHeader(&fb->hdr_, (uint16_t)c, heap, gosBlockFree, 0);
+        fb->next_ = arena->free_[c];
+        arena->free_[c] = fb;
+        arena->bump_ += block_size;
+        left -= block_size;
+    }
+    arena->bump_ = arena->bump_end_ = NULL;
+}
+
+static gosBlockHeader* arenaAllocSmall(gos_Heap* heap, int size_class)
+{
+    gosHeapArena* arena = heap->pArena;
+
+    gosFreeBlock* fb = arena->free_[size_class];
+    if(fb) {
+        arena->free_[size_class] = fb->next_;
+        return &fb->hdr_;
+    }
+
+    const size_t block_size = sizeof(gosBlockHeader) + getClassSize(size_class);
+    if(arena->bump_ + block_size > arena->bump_end_) {
+        if(arena->bump_)
+            retireBumpRegion(arena, heap->HeapNumber);
+
+        gosRegion* region = takePooledRegion();
+        if(!region) {
+            region = (gosRegion*)allocPages(gosRegionSize);
+            if(!region)
+                return NULL;
+        }
+        if(!setPageOwner(region, gosRegionSize, (int16_t)(heap->HeapNumber + 1))) {
+            poolRegion(region);
+            return NULL;
+        }
+        region->next_ = arena->regions_;
+        region->size_ = gosRegionSize;
+        arena->regions_ = region;
+        heap->ReservedBytes += gosRegionSize;
+
+        arena->bump_ = reinterpret_cast<char*>(region) + gosRegionHeaderSize;
+        arena->bump_end_ = reinterpret_cast<char*>(region) + gosRegionSize;
+    }
+
+    gosBlockHeader* hdr = reinterpret_cast<gosBlockHeader*>(arena->bump_);
+    arena->bump_ += block_size;
+    return hdr;
+}
+
+static gosBlockHeader* arenaAllocLarge(gos_Heap* heap, size_t bytes)
+{
+    gosHeapArena* arena = heap->pArena;
+
+    const size_t pages = getLargeBlockPages(bytes);
+    gosLargeBlock* lb = (gosLargeBlock*)allocPages(pages);
+    if(!lb)
+        return NULL;
+    if(!setPageOwner(lb, pages, (int16_t)(heap->HeapNumber + 1))) {
+        freePages(lb, pages);
+        return NULL;
+    }
+    lb->prev_ = NULL;
+    lb->next_ = arena->large_;
+    if(arena->large_)
+        arena->large_->prev_ = lb;
+    arena->large_ = lb;
+    arena->num_large_++;
+    heap->ReservedBytes += pages;
+    return &lb->hdr_;
+}
+
+static void arenaFreeLarge(gos_Heap* heap, gosBlockHeader* hdr)
+{
+    gosHeapArena* arena = heap->pArena;
+    gosLargeBlock* lb = reinterpret_cast<gosLargeBlock*>(reinterpret_cast<char*>(hdr) - offsetof(gosLargeBlock, hdr_));
+
+    if(lb->prev_)
+        lb->prev_->next_ = lb->next_;
+    else
+        arena->large_ = lb->next_;
+    if(lb->next_)
+        lb->next_->prev_ = lb->prev_;
+    arena->num_large_--;
+    const size_t pages = getLargeBlockPages(hdr->size_);
+    heap->ReservedBytes -= pages;
+
+    hdr->magic_ = 0;
+    freePages(lb, pages);
+}
+
+// releases all memory owned by arena regardless of whether blocks are still in use
+static void arenaReleaseAll(gos_Heap* heap)
+{
+    gosHeapArena* arena = heap->pArena;
+
+    gosRegion* region = arena->regions_;
+    while(region) {
+        gosRegion* next = region->next_;
+        poolRegion(region);
+        region = next;
+    }
+    gosLargeBlock* lb = arena->large_;
+    while(lb) {
+        gosLargeBlock* next = lb->next_;
+        freePages(lb, getLargeBlockPages(lb->hdr_.size_));
+        lb = next;
+    }
+    initArena(arena, NULL);
+
+    heap->LiveBytes = 0;
+    heap->LiveBlocks = 0;
+    heap->ReservedBytes = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Heap list, all functions expect heap list lock to be held
+
+static gos_Heap* createHeap(const char* HeapName, DWORD MaximumSize, gos_Heap* parent)
+{
+    gos_Heap* pheap = (gos_Heap*)malloc(sizeof(gos_Heap));
+    memset(pheap, 0, sizeof(gos_Heap));
+    pheap->pParent = parent;
+    pheap->Magic = (DWORD)(reinterpret_cast<size_t>(HeapName) & 0xffffffff);
+    if(HeapName) {
+        strncpy(pheap->Name, HeapName, sizeof(pheap->Name)-1);
+        pheap->Name[sizeof(pheap->Name)-1] = '\0';
+    }
+#ifdef LAB_ONLY
+    pheap->BytesAllocated = 0;
+    pheap->MaximumSize = MaximumSize;
+#endif
+
+    for(int i = 0; i < gosMaxHeaps; ++i) {
+        if(!HeapList[i]) {
+            HeapList[i] = pheap;
+            pheap->HeapNumber = (BYTE)i;
+            pheap->pArena = &getArenas()[i];
+            std::lock_guard<std::mutex> guard(pheap->pArena->lock_);
+            initArena(pheap->pArena, pheap);
+            break;
+        }
+    }
+    // out of heap numbers, allocations will be made from first ancestor which has an arena
+    if(!pheap->pArena) {
+        SPEW(("GAMEOS_MEMORY", "gos_CreateMemoryHeap: too many heaps, \"%s\" will share memory with its parent\n", pheap->Name));
+    }
+
+    if(parent) {
+        pheap->pNext = parent->pChild;
+        parent->pChild = pheap;
+    }
+    return pheap;
+}
+
+static void unlinkHeap(gos_Heap* pheap)
+{
+    if(!pheap->pParent)
+        return;
+    gos_Heap** link = &pheap->pParent->pChild;
+    while(*link && *link != pheap)
+        link = &(*link)->pNext;
+    if(*link)
+        *link = pheap->pNext;
+    pheap->pParent = NULL;
+    pheap->pNext = NULL;
+}
+
+static void releaseHeap(gos_Heap* pheap)
+{
+    if(pheap->pArena) {
+        {
+            // frees waiting on the lock see the pages released once they get it
+            std::lock_guard<std::mutex> guard(pheap->pArena->lock_);
+            arenaReleaseAll(pheap);
+        }
+        HeapList[pheap->HeapNumber] = NULL;
+    }
+    free(pheap);
+}
+
+static gos_Heap* createClientHeap()
+{
+    std::lock_guard<std::mutex> guard(getHeapListLock());
+    return createHeap("Client", 0, NULL);
+}
+
+// default heap and root of all other heaps, created on first allocation
+static gos_Heap* getClientHeap()
+{
+    static gos_Heap* client_heap = createClientHeap();
+    return client_heap;
+}
+
+static inline gos_Heap* resolveHeap(gos_Heap* heap)
+{
+    while(heap && !heap->pArena)
+        heap = heap->pParent;
+    return heap ? heap : getClientHeap();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+HGOSHEAP __stdcall gos_CreateMemoryHeap(char const* HeapName, DWORD MaximumSize/* = 0*/, HGOSHEAP parentHeap/* = ParentClientHeap*/)
+{
+    gos_Heap* parent = parentHeap ? parentHeap : getClientHeap();
+    std::lock_guard<std::mutex> guard(getHeapListLock());
+    return createHeap(HeapName, MaximumSize, parent);
+}
+
+static void destroyHeap(gos_Heap* pheap, bool shouldBeEmpty)
+{
+    while(pheap->pChild)
+        destroyHeap(pheap->pChild, shouldBeEmpty);
+
+    unlinkHeap(pheap);
+
+    if(!pheap->pArena) {
+        free(pheap);
+        return;
+    }
+
+    DWORD live_blocks;
+    {
+        std::lock_guard<std::mutex> guard(pheap->pArena->lock_);
+        pheap->bDestroyed = true;
+        live_blocks = pheap->LiveBlocks;
+    }
+
+    if(live_blocks && shouldBeEmpty) {
+        // keep it around until last block is freed, so that pointers which are still
+        // held by client stay valid
+        SPEW(("GAMEOS_MEMORY", "gos_DestroyMemoryHeap: \"%s\" still has %u blocks (%u bytes) allocated\n",
+                    pheap->Name, (unsigned)live_blocks, (unsigned)pheap->LiveBytes));
+        return;
+    }
+
+    releaseHeap(pheap);
+}
+
+void __stdcall gos_DestroyMemoryHeap(HGOSHEAP Heap, bool shouldBeEmpty/* = true*/)
+{
+    if(!Heap)
+        return;
+    gosASSERT(Heap != getClientHeap());
+
+    std::lock_guard<std::mutex> guard(getHeapListLock());
+    gosASSERT(!Heap->bDestroyed);
+    destroyHeap(Heap, shouldBeEmpty);
+}
+
+void __stdcall gos_PushCurrentHeap(HGOSHEAP Heap)
+{
+    gosASSERT(g_heapStackPointer < g_hepsStackSize - 1);
+    g_heapsStack[++g_heapStackPointer] = Heap;
+}
+void __stdcall gos_PopCurrentHeap()
+{
+    gosASSERT(g_heapStackPointer >= 0 && g_heapStackPointer < g_hepsStackSize);
+    g_heapsStack[g_heapStackPointer--] = nullptr;
+}
+
+HGOSHEAP __stdcall gos_GetCurrentHeap()
+{
+    if(g_heapStackPointer == -1)
+        return NULL;
+    return g_heapsStack[g_heapStackPointer];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+struct gosHeapStats {
+    char name[128];
+    size_t live_bytes;
+    size_t peak_bytes;
+    size_t reserved_bytes;
+    DWORD live_blocks;
+    DWORD large_blocks;
+    DWORD free_blocks;
+    DWORD class_blocks[gosNumSizeClasses];
+    bool destroyed;
+};
+
+// checks everything which can be reached from arena without touching blocks in use
+static bool walkArena(gos_Heap* heap, gosHeapStats& stats)
+{
+    gosHeapArena* arena = heap->pArena;
+    bool ok = true;
+
+    memset(&stats, 0, sizeof(stats));
+    strncpy(stats.name, heap->Name, sizeof(stats.name) - 1);
+
+    for(int c = 0; c < gosNumSizeClasses; ++c) {
+        for(gosFreeBlock* fb = arena->free_[c]; fb; fb = fb->next_) {
+            if(!isValidHeader(&fb->hdr_) || fb->hdr_.state_ != gosBlockFree || fb->hdr_.class_ != c || fb->hdr_.heap_ != heap->HeapNumber) {
+                ok = false;
+                break;
+            }
+            stats.free_blocks++;
+        }
+        stats.class_blocks[c] = arena->live_blocks_[c];
+    }
+
+    size_t large_bytes = 0;
+    for(gosLargeBlock* lb = arena->large_; lb; lb = lb->next_) {
+        if(!isValidHeader(&lb->hdr_) || lb->hdr_.state_ != gosBlockAllocated || lb->hdr_.heap_ != heap->HeapNumber ||
+                (lb->next_ && lb->next_->prev_ != lb)) {
+            ok = false;
+            break;
+        }
+        large_bytes += lb->hdr_.size_;
+        stats.large_blocks++;
+    }
+
+    if(large_bytes > heap->LiveBytes || stats.large_blocks != arena->num_large_)
+        ok = false;
+
+    stats.live_bytes = heap->LiveBytes;
+    stats.peak_bytes = heap->PeakBytes;
+    stats.reserved_bytes = heap->ReservedBytes;
+    stats.live_blocks = heap->LiveBlocks;
+    stats.destroyed = heap->bDestroyed;
+    return ok;
+}
+
+static void reportHeap(const gosHeapStats& stats, bool vociferous)
+{
+    SPEW(("GAMEOS_MEMORY", "%-32s live: %8u bytes in %6u blocks, peak: %8u, reserved: %8u%s\n",
+                stats.name, (unsigned)stats.live_bytes, (unsigned)stats.live_blocks,
+                (unsigned)stats.peak_bytes, (unsigned)stats.reserved_bytes,
+                stats.destroyed ? " (destroyed)" : ""));
+    if(!vociferous)
+        return;
+
+    for(int c = 0; c < gosNumSizeClasses; ++c) {
+        if(stats.class_blocks[c]) {
+            SPEW(("GAMEOS_MEMORY", "    %5u bytes: %6u blocks\n", (unsigned)getClassSize(c), (unsigned)stats.class_blocks[c]));
+        }
+    }
+    SPEW(("GAMEOS_MEMORY", "    large: %u blocks, free: %u blocks\n", (unsigned)stats.large_blocks, (unsigned)stats.free_blocks));
+}
+
+void __stdcall gos_WalkMemoryHeap(HGOSHEAP pHeap, bool vociferous/* = false*/)
+{
+    // SPEW may allocate, so only collect stats while holding locks
+    gosHeapStats stats;
+    if(pHeap) {
+        gos_Heap* heap = resolveHeap(pHeap);
+        bool ok;
+        {
+            std::lock_guard<std::mutex> guard(heap->pArena->lock_);
+            ok = walkArena(heap, stats);
+        }
+        if(!ok) {
+            STOP(("Memory heap \"%s\" is corrupted", stats.name));
+        }
+        reportHeap(stats, vociferous);
+        return;
+    }
+
+    getClientHeap();
+    for(int i = 0; i < gosMaxHeaps; ++i) {
+        bool ok;
+        {
+            std::lock_guard<std::mutex> list_guard(getHeapListLock());
+            gos_Heap* heap = HeapList[i];
+            if(!heap)
+                continue;
+            std::lock_guard<std::mutex> guard(heap->pArena->lock_);
+            ok = walkArena(heap, stats);
+        }
+        if(!ok) {
+            STOP(("Memory heap \"%s\" is corrupted", stats.name));
+        }
+        reportHeap(stats, vociferous);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void* operator new(size_t sz) {
+    return gos_Malloc(sz, NULL);
+}
+void operator delete(void* ptr)
+#ifndef PLATFORM_WINDOWS
+noexcept
+#endif
+{
+    gos_Free(ptr);
+}
+
+void* __cdecl operator new(size_t size, HGOSHEAP Heap)
+{
+    return gos_Malloc(size, Heap);
+}
+
+void* __cdecl operator new[](size_t size, HGOSHEAP Heap)
+{
+    return gos_Malloc(size, Heap);
+}
+
+void* __stdcall gos_Malloc(size_t bytes, HGOSHEAP Heap/* = 0*/)
+{
+    gos_Heap* heap = resolveHeap(Heap ? Heap : gos_GetCurrentHeap());
+    gosASSERT(!heap->bDestroyed);
+
+    const bool large = !GOS_USE_HEAP_ARENAS || bytes > gosLargestArenaBlock;
+    const int size_class = large ? -1 : getSizeClass(bytes);
+
+    bool over_budget = false;
+    gosBlockHeader* hdr;
+    {
+        std::lock_guard<std::mutex> guard(heap->pArena->lock_);
+
+        hdr = large ? arenaAllocLarge(heap, bytes) : arenaAllocSmall(heap, size_class);
+        if(!hdr)
+            return NULL;
+        setHeader(hdr, large ? gosLargeBlockClass : (uint16_t)size_class, heap->HeapNumber, gosBlockAllocated, bytes);
+
+        if(!large)
+            heap->pArena->live_blocks_[size_class]++;
+        heap->LiveBlocks++;
+        heap->LiveBytes += bytes;
+        if(heap->LiveBytes > heap->PeakBytes)
+            heap->PeakBytes = heap->LiveBytes;
+
+#ifdef LAB_ONLY
+        heap->BytesAllocated += (int)bytes;
+        heap->TotalAllocations++;
+        heap->PeakSize = (int)heap->PeakBytes;
+        if(large) {
+            heap->LargeAllocations++;
+            heap->LargeAllocated += (int)bytes;
+        }
+        if(heap->MaximumSize && heap->LiveBytes > heap->MaximumSize && !heap->pArena->over_budget_reported_) {
+            heap->pArena->over_budget_reported_ = true;
+            over_budget = true;
+        }
+#endif
+    }
+
+    if(over_budget) {
+        SPEW(("GAMEOS_MEMORY", "heap \"%s\" is over its maximum size\n", heap->Name));
+    }
+
+    return hdr + 1;
+}
+
+void __stdcall gos_Free(void* ptr)
+{
+    if(!ptr)
+        return;
+
+    gosBlockHeader* hdr = reinterpret_cast<gosBlockHeader*>(ptr) - 1;
+
+    // header of a block which is not ours may be in the last page of one of ours
+    const int owner = getPageOwner(ptr);
+    if(owner == gosForeignPage) {
+        // not ours (e.g. allocated by a library with malloc), every page a heap ever
+        // had is marked in page map so no gos block can end up here
+        free(ptr);
+        return;
+    }
+
+    if(owner != gosReleasedPage) {
+        gosHeapArena* arena = &getArenas()[owner - 1];
+        {
+            std::unique_lock<std::mutex> guard(arena->lock_);
+
+            // heap may have been released while we were waiting for the lock
+            gos_Heap* heap = arena->heap_;
+            if(heap && getPageOwner(ptr) == owner) {
+                if(!isValidHeader(hdr) || hdr->heap_ != owner - 1) {
+                    guard.unlock();
+                    PAUSE(("gos_Free: %p is not a block of heap \"%s\"", ptr, heap->Name));
+                    return;
+                }
+                if(hdr->state_ != gosBlockAllocated) {
+                    guard.unlock();
+                    PAUSE(("gos_Free: block at %p was already freed", ptr));
+                    return;
+                }
+
+                const size_t bytes = hdr->size_;
+                heap->LiveBlocks--;
+                heap->LiveBytes -= bytes;
+#ifdef LAB_ONLY
+                heap->BytesAllocated -= (int)bytes;
+                if(hdr->class_ == gosLargeBlockClass)
+                    heap->LargeAllocated -= (int)bytes;
+#endif
+
+                if(hdr->class_ == gosLargeBlockClass) {
+                    arenaFreeLarge(heap, hdr);
+                } else {
+                    const int size_class = hdr->class_;
+                    arena->live_blocks_[size_class]--;
+                    setHeader(hdr, (uint16_t)size_class, heap->HeapNumber, gosBlockFree, 0);
+                    gosFreeBlock* fb = reinterpret_cast<gosFreeBlock*>(hdr);
+                    fb->next_ = arena->free_[size_class];
+                    arena->free_[size_class] = fb;
+                }
+
+                const bool release = heap->bDestroyed && 0 == heap->LiveBlocks;
+                guard.unlock();
+
+                // last block of a heap destroyed while it was still in use
+                if(release) {
+                    std::lock_guard<std::mutex> list_guard(getHeapListLock());
+                    releaseHeap(heap);
+                }
+                return;
+            }
+        }
+    }
+
+    SPEW(("GAMEOS_MEMORY", "gos_Free: block at %p belongs to a released heap, ignored\n", ptr));
+}
@@ -0,0 +1,214 @@
+#include "gameos.hpp"
+#include "utils/timing.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+// Zone profiler, see ZONE PROFILER in gameos.hpp.
+//
+// Every thread that records gets a ring buffer of its own so recording
+// never takes a lock. Buffers are kept when their thread exits (so short
+// lived worker threads still show up in a capture) and handed to the next
+// new thread, which gets a new trace thread id.
+
+static const uint32_t RING_SIZE = 1 << 18;  // events per thread, must be a power of 2
+
+struct ProfileEvent {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+    uint32_t tid;
+};
+
+struct ProfileThreadBuffer {
+    ProfileEvent* events;
+    std::atomic<uint64_t> head;
+    uint32_t tid;
+    const char* name;
+    bool in_use;
+};
+
+volatile bool gos_ProfilerActive = false;
+
+static std::mutex g_lock;
+static std::vector<ProfileThreadBuffer*> g_buffers;
+static uint32_t g_next_tid = 1;
+static uint64_t g_record_start = 0;
+
+static uint64_t g_frame_start = 0;
+static std::string g_capture_file;
+static DWORD g_capture_frames = 0;
+static DWORD g_capture_delay = 0;
+static DWORD g_capture_left = 0;
+
+static thread_local ProfileThreadBuffer* t_buffer = NULL;
+
+// gives the buffer back when its thread exits
+struct ProfileThreadBufferOwner {
+    ~ProfileThreadBufferOwner() {
+        if(t_buffer) {
+            std::lock_guard<std::mutex> guard(g_lock);
+            t_buffer->in_use = false;
+            t_buffer = NULL;
+        }
+    }
+};
+static thread_local ProfileThreadBufferOwner t_owner;
+
+static ProfileThreadBuffer* acquire_buffer()
+{
+    (void)&t_owner;
+
+    std::lock_guard<std::mutex> guard(g_lock);
+    ProfileThreadBuffer* b = NULL;
+    for(size_t i=0; i<g_buffers.size(); ++i) {
+        if(!g_buffers[i]->in_use) {
+            b = g_buffers[i];
+            break;
+        }
+    }
+    if(!b) {
+        b = new ProfileThreadBuffer;
+        b->events = new ProfileEvent[RING_SIZE];
+        b->head = 0;
+        g_buffers.push_back(b);
+    }
+    b->tid = g_next_tid++;
+    b->name = NULL;
+    b->in_use = true;
+    t_buffer = b;
+    return b;
+}
+
+unsigned __int64 __stdcall gos_ProfilerTime()
+{
+    return timing::get_time_ns();
+}
+
+void __stdcall gos_ProfilerRecord(const char* Name, unsigned __int64 Start)
+{
+    uint64_t end = timing::get_time_ns();
+    ProfileThreadBuffer* b = t_buffer ? t_buffer : acquire_buffer();
+
+    uint64_t h = b->head.load(std::memory_order_relaxed);
+    ProfileEvent& e = b->events[h & (RING_SIZE - 1)];
+    e.name = Name;
+    e.start = Start;
+    e.end = end;
+    e.tid = b->tid;
+    b->head.store(h + 1, std::memory_order_release);
+}
+
+void __stdcall gos_ProfilerSetThreadName(const char* Name)
+{
+    ProfileThreadBuffer* b = t_buffer ? t_buffer : acquire_buffer();
+    b->name = Name;
+}
+
+void __stdcall gos_ProfilerEnable(bool Enable)
+{
+    if(Enable && !gos_ProfilerActive)
+        g_record_start = timing::get_time_ns();
+    gos_ProfilerActive = Enable;
+}
+
+void __stdcall gos_ProfilerCapture(const char* FileName, DWORD NumFrames, DWORD DelayFrames)
+{
+    if(!FileName || !NumFrames)
+        return;
+
+    g_capture_file = FileName;
+    g_capture_frames = NumFrames;
+    g_capture_delay = DelayFrames + 1;  // recording starts at the next frame boundary
+    g_capture_left = 0;
+}
+
+void __stdcall gos_ProfilerEndFrame()
+{
+    if(gos_ProfilerActive && g_frame_start)
+        gos_ProfilerRecord("Frame", g_frame_start);
+
+    if(g_capture_delay) {
+        if(0 == --g_capture_delay) {
+            gos_ProfilerEnable(true);
+            g_capture_left = g_capture_frames;
+        }
+    } else if(g_capture_left) {
+        if(0 == --g_capture_left) {
+            gos_ProfilerWrite(g_capture_file.c_str());
+            gos_ProfilerEnable(false);
+        }
+    }
+
+    g_frame_start = timing::get_time_ns();
+}
+
+static void write_json_string(FILE* f, const char* s)
+{
+    fputc('"', f);
+    for(; *s; ++s) {
+        if(*s == '"' || *s == '\\')
+            fputc('\\', f);
+        if((unsigned char)*s >= 0x20)
+            fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+bool __stdcall gos_ProfilerWrite(const char* FileName)
+{
+    FILE* f = fopen(FileName, "w");
+    if(!f) {
+        SPEWALWAYS(("PROFILER", "Could not open %s\n", FileName));
+        return false;
+    }
+
+    // Threads keep recording while this runs. An event can only be torn if
+    // its thread laps the whole ring meanwhile, which a frame never does.
+    std::lock_guard<std::mutex> guard(g_lock);
+
+    uint64_t num_events = 0;
+    bool overflowed = false;
+    bool first = true;
+
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for(size_t i=0; i<g_buffers.size(); ++i) {
+        ProfileThreadBuffer* b = g_buffers[i];
+
+        if(b->in_use && b->name) {
+            fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", b->tid);
+            write_json_string(f, b->name);
+            fprintf(f, "}}");
+            first = false;
+        }
+
+        uint64_t head = b->head.load(std::memory_order_acquire);
+        uint64_t tail = head > RING_SIZE ? head - RING_SIZE : 0;
+        if(tail && b->events[tail & (RING_SIZE - 1)].start >= g_record_start)
+            overflowed = true;
+
+        for(uint64_t n=tail; n<head; ++n) {
+            const ProfileEvent& e = b->events[n & (RING_SIZE - 1)];
+            if(e.start < g_record_start || e.end < e.start)
+                continue;
+
+            fprintf(f, "%s{\"name\":", first ? "" : ",\n");
+            write_json_string(f, e.name);
+            fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    e.tid, (double)(e.start - g_record_start) * 1e-3, (double)(e.end - e.start) * 1e-3);
+            first = false;
+            ++num_events;
+        }
+    }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+
+    SPEWALWAYS(("PROFILER", "Wrote %llu zones to %s\n", (unsigned long long)num_events, FileName));
+    if(overflowed)
+        SPEWALWAYS(("PROFILER", "A thread filled its ring buffer, its oldest zones are missing\n"));
+    return true;
+}
@@ -226,6 +226,12 @@ void __stdcall gosAudio_CreateResource( HGOSAUDIO* hgosaudio, enum gosAudio_Reso
     gosASSERT(hgosaudio);
     gosASSERT((res_type == gosAudio_UserMemory && data && ga_wf) || (res_type == gosAudio_StreamedFile && file_name));
 
+    // no audio device (failed to init or running headless): hand out null resources
+    if(!g_sound_engine) {
+        *hgosaudio = NULL;
+        return;
+    }
+
 	//WORD  wFormatTag;				// Waveform-audio format type. 1=PCM, 2=Microsoft ADPCM.
 	//WORD  nChannels; 				// 1=Mono, 2=Stereo.
     //DWORD nSamplesPerSec;			// Sample rate, 11025Hz, 22050Hz or 44100Hz.
@@ -392,7 +398,11 @@ void __stdcall gosAudio_CreateResource( HGOSAUDIO* hgosaudio, enum gosAudio_Reso
 //
 void __stdcall gosAudio_DestroyResource( HGOSAUDIO* hgosaudio )
 {
-    gosASSERT(g_sound_engine && hgosaudio);
+    gosASSERT(hgosaudio);
+    if(!g_sound_engine) {
+        *hgosaudio = NULL;
+        return;
+    }
 
     gosAudio* audio = (gosAudio*)*hgosaudio;
     gosAudio_ChannelInfo* pci = g_sound_engine->getChannelsInfo();
@@ -420,7 +430,8 @@ void __stdcall gosAudio_DestroyResource( HGOSAUDIO* hgosaudio )
 //
 void __stdcall gosAudio_AllocateChannelSliders( int Channel, DWORD properties)
 {
-    gosASSERT(g_sound_engine);
+    if(!g_sound_engine)
+        return;
     gosASSERT(g_sound_engine->NUM_CHANNELS > Channel);
     gosAudio_ChannelInfo* ci = g_sound_engine->getChannel(Channel);
     if(!ci)
@@ -435,7 +446,8 @@ void __stdcall gosAudio_AllocateChannelSliders( int Channel, DWORD properties)
 //
 void __stdcall gosAudio_AssignResourceToChannel( int Channel, HGOSAUDIO hgosaudio)
 {
-    gosASSERT(g_sound_engine);
+    if(!g_sound_engine)
+        return;
     gosASSERT(g_sound_engine->NUM_CHANNELS > Channel);
     gosAudio_ChannelInfo* ci = g_sound_engine->getChannel(Channel);
     if(!ci)
@@ -452,7 +464,8 @@ void __stdcall gosAudio_AssignResourceToChannel( int Channel, HGOSAUDIO hgosaudi
 //  volume and balance
 void __stdcall gosAudio_SetChannelSlider( int Channel, enum gosAudio_Properties prop, float value1, float value2, float value3)
 {
-    gosASSERT(g_sound_engine);
+    if(!g_sound_engine)
+        return;
     gosASSERT(g_sound_engine->NUM_CHANNELS > Channel);
     gosAudio_ChannelInfo* ci = g_sound_engine->getChannel(Channel);
     if(!ci)
@@ -497,7 +510,11 @@ void __stdcall gosAudio_SetChannelSlider( int Channel, enum gosAudio_Properties
 
 void __stdcall gosAudio_GetChannelSlider( int Channel, enum gosAudio_Properties prop, float* value1, float* value2, float* value3)
 {
-    gosASSERT(g_sound_engine);
+    if(!g_sound_engine) {
+        gosASSERT(value1);
+        *value1 = 0.0f;
+        return;
+    }
     gosASSERT(g_sound_engine->NUM_CHANNELS > Channel);
     gosAudio_ChannelInfo* ci = g_sound_engine->getChannel(Channel);
     if(!ci)
@@ -524,7 +541,8 @@ void __stdcall gosAudio_GetChannelSlider( int Channel, enum gosAudio_Properties
 //
 void __stdcall gosAudio_SetChannelPlayMode( int Channel, enum gosAudio_PlayMode ga_pm )
 {
-    gosASSERT(g_sound_engine);
+    if(!g_sound_engine)
+        return;
     gosASSERT(g_sound_engine->NUM_CHANNELS > Channel);
     gosAudio_ChannelInfo* ci = g_sound_engine->getChannel(Channel);
     if(!ci)
@@ -566,7 +584,8 @@ void __stdcall gosAudio_SetChannelPlayMode( int Channel, enum gosAudio_PlayMode
 //
 gosAudio_PlayMode __stdcall gosAudio_GetChannelPlayMode( int Channel )
 {
-    gosASSERT(g_sound_engine);
+    if(!g_sound_engine)
+        return gosAudio_Stop;
     gosASSERT(g_sound_engine->NUM_CHANNELS > Channel);
     gosAudio_ChannelInfo* ci = g_sound_engine->getChannel(Channel);
     if(!ci) {
@@ -1,6 +1,7 @@
 #include "gameos.hpp"
 #include "gos_render.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
 
 #include <SDL2/SDL.h>
@@ -10,6 +11,7 @@
 #include "utils/shader_builder.h"
 #include "utils/gl_utils.h"
 #include "utils/timing.h"
+#include "utils/frame_pacer.h"
 
 #include <signal.h>
 
@@ -27,8 +29,15 @@ extern bool gosExitGameOS();
 extern bool gos_CreateAudio();
 extern void gos_DestroyAudio();
 
+extern void gos_CreateNullRenderer(int w, int h);
+extern void gos_DestroyNullRenderer();
+extern void gosSetHeadless(bool headless);
+
 static bool g_exit = false;
 static bool g_focus_lost = false;
+static frame_pacer g_pacer;
+static const char* g_profile_file = "profile.json";
+static int g_profile_frames = 300;
 #if 0
 static camera g_camera;
 #endif
@@ -43,6 +52,10 @@ static void handle_key_down( SDL_Keysym* keysym ) {
             if(keysym->mod & KMOD_RALT)
                 gos_RenderEnableDebugDrawCalls();
             break;
+        case 'p':
+            if(keysym->mod & KMOD_RALT)
+                gos_ProfilerCapture(g_profile_file, g_profile_frames);
+            break;
     }
 }
 
@@ -223,10 +236,89 @@ void GLAPIENTRY OpenGLDebugLog(GLenum source, GLenum type, GLuint id, GLenum sev
 }
 
 #ifndef DISABLE_GAMEOS_MAIN
+// --headless: no window, GL context or audio device, game logic is stepped
+// back to back with a fixed frame rate (--headless-fps, 30 by default)
+static int run_headless(float fixed_fps)
+{
+    gos_CreateNullRenderer(Environment.screenWidth, Environment.screenHeight);
+
+    Environment.InitializeGameEngine();
+
+    timing::init();
+
+    uint64_t num_frames = 0;
+    uint64_t start_tick = timing::gettickcount();
+
+    while( !g_exit ) {
+
+        // game converts this to frameLength, so every frame advances simulation by the same amount
+        frameRate = fixed_fps;
+
+        Environment.DoGameLogic();
+        ++num_frames;
+
+        g_exit |= gosExitGameOS();
+
+        gos_ProfilerEndFrame();
+    }
+
+    uint64_t dt = timing::ticks2ms(timing::gettickcount() - start_tick);
+    SPEW(("HEADLESS", "%llu frames in %llu ms\n", (unsigned long long)num_frames, (unsigned long long)dt));
+
+    Environment.TerminateGameEngine();
+
+    gos_DestroyNullRenderer();
+
+    return 0;
+}
+
 int main(int argc, char** argv)
 {
     //signal(SIGTRAP, SIG_IGN);
 
+    bool headless = false;
+    float headless_fps = 30.0f;
+    // --fps: frame cap, 0 leaves pacing to vsync (or runs uncapped with --no-vsync)
+    // --logic-hz: step game logic at a fixed rate instead of once per frame
+    float target_fps = 0.0f;
+    float logic_hz = 0.0f;
+    bool vsync = true;
+    // --profile-frames: write a trace of that many frames to --profile-file,
+    // after skipping --profile-start frames. Right Alt+P captures at any time.
+    int profile_start = 0;
+    bool profile = false;
+    for(int i=1;i<argc;++i) {
+        if(0 == strcmp(argv[i], "--headless")) {
+            headless = true;
+        } else if(0 == strcmp(argv[i], "--headless-fps") && i+1 < argc) {
+            headless_fps = (float)atof(argv[++i]);
+            if(headless_fps <= 0.0f)
+                headless_fps = 30.0f;
+        } else if(0 == strcmp(argv[i], "--fps") && i+1 < argc) {
+            target_fps = (float)atof(argv[++i]);
+        } else if(0 == strcmp(argv[i], "--logic-hz") && i+1 < argc) {
+            logic_hz = (float)atof(argv[++i]);
+        } else if(0 == strcmp(argv[i], "--no-vsync")) {
+            vsync = false;
+        } else if(0 == strcmp(argv[i], "--profile-frames") && i+1 < argc) {
+            g_profile_frames = atoi(argv[++i]);
+            profile = g_profile_frames > 0;
+            if(!profile)
+                g_profile_frames = 300;
+        } else if(0 == strcmp(argv[i], "--profile-start") && i+1 < argc) {
+            profile_start = atoi(argv[++i]);
+            if(profile_start < 0)
+                profile_start = 0;
+        } else if(0 == strcmp(argv[i], "--profile-file") && i+1 < argc) {
+            g_profile_file = argv[++i];
+        }
+    }
+    gosSetHeadless(headless);
+
+    gos_ProfilerSetThreadName("Main");
+    if(profile)
+        gos_ProfilerCapture(g_profile_file, g_profile_frames, profile_start);
+
     // gather command line
 	size_t cmdline_len = 0;
     for(int i=0;i<argc;++i) {
@@ -249,6 +341,9 @@ int main(int argc, char** argv)
     delete[] cmdline;
     cmdline = NULL;
 
+    if(headless)
+        return run_headless(headless_fps);
+
     int w = Environment.screenWidth;
     int h = Environment.screenHeight;
 
@@ -256,6 +351,7 @@ int main(int argc, char** argv)
     if(!win)
         return 1;
 
+    graphics::set_vsync(vsync);
     graphics::RenderContextHandle ctx = graphics::init_render_context(win);
     if(!ctx)
         return 1;
@@ -320,19 +416,39 @@ int main(int argc, char** argv)
 
 	timing::init();
 
+    // asked for vsync but did not get it, don't let the loop spin flat out
+    if(vsync && target_fps <= 0.0f && !graphics::is_vsync_enabled()) {
+        SPEW(("GRAPHICS", "No vsync, capping at 60 fps\n"));
+        target_fps = 60.0f;
+    }
+    g_pacer.set_target_fps(target_fps);
+    g_pacer.set_logic_rate(logic_hz);
+
+    frame_pacer::stats* fstats = g_pacer.get_stats_ptr();
+    StatisticFormat("Frame pacing");
+    AddStatistic("Frame time p50", "ms", gos_float, &fstats->p50_ms, Stat_2DP);
+    AddStatistic("Frame time p95", "ms", gos_float, &fstats->p95_ms, Stat_2DP);
+    AddStatistic("Frame time p99", "ms", gos_float, &fstats->p99_ms, Stat_2DP);
+    AddStatistic("Frame time max", "ms", gos_float, &fstats->max_ms, Stat_2DP);
+    AddStatistic("Frame rate", "Hz", gos_float, &fstats->fps, Stat_1DP | Stat_Graph);
+
     while( !g_exit ) {
 
-		uint64_t start_tick = timing::gettickcount();
-		timing::sleep(10*1000000);
+        int logic_steps = g_pacer.begin_frame();
 
         if(gos_RenderGetEnableDebugDrawCalls()) {
             gos_RenderUpdateDebugInput();
-        } else {
-            Environment.DoGameLogic();
+            process_events();
+        } else if(logic_steps) {
+            for(int step=0; step<logic_steps; ++step) {
+                frameRate = g_pacer.logic_frame_rate();
+                Environment.DoGameLogic();
+            }
+            // input is only taken when logic runs, anything newer stays
+            // queued in SDL for the next step instead of being dropped
+            process_events();
         }
 
-        process_events();
-
 		gos_RendererHandleEvents();
 
         graphics::make_current_context(ctx);
@@ -341,10 +457,14 @@ int main(int argc, char** argv)
 
         g_exit |= gosExitGameOS();
 
-		uint64_t end_tick = timing::gettickcount();
-		uint64_t dt = timing::ticks2ms(end_tick - start_tick);
-		frameRate = 1000.0f / (float)dt;
+        g_pacer.end_frame();
+
+        gos_ProfilerEndFrame();
     }
+
+    const frame_pacer::stats& fs = g_pacer.get_stats();
+    SPEW(("FRAME", "%llu frames, p50 %.2f ms p95 %.2f ms p99 %.2f ms max %.2f ms\n",
+          (unsigned long long)g_pacer.get_num_frames(), fs.p50_ms, fs.p95_ms, fs.p99_ms, fs.max_ms));
     
     Environment.TerminateGameEngine();
 
@@ -0,0 +1,362 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <algorithm>
+
+#include "gameos.hpp"
+#include "gos_cmdbuffer.h"
+
+static const uint32_t GCB_MAGIC = 0x31424347; // "GCB1"
+
+gosCommandBuffer::gosCommandBuffer(uint32_t vertex_capacity, uint32_t index_capacity):
+    vertex_capacity_(vertex_capacity),
+    index_capacity_(index_capacity),
+    segment_(0),
+    last_state_(0xffffffff)
+{
+    vertices_.reserve(vertex_capacity);
+    indices_.reserve(index_capacity);
+}
+
+bool gosCommandBuffer::isSortable(const RenderState& rs)
+{
+    // Whichever depth test is used, opaque draws which write depth end up the same in
+    // any order, except where two of them are exactly coplanar: there the later one
+    // wins under LessEqual (the earlier one under Less). Clients draw coplanar opaque
+    // layers in a separate pass and call gos_DrawBarrier() before it, which starts
+    // a new segment, so sorting never moves a draw across such a pass.
+    return rs[gos_State_AlphaMode] == gos_Alpha_OneZero &&
+        rs[gos_State_ZWrite] != 0 && rs[gos_State_ZCompare] != 0;
+}
+
+// material:8 texture:18 blend:3 zwrite:1 zcompare:2 prim:2 state:30
+uint64_t gosCommandBuffer::makeSortKey(uint32_t prim, uint32_t material, uint32_t state, const RenderState& rs)
+{
+    uint64_t key = (uint64_t)(material & 0xff) << 56;
+    key |= (uint64_t)(rs[gos_State_Texture] & 0x3ffff) << 38;
+    key |= (uint64_t)(rs[gos_State_AlphaMode] & 0x7) << 35;
+    key |= (uint64_t)(rs[gos_State_ZWrite] & 0x1) << 34;
+    key |= (uint64_t)(rs[gos_State_ZCompare] & 0x3) << 32;
+    key |= (uint64_t)(prim & 0x3) << 30;
+    key |= (uint64_t)(state & 0x3fffffff);
+    return key;
+}
+
+static uint64_t hash_state(const uint32_t* rs)
+{
+    // FNV-1a
+    uint64_t h = 14695981039346656037ULL;
+    for(int i=0; i<gos_MaxState; ++i) {
+        h ^= rs[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+uint32_t gosCommandBuffer::addState(const RenderState& rs)
+{
+    // most of the time states do not change between draws
+    if(last_state_ != 0xffffffff && 0 == memcmp(getState(last_state_), rs, sizeof(RenderState)))
+        return last_state_;
+
+    uint64_t h = hash_state(rs);
+    std::unordered_map<uint64_t, uint32_t>::const_iterator it = state_lookup_.find(h);
+    if(it != state_lookup_.end() && 0 == memcmp(getState(it->second), rs, sizeof(RenderState))) {
+        last_state_ = it->second;
+        return last_state_;
+    }
+
+    last_state_ = getNumStates();
+    states_.insert(states_.end(), rs, rs + gos_MaxState);
+    // on (unlikely) hash collision just keep the first one, we only lose a chance to merge
+    if(it == state_lookup_.end())
+        state_lookup_.insert(std::make_pair(h, last_state_));
+    return last_state_;
+}
+
+gosCommandBuffer::Command& gosCommandBuffer::addCommand(PrimType prim, uint32_t material, const RenderState& rs)
+{
+    uint32_t state = addState(rs);
+
+    Command cmd;
+    cmd.key_ = makeSortKey(prim, material, state, rs);
+    cmd.state_ = state;
+    cmd.material_ = material;
+    cmd.prim_ = prim;
+    cmd.segment_ = segment_;
+    cmd.first_vertex_ = (uint32_t)vertices_.size();
+    cmd.num_vertices_ = 0;
+    cmd.first_index_ = (uint32_t)indices_.size();
+    cmd.num_indices_ = 0;
+    cmd.sortable_ = isSortable(rs);
+    commands_.push_back(cmd);
+    return commands_.back();
+}
+
+void gosCommandBuffer::record(PrimType prim, uint32_t material, const RenderState& rs, const gos_VERTEX* vertices, uint32_t num_vertices, const WORD* indices, uint32_t num_indices)
+{
+    gosASSERT(vertices && prim < PT_COUNT);
+    gosASSERT((prim == PT_INDEXED_TRIS) == (indices != NULL));
+    gosASSERT(hasRoomFor(num_vertices, num_indices));
+
+    if(num_vertices == 0 || (prim == PT_INDEXED_TRIS && num_indices == 0))
+        return;
+
+    Command& cmd = addCommand(prim, material, rs);
+    vertices_.insert(vertices_.end(), vertices, vertices + num_vertices);
+    cmd.num_vertices_ = num_vertices;
+    if(indices) {
+        indices_.insert(indices_.end(), indices, indices + num_indices);
+        cmd.num_indices_ = num_indices;
+    }
+}
+
+void gosCommandBuffer::recordQuads(uint32_t material, const RenderState& rs, const gos_VERTEX* vertices, uint32_t num_vertices)
+{
+    gosASSERT(vertices);
+    uint32_t num_quads = num_vertices / 4;
+    gosASSERT(hasRoomFor(num_quads * 6, 0));
+
+    if(num_quads == 0)
+        return;
+
+    Command& cmd = addCommand(PT_TRIS, material, rs);
+    for(uint32_t i=0; i<num_quads*4; i+=4) {
+        vertices_.push_back(vertices[i + 0]);
+        vertices_.push_back(vertices[i + 1]);
+        vertices_.push_back(vertices[i + 2]);
+
+        vertices_.push_back(vertices[i + 0]);
+        vertices_.push_back(vertices[i + 2]);
+        vertices_.push_back(vertices[i + 3]);
+    }
+    cmd.num_vertices_ = num_quads * 6;
+}
+
+void gosCommandBuffer::append(const gosCommandBuffer& other)
+{
+    barrier();
+
+    const uint32_t vertex_base = (uint32_t)vertices_.size();
+    const uint32_t index_base = (uint32_t)indices_.size();
+
+    for(size_t i=0; i<other.commands_.size(); ++i) {
+        const Command& src = other.commands_[i];
+        const uint32_t* rs = other.getState(src.state_);
+        uint32_t state = addState(*(const RenderState*)rs);
+
+        Command cmd = src;
+        cmd.state_ = state;
+        cmd.key_ = makeSortKey(src.prim_, src.material_, state, *(const RenderState*)rs);
+        cmd.segment_ = segment_ + src.segment_;
+        cmd.first_vertex_ += vertex_base;
+        cmd.first_index_ += index_base;
+        commands_.push_back(cmd);
+    }
+    segment_ += other.segment_;
+
+    vertices_.insert(vertices_.end(), other.vertices_.begin(), other.vertices_.end());
+    indices_.insert(indices_.end(), other.indices_.begin(), other.indices_.end());
+
+    barrier();
+}
+
+struct gosCommandKeyLess {
+    const std::vector<gosCommandBuffer::Command>* commands_;
+    bool operator()(uint32_t a, uint32_t b) const {
+        return (*commands_)[a].key_ < (*commands_)[b].key_;
+    }
+};
+
+const std::vector<gosCommandBuffer::Batch>& gosCommandBuffer::build(bool allow_sort, uint32_t max_batch_vertices, uint32_t max_batch_indices)
+{
+    const uint32_t num_commands = (uint32_t)commands_.size();
+
+    order_.resize(num_commands);
+    for(uint32_t i=0; i<num_commands; ++i)
+        order_[i] = i;
+
+    // only reorder inside of runs of order independent commands, everything else
+    // (blended, no depth test/write) acts as a barrier and is drawn where it was issued
+    if(allow_sort) {
+        gosCommandKeyLess less;
+        less.commands_ = &commands_;
+
+        uint32_t i = 0;
+        while(i < num_commands) {
+            if(!commands_[i].sortable_) {
+                ++i;
+                continue;
+            }
+            uint32_t j = i + 1;
+            while(j < num_commands && commands_[j].sortable_ && commands_[j].segment_ == commands_[i].segment_)
+                ++j;
+            if(j - i > 1)
+                std::stable_sort(order_.begin() + i, order_.begin() + j, less);
+            i = j;
+        }
+    }
+
+    // merging neighbours with equal state never changes result
+    batches_.clear();
+    for(uint32_t pos=0; pos<num_commands; ++pos) {
+        const Command& cmd = commands_[order_[pos]];
+
+        if(!batches_.empty()) {
+            Batch& b = batches_.back();
+            const Command& prev = commands_[order_[pos - 1]];
+            bool same = b.state_ == cmd.state_ && b.material_ == cmd.material_ &&
+                b.prim_ == cmd.prim_ && prev.segment_ == cmd.segment_;
+            bool fits = b.num_vertices_ + cmd.num_vertices_ <= max_batch_vertices &&
+                b.num_indices_ + cmd.num_indices_ <= max_batch_indices;
+            if(same && fits) {
+                b.count_++;
+                b.num_vertices_ += cmd.num_vertices_;
+                b.num_indices_ += cmd.num_indices_;
+                continue;
+            }
+        }
+
+        Batch b;
+        b.state_ = cmd.state_;
+        b.material_ = cmd.material_;
+        b.prim_ = cmd.prim_;
+        b.first_ = pos;
+        b.count_ = 1;
+        b.num_vertices_ = cmd.num_vertices_;
+        b.num_indices_ = cmd.num_indices_;
+        batches_.push_back(b);
+    }
+
+    return batches_;
+}
+
+void gosCommandBuffer::gatherBatch(const Batch& batch, gos_VERTEX* vout, uint32_t* iout, uint32_t base_vertex) const
+{
+    gosASSERT(vout);
+    gosASSERT(batch.prim_ != PT_INDEXED_TRIS || iout);
+
+    uint32_t vertex_offset = base_vertex;
+    for(uint32_t i=0; i<batch.count_; ++i) {
+        const Command& cmd = commands_[order_[batch.first_ + i]];
+
+        memcpy(vout, &vertices_[cmd.first_vertex_], cmd.num_vertices_ * sizeof(gos_VERTEX));
+        vout += cmd.num_vertices_;
+
+        if(batch.prim_ == PT_INDEXED_TRIS) {
+            const WORD* src = &indices_[cmd.first_index_];
+            for(uint32_t j=0; j<cmd.num_indices_; ++j)
+                iout[j] = vertex_offset + src[j];
+            iout += cmd.num_indices_;
+        }
+        vertex_offset += cmd.num_vertices_;
+    }
+}
+
+void gosCommandBuffer::reset()
+{
+    commands_.clear();
+    order_.clear();
+    batches_.clear();
+    states_.clear();
+    state_lookup_.clear();
+    last_state_ = 0xffffffff;
+    vertices_.clear();
+    indices_.clear();
+    segment_ = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Recorded frames can be saved for offline inspection (debug key in
+// gameos_graphics_debug.cpp), format is native endian and only meant to be
+// read back on the same machine
+
+struct gosCommandBufferHeader {
+    uint32_t magic_;
+    uint32_t max_state_;
+    uint32_t num_states_;
+    uint32_t num_commands_;
+    uint32_t num_vertices_;
+    uint32_t num_indices_;
+};
+
+bool gosCommandBuffer::save(const char* fname) const
+{
+    FILE* f = fopen(fname, "wb");
+    if(!f) {
+        SPEW(("GRAPHICS", "fopen: %s: %s\n", fname, strerror(errno)));
+        return false;
+    }
+
+    gosCommandBufferHeader hdr;
+    hdr.magic_ = GCB_MAGIC;
+    hdr.max_state_ = gos_MaxState;
+    hdr.num_states_ = getNumStates();
+    hdr.num_commands_ = getNumCommands();
+    hdr.num_vertices_ = getNumVertices();
+    hdr.num_indices_ = getNumIndices();
+
+    bool ok = 1 == fwrite(&hdr, sizeof(hdr), 1, f);
+    if(ok && !states_.empty())
+        ok = states_.size() == fwrite(&states_[0], sizeof(uint32_t), states_.size(), f);
+    if(ok && !commands_.empty())
+        ok = commands_.size() == fwrite(&commands_[0], sizeof(Command), commands_.size(), f);
+    if(ok && !vertices_.empty())
+        ok = vertices_.size() == fwrite(&vertices_[0], sizeof(gos_VERTEX), vertices_.size(), f);
+    if(ok && !indices_.empty())
+        ok = indices_.size() == fwrite(&indices_[0], sizeof(WORD), indices_.size(), f);
+
+    fclose(f);
+    return ok;
+}
+
+bool gosCommandBuffer::load(const char* fname)
+{
+    FILE* f = fopen(fname, "rb");
+    if(!f) {
+        SPEW(("GRAPHICS", "fopen: %s: %s\n", fname, strerror(errno)));
+        return false;
+    }
+
+    reset();
+
+    gosCommandBufferHeader hdr;
+    bool ok = 1 == fread(&hdr, sizeof(hdr), 1, f);
+    if(ok && (hdr.magic_ != GCB_MAGIC || hdr.max_state_ != gos_MaxState)) {
+        SPEW(("GRAPHICS", "%s: not a command buffer or recorded by incompatible version\n", fname));
+        ok = false;
+    }
+
+    if(ok) {
+        states_.resize(hdr.num_states_ * gos_MaxState);
+        commands_.resize(hdr.num_commands_);
+        vertices_.resize(hdr.num_vertices_);
+        indices_.resize(hdr.num_indices_);
+
+        if(!states_.empty())
+            ok = ok && states_.size() == fread(&states_[0], sizeof(uint32_t), states_.size(), f);
+        if(!commands_.empty())
+            ok = ok && commands_.size() == fread(&commands_[0], sizeof(Command), commands_.size(), f);
+        if(!vertices_.empty())
+            ok = ok && vertices_.size() == fread(&vertices_[0], sizeof(gos_VERTEX), vertices_.size(), f);
+        if(!indices_.empty())
+            ok = ok && indices_.size() == fread(&indices_[0], sizeof(WORD), indices_.size(), f);
+    }
+
+    fclose(f);
+
+    if(!ok) {
+        reset();
+        return false;
+    }
+
+    for(uint32_t i=0; i<getNumStates(); ++i)
+        state_lookup_.insert(std::make_pair(hash_state(getState(i)), i));
+    if(!commands_.empty())
+        segment_ = commands_.back().segment_;
+
+    vertex_capacity_ = std::max(vertex_capacity_, getNumVertices());
+    index_capacity_ = std::max(index_capacity_, getNumIndices());
+
+    return true;
+}
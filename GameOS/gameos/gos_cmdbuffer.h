@@ -0,0 +1,119 @@
+#ifndef GOS_CMDBUFFER_H
+#define GOS_CMDBUFFER_H
+
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+
+// Frame command buffer for immediate draws (gos_DrawTriangles, gos_DrawQuads, ...)
+// Every draw is recorded together with a copy of render states it was issued with.
+// When flushed, runs of commands which do not depend on draw order are sorted by
+// (material, texture, blend, z state) and neighbours which ended up with equal
+// state are merged, so renderer issues one draw per batch instead of one per call.
+// Knows nothing about GL, so that it can be exercised without a context
+// (see data_tools/drawbatchtest.cpp)
+class gosCommandBuffer {
+    public:
+        typedef uint32_t RenderState[gos_MaxState];
+
+        enum PrimType {
+            PT_POINTS = 0,
+            PT_LINES,
+            PT_TRIS,
+            PT_INDEXED_TRIS,
+            PT_COUNT
+        };
+
+        struct Command {
+            uint64_t key_;
+            uint32_t state_;        // index of render state snapshot
+            uint32_t material_;     // renderer defined material id
+            uint32_t prim_;
+            uint32_t segment_;      // commands are never reordered or merged across segments
+            uint32_t first_vertex_;
+            uint32_t num_vertices_;
+            uint32_t first_index_;
+            uint32_t num_indices_;
+            bool sortable_;
+        };
+
+        struct Batch {
+            uint32_t state_;
+            uint32_t material_;
+            uint32_t prim_;
+            uint32_t first_;        // position in getOrder()
+            uint32_t count_;        // number of commands
+            uint32_t num_vertices_;
+            uint32_t num_indices_;
+        };
+
+        gosCommandBuffer(uint32_t vertex_capacity, uint32_t index_capacity);
+
+        bool hasRoomFor(uint32_t num_vertices, uint32_t num_indices) const {
+            return vertices_.size() + num_vertices <= vertex_capacity_ &&
+                indices_.size() + num_indices <= index_capacity_;
+        }
+
+        void record(PrimType prim, uint32_t material, const RenderState& rs, const gos_VERTEX* vertices, uint32_t num_vertices, const WORD* indices = 0, uint32_t num_indices = 0);
+        // quads are expanded to triangle lists
+        void recordQuads(uint32_t material, const RenderState& rs, const gos_VERTEX* vertices, uint32_t num_vertices);
+
+        // copies all commands of other buffer, keeps them in separate segment
+        void append(const gosCommandBuffer& other);
+        // commands recorded after this are never sorted or merged with ones before
+        // (gos_DrawBarrier(), clients call it before coplanar overlay passes)
+        void barrier() { if(!commands_.empty()) segment_++; }
+
+        // sorts and merges recorded commands, result is valid until reset()
+        // batches are not grown beyond given limits (single commands may still exceed them)
+        const std::vector<Batch>& build(bool allow_sort, uint32_t max_batch_vertices = 0xffffffff, uint32_t max_batch_indices = 0xffffffff);
+
+        // writes batch vertices to vout and (for indexed batches) indices to iout,
+        // indices are rebased to index vertices written to vout starting from base_vertex
+        void gatherBatch(const Batch& batch, gos_VERTEX* vout, uint32_t* iout, uint32_t base_vertex) const;
+
+        void reset();
+
+        bool empty() const { return commands_.empty(); }
+        uint32_t getNumCommands() const { return (uint32_t)commands_.size(); }
+        uint32_t getNumBatches() const { return (uint32_t)batches_.size(); }
+        uint32_t getNumVertices() const { return (uint32_t)vertices_.size(); }
+        uint32_t getNumIndices() const { return (uint32_t)indices_.size(); }
+        uint32_t getNumStates() const { return (uint32_t)states_.size() / gos_MaxState; }
+        uint32_t getVertexCapacity() const { return vertex_capacity_; }
+        uint32_t getIndexCapacity() const { return index_capacity_; }
+
+        const std::vector<Command>& getCommands() const { return commands_; }
+        const std::vector<uint32_t>& getOrder() const { return order_; }
+        const uint32_t* getState(uint32_t state) const { return &states_[state * gos_MaxState]; }
+        const gos_VERTEX* getVertices() const { return vertices_.empty() ? NULL : &vertices_[0]; }
+        const WORD* getIndices() const { return indices_.empty() ? NULL : &indices_[0]; }
+
+        bool save(const char* fname) const;
+        bool load(const char* fname);
+
+        // only opaque geometry, which is depth tested and writes depth, may be drawn in any order
+        static bool isSortable(const RenderState& rs);
+        static uint64_t makeSortKey(uint32_t prim, uint32_t material, uint32_t state, const RenderState& rs);
+
+    private:
+        uint32_t addState(const RenderState& rs);
+        Command& addCommand(PrimType prim, uint32_t material, const RenderState& rs);
+
+        uint32_t vertex_capacity_;
+        uint32_t index_capacity_;
+        uint32_t segment_;
+
+        std::vector<Command> commands_;
+        std::vector<uint32_t> order_;
+        std::vector<Batch> batches_;
+
+        std::vector<uint32_t> states_;
+        std::unordered_map<uint64_t, uint32_t> state_lookup_;
+        uint32_t last_state_;
+
+        std::vector<gos_VERTEX> vertices_;
+        std::vector<WORD> indices_;
+};
+
+#endif // GOS_CMDBUFFER_H
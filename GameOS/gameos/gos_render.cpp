@@ -42,6 +42,18 @@ void set_verbose(bool is_verbose)
     VERBOSE_MODES = is_verbose;
 }
 
+//==============================================================================
+void set_vsync(bool enable)
+{
+    ENABLE_VSYNC = enable;
+}
+
+//==============================================================================
+bool is_vsync_enabled()
+{
+    return SDL_GL_GetSwapInterval() != 0;
+}
+
 //==============================================================================
 RenderWindow* create_window(const char* pwinname, int width, int height)
 {
@@ -10,6 +10,10 @@ typedef RenderWindow*   RenderWindowHandle;
 typedef RenderContext*   RenderContextHandle;
 
 void set_verbose(bool is_verbose);
+// must be called before init_render_context
+void set_vsync(bool enable);
+// whether the driver actually gave us vsync on the current context
+bool is_vsync_enabled();
 
 RenderWindowHandle  create_window           (const char* pwinname, int width, int height);
 bool                resize_window           (RenderWindowHandle rw_handle, int width, int height);
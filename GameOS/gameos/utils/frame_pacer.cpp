@@ -0,0 +1,129 @@
+#include "frame_pacer.h"
+#include "timing.h"
+
+#include <string.h>
+#include <algorithm>
+#include <thread>
+
+// how long before the deadline we stop sleeping and start spinning, sleep
+// can wake up late by about a scheduler tick
+#ifdef PLATFORM_WINDOWS
+static const uint64_t SPIN_NS = 4000000;
+#else
+static const uint64_t SPIN_NS = 2000000;
+#endif
+
+// used for the first frame when there is nothing to measure yet
+static const uint64_t NOMINAL_FRAME_NS = 16666667;
+
+frame_pacer::frame_pacer():
+    target_ns_(0),
+    logic_ns_(0),
+    spin_ns_(SPIN_NS),
+    frame_start_(0),
+    deadline_(0),
+    accumulator_(0),
+    logic_frame_rate_(60.0f),
+    history_count_(0),
+    num_frames_(0)
+{
+    memset(history_, 0, sizeof(history_));
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+void frame_pacer::set_target_fps(float fps)
+{
+    target_ns_ = fps > 0.0f ? (uint64_t)(1e+9f / fps) : 0;
+    deadline_ = 0;
+}
+
+void frame_pacer::set_logic_rate(float hz)
+{
+    logic_ns_ = hz > 0.0f ? (uint64_t)(1e+9f / hz) : 0;
+    accumulator_ = 0;
+}
+
+int frame_pacer::begin_frame()
+{
+    uint64_t now = timing::get_time_ns();
+    uint64_t dt;
+    if(frame_start_) {
+        dt = now - frame_start_;
+        history_[history_count_ % HISTORY_SIZE] = (float)dt * 1e-6f;
+        history_count_++;
+        if(0 == (history_count_ % STATS_INTERVAL))
+            update_stats();
+    } else {
+        dt = target_ns_ ? target_ns_ : NOMINAL_FRAME_NS;
+    }
+    frame_start_ = now;
+    num_frames_++;
+
+    if(!logic_ns_) {
+        // old behaviour, whatever the last frame took is this step
+        logic_frame_rate_ = 1e+9f / (float)std::max<uint64_t>(dt, 1000);
+        return 1;
+    }
+
+    // after a hitch drop the time we can't catch up with instead of
+    // running more and more steps every frame
+    accumulator_ += dt;
+    if(accumulator_ > logic_ns_ * MAX_LOGIC_STEPS)
+        accumulator_ = logic_ns_ * MAX_LOGIC_STEPS;
+
+    int steps = (int)(accumulator_ / logic_ns_);
+    accumulator_ -= steps * logic_ns_;
+    logic_frame_rate_ = 1e+9f / (float)logic_ns_;
+    return steps;
+}
+
+void frame_pacer::end_frame()
+{
+    if(!target_ns_)
+        return;
+
+    // deadlines follow each other so oversleeping one frame is made up by
+    // the next, but if we are already late don't try to catch up
+    uint64_t now = timing::get_time_ns();
+    deadline_ = deadline_ ? deadline_ + target_ns_ : frame_start_ + target_ns_;
+    if(deadline_ < now)
+        deadline_ = now;
+
+    wait_until(deadline_);
+}
+
+void frame_pacer::wait_until(uint64_t deadline)
+{
+    for(;;) {
+        uint64_t now = timing::get_time_ns();
+        if(now >= deadline)
+            break;
+
+        uint64_t remaining = deadline - now;
+        if(remaining > spin_ns_)
+            timing::sleep((unsigned int)(remaining - spin_ns_));
+        else
+            std::this_thread::yield();
+    }
+}
+
+void frame_pacer::update_stats()
+{
+    uint32_t count = std::min<uint32_t>(history_count_, HISTORY_SIZE);
+    if(!count)
+        return;
+
+    float sorted[HISTORY_SIZE];
+    memcpy(sorted, history_, count * sizeof(float));
+    std::sort(sorted, sorted + count);
+
+    float total = 0.0f;
+    for(uint32_t i=0; i<count; ++i)
+        total += sorted[i];
+
+    stats_.p50_ms = sorted[(count - 1) * 50 / 100];
+    stats_.p95_ms = sorted[(count - 1) * 95 / 100];
+    stats_.p99_ms = sorted[(count - 1) * 99 / 100];
+    stats_.max_ms = sorted[count - 1];
+    stats_.fps = total > 0.0f ? 1000.0f * (float)count / total : 0.0f;
+}
@@ -0,0 +1,72 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <stdint.h>
+
+// Paces the main loop: sleeps until the next frame deadline (the last bit
+// is a spin so we don't oversleep), and decides how many game logic steps
+// to run each frame.
+//
+// With a logic rate set the game is stepped at that fixed rate whatever the
+// render rate is, otherwise it gets one step per frame with the measured
+// frame time like it always did.
+class frame_pacer
+{
+public:
+    enum { HISTORY_SIZE = 256, MAX_LOGIC_STEPS = 4 };
+
+    struct stats {
+        float p50_ms;
+        float p95_ms;
+        float p99_ms;
+        float max_ms;
+        float fps;
+    };
+
+    frame_pacer();
+
+    // fps <= 0: no cap, frames are paced by vsync or not at all
+    void set_target_fps(float fps);
+    // hz <= 0: one logic step per rendered frame
+    void set_logic_rate(float hz);
+
+    float get_target_fps() const { return target_ns_ ? 1e+9f / (float)target_ns_ : 0.0f; }
+    float get_logic_rate() const { return logic_ns_ ? 1e+9f / (float)logic_ns_ : 0.0f; }
+
+    // Top of the frame. Returns the number of logic steps to run now, each
+    // of them should be told logic_frame_rate() as the frame rate.
+    int begin_frame();
+    float logic_frame_rate() const { return logic_frame_rate_; }
+
+    // After the swap. Sleeps until the next deadline if there is a cap.
+    void end_frame();
+
+    // Percentiles over the last HISTORY_SIZE frames, refreshed every
+    // STATS_INTERVAL frames. Stable addresses so they can be watched.
+    const stats& get_stats() const { return stats_; }
+    stats* get_stats_ptr() { return &stats_; }
+
+    uint64_t get_num_frames() const { return num_frames_; }
+
+private:
+    enum { STATS_INTERVAL = 32 };
+
+    void wait_until(uint64_t deadline);
+    void update_stats();
+
+    uint64_t target_ns_;
+    uint64_t logic_ns_;
+    uint64_t spin_ns_;
+
+    uint64_t frame_start_;
+    uint64_t deadline_;
+    uint64_t accumulator_;
+    float logic_frame_rate_;
+
+    float history_[HISTORY_SIZE];
+    uint32_t history_count_;
+    uint64_t num_frames_;
+    stats stats_;
+};
+
+#endif // FRAME_PACER_H
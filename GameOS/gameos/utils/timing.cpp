@@ -68,6 +68,22 @@ namespace timing {
 #endif
 	}
 
+    uint64_t get_time_ns()
+    {
+#ifdef PLATFORM_WINDOWS
+#ifdef _DEBUG
+		assert(initialized);
+#endif
+		LARGE_INTEGER t;
+		QueryPerformanceCounter(&t);
+		return (uint64_t)((double)t.QuadPart * 1e+9 / (double)Frequency.QuadPart);
+#else
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+    }
+
     uint64_t get_wall_time_ms()
     {
         // or clock_gettime(CLOCKREALTIME, ts);
@@ -10,6 +10,8 @@ void init();
 uint64_t gettickcount();
 uint64_t ticks2ms(uint64_t ticks);
 uint64_t get_wall_time_ms();
+// monotonic, nanosecond resolution, for frame pacing
+uint64_t get_time_ns();
 
 };
 
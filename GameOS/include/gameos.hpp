@@ -191,6 +191,7 @@ typedef struct gos_StringRes*   HSTRRES; //sebi
 typedef class gosBuffer*		HGOSBUFFER; //sebi
 typedef class gosVertexDeclaration*	HGOSVERTEXDECLARATION; //sebi
 typedef class gosRenderMaterial*	HGOSRENDERMATERIAL; //sebi
+typedef struct gosDecodedTexture*	HGOSDECODEDTEXTURE;
 
 
 
@@ -400,6 +401,11 @@ bool __stdcall gos_UserExit();
 // While the application is inside the Environment.TerminateGameEngine routine it may execute this to make GameOS continue.
 //
 void __stdcall gos_AbortTermination();
+//
+// Returns true if GameOS was started with --headless: no window, renderer or audio device was created.
+// Render and sound APIs still accept calls but do nothing, the game is expected to step its simulation on a fixed time step.
+//
+bool __stdcall gos_IsHeadless();
 
 
 //
@@ -2222,6 +2228,13 @@ void __stdcall gos_DrawFans( gos_VERTEX* Vertices, int NumVertices );
 //
 void __stdcall gos_DrawQuads( gos_VERTEX* Vertices, int NumVertices );
 
+//
+// Opaque draws which write depth are batched and may be drawn in a different order than they
+// were issued in. Draws issued after this call are never moved in front of ones issued before,
+// call it before drawing opaque geometry exactly on top of (coplanar with) what was drawn already.
+//
+void __stdcall gos_DrawBarrier();
+
 //
 // This API allows you to pass an array of indices and an array of vertices to be rendered.
 //
@@ -2795,6 +2808,25 @@ DWORD __stdcall gos_NewTextureFromFile( gos_TextureFormat Format, const char* Fi
 //
 DWORD __stdcall gos_NewTextureFromMemory( gos_TextureFormat Format, const char* FileName, BYTE* pBitmap, DWORD Size, DWORD Hints=0, gos_RebuildFunction pFunc=0, void *pInstance=0 );
 
+//
+// Two stage version of gos_NewTextureFromMemory for background loading.
+//
+// gos_DecodeTextureFromMemory does all the image decoding and format conversion and does not touch
+// the graphics API, so it may be called from any thread. Returns NULL if the image could not be decoded.
+//
+// gos_NewTextureFromDecoded must be called from the main thread. It uploads the decoded image, frees
+// it (whether or not the upload worked) and returns a texture handle just like gos_NewTextureFromMemory.
+//
+// gos_FreeDecodedTexture frees a decoded image which is not going to be uploaded. Any thread.
+//
+// gos_GetDecodedTextureLowMip box filters a decoded image down to Size x Size ARGB pixels (the layout
+// gos_LockTexture returns), e.g. to draw something close to the texture while it is still loading. Any thread.
+//
+HGOSDECODEDTEXTURE __stdcall gos_DecodeTextureFromMemory( gos_TextureFormat Format, const char* FileName, BYTE* pBitmap, DWORD Size );
+DWORD __stdcall gos_NewTextureFromDecoded( HGOSDECODEDTEXTURE Decoded, DWORD Hints=0 );
+void __stdcall gos_FreeDecodedTexture( HGOSDECODEDTEXTURE Decoded );
+void __stdcall gos_GetDecodedTextureLowMip( HGOSDECODEDTEXTURE Decoded, DWORD Size, DWORD* pARGB );
+
 #define RECT_TEX(width,height) (((height)<<16)|(width))
 
 //
@@ -3333,5 +3365,113 @@ public:
 	}
 };
 
+
+///////////////////////////////////////////////////////////////////////////////
+//////////////////////////////// ZONE PROFILER ////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+//
+// Scoped timing zones, compiled into every build and switched on at run
+// time.  Each thread records into its own ring buffer, and a capture of a
+// number of frames is written out as Chrome trace JSON (load it in
+// chrome://tracing or ui.perfetto.dev).  Zones nest by time, so the trace
+// shows the call hierarchy.
+//
+//	e.g:
+//
+//	void Mission::update()
+//	{
+//		GOS_PROFILE_ZONE( "Mission::update" );
+//		...
+//	}
+//
+// GOS_PROFILE_STAT also adds the time (in GetCycles units) into an __int64
+// shown with AddStatistic.  The counter is only touched in LAB_ONLY builds
+// (which is where those statistics exist), the zone itself always is.
+//
+// A zone can be ended early with end(), or ended and a new one started in
+// its place with next() for code that runs in phases.
+//
+// The name must be a string that lives for the whole program (a literal).
+//
+
+//
+// Turns recording on or off.  Zones already open when it is turned on are not recorded.
+//
+void __stdcall gos_ProfilerEnable( bool Enable );
+//
+// Waits DelayFrames frames, records NumFrames frames, then writes FileName and turns recording off again.
+//
+void __stdcall gos_ProfilerCapture( const char* FileName, DWORD NumFrames, DWORD DelayFrames = 0 );
+//
+// Called once per frame by the main loop.  Adds a "Frame" zone and handles captures.
+//
+void __stdcall gos_ProfilerEndFrame();
+//
+// Writes everything still in the ring buffers that was recorded since recording was turned on.
+//
+bool __stdcall gos_ProfilerWrite( const char* FileName );
+//
+// Names the calling thread in the trace.
+//
+void __stdcall gos_ProfilerSetThreadName( const char* Name );
+
+extern volatile bool gos_ProfilerActive;
+unsigned __int64 __stdcall gos_ProfilerTime();
+void __stdcall gos_ProfilerRecord( const char* Name, unsigned __int64 Start );
+
+class gosProfileZone
+{
+	const char*			m_Name;
+	unsigned __int64	m_Start;
+	__int64*			m_Counter;
+	__int64				m_Cycles;
+
+	void begin( const char* name, __int64* counter )
+	{
+		m_Name = name;
+		m_Start = gos_ProfilerActive ? gos_ProfilerTime() : 0;
+		m_Counter = counter;
+		if( counter )
+			m_Cycles = GetCycles();
+	}
+public:
+	gosProfileZone( const char* name, __int64* counter = NULL )
+	{
+		begin( name, counter );
+	}
+	~gosProfileZone()
+	{
+		end();
+	}
+	void end()
+	{
+		if( m_Start )
+			gos_ProfilerRecord( m_Name, m_Start );
+		if( m_Counter )
+			*m_Counter += GetCycles() - m_Cycles;
+		m_Start = 0;
+		m_Counter = NULL;
+	}
+	void next( const char* name, __int64* counter = NULL )
+	{
+		end();
+		begin( name, counter );
+	}
+};
+
+#define GOS_PROFILE_CAT2(a,b)	a##b
+#define GOS_PROFILE_CAT(a,b)	GOS_PROFILE_CAT2(a,b)
+#define GOS_PROFILE_ZONE(name)	gosProfileZone GOS_PROFILE_CAT(gosProfileZone,__LINE__)( name )
+
+#ifdef LAB_ONLY
+#define GOS_PROFILE_STAT(name,counter)			gosProfileZone GOS_PROFILE_CAT(gosProfileZone,__LINE__)( name, &(counter) )
+#define GOS_PROFILE_NAMED_STAT(zone,name,counter)	gosProfileZone zone( name, &(counter) )
+#define GOS_PROFILE_NEXT_STAT(zone,name,counter)	zone.next( name, &(counter) )
+#else
+#define GOS_PROFILE_STAT(name,counter)			gosProfileZone GOS_PROFILE_CAT(gosProfileZone,__LINE__)( name )
+#define GOS_PROFILE_NAMED_STAT(zone,name,counter)	gosProfileZone zone( name )
+#define GOS_PROFILE_NEXT_STAT(zone,name,counter)	zone.next( name )
+#endif
+
 #endif // __cplusplus
 
@@ -9,6 +9,7 @@
 struct _MEMORYPOOL;
 struct _HEAPHEADER;
 struct _LARGEBLOCKHEADER;
+struct gosHeapArena;
 
 //
 // Single byte before allocations
@@ -122,6 +123,12 @@ struct gos_Heap
 	DWORD		Magic;
 	int			Instances;
 	char		Name[128];
+	size_t		LiveBytes;							// bytes requested by blocks currently allocated
+	size_t		PeakBytes;
+	size_t		ReservedBytes;						// memory taken from the system (regions and large blocks)
+	gosHeapArena*	pArena;							// NULL if heap shares memory with its parent
+	DWORD		LiveBlocks;
+	bool		bDestroyed;							// destroyed, but still has blocks in use
 #ifdef LAB_ONLY
 	DWORD		MaximumSize;
 	int			BytesAllocated;
@@ -71,6 +71,9 @@ These may be OR'd together.  */
 #define STDOUT_FILENO 1
 #define STDERR_FILENO 2
 
+// positional read, does not move the file pointer (safe to call from several threads)
+ssize_t pread(int fd, void* buf, size_t count, long offset);
+
 #endif // PLATFORM_WINDOWS
 
 #endif // PLATFORM_IO_H
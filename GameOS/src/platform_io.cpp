@@ -1,7 +1,7 @@
-#ifndef PLATFORM_WINDOWS
-
 #include "platform_io.h"
 
+#ifndef PLATFORM_WINDOWS
+
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -12,4 +12,28 @@ long _filelength(int fd) {
     return buf.st_size;
 }
 
+#else
+
+#include <windows.h>
+#include <string.h>
+
+// NOTE: for handles not opened with FILE_FLAG_OVERLAPPED Windows still moves the
+// file pointer, so do not interleave this with unpositioned _read on the same fd.
+
+ssize_t pread(int fd, void* buf, size_t count, long offset) {
+    HANDLE h = (HANDLE)_get_osfhandle(fd);
+    if (h == INVALID_HANDLE_VALUE)
+        return -1;
+
+    OVERLAPPED ov;
+    memset(&ov, 0, sizeof(ov));
+    ov.Offset = (DWORD)offset;
+
+    DWORD bytesRead = 0;
+    if (!ReadFile(h, buf, (DWORD)count, &bytesRead, &ov))
+        return (GetLastError() == ERROR_HANDLE_EOF) ? 0 : -1;
+
+    return bytesRead;
+}
+
 #endif // PLATFORM_WINDOWS
\ No newline at end of file
@@ -6690,254 +6690,10 @@ void initABL (void) {
 	ABLi_setRandomCallbacks(ablSeedRandom, RandomNumber);
 	ABLi_setEndlessStateCallback(ablEndlessStateCallback);
 
-	ABLi_addFunction("getid", false, NULL, "i", execGetId);
-	ABLi_addFunction("gettime", false, NULL, "r", execGetTime);
-	ABLi_addFunction("gettimeleft", false, NULL, "r", execGetTimeLeft);
-	ABLi_addFunction("selectobject", false, "i", "i", execSelectObject);
-	//ABLi_addFunction("selectunit", false, "i", "i", execSelectUnit);
-	ABLi_addFunction("selectwarrior", false, "i", "i", execSelectWarrior);
-	ABLi_addFunction("getwarriorstatus", false, "i", "i", execGetWarriorStatus);
-	ABLi_addFunction("getcontacts", false, "Iii", "i", execGetContacts);
-	ABLi_addFunction("getenemycount", false, "i", "i", execGetEnemyCount);
-	ABLi_addFunction("selectcontact", false, "ii", "i", execSelectContact);
-	ABLi_addFunction("getcontactid", false, NULL, "i", execGetContactId);
-	ABLi_addFunction("iscontact", false, "iii", "i", execIsContact);
-	ABLi_addFunction("getcontactstatus", false, "I", "i", execGetContactStatus);
-	ABLi_addFunction("getcontactrelativeposition", false, "rr", "i", execGetContactRelativePosition);
-	ABLi_addFunction("settarget", false, "ii", NULL, execSetTarget);
-	ABLi_addFunction("gettarget", false, "i", "i", execGetTarget);
-	ABLi_addFunction("getweaponsready", false, "Ii", "i", execGetWeaponsReady);
-	ABLi_addFunction("getweaponslocked", false, "Ii", "i", execGetWeaponsLocked);
-	ABLi_addFunction("getweaponsinrange", false, "Ii", "i", execGetWeaponsInRange);
-	ABLi_addFunction("getweaponshots", false, "i", "i", execGetWeaponShots);
-	ABLi_addFunction("getweaponranges", false, "iR", NULL, execGetWeaponRanges);
-	ABLi_addFunction("getobjectposition", false, "iR", NULL, execGetObjectPosition);
-	ABLi_addFunction("getintegermemory", false, "i", "i", execGetIntegerMemory);
-	ABLi_addFunction("getrealmemory", false, "i", "r", execGetRealMemory);
-	ABLi_addFunction("getalarmtriggers", false, "I", "i", execGetAlarmTriggers);
-	ABLi_addFunction("getchallenger", false, "i", "i", execGetChallenger);
-	ABLi_addFunction("gettimewithoutorders", false, NULL, "r", execGetTimeWithoutOrders);
-	ABLi_addFunction("getfireranges", false, "R", NULL, execGetFireRanges);
-	ABLi_addFunction("getattackers", false, "Ir", "i", execGetAttackers);
-	ABLi_addFunction("getattackerinfo", false, "i", "r", execGetAttackerInfo);
-	ABLi_addFunction("setchallenger", false, "ii", "i", execSetChallenger);
-	ABLi_addFunction("setintegermemory", false, "ii", NULL, execSetIntegerMemory);
-	ABLi_addFunction("setrealmemory", false, "ir", NULL, execSetRealMemory);
-	ABLi_addFunction("hasmovegoal", false, NULL, "b", execHasMoveGoal);
-	ABLi_addFunction("hasmovepath", false, NULL, "b", execHasMovePath);
-	ABLi_addFunction("sortweapons", false, "Ii", "i", execSortWeapons);
-	ABLi_addFunction("getvisualrange", false, "i", "r", execGetVisualRange);
-	ABLi_addFunction("getunitmates", false, "iI", "i", execGetUnitMates);
-	ABLi_addFunction("gettacorder", false, "irI", "i", execGetTacOrder);
-	ABLi_addFunction("getlasttacorder", false, "irI", "i", execGetLastTacOrder);
-	ABLi_addFunction("getobjects", false, "iI", "i", execGetObjects);
-	ABLi_addFunction("orderwait", false, "rb", "i", execOrderWait);
-	ABLi_addFunction("ordermoveto", false, "Rb", "i", execOrderMoveTo);
-	ABLi_addFunction("ordermovetoobject", false, "ib", "i", execOrderMoveToObject);
-	ABLi_addFunction("ordermovetocontact", false, "b", "i", execOrderMoveToContact);
-	ABLi_addFunction("orderpowerdown", false, NULL, "i", execOrderPowerDown);
-	ABLi_addFunction("orderpowerup", false, NULL, "i", execOrderPowerUp);
-	ABLi_addFunction("orderattackobject", false, "iiiib", "i", execOrderAttackObject);
-	ABLi_addFunction("orderattackcontact", false, "iiib", "i", execOrderAttackContact);
-	ABLi_addFunction("orderwithdraw", false, NULL, "i", execOrderWithdraw);
-	ABLi_addFunction("objectinwithdrawal", false, "i", "i", execObjectInWithdrawal);
-	ABLi_addFunction("damageobject", false, "iiirirr", "i", execDamageObject);
-	ABLi_addFunction("setattackradius", false, "r", "r", execSetAttackRadius);
-	ABLi_addFunction("objectchangesides", false, "ii", NULL, execObjectChangeSides);
-	ABLi_addFunction("distancetoobject", false, "ii", "r", execDistanceToObject);
-	ABLi_addFunction("distancetoposition", false, "iR", "r", execDistanceToPosition);
-	ABLi_addFunction("objectsuicide", false, "i", NULL, execObjectSuicide);
-	ABLi_addFunction("objectcreate", false, "i", "i", execObjectCreate);
-	ABLi_addFunction("objectexists", false, "i", "i", execObjectExists);
-	ABLi_addFunction("objectstatus", false, "i", "i", execObjectStatus);
-	ABLi_addFunction("objectstatuscount", false, "iI", NULL, execObjectStatusCount);
-	ABLi_addFunction("objectvisible", false, "ii", "i", execObjectVisible);
-	ABLi_addFunction("objectside", false, "i", "i", execObjectTeam);
-	ABLi_addFunction("objectcommander", false, "i", "i", execObjectCommander);
-	ABLi_addFunction("objectclass", false, "i", "i", execObjectClass);
-	ABLi_addFunction("settimer", false, "i*", "i", execSetTimer);
-	ABLi_addFunction("checktimer", false, "i", "r", execCheckTimer);
-	ABLi_addFunction("endtimer", false, "i", NULL, execEndTimer);
-//	ABLi_addFunction("setobjectivetimer", false, "i*", "i", execSetObjectiveTimer);
-//	ABLi_addFunction("checkobjectivetimer", false, "i", "r", execCheckObjectiveTimer);
-	ABLi_addFunction("setobjectivestatus", false, "ii", "i", execSetObjectiveStatus);
-	ABLi_addFunction("checkobjectivestatus", false, "i", "i", execCheckObjectiveStatus);
-//	ABLi_addFunction("setobjectivetype", false, "ii", "i", execSetObjectiveType);
-//	ABLi_addFunction("checkobjectivetype", false, "i", "i", execCheckObjectiveType);
-	ABLi_addFunction("playdigitalmusic", false, "i", "i", execPlayDigitalMusic);
-	ABLi_addFunction("stopmusic", false, NULL, "i", execStopMusic);
-	ABLi_addFunction("playsoundeffect", false, "i", "i", execPlaySoundEffect);
-	ABLi_addFunction("playvideo", false, "C", "i", execPlayVideo);
-	ABLi_addFunction("setradio", false, "ib", "i", execSetRadio);
-	ABLi_addFunction("playspeech", false, "ii", "i", execPlaySpeech);
-	ABLi_addFunction("playbetty", false, "i", "i", execPlayBetty);
-	ABLi_addFunction("setobjectactive", false, "ib", "i", execSetObjectActive);
-	ABLi_addFunction("objecttypeid", false, "i", "i", execObjectTypeID);
-	ABLi_addFunction("getterrainobjectpartid", false, "ii", "i", execGetTerrainObjectPartID);
-	ABLi_addFunction("objectremove", false, "i", "i", execObjectRemove);
-	ABLi_addFunction("inarea", false, "iRri", "b", execInArea);
-	ABLi_addFunction("createinfantry", false, "Ri", "i", execCreateInfantry);
-	ABLi_addFunction("getsensorsworking", false, "i", "i", execGetSensorsWorking);
-	ABLi_addFunction("getcurrentbrvalue", false, "i", "i", execGetCurrentBRValue);
-	ABLi_addFunction("setcurrentbrvalue", false, "ii", NULL, execSetCurrentBRValue);
-	ABLi_addFunction("getarmorpts", false, "i", "i", execGetArmorPts);
-	ABLi_addFunction("getmaxarmor", false, "i", "i", execGetMaxArmor);
-	ABLi_addFunction("getpilotid", false, "i", "i", execGetPilotID);
-	ABLi_addFunction("getpilotwounds", false, "i", "r", execGetPilotWounds);
-	ABLi_addFunction("setpilotwounds", false, "ii", NULL, execSetPilotWounds);
-	ABLi_addFunction("getobjectactive", false, "i", "i", execGetObjectActive);
-	ABLi_addFunction("getobjectdamage", false, "i", "i", execGetObjectDamage);
-	ABLi_addFunction("getobjectdmgpts", false, "i", "i", execGetObjectDmgPts);
-	ABLi_addFunction("getobjectmaxdmg", false, "i", "i", execGetObjectMaxDmg);
-	ABLi_addFunction("setobjectdamage", false, "ii", "i", execSetObjectDamage);
-	ABLi_addFunction("getglobalvalue", false, "i", "r", execGetGlobalValue);
-	ABLi_addFunction("setglobalvalue", false, "i*", NULL, execSetGlobalValue);
-	ABLi_addFunction("setobjectivepos", false, "i***", NULL, execSetObjectivePos);
-	ABLi_addFunction("setsensorrange", false, "ir", NULL, execSetSensorRange);
-	ABLi_addFunction("settonnage", false, "ir", NULL, execSetTonnage);
-	ABLi_addFunction("setexplosiondamage", false, "ir", NULL, execSetExplosionDamage);
-	ABLi_addFunction("setexplosionradius", false, "ir", NULL, execSetExplosionRadius);
-	ABLi_addFunction("setsalvage", false, "iii", "b", execSetSalvage);
-	ABLi_addFunction("setsalvagestatus", false, "ib", "b", execSetSalvageStatus);
-	ABLi_addFunction("setanimation", false, "iii", NULL, execSetAnimation);
-	ABLi_addFunction("setrevealed", false, "i*R", NULL, execSetRevealed);
-	ABLi_addFunction("getsalvage", false, "iiII", NULL, execGetSalvage);
-	ABLi_addFunction("orderrefit", false, "ii", NULL, execOrderRefit);
-	ABLi_addFunction("setcaptured", false, "i", NULL, execSetCaptured);
-	ABLi_addFunction("ordercapture", false, "ii", NULL, execOrderCapture);
-	ABLi_addFunction("setcapturable", false, "ib", NULL, execSetCapturable);
-	ABLi_addFunction("iscaptured", false, "i", "i", execIsCaptured);
-	ABLi_addFunction("iscapturable", false, "ii", "b", execIsCapturable);
-	ABLi_addFunction("wasevercapturable", false, "i", "b", execWasEverCapturable);
-	ABLi_addFunction("setbuildingname", false, "ii", NULL, execSetBuildingName);
-	ABLi_addFunction("callstrike", false, "iirrrb", NULL, execCallStrike);
-	ABLi_addFunction("callstrikeex", false, "iirrrbr", NULL, execCallStrikeEx);
-	ABLi_addFunction("orderloadelementals", false, "i", NULL, execOrderLoadElementals);
-	ABLi_addFunction("orderdeployelementals", false, "i", NULL, execOrderDeployElementals);
-	ABLi_addFunction("addprisoner", false, "ii", "i", execAddPrisoner);
-	ABLi_addFunction("lockgateopen", false, "i", NULL, execLockGateOpen);
-	ABLi_addFunction("lockgateclosed", false, "i", NULL, execLockGateClosed);
-	ABLi_addFunction("releasegatelock", false, "i", NULL, execReleaseGateLock);
-	ABLi_addFunction("isgateopen", false, "i", "b", execIsGateOpen);
-	ABLi_addFunction("getrelativepositiontopoint", false, "RrriR", NULL, execGetRelativePositionToPoint);
-	ABLi_addFunction("getrelativepositiontoobject", false, "irriR", NULL, execGetRelativePositionToObject);
-	ABLi_addFunction("getunitstatus", false, "i", "r", execGetUnitStatus);
-	ABLi_addFunction("repair", false, "ir", NULL, execRepair);
-	ABLi_addFunction("getfixed", false, "iii", "i", execGetFixed);
-	ABLi_addFunction("getrepairstate", false, "i", "i", execGetRepairState);
-	ABLi_addFunction("isteamtargeting", false, "iii", "b", execIsTeamTargeting);
-	ABLi_addFunction("isteamcapturing", false, "iii", "b", execIsTeamCapturing);
-	ABLi_addFunction("sendmessage", false, "ii", NULL, execSendMessage);
-	ABLi_addFunction("getmessage", false, "i", "i", execGetMessage);
-	ABLi_addFunction("gethometeam", false, NULL, "i", execGetHomeTeam);
-//	ABLi_addFunction("getstrikes", false, "ii", "i", execGetStrikes);
-//	ABLi_addFunction("setstrikes", false, "iii", NULL, execSetStrikes);
-//	ABLi_addFunction("addstrikes", false, "iii", NULL, execAddStrikes);
-	ABLi_addFunction("isserver", false, NULL, "b", execIsServer);
-	ABLi_addFunction("calcpartid", false, "iiii", "i", execCalcPartID);
-	ABLi_addFunction("setdebugstring", false, "iiC", NULL, execSetDebugString);
-	ABLi_addFunction("break", false, NULL, NULL, execBreak);
-	ABLi_addFunction("pathexists", false, "iiiii", "i", execPathExists);
-	ABLi_addFunction("convertcoords", false, "iRI", "i", execConvertCoords);
-	ABLi_addFunction("newmoveto", true, "Ri", "i", execCoreMoveTo);
-	ABLi_addFunction("newmovetoobject", true, "ii", "i", execCoreMoveToObject);
-	ABLi_addFunction("newpower", true, "b", "i", execCorePower);
-	ABLi_addFunction("newattack", true, "ii", "i", execCoreAttack);
-	ABLi_addFunction("newcapture", true, "ii", "i", execCoreCapture);
-	ABLi_addFunction("newscan", true, "ii", "i", execCoreScan);
-	ABLi_addFunction("newcontrol", true, "ii", "i", execCoreControl);
-	ABLi_addFunction("coremoveto", true, "Ri", "i", execCoreMoveTo);
-	ABLi_addFunction("coremovetoobject", true, "ii", "i", execCoreMoveToObject);
-	ABLi_addFunction("corepower", true, "b", "i", execCorePower);
-	ABLi_addFunction("coreattack", true, "ii", "i", execCoreAttack);
-	ABLi_addFunction("corecapture", true, "ii", "i", execCoreCapture);
-	ABLi_addFunction("corescan", true, "ii", "i", execCoreScan);
-	ABLi_addFunction("corecontrol", true, "ii", "i", execCoreControl);
-	ABLi_addFunction("coreeject", true, NULL, "i", execCoreEject);
-	ABLi_addFunction("setpilotstate", false, "i", "i", execSetPilotState);
-	ABLi_addFunction("getpilotstate", false, NULL, "i", execGetPilotState);
-	ABLi_addFunction("getnextpilotevent", false, "I", "i", execGetNextPilotEvent);
-	ABLi_addFunction("settargetpriority", false, "iiiii", "i", execSetTargetPriority);
-	ABLi_addFunction("setdebugwindow", false, "ii", "i", execSetDebugWindow);
-	
-	ABLi_addFunction("setmoviemode", false, NULL, NULL, execSetMovieMode);
-	ABLi_addFunction("endmoviemode", false, NULL, NULL, execEndMovieMode);
-	ABLi_addFunction("fadetocolor", false, "ir", NULL, execFadeToColor);
-	ABLi_addFunction("forcemovieend", false, NULL, "i", execForceMovieEnd);
-	
-	ABLi_addFunction("getcameraposition", false, "R", NULL, execGetCameraPosition);
-	ABLi_addFunction("setcameraposition", false, "R", NULL, execSetCameraPosition);
-	ABLi_addFunction("setcameragoalposition", false, "Rr", NULL, execSetCameraGoalPosition);
-	ABLi_addFunction("getcameragoalposition", false, "R", NULL, execGetCameraGoalPosition);
-	ABLi_addFunction("getcamerarotation", false, "R", NULL, execGetCameraRotation);
-	ABLi_addFunction("setcamerarotation", false, "R", NULL, execSetCameraRotation);
-	ABLi_addFunction("setcameragoalrotation", false, "Rr", NULL, execSetCameraGoalRotation);
-	ABLi_addFunction("getcameragoalrotation", false, "R", NULL, execGetCameraGoalRotation);
-	ABLi_addFunction("getcamerazoom", false, NULL, "r", execGetCameraZoom);
-	ABLi_addFunction("setcamerazoom", false, "r", NULL, execSetCameraZoom);
-	ABLi_addFunction("getcameragoalzoom", false, NULL, "r", execGetCameraGoalZoom);
-	ABLi_addFunction("setcameragoalzoom", false, "rr", NULL, execSetCameraGoalZoom);
-	ABLi_addFunction("setcameravelocity", false, "R", NULL, execSetCameraVelocity);
-	ABLi_addFunction("getcameravelocity", false, "R", NULL, execGetCameraVelocity);
-	ABLi_addFunction("setcameragoalvelocity", false, "Rr", NULL, execSetCameraGoalVelocity);
-	ABLi_addFunction("getcameragoalvelocity", false, "R", NULL, execGetCameraGoalVelocity);
-	ABLi_addFunction("setcameralookobject", false, "i", NULL, execSetCameraLookObject);
-	ABLi_addFunction("getcameralookobject", false, NULL, "i", execGetCameraLookObject);
-	ABLi_addFunction("getcameraframelength", false, NULL, "r", execGetCameraFrameLength);
-	
-	ABLi_addFunction("getmissionwon", false, NULL, "b", execGetMissionWon);
-	ABLi_addFunction("getmissionlost", false, NULL, "b", execGetMissionLost);
-	ABLi_addFunction("getobjectivesuccess", false, NULL, "b", execGetObjectiveSuccess);
-	ABLi_addFunction("getobjectivefailed", false, NULL, "b", execGetObjectiveFailed);
-	ABLi_addFunction("getenemydestroyed", false, NULL, "b", execGetEnemyDestroyed);
-	ABLi_addFunction("getfriendlydestroyed", false, NULL, "b", execGetFriendlyDestroyed);
-	ABLi_addFunction("getplayerincombat", false, NULL, "b", execPlayerInCombat);
-	ABLi_addFunction("getsensorsactive", false, NULL, "b", execGetSensorsActive);
-	ABLi_addFunction("getcurrentmusicid", false, NULL, "i", execGetCurrentMusicId);
-	ABLi_addFunction("getmissiontune", false, NULL, "i", execGetMissionTuneId);
-	
-	ABLi_addFunction("requesthelp", false, "iRrRri", "r", execRequestHelp);
-	ABLi_addFunction("requesttarget", false, "Rr", "i", execRequestTarget);
-	ABLi_addFunction("requestshelter", false, "*", "i", execRequestShelter);
-	ABLi_addFunction("mcprint", false, "?", NULL, execMCPrint);
-
-	ABLi_addFunction("getmissionstatus", false, NULL, "i", execGetMissionStatus);
-	ABLi_addFunction("addtriggerarea", false, "iiiiii", "i", execAddTriggerArea);
-	ABLi_addFunction("istriggerareahit", false, "i", "b", execIsTriggerAreaHit);
-	ABLi_addFunction("resettriggerarea", false, "i", NULL, execResetTriggerArea);
-	ABLi_addFunction("removetriggerarea", false, "i", NULL, execRemoveTriggerArea);
-	ABLi_addFunction("getweapons", false, "Ii", "i", execGetWeapons);
-	ABLi_addFunction("setmovearea", false, "Rr", NULL, execSetMoveArea);
-	ABLi_addFunction("getweaponsstatus", false, "I", "i", execGetWeaponsStatus);
-	ABLi_addFunction("cleartacorder", false, NULL, NULL, execClearTacOrder);
-	ABLi_addFunction("playwave", false, "Ci", "i", execPlayWave);
-	ABLi_addFunction("objectteam", false, "i", "i", execObjectTeam);
-	ABLi_addFunction("setwillhelp", false, "b", "b", execSetWillHelp);
-	ABLi_addFunction("getlastscan", false, NULL, "i", execGetLastScan);
-	ABLi_addFunction("getmapinfo", false, "I", NULL, execGetMapInfo);
-	
-	ABLi_addFunction("getgeneralalarm", false, NULL, "i", execGetGeneralAlarm);
-	ABLi_addFunction("setgeneralalarm", false, "i", NULL, execSetGeneralAlarm);
-
-	ABLi_addFunction("isoffmap", false, "R", "b", execIsOffMap);
-	ABLi_addFunction("setgoalplanning", false, "b", "b", execSetGoalPlanning);
-
-	ABLi_addFunction("seteject", false, "b", "b", execSetEject);
-	ABLi_addFunction("setkeepmoving", false, "b", "b", execSetKeepMoving);
-
-	//Tutorial Functions
-	ABLi_addFunction("animationcallout", false, "ibbri", "b", execAnimationCallout);
-	ABLi_addFunction("tutorialtext", false, "i", NULL, execTutorialText);
-	ABLi_addFunction("guiisaoe", false, NULL, "b", execGUIIsAOEStyle);
-	ABLi_addFunction("logisticsscreenid", false, NULL, "i", execLogisticsScreenId);
-	ABLi_addFunction("logisticsanimationcallout", false, "ibri", "b", execLogisticsAnimationCallout);
-	ABLi_addFunction("logisticsincallout", false, NULL, "b", execLogisticsInCallout);
-	ABLi_addFunction("isplayingvoiceover", false, NULL, "b", execIsPlayingVoiceOver);
-	ABLi_addFunction("getlogisticstime", false, NULL, "r", execGetLogisticsTime);
-	ABLi_addFunction("stopvoiceover", false, NULL, NULL, execStopVoiceOver);
-	ABLi_addFunction("incallout", false, NULL, "b", execInCallout);
-	ABLi_addFunction("setinvulnerable", false, "b", NULL, execSetInvulnerable);
-	ABLi_addFunction("freezegui", false, "b", NULL, execFreezeGUI);
+#define ABL_FUNCTION(name, isOrder, paramList, returnType, codeCallback) \
+	ABLi_addFunction(name, isOrder, paramList, returnType, codeCallback);
+#include"ablmc2fn.h"
+#undef ABL_FUNCTION
 	
 	//static long Godzilla = 120;
 	//static long GodzillaList[5] = {10, 20, 30, 40, 50};
@@ -0,0 +1,258 @@
+//===========================================================================//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+//---------------------------------------------------------------------------
+// The library functions the game gives ABL scripts, for initABL() to register
+// and for tools which run the scripts outside of the game (data_tools/abldiff).
+// Define ABL_FUNCTION(name, isOrder, paramList, returnType, codeCallback)
+// before including this; there is deliberately no include guard...
+
+ABL_FUNCTION("getid", false, NULL, "i", execGetId)
+ABL_FUNCTION("gettime", false, NULL, "r", execGetTime)
+ABL_FUNCTION("gettimeleft", false, NULL, "r", execGetTimeLeft)
+ABL_FUNCTION("selectobject", false, "i", "i", execSelectObject)
+//ABL_FUNCTION("selectunit", false, "i", "i", execSelectUnit)
+ABL_FUNCTION("selectwarrior", false, "i", "i", execSelectWarrior)
+ABL_FUNCTION("getwarriorstatus", false, "i", "i", execGetWarriorStatus)
+ABL_FUNCTION("getcontacts", false, "Iii", "i", execGetContacts)
+ABL_FUNCTION("getenemycount", false, "i", "i", execGetEnemyCount)
+ABL_FUNCTION("selectcontact", false, "ii", "i", execSelectContact)
+ABL_FUNCTION("getcontactid", false, NULL, "i", execGetContactId)
+ABL_FUNCTION("iscontact", false, "iii", "i", execIsContact)
+ABL_FUNCTION("getcontactstatus", false, "I", "i", execGetContactStatus)
+ABL_FUNCTION("getcontactrelativeposition", false, "rr", "i", execGetContactRelativePosition)
+ABL_FUNCTION("settarget", false, "ii", NULL, execSetTarget)
+ABL_FUNCTION("gettarget", false, "i", "i", execGetTarget)
+ABL_FUNCTION("getweaponsready", false, "Ii", "i", execGetWeaponsReady)
+ABL_FUNCTION("getweaponslocked", false, "Ii", "i", execGetWeaponsLocked)
+ABL_FUNCTION("getweaponsinrange", false, "Ii", "i", execGetWeaponsInRange)
+ABL_FUNCTION("getweaponshots", false, "i", "i", execGetWeaponShots)
+ABL_FUNCTION("getweaponranges", false, "iR", NULL, execGetWeaponRanges)
+ABL_FUNCTION("getobjectposition", false, "iR", NULL, execGetObjectPosition)
+ABL_FUNCTION("getintegermemory", false, "i", "i", execGetIntegerMemory)
+ABL_FUNCTION("getrealmemory", false, "i", "r", execGetRealMemory)
+ABL_FUNCTION("getalarmtriggers", false, "I", "i", execGetAlarmTriggers)
+ABL_FUNCTION("getchallenger", false, "i", "i", execGetChallenger)
+ABL_FUNCTION("gettimewithoutorders", false, NULL, "r", execGetTimeWithoutOrders)
+ABL_FUNCTION("getfireranges", false, "R", NULL, execGetFireRanges)
+ABL_FUNCTION("getattackers", false, "Ir", "i", execGetAttackers)
+ABL_FUNCTION("getattackerinfo", false, "i", "r", execGetAttackerInfo)
+ABL_FUNCTION("setchallenger", false, "ii", "i", execSetChallenger)
+ABL_FUNCTION("setintegermemory", false, "ii", NULL, execSetIntegerMemory)
+ABL_FUNCTION("setrealmemory", false, "ir", NULL, execSetRealMemory)
+ABL_FUNCTION("hasmovegoal", false, NULL, "b", execHasMoveGoal)
+ABL_FUNCTION("hasmovepath", false, NULL, "b", execHasMovePath)
+ABL_FUNCTION("sortweapons", false, "Ii", "i", execSortWeapons)
+ABL_FUNCTION("getvisualrange", false, "i", "r", execGetVisualRange)
+ABL_FUNCTION("getunitmates", false, "iI", "i", execGetUnitMates)
+ABL_FUNCTION("gettacorder", false, "irI", "i", execGetTacOrder)
+ABL_FUNCTION("getlasttacorder", false, "irI", "i", execGetLastTacOrder)
+ABL_FUNCTION("getobjects", false, "iI", "i", execGetObjects)
+ABL_FUNCTION("orderwait", false, "rb", "i", execOrderWait)
+ABL_FUNCTION("ordermoveto", false, "Rb", "i", execOrderMoveTo)
+ABL_FUNCTION("ordermovetoobject", false, "ib", "i", execOrderMoveToObject)
+ABL_FUNCTION("ordermovetocontact", false, "b", "i", execOrderMoveToContact)
+ABL_FUNCTION("orderpowerdown", false, NULL, "i", execOrderPowerDown)
+ABL_FUNCTION("orderpowerup", false, NULL, "i", execOrderPowerUp)
+ABL_FUNCTION("orderattackobject", false, "iiiib", "i", execOrderAttackObject)
+ABL_FUNCTION("orderattackcontact", false, "iiib", "i", execOrderAttackContact)
+ABL_FUNCTION("orderwithdraw", false, NULL, "i", execOrderWithdraw)
+ABL_FUNCTION("objectinwithdrawal", false, "i", "i", execObjectInWithdrawal)
+ABL_FUNCTION("damageobject", false, "iiirirr", "i", execDamageObject)
+ABL_FUNCTION("setattackradius", false, "r", "r", execSetAttackRadius)
+ABL_FUNCTION("objectchangesides", false, "ii", NULL, execObjectChangeSides)
+ABL_FUNCTION("distancetoobject", false, "ii", "r", execDistanceToObject)
+ABL_FUNCTION("distancetoposition", false, "iR", "r", execDistanceToPosition)
+ABL_FUNCTION("objectsuicide", false, "i", NULL, execObjectSuicide)
+ABL_FUNCTION("objectcreate", false, "i", "i", execObjectCreate)
+ABL_FUNCTION("objectexists", false, "i", "i", execObjectExists)
+ABL_FUNCTION("objectstatus", false, "i", "i", execObjectStatus)
+ABL_FUNCTION("objectstatuscount", false, "iI", NULL, execObjectStatusCount)
+ABL_FUNCTION("objectvisible", false, "ii", "i", execObjectVisible)
+ABL_FUNCTION("objectside", false, "i", "i", execObjectTeam)
+ABL_FUNCTION("objectcommander", false, "i", "i", execObjectCommander)
+ABL_FUNCTION("objectclass", false, "i", "i", execObjectClass)
+ABL_FUNCTION("settimer", false, "i*", "i", execSetTimer)
+ABL_FUNCTION("checktimer", false, "i", "r", execCheckTimer)
+ABL_FUNCTION("endtimer", false, "i", NULL, execEndTimer)
+//	ABL_FUNCTION("setobjectivetimer", false, "i*", "i", execSetObjectiveTimer)
+//	ABL_FUNCTION("checkobjectivetimer", false, "i", "r", execCheckObjectiveTimer)
+ABL_FUNCTION("setobjectivestatus", false, "ii", "i", execSetObjectiveStatus)
+ABL_FUNCTION("checkobjectivestatus", false, "i", "i", execCheckObjectiveStatus)
+//	ABL_FUNCTION("setobjectivetype", false, "ii", "i", execSetObjectiveType)
+//	ABL_FUNCTION("checkobjectivetype", false, "i", "i", execCheckObjectiveType)
+ABL_FUNCTION("playdigitalmusic", false, "i", "i", execPlayDigitalMusic)
+ABL_FUNCTION("stopmusic", false, NULL, "i", execStopMusic)
+ABL_FUNCTION("playsoundeffect", false, "i", "i", execPlaySoundEffect)
+ABL_FUNCTION("playvideo", false, "C", "i", execPlayVideo)
+ABL_FUNCTION("setradio", false, "ib", "i", execSetRadio)
+ABL_FUNCTION("playspeech", false, "ii", "i", execPlaySpeech)
+ABL_FUNCTION("playbetty", false, "i", "i", execPlayBetty)
+ABL_FUNCTION("setobjectactive", false, "ib", "i", execSetObjectActive)
+ABL_FUNCTION("objecttypeid", false, "i", "i", execObjectTypeID)
+ABL_FUNCTION("getterrainobjectpartid", false, "ii", "i", execGetTerrainObjectPartID)
+ABL_FUNCTION("objectremove", false, "i", "i", execObjectRemove)
+ABL_FUNCTION("inarea", false, "iRri", "b", execInArea)
+ABL_FUNCTION("createinfantry", false, "Ri", "i", execCreateInfantry)
+ABL_FUNCTION("getsensorsworking", false, "i", "i", execGetSensorsWorking)
+ABL_FUNCTION("getcurrentbrvalue", false, "i", "i", execGetCurrentBRValue)
+ABL_FUNCTION("setcurrentbrvalue", false, "ii", NULL, execSetCurrentBRValue)
+ABL_FUNCTION("getarmorpts", false, "i", "i", execGetArmorPts)
+ABL_FUNCTION("getmaxarmor", false, "i", "i", execGetMaxArmor)
+ABL_FUNCTION("getpilotid", false, "i", "i", execGetPilotID)
+ABL_FUNCTION("getpilotwounds", false, "i", "r", execGetPilotWounds)
+ABL_FUNCTION("setpilotwounds", false, "ii", NULL, execSetPilotWounds)
+ABL_FUNCTION("getobjectactive", false, "i", "i", execGetObjectActive)
+ABL_FUNCTION("getobjectdamage", false, "i", "i", execGetObjectDamage)
+ABL_FUNCTION("getobjectdmgpts", false, "i", "i", execGetObjectDmgPts)
+ABL_FUNCTION("getobjectmaxdmg", false, "i", "i", execGetObjectMaxDmg)
+ABL_FUNCTION("setobjectdamage", false, "ii", "i", execSetObjectDamage)
+ABL_FUNCTION("getglobalvalue", false, "i", "r", execGetGlobalValue)
+ABL_FUNCTION("setglobalvalue", false, "i*", NULL, execSetGlobalValue)
+ABL_FUNCTION("setobjectivepos", false, "i***", NULL, execSetObjectivePos)
+ABL_FUNCTION("setsensorrange", false, "ir", NULL, execSetSensorRange)
+ABL_FUNCTION("settonnage", false, "ir", NULL, execSetTonnage)
+ABL_FUNCTION("setexplosiondamage", false, "ir", NULL, execSetExplosionDamage)
+ABL_FUNCTION("setexplosionradius", false, "ir", NULL, execSetExplosionRadius)
+ABL_FUNCTION("setsalvage", false, "iii", "b", execSetSalvage)
+ABL_FUNCTION("setsalvagestatus", false, "ib", "b", execSetSalvageStatus)
+ABL_FUNCTION("setanimation", false, "iii", NULL, execSetAnimation)
+ABL_FUNCTION("setrevealed", false, "i*R", NULL, execSetRevealed)
+ABL_FUNCTION("getsalvage", false, "iiII", NULL, execGetSalvage)
+ABL_FUNCTION("orderrefit", false, "ii", NULL, execOrderRefit)
+ABL_FUNCTION("setcaptured", false, "i", NULL, execSetCaptured)
+ABL_FUNCTION("ordercapture", false, "ii", NULL, execOrderCapture)
+ABL_FUNCTION("setcapturable", false, "ib", NULL, execSetCapturable)
+ABL_FUNCTION("iscaptured", false, "i", "i", execIsCaptured)
+ABL_FUNCTION("iscapturable", false, "ii", "b", execIsCapturable)
+ABL_FUNCTION("wasevercapturable", false, "i", "b", execWasEverCapturable)
+ABL_FUNCTION("setbuildingname", false, "ii", NULL, execSetBuildingName)
+ABL_FUNCTION("callstrike", false, "iirrrb", NULL, execCallStrike)
+ABL_FUNCTION("callstrikeex", false, "iirrrbr", NULL, execCallStrikeEx)
+ABL_FUNCTION("orderloadelementals", false, "i", NULL, execOrderLoadElementals)
+ABL_FUNCTION("orderdeployelementals", false, "i", NULL, execOrderDeployElementals)
+ABL_FUNCTION("addprisoner", false, "ii", "i", execAddPrisoner)
+ABL_FUNCTION("lockgateopen", false, "i", NULL, execLockGateOpen)
+ABL_FUNCTION("lockgateclosed", false, "i", NULL, execLockGateClosed)
+ABL_FUNCTION("releasegatelock", false, "i", NULL, execReleaseGateLock)
+ABL_FUNCTION("isgateopen", false, "i", "b", execIsGateOpen)
+ABL_FUNCTION("getrelativepositiontopoint", false, "RrriR", NULL, execGetRelativePositionToPoint)
+ABL_FUNCTION("getrelativepositiontoobject", false, "irriR", NULL, execGetRelativePositionToObject)
+ABL_FUNCTION("getunitstatus", false, "i", "r", execGetUnitStatus)
+ABL_FUNCTION("repair", false, "ir", NULL, execRepair)
+ABL_FUNCTION("getfixed", false, "iii", "i", execGetFixed)
+ABL_FUNCTION("getrepairstate", false, "i", "i", execGetRepairState)
+ABL_FUNCTION("isteamtargeting", false, "iii", "b", execIsTeamTargeting)
+ABL_FUNCTION("isteamcapturing", false, "iii", "b", execIsTeamCapturing)
+ABL_FUNCTION("sendmessage", false, "ii", NULL, execSendMessage)
+ABL_FUNCTION("getmessage", false, "i", "i", execGetMessage)
+ABL_FUNCTION("gethometeam", false, NULL, "i", execGetHomeTeam)
+//	ABL_FUNCTION("getstrikes", false, "ii", "i", execGetStrikes)
+//	ABL_FUNCTION("setstrikes", false, "iii", NULL, execSetStrikes)
+//	ABL_FUNCTION("addstrikes", false, "iii", NULL, execAddStrikes)
+ABL_FUNCTION("isserver", false, NULL, "b", execIsServer)
+ABL_FUNCTION("calcpartid", false, "iiii", "i", execCalcPartID)
+ABL_FUNCTION("setdebugstring", false, "iiC", NULL, execSetDebugString)
+ABL_FUNCTION("break", false, NULL, NULL, execBreak)
+ABL_FUNCTION("pathexists", false, "iiiii", "i", execPathExists)
+ABL_FUNCTION("convertcoords", false, "iRI", "i", execConvertCoords)
+ABL_FUNCTION("newmoveto", true, "Ri", "i", execCoreMoveTo)
+ABL_FUNCTION("newmovetoobject", true, "ii", "i", execCoreMoveToObject)
+ABL_FUNCTION("newpower", true, "b", "i", execCorePower)
+ABL_FUNCTION("newattack", true, "ii", "i", execCoreAttack)
+ABL_FUNCTION("newcapture", true, "ii", "i", execCoreCapture)
+ABL_FUNCTION("newscan", true, "ii", "i", execCoreScan)
+ABL_FUNCTION("newcontrol", true, "ii", "i", execCoreControl)
+ABL_FUNCTION("coremoveto", true, "Ri", "i", execCoreMoveTo)
+ABL_FUNCTION("coremovetoobject", true, "ii", "i", execCoreMoveToObject)
+ABL_FUNCTION("corepower", true, "b", "i", execCorePower)
+ABL_FUNCTION("coreattack", true, "ii", "i", execCoreAttack)
+ABL_FUNCTION("corecapture", true, "ii", "i", execCoreCapture)
+ABL_FUNCTION("corescan", true, "ii", "i", execCoreScan)
+ABL_FUNCTION("corecontrol", true, "ii", "i", execCoreControl)
+ABL_FUNCTION("coreeject", true, NULL, "i", execCoreEject)
+ABL_FUNCTION("setpilotstate", false, "i", "i", execSetPilotState)
+ABL_FUNCTION("getpilotstate", false, NULL, "i", execGetPilotState)
+ABL_FUNCTION("getnextpilotevent", false, "I", "i", execGetNextPilotEvent)
+ABL_FUNCTION("settargetpriority", false, "iiiii", "i", execSetTargetPriority)
+ABL_FUNCTION("setdebugwindow", false, "ii", "i", execSetDebugWindow)
+
+ABL_FUNCTION("setmoviemode", false, NULL, NULL, execSetMovieMode)
+ABL_FUNCTION("endmoviemode", false, NULL, NULL, execEndMovieMode)
+ABL_FUNCTION("fadetocolor", false, "ir", NULL, execFadeToColor)
+ABL_FUNCTION("forcemovieend", false, NULL, "i", execForceMovieEnd)
+
+ABL_FUNCTION("getcameraposition", false, "R", NULL, execGetCameraPosition)
+ABL_FUNCTION("setcameraposition", false, "R", NULL, execSetCameraPosition)
+ABL_FUNCTION("setcameragoalposition", false, "Rr", NULL, execSetCameraGoalPosition)
+ABL_FUNCTION("getcameragoalposition", false, "R", NULL, execGetCameraGoalPosition)
+ABL_FUNCTION("getcamerarotation", false, "R", NULL, execGetCameraRotation)
+ABL_FUNCTION("setcamerarotation", false, "R", NULL, execSetCameraRotation)
+ABL_FUNCTION("setcameragoalrotation", false, "Rr", NULL, execSetCameraGoalRotation)
+ABL_FUNCTION("getcameragoalrotation", false, "R", NULL, execGetCameraGoalRotation)
+ABL_FUNCTION("getcamerazoom", false, NULL, "r", execGetCameraZoom)
+ABL_FUNCTION("setcamerazoom", false, "r", NULL, execSetCameraZoom)
+ABL_FUNCTION("getcameragoalzoom", false, NULL, "r", execGetCameraGoalZoom)
+ABL_FUNCTION("setcameragoalzoom", false, "rr", NULL, execSetCameraGoalZoom)
+ABL_FUNCTION("setcameravelocity", false, "R", NULL, execSetCameraVelocity)
+ABL_FUNCTION("getcameravelocity", false, "R", NULL, execGetCameraVelocity)
+ABL_FUNCTION("setcameragoalvelocity", false, "Rr", NULL, execSetCameraGoalVelocity)
+ABL_FUNCTION("getcameragoalvelocity", false, "R", NULL, execGetCameraGoalVelocity)
+ABL_FUNCTION("setcameralookobject", false, "i", NULL, execSetCameraLookObject)
+ABL_FUNCTION("getcameralookobject", false, NULL, "i", execGetCameraLookObject)
+ABL_FUNCTION("getcameraframelength", false, NULL, "r", execGetCameraFrameLength)
+
+ABL_FUNCTION("getmissionwon", false, NULL, "b", execGetMissionWon)
+ABL_FUNCTION("getmissionlost", false, NULL, "b", execGetMissionLost)
+ABL_FUNCTION("getobjectivesuccess", false, NULL, "b", execGetObjectiveSuccess)
+ABL_FUNCTION("getobjectivefailed", false, NULL, "b", execGetObjectiveFailed)
+ABL_FUNCTION("getenemydestroyed", false, NULL, "b", execGetEnemyDestroyed)
+ABL_FUNCTION("getfriendlydestroyed", false, NULL, "b", execGetFriendlyDestroyed)
+ABL_FUNCTION("getplayerincombat", false, NULL, "b", execPlayerInCombat)
+ABL_FUNCTION("getsensorsactive", false, NULL, "b", execGetSensorsActive)
+ABL_FUNCTION("getcurrentmusicid", false, NULL, "i", execGetCurrentMusicId)
+ABL_FUNCTION("getmissiontune", false, NULL, "i", execGetMissionTuneId)
+
+ABL_FUNCTION("requesthelp", false, "iRrRri", "r", execRequestHelp)
+ABL_FUNCTION("requesttarget", false, "Rr", "i", execRequestTarget)
+ABL_FUNCTION("requestshelter", false, "*", "i", execRequestShelter)
+ABL_FUNCTION("mcprint", false, "?", NULL, execMCPrint)
+
+ABL_FUNCTION("getmissionstatus", false, NULL, "i", execGetMissionStatus)
+ABL_FUNCTION("addtriggerarea", false, "iiiiii", "i", execAddTriggerArea)
+ABL_FUNCTION("istriggerareahit", false, "i", "b", execIsTriggerAreaHit)
+ABL_FUNCTION("resettriggerarea", false, "i", NULL, execResetTriggerArea)
+ABL_FUNCTION("removetriggerarea", false, "i", NULL, execRemoveTriggerArea)
+ABL_FUNCTION("getweapons", false, "Ii", "i", execGetWeapons)
+ABL_FUNCTION("setmovearea", false, "Rr", NULL, execSetMoveArea)
+ABL_FUNCTION("getweaponsstatus", false, "I", "i", execGetWeaponsStatus)
+ABL_FUNCTION("cleartacorder", false, NULL, NULL, execClearTacOrder)
+ABL_FUNCTION("playwave", false, "Ci", "i", execPlayWave)
+ABL_FUNCTION("objectteam", false, "i", "i", execObjectTeam)
+ABL_FUNCTION("setwillhelp", false, "b", "b", execSetWillHelp)
+ABL_FUNCTION("getlastscan", false, NULL, "i", execGetLastScan)
+ABL_FUNCTION("getmapinfo", false, "I", NULL, execGetMapInfo)
+
+ABL_FUNCTION("getgeneralalarm", false, NULL, "i", execGetGeneralAlarm)
+ABL_FUNCTION("setgeneralalarm", false, "i", NULL, execSetGeneralAlarm)
+
+ABL_FUNCTION("isoffmap", false, "R", "b", execIsOffMap)
+ABL_FUNCTION("setgoalplanning", false, "b", "b", execSetGoalPlanning)
+
+ABL_FUNCTION("seteject", false, "b", "b", execSetEject)
+ABL_FUNCTION("setkeepmoving", false, "b", "b", execSetKeepMoving)
+
+//Tutorial Functions
+ABL_FUNCTION("animationcallout", false, "ibbri", "b", execAnimationCallout)
+ABL_FUNCTION("tutorialtext", false, "i", NULL, execTutorialText)
+ABL_FUNCTION("guiisaoe", false, NULL, "b", execGUIIsAOEStyle)
+ABL_FUNCTION("logisticsscreenid", false, NULL, "i", execLogisticsScreenId)
+ABL_FUNCTION("logisticsanimationcallout", false, "ibri", "b", execLogisticsAnimationCallout)
+ABL_FUNCTION("logisticsincallout", false, NULL, "b", execLogisticsInCallout)
+ABL_FUNCTION("isplayingvoiceover", false, NULL, "b", execIsPlayingVoiceOver)
+ABL_FUNCTION("getlogisticstime", false, NULL, "r", execGetLogisticsTime)
+ABL_FUNCTION("stopvoiceover", false, NULL, NULL, execStopVoiceOver)
+ABL_FUNCTION("incallout", false, NULL, "b", execInCallout)
+ABL_FUNCTION("setinvulnerable", false, "b", NULL, execSetInvulnerable)
+ABL_FUNCTION("freezegui", false, "b", NULL, execFreezeGUI)
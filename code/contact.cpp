@@ -588,10 +588,32 @@ long SensorSystem::scanBattlefield (void)
 
 	long numNewContacts = 0;
 
-	long numMovers = ObjectManager->getNumMovers();
+	//-----------------------------------------------------------------
+	// Only movers near enough to be seen or sensed, plus whatever we
+	// already have contact with so it can be dropped, need a look.
+	// Everyone else would come back CONTACT_NONE anyway.  The visual
+	// range gets some extra since lineOfSight uses an approximate 3D
+	// distance.
+	float scanRange = getEffectiveRange() / metersPerWorldUnit;
+	float visualRange = owner->getVisualRange() * 1.1f;
+	if (visualRange > scanRange)
+		scanRange = visualRange;
+
+	DWORD moverMask[MOVER_MASK_WORDS];
+	memset(moverMask, 0, sizeof(moverMask));
+	ObjectManager->markMoversInRange(owner->getPosition(), scanRange, moverMask);
+	for (long i = 0; i < numContacts; i++)
+	{
+		MoverPtr contact = (MoverPtr)ObjectManager->get(contacts[i] & 0x7FFF);
+		if (contact)
+			ObjectManager->markMover(contact, moverMask);
+	}
+
+	MoverPtr scanList[MAX_MOVERS];
+	long numMovers = ObjectManager->getMarkedMovers(moverMask, scanList, MAX_MOVERS);
 	for (long i = 0; i < numMovers; i++) 
 	{
-		MoverPtr mover = (MoverPtr)ObjectManager->getMover(i);
+		MoverPtr mover = scanList[i];
 		if (mover->getExists() && (mover->getTeamId() != owner->getTeamId())) 
 		{
 			long contactStatus = calcContactStatus(mover);
@@ -1839,27 +1839,7 @@ bool GameObject::lineOfSight (Stuff::Vector3D point, bool checkVisibleBits) {
 
 //---------------------------------------------------------------------------
 
-#ifdef LAB_ONLY
-extern __int64 MCTimeLOSUpdate;
-#endif
-
-inline bool GameObject::lineOfSight (GameObjectPtr target, float startExtRad, bool checkVisibleBits) 
-{
-	__int64 timeStart = GetCycles(); 
-
-	//If we call this without a target, we have no LOS!!
-	// Keeps it from crashing, too.
-	// Not sure where all of the calls Glenn makes to this are, but I'm looking!
-	if (!target) {
-#ifdef LAB_ONLY
-		MCTimeLOSUpdate += (GetCycles() - timeStart);
-#endif
-		return false;
-	}
-
-	Stuff::Vector3D distance;
-	distance.Subtract(target->getPosition(),getPosition());
-	float dist = distance.GetApproximateLength();
+float GameObject::getVisualRange (void) {
 
 	//Figure out altitude above minimum terrain altitude and look up in table.
 	float baseElevation = MapData::waterDepth;
@@ -1890,11 +1870,32 @@ inline bool GameObject::lineOfSight (GameObjectPtr target, float startExtRad, bo
 		radius *= mover->getLOSFactor();
 	}
 
-	if (dist > (radius * 25.0f * worldUnitsPerMeter))
-	{
+	return(radius * 25.0f * worldUnitsPerMeter);
+}
+
+//---------------------------------------------------------------------------
+
 #ifdef LAB_ONLY
-		MCTimeLOSUpdate += (GetCycles() - timeStart);
+extern __int64 MCTimeLOSUpdate;
 #endif
+
+inline bool GameObject::lineOfSight (GameObjectPtr target, float startExtRad, bool checkVisibleBits) 
+{
+	GOS_PROFILE_STAT("GameObject::lineOfSight",MCTimeLOSUpdate);
+
+	//If we call this without a target, we have no LOS!!
+	// Keeps it from crashing, too.
+	// Not sure where all of the calls Glenn makes to this are, but I'm looking!
+	if (!target) {
+		return false;
+	}
+
+	Stuff::Vector3D distance;
+	distance.Subtract(target->getPosition(),getPosition());
+	float dist = distance.GetApproximateLength();
+
+	if (dist > getVisualRange())
+	{
 		return false;
 	}
 		
@@ -1927,32 +1928,20 @@ inline bool GameObject::lineOfSight (GameObjectPtr target, float startExtRad, bo
 			
 			if (ObjectManager->moverLineOfSightTable[index])
 			{
-#ifdef LAB_ONLY
-			MCTimeLOSUpdate += (GetCycles() - timeStart);
-#endif
 				return true;
 			}
 			else
 			{
-#ifdef LAB_ONLY
-			MCTimeLOSUpdate += (GetCycles() - timeStart);
-#endif
 				return false;
 			}
 		}
 		
 		if (Team::lineOfSight(getLOSPosition(), target->getLOSPosition(), getTeamId(), target->getAppearRadius(), startExtRad, checkVisibleBits))
 		{
-#ifdef LAB_ONLY
-		MCTimeLOSUpdate += (GetCycles() - timeStart);
-#endif
 			return(true);
 		}
 		else
 		{
-#ifdef LAB_ONLY
-		MCTimeLOSUpdate += (GetCycles() - timeStart);
-#endif
 			return(false);
 		}
 	}
@@ -1973,17 +1962,11 @@ inline bool GameObject::lineOfSight (GameObjectPtr target, float startExtRad, bo
 		
 			if (Team::lineOfSight(getLOSPosition(), target->getLOSPosition(), getTeamId(), target->getAppearRadius(), startExtRad, checkVisibleBits)) 
 			{
-#ifdef LAB_ONLY
-				MCTimeLOSUpdate += (GetCycles() - timeStart);
-#endif
 				return(true);
 			}
 //		}
 //	}
 
-#ifdef LAB_ONLY
-	MCTimeLOSUpdate += (GetCycles() - timeStart);
-#endif
 	return(false);
 }
 
@@ -2068,9 +2051,12 @@ long GameObject::getCaptureBlocker (GameObjectPtr capturingMover, GameObjectPtr*
 	if (!capturingTeam)
 		STOP(("GameObject.getCaptureBlocker: NULL capturingTeam"));
 
+	MoverPtr nearbyMovers[MAX_MOVERS];
+	long numNearbyMovers = ObjectManager->getMoversInRange(position, blockCaptureRange / metersPerWorldUnit, nearbyMovers, MAX_MOVERS);
+
 	if (distanceFrom(capturingMover->getPosition()) <= 30.0) {
-		for (long i = 0; i < ObjectManager->getNumMovers(); i++) {
-			MoverPtr mover = ObjectManager->getMover(i);
+		for (long i = 0; i < numNearbyMovers; i++) {
+			MoverPtr mover = nearbyMovers[i];
 			if (capturingTeam->isEnemy(mover->getTeam()))
 				if (!mover->isMarine() && (mover->numWeapons > 0))
 					if ((distanceFrom(mover->getPosition()) < blockCaptureRange) && !mover->isDisabled() && mover->getAwake()) {
@@ -2082,8 +2068,8 @@ long GameObject::getCaptureBlocker (GameObjectPtr capturingMover, GameObjectPtr*
 		}
 		}
 	else {
-		for (long i = 0; i < ObjectManager->getNumMovers(); i++) {
-			MoverPtr mover = ObjectManager->getMover(i);
+		for (long i = 0; i < numNearbyMovers; i++) {
+			MoverPtr mover = nearbyMovers[i];
 			if (!mover->getTeam() || capturingTeam->isEnemy(mover->getTeam()))
 				if (!mover->isMarine() && (mover->numWeapons > 0))
 					if ((distanceFrom(mover->getPosition()) < blockCaptureRange) && !mover->isDisabled() && mover->getAwake())
@@ -666,6 +666,9 @@ class GameObject {
 
 		virtual bool lineOfSight (Stuff::Vector3D point, bool checkVisibleBits = true);
 
+		//How far (world units) this object can see another, before terrain is checked.
+		float getVisualRange (void);
+
 		virtual bool lineOfSight (GameObjectPtr target, float startExtRad = 0.0f, bool checkVisibleBits = true);
 	
 		virtual float relFacingTo (Stuff::Vector3D goal, long bodyLocation = -1);
@@ -2528,14 +2528,6 @@ Stuff::Vector3D GroundVehicle::getPositionFromHS (long nodeId)
 	return(hsPos);
 }
 
-#ifdef PROFILE
-extern long srCtrlUpd;
-extern long srApprUpd;
-extern long srDyneUpd;
-extern long srWeapUpd;
-extern long srObjtUpd;
-#endif
-
 //extern L_INTEGER startCk;
 //extern L_INTEGER endCk;
 
@@ -3149,6 +3141,8 @@ long GroundVehicle::setTeamId (long _teamId, bool setup)
 //---------------------------------------------------------------------------
 long GroundVehicle::update (void)
 {
+	GOS_PROFILE_ZONE("GroundVehicle::update");
+
 	if (withdrawing && (pilot->getStatus() == WARRIOR_STATUS_WITHDRAWN)) 
 	{
 		setTangible(false);
@@ -3396,10 +3390,6 @@ long GroundVehicle::update (void)
 	}
 	else if (getAwake() && !isDisabled())
 	{
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(startCk);
-		#endif
-
 		//-----------------------------------------------------
 		// Not destroyed nor disabled yet, so update our LOS...
 		GroundVehicleTypePtr vehicleType = (GroundVehicleTypePtr)ObjectManager->getObjectType(typeHandle);ObjectManager->getObjectType(typeHandle);
@@ -3428,27 +3418,17 @@ long GroundVehicle::update (void)
 		}
 	}
 	
+	gosProfileZone updateZone("GroundVehicle control");
+
 	((ObjectAppearance*)appearance)->pilotNameID = IDS_NOPILOT;
 	control.update(this);
 	
-	#ifdef MC_PROFILE
-	QueryPerformanceCounter(endCk);
-	srCtrlUpd += (endCk.LowPart - startCk.LowPart);
-	#endif
-
-	#ifdef MC_PROFILE
-	QueryPerformanceCounter(startCk);
-	#endif
+	updateZone.next("GroundVehicle dynamics");
 
 	bool emergencyStop = false;
 	if (!isDisabled())
 		emergencyStop = crashAvoidanceSystem();
 
-	#ifdef MC_PROFILE
-	QueryPerformanceCounter(endCk);
-	srDyneUpd += (endCk.LowPart - startCk.LowPart);
-	#endif
-
 	//--------------------------------------------------------------------
 	// At this point, the other updates have completed, its time to
 	// apply the velocity and rotations to the mech.
@@ -3461,9 +3441,7 @@ long GroundVehicle::update (void)
 	// the terrain.  So, whenever you want a position derived from
 	// a velocity, multiply velocity by worldUnitsPerMeter.
 
-	#ifdef MC_PROFILE
-	QueryPerformanceCounter(startCk);
-	#endif
+	updateZone.next("GroundVehicle appearance");
 
 	float velMag = 0.0;
 	if (!emergencyStop)
@@ -3486,11 +3464,7 @@ long GroundVehicle::update (void)
 		pilot->orderMoveToPoint (false, true, ORDER_ORIGIN_PLAYER, location, -1, TACORDER_PARAM_RUN);
 	}
 
-	#ifdef MC_PROFILE
-	QueryPerformanceCounter(endCk);
-	srApprUpd += (endCk.LowPart - startCk.LowPart);
-	QueryPerformanceCounter(startCk);
-	#endif
+	updateZone.next("GroundVehicle position");
 
 	if (teleportPosition.x > -999990.0) {
 		setPosition(teleportPosition);
@@ -3830,11 +3804,7 @@ long GroundVehicle::update (void)
 	long blockNumber = float2long(xCoord) + (float2long(yCoord) * Terrain::blocksMapSide);
 	addMoverToList(blockNumber);
 
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(endCk);
-
-		srObjtUpd += (endCk.LowPart - startCk.LowPart);
-		#endif
+	updateZone.end();
 
 	if (getDebugFlag(OBJECT_DFLAG_DISABLE))
 		disable(DEBUGGER_DEATH);
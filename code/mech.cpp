@@ -5325,14 +5325,6 @@ Stuff::Vector3D BattleMech::getPositionFromHS (long nodeId)
 
 //----------------------------------------------------------------------------------
 
-#ifdef PROFILE
-extern long srCtrlUpd;
-extern long srApprUpd;
-extern long srDyneUpd;
-extern long srWeapUpd;
-extern long srObjtUpd;
-#endif
-
 //L_INTEGER startCk;
 //L_INTEGER endCk;
 
@@ -5749,6 +5741,8 @@ extern GameObjectPtr DebugGameObject[3];
 
 long BattleMech::update (void)
 {
+	GOS_PROFILE_ZONE("BattleMech::update");
+
 	positionNormal = land->getTerrainNormal(position);
 
 	getPilot()->getIndex();
@@ -5811,9 +5805,7 @@ long BattleMech::update (void)
 
 	if (!isDestroyed() && !isDisabled())
 	{
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(startCk);
-		#endif
+		gosProfileZone updateZone("BattleMech control");
 
 		//Be damned sure our legs are marked correctly!!
 		calcLegStatus();
@@ -5868,14 +5860,7 @@ long BattleMech::update (void)
 			shutDownThisFrame = false;
 		}
 		
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(endCk);
-		srCtrlUpd += (endCk.LowPart - startCk.LowPart);
-		#endif
-
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(startCk);
-		#endif
+		updateZone.next("BattleMech dynamics");
 
 		//updateDynamics();
 
@@ -5893,12 +5878,6 @@ long BattleMech::update (void)
 				ramTarget->updatePathLock(true);
 		}
 
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(endCk);
-
-		srDyneUpd += (endCk.LowPart - startCk.LowPart);
-		#endif
-
 		//--------------------------------------------------------------------
 		// At this point, the other updates have completed, its time to
 		// apply the velocity and rotations to the mech.
@@ -5911,9 +5890,7 @@ long BattleMech::update (void)
 		// the terrain.  So, whenever you want a position derived from
 		// a velocity, multiply velocity by worldUnitsPerMeter.
 
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(startCk);
-		#endif
+		updateZone.next("BattleMech position");
 
 		if (teleportPosition.x > -999990.0) {
 			setPosition(teleportPosition);
@@ -6009,15 +5986,7 @@ long BattleMech::update (void)
 
 		//float inverseAngle = 180.0;
 
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(endCk);
-
-		srObjtUpd += (endCk.LowPart - startCk.LowPart);
-		#endif
-		
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(startCk);
-		#endif
+		updateZone.next("BattleMech appearance");
 
 		bool inView = appearance->recalcBounds();
 		if (inView)
@@ -6043,18 +6012,8 @@ long BattleMech::update (void)
 				setTangible(true);
 		}
 
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(endCk);
-
-		srApprUpd += (endCk.LowPart - startCk.LowPart);
-		#endif
+		updateZone.end();
 
-		#ifdef MC_PROFILE
-		QueryPerformanceCounter(endCk);
-
-		srObjtUpd += (endCk.LowPart - startCk.LowPart);
-		#endif
-		
 		if (getDebugFlag(OBJECT_DFLAG_DISABLE))
 			disable(DEBUGGER_DEATH);
 	}
@@ -199,6 +199,50 @@ SoundSystem* sndSystem;
 //extern bool gNoDialogs;
 bool gNoDialogs = false;
 
+//---------------------------------------------------------------------------
+// Headless batch runs (GameOS started with --headless).  The mission from
+// -mission is run back to back at a fixed frame length and when it ends the
+// results and timings are written to headlessResultsFile.  headlessMaxTime
+// (-maxtime, scenario seconds) stops missions which never end on their own.
+char headlessResultsFile[1024] = "headless_results.txt";
+float headlessMaxTime = -1.0f;
+double headlessLoadTime = 0.0;
+double headlessUpdateTime = 0.0;
+double headlessMaxUpdateTime = 0.0;
+long headlessFrames = 0;
+
+//---------------------------------------------------------------------------
+// -loscheck <rays> fires that many random lines of sight at the end of
+// mission load, with and without GameMap's LOS heights, and reports any that
+// differ (Team::checkLOSHeights).
+long losCheckRays = 0;
+long losCheckMismatches = -1;
+
+//---------------------------------------------------------------------------
+// -jps has movers path with jump point search (MOVEPARAM_JUMP_POINTS).
+// -jpscheck does too, but runs the old search after each one as well and
+// reports how many jump point paths came out costlier.
+extern bool UseJumpPointSearch;
+extern bool JumpPointCheck;
+extern long JumpPointChecks;
+extern long JumpPointWorse;
+
+//---------------------------------------------------------------------------
+// -pqtrace <file> records what every path search does to its open list
+// (PriorityQueue::traceCallback), for the pqbench tool to replay.
+FILE* pqTraceFile = NULL;
+
+static void recordPQTrace (int op, int32_t key, uint32_t id)
+{
+	PQTraceRecord rec = {op, key, id};
+	fwrite(&rec, sizeof(rec), 1, pqTraceFile);
+}
+
+//---------------------------------------------------------------------------
+// -serialload has Mission::init load everything on the main thread, without
+// the worker threads reading ahead.
+extern bool ParallelMissionLoad;
+
 //DEBUG
 #define MAX_SHAPES	0
 TG_MultiShape 	testShape[36];
@@ -248,10 +292,10 @@ Stuff::Vector3D pos[36] =
 long currentLineElement = 0;
 LineElement *debugLines[10000];
 
-#define ProfileTime(x,y)	x=GetCycles();y;x=GetCycles()-x;
+#define ProfileTime(x,y)	do { x = 0; GOS_PROFILE_STAT(#x,x); y; } while (0)
 extern __int64 MCTimeMultiplayerUpdate;
 #else
-#define ProfileTime(x,y)	y;
+#define ProfileTime(x,y)	do { GOS_PROFILE_ZONE(#x); y; } while (0)
 #endif
 
 #define	MAX_KILL_AT_START	100
@@ -675,6 +719,8 @@ DWORD endTime;
 //---------------------------------------------------------------------------
 void __stdcall UpdateRenderers()
 {
+	GOS_PROFILE_ZONE("UpdateRenderers");
+
 	if (!SnifferMode)
 	{
 		hasGuardBand = true;
@@ -1165,6 +1211,13 @@ void __stdcall InitializeGameEngine()
 				useMusic = FALSE;
 			}
 
+			//No audio device when running headless
+			if (gos_IsHeadless())
+			{
+				useSound = FALSE;
+				useMusic = FALSE;
+			}
+
 			result = systemFile->seekBlock("CameraSettings");
 			if (result == NO_ERR)
 			{
@@ -1663,11 +1716,16 @@ void __stdcall InitializeGameEngine()
 		movieSoundUseDirectSound(0);
 #endif
 
+		if (gos_IsHeadless() && !justStartMission)
+			STOP(("Headless mode needs a mission to run, use -mission <name>"));
+
 		if (justStartMission)
 		{
 			logistics->setLogisticsState(log_STARTMISSIONFROMCMDLINE);
 			char commandersToLoad[MAX_MC_PLAYERS][3] = {{0, 0, 0}, {1, 1, 1}, {2, 0, 2}, {3, 3, 3}, {4, 4, 4}, {5, 5, 5}, {6, 6, 6}, {7, 7, 7}};
+			double loadStart = gos_GetHiResTime();
 			mission->init(missionName, MISSION_LOAD_SP_QUICKSTART, 0, NULL, commandersToLoad, 2);
+			headlessLoadTime = gos_GetHiResTime() - loadStart;
 			eye->activate();
 			eye->update();
 			mission->start();
@@ -1798,6 +1856,13 @@ void __stdcall InitializeGameEngine()
 
 void __stdcall TerminateGameEngine()
 {
+	if (pqTraceFile)
+	{
+		PriorityQueue::traceCallback = NULL;
+		fclose(pqTraceFile);
+		pqTraceFile = NULL;
+	}
+
 	if (!gameStarted)
 		return;
 
@@ -2012,6 +2077,90 @@ float frameNum = 0.0f;
 bool enoughTime = true;
 long enoughCount = 0;
 
+//---------------------------------------------------------------------------
+static const char* headlessResultName (long result)
+{
+	switch (result)
+	{
+		case mis_PLAYER_LOST_BIG:	return "PLAYER_LOST_BIG";
+		case mis_PLAYER_LOST_SMALL:	return "PLAYER_LOST_SMALL";
+		case mis_PLAYER_DRAW:		return "PLAYER_DRAW";
+		case mis_PLAYER_WIN_SMALL:	return "PLAYER_WIN_SMALL";
+		case mis_PLAYER_WIN_BIG:	return "PLAYER_WIN_BIG";
+		case 9999:					return "ABORTED";
+	}
+	return "UNKNOWN";
+}
+
+//---------------------------------------------------------------------------
+void WriteHeadlessResults (long result)
+{
+	File resultsFile;
+	if (resultsFile.create(headlessResultsFile) != NO_ERR)
+	{
+		SPEW(("HEADLESS", "Unable to write results to %s\n", headlessResultsFile));
+		return;
+	}
+
+	char line[1024];
+	sprintf(line, "mission = %s", missionName);
+	resultsFile.writeLine(line);
+	sprintf(line, "result = %ld %s", result, headlessResultName(result));
+	resultsFile.writeLine(line);
+	if (Team::home)
+	{
+		sprintf(line, "objectives = %d status %d", Team::home->objectives.Count(), (int)Team::home->objectives.Status());
+		resultsFile.writeLine(line);
+	}
+
+	//-------------------------------------------------------------
+	// Timings.  Frame length is fixed so scenario time only depends
+	// on how many frames were run, not how long they took.
+	double avgUpdate = headlessFrames ? headlessUpdateTime / headlessFrames : 0.0;
+	sprintf(line, "scenarioTime = %f", scenarioTime);
+	resultsFile.writeLine(line);
+	sprintf(line, "frames = %ld frameLength = %f", headlessFrames, frameLength);
+	resultsFile.writeLine(line);
+	sprintf(line, "loadTime = %f", headlessLoadTime);
+	resultsFile.writeLine(line);
+	sprintf(line, "updateTime = %f avg %f max %f", headlessUpdateTime, avgUpdate, headlessMaxUpdateTime);
+	resultsFile.writeLine(line);
+	if (headlessUpdateTime > 0.0)
+	{
+		sprintf(line, "speedup = %f", scenarioTime / headlessUpdateTime);
+		resultsFile.writeLine(line);
+	}
+	if (losCheckMismatches > -1)
+	{
+		sprintf(line, "losCheck = %ld rays %ld mismatches", losCheckRays, losCheckMismatches);
+		resultsFile.writeLine(line);
+	}
+	if (JumpPointCheck)
+	{
+		sprintf(line, "jpsCheck = %ld paths %ld worse", JumpPointChecks, JumpPointWorse);
+		resultsFile.writeLine(line);
+	}
+
+	//-------------------------------------------------------------
+	// One line per mover: team, commander, status and name
+	if (ObjectManager)
+	{
+		for (long i=0;i<ObjectManager->getNumMovers();i++)
+		{
+			MoverPtr mover = ObjectManager->getMover(i);
+			const char* status = "ok";
+			if (mover->isDestroyed())
+				status = "destroyed";
+			else if (mover->isDisabled())
+				status = "disabled";
+			sprintf(line, "mover %ld team %ld commander %ld %s %s", i, mover->getTeamId(), mover->getCommanderId(), status, mover->getName() ? mover->getName() : "");
+			resultsFile.writeLine(line);
+		}
+	}
+
+	resultsFile.close();
+}
+
 //---------------------------------------------------------------------------
 //
 // No multi-thread now!
@@ -2019,6 +2168,8 @@ long enoughCount = 0;
 bool DoneSniffing = false;
 void __stdcall DoGameLogic()
 {
+	GOS_PROFILE_ZONE("DoGameLogic");
+
 	if (!SnifferMode)
 	{
 	#ifdef LAB_ONLY		//Used for debugging LOS
@@ -2116,7 +2267,30 @@ void __stdcall DoGameLogic()
 				}
 			}
 			else
-			if (mission && (!optionsScreenWrapper || optionsScreenWrapper->isDone() ) )
+			if (mission && gos_IsHeadless())
+			{
+				//---------------------------------------------------------
+				// Nothing to show and nobody to ask, so the mission is
+				// only updated and the results written when it is over.
+				double updateStart = gos_GetHiResTime();
+				long result = mission->update();
+				double updateTime = gos_GetHiResTime() - updateStart;
+				headlessUpdateTime += updateTime;
+				if (updateTime > headlessMaxUpdateTime)
+					headlessMaxUpdateTime = updateTime;
+				headlessFrames++;
+
+				if ((result == mis_PLAYING) && (headlessMaxTime > 0.0f) && (scenarioTime >= headlessMaxTime))
+					result = mis_PLAYER_DRAW;
+
+				if (result != mis_PLAYING)
+				{
+					WriteHeadlessResults(result);
+					mission->destroy();
+					quitGame = true;
+				}
+			}
+			else if (mission && (!optionsScreenWrapper || optionsScreenWrapper->isDone() ) )
 			{
 				long result = mission->update();
 				if (result == 9999) {
@@ -2504,6 +2678,51 @@ void ParseCommandLine(const char *command_line)
 		{
 			gNoDialogs = true;
 		}
+		else if (S_stricmp(argv[i],"-results") == 0)
+		{
+			i++;
+			if (i < n_args)
+				strncpy(headlessResultsFile,argv[i],sizeof(headlessResultsFile)-1);
+		}
+		else if (S_stricmp(argv[i],"-maxtime") == 0)
+		{
+			i++;
+			if (i < n_args)
+				headlessMaxTime = (float)textToLong(argv[i]);
+		}
+		else if (S_stricmp(argv[i],"-loscheck") == 0)
+		{
+			i++;
+			if (i < n_args)
+				losCheckRays = textToLong(argv[i]);
+		}
+		else if (S_stricmp(argv[i],"-jps") == 0)
+		{
+			UseJumpPointSearch = true;
+		}
+		else if (S_stricmp(argv[i],"-jpscheck") == 0)
+		{
+			UseJumpPointSearch = true;
+			JumpPointCheck = true;
+		}
+		else if (S_stricmp(argv[i],"-pqtrace") == 0)
+		{
+			i++;
+			if (i < n_args)
+			{
+				pqTraceFile = fopen(argv[i], "wb");
+				if (pqTraceFile)
+				{
+					DWORD traceId = PQ_TRACE_ID;
+					fwrite(&traceId, sizeof(traceId), 1, pqTraceFile);
+					PriorityQueue::traceCallback = recordPQTrace;
+				}
+			}
+		}
+		else if (S_stricmp(argv[i],"-serialload") == 0)
+		{
+			ParallelMissionLoad = false;
+		}
 		else if (S_stricmp(argv[i],"-sniffer") == 0)
 		{
 			SnifferMode = true;
@@ -2612,6 +2831,17 @@ void ParseCommandLine(const char *command_line)
 			if (i < n_args)
 				MaxResourcePoints = textToLong(argv[i]);
 		}
+		else if (S_stricmp(argv[i], "-ablvm") == 0) {
+			i++;
+			if (i < n_args) {
+				if (S_stricmp(argv[i], "off") == 0)
+					ABLi_setVMMode(ABL_VM_OFF);
+				if (S_stricmp(argv[i], "on") == 0)
+					ABLi_setVMMode(ABL_VM_ON);
+				if (S_stricmp(argv[i], "verify") == 0)
+					ABLi_setVMMode(ABL_VM_VERIFY);
+			}
+		}
 		else if (S_stricmp(argv[i], "-registerzone") == 0) {
 			MultiPlayer::registerZone = true;
 		}
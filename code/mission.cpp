@@ -130,6 +130,12 @@ float minFrameLength = 1.0/4.0;
 long MissionStartTime =	0;			//No Idea
 
 Mission *mission = NULL;
+
+//----------------------------------------------------------------------------------
+// Mission::init has worker threads read and unpack the terrain packets, object
+// types, ABL and mech shapes ahead of the code which loads them (LoadGraph).
+// Turned off by -serialload.
+bool ParallelMissionLoad = true;
 unsigned long scenarioResult = mis_PLAYING;
 long scenarioEndTurn = -1;
 
@@ -196,6 +202,9 @@ bool GeneralAlarm = false;
 
 extern bool KillAmbientLight;
 
+extern long losCheckRays;
+extern long losCheckMismatches;
+
 extern GameLog* CombatLog;
 #ifndef FINAL
 float CheatHitDamage = 0.0f;
@@ -226,7 +235,7 @@ extern PriorityQueuePtr	openList;
 // Macro used for statistic timing of main functions
 //
 #ifdef LAB_ONLY
-#define ProfileTime(x,y)	x=GetCycles();y;x=GetCycles()-x;
+#define ProfileTime(x,y)	do { x = 0; GOS_PROFILE_STAT(#x,x); y; } while (0)
 extern __int64 MCTimeTerrainUpdate 	;
 extern __int64 MCTimeCameraUpdate 		;
 extern __int64 MCTimeWeatherUpdate 	;
@@ -240,7 +249,6 @@ extern __int64 MCTimePath5Update ;
 extern __int64 MCTimeCalcGoal1Update ;
 extern __int64 MCTimeCalcPath1Update;
 extern __int64 MCTimeCalcPath2Update;
-extern __int64 MCTimeCalcPath3Update;
 extern __int64 MCTimeCalcPath4Update;
 extern __int64 MCTimeCalcPath5Update;
 extern __int64 MCTimeCalcGoal2Update ;
@@ -287,13 +295,8 @@ extern __int64 MCTimeCommanderLoad 	;
 extern __int64 MCTimeMiscLoad 			; 
 extern __int64 MCTimeGUILoad 			; 
 
-extern __int64 x1;
-
-extern __int64 x;
-
-
 #else
-#define ProfileTime(x,y)	y;
+#define ProfileTime(x,y)	do { GOS_PROFILE_ZONE(#x); y; } while (0)
 #endif
 
 long GameVisibleVertices		= 60;
@@ -317,6 +320,8 @@ extern bool 			invulnerableON;		//Used for tutorials so mechs can take damage, b
 // class Mission
 long Mission::update (void)
 {
+	GOS_PROFILE_ZONE("Mission::update");
+
 	if (active)
 	{
 		turn++;
@@ -411,7 +416,13 @@ long Mission::update (void)
 
 		//--------------------------------------------------
 		// Update length of time scenario has been running.
-		if (!missionInterface->isPaused() || MPlayer )
+		if (gos_IsHeadless())
+		{
+			//Headless runs go as fast as they can, system time means nothing.
+			// GameOS keeps frameRate fixed so every frame is the same length.
+			scenarioTime += frameLength;
+		}
+		else if (!missionInterface->isPaused() || MPlayer )
 		{
 			//First Frame we just set LastTimeGetTime.
 			// After that, it increments based on System Time.
@@ -463,7 +474,11 @@ long Mission::update (void)
 		}
 #endif
 
-		mcTextureManager->clearArrays();
+		//Nothing is drawn when headless, skip everything which only feeds the renderer
+		bool headless = gos_IsHeadless();
+
+		if (!headless)
+			mcTextureManager->clearArrays();
 		
 		if (missionInterface)
 			ProfileTime(MCTimeInterfaceUpdate,missionInterface->update());
@@ -475,14 +490,11 @@ long Mission::update (void)
 		ProfileTime(MCTimeTerrainUpdate,land->update());
 
 		//ALWAYS update weather AFTER the camera.  May change the lights!
-		if (useNonWeaponEffects)
+		if (useNonWeaponEffects && !headless)
 			ProfileTime(MCTimeWeatherUpdate,weather->update());		//Should the rain fall during a pause?
 		
 		missionInterface->updateWaypoints();
 
-#ifdef USE_PATH_COST_TABLE
-		GlobalMoveMap[0]->resetPathCostTable();
-#endif
 		ProfileTime(MCTimePathManagerUpdate,PathManager->update());
 
 		if (KillAmbientLight) {
@@ -495,10 +507,12 @@ long Mission::update (void)
 		// Also reset the object flags because we recalc those during geometry!
 		land->clearObjBlocksActive();
 		land->clearObjVerticesActive();
-		land->terrainTextures->update();
-
+		if (!headless)
+		{
+			land->terrainTextures->update();
 
-		ProfileTime(MCTimeTerrainGeometry,land->geometry());
+			ProfileTime(MCTimeTerrainGeometry,land->geometry());
+		}
 
 		if ( missionInterface->isPaused() && !MPlayer )
 			ObjectManager->updateAppearancesOnly( true, true, true );
@@ -509,7 +523,7 @@ long Mission::update (void)
 		
 		//Do not UPDATE the textures during a pause.  
 		//This uncaches things which only objectManager->update can cache back in!!!!!
-		if ( !missionInterface->isPaused() || MPlayer )
+		if ( (!missionInterface->isPaused() || MPlayer) && !headless )
 			ProfileTime(MCTimeTXMManagerUpdate,mcTextureManager->update());
 
 		//--------------------------------------
@@ -559,7 +573,8 @@ long Mission::update (void)
 		if (!neverEndingStory && terminationCounterStarted) 
 		{
 			if (missionTerminationTime <= actualTime) {
-				if (ControlGui::instance->resultsDone()) {
+				//Nobody watches the results screen when headless
+				if (headless || ControlGui::instance->resultsDone()) {
 					/* if the gui is finished rendering objective results then end it */
 					scenarioResult = terminationResult;
 
@@ -714,7 +729,6 @@ long Mission::update (void)
 									MCTimePath5Update + 
 									MCTimeCalcPath1Update +
 									MCTimeCalcPath2Update +
-									MCTimeCalcPath3Update +
 									MCTimeCalcPath4Update +
 									MCTimeCalcPath5Update +
 									MCTimeCalcGoal1Update + 
@@ -755,6 +769,8 @@ long Mission::getStatus (void) {
 
 long Mission::render (void)
 {
+	GOS_PROFILE_ZONE("Mission::render");
+
 	if (active)
 	{
 		unsigned char tempAmbientLight[3];
@@ -1628,6 +1644,95 @@ bool IsGateOpen (int objectWID) {
 	return(false);
 }
 
+//----------------------------------------------------------------------------
+// The terrain objects are in packet 1 of the terrain file, an int count and
+// then 10 ints each, the first of which is the object type.
+static void PrefetchTerrainObjectTypes (LoadGraph *graph, void *data)
+{
+	PacketFile *pakFile = (PacketFile *)data;
+
+	long size = 0;
+	MemoryPtr objectData = graph->getPacketData(pakFile, 1, size);
+	MemoryPtr ownData = NULL;
+	if (!objectData) {
+		size = pakFile->getPacketSizeAt(1);
+		if (size <= 0)
+			return;
+		ownData = (MemoryPtr)malloc(size);
+		if (!ownData || (pakFile->readPacketAt(1, ownData) != size)) {
+			free(ownData);
+			return;
+		}
+		objectData = ownData;
+	}
+
+	int *record = (int *)objectData;
+	long numObjects = *record++;
+	if ((numObjects > 0) && ((long)((numObjects * 10 + 1) * sizeof(int)) <= size)) {
+		long lastObjTypeNum = -1;
+		for (long i = 0; i < numObjects; i++, record += 10) {
+			if (record[0] == lastObjTypeNum)
+				continue;
+			lastObjTypeNum = record[0];
+			//------------------------------------------------------
+			// ObjectTypeManager::load reads the packet twice.
+			graph->prefetchPacket(ObjectTypeManager::objectFile, lastObjTypeNum, 2);
+		}
+	}
+
+	free(ownData);
+}
+
+//----------------------------------------------------------------------------
+// Queues up everything Mission::init reads from the terrain on which doesn't
+// need anything loaded first.  Leaves missionFile in no particular block.
+static void PrefetchMission (LoadGraph *graph, PacketFile *pakFile, FitIniFile *missionFile)
+{
+	for (long i = 0; i < pakFile->getNumPackets(); i++)
+		graph->prefetchPacket(pakFile, i);
+
+	long terrainObjectsTask = graph->prefetchPacket(pakFile, 1);
+	graph->addTask(PrefetchTerrainObjectTypes, pakFile, false, 1, &terrainObjectsTask);
+
+	FullPathFileName fileName;
+	fileName.init(missionPath, "orders", ".abx");
+	graph->prefetchFile(fileName);
+	fileName.init(missionPath, "miscfunc", ".abx");
+	graph->prefetchFile(fileName);
+	fileName.init(missionPath, "corebrain", ".abx");
+	graph->prefetchFile(fileName);
+
+	char name[128];
+	if ((missionFile->seekBlock("Script") == NO_ERR) && (missionFile->readIdString("ScenarioScript", name, 79) == NO_ERR)) {
+		fileName.init(missionPath, name, ".abl");
+		graph->prefetchFile(fileName);
+	}
+
+	unsigned long numWarriors = 0;
+	if ((missionFile->seekBlock("Warriors") == NO_ERR) && (missionFile->readIdULong("NumWarriors", numWarriors) == NO_ERR)) {
+		for (unsigned long i = 1; i <= numWarriors; i++) {
+			char warriorName[32];
+			sprintf(warriorName, "Warrior%lu", i);
+			if (missionFile->seekBlock(warriorName) != NO_ERR)
+				continue;
+
+			if (missionFile->readIdString("Profile", name, 99) == NO_ERR) {
+				fileName.init(warriorPath, name, ".fit");
+				graph->prefetchFile(fileName);
+			}
+
+			//---------------------------------------------------
+			// Brains are shared, ABL only reads each one once.
+			if (MPlayer)
+				strcpy(name, "pbrain");
+			else if (missionFile->readIdString("Brain", name, 127) != NO_ERR)
+				continue;
+			fileName.init(warriorPath, name, ".abl");
+			graph->prefetchFile(fileName);
+		}
+	}
+}
+
 //----------------------------------------------------------------------------
 void Mission::init (const char *missionName, long loadType, long dropZoneID, Stuff::Vector3D* dropZoneList, char commandersToLoad[8][3], long numMoversPerCommander)
 {
@@ -1684,18 +1789,18 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 	turn = 0;
 	terminationCounterStarted = 0;
 
-	#ifdef LAB_ONLY
-	x=GetCycles();
-	#endif
+#ifdef LAB_ONLY
+	MCTimeABLLoad = MCTimeMiscToTeamLoad = MCTimeTeamLoad = MCTimeObjectLoad = MCTimeTerrainLoad = 0;
+	MCTimeMoveLoad = MCTimeMissionABLLoad = MCTimeWarriorLoad = MCTimeMoverPartsLoad = 0;
+	MCTimeObjectiveLoad = MCTimeCommanderLoad = MCTimeMiscLoad = MCTimeGUILoad = 0;
+#endif
+	GOS_PROFILE_NAMED_STAT(loadZone,"ABL Load",MCTimeABLLoad);
 
 	//-----------------------
 	// Init the ABL system...
 	initABL();
 
-#ifdef LAB_ONLY
-	x1=GetCycles();
-	MCTimeABLLoad=x1-x;
-#endif
+	GOS_PROFILE_NEXT_STAT(loadZone,"Misc To Team Load",MCTimeMiscToTeamLoad);
 
 	initBareMinimum();
 	loadProgress = 4.0f;
@@ -1954,10 +2059,7 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 		}
 	}
 
-#ifdef LAB_ONLY
-	x=GetCycles();
-	MCTimeMiscToTeamLoad=x-x1;
-#endif
+	GOS_PROFILE_NEXT_STAT(loadZone,"Team Load",MCTimeTeamLoad);
 
 	//-----------------------------------
 	// Find the SKY Number and save it.
@@ -2108,10 +2210,7 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 		dropZone.y = -1.f;
 	}
 
-#ifdef LAB_ONLY
-	x1=GetCycles();
-	MCTimeTeamLoad=x1-x;
-#endif
+	GOS_PROFILE_NEXT_STAT(loadZone,"Object Load",MCTimeObjectLoad);
 
 	//-----------------------------------------------------------------
 	// Load the names of the scenario tunes.
@@ -2169,6 +2268,13 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 	result = pakFile.open( terrainFileName );
 	gosASSERT( result == NO_ERR );
 
+	//-----------------------------------------------------------------
+	// Start reading ahead.  Everything below still loads in the same
+	// order on this thread, it just finds most of its data unpacked.
+	LoadGraph loadGraph;
+	if (ParallelMissionLoad && loadGraph.start())
+		PrefetchMission(&loadGraph, &pakFile, missionFile);
+
 	land = new Terrain;
 
 	land->getColorMapName(missionFile);
@@ -2177,10 +2283,7 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 
 	loadProgress = 15.0f;
 
-#ifdef LAB_ONLY
-	x=GetCycles();
-	MCTimeObjectLoad=x-x1;
-#endif
+	GOS_PROFILE_NEXT_STAT(loadZone,"Terrain Load",MCTimeTerrainLoad);
 
 	long terrainInitResult = land->init(&pakFile, 0, GameVisibleVertices, loadProgress, 20.0 );
 
@@ -2191,10 +2294,7 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 
 	loadProgress = 35.0f;
 
-#ifdef LAB_ONLY
-	x1=GetCycles();
-	MCTimeTerrainLoad=x1-x;
-#endif
+	GOS_PROFILE_NEXT_STAT(loadZone,"Move Load",MCTimeMoveLoad);
 
 	land->load( missionFile );
 
@@ -2235,10 +2335,7 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 
 	loadProgress = 40.0f;
 
-#ifdef LAB_ONLY
-	x=GetCycles();
-	MCTimeMoveLoad=x-x1;
-#endif
+	GOS_PROFILE_NEXT_STAT(loadZone,"Mission ABL Load",MCTimeMissionABLLoad);
 
 	//----------------------
 	// Load ABL Libraries...
@@ -2291,10 +2388,7 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 
 	missionBrainCallback = missionBrain->findFunction("handlemessage", TRUE);
 
-#ifdef LAB_ONLY
-	x1=GetCycles();
-	MCTimeMissionABLLoad=x1-x;
-#endif
+	GOS_PROFILE_NEXT_STAT(loadZone,"Warrior Load",MCTimeWarriorLoad);
 
 	loadProgress = 41.0f;
 
@@ -2388,10 +2482,7 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 				
 	}	
 	
-#ifdef LAB_ONLY
-	x=GetCycles();
-	MCTimeWarriorLoad=x-x1;
-#endif
+	GOS_PROFILE_NEXT_STAT(loadZone,"Mover Parts Load",MCTimeMoverPartsLoad);
 
 	loadProgress = 43.0f;
 
@@ -2682,6 +2773,10 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 	}
 
 	loadProgress = 48.5f;
+
+	for (int i = 1; i < (numParts + 1); i++)
+		loadGraph.prefetchPacket(ObjectTypeManager::objectFile, parts[i].objNumber, 2);
+
 	//--------------------------------------------------------------------------
 	// Now that the parts data has been loaded, let's prep the ObjectManager for
 	// the real things. First, count the number of objects we need...
@@ -2689,7 +2784,10 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 	long numVehicles = 0;
 	for (int i = 1; i < (numParts + 1); i++) 
 	{
+		loadGraph.runMainTasks();
+
 		ObjectTypePtr objType = ObjectManager->loadObjectType(parts[i].objNumber);
+		bool newType = (objType != NULL);
 		if (!objType)
 			objType = ObjectManager->getObjectType(parts[i].objNumber);
 		if (objType)
@@ -2697,6 +2795,8 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 			{
 				case BATTLEMECH_TYPE:
 					numMechs++;
+					if (newType)
+						Mech3DAppearanceType::prefetch(&loadGraph, objType->getAppearanceTypeName());
 					break;
 				case VEHICLE_TYPE:
 					numVehicles++;
@@ -2743,6 +2843,7 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 				if (parts[i].commanderID == -1)
 					loadEm = false;
 			if (loadEm) {
+				loadGraph.runMainTasks();
 				ObjectTypePtr objType = ObjectManager->getObjectType(parts[i].objNumber);
 				if (objType)
 					switch (objType->getObjectTypeClass()) 
@@ -2773,14 +2874,18 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 			}
 		}
 
-#ifdef LAB_ONLY
-	x1=GetCycles();
-	MCTimeMoverPartsLoad=x1-x;
-#endif
+	GOS_PROFILE_NEXT_STAT(loadZone,"Objective Load",MCTimeObjectiveLoad);
 
 	loadProgress = 68.0f;
 
-	ObjectManager->loadTerrainObjects(&pakFile, loadProgress, 30);
+	//-----------------------------------------------------------------
+	// Done reading ahead.  Progress from here follows the tasks still
+	// in flight, the terrain objects' types are among them.
+	loadGraph.waitAll(loadProgress, 5.0f);
+
+	ObjectManager->loadTerrainObjects(&pakFile, loadProgress, 25);
+
+	loadGraph.destroy();
 
 	loadProgress = 98.0f;
 
@@ -2840,10 +2945,7 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 	}
 	ReadNavMarkers(missionFile, Team::home->objectives);
 */
-#ifdef LAB_ONLY
-	x=GetCycles();
-	MCTimeObjectiveLoad=x-x1;
-#endif
+	GOS_PROFILE_NEXT_STAT(loadZone,"Commander Load",MCTimeCommanderLoad);
 
 	//----------------------------
 	// Read in Commander Groups...
@@ -2892,10 +2994,7 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 	if (!MPlayer)
 		Commander::home->setLocalMoverId(0);
 
-#ifdef LAB_ONLY
-	x1=GetCycles();
-	MCTimeCommanderLoad=x1-x;
-#endif
+	GOS_PROFILE_NEXT_STAT(loadZone,"Misc Load",MCTimeMiscLoad);
 
 	//-----------------------------------------------------
 	// This tracks time since scenario started in seconds.
@@ -2927,10 +3026,7 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 
 	loadProgress = 99.0;
 
-#ifdef LAB_ONLY
-	x=GetCycles();
-	MCTimeMiscLoad=x-x1;
-#endif
+	GOS_PROFILE_NEXT_STAT(loadZone,"GUI Load",MCTimeGUILoad);
 
 	//----------------------------------------------------------------------------
 	// Start the Mission GUI
@@ -2966,6 +3062,15 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 
 	Mover::initOptimalCells(32);
 
+	//-----------------------------------------------------------------
+	// Buildings and trees have marked their heights by now.  From here
+	// on GameMap keeps its LOS heights and move classes current as they
+	// get knocked down.
+	GameMap->buildLOSHeights();
+	GameMap->buildMoveClasses();
+	if (losCheckRays > 0)
+		losCheckMismatches = Team::checkLOSHeights(losCheckRays);
+
 	//--------------------------------------------------
 	// Close all walls and open gates and landbridges...
 //	GameObjectPtr wallObjects[MAX_WALL_OBJECTS];
@@ -2983,10 +3088,7 @@ void Mission::init (const char *missionName, long loadType, long dropZoneID, Stu
 	if (CombatLog)
 		MechWarrior::logPilots(CombatLog);
 
-#ifdef LAB_ONLY
-	x1=GetCycles();
-	MCTimeGUILoad=x1-x;
-#endif
+	loadZone.end();
 
 #ifdef LAB_ONLY	
 	//Add Mission Load statistics to GameOS Debugger screen!
@@ -27,8 +27,6 @@ __int64 MCTimeCommanderLoad 	= 0;
 __int64 MCTimeMiscLoad 			= 0; 
 __int64 MCTimeGUILoad 			= 0; 
 
-__int64 x1;
-
 __int64 MCTimeMultiplayerUpdate = 0;
 __int64 MCTimeTerrainUpdate 	= 0;
 __int64 MCTimeCameraUpdate 		= 0;
@@ -44,7 +42,6 @@ __int64 MCTimePath5Update = 0;
  __int64 MCTimeCalcGoal1Update = 0;
  extern __int64 MCTimeCalcPath1Update;
  extern __int64 MCTimeCalcPath2Update;
- extern __int64 MCTimeCalcPath3Update;
  extern __int64 MCTimeCalcPath4Update;
  extern __int64 MCTimeCalcPath5Update;
  __int64 MCTimeCalcGoal2Update = 0;
@@ -99,8 +96,6 @@ extern __int64 MCTimeTurretsTL;
 
 extern __int64 MCTimeAnimationCalc;
 
-extern __int64 x;
-
 extern float OneOverProcessorSpeed;
 #endif
 
@@ -183,7 +178,6 @@ void Mission::initializeStatistics()
 	AddStatistic( "   Path5 Update",				"%", gos_timedata, (void*)&MCTimePath5Update  ,				0 ); 
 	AddStatistic( "   CalcPath1 Update",			"%", gos_timedata, (void*)&MCTimeCalcPath1Update  ,			0 ); 
 	AddStatistic( "   CalcPath2 Update",			"%", gos_timedata, (void*)&MCTimeCalcPath2Update  ,			0 ); 
-	AddStatistic( "   CalcPath3 Update",			"%", gos_timedata, (void*)&MCTimeCalcPath3Update  ,			0 ); 
 	AddStatistic( "   CalcPath4 Update",			"%", gos_timedata, (void*)&MCTimeCalcPath4Update  ,			0 ); 
 	AddStatistic( "   CalcPath5 Update",			"%", gos_timedata, (void*)&MCTimeCalcPath5Update  ,			0 ); 
 	AddStatistic( "   CalcGoal1 Update",			"%", gos_timedata, (void*)&MCTimeCalcGoal1Update  ,			0 ); 
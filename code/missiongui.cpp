@@ -4778,12 +4778,9 @@ int MissionInterfaceManager::quickDebugInfo() {
 				wPos.x, wPos.y, wPos.z,
 				PathManager->numPaths, PathManager->peakPaths);
 		DEBUGWINS_print(debugString);
-		sprintf(debugString, "REQ =");
-		char s[10];
-		for (long i = 0; i < 25; i++) {
-			sprintf(s, " %02d", PathManager->sourceTally[i]);
-			strcat(debugString, s);
-		}
+		sprintf(debugString, "PATHMGR = %d calced in %.2fms, latency avg %.3fs max %.3fs, %d redone",
+			PathManager->numPathsLastFrame, PathManager->calcTimeLastFrame,
+			PathManager->avgLatency, PathManager->maxLatency, PathManager->numPathsRedone);
 		DEBUGWINS_print(debugString);
 		lastTime = gos_GetElapsedTime();
 	}
@@ -20,14 +20,97 @@
 #include"warrior.h"
 #endif
 
+#ifndef MOVER_H
+#include"mover.h"
+#endif
+
 #include"gameos.hpp"
+#include"toolos.hpp"
+
+#include<vector>
+#include<thread>
+#include<mutex>
+#include<condition_variable>
 
+//---------------------------------------------------------------------------
+// Batches are calced until the frame budget is used up. At least this many
+// paths are done each update, so a slow path can't stall the queue...
+#define	MIN_PATHS_PER_UPDATE	1
+#define	LATENCY_AVG_WEIGHT		0.1f
 
 long MovePathManager::numPaths = 0;
 long MovePathManager::peakPaths = 0;
-long MovePathManager::sourceTally[50];
+long MovePathManager::numPathsLastFrame = 0;
+float MovePathManager::calcTimeLastFrame = 0.0f;
+float MovePathManager::avgLatency = 0.0f;
+float MovePathManager::maxLatency = 0.0f;
+float MovePathManager::frameBudget = 3.0f;
+long MovePathManager::numThreads = 0;
+long MovePathManager::numPathsRedone = 0;
 MovePathManagerPtr PathManager = NULL;
 
+//---------------------------------------------------------------------------
+typedef struct _MovePathJob {
+	MechWarriorPtr				pilot;
+	MovePathCalc				calc;
+	MoveMapPtr					map;					// only this job's search uses it
+	MovePathPtr					path;
+} MovePathJob;
+
+struct MovePathWorkers
+{
+	MovePathJob					jobs[MOVE_PATH_BATCH];
+	std::vector<std::thread>	threads;
+	std::mutex					lock;
+	std::condition_variable		wakeUp;					//Threads: there are searches, or we quit.
+	std::condition_variable		batchDone;				//Main thread: the last search is done.
+	long						searches[MOVE_PATH_BATCH];	//Jobs to search, only changed under the lock.
+	long						numSearches;
+	long						nextSearch;
+	long						numSearchesLeft;
+	bool						quit;
+};
+
+//---------------------------------------------------------------------------
+static void SearchMovePath (MovePathJob *job)
+{
+	int goalCell[2];
+	job->calc.numSteps = job->map->search(job->path, NULL, goalCell);
+}
+
+//---------------------------------------------------------------------------
+// The lock is held on entry and on return, but not during the search.
+static void RunMovePathSearch (MovePathWorkers *workers, std::unique_lock<std::mutex> &guard)
+{
+	MovePathJob *job = &workers->jobs[workers->searches[workers->nextSearch++]];
+
+	guard.unlock();
+	SearchMovePath(job);
+	guard.lock();
+
+	if (--workers->numSearchesLeft == 0)
+		workers->batchDone.notify_all();
+}
+
+//---------------------------------------------------------------------------
+static void MovePathWorker (MovePathWorkers *workers)
+{
+	if (gos_ProfilerActive)
+		gos_ProfilerSetThreadName("Path Worker");
+
+	std::unique_lock<std::mutex> guard(workers->lock);
+	for (;;)
+	{
+		while (!workers->quit && (workers->nextSearch == workers->numSearches))
+			workers->wakeUp.wait(guard);
+
+		if (workers->quit)
+			return;
+
+		RunMovePathSearch(workers,guard);
+	}
+}
+
 //***************************************************************************
 // PATH MANAGER class
 //***************************************************************************
@@ -70,17 +153,69 @@ long MovePathManager::init (void) {
 	freeList = &pool[0];
 
 	numPaths = 0;
-	peakPaths = 0;
-	for (int i =0; i < 50; i++)
-		sourceTally[i] = 0;
+	resetStats();
+
+	//-----------------------------------------------------------------
+	// Each job in a batch gets its own map and path. The maps allocate
+	// themselves the first time they're set up...
+	workers = new MovePathWorkers;
+	for (long i = 0; i < MOVE_PATH_BATCH; i++) {
+		workers->jobs[i].pilot = NULL;
+		workers->jobs[i].map = new MoveMap;
+		gosASSERT(workers->jobs[i].map != NULL);
+		workers->jobs[i].path = new MovePath;
+		gosASSERT(workers->jobs[i].path != NULL);
+	}
+	workers->numSearches = 0;
+	workers->nextSearch = 0;
+	workers->numSearchesLeft = 0;
+	workers->quit = false;
+
+	//-----------------------------------------------------
+	// Leave one core for the game itself, which also searches.
+	numThreads = std::thread::hardware_concurrency() - 1;
+	if (numThreads > MOVE_PATH_MAX_THREADS)
+		numThreads = MOVE_PATH_MAX_THREADS;
+	for (long i = 0; i < numThreads; i++)
+		workers->threads.push_back(std::thread(MovePathWorker, workers));
 
 	return(NO_ERR);
 }
 
 //---------------------------------------------------------------------------
 
+void MovePathManager::resetStats (void) {
+
+	peakPaths = numPaths;
+	numPathsLastFrame = 0;
+	calcTimeLastFrame = 0.0f;
+	avgLatency = 0.0f;
+	maxLatency = 0.0f;
+	numPathsRedone = 0;
+}
+
+//---------------------------------------------------------------------------
+
 void MovePathManager::destroy (void) {
 
+	if (!workers)
+		return;
+
+	{
+		std::lock_guard<std::mutex> guard(workers->lock);
+		workers->quit = true;
+	}
+	workers->wakeUp.notify_all();
+	for (size_t i = 0; i < workers->threads.size(); i++)
+		workers->threads[i].join();
+	numThreads = 0;
+
+	for (long i = 0; i < MOVE_PATH_BATCH; i++) {
+		delete workers->jobs[i].map;
+		delete workers->jobs[i].path;
+	}
+	delete workers;
+	workers = NULL;
 }
 
 //---------------------------------------------------------------------------
@@ -104,7 +239,6 @@ void MovePathManager::remove (PathQueueRecPtr rec) {
 	rec->next = freeList;
 	freeList = rec;
 
-	sourceTally[rec->num]--;
 	numPaths--;
 }
 
@@ -150,6 +284,7 @@ void MovePathManager::request (MechWarriorPtr pilot, long selectionIndex, unsign
 	pathQRec->pilot = pilot;
 	pathQRec->selectionIndex = selectionIndex;
 	pathQRec->moveParams = moveParams;
+	pathQRec->requestTime = gos_GetHiResTime();
 
 	if (queueEnd) {
 		queueEnd->next = pathQRec;
@@ -165,7 +300,6 @@ void MovePathManager::request (MechWarriorPtr pilot, long selectionIndex, unsign
 	pilot->setMovePathRequest(pathQRec);
 	
 	numPaths++;
-	sourceTally[source]++;
 
 	if (numPaths > peakPaths)
 		peakPaths = numPaths;
@@ -173,24 +307,96 @@ void MovePathManager::request (MechWarriorPtr pilot, long selectionIndex, unsign
 
 //---------------------------------------------------------------------------
 
-void MovePathManager::calcPath (void) {
+long MovePathManager::calcPaths (void) {
 
-	if (queueFront) {
-		//------------------------------
-		// Grab the next in the queue...
+	//-------------------------------------------------------------------
+	// Start the next batch, in queue order. startMovePath sets each simple
+	// path search up in the job's own map...
+	long numRequests = 0;
+	long numJobs = 0;
+	long numSearches = 0;
+	long searches[MOVE_PATH_BATCH];
+	while (queueFront && (numRequests < MOVE_PATH_BATCH)) {
 		PathQueueRecPtr curQRec = queueFront;
 		remove(queueFront);
+		numRequests++;
 
 		//--------------------------------------------------
 		// If the mover is no longer around, don't bother...
 		MechWarriorPtr pilot = curQRec->pilot;
 		pilot->setMovePathRequest(NULL);
+
+		float latency = (float)(gos_GetHiResTime() - curQRec->requestTime);
+		avgLatency += (latency - avgLatency) * LATENCY_AVG_WEIGHT;
+		if (latency > maxLatency)
+			maxLatency = latency;
+
 		MoverPtr mover = pilot->getVehicle();
 		if (!mover)
-			return;
+			continue;
+
+		MovePathJob* job = &workers->jobs[numJobs++];
+		job->pilot = pilot;
+		job->map->blockedDoorCallback = PathFindMap[SIMPLE_PATHMAP]->blockedDoorCallback;
+		job->map->placeStationaryMoversCallback = PathFindMap[SIMPLE_PATHMAP]->placeStationaryMoversCallback;
+		job->calc.map = job->map;
+		job->calc.path = job->path;
+		/*long err = */pilot->startMovePath(&job->calc, curQRec->selectionIndex, curQRec->moveParams);
+		if (job->calc.search)
+			searches[numSearches++] = numJobs - 1;
+	}
+
+	//-------------------------------------------------------------------
+	// Run the searches. The search threads and this one share them out.
+	// JumpPointCheck keeps them all here, since it tallies every search,
+	// and so does recording open list traces, which go to one file...
+	if ((numThreads > 0) && (numSearches > 1) && !JumpPointCheck && !PriorityQueue::traceCallback) {
+		std::unique_lock<std::mutex> guard(workers->lock);
+		for (long i = 0; i < numSearches; i++)
+			workers->searches[i] = searches[i];
+		workers->numSearches = workers->numSearchesLeft = numSearches;
+		workers->nextSearch = 0;
+		workers->wakeUp.notify_all();
+		while (workers->nextSearch < workers->numSearches)
+			RunMovePathSearch(workers, guard);
+		while (workers->numSearchesLeft > 0)
+			workers->batchDone.wait(guard);
+		workers->numSearches = workers->nextSearch = 0;
+		}
+	else {
+		for (long i = 0; i < numSearches; i++)
+			SearchMovePath(&workers->jobs[searches[i]]);
+	}
 
-		/*long err = */pilot->calcMovePath(curQRec->selectionIndex, curQRec->moveParams);
+	//-------------------------------------------------------------
+	// ...and finish the batch in queue order, no matter which thread
+	// got done first. Every search only saw the pathlocks from before
+	// the batch, so one which runs thru cells an earlier path in the
+	// batch has locked since is set up and searched again, right here,
+	// as if it had been calced after it...
+	for (long i = 0; i < numJobs; i++) {
+		MovePathJob* job = &workers->jobs[i];
+		if (job->calc.search && (job->calc.numSteps > 0) && (job->calc.moveParams & MOVEPARAM_AVOID_PATHLOCKS)) {
+			long lockLevel = (job->pilot->getVehicle()->getMoveLevel() == 2);
+			for (long j = 0; j < i; j++) {
+				MoverPtr lockMover = workers->jobs[j].pilot->getVehicle();
+				if (lockMover && lockMover->pathLocksCross(job->path, job->calc.numSteps, lockLevel)) {
+					job->pilot->setUpSimpleMovePath(&job->calc);
+					if (job->calc.search)
+						SearchMovePath(job);
+					numPathsRedone++;
+					break;
+				}
+			}
+		}
+		job->map->setMover(0);
+		if (job->calc.finish)
+			/*long err = */job->pilot->finishMovePath(&job->calc);
 	}
+	for (long i = 0; i < numJobs; i++)
+		workers->jobs[i].pilot = NULL;
+
+	return(numRequests);
 }
 
 //----------------------------------------------------------------------------------
@@ -225,27 +431,23 @@ void MovePathManager::update (void) {
 	MCTimeCalcGoal6Update = 0;
 #endif
 
-	#ifdef MC_PROFILE
-	QueryPerformanceCounter(startCk);
-	#endif
-
-	long numPathsToProcess = 6;
-	//if (numPaths > 15)
-	//	numPathsToProcess = 10;
-	for (long i = 0; i < numPathsToProcess; i++) {
-		if (!queueFront)
+	//--------------------------------------------------------------------
+	// Calc as many queued paths as fit in this frame's budget, rather than
+	// a fixed count, so a burst of re-paths drains as fast as it can...
+	double startTime = gos_GetHiResTime();
+	double endTime = startTime + frameBudget / 1000.0;
+	numPathsLastFrame = 0;
+	while (queueFront) {
+		if ((numPathsLastFrame >= MIN_PATHS_PER_UPDATE) && (gos_GetHiResTime() >= endTime))
 			break;
-		calcPath();
+		numPathsLastFrame += calcPaths();
 	}
+	calcTimeLastFrame = (float)((gos_GetHiResTime() - startTime) * 1000.0);
 
 //	char s[50];
 //	sprintf(s, "num paths = %d", numPaths);
 //	DEBUGWINS_print(s, 0);
 
-	#ifdef MC_PROFILE
-	QueryPerformanceCounter(endCk);
-	srMvPathUpd += (endCk.LowPart - startCk.LowPart);
-	#endif
 }
 
 //***************************************************************************
@@ -22,6 +22,16 @@
 #endif
 
 //***************************************************************************
+// Requests are taken off the queue in batches. Each one's simple path search
+// is set up on the main thread, in its own MoveMap, then the searches all run
+// at once on the search threads. They are finished in queue order, so where
+// the searches ran doesn't change the outcome. Searches in a batch don't see
+// the path locks of paths found earlier in the same batch.
+
+#define	MOVE_PATH_BATCH				8				//Fixed, so the outcome doesn't depend on the core count.
+#define	MOVE_PATH_MAX_THREADS		4				//Search threads. The main thread searches too.
+
+struct MovePathWorkers;
 
 typedef struct _PathQueueRec* PathQueueRecPtr;
 
@@ -32,6 +42,7 @@ typedef struct _PathQueueRec {
 	unsigned long		moveParams;
 	bool				initPath;
 	bool				faceObject;
+	double				requestTime;		// when queued, for latency stats
 	PathQueueRecPtr		prev;
 	PathQueueRecPtr		next;
 } PathQueueRec;
@@ -46,9 +57,16 @@ class MovePathManager {
 		PathQueueRecPtr		queueFront;
 		PathQueueRecPtr		queueEnd;
 		PathQueueRecPtr		freeList;
-		static long			numPaths;
-		static long			peakPaths;
-		static long			sourceTally[50];
+		MovePathWorkers*	workers;			// batch maps and search threads
+		static long			numPaths;			// current queue depth
+		static long			peakPaths;			// peak queue depth this mission
+		static long			numPathsLastFrame;
+		static float		calcTimeLastFrame;	// in msecs
+		static float		avgLatency;			// request to calc, in secs
+		static float		maxLatency;
+		static float		frameBudget;		// msecs of path calcs per update
+		static long			numThreads;			// search threads, 0 = main thread only
+		static long			numPathsRedone;		// searched again after a path earlier in the batch locked their way
 
 	public:
 
@@ -74,7 +92,9 @@ class MovePathManager {
 
 		void request (MechWarriorPtr pilot, long selectionIndex, unsigned long moveParams, long source);
 
-		void calcPath (void);
+		long calcPaths (void);
+
+		void resetStats (void);
 
 		void update (void);
 };
@@ -4389,7 +4389,7 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 						  short* validAreas,
 						  unsigned long moveParams) {
 
-	__int64 startTime = 0;
+	GOS_PROFILE_ZONE("Mover::calcMoveGoal");
 
 	if (goalMapRowStart[0] == -1) {
 		for (long i = 0; i < GOALMAP_CELL_DIM; i++)
@@ -4515,8 +4515,8 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 		//---------------------------------------------------
 		// If we have a max move radius (i.e. guarding area),
 		// anything beyond our radius is bad...
-		startTime = GetCycles();
 		if (moveRadius > 0.0) {
+			GOS_PROFILE_STAT("Mover::calcMoveGoal radius",MCTimeCalcGoal2Update);
 			long moveCellRange = moveRadius / metersPerCell;
 			if (moveCellRange < 1)
 				moveCellRange = 1;
@@ -4531,9 +4531,6 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 					goalMap[goalMapRowStart[r] + c] -= 5000;
 			}
 		}
-#ifdef LAB_ONLY
-		MCTimeCalcGoal2Update += (GetCycles() - startTime);
-#endif
 		//---------------------------------------------------------------------------
 		// If the pilot has a set fire range, let's use it in determining how far out
 		// we would consider attacking. If we're ramming, fireCellrange will stay at
@@ -4665,7 +4662,7 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 	for (int i = 0; i < numValidAreas; i++)
 		validAreaTable[validAreas[i]] = 1;
 
-	startTime = GetCycles();
+	GOS_PROFILE_NAMED_STAT(goalZone,"Mover::calcMoveGoal terrain",MCTimeCalcGoal1Update);
 	long deepWaterWeight = ((moveLevel == 1) ? 0 : 999999);
 
 	//-----------------------------------------
@@ -4731,11 +4728,8 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 			else
 				goalMap[goalMapRowStart[r] + c] = -999999;
 		}
-#ifdef LAB_ONLY
-		MCTimeCalcGoal1Update += (GetCycles() - startTime);
-#endif
 
-	startTime = GetCycles();
+	GOS_PROFILE_NEXT_STAT(goalZone,"Mover::calcMoveGoal goal list",MCTimeCalcGoal3Update);
 	long goalList[MAX_MOVE_GOALS][2];
 	//------------------
 	// Setup the list...
@@ -4774,9 +4768,7 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 		}
 	}
 
-#ifdef LAB_ONLY
-	MCTimeCalcGoal3Update += (GetCycles() - startTime);
-#endif
+	goalZone.end();
 
 	//----------------------------------------------------------------------
 	// If we're attacking this target, let's use a selectionIndex based upon
@@ -4821,7 +4813,7 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 		long curMoverRow = cellPositionRow;
 		long curMoverCol = cellPositionCol;
 
-		startTime = GetCycles();
+		GOS_PROFILE_NAMED_STAT(lofZone,"Mover::calcMoveGoal LOF search",MCTimeCalcGoal5Update);
 		long i = 0;
 		ObjectManager->useMoverLineOfSightTable = false;
 		while (noLOF && (i < MaxMoveGoalChecks)) {
@@ -4842,7 +4834,7 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 				position = start;
 				cellPositionRow = curGoalCell[0];
 				cellPositionCol = curGoalCell[1];
-				__int64 lstartTime = GetCycles();
+				GOS_PROFILE_STAT("Mover::calcMoveGoal LOS",MCTimeCalcGoal4Update);
                 // sebi
 				//if (goalList[i][1] > -10000) {
 				if (weight > -10000) {
@@ -4853,14 +4845,9 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 					else
 						noLOF = !lineOfSight(moveGoal, false);
 				}
-#ifdef LAB_ONLY
-				MCTimeCalcGoal4Update += (GetCycles() - lstartTime);
-#endif
 			}
 		}
-#ifdef LAB_ONLY
-		MCTimeCalcGoal5Update += (GetCycles() - startTime);
-#endif
+		lofZone.end();
 		ObjectManager->useMoverLineOfSightTable = true;
 		position = curMoverPosition;
 		cellPositionRow = curMoverRow;
@@ -4869,7 +4856,7 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 
 	GameMap->clearCellDebugs(2);
 
-	startTime = GetCycles();
+	GOS_PROFILE_NEXT_STAT(goalZone,"Mover::calcMoveGoal fire position",MCTimeCalcGoal6Update);
 	if (noLOF && hasWeaponNode()) {
 		int targetPos[2], maxPos[2], bestCell[4][2];
 		float castRange;
@@ -4956,9 +4943,8 @@ long Mover::calcMoveGoal (GameObjectPtr target,
 		}
 	}
 	GameMap->setCellDebug(curGoalCell[0], curGoalCell[1], 3, 2);			
-#ifdef LAB_ONLY
-	MCTimeCalcGoal6Update += (GetCycles() - startTime);
-#endif	
+	goalZone.end();
+
 	//--------------------------------------------
 	// Let's calc the woorld coord of this cell...
 	land->cellToWorld(curGoalCell[0], curGoalCell[1], newGoal);
@@ -4993,69 +4979,10 @@ int Mover::calcMovePath (MovePathPtr path,
 	int result = 0;
 
 	if (pathType == MOVEPATH_SIMPLE) {
-		long mapULr = posCellR - SimpleMovePathRange;
-		if (mapULr < 0)
-			mapULr = 0;
-		long mapULc = posCellC - SimpleMovePathRange;
-		if (mapULc < 0)
-			mapULc = 0;
-
-		float cellLength = (Terrain::worldUnitsPerCell * metersPerWorldUnit);
-		long clearCost = 0;
-		if (maxMoveSpeed != 0.0)
-			clearCost = (float2short)(cellLength / maxMoveSpeed * 50.0);
-		if (clearCost > 0) {
-			long jumpCost = 0;
-			long numOffsets = 8;
-			if (!pilot->onHomeTeam() && !MPlayer)
-				getJumpRange(&numOffsets, &jumpCost);
-			#ifdef USE_ELEMENTALS
-			if (getObjectClass() == ELEMENTAL) {
-				GameObjectPtr target = pilot->getLastTarget();
-				if (target && (distanceFrom(target->getPosition()) < ElementalTargetNoJumpDistance)) {
-					jumpCost = 0;
-					numOffsets = 8;
-					}
-				else
-					JumpOnBlocked = true;
-			}
-			#endif
-			if (isMineSweeper())
-				moveParams |= MOVEPARAM_SWEEP_MINES;
-			if (followRoads)
-				moveParams |= MOVEPARAM_FOLLOW_ROADS;
-			if (isMech())
-				moveParams |= MOVEPARAM_WATER_SHALLOW;
-			if (moveLevel == 1)
-				moveParams |= (MOVEPARAM_WATER_SHALLOW + MOVEPARAM_WATER_DEEP);
-			PathFindMap[SIMPLE_PATHMAP]->setMover(getWatchID(), getTeamId(), isLayingMines());
-			PathFindMap[SIMPLE_PATHMAP]->setUp(mapULr,
-							   mapULc,
-							   SimpleMovePathRange * 2 + 1,
-							   SimpleMovePathRange * 2 + 1,
-							   moveLevel,
-							   &start,
-							   posCellR,
-							   posCellC,
-							   goal,
-							   goalCellR - mapULr,
-							   goalCellC - mapULc,
-							   clearCost,
-							   jumpCost,
-							   numOffsets,
-							   moveParams);
-
-			//---------------------
-			// Set up debug info...
-			DebugMovePathType = pathType;
-
+		if (setUpSimplePath(PathFindMap[SIMPLE_PATHMAP], path, start, goal, moveParams)) {
 			int goalCell[2];
-			if (numOffsets > 8)
-				result = PathFindMap[SIMPLE_PATHMAP]->calcPathJUMP(path, NULL, goalCell);
-			else
-				result = PathFindMap[SIMPLE_PATHMAP]->calcPath(path, NULL, goalCell);
+			result = PathFindMap[SIMPLE_PATHMAP]->search(path, NULL, goalCell);
 			PathFindMap[SIMPLE_PATHMAP]->setMover(0);
-			JumpOnBlocked = false;
 		}
 		}
 	else {
@@ -5105,6 +5032,8 @@ int Mover::calcMovePath (MovePathPtr path,
 				moveParams |= (MOVEPARAM_WATER_SHALLOW + MOVEPARAM_WATER_DEEP);
 			if (moveParams & MOVEPARAM_JUMP)
 				moveParams |= 0;
+			if (UseJumpPointSearch)
+				moveParams |= MOVEPARAM_JUMP_POINTS;
 			PathFindMap[SECTOR_PATHMAP]->setMover(getWatchID(), getTeamId(), isLayingMines());
 			PathFindMap[SECTOR_PATHMAP]->setUp(sectorULr,
 							   sectorULc,
@@ -5149,6 +5078,86 @@ int Mover::calcMovePath (MovePathPtr path,
 
 //---------------------------------------------------------------------------
 
+bool Mover::setUpSimplePath (MoveMapPtr map,
+							 MovePathPtr path,
+							 Stuff::Vector3D start,
+							 Stuff::Vector3D goal,
+							 unsigned long moveParams) {
+
+	int posCellR, posCellC;
+	land->worldToCell(start, posCellR, posCellC);
+
+	int goalCellR, goalCellC;
+	land->worldToCell(goal, goalCellR, goalCellC);
+
+	path->clear();
+
+	long mapULr = posCellR - SimpleMovePathRange;
+	if (mapULr < 0)
+		mapULr = 0;
+	long mapULc = posCellC - SimpleMovePathRange;
+	if (mapULc < 0)
+		mapULc = 0;
+
+	float cellLength = (Terrain::worldUnitsPerCell * metersPerWorldUnit);
+	long clearCost = 0;
+	if (maxMoveSpeed != 0.0)
+		clearCost = (float2short)(cellLength / maxMoveSpeed * 50.0);
+	if (clearCost <= 0)
+		return(false);
+
+	long jumpCost = 0;
+	long numOffsets = 8;
+	if (!pilot->onHomeTeam() && !MPlayer)
+		getJumpRange(&numOffsets, &jumpCost);
+	#ifdef USE_ELEMENTALS
+	if (getObjectClass() == ELEMENTAL) {
+		GameObjectPtr target = pilot->getLastTarget();
+		if (target && (distanceFrom(target->getPosition()) < ElementalTargetNoJumpDistance)) {
+			jumpCost = 0;
+			numOffsets = 8;
+			}
+		else
+			JumpOnBlocked = true;
+	}
+	#endif
+	if (isMineSweeper())
+		moveParams |= MOVEPARAM_SWEEP_MINES;
+	if (followRoads)
+		moveParams |= MOVEPARAM_FOLLOW_ROADS;
+	if (isMech())
+		moveParams |= MOVEPARAM_WATER_SHALLOW;
+	if (moveLevel == 1)
+		moveParams |= (MOVEPARAM_WATER_SHALLOW + MOVEPARAM_WATER_DEEP);
+	if (UseJumpPointSearch)
+		moveParams |= MOVEPARAM_JUMP_POINTS;
+	map->setMover(getWatchID(), getTeamId(), isLayingMines());
+	map->setUp(mapULr,
+			   mapULc,
+			   SimpleMovePathRange * 2 + 1,
+			   SimpleMovePathRange * 2 + 1,
+			   moveLevel,
+			   &start,
+			   posCellR,
+			   posCellC,
+			   goal,
+			   goalCellR - mapULr,
+			   goalCellC - mapULc,
+			   clearCost,
+			   jumpCost,
+			   numOffsets,
+			   moveParams);
+
+	//-------------------------------------------------------------------
+	// Set up debug info. setUp took its own copy of JumpOnBlocked, so it
+	// can be put back now instead of after the search...
+	DebugMovePathType = MOVEPATH_SIMPLE;
+	JumpOnBlocked = false;
+	return(true);
+}
+
+//---------------------------------------------------------------------------
+
 int Mover::calcEscapePath (MovePathPtr path,
 							Stuff::Vector3D start,
 							Stuff::Vector3D goal,
@@ -5270,6 +5279,22 @@ bool Mover::getAdjacentCellPathLocked (long level, long cellRow, long cellCol, l
 
 //---------------------------------------------------------------------------
 
+bool Mover::pathLocksCross (MovePathPtr path, long numSteps, long level) {
+
+	//----------------------------------------------------------------
+	// Does any of the first numSteps steps of path run thru a cell our
+	// path range has locked?
+	if (level != (moveLevel == 2))
+		return(false);
+	for (long i = 0; i < numSteps; i++)
+		for (long j = 0; j < pathLockLength; j++)
+			if ((path->stepList[i].cell[0] == pathLockList[j][0]) && (path->stepList[i].cell[1] == pathLockList[j][1]))
+				return(true);
+	return(false);
+}
+
+//---------------------------------------------------------------------------
+
 bool Mover::getPathRangeLock (long range, bool* reachedEnd) {
 
 	MovePathPtr path = pilot->getMovePath();
@@ -5476,6 +5501,8 @@ int Mover::calcMovePath (MovePathPtr path,
 			moveParams |= MOVEPARAM_WATER_SHALLOW;
 		if (moveLevel == 1)
 			moveParams |= (MOVEPARAM_WATER_SHALLOW + MOVEPARAM_WATER_DEEP);
+		if (UseJumpPointSearch)
+			moveParams |= MOVEPARAM_JUMP_POINTS;
 		PathFindMap[SECTOR_PATHMAP]->setMover(getWatchID(), getTeamId(), isLayingMines());
 		result = PathFindMap[SECTOR_PATHMAP]->setUp(
 									moveLevel,
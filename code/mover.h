@@ -1170,6 +1170,8 @@ class Mover : public GameObject {
 
 		virtual bool getPathRangeLock (long range, bool* reachedEnd = NULL);
 
+		bool pathLocksCross (MovePathPtr path, long numSteps, long level);
+
 		virtual long setPathRangeLock (bool set, long range = 0);
 
 		virtual bool getPathRangeBlocked (long range, bool* reachedEnd = NULL);
@@ -1478,6 +1480,16 @@ class Mover : public GameObject {
 								   int* goalCell,
 								   unsigned long moveParams = MOVEPARAM_NONE);
 
+		//------------------------------------------------------------------
+		// Sets map up for the MOVEPATH_SIMPLE search from start to goal and
+		// clears path. Returns false if there's nothing to search for (we
+		// can't move). map->search() may then be run on any thread.
+		virtual bool setUpSimplePath (MoveMapPtr map,
+									  MovePathPtr path,
+									  Stuff::Vector3D start,
+									  Stuff::Vector3D goal,
+									  unsigned long moveParams = MOVEPARAM_NONE);
+
 		virtual int calcEscapePath (MovePathPtr path,
 									 Stuff::Vector3D start,
 									 Stuff::Vector3D goal,
@@ -253,6 +253,8 @@ void GameObjectManager::init (void) {
 	numGoodMovers = 0;
 	numBadMovers = 0;
 	numMovers = 0;
+	moverGridIndex = NULL;
+	rebuildMoverGrid = true;
 	nextReinforcementPartId = MIN_REINFORCEMENT_PART_ID;
 	numRemoved = 0;
 	nextWatchID = 1;
@@ -1392,6 +1394,14 @@ void GameObjectManager::destroy (void)
 
 	systemHeap->Free(moverLineOfSightTable);
 	moverLineOfSightTable = NULL;
+
+	moverGrid.destroy();
+	if (moverGridIndex)
+	{
+		systemHeap->Free(moverGridIndex);
+		moverGridIndex = NULL;
+	}
+	rebuildMoverGrid = true;
 }
 
 //---------------------------------------------------------------------------
@@ -1643,8 +1653,6 @@ extern __int64 MCTimeTurretsTL;
 extern __int64 MCTimeAllElseUpdate;
 __int64 MCTimeCaptureListUpdate		= 0;
 extern __int64 MCTimeTransformandLight;
-extern __int64 MCTimeAnimationandMatrix;
-extern __int64 MCTimePerShapeTransform;
 
 unsigned long bldgCount = 0;
 #endif
@@ -1654,18 +1662,16 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 	//----------------------------
 	// Now, update game objects...
 	#ifdef LAB_ONLY
-	__int64 x;
-	x=GetCycles();
+	MCTimeCaptureListUpdate = MCTimeTerrainObjectsUpdate = 0;
+	MCTimeMechsUpdate = MCTimeVehiclesUpdate = 0;
+	MCTimeTurretsUpdate = MCTimeAllElseUpdate = 0;
 	#endif
+
+	GOS_PROFILE_NAMED_STAT(updateZone,"CaptureList Update",MCTimeCaptureListUpdate);
 	
 	updateCaptureList();
 	
-	#ifdef LAB_ONLY
-	x=GetCycles()-x;
-	MCTimeCaptureListUpdate = x;
-	
-	x=GetCycles(); 
-	#endif
+	GOS_PROFILE_NEXT_STAT(updateZone,"TerrainObject Update",MCTimeTerrainObjectsUpdate);
 	
  	if (terrain && renderObjects) 
 	{
@@ -1681,8 +1687,6 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 			{
 			#ifdef LAB_ONLY
 				bldgCount++;
-				MCTimeAnimationandMatrix =
-				MCTimePerShapeTransform =
 				MCTimeTransformandLight = 0;
 			#endif
 				if (!specialBuildings[spBuilding]->update()) 
@@ -1706,8 +1710,6 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 			{
 			#ifdef LAB_ONLY
 				bldgCount++;
-				MCTimeAnimationandMatrix =
-				MCTimePerShapeTransform =
 				MCTimeTransformandLight = 0;
 			#endif
 				if (!gates[nGates]->update()) 
@@ -1737,8 +1739,6 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 			#ifdef LAB_ONLY
 				bldgCount++;
 				
-				MCTimeAnimationandMatrix =
-				MCTimePerShapeTransform =
 				MCTimeTransformandLight = 0;
 			#endif
 						
@@ -1758,18 +1758,13 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 		}
 	}
 
-	#ifdef LAB_ONLY
-	x=GetCycles()-x;
-	MCTimeTerrainObjectsUpdate = x;
-	#endif
+	updateZone.end();
 	
  	if (movers) {
 		static MoverPtr removeList[MAX_MOVERS];
 		long numRemoved = 0;
 		
-		#ifdef LAB_ONLY
-		x=GetCycles();
-		#endif
+		GOS_PROFILE_NAMED_STAT(moverZone,"Mech Update",MCTimeMechsUpdate);
 		
 		if (mechs)
 		{
@@ -1779,8 +1774,6 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 				if (mover && mover->getExists()) 
 				{
 			#ifdef LAB_ONLY
-				MCTimeAnimationandMatrix =
-				MCTimePerShapeTransform =
 				MCTimeTransformandLight = 0;
 			#endif
 					if (!mover->update())
@@ -1794,12 +1787,7 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 			}
 		}
 
-		#ifdef LAB_ONLY
-		x=GetCycles()-x;
-		MCTimeMechsUpdate = x;
-		
-		x=GetCycles(); 
-		#endif
+		GOS_PROFILE_NEXT_STAT(moverZone,"Vehicle Update",MCTimeVehiclesUpdate);
 	
 		if (vehicles)
 		{
@@ -1809,8 +1797,6 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 				if (mover && mover->getExists()) 
 				{
 			#ifdef LAB_ONLY
-				MCTimeAnimationandMatrix =
-				MCTimePerShapeTransform =
 				MCTimeTransformandLight = 0;
 			#endif
 					if (!mover->update())
@@ -1824,22 +1810,20 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 			}
 		}
 			
-		#ifdef LAB_ONLY
-		x=GetCycles()-x;
-		MCTimeVehiclesUpdate = x;
-		#endif
+		moverZone.end();
 		
 		for (long i = 0; i < numRemoved; i++)
 			mission->removeMover(removeList[i]);
+
+		//-----------------------------------------------------------
+		// Everyone has moved.  Sensors scan against the new spots.
+		buildMoverGrid();
 	}
 
 	if (other) {
 		//---------------------------------------
 		// All other objects should be updated...
-		#ifdef LAB_ONLY
-		__int64 x;
-		x=GetCycles();
-		#endif
+		GOS_PROFILE_NAMED_STAT(otherZone,"Turret Update",MCTimeTurretsUpdate);
 	
 		if (turrets) 
 		{
@@ -1848,8 +1832,6 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 				if (turrets[i] && turrets[i]->getExists()) 
 				{
 			#ifdef LAB_ONLY
-				MCTimeAnimationandMatrix =
-				MCTimePerShapeTransform =
 				MCTimeTransformandLight = 0;
 			#endif
 					if (!turrets[i]->update())
@@ -1861,12 +1843,7 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 			}
 		}
 		
-		#ifdef LAB_ONLY
-		x=GetCycles()-x;
-		MCTimeTurretsUpdate = x;
-		
-		x=GetCycles(); 
-		#endif
+		GOS_PROFILE_NEXT_STAT(otherZone,"Everything else Update",MCTimeAllElseUpdate);
 		
 		if (weapons) {
 			for (long i=0;i<numWeapons;i++) {
@@ -1903,11 +1880,6 @@ void GameObjectManager::update (bool terrain, bool movers, bool other)
 				}
 			}
 		}
-		
-		#ifdef LAB_ONLY
-		x=GetCycles()-x;
-		MCTimeAllElseUpdate = x;
-		#endif
 	}
 }
 
@@ -1925,6 +1897,7 @@ GameObjectPtr GameObjectManager::get (GameObjectHandle handle) {
 
 long GameObjectManager::buildMoverLists (void) {
 
+	rebuildMoverGrid = true;
 	numMovers = 0;
 	numGoodMovers = 0;
 	numBadMovers = 0;
@@ -1956,8 +1929,98 @@ long GameObjectManager::buildMoverLists (void) {
 
 //---------------------------------------------------------------------------
 
+void GameObjectManager::buildMoverGrid (void) {
+
+	if (!moverGrid.isReady()) {
+		//------------------------------------------------------------
+		// Cover the whole map.  Anything off of it lands in the edge
+		// cells, which is fine since queries still check distance.
+		float mapSide = Terrain::worldUnitsMapSide;
+		if (moverGrid.init(Terrain::mapTopLeft3d.x, Terrain::mapTopLeft3d.y - mapSide, mapSide, mapSide, MOVER_GRID_CELL_SIZE, MAX_MOVERS) != NO_ERR)
+			Fatal(0, " GameObjectManager.buildMoverGrid: cannot init moverGrid ");
+	}
+
+	if (!moverGridIndex) {
+		moverGridIndex = (long*)systemHeap->Malloc(sizeof(long) * (maxMovers + 1));
+		if (!moverGridIndex)
+			Fatal(maxMovers, " GameObjectManager.buildMoverGrid: cannot malloc moverGridIndex ");
+	}
+
+	for (long i = 0; i <= maxMovers; i++)
+		moverGridIndex[i] = -1;
+
+	moverGrid.clear(numMovers);
+	for (long i = 0; i < numMovers; i++) {
+		MoverPtr mover = moverList[i];
+		if (!mover)
+			continue;
+		Stuff::Vector3D position = mover->getPosition();
+		moverGrid.setEntry(i, position.x, position.y);
+		long handle = mover->getHandle();
+		if ((handle > 0) && (handle <= maxMovers))
+			moverGridIndex[handle] = i;
+	}
+	moverGrid.build();
+
+	rebuildMoverGrid = false;
+}
+
+//---------------------------------------------------------------------------
+
+void GameObjectManager::markMoversInRange (Stuff::Vector3D position, float range, DWORD* moverMask) {
+
+	if (rebuildMoverGrid || !moverGrid.isReady())
+		buildMoverGrid();
+
+	moverGrid.markInRange(position.x, position.y, range + MOVER_GRID_SLACK, moverMask);
+}
+
+//---------------------------------------------------------------------------
+
+void GameObjectManager::markMover (MoverPtr mover, DWORD* moverMask) {
+
+	if (rebuildMoverGrid || !moverGridIndex)
+		buildMoverGrid();
+
+	long handle = mover->getHandle();
+	if ((handle < 1) || (handle > maxMovers))
+		return;
+
+	long index = moverGridIndex[handle];
+	if (index > -1)
+		moverMask[index >> 5] |= ((DWORD)1 << (index & 31));
+}
+
+//---------------------------------------------------------------------------
+
+long GameObjectManager::getMarkedMovers (DWORD* moverMask, MoverPtr* movers, long maxCount) {
+
+	if (rebuildMoverGrid || !moverGrid.isReady())
+		buildMoverGrid();
+
+	long indices[MAX_MOVERS];
+	long numFound = moverGrid.listMarked(moverMask, indices, (maxCount < MAX_MOVERS) ? maxCount : MAX_MOVERS);
+	for (long i = 0; i < numFound; i++)
+		movers[i] = moverList[indices[i]];
+
+	return(numFound);
+}
+
+//---------------------------------------------------------------------------
+
+long GameObjectManager::getMoversInRange (Stuff::Vector3D position, float range, MoverPtr* movers, long maxCount) {
+
+	DWORD moverMask[MOVER_MASK_WORDS];
+	memset(moverMask, 0, sizeof(moverMask));
+	markMoversInRange(position, range, moverMask);
+	return(getMarkedMovers(moverMask, movers, maxCount));
+}
+
+//---------------------------------------------------------------------------
+
 bool GameObjectManager::modifyMoverLists (MoverPtr mover, long action) {
 
+	rebuildMoverGrid = true;
 	switch (action) {
 		case MOVERLIST_DELETE: {
 			bool foundIt = false;
@@ -73,6 +73,10 @@
 #include"dcollsn.h"
 #endif
 
+#ifndef SPATIALGRID_H
+#include"spatialgrid.h"
+#endif
+
 class PacketFile;
 
 //---------------------------------------------------------------------------
@@ -81,6 +85,10 @@ class PacketFile;
 #define	MOVERLIST_ADD		1
 #define	MOVERLIST_TRADE		2
 
+#define	MOVER_GRID_CELL_SIZE	1280.0f			//World units, ten terrain vertices
+#define	MOVER_GRID_SLACK		256.0f			//World units added to every range query.  Covers movers which moved since the grid was built.
+#define	MOVER_MASK_WORDS		SPATIAL_GRID_MASK_WORDS(MAX_MOVERS)
+
 #define NO_RAM_FOR_TERRAIN_OBJECT_FILE		0xBAAA0014
 #define NO_RAM_FOR_TERRAIN_OBJECT_HEAP		0xBAAA0015
 #define NO_RAM_FOR_OBJECT_BLOCK_NUM			0xBAAA0016
@@ -232,6 +240,10 @@ class GameObjectManager {
 		char*					moverLineOfSightTable;
 		bool					useMoverLineOfSightTable;
 
+		SpatialGrid				moverGrid;						//moverList positions, rebuilt every update
+		long*					moverGridIndex;					//moverList index by mover handle, as of last moverGrid build
+		bool					rebuildMoverGrid;
+
 		GameObjectPtr*			objList;
 		GameObjectPtr*			collidableList;
 		MoverPtr				moverList[MAX_MOVERS];
@@ -505,6 +517,22 @@ class GameObjectManager {
 			return(badMoverList[index]);
 		}
 
+		void buildMoverGrid (void);
+
+		//---------------------------------------------------------------
+		// Range queries against moverGrid.  Ranges are in world units and
+		// flat (x and y only).  They may return a few movers just outside
+		// of range, never miss one inside, and always return movers in
+		// moverList order.  Masks have MOVER_MASK_WORDS words, one bit per
+		// moverList index.
+		long getMoversInRange (Stuff::Vector3D position, float range, MoverPtr* movers, long maxCount);
+
+		void markMoversInRange (Stuff::Vector3D position, float range, DWORD* moverMask);
+
+		void markMover (MoverPtr mover, DWORD* moverMask);
+
+		long getMarkedMovers (DWORD* moverMask, MoverPtr* movers, long maxCount);
+
 		GameObjectPtr findObject (Stuff::Vector3D position);
 
 		GameObjectPtr findByPartId (long partId);
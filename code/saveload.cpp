@@ -1463,6 +1463,9 @@ void Mission::load (const char *loadFileName)
 
 	Mover::initOptimalCells(32);
 
+	GameMap->buildLOSHeights();
+	GameMap->buildMoveClasses();
+
 	if (CombatLog)
 		MechWarrior::logPilots(CombatLog);
 
@@ -86,6 +86,7 @@ long			Team::numTeams = 0;
 TeamPtr			Team::home = NULL;
 TeamPtr			Team::teams[MAX_TEAMS] = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
 SortListPtr		Team::sortList = NULL;
+bool			Team::useLOSHeights = true;
 
 bool			useRealLOS = true;
 #ifdef LAB_ONLY
@@ -878,9 +879,7 @@ extern __int64 MCTimeLOSCalc;
 //---------------------------------------------------------------------------
 bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, long tCellRow, long tCellCol, long teamId, float extRad, bool checkVisibleBits)
 {
-	#ifdef LAB_ONLY
-	__int64 x=GetCycles();
-	#endif
+	GOS_PROFILE_STAT("Team::lineOfSight",MCTimeLOSCalc);
 	
 	//-----------------------------------------------------
 	// Once we allow teams to have alliances (for contacts,
@@ -929,10 +928,6 @@ bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, long tCe
 
 		if (!losResult)
 		{
-	#ifdef LAB_ONLY
-	x=GetCycles()-x;
-	MCTimeLOSCalc += x;
-	#endif
 			return losResult;
 		}
 	}
@@ -1014,10 +1009,6 @@ bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, long tCe
 				
 				if (startHeight+startLocal < currentPos.z)
 				{
-	#ifdef LAB_ONLY
-	x=GetCycles()-x;
-	MCTimeLOSCalc += x;
-	#endif
 #ifdef LAB_ONLY
 		if (drawTerrainGrid)
 		{
@@ -1055,24 +1046,18 @@ bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, long tCe
 #endif
 	}
 	
-	#ifdef LAB_ONLY
-	x=GetCycles()-x;
-	MCTimeLOSCalc += x;
-	#endif
-	
 	return true;
 }
 
 #else
 
 #define ACCURACY_ADJUST		1.5f
+#define LOS_SKIP_EXTENT		1.25f		//GetApproximateLength can be a few percent short
 const float HALF_CELL_DIST	= (128.0f / 6.0f);
 //---------------------------------------------------------------------------
 bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, float endLocal, long tCellRow, long tCellCol, long teamId, float extRad, float startExtRad, bool checkVisibleBits)
 {
-	#ifdef LAB_ONLY
-	__int64 x=GetCycles();
-	#endif
+	GOS_PROFILE_STAT("Team::lineOfSight",MCTimeLOSCalc);
 	
 	//-----------------------------------------------------
 	// Once we allow teams to have alliances (for contacts,
@@ -1122,10 +1107,6 @@ bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, float en
 
 		if (!losResult)
 		{
-	#ifdef LAB_ONLY
-	x=GetCycles()-x;
-	MCTimeLOSCalc += x;
-	#endif
 			return losResult;
 		}
 	}
@@ -1162,20 +1143,50 @@ bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, float en
 			float rowLength = (endPos.y - startPos.y) / length;
 			float heightLen = (endPos.z - startPos.z) / (length + ACCURACY_ADJUST);
 			
+			//--------------------------------------------------------------
+			// currentPos.z is only looked up for steps which need it.  When
+			// the line is above GameMap's LOS height for a cell, nothing in
+			// the step can block it and the step is skipped.  The end check
+			// still has to be able to stop us there, so skipping is only
+			// done well outside of extRad.
 			Stuff::Vector3D currentPos = startPos;
-			currentPos.z = land->getTerrainElevation(currentPos);
+			bool needElevation = true;
+			bool skipCells = useLOSHeights && GameMap;
 			long maxDistIter = (length - 0.5f);
 			long maxTrees = 0;
 
 			Stuff::Vector3D dist;
-			dist.Subtract(endPos,currentPos);
-			
-			float remainingDist = dist.GetApproximateLength();
+			float remainingDist = 0.0f;
 			bool checkExtent = (extRad > Stuff::SMALL);
 			bool checkStart = (startExtRad > Stuff::SMALL);
 			extRad += HALF_CELL_DIST;
+			float skipExtentSquared = (extRad * LOS_SKIP_EXTENT) * (extRad * LOS_SKIP_EXTENT);
 			for (long distIter = 0;distIter < maxDistIter;distIter++)
 			{
+				startHeight += heightLen;
+
+				int curCellRow, curCellCol;
+				land->worldToCell(currentPos,curCellRow, curCellCol);
+
+				if (skipCells && GameMap->isAboveLOSHeight(curCellRow, curCellCol, startHeight))
+				{
+					float endX = endPos.x - currentPos.x;
+					float endY = endPos.y - currentPos.y;
+					if (!checkExtent || ((endX * endX + endY * endY) > skipExtentSquared))
+					{
+						currentPos.x += colLength;
+						currentPos.y += rowLength;
+						needElevation = true;
+						continue;
+					}
+				}
+
+				if (needElevation)
+				{
+					currentPos.z = land->getTerrainElevation(currentPos);
+					needElevation = false;
+				}
+
 				bool outsideStartRadius = true;
 				if (checkStart)
 				{
@@ -1187,11 +1198,6 @@ bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, float en
 						outsideStartRadius = false;
 				}
 
-				startHeight += heightLen;
-
-				int curCellRow, curCellCol;
-				land->worldToCell(currentPos,curCellRow, curCellCol);
-
 				float localElev = (worldUnitsPerMeter * 4.0f * (float)GameMap->getLocalHeight(curCellRow,curCellCol)); 
 				float thisHeight = currentPos.z + localElev;
 
@@ -1216,11 +1222,6 @@ bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, float en
 
 					if (!isTree || (maxTrees >= MaxTreeLOSCellBlock))
 					{
-#ifdef LAB_ONLY
-						x=GetCycles()-x;
-						MCTimeLOSCalc += x;
-#endif
-		
 #ifdef LAB_ONLY
 						if (drawTerrainGrid)
 						{
@@ -1238,7 +1239,7 @@ bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, float en
 
 				currentPos.x += colLength;
 				currentPos.y += rowLength;
-				currentPos.z = land->getTerrainElevation(currentPos);
+				needElevation = true;
 			}
 		}
 
@@ -1255,11 +1256,6 @@ bool Team::lineOfSight (float startLocal, long mCellRow, long mCellCol, float en
 #endif
 	}
 	
-	#ifdef LAB_ONLY
-	x=GetCycles()-x;
-	MCTimeLOSCalc += x;
-	#endif
-	
 	return true;
 }
 #endif
@@ -1281,6 +1277,67 @@ bool Team::lineOfSight (Stuff::Vector3D position, Stuff::Vector3D targetPosition
 	return(lineOfSight(localStart,posCellR, posCellC, localEnd, tarCellR, tarCellC,teamId,extRad, startExtRad, checkVisibleBits));
 }
 
+//---------------------------------------------------------------------------
+long Team::checkLOSHeights (long numRays)
+{
+	if (!GameMap || !land || !useRealLOS || (numRays < 1))
+		return(0);
+
+	//------------------------------------------------------------------
+	// Own generator so the game's random numbers are left alone.  Rays
+	// are about as long as the longest visual range and start and end
+	// at heights movers and buildings look from.
+	unsigned long seed = 0x4C4F5321;
+	#define LOS_CHECK_RAND(range)	((seed = seed * 1664525 + 1013904223), (long)((seed >> 8) % (range)))
+
+	long maxReach = 150;
+	long numMismatches = 0;
+	double heightsTime = 0.0;
+	double fullTime = 0.0;
+	bool oldUseLOSHeights = useLOSHeights;
+	for (long i = 0; i < numRays; i++)
+	{
+		long mRow = LOS_CHECK_RAND(GameMap->height);
+		long mCol = LOS_CHECK_RAND(GameMap->width);
+		long tRow = mRow + LOS_CHECK_RAND(maxReach * 2 + 1) - maxReach;
+		long tCol = mCol + LOS_CHECK_RAND(maxReach * 2 + 1) - maxReach;
+		if (tRow < 0)
+			tRow = 0;
+		if (tRow >= GameMap->height)
+			tRow = GameMap->height - 1;
+		if (tCol < 0)
+			tCol = 0;
+		if (tCol >= GameMap->width)
+			tCol = GameMap->width - 1;
+
+		float startLocal = (float)LOS_CHECK_RAND(120);
+		float endLocal = (float)LOS_CHECK_RAND(120);
+		float extRad = (LOS_CHECK_RAND(2) ? (float)LOS_CHECK_RAND(80) : 0.0f);
+		float startExtRad = (LOS_CHECK_RAND(4) ? 0.0f : (float)LOS_CHECK_RAND(80));
+
+		double start = gos_GetHiResTime();
+		useLOSHeights = true;
+		bool heightsResult = lineOfSight(startLocal, mRow, mCol, endLocal, tRow, tCol, 0, extRad, startExtRad, false);
+		double middle = gos_GetHiResTime();
+		useLOSHeights = false;
+		bool fullResult = lineOfSight(startLocal, mRow, mCol, endLocal, tRow, tCol, 0, extRad, startExtRad, false);
+		double end = gos_GetHiResTime();
+
+		heightsTime += (middle - start);
+		fullTime += (end - middle);
+		if (heightsResult != fullResult)
+		{
+			numMismatches++;
+			SPEWALWAYS(("LOS", "LOS heights mismatch: %d,%d (%f) -> %d,%d (%f) ext %f start %f: %d, should be %d\n", mRow, mCol, startLocal, tRow, tCol, endLocal, extRad, startExtRad, heightsResult, fullResult));
+		}
+	}
+	useLOSHeights = oldUseLOSHeights;
+	#undef LOS_CHECK_RAND
+
+	SPEWALWAYS(("LOS", "LOS heights check: %d rays, %d mismatches, %f sec with heights, %f sec without\n", numRays, numMismatches, heightsTime, fullTime));
+	return(numMismatches);
+}
+
 //***************************************************************************
 
 void disableHomeTeamTargets (void) {
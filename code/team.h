@@ -82,6 +82,7 @@ class Team {
 		static SortListPtr	sortList;
 		static char			relations[MAX_TEAMS][MAX_TEAMS];
 		static bool			noPain[MAX_TEAMS];
+		static bool			useLOSHeights;						//Let lineOfSight skip cells using GameMap's LOS heights
 
 	public:
 
@@ -150,6 +151,10 @@ class Team {
 
 		static bool lineOfSight (Stuff::Vector3D myPos, Stuff::Vector3D targetPosition, long teamId, float targetRadius, float startRadius = 0.0f, bool checkVisibleBits = true);
 
+		//Fires random lines of sight over the current map with and without LOS heights.
+		//Returns how many came out different.
+		static long checkLOSHeights (long numRays);
+
 		//-------------------------------------------		
 		// Can anyone on my team see this position?
 		// Used for cursors, artillery, indirect fire.
@@ -2153,9 +2153,7 @@ long MechWarrior::runBrain (void) {
 	brain->getInfo(&moduleInfo);
 
 	brain->execute();
-#ifdef LAB_ONLY
-	__int64 startTime = GetCycles();
-#endif
+	GOS_PROFILE_NAMED_STAT(goalPlanZone,"MechWarrior::runBrain goal plan",MCTimeRunBrainUpdate);
 	//--------------------------------------------------------------
 	// Well, we'll just set it every frame so it doesn't screw up :)
 	setUseGoalPlan(!MPlayer && (getCommander() != Commander::home));
@@ -2176,9 +2174,7 @@ long MechWarrior::runBrain (void) {
 			clearCurTacOrder();
 		}
 	}
-#ifdef LAB_ONLY
-	MCTimeRunBrainUpdate += (GetCycles() - startTime);
-#endif
+	goalPlanZone.end();
 
 	CurGroup = NULL;
 	CurObject = NULL;
@@ -2751,7 +2747,11 @@ extern __int64 MCTimePath3Update;
 extern __int64 MCTimePath4Update;
 extern __int64 MCTimePath5Update;
 #endif
-long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
+long MechWarrior::startMovePath (MovePathCalcPtr calc, long selectionIndex, unsigned long moveParams) {
+
+	calc->finish = false;
+	calc->search = false;
+	calc->numSteps = 0;
 
  	MoverPtr myVehicle = getVehicle();
 	bool flying = (myVehicle->getMoveLevel() > 0);
@@ -2858,7 +2858,11 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 			pathNum = 1;
 	}
 
-	__int64 startTime = 0;
+	GOS_PROFILE_ZONE("MechWarrior::startMovePath");
+	int goalCellR = -1, goalCellC = -1;
+	bool doQuickMove = false;
+	bool startAreaOpen = false;
+	calc->newPath = (moveOrders.pathType == MOVEPATH_UNDEFINED);
 	//----------------------------------------------------------------------
 	// Before we do anything else, check if we already have a global path...
 	if (moveOrders.pathType == MOVEPATH_UNDEFINED/*numGlobalSteps == 0*/) {
@@ -2869,14 +2873,12 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 			long result = NO_ERR;
 			if ((myVehicle->getCommander() == Commander::home) && (curTacOrder.code != TACTICAL_ORDER_NONE) && (curTacOrder.origin == ORDER_ORIGIN_PLAYER))
 				moveParams |= MOVEPARAM_PLAYER;
-			startTime = GetCycles();
+			GOS_PROFILE_NAMED_STAT(goalZone,"MechWarrior::calcMovePath move goal",MCTimePath1Update);
 			if (myVehicle->moveRadius > 0.0)
 				result = myVehicle->calcMoveGoal(target, myVehicle->moveCenter, myVehicle->moveRadius, goal, selectionIndex, goal, lastGoalPathSize, lastGoalPath, moveParams);
 			else
 				result = myVehicle->calcMoveGoal(target, goal, -1.0, goal, selectionIndex, goal, lastGoalPathSize, lastGoalPath, moveParams);
-#ifdef LAB_ONLY
-			MCTimePath1Update += (GetCycles() - startTime);
-#endif
+			goalZone.end();
 			if (result != NO_ERR) {
 				LastMoveCalcErr = MOVEPATH_ERR_NO_VALID_GOAL;
 				triggerAlarm(PILOT_ALARM_NO_MOVEPATH, LastMoveCalcErr);
@@ -2960,10 +2962,8 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 		// don't do any global pathfinding--do it all on one movemap. In other words,
 		// make it a "simple" path. Also, if we're starting on a blocked tile (burnt
 		// forest tile, for example), we'll want to do a quickmove, as well...
-		int goalCellR, goalCellC;
 		land->worldToCell(goal, goalCellR, goalCellC);
 
-		bool doQuickMove = false;
 		long rowDiff = goalCellR - posCellR;
 		if (rowDiff < 0)
 			rowDiff *= -1;
@@ -2975,31 +2975,101 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 				doQuickMove = true;
 		}
 
-		bool startAreaOpen = (startArea >= 0) && (GlobalMoveMap[myVehicle->getMoveLevel()]->areas[startArea].open || GlobalMoveMap[myVehicle->getMoveLevel()]->areas[startArea].offMap);
+		startAreaOpen = (startArea >= 0) && (GlobalMoveMap[myVehicle->getMoveLevel()]->areas[startArea].open || GlobalMoveMap[myVehicle->getMoveLevel()]->areas[startArea].offMap);
 
 		if (doQuickMove) {
 			moveOrders.pathType = MOVEPATH_SIMPLE;
 
-			myVehicle->updatePathLock(false);
-			if ((curTacOrder.code == TACTICAL_ORDER_ATTACK_OBJECT) && (curTacOrder.attackParams.method == ATTACKMETHOD_RAMMING))
-				RamObjectWID = curTacOrder.targetWID;
-			else
-				RamObjectWID = 0;
-			GameObjectPtr ramObject = ObjectManager->getByWatchID(RamObjectWID);
-			if (ramObject && ramObject->isMover())
-				((MoverPtr)ramObject)->updatePathLock(false);
 			if (myVehicle->getObjectClass() != ELEMENTAL)
 				moveParams |= MOVEPARAM_AVOID_PATHLOCKS;
-			startTime = GetCycles();
-			long numSteps = myVehicle->calcMovePath(moveOrders.path[pathNum], MOVEPATH_SIMPLE, start, goal, NULL, moveParams | MOVEPARAM_STATIONARY_MOVERS);
-#ifdef LAB_ONLY
-			MCTimePath2Update += (GetCycles() - startTime);
-#endif
-			if (ramObject && ramObject->isMover())
-				((MoverPtr)ramObject)->updatePathLock(true);
+			calc->start = start;
+			calc->goal = goal;
+			calc->moveParams = moveParams;
+			setUpSimpleMovePath(calc);
+		}
+		}
+	else if (moveOrders.pathType == MOVEPATH_COMPLEX) {
+		moveOrders.curGlobalStep++;
+	}
+
+	//-----------------------------------------------------------------------
+	// The rest is up to finishMovePath, once whoever called us has run the
+	// search we set up (if we did)...
+	calc->selectionIndex = selectionIndex;
+	calc->moveParams = moveParams;
+	calc->pathNum = pathNum;
+	calc->start = start;
+	calc->goal = goal;
+	calc->target = target;
+	calc->yielding = yielding;
+	calc->startArea = startArea;
+	calc->startAreaOpen = startAreaOpen;
+	calc->posCell[0] = posCellR;
+	calc->posCell[1] = posCellC;
+	calc->goalCell[0] = goalCellR;
+	calc->goalCell[1] = goalCellC;
+	calc->quickMove = doQuickMove;
+	calc->finish = true;
+	return(NO_ERR);
+}
+
+//---------------------------------------------------------------------------
+
+void MechWarrior::setUpSimpleMovePath (MovePathCalcPtr calc) {
+
+	//------------------------------------------------------------------
+	// Our own pathlocks, and those of whatever we're ramming, are lifted
+	// while the map is set up, so we don't try to route around them...
+	MoverPtr myVehicle = getVehicle();
+	calc->numSteps = 0;
+	myVehicle->updatePathLock(false);
+	if ((curTacOrder.code == TACTICAL_ORDER_ATTACK_OBJECT) && (curTacOrder.attackParams.method == ATTACKMETHOD_RAMMING))
+		RamObjectWID = curTacOrder.targetWID;
+	else
+		RamObjectWID = 0;
+	GameObjectPtr ramObject = ObjectManager->getByWatchID(RamObjectWID);
+	if (ramObject && ramObject->isMover())
+		((MoverPtr)ramObject)->updatePathLock(false);
+	GOS_PROFILE_NAMED_STAT(simpleZone,"MechWarrior::calcMovePath simple path setUp",MCTimePath2Update);
+	calc->search = myVehicle->setUpSimplePath(calc->map, calc->path, calc->start, calc->goal, calc->moveParams | MOVEPARAM_STATIONARY_MOVERS);
+	simpleZone.end();
+	if (ramObject && ramObject->isMover())
+		((MoverPtr)ramObject)->updatePathLock(true);
+	myVehicle->updatePathLock(true);
+	RamObjectWID = 0;
+}
+
+//---------------------------------------------------------------------------
+
+long MechWarrior::finishMovePath (MovePathCalcPtr calc) {
+
+	MoverPtr myVehicle = getVehicle();
+	long selectionIndex = calc->selectionIndex;
+	unsigned long moveParams = calc->moveParams;
+	long pathNum = calc->pathNum;
+	Stuff::Vector3D start = calc->start;
+	Stuff::Vector3D goal = calc->goal;
+	GameObjectPtr target = calc->target;
+	bool yielding = calc->yielding;
+	long startArea = calc->startArea;
+	bool startAreaOpen = calc->startAreaOpen;
+	int posCellR = calc->posCell[0];
+	int posCellC = calc->posCell[1];
+	int goalCellR = calc->goalCell[0];
+	int goalCellC = calc->goalCell[1];
+	bool doQuickMove = calc->quickMove;
+
+	GOS_PROFILE_ZONE("MechWarrior::finishMovePath");
+	if (calc->newPath) {
+		if (doQuickMove) {
+			//------------------------------------------------------------------
+			// Swap the new path in, taking the old one's locks off first, just
+			// as if it had been calced right here...
+			myVehicle->updatePathLock(false);
+			*moveOrders.path[pathNum] = *calc->path;
 			myVehicle->updatePathLock(true);
-			RamObjectWID = 0;
 
+			long numSteps = calc->numSteps;
 			bool foundPath = (numSteps > 0);
 			if ((numSteps > 0) && (selectionIndex > 0)) {
 				//---------------------------------------------
@@ -3069,7 +3139,7 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 						GlobalMoveMap[myVehicle->getMoveLevel()]->useClosedAreas = true;
 
 				GlobalMoveMap[myVehicle->getMoveLevel()]->moverTeamID = myVehicle->getTeamId();
-				startTime = GetCycles();
+				GOS_PROFILE_NAMED_STAT(globalZone,"MechWarrior::calcMovePath global path",MCTimePath3Update);
 				if (GlobalMap::logEnabled) {
 					static char s[256];
 					sprintf(s, "[%.2f] calcPath: [%05d]%s", scenarioTime, myVehicle->getPartId(), myVehicle->getName());
@@ -3082,9 +3152,7 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 																			  posCellC,
 																			  goalCellR,
 																			  goalCellC);
-#ifdef LAB_ONLY
-				MCTimePath3Update += (GetCycles() - startTime);
-#endif
+				globalZone.end();
 				GlobalMoveMap[myVehicle->getMoveLevel()]->useClosedAreas = false;
 			}
 			if (numSteps == -1) {
@@ -3127,9 +3195,6 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 			moveOrders.curGlobalStep = 0;
 		}
 		}
-	else if (moveOrders.pathType == MOVEPATH_COMPLEX) {
-		moveOrders.curGlobalStep++;
-	}
 
 	if (moveOrders.pathType == MOVEPATH_COMPLEX) {
 		long curGlobalStep = moveOrders.curGlobalStep;
@@ -3182,7 +3247,7 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 				((MoverPtr)ramObject)->updatePathLock(false);
 			if (myVehicle->getObjectClass() != ELEMENTAL)
 				moveParams |= MOVEPARAM_AVOID_PATHLOCKS;
-			startTime = GetCycles();
+			GOS_PROFILE_NAMED_STAT(areaZone,"MechWarrior::calcMovePath area path",MCTimePath4Update);
 			long thruArea[2] = {-1, -1};
 			long goalDoor = -1;
 			if (curGlobalStep == (numGlobalSteps - 2)) {
@@ -3197,9 +3262,7 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 			}
 			numSteps = myVehicle->calcMovePath(
                     moveOrders.path[pathNum], start, thruArea, goalDoor, moveOrders.globalGoalLocation, &goal, globalStep->goalCell, moveParams | MOVEPARAM_STATIONARY_MOVERS);
-#ifdef LAB_ONLY
-			MCTimePath4Update += (GetCycles() - startTime);
-#endif
+			areaZone.end();
 			if (ramObject && ramObject->isMover())
 				((MoverPtr)ramObject)->updatePathLock(true);
 			myVehicle->updatePathLock(true);
@@ -3218,11 +3281,9 @@ long MechWarrior::calcMovePath (long selectionIndex, unsigned long moveParams) {
 				((MoverPtr)ramObject)->updatePathLock(false);
 			if (myVehicle->getObjectClass() != ELEMENTAL)
 				moveParams |= MOVEPARAM_AVOID_PATHLOCKS;
-			startTime = GetCycles();
+			GOS_PROFILE_NAMED_STAT(complexZone,"MechWarrior::calcMovePath complex path",MCTimePath5Update);
 			numSteps = myVehicle->calcMovePath(moveOrders.path[pathNum], MOVEPATH_COMPLEX, start, goal, globalStep->goalCell, moveParams | MOVEPARAM_STATIONARY_MOVERS);
-#ifdef LAB_ONLY
-			MCTimePath5Update += (GetCycles() - startTime);
-#endif
+			complexZone.end();
 			if (ramObject && ramObject->isMover())
 				((MoverPtr)ramObject)->updatePathLock(true);
 			myVehicle->updatePathLock(true);
@@ -8054,11 +8115,12 @@ long MechWarrior::calcTacOrder (long goalAction,
 			if (noTargetSelected) {
 				//---------------------------------------------------------
 				// Let's look at any enemy movers within our control range.
-				long numMovers = ObjectManager->getNumMovers();
+				MoverPtr nearbyMovers[MAX_MOVERS];
+				long numMovers = ObjectManager->getMoversInRange(mainTarget->getPosition(), controlRadius / metersPerWorldUnit, nearbyMovers, MAX_MOVERS);
 				MoverPtr biggestMoverThreat = NULL;
 				long biggestThreatRating = 0;
 				for (long i = 0; i < numMovers; i++) {
-					MoverPtr mover = ObjectManager->getMover(i);
+					MoverPtr mover = nearbyMovers[i];
 					if (getVehicle()->isEnemy(mover->getTeam()))
 						if (!mover->isDisabled())
 							if (mainTarget/*getVehicle()*/->distanceFrom(mover->getPosition()) <= controlRadius)
@@ -465,6 +465,33 @@ typedef struct _MoveOrders {
 
 } MoveOrders;
 
+//---------------------------------------------------------------------------
+// Everything startMovePath has worked out that finishMovePath needs, and
+// the simple path search between them...
+
+typedef struct _MovePathCalc {
+	long						selectionIndex;
+	unsigned long				moveParams;
+	long						pathNum;				// 0 = current path, 1 = next path
+	Stuff::Vector3D				start;
+	Stuff::Vector3D				goal;
+	GameObjectPtr				target;
+	bool						yielding;
+	long						startArea;
+	bool						startAreaOpen;
+	int							posCell[2];
+	int							goalCell[2];
+	bool						newPath;				// pathType was MOVEPATH_UNDEFINED
+	bool						quickMove;				// went for a simple path
+	bool						finish;					// finishMovePath has work left
+	bool						search;					// map is set up and needs searching
+	MoveMapPtr					map;
+	MovePathPtr					path;					// where the search puts the path
+	long						numSteps;				// what the search returned
+} MovePathCalc;
+
+typedef MovePathCalc* MovePathCalcPtr;
+
 typedef struct _SaveableMoveOrders {
 	//------------------
 	// order  parameters
@@ -1690,7 +1717,19 @@ class MechWarrior {
 
 		void requestMovePath (long selectionIndex, unsigned long moveParams, long source);
 
-		long calcMovePath (long selectionIndex, unsigned long moveParams = MOVEPARAM_NONE);
+		//-----------------------------------------------------------------
+		// A move path is calced in two halves. startMovePath sets up the
+		// simple path search, if there is one, in calc->map. Once the path
+		// manager has run it, finishMovePath takes the path from calc->path.
+		long startMovePath (MovePathCalcPtr calc, long selectionIndex, unsigned long moveParams = MOVEPARAM_NONE);
+
+		//-----------------------------------------------------------------
+		// Sets the simple path search up in calc->map from calc's start,
+		// goal and moveParams.  Also used to set it up again when the map
+		// has changed since startMovePath.
+		void setUpSimpleMovePath (MovePathCalcPtr calc);
+
+		long finishMovePath (MovePathCalcPtr calc);
 
 		long calcMoveSpeedState (void) {
 			//-------------------------------------------------
@@ -33,8 +33,17 @@ Weather *weather = NULL;
 // Class Weather
 void Weather::destroy (void)
 {
-	systemHeap->Free(rainDrops);
-	rainDrops = NULL;
+	if (rainDropX)
+		systemHeap->Free(rainDropX);
+	rainDropX = NULL;
+	
+	if (rainLanes.px)
+		systemHeap->Free(rainLanes.px);
+	rainLanes.px = NULL;
+	
+	if (rainVertices)
+		systemHeap->Free(rainVertices);
+	rainVertices = NULL;
 	
 	init();
 }
@@ -159,11 +168,20 @@ void Weather::init (DWORD maxDrops, float startingRain, float brChance, float lt
 	
 	if (maxDrops)
 	{
-		rainDrops = (RainDrops *)systemHeap->Malloc(sizeof(RainDrops) * maxDrops);
-		gosASSERT(rainDrops != NULL);
+		rainDropX = (float *)systemHeap->Malloc(sizeof(float) * maxDrops * 4);
+		gosASSERT(rainDropX != NULL);
+		memset(rainDropX,0,sizeof(float) * maxDrops * 4);
+		
+		rainDropY = rainDropX + maxDrops;
+		rainDropZ = rainDropY + maxDrops;
+		rainDropLength = rainDropZ + maxDrops;
 		
-		for (long i=0;i<totalRainDrops;i++)
-			rainDrops[i].init();
+		void *laneMemory = systemHeap->Malloc(TG_VertexLanesSize(maxDrops * 2));
+		gosASSERT(laneMemory != NULL);
+		TG_SetVertexLanes(rainLanes,laneMemory,maxDrops * 2);
+		
+		rainVertices = (gos_VERTEX *)systemHeap->Malloc(sizeof(gos_VERTEX) * maxDrops * 2);
+		gosASSERT(rainVertices != NULL);
 	}
 	else
 	{
@@ -188,6 +206,21 @@ void Weather::init (DWORD maxDrops, float startingRain, float brChance, float lt
 	oldFog = -1.0f;
 }
 		
+//----------------------------------------------------------------------------------
+void Weather::placeRainDrop (long drop, Stuff::Vector3D &startPos)
+{
+	Stuff::Vector3D positionOffset;
+	positionOffset.x = RandomNumber(BASE_RAIN_RANDOM_POS_FACTOR * 2) - BASE_RAIN_RANDOM_POS_FACTOR;
+	positionOffset.y = RandomNumber(BASE_RAIN_RANDOM_POS_FACTOR * 2) - BASE_RAIN_RANDOM_POS_FACTOR;
+	positionOffset.z = RandomNumber(BASE_RAIN_RANDOM_HGT_FACTOR * 2) - BASE_RAIN_RANDOM_HGT_FACTOR;
+	
+	rainDropX[drop] = startPos.x + positionOffset.x;
+	rainDropY[drop] = startPos.y + positionOffset.y;
+	rainDropZ[drop] = startPos.z + positionOffset.z;
+	
+	rainDropLength[drop] = BASE_RAIN_LENGTH + RandomNumber(BASE_RAIN_RANDOM_LEN_FACTOR * 2) - BASE_RAIN_RANDOM_LEN_FACTOR; 
+}
+
 //----------------------------------------------------------------------------------
 void Weather::update (void)
 {
@@ -399,39 +432,23 @@ void Weather::update (void)
 				//----------------------------------------------
 				// Must put the new raindrops into service.
 				for (long i=currentRainDrops;i<newRainDrops;i++)
-				{
-					Stuff::Vector3D positionOffset;
-					positionOffset.x = RandomNumber(BASE_RAIN_RANDOM_POS_FACTOR * 2) - BASE_RAIN_RANDOM_POS_FACTOR;
-					positionOffset.y = RandomNumber(BASE_RAIN_RANDOM_POS_FACTOR * 2) - BASE_RAIN_RANDOM_POS_FACTOR;
-					positionOffset.z = RandomNumber(BASE_RAIN_RANDOM_HGT_FACTOR * 2) - BASE_RAIN_RANDOM_HGT_FACTOR;
-				
-					rainDrops[i].position.Add(startPos,positionOffset);
-					
-					rainDrops[i].length = BASE_RAIN_LENGTH + RandomNumber(BASE_RAIN_RANDOM_LEN_FACTOR * 2) - BASE_RAIN_RANDOM_LEN_FACTOR; 
-				}
+					placeRainDrop(i,startPos);
 			}
 			
 			currentRainDrops = newRainDrops;
 		}
 		
+		//-----------------------------------------------
+		//Update the position.  Move rain toward ground.
+		float rainFall = BASE_RAIN_VEL * frameLength * rainLevel;
 		for (long i=0;i<currentRainDrops;i++)
-		{
-			//-----------------------------------------------
-			//Update the position.  Move rain toward ground.
-			rainDrops[i].position.z -= BASE_RAIN_VEL * frameLength * rainLevel;
+			rainDropZ[i] -= rainFall;
 			
-			if (rainDrops[i].position.z <= currentElevation)
-			{
-				Stuff::Vector3D positionOffset;
-				//This raindrop has hit the ground.  Recycle him.
-				positionOffset.x = RandomNumber(BASE_RAIN_RANDOM_POS_FACTOR * 2) - BASE_RAIN_RANDOM_POS_FACTOR;
-				positionOffset.y = RandomNumber(BASE_RAIN_RANDOM_POS_FACTOR * 2) - BASE_RAIN_RANDOM_POS_FACTOR;
-				positionOffset.z = RandomNumber(BASE_RAIN_RANDOM_HGT_FACTOR * 2) - BASE_RAIN_RANDOM_HGT_FACTOR;
-			
-				rainDrops[i].position.Add(startPos,positionOffset);
-				
-				rainDrops[i].length = BASE_RAIN_LENGTH + RandomNumber(BASE_RAIN_RANDOM_LEN_FACTOR * 2) - BASE_RAIN_RANDOM_LEN_FACTOR; 
-			}
+		for (long i=0;i<currentRainDrops;i++)
+		{
+			//This raindrop has hit the ground.  Recycle him.
+			if (rainDropZ[i] <= currentElevation)
+				placeRainDrop(i,startPos);
 		}
 	}
 	else
@@ -481,44 +498,81 @@ void Weather::render (void)
 		gos_SetRenderState( gos_State_ZCompare, 1);
 		gos_SetRenderState(	gos_State_ZWrite, 0);
 		
+		//-----------------------------------------------------------------
+		// Top and bottom of every drop go into the lanes the way projectZ
+		// would hand them to worldToClip, and get projected in blocks.
+		DWORD numPoints = currentRainDrops * 2;
 		for (long i=0;i<currentRainDrops;i++)
 		{
-			Stuff::Vector4D screen1, screen2;
-			bool onScreen = eye->projectZ(rainDrops[i].position,screen1);
-			if (onScreen)
-			{
-				Stuff::Point3D  botPos = rainDrops[i].position;
-				botPos.z -= rainDrops[i].length;
+			rainLanes.px[i * 2] = rainLanes.px[i * 2 + 1] = -rainDropX[i];
+			rainLanes.py[i * 2] = rainDropZ[i];
+			rainLanes.py[i * 2 + 1] = rainDropZ[i] - rainDropLength[i];
+			rainLanes.pz[i * 2] = rainLanes.pz[i * 2 + 1] = rainDropY[i];
+		}
+		
+		TG_XformParams xformParams;
+		const Stuff::Matrix4D &worldToClip = eye->getWorldToClip();
+		for (long r=0;r<4;r++)
+		{
+			for (long c=0;c<4;c++)
+				xformParams.m[r][c] = worldToClip(r,c);
+		}
+		
+		xformParams.scale = 0.0f;
+		xformParams.viewMulX = eye->viewMulX;
+		xformParams.viewAddX = eye->viewAddX;
+		xformParams.viewMulY = eye->viewMulY;
+		xformParams.viewAddY = eye->viewAddY;
+		xformParams.perspective = eye->usePerspective;
+		
+		Stuff::Vector3D screenRes = eye->getScreenRes();
+		TG_XformBlock xformBlock;
+		long numVertices = 0;
+		for (DWORD first=0;first<numPoints;first+=TG_XFORM_BLOCK)
+		{
+			DWORD blockCount = numPoints - first;
+			if (blockCount > TG_XFORM_BLOCK)
+				blockCount = TG_XFORM_BLOCK;
 				
-				onScreen = eye->projectZ(botPos,screen2);
-				if (onScreen)
+			TG_TransformBlock(xformParams,rainLanes,first,blockCount,xformBlock);
+			
+			for (DWORD k=0;k<blockCount;k+=2)
+			{
+				//---------------------------------------------
+				// Only drawn if both ends are on screen, same
+				// test projectZ makes.
+				bool onScreen = true;
+				for (DWORD e=k;e<k+2;e++)
 				{
-					unsigned char amb = ambientFactor * (1.0f - screen1.z);
-					DWORD rainColor = (amb << 24) + (0xff << 16) + (0xff << 8) + (0xff);
-					
-					//Gotta draw this one!
-					gos_VERTEX sVertices[2];
-					
-					sVertices[0].x = screen1.x;
-					sVertices[0].y = screen1.y;
-					sVertices[0].z = screen1.z;
-					sVertices[0].rhw = screen1.w;
-					sVertices[0].u = sVertices[0].v = 0.0f;
-					sVertices[0].argb = rainColor;
-					sVertices[0].frgb = 0xff000000;
-					
-					sVertices[1].x = screen2.x;
-					sVertices[1].y = screen2.y;
-					sVertices[1].z = screen2.z;
-					sVertices[1].rhw = screen2.w;
-					sVertices[1].u = sVertices[1].v = 0.0f;
-					sVertices[1].argb = rainColor;
-					sVertices[1].frgb = 0xff000000;
+					if ((xformBlock.x[e] < 0) || (xformBlock.y[e] < 0) || (xformBlock.x[e] > screenRes.x) || (xformBlock.y[e] > screenRes.y))
+						onScreen = false;
+				}
+				
+				if (!onScreen)
+					continue;
 					
-					gos_DrawLines(sVertices,2);
+				unsigned char amb = ambientFactor * (1.0f - xformBlock.z[k]);
+				DWORD rainColor = (amb << 24) + (0xff << 16) + (0xff << 8) + (0xff);
+				
+				//Gotta draw this one!
+				for (DWORD e=k;e<k+2;e++)
+				{
+					gos_VERTEX &vertex = rainVertices[numVertices++];
+					vertex.x = xformBlock.x[e];
+					vertex.y = xformBlock.y[e];
+					vertex.z = xformBlock.z[e];
+					vertex.rhw = xformBlock.rhw[e];
+					vertex.u = vertex.v = 0.0f;
+					vertex.argb = rainColor;
+					vertex.frgb = 0xff000000;
 				}
 			}
 		}
+		
+		//------------------------------------------
+		// All of the rain goes down in one draw.
+		if (numVertices)
+			gos_DrawLines(rainVertices,numVertices);
 	}
 }
 
@@ -33,21 +33,6 @@
 #define 		BASE_LIGHTENING_FLASH_AGAIN		2.0f
 #define			BASE_LIGHTENING_FLASH_CHECK		1.0f
 #define			BASE_THUNDER_RANDOM_START		5.0f
-//----------------------------------------------------------------------------------
-// Struct Definitions
-typedef struct _RainDrops
-{
-	Stuff::Point3D		position;
-	float				length;
-	
-	void init (void)
-	{
-		position.Zero();
-		length = 0.0f;
-	}
-	
-} RainDrops;
-
 //----------------------------------------------------------------------------------
 // Class Definitions
 class Weather
@@ -75,7 +60,13 @@ class Weather
 		DWORD			totalRainDrops;				// Total number of drops I can draw.
 		DWORD			currentRainDrops;			// Current number of drops in use.
 		
-		RainDrops*		rainDrops;					// Pointer to data for the drops.
+		float*			rainDropX;					// Drop positions and lengths.  One array per
+		float*			rainDropY;					// field so they can be moved and projected
+		float*			rainDropZ;					// a block at a time.
+		float*			rainDropLength;
+		
+		TG_VertexLanes	rainLanes;					// Top then bottom of each drop, ready for TG_TransformBlock.
+		gos_VERTEX*		rainVertices;				// The drops on screen, drawn as one line list.
 		
 		float			rainTrend;					// Either plus 1.0f or minus 1.0f.  Based on raining more or less then it was.
 		float			rainFactor;					// Increase/decrease in rainLevel per second based on rainTrend.
@@ -85,6 +76,8 @@ class Weather
 		
 		float			oldFog;						// Original FOGFull Height value.
 		
+		void placeRainDrop (long drop, Stuff::Vector3D &startPos);
+		
 	public:
 	
 		Weather (void)
@@ -104,7 +97,11 @@ class Weather
 			
 			baseRainChance = 0;
 			
-			rainDrops = NULL;
+			rainDropX = rainDropY = rainDropZ = rainDropLength = NULL;
+			rainLanes.count = rainLanes.stride = 0;
+			rainLanes.px = rainLanes.py = rainLanes.pz = NULL;
+			rainLanes.nx = rainLanes.ny = rainLanes.nz = NULL;
+			rainVertices = NULL;
 			
 			thunderSFX = 0xffffffff;
 			thunderTime = 0.0f;
@@ -0,0 +1,583 @@
+#include <vector>
+#include <setjmp.h>
+#include "gameos.hpp"
+#include "toolos.hpp"
+
+#include "mclib.h"
+#include "abl.h"
+#include "ablexec.h"
+#include "ablenv.h"
+#include "ablscan.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Differential test for the ABL expression VM (mclib/ablvm.cpp).  Every script
+// is run twice from scratch, once with the token walker only and once with the
+// VM, and everything the script does is compared: each call into the game
+// library with its arguments, each print, fatals, and after every frame the
+// whole ABL environment as a savegame would store it (eternals, module statics
+// and states).  Unlike -ablvm verify in game, this covers expressions which
+// call routines, since nothing is evaluated twice within a run.  Besides the
+// module itself, the handlers the game calls into (pilot alarms, the mission's
+// handlemessage) are run on frames picked from the seed.
+//
+// The game library is replaced by stubs with the signatures of code/ablmc2fn.h.
+// They consume their arguments the way the game does and return values drawn
+// from a seeded sequence, so both runs see the same game and scripts wander
+// down many branches over the frames.  Run from the game directory, e.g.:
+//   abldiff -lib data/missions/orders.abx -lib data/missions/miscfunc.abx
+//           -lib data/missions/corebrain.abx data/missions/profiles/*.abl
+
+UserHeapPtr systemHeap = NULL;
+
+void usage(char** argv) {
+    printf("%s [-n frames] [-s seed] [-lib library.abx]... script.abl...\n", argv[0]);
+    printf("\t-n - how many times each module is executed (default 100)\n");
+    printf("\t-s - seed of the values library stubs return (default 1)\n");
+    printf("\t-lib - library loaded before the script, as the mission does (may repeat)\n");
+}
+
+struct LibraryFunction {
+    const char* name;
+    bool isOrder;
+    const char* params;
+    const char* returnType;
+};
+
+#define ABL_FUNCTION(name, isOrder, paramList, returnType, codeCallback) { name, isOrder, paramList, returnType },
+static const LibraryFunction g_library[] = {
+#include "ablmc2fn.h"
+};
+#undef ABL_FUNCTION
+
+static const int NUM_LIBRARY_FUNCTIONS = sizeof(g_library) / sizeof(g_library[0]);
+
+// Functions the game calls by name: pilotAlarmFunctionName in code/warrior.cpp
+// and the mission brain's message handler (code/mission.cpp)
+static const char* g_handlers[] = {
+    "handletargetofweaponfire",
+    "handlehitbyweaponfire",
+    "handledamagetakenrate",
+    "handledeathofmate",
+    "handlecripplingoffriendlyvehicle",
+    "handledestructionoffriendlyvehicle",
+    "handleincapacitationofvehicle",
+    "handledestructionofvehicle",
+    "handlewithdraw",
+    "handleattackorder",
+    "handlecollision",
+    "handleguardbreach",
+    "handlekilledtarget",
+    "handlematefiredweapon",
+    "handleplayerorder",
+    "handlenomovepath",
+    "handlegateclosing",
+    "handlefiredweapon",
+    "handlenewmover",
+    "handlemessage"
+};
+
+static const int NUM_HANDLERS = sizeof(g_handlers) / sizeof(g_handlers[0]);
+
+enum EventKind {
+    EV_CALL,
+    EV_PRINT,
+    EV_FATAL,
+    EV_HANDLER,
+    EV_FRAME
+};
+
+struct Event {
+    int kind;
+    int what;       // library function, fatal code, handler or frame
+    int line;
+    uint32_t data;  // hash of arguments, text or environment
+};
+
+static std::vector<Event>* g_events = NULL;
+static uint32_t g_seed = 1;
+static uint32_t g_num_calls = 0;
+static uint32_t g_random = 1;
+static jmp_buf g_fatal_jump;
+static char g_fatal_message[256];
+
+static uint32_t hash_bytes(uint32_t h, const void* data, size_t size)
+{
+    // FNV-1a
+    const unsigned char* p = (const unsigned char*)data;
+    for(size_t i=0; i<size; ++i) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static const uint32_t HASH_START = 2166136261u;
+
+static void add_event(int kind, int what, uint32_t data)
+{
+    Event e = { kind, what, execLineNumber, data };
+    g_events->push_back(e);
+}
+
+// what the game would have answered to the n-th library call
+static uint32_t stub_value(uint32_t n)
+{
+    uint32_t h = hash_bytes(HASH_START, &g_seed, sizeof(g_seed));
+    return hash_bytes(h, &n, sizeof(n));
+}
+
+//---------------------------------------------------------------------------
+// ABL callbacks
+
+static void* diff_malloc(unsigned long size)
+{
+    // module statics are saved as whole stack items even when only an integer
+    // was stored, so memory has to start out the same in both runs
+    return calloc(1, size ? size : 1);
+}
+
+static void diff_free(void* p)
+{
+    free(p);
+}
+
+// Scripts are read from disk, environment snapshots go to memory
+struct DiffFile {
+    File* file;
+    std::vector<unsigned char>* mem;
+};
+
+static long diff_create(void** f, const char* name)
+{
+    DiffFile* df = new DiffFile;
+    df->file = new File;
+    df->mem = NULL;
+    *f = df;
+    return df->file->create((char*)name);
+}
+
+static long diff_open(void** f, const char* name)
+{
+    DiffFile* df = new DiffFile;
+    df->file = new File;
+    df->mem = NULL;
+    *f = df;
+    return df->file->open((char*)name);
+}
+
+static long diff_close(void** f)
+{
+    DiffFile* df = (DiffFile*)*f;
+    if(df->file) {
+        df->file->close();
+        delete df->file;
+    }
+    delete df;
+    *f = NULL;
+    return 0;
+}
+
+static bool diff_eof(void* f) { return ((DiffFile*)f)->file->eof(); }
+static long diff_read(void* f, unsigned char* b, long l) { return ((DiffFile*)f)->file->read(b, l); }
+static int32_t diff_read_int(void* f) { return ((DiffFile*)f)->file->readInt(); }
+static long diff_read_long(void* f) { return ((DiffFile*)f)->file->readLong(); }
+static long diff_read_string(void* f, unsigned char* b) { return ((DiffFile*)f)->file->readString(b); }
+static long diff_read_line(void* f, unsigned char* b, long m) { return ((DiffFile*)f)->file->readLineEx(b, m); }
+
+static long diff_write(void* f, unsigned char* b, long l)
+{
+    DiffFile* df = (DiffFile*)f;
+    if(df->mem) {
+        df->mem->insert(df->mem->end(), b, b + l);
+        return l;
+    }
+    return df->file->write(b, l);
+}
+
+static long diff_write_byte(void* f, unsigned char b) { return diff_write(f, &b, 1); }
+static long diff_write_int(void* f, int32_t v) { return diff_write(f, (unsigned char*)&v, sizeof(v)); }
+static long diff_write_long(void* f, long v) { return diff_write(f, (unsigned char*)&v, sizeof(v)); }
+static long diff_write_string(void* f, const char* s) { return diff_write(f, (unsigned char*)s, (long)strlen(s)); }
+
+static void diff_debugger_print(const char* s)
+{
+}
+
+static void diff_print(const char* s)
+{
+    add_event(EV_PRINT, 0, hash_bytes(HASH_START, s, strlen(s)));
+}
+
+static void diff_fatal(long code, const char* s)
+{
+    add_event(EV_FATAL, (int)code, hash_bytes(HASH_START, s, strlen(s)));
+    snprintf(g_fatal_message, sizeof(g_fatal_message), "%s", s);
+    longjmp(g_fatal_jump, 1);
+}
+
+static void diff_seed_random(unsigned long seed)
+{
+    // seedrandom(-1) seeds from the clock, keep both runs on the same sequence
+}
+
+static long diff_random(long range)
+{
+    g_random = g_random * 1103515245 + 12345;
+    return range > 0 ? (long)((g_random >> 16) % range) : 0;
+}
+
+static void diff_endless_state(UserFile* log)
+{
+}
+
+//---------------------------------------------------------------------------
+// Library stubs: arguments are taken off the stack as the game's callbacks take
+// them (ABLi_pop*), arrays the game would fill get their first element set
+
+static void exec_stub(int index)
+{
+    const LibraryFunction& fn = g_library[index];
+    const uint32_t value = stub_value(g_num_calls++);
+    uint32_t h = HASH_START;
+
+    for(const char* p = fn.params; p && *p; ++p) {
+        switch(*p) {
+            case 'c': {
+                char c = ABLi_popChar();
+                h = hash_bytes(h, &c, sizeof(c));
+                break;
+            }
+            case 'i': {
+                int i = ABLi_popInteger();
+                h = hash_bytes(h, &i, sizeof(i));
+                break;
+            }
+            case 'r': {
+                float r = ABLi_popReal();
+                h = hash_bytes(h, &r, sizeof(r));
+                break;
+            }
+            case 'b': {
+                bool b = ABLi_popBoolean();
+                h = hash_bytes(h, &b, sizeof(b));
+                break;
+            }
+            case '*': {
+                float r = ABLi_popIntegerReal();
+                h = hash_bytes(h, &r, sizeof(r));
+                break;
+            }
+            case '?': {
+                ABLStackItem item;
+                long type = ABLi_popAnything(&item);
+                h = hash_bytes(h, &type, sizeof(type));
+                switch(type) {
+                    case ABL_STACKITEM_CHAR_PTR:
+                        h = hash_bytes(h, item.data.characterPtr, strlen(item.data.characterPtr));
+                        break;
+                    case ABL_STACKITEM_INTEGER_PTR:
+                        h = hash_bytes(h, item.data.integerPtr, sizeof(int));
+                        break;
+                    case ABL_STACKITEM_REAL_PTR:
+                        h = hash_bytes(h, item.data.realPtr, sizeof(float));
+                        break;
+                    case ABL_STACKITEM_BOOLEAN_PTR:
+                        h = hash_bytes(h, item.data.booleanPtr, sizeof(bool));
+                        break;
+                    default:
+                        h = hash_bytes(h, &item.data, sizeof(item.data.integer));
+                        break;
+                }
+                break;
+            }
+            case 'C': {
+                char* s = ABLi_popCharPtr();
+                h = hash_bytes(h, s, strlen(s));
+                break;
+            }
+            case 'I': {
+                int* a = ABLi_popIntegerPtr();
+                h = hash_bytes(h, a, sizeof(int));
+                a[0] = (int)(value % 8);
+                break;
+            }
+            case 'R': {
+                float* a = ABLi_popRealPtr();
+                h = hash_bytes(h, a, sizeof(float));
+                a[0] = (float)(value % 4096) * 0.25f;
+                break;
+            }
+            case 'B': {
+                char* a = ABLi_popBooleanPtr();
+                h = hash_bytes(h, a, 1);
+                a[0] = (value & 1) ? 1 : 0;
+                break;
+            }
+        }
+    }
+
+    add_event(EV_CALL, index, h);
+
+    if(!fn.returnType)
+        return;
+
+    // orders skipped because they are already done report success, as in game
+    if(fn.isOrder && ABLi_getSkipOrder()) {
+        ABLi_pushInteger(1);
+        return;
+    }
+
+    switch(fn.returnType[0]) {
+        case 'i':
+            // mostly small values: ids, counts, flags and -1 for "none"
+            ABLi_pushInteger((value >> 8) % 16 == 0 ? (int)(value >> 12) % 1000 : (int)((value >> 8) % 12) - 1);
+            break;
+        case 'r':
+            ABLi_pushReal((float)((value >> 8) % 20000) * 0.05f - 100.0f);
+            break;
+        case 'b':
+            ABLi_pushBoolean(((value >> 8) & 1) != 0);
+            break;
+    }
+}
+
+template <int N> static void stub_callback(void) { exec_stub(N); }
+
+template <int N> struct StubTable {
+    static void fill(void (**table)(void)) {
+        table[N - 1] = stub_callback<N - 1>;
+        StubTable<N - 1>::fill(table);
+    }
+};
+template <> struct StubTable<0> {
+    static void fill(void (**table)(void)) {}
+};
+
+static const int MAX_STUBS = 256;
+
+//---------------------------------------------------------------------------
+
+static uint32_t hash_environment()
+{
+    std::vector<unsigned char> mem;
+    DiffFile df = { NULL, &mem };
+    ABLFile ablFile;
+    ablFile.set(&df);
+    ABLi_saveEnvironment(&ablFile);
+    ablFile.set(NULL);
+    return hash_bytes(HASH_START, mem.empty() ? NULL : &mem[0], mem.size());
+}
+
+struct RunResult {
+    std::vector<Event> events;
+    long compiled;
+    long interpreted;
+    long handlers;
+    bool loaded;
+};
+
+static void run(const char* script, const std::vector<const char*>& libraries, int frames, long vmMode, RunResult& result)
+{
+    // same sizes the game gives ABL (initABL in code/ablmc2.cpp)
+    ABLi_init(20479, 102400, 200, 100,
+              diff_malloc, diff_malloc, diff_malloc, diff_malloc,
+              diff_free, diff_free, diff_free, diff_free,
+              diff_create, diff_open, diff_close, diff_eof,
+              diff_read, diff_read_int, diff_read_long, diff_read_string, diff_read_line,
+              diff_write, diff_write_byte, diff_write_int, diff_write_long, diff_write_string,
+              diff_debugger_print, diff_fatal, true, false);
+    ABLi_setDebugPrintCallback(diff_print);
+    ABLi_setRandomCallbacks(diff_seed_random, diff_random);
+    ABLi_setEndlessStateCallback(diff_endless_state);
+    ABLi_setVMMode(vmMode);
+
+    void (*stubs[MAX_STUBS])(void);
+    StubTable<MAX_STUBS>::fill(stubs);
+    for(int i=0; i<NUM_LIBRARY_FUNCTIONS; ++i)
+        ABLi_addFunction(g_library[i].name, g_library[i].isOrder, g_library[i].params, g_library[i].returnType, stubs[i]);
+
+    g_events = &result.events;
+    g_num_calls = 0;
+    g_random = 1;
+    result.loaded = false;
+    result.handlers = 0;
+
+    long compiled = 0, interpreted = 0, mismatches = 0;
+    ABLi_getVMStats(compiled, interpreted, mismatches);
+
+    // survive the longjmp out of a fatal
+    static ABLModulePtr module;
+    static int frame;
+    static SymTableNodePtr handlers[NUM_HANDLERS];
+    module = NULL;
+    frame = 0;
+    g_fatal_message[0] = 0;
+    if(setjmp(g_fatal_jump) == 0) {
+        bool ok = true;
+        for(size_t i=0; i<libraries.size() && ok; ++i) {
+            long numErrors = 0;
+            if(!ABLi_loadLibrary(libraries[i], &numErrors) || numErrors) {
+                printf("%s: failed to load\n", libraries[i]);
+                ok = false;
+            }
+        }
+
+        long numErrors = 0;
+        long handle = ok ? ABLi_preProcess(script, &numErrors) : -1;
+        if(handle >= 0 && !numErrors) {
+            module = new ABLModule;
+            module->init(handle);
+            result.loaded = true;
+            for(int i=0; i<NUM_HANDLERS; ++i) {
+                handlers[i] = module->findFunction(g_handlers[i], true);
+                if(handlers[i])
+                    result.handlers++;
+            }
+            for(; frame<frames; ++frame) {
+                module->execute();
+                for(int i=0; i<NUM_HANDLERS; ++i) {
+                    // roughly every fourth frame, the same frames in both runs
+                    if(handlers[i] && stub_value(0x80000000u + frame * NUM_HANDLERS + i) % 4 == 0) {
+                        add_event(EV_HANDLER, i, 0);
+                        module->execute(NULL, handlers[i]);
+                    }
+                }
+                add_event(EV_FRAME, frame, hash_environment());
+            }
+        } else if(ok) {
+            printf("%s: %ld errors\n", script, numErrors);
+        }
+    } else if(!result.loaded) {
+        printf("%s: %s\n", script, g_fatal_message);
+    }
+
+    long compiled_after = 0, interpreted_after = 0;
+    ABLi_getVMStats(compiled_after, interpreted_after, mismatches);
+    result.compiled = compiled_after - compiled;
+    result.interpreted = interpreted_after - interpreted;
+
+    delete module;
+    ABLi_close();
+    g_events = NULL;
+}
+
+static void describe(const Event& e, char* s, size_t size)
+{
+    switch(e.kind) {
+        case EV_CALL:
+            snprintf(s, size, "%s() at line %d, arguments 0x%08x", g_library[e.what].name, e.line, e.data);
+            break;
+        case EV_PRINT:
+            snprintf(s, size, "print at line %d, text 0x%08x", e.line, e.data);
+            break;
+        case EV_FATAL:
+            snprintf(s, size, "fatal %d at line %d", e.what, e.line);
+            break;
+        case EV_HANDLER:
+            snprintf(s, size, "%s() called", g_handlers[e.what]);
+            break;
+        case EV_FRAME:
+            snprintf(s, size, "end of frame %d, environment 0x%08x", e.what, e.data);
+            break;
+    }
+}
+
+// Returns true if both runs did the same
+static bool compare(const char* script, const RunResult& walker, const RunResult& vm)
+{
+    size_t n = std::min(walker.events.size(), vm.events.size());
+    for(size_t i=0; i<=n; ++i) {
+        bool walker_done = i == walker.events.size();
+        bool vm_done = i == vm.events.size();
+        if(walker_done && vm_done)
+            return true;
+
+        if(!walker_done && !vm_done) {
+            const Event& a = walker.events[i];
+            const Event& b = vm.events[i];
+            if(a.kind == b.kind && a.what == b.what && a.line == b.line && a.data == b.data)
+                continue;
+        }
+
+        char sa[256] = "nothing more", sb[256] = "nothing more";
+        if(!walker_done)
+            describe(walker.events[i], sa, sizeof(sa));
+        if(!vm_done)
+            describe(vm.events[i], sb, sizeof(sb));
+        printf("%s: MISMATCH at event %d\n\ttoken walker: %s\n\tvm:           %s\n", script, (int)i, sa, sb);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    int frames = 100;
+    std::vector<const char*> libraries;
+    std::vector<const char*> scripts;
+
+    for(int i=1; i<argc; ++i) {
+        if(0 == strcmp(argv[i], "-n") && i+1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if(0 == strcmp(argv[i], "-s") && i+1 < argc) {
+            g_seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if(0 == strcmp(argv[i], "-lib") && i+1 < argc) {
+            libraries.push_back(argv[++i]);
+        } else if(argv[i][0] != '-') {
+            scripts.push_back(argv[i]);
+        } else {
+            usage(argv);
+            return 1;
+        }
+    }
+
+    if(scripts.empty() || frames < 1) {
+        usage(argv);
+        return 1;
+    }
+
+    if(NUM_LIBRARY_FUNCTIONS > MAX_STUBS) {
+        printf("%d library functions, only %d stubs\n", NUM_LIBRARY_FUNCTIONS, MAX_STUBS);
+        return 1;
+    }
+
+    systemHeap = new UserHeap();
+    if(!systemHeap) {
+        STOP(("Failed to initialize system heap"));
+        return -1;
+    }
+    systemHeap->init(8*1024*1024);
+
+    int failed = 0;
+    long total_calls = 0;
+    for(size_t s=0; s<scripts.size(); ++s) {
+        RunResult walker, vm;
+        run(scripts[s], libraries, frames, ABL_VM_OFF, walker);
+        run(scripts[s], libraries, frames, ABL_VM_ON, vm);
+
+        if(!walker.loaded || !vm.loaded) {
+            failed++;
+            continue;
+        }
+
+        long calls = 0;
+        for(size_t i=0; i<walker.events.size(); ++i)
+            if(walker.events[i].kind == EV_CALL)
+                calls++;
+        total_calls += calls;
+
+        if(!compare(scripts[s], walker, vm)) {
+            failed++;
+            continue;
+        }
+
+        const Event& last = walker.events.back();
+        printf("%s: OK, %d frames, %ld handlers, %ld library calls, %ld expressions compiled, %ld left to the token walker%s\n",
+               scripts[s], frames, walker.handlers, calls, vm.compiled, vm.interpreted, last.kind == EV_FATAL ? " (both stopped on the same fatal)" : "");
+    }
+
+    printf("%d of %d scripts differ or failed to load, %ld library calls compared\n", failed, (int)scripts.size(), total_calls);
+    return failed ? 1 : 0;
+}
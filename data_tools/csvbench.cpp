@@ -0,0 +1,245 @@
+#include <queue>
+#include <vector>
+#include <string>
+#include <chrono>
+#include "gameos.hpp"
+#include "toolos.hpp"
+
+#include "mclib.h"
+#include "datacache.h"
+#include <stdio.h>
+
+
+UserHeapPtr systemHeap = NULL;
+FastFile** fastFiles = NULL;
+long numFastFiles = 0;
+long maxFastFiles = 0;
+
+void usage(char** argv) {
+    printf("%s [-n iterations] [-nocache] [-noscan] <-p data_path>\n", argv[0]);
+    printf("\\t-p - directory which is searched recursively for .csv files\n");
+    printf("\\t-n - how many times every file is opened and every cell read (default 1)\n");
+    printf("\\t-nocache - always parse the text, ignore (and don't write) data caches\n");
+    printf("\\t-noscan - don't compare against (and time) the old row by row scan\n");
+}
+
+struct BenchStats {
+    size_t files;
+    size_t badFiles;
+    size_t cells;
+    size_t emptyCells;
+    size_t mismatches;
+    double openMs;
+    double readMs;
+    double scanMs;
+};
+
+// Finds cells the way CSVFile did before it kept an index: back to the top of the file
+// and readLine down to the row, then count commas along it. Used as the reference.
+class ScanCSVFile : public CSVFile
+{
+public:
+    DWORD getTotalRows() const { return totalRows; }
+    DWORD getTotalCols() const { return totalCols; }
+    const char* getData() const { return dataBuffer; }
+
+    long scanRowCol(DWORD row, DWORD col, char* buffer)
+    {
+        if(row == 0 || row > totalRows || col > totalCols)
+            return -1;
+
+        seek(0);
+        char tmp[2048];
+        for(DWORD r=0; r<row; ++r)
+            readLine((MemoryPtr)tmp, 2047);
+
+        char* currentChk = tmp;
+        for(DWORD c=1; currentChk && c<col; ++c) {
+            currentChk = strstr(currentChk, ",");
+            if(currentChk)
+                currentChk++;
+        }
+
+        if(!currentChk)
+            return -1;
+        return getNextWord(currentChk, buffer, 2047);
+    }
+};
+
+static bool has_csv_extension(const char* fname)
+{
+    size_t len = strlen(fname);
+    return len > 4 && 0 == S_stricmp(fname + len - 4, ".csv");
+}
+
+static void bench_file(const char* fname, int iterations, bool scan, BenchStats& stats)
+{
+    for(int it=0; it<iterations; ++it) {
+        ScanCSVFile csv;
+
+        auto t0 = std::chrono::steady_clock::now();
+        long result = csv.open(fname);
+        auto t1 = std::chrono::steady_clock::now();
+        stats.openMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+        if(result != NO_ERR) {
+            if(it == 0) {
+                printf("Failed to open %s (0x%lx)\n", fname, result);
+                stats.badFiles++;
+            }
+            return;
+        }
+
+        DWORD rows = csv.getTotalRows();
+        DWORD cols = csv.getTotalCols();
+
+        // read every cell the way the game's tables do, as text and as both kinds of number
+        char text[2048];
+        size_t empty = 0;
+        t0 = std::chrono::steady_clock::now();
+        for(DWORD row=1; row<=rows; ++row) {
+            for(DWORD col=1; col<=cols; ++col) {
+                float f;
+                long l;
+                if(csv.readString(row, col, text, sizeof(text) - 1) != NO_ERR)
+                    empty++;
+                csv.readFloat(row, col, f);
+                csv.readLong(row, col, l);
+            }
+        }
+        t1 = std::chrono::steady_clock::now();
+        stats.readMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+        if(it == 0) {
+            stats.files++;
+            stats.cells += rows * cols;
+            stats.emptyCells += empty;
+        }
+
+        // the scan is quadratic in the number of rows, one pass is plenty
+        if(it == 0 && scan) {
+            char expected[2048];
+            t0 = std::chrono::steady_clock::now();
+            for(DWORD row=0; row<=rows + 1; ++row) {
+                for(DWORD col=0; col<=cols + 1; ++col) {
+                    long want = csv.scanRowCol(row, col, expected);
+                    long got = csv.seekRowCol(row, col);
+                    if(want != got || (want == NO_ERR && strcmp(csv.getData(), expected) != 0)) {
+                        if(stats.mismatches < 20)
+                            printf("%s: row %lu col %lu: scan %ld \"%s\", index %ld \"%s\"\n", fname,
+                                   (unsigned long)row, (unsigned long)col, want, want == NO_ERR ? expected : "",
+                                   got, got == NO_ERR ? csv.getData() : "");
+                        stats.mismatches++;
+                    }
+                }
+            }
+            t1 = std::chrono::steady_clock::now();
+            stats.scanMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+        }
+
+        csv.close();
+    }
+}
+
+int bench(const char* in_path, int iterations, bool scan)
+{
+    std::queue<char*> dirs2process;
+    BenchStats stats = {0};
+
+    char* findString = new char[strlen(in_path) + 1];
+    strcpy(findString, in_path);
+    dirs2process.push(findString);
+
+    while(!dirs2process.empty()) {
+
+        char* cur_dir = dirs2process.front();
+        dirs2process.pop();
+
+        char* cur_search_path = new char[strlen(cur_dir) + strlen(PATH_SEPARATOR) + strlen("*") + 1];
+        sprintf(cur_search_path, "%s" PATH_SEPARATOR "*", cur_dir);
+
+        WIN32_FIND_DATA	findResult;
+        HANDLE searchHandle = FindFirstFile(cur_search_path, &findResult);
+        if (searchHandle != INVALID_HANDLE_VALUE)
+        {
+            do
+            {
+                char* filename = new char[strlen(cur_dir) + strlen(PATH_SEPARATOR) + strlen(findResult.cFileName) + 1];
+                sprintf(filename, "%s" PATH_SEPARATOR "%s", cur_dir, findResult.cFileName);
+
+                if ((findResult.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+                {
+                    if(has_csv_extension(findResult.cFileName))
+                        bench_file(filename, iterations, scan, stats);
+                    delete[] filename;
+                } else {
+                    if(strcmp(findResult.cFileName, ".") && strcmp(findResult.cFileName, ".."))
+                        dirs2process.push(filename);
+                    else
+                        delete[] filename;
+                }
+            } while (FindNextFile(searchHandle, &findResult) != 0);
+
+            FindClose(searchHandle);
+        }
+
+        delete[] cur_search_path;
+        delete[] cur_dir;
+    }
+
+    printf("files: %zu (%zu failed to open)\n", stats.files, stats.badFiles);
+    printf("cells: %zu (%zu empty)\n", stats.cells, stats.emptyCells);
+    printf("iterations: %d, caches loaded: %ld, written: %ld, rejected: %ld\n", iterations, DataCacheFile::numLoaded, DataCacheFile::numWritten, DataCacheFile::numRejected);
+    printf("open: %.3f ms total, %.3f ms per pass\n", stats.openMs, stats.openMs / iterations);
+    printf("read: %.3f ms total, %.3f ms per pass\n", stats.readMs, stats.readMs / iterations);
+    if(scan) {
+        printf("scan: %.3f ms for one pass (reads each cell once, as text)\n", stats.scanMs);
+        printf("scan mismatches: %zu\n", stats.mismatches);
+    }
+
+    return (stats.badFiles || stats.mismatches) ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+    const char* in_path = nullptr;
+    int iterations = 1;
+    bool scan = true;
+
+    if(argc < 2) {
+        usage(argv);
+        return 1;
+    }
+
+    systemHeap = new UserHeap();
+    if(!systemHeap) {
+        STOP(("Failed to initialize system heap"));
+        return -1;
+    }
+    systemHeap->init(32*1024*1024);
+
+    for(int i=1;i<argc;++i) {
+        if(0 == strcmp(argv[i], "-p") && i+1 < argc) {
+           in_path = argv[i+1];
+           ++i;
+        }
+
+        if(0 == strcmp(argv[i], "-n") && i+1 < argc) {
+           iterations = atoi(argv[i+1]);
+           ++i;
+        }
+
+        if(0 == strcmp(argv[i], "-nocache"))
+            DataCacheFile::useDataCache = false;
+
+        if(0 == strcmp(argv[i], "-noscan"))
+            scan = false;
+    }
+
+    if(!in_path || iterations < 1) {
+        usage(argv);
+        return 1;
+    }
+
+    return bench(in_path, iterations, scan);
+}
@@ -0,0 +1,309 @@
+#include <vector>
+#include <algorithm>
+#include <math.h>
+#include "gameos.hpp"
+#include "gos_cmdbuffer.h"
+#include <stdio.h>
+#include <string.h>
+
+// Replays a frame captured in game through the renderer's command buffer with a
+// backend which only counts what would be drawn, and checks that batching reduces
+// the number of draws without changing what ends up on screen.  To capture one,
+// run the game, enter debug draw calls mode and press C: the next frame is saved
+// to gos_frame.gcb in the working directory.
+
+void usage(char** argv) {
+    printf("%s -f frame.gcb [-o out.gcb]\n", argv[0]);
+    printf("\t-f - frame captured in game (debug draw calls mode, C key)\n");
+    printf("\t-o - save replayed frame\n");
+}
+
+struct ReplayStats {
+    uint32_t draws;
+    uint32_t state_changes;
+    uint32_t vertices;
+    uint32_t indices;
+};
+
+// Null backend: does what gosRenderer::flush() does, minus GL. Batch data is gathered
+// and every primitive is compared against the command it came from.
+static bool replay(const gosCommandBuffer& cb, const std::vector<gosCommandBuffer::Batch>& batches, ReplayStats& stats)
+{
+    memset(&stats, 0, sizeof(stats));
+
+    const std::vector<gosCommandBuffer::Command>& cmds = cb.getCommands();
+    const gos_VERTEX* src_vertices = cb.getVertices();
+
+    std::vector<gos_VERTEX> vout;
+    std::vector<uint32_t> iout;
+    uint32_t applied_state = 0xffffffff;
+    const uint32_t base_vertex = 1000;
+
+    for(size_t b=0; b<batches.size(); ++b) {
+        const gosCommandBuffer::Batch& batch = batches[b];
+
+        stats.draws++;
+        if(batch.state_ != applied_state) {
+            stats.state_changes++;
+            applied_state = batch.state_;
+        }
+        stats.vertices += batch.num_vertices_;
+        stats.indices += batch.num_indices_;
+
+        vout.resize(batch.num_vertices_);
+        iout.resize(batch.num_indices_ ? batch.num_indices_ : 1);
+        cb.gatherBatch(batch, &vout[0], &iout[0], base_vertex);
+
+        uint32_t voff = 0;
+        uint32_t ioff = 0;
+        for(uint32_t c=0; c<batch.count_; ++c) {
+            const gosCommandBuffer::Command& cmd = cmds[cb.getOrder()[batch.first_ + c]];
+            if(cmd.state_ != batch.state_ || cmd.material_ != batch.material_ || cmd.prim_ != batch.prim_) {
+                printf("batch %d: command with different state merged in\n", (int)b);
+                return false;
+            }
+            if(0 != memcmp(&vout[voff], src_vertices + cmd.first_vertex_, cmd.num_vertices_ * sizeof(gos_VERTEX))) {
+                printf("batch %d: vertices do not match recorded ones\n", (int)b);
+                return false;
+            }
+            for(uint32_t i=0; i<cmd.num_indices_; ++i) {
+                uint32_t idx = iout[ioff + i];
+                if(idx < base_vertex + voff || idx >= base_vertex + voff + cmd.num_vertices_) {
+                    printf("batch %d: index %u points outside of its draw\n", (int)b, idx);
+                    return false;
+                }
+            }
+            voff += cmd.num_vertices_;
+            ioff += cmd.num_indices_;
+        }
+    }
+    return true;
+}
+
+// Everything which is not order independent must stay where it was issued and
+// sortable commands may only move inside of their own run
+static bool check_order(const gosCommandBuffer& cb)
+{
+    const std::vector<gosCommandBuffer::Command>& cmds = cb.getCommands();
+    const std::vector<uint32_t>& order = cb.getOrder();
+
+    std::vector<bool> seen(cmds.size(), false);
+    for(size_t pos=0; pos<order.size(); ++pos) {
+        uint32_t ci = order[pos];
+        if(ci >= cmds.size() || seen[ci]) {
+            printf("draw order is not a permutation of recorded draws\n");
+            return false;
+        }
+        seen[ci] = true;
+
+        if(!cmds[ci].sortable_ && ci != pos) {
+            printf("order dependent draw %u moved to %d\n", ci, (int)pos);
+            return false;
+        }
+        if(cmds[ci].sortable_) {
+            size_t lo = ci < pos ? ci : pos;
+            size_t hi = ci < pos ? pos : ci;
+            for(size_t i=lo; i<=hi; ++i) {
+                if(!cmds[i].sortable_ || cmds[i].segment_ != cmds[ci].segment_) {
+                    printf("draw %u moved across order dependent draw %d\n", ci, (int)i);
+                    return false;
+                }
+            }
+        }
+    }
+    return order.size() == cmds.size();
+}
+
+// Depth only software rasterizer, just enough to tell which depth writing draw
+// ends up visible at each pixel.  Sorting may only reorder opaque draws, so for any two of them
+// drawn in a different order the result must not change, which is only the
+// case when they do not overlap at exactly the same depth (coplanar overlays
+// have to be separated by gos_DrawBarrier()).  Points and lines are ignored.
+struct VisibleFrame {
+    int w;
+    int h;
+    std::vector<float> depth;
+    std::vector<uint32_t> draw;
+};
+
+static const uint32_t NO_DRAW = 0xffffffff;
+
+static float edge(const gos_VERTEX& a, const gos_VERTEX& b, float x, float y)
+{
+    return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+}
+
+// top-left rule, so triangles sharing an edge never both cover a pixel on it
+static bool is_top_left(const gos_VERTEX& a, const gos_VERTEX& b)
+{
+    return (a.y == b.y && b.x < a.x) || b.y < a.y;
+}
+
+static void rasterize_triangle(VisibleFrame& f, const gos_VERTEX* v0, const gos_VERTEX* v1, const gos_VERTEX* v2, uint32_t zcompare, uint32_t draw)
+{
+    float area = edge(*v0, *v1, v2->x, v2->y);
+    if(area == 0.0f)
+        return;
+    if(area < 0.0f) {
+        std::swap(v1, v2);
+        area = -area;
+    }
+
+    int x0 = std::max(0, (int)floorf(std::min(v0->x, std::min(v1->x, v2->x))));
+    int y0 = std::max(0, (int)floorf(std::min(v0->y, std::min(v1->y, v2->y))));
+    int x1 = std::min(f.w - 1, (int)ceilf(std::max(v0->x, std::max(v1->x, v2->x))));
+    int y1 = std::min(f.h - 1, (int)ceilf(std::max(v0->y, std::max(v1->y, v2->y))));
+
+    const bool tl0 = is_top_left(*v1, *v2);
+    const bool tl1 = is_top_left(*v2, *v0);
+    const bool tl2 = is_top_left(*v0, *v1);
+
+    for(int y=y0; y<=y1; ++y) {
+        for(int x=x0; x<=x1; ++x) {
+            const float px = x + 0.5f;
+            const float py = y + 0.5f;
+            float w0 = edge(*v1, *v2, px, py);
+            float w1 = edge(*v2, *v0, px, py);
+            float w2 = edge(*v0, *v1, px, py);
+            if(w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+                continue;
+            if((w0 == 0.0f && !tl0) || (w1 == 0.0f && !tl1) || (w2 == 0.0f && !tl2))
+                continue;
+
+            const float z = (w0 * v0->z + w1 * v1->z + w2 * v2->z) / area;
+            const int p = y * f.w + x;
+            if(zcompare == 1 && !(z <= f.depth[p]))
+                continue;
+            if(zcompare == 2 && !(z < f.depth[p]))
+                continue;
+            f.depth[p] = z;
+            f.draw[p] = draw;
+        }
+    }
+}
+
+static void rasterize(const gosCommandBuffer& cb, bool sorted, VisibleFrame& f)
+{
+    const std::vector<gosCommandBuffer::Command>& cmds = cb.getCommands();
+    const gos_VERTEX* vertices = cb.getVertices();
+
+    f.w = 1;
+    f.h = 1;
+    for(uint32_t i=0; i<cb.getNumVertices(); ++i) {
+        f.w = std::max(f.w, std::min(4096, (int)ceilf(vertices[i].x) + 1));
+        f.h = std::max(f.h, std::min(4096, (int)ceilf(vertices[i].y) + 1));
+    }
+    f.depth.assign(f.w * f.h, 1.0f);
+    f.draw.assign(f.w * f.h, NO_DRAW);
+
+    for(size_t pos=0; pos<cmds.size(); ++pos) {
+        const uint32_t ci = sorted ? cb.getOrder()[pos] : (uint32_t)pos;
+        const gosCommandBuffer::Command& cmd = cmds[ci];
+        const uint32_t* rs = cb.getState(cmd.state_);
+        // draws which leave depth alone are never reordered, what is under them is what matters
+        if(!rs[gos_State_ZWrite])
+            continue;
+        const uint32_t zcompare = rs[gos_State_ZCompare];
+        const gos_VERTEX* v = vertices + cmd.first_vertex_;
+
+        if(cmd.prim_ == gosCommandBuffer::PT_TRIS) {
+            for(uint32_t i=0; i+2<cmd.num_vertices_; i+=3)
+                rasterize_triangle(f, &v[i], &v[i+1], &v[i+2], zcompare, ci);
+        } else if(cmd.prim_ == gosCommandBuffer::PT_INDEXED_TRIS) {
+            const WORD* idx = cb.getIndices() + cmd.first_index_;
+            for(uint32_t i=0; i+2<cmd.num_indices_; i+=3)
+                rasterize_triangle(f, &v[idx[i]], &v[idx[i+1]], &v[idx[i+2]], zcompare, ci);
+        }
+    }
+}
+
+static uint32_t count_changed_pixels(const VisibleFrame& a, const VisibleFrame& b)
+{
+    uint32_t changed = 0;
+    for(size_t p=0; p<a.draw.size(); ++p)
+        if(a.draw[p] != b.draw[p])
+            ++changed;
+    return changed;
+}
+
+int main(int argc, char** argv)
+{
+    const char* frame_file = nullptr;
+    const char* out_file = nullptr;
+
+    for(int i=1;i<argc;++i) {
+        if(0 == strcmp(argv[i], "-f") && i+1 < argc) {
+            frame_file = argv[i+1];
+            ++i;
+        } else if(0 == strcmp(argv[i], "-o") && i+1 < argc) {
+            out_file = argv[i+1];
+            ++i;
+        } else {
+            usage(argv);
+            return 1;
+        }
+    }
+
+    if(!frame_file) {
+        usage(argv);
+        return 1;
+    }
+
+    gosCommandBuffer cb(1024*64, 1024*96);
+    if(!cb.load(frame_file)) {
+        printf("Failed to load %s\n", frame_file);
+        return 1;
+    }
+
+    if(out_file && !cb.save(out_file)) {
+        printf("Failed to save %s\n", out_file);
+        return 1;
+    }
+
+    const uint32_t num_commands = cb.getNumCommands();
+    printf("recorded: %u draws, %u unique states, %u vertices, %u indices\n",
+            num_commands, cb.getNumStates(), cb.getNumVertices(), cb.getNumIndices());
+
+    // what renderer used to do: one draw per call
+    ReplayStats unsorted;
+    std::vector<gosCommandBuffer::Batch> batches = cb.build(false);
+    if(!check_order(cb) || !replay(cb, batches, unsorted))
+        return 1;
+
+    VisibleFrame issued;
+    rasterize(cb, false, issued);
+
+    ReplayStats sorted;
+    batches = cb.build(true);
+    if(!check_order(cb) || !replay(cb, batches, sorted))
+        return 1;
+
+    VisibleFrame reordered;
+    rasterize(cb, true, reordered);
+    uint32_t changed = count_changed_pixels(issued, reordered);
+    if(changed) {
+        printf("FAILED: sorting changed which draw is visible at %u of %d pixels\n", changed, issued.w * issued.h);
+        return 1;
+    }
+
+    printf("merged only:     %u draws, %u state changes\n", unsorted.draws, unsorted.state_changes);
+    printf("sorted + merged: %u draws, %u state changes\n", sorted.draws, sorted.state_changes);
+
+    if(sorted.vertices != cb.getNumVertices() || sorted.indices != cb.getNumIndices()) {
+        printf("FAILED: not every recorded vertex/index was drawn\n");
+        return 1;
+    }
+
+    if(sorted.draws > unsorted.draws) {
+        printf("FAILED: sorting increased number of draws\n");
+        return 1;
+    }
+
+    if(num_commands > 1 && sorted.draws >= num_commands) {
+        printf("FAILED: draw count did not drop (%u draws for %u recorded)\n", sorted.draws, num_commands);
+        return 1;
+    }
+
+    printf("OK: %u -> %u draws\n", num_commands, sorted.draws);
+    return 0;
+}
@@ -0,0 +1,310 @@
+#include <queue>
+#include <vector>
+#include <string>
+#include <chrono>
+#include "gameos.hpp"
+#include "toolos.hpp"
+
+#include "mclib.h"
+#include "datacache.h"
+#include <stdio.h>
+#include <ctype.h>
+
+
+UserHeapPtr systemHeap = NULL;
+FastFile** fastFiles = NULL;
+long numFastFiles = 0;
+long maxFastFiles = 0;
+
+void usage(char** argv) {
+    printf("%s [-n iterations] [-nocache] <-p data_path>\n", argv[0]);
+    printf("\\t-p - directory which is searched recursively for .fit files\n");
+    printf("\\t-n - how many times every file is opened and fully read (default 1)\n");
+    printf("\\t-nocache - always parse the text, ignore (and don't write) data caches\n");
+}
+
+struct FitKey {
+    std::string block;
+    std::string type;
+    std::string name;
+};
+
+struct BenchStats {
+    size_t files;
+    size_t badFiles;
+    size_t blocks;
+    size_t reads;
+    size_t failedReads;
+    double openMs;
+    double readMs;
+};
+
+static bool has_fit_extension(const char* fname)
+{
+    size_t len = strlen(fname);
+    return len > 4 && 0 == S_stricmp(fname + len - 4, ".fit");
+}
+
+// Pull every "type name = ..." line out of the raw text, so that the benchmark issues the same
+// lookups the game would without knowing anything about what a particular file describes
+static void collect_keys(const char* fname, std::vector<FitKey>& keys)
+{
+    FILE* fh = fopen(fname, "rb");
+    if(!fh)
+        return;
+
+    std::string block;
+    char line[2048];
+    while(fgets(line, sizeof(line), fh)) {
+        if(line[0] == '[') {
+            char* end = strchr(line, ']');
+            if(end)
+                block.assign(line + 1, end - line - 1);
+            continue;
+        }
+
+        if(block.empty() || !isalpha((unsigned char)line[0]))
+            continue;
+
+        const char* p = line;
+        const char* type_start = p;
+        while(*p && !isspace((unsigned char)*p) && *p != '[')
+            ++p;
+        std::string type(type_start, p - type_start);
+        bool is_array = false;
+        if(*p == '[') {
+            is_array = true;
+            while(*p && *p != ']')
+                ++p;
+            if(*p)
+                ++p;
+        }
+        if(type.size() > 3 || !isspace((unsigned char)*p))
+            continue;
+
+        while(*p && isspace((unsigned char)*p))
+            ++p;
+        const char* name_start = p;
+        while(*p && !isspace((unsigned char)*p) && *p != '=')
+            ++p;
+        if(p == name_start)
+            continue;
+
+        FitKey key;
+        key.block = block;
+        key.type = is_array ? type + "[]" : type;
+        key.name.assign(name_start, p - name_start);
+        keys.push_back(key);
+    }
+    fclose(fh);
+}
+
+static long read_key(FitIniFile& fit, const FitKey& key)
+{
+    const char* t = key.type.c_str();
+    const char* n = key.name.c_str();
+
+    if(0 == S_stricmp(t, "f")) { float v; return fit.readIdFloat(n, v); }
+    if(0 == S_stricmp(t, "l")) { long v; return fit.readIdLong(n, v); }
+    if(0 == S_stricmp(t, "ul")) { DWORD v; return fit.readIdULong(n, v); }
+    if(0 == S_stricmp(t, "s")) { short v; return fit.readIdShort(n, v); }
+    if(0 == S_stricmp(t, "us")) { unsigned short v; return fit.readIdUShort(n, v); }
+    if(0 == S_stricmp(t, "c")) { char v; return fit.readIdChar(n, v); }
+    if(0 == S_stricmp(t, "uc")) { unsigned char v; return fit.readIdUChar(n, v); }
+    if(0 == S_stricmp(t, "b")) { bool v; return fit.readIdBoolean(n, v); }
+    if(0 == S_stricmp(t, "st")) {
+        char v[1024];
+        if(fit.getIdStringLength(n) < 0)
+            return -1;
+        return fit.readIdString(n, v, sizeof(v) - 1);
+    }
+
+    // arrays: ask for the element count first, same as the game code does
+    static const unsigned long MAX_ELEMENTS = 4096;
+    static double scratch[MAX_ELEMENTS];
+    unsigned long count = 0;
+    if(0 == S_stricmp(t, "f[]")) {
+        count = fit.getIdFloatArrayElements(n);
+        return count > MAX_ELEMENTS ? -1 : fit.readIdFloatArray(n, (float*)scratch, count);
+    }
+    if(0 == S_stricmp(t, "l[]")) {
+        count = fit.getIdLongArrayElements(n);
+        return count > MAX_ELEMENTS / 2 ? -1 : fit.readIdLongArray(n, (long*)scratch, count);
+    }
+    if(0 == S_stricmp(t, "ul[]")) {
+        count = fit.getIdULongArrayElements(n);
+        return count > MAX_ELEMENTS / 2 ? -1 : fit.readIdULongArray(n, (unsigned long*)scratch, count);
+    }
+    if(0 == S_stricmp(t, "s[]")) {
+        count = fit.getIdShortArrayElements(n);
+        return count > MAX_ELEMENTS ? -1 : fit.readIdShortArray(n, (short*)scratch, count);
+    }
+    if(0 == S_stricmp(t, "us[]")) {
+        count = fit.getIdUShortArrayElements(n);
+        return count > MAX_ELEMENTS ? -1 : fit.readIdUShortArray(n, (unsigned short*)scratch, count);
+    }
+    if(0 == S_stricmp(t, "c[]")) {
+        count = fit.getIdCharArrayElements(n);
+        return count > MAX_ELEMENTS ? -1 : fit.readIdCharArray(n, (char*)scratch, count);
+    }
+    if(0 == S_stricmp(t, "uc[]")) {
+        count = fit.getIdUCharArrayElements(n);
+        return count > MAX_ELEMENTS ? -1 : fit.readIdUCharArray(n, (unsigned char*)scratch, count);
+    }
+
+    // type the parser does not know about (e.g. "d"), not counted
+    return NO_ERR;
+}
+
+static void bench_file(const char* fname, int iterations, BenchStats& stats)
+{
+    std::vector<FitKey> keys;
+    collect_keys(fname, keys);
+
+    for(int it=0; it<iterations; ++it) {
+        FitIniFile fit;
+
+        auto t0 = std::chrono::steady_clock::now();
+        long result = fit.open(fname);
+        auto t1 = std::chrono::steady_clock::now();
+        stats.openMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+        if(result != NO_ERR) {
+            if(it == 0) {
+                printf("Failed to open %s (0x%lx)\n", fname, result);
+                stats.badFiles++;
+            }
+            return;
+        }
+
+        const char* cur_block = nullptr;
+        size_t reads = 0;
+        size_t failed = 0;
+
+        t0 = std::chrono::steady_clock::now();
+        for(size_t i=0; i<fit.getNumBlocks(); ++i)
+            fit.seekBlock(fit.getBlockId(i));
+
+        for(size_t i=0; i<keys.size(); ++i) {
+            if(!cur_block || keys[i].block != cur_block) {
+                cur_block = keys[i].block.c_str();
+                if(fit.seekBlock(cur_block) != NO_ERR) {
+                    cur_block = nullptr;
+                    continue;
+                }
+            }
+            reads++;
+            if(read_key(fit, keys[i]) != NO_ERR) {
+                if(it == 0)
+                    printf("%s: [%s] %s %s not found\n", fname, keys[i].block.c_str(), keys[i].type.c_str(), keys[i].name.c_str());
+                failed++;
+            }
+        }
+        t1 = std::chrono::steady_clock::now();
+        stats.readMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+        if(it == 0) {
+            stats.files++;
+            stats.blocks += fit.getNumBlocks();
+            stats.reads += reads;
+            stats.failedReads += failed;
+        }
+
+        fit.close();
+    }
+}
+
+int bench(const char* in_path, int iterations)
+{
+    std::queue<char*> dirs2process;
+    BenchStats stats = {0};
+
+    char* findString = new char[strlen(in_path) + 1];
+    strcpy(findString, in_path);
+    dirs2process.push(findString);
+
+    while(!dirs2process.empty()) {
+
+        char* cur_dir = dirs2process.front();
+        dirs2process.pop();
+
+        char* cur_search_path = new char[strlen(cur_dir) + strlen(PATH_SEPARATOR) + strlen("*") + 1];
+        sprintf(cur_search_path, "%s" PATH_SEPARATOR "*", cur_dir);
+
+        WIN32_FIND_DATA	findResult;
+        HANDLE searchHandle = FindFirstFile(cur_search_path, &findResult);
+        if (searchHandle != INVALID_HANDLE_VALUE)
+        {
+            do
+            {
+                char* filename = new char[strlen(cur_dir) + strlen(PATH_SEPARATOR) + strlen(findResult.cFileName) + 1];
+                sprintf(filename, "%s" PATH_SEPARATOR "%s", cur_dir, findResult.cFileName);
+
+                if ((findResult.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+                {
+                    if(has_fit_extension(findResult.cFileName))
+                        bench_file(filename, iterations, stats);
+                    delete[] filename;
+                } else {
+                    if(strcmp(findResult.cFileName, ".") && strcmp(findResult.cFileName, ".."))
+                        dirs2process.push(filename);
+                    else
+                        delete[] filename;
+                }
+            } while (FindNextFile(searchHandle, &findResult) != 0);
+
+            FindClose(searchHandle);
+        }
+
+        delete[] cur_search_path;
+        delete[] cur_dir;
+    }
+
+    printf("files: %zu (%zu failed to open)\n", stats.files, stats.badFiles);
+    printf("blocks: %zu, reads: %zu (%zu failed)\n", stats.blocks, stats.reads, stats.failedReads);
+    printf("iterations: %d, caches loaded: %ld, written: %ld, rejected: %ld\n", iterations, DataCacheFile::numLoaded, DataCacheFile::numWritten, DataCacheFile::numRejected);
+    printf("open: %.3f ms total, %.3f ms per pass\n", stats.openMs, stats.openMs / iterations);
+    printf("read: %.3f ms total, %.3f ms per pass\n", stats.readMs, stats.readMs / iterations);
+
+    return (stats.badFiles || stats.failedReads) ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+    const char* in_path = nullptr;
+    int iterations = 1;
+
+    if(argc < 2) {
+        usage(argv);
+        return 1;
+    }
+
+    systemHeap = new UserHeap();
+    if(!systemHeap) {
+        STOP(("Failed to initialize system heap"));
+        return -1;
+    }
+    systemHeap->init(32*1024*1024);
+
+    for(int i=1;i<argc;++i) {
+        if(0 == strcmp(argv[i], "-p") && i+1 < argc) {
+           in_path = argv[i+1];
+           ++i;
+        }
+
+        if(0 == strcmp(argv[i], "-n") && i+1 < argc) {
+           iterations = atoi(argv[i+1]);
+           ++i;
+        }
+
+        if(0 == strcmp(argv[i], "-nocache"))
+            DataCacheFile::useDataCache = false;
+    }
+
+    if(!in_path || iterations < 1) {
+        usage(argv);
+        return 1;
+    }
+
+    return bench(in_path, iterations);
+}
@@ -0,0 +1,172 @@
+#include <vector>
+#include <chrono>
+#include "gameos.hpp"
+#include "toolos.hpp"
+#include "paths.h"
+
+#include <stuff/stuff.hpp>
+#include <mlr/mlr.hpp>
+#include <gosfx/gosfxheaders.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Spawns a number of effects from the effect library and times how long it takes to
+// execute them (particle aging, motion and curve evaluation), nothing is drawn.
+
+void usage(char** argv) {
+    printf("%s <-f mc2.fx> [-n effects] [-frames frames] [-e effect_name]\n", argv[0]);
+    printf("\t-f - effect library, usually data/effects/mc2.fx\n");
+    printf("\t-n - number of effects executed every frame (default 100)\n");
+    printf("\t-frames - number of simulated frames (default 300)\n");
+    printf("\t-e - only spawn this effect, otherwise all library effects are used in turn\n");
+}
+
+static const Stuff::Scalar FRAME_TIME = 1.0f / 30.0f;
+
+static bool load_library(const char* fname)
+{
+    FILE* fh = fopen(fname, "rb");
+    if(!fh) {
+        printf("Failed to open %s\n", fname);
+        return false;
+    }
+    fseek(fh, 0, SEEK_END);
+    long size = ftell(fh);
+    fseek(fh, 0, SEEK_SET);
+
+    std::vector<unsigned char> data(size > 0 ? size : 1);
+    bool ok = size > 0 && fread(&data[0], 1, size, fh) == (size_t)size;
+    fclose(fh);
+    if(!ok) {
+        printf("Failed to read %s\n", fname);
+        return false;
+    }
+
+    gos_PushCurrentHeap(gosFX::Heap);
+    gosFX::EffectLibrary::Instance = new gosFX::EffectLibrary();
+    Check_Object(gosFX::EffectLibrary::Instance);
+    Stuff::MemoryStream stream(&data[0], size);
+    gosFX::EffectLibrary::Instance->Load(&stream);
+    gosFX::LightManager::Instance = new gosFX::LightManager();
+    gos_PopCurrentHeap();
+    return true;
+}
+
+static void start_effect(gosFX::Effect* effect, Stuff::Time now, const Stuff::LinearMatrix4D& origin)
+{
+    gosFX::Effect::ExecuteInfo info(now, &origin, NULL);
+    effect->Start(&info);
+}
+
+int main(int argc, char** argv)
+{
+    const char* fx_file = nullptr;
+    const char* effect_name = nullptr;
+    int num_effects = 100;
+    int num_frames = 300;
+
+    for(int i=1;i<argc;++i) {
+        if(0 == strcmp(argv[i], "-f") && i+1 < argc) {
+            fx_file = argv[++i];
+        } else if(0 == strcmp(argv[i], "-n") && i+1 < argc) {
+            num_effects = atoi(argv[++i]);
+        } else if(0 == strcmp(argv[i], "-frames") && i+1 < argc) {
+            num_frames = atoi(argv[++i]);
+        } else if(0 == strcmp(argv[i], "-e") && i+1 < argc) {
+            effect_name = argv[++i];
+        } else {
+            usage(argv);
+            return 1;
+        }
+    }
+
+    if(!fx_file || num_effects < 1 || num_frames < 1) {
+        usage(argv);
+        return 1;
+    }
+
+    Stuff::InitializeClasses();
+    MidLevelRenderer::InitializeClasses(8192*4,8192,0,0,true);
+    gosFX::InitializeClasses();
+
+    // effects with textured states look their textures up while loading,
+    // images themselves are only loaded when something gets drawn
+    gos_PushCurrentHeap(MidLevelRenderer::Heap);
+    MidLevelRenderer::TGAFilePool *pool = new MidLevelRenderer::TGAFilePool("data" PATH_SEPARATOR "tgl" PATH_SEPARATOR "128" PATH_SEPARATOR);
+    MidLevelRenderer::MLRTexturePool::Instance = new MidLevelRenderer::MLRTexturePool(pool);
+    gos_PopCurrentHeap();
+
+    if(!load_library(fx_file))
+        return 1;
+
+    gosFX::EffectLibrary* library = gosFX::EffectLibrary::Instance;
+    std::vector<unsigned> ids;
+    if(effect_name) {
+        gosFX::Effect::Specification* spec = library->Find(effect_name);
+        if(!spec) {
+            printf("Effect %s not found in %s\n", effect_name, fx_file);
+            return 1;
+        }
+        ids.push_back(spec->m_effectID);
+    } else {
+        for(unsigned i=0; i<library->m_effects.GetLength(); ++i) {
+            if(library->m_effects[i])
+                ids.push_back(i);
+        }
+    }
+    if(ids.empty()) {
+        printf("No effects in %s\n", fx_file);
+        return 1;
+    }
+
+    // spread effects around so that world space clouds get some motion of their own
+    std::vector<gosFX::Effect*> effects(num_effects);
+    std::vector<Stuff::LinearMatrix4D> origins(num_effects);
+    Stuff::Time now = 0.0;
+    for(int i=0; i<num_effects; ++i) {
+        origins[i] = Stuff::LinearMatrix4D::Identity;
+        origins[i].BuildTranslation(Stuff::Point3D((Stuff::Scalar)(i % 32) * 10.0f, 0.0f, (Stuff::Scalar)(i / 32) * 10.0f));
+        effects[i] = library->MakeEffect(ids[i % ids.size()], gosFX::Effect::ExecuteFlag|gosFX::Effect::LoopFlag);
+        Check_Object(effects[i]);
+        start_effect(effects[i], now, origins[i]);
+    }
+
+    double total_ms = 0.0;
+    double worst_ms = 0.0;
+    int restarts = 0;
+    for(int frame=0; frame<num_frames; ++frame) {
+        now += FRAME_TIME;
+        const Stuff::Scalar wobble = Stuff::Sin((Stuff::Scalar)now);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for(int i=0; i<num_effects; ++i) {
+            origins[i](3,1) = wobble;
+            Stuff::OBB bounds(Stuff::OBB::Identity);
+            gosFX::Effect::ExecuteInfo info(now, &origins[i], &bounds);
+            if(!effects[i]->Execute(&info)) {
+                effects[i]->Kill();
+                start_effect(effects[i], now, origins[i]);
+                ++restarts;
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        total_ms += ms;
+        if(ms > worst_ms)
+            worst_ms = ms;
+    }
+
+    printf("%d effects (%d kinds), %d frames, %d restarts\n", num_effects, (int)ids.size(), num_frames, restarts);
+    printf("execute: %.3f ms total, %.3f ms/frame avg, %.3f ms/frame worst, %.2f us/effect\n",
+            total_ms, total_ms / num_frames, worst_ms, 1000.0 * total_ms / ((double)num_frames * num_effects));
+
+    for(int i=0; i<num_effects; ++i)
+        delete effects[i];
+
+    gosFX::TerminateClasses();
+    MidLevelRenderer::TerminateClasses();
+    Stuff::TerminateClasses();
+    return 0;
+}
@@ -0,0 +1,607 @@
+#include <vector>
+#include <chrono>
+#include "gameos.hpp"
+#include "toolos.hpp"
+
+#include "mclib.h"
+#include "move.h"
+#include "pqueue.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Runs jump point search (MoveMap::calcJumpPointPath) and the old search over the
+// same seeded move maps: walls with gaps, buildings, forests, water, roads, path
+// locks and parked movers.  Each map is searched three ways: old search only, jump
+// point search as movers use it (linked path), and with JumpPointCheck on, as
+// -jpscheck does in game.  Fails if any jump point path costs more than the old
+// one, or if the path handed back steps onto anything blocked.
+// -map does the same on windows of a mission's real move map, set up through
+// MoveMap::setUp the way Mover::setUpSimplePath does it, with jump point search
+// forced on for windows where setUp itself would not have picked it.
+// -pqtrace records the open list traffic of all those searches for pqbench.
+
+UserHeapPtr systemHeap = NULL;
+
+static const int MAP_DIM = 43;      // simple path map, SimpleMovePathRange * 2 + 1
+
+static const int CELL_CLEAR = 0;
+static const int CELL_WALL = 1;
+static const int CELL_FOREST = 2;
+static const int CELL_WATER = 3;
+static const int CELL_ROAD = 4;
+static const int CELL_PATHLOCK = 5;
+static const int CELL_MOVER = 6;
+
+void usage(char** argv) {
+    printf("%s [-n maps] [-s seed] [-pqtrace file] [-map mission.pak]...\n", argv[0]);
+    printf("\t-n - number of maps searched, or windows per mission with -map (default 2000)\n");
+    printf("\t-s - seed of the first map, or of the windows with -map (default 1)\n");
+    printf("\t-map - search windows of the move map in a mission's pak file instead, may be repeated\n");
+    printf("\t-pqtrace - record open list traffic to file\n");
+}
+
+static FILE* g_pqtrace = NULL;
+
+static void record_pq(int op, int32_t key, uint32_t id)
+{
+    PQTraceRecord rec = { op, key, id };
+    fwrite(&rec, sizeof(rec), 1, g_pqtrace);
+}
+
+static unsigned int g_seed = 1;
+
+static int irand(int lo, int hi)
+{
+    g_seed = g_seed * 1664525 + 1013904223;
+    return lo + (int)((g_seed >> 8) % (unsigned int)(hi - lo + 1));
+}
+
+struct TestMap {
+    int width, height;
+    int clear_cost;
+    bool water_mover;               // water costs clearCost instead of being blocked
+    std::vector<unsigned char> cells;
+    int start_r, start_c;
+    int goal_r, goal_c;
+
+    unsigned char& at(int r, int c) { return cells[r * width + c]; }
+};
+
+static void fill_rect(TestMap& m, int r0, int c0, int h, int w, unsigned char type)
+{
+    for(int r=r0; r<r0+h && r<m.height; ++r)
+        for(int c=c0; c<c0+w && c<m.width; ++c)
+            m.at(r, c) = type;
+}
+
+static void fill_blob(TestMap& m, unsigned char type, int size)
+{
+    int r = irand(0, m.height - 1);
+    int c = irand(0, m.width - 1);
+    for(int i=0; i<size; ++i) {
+        m.at(r, c) = type;
+        r += irand(-1, 1);
+        c += irand(-1, 1);
+        if(r < 0) r = 0;
+        if(c < 0) c = 0;
+        if(r >= m.height) r = m.height - 1;
+        if(c >= m.width) c = m.width - 1;
+    }
+}
+
+// Mostly open ground, like the maps jump point search gets used on, but some
+// of them crowded enough that the old search has to do the work.
+static void make_map(TestMap& m)
+{
+    m.width = irand(12, MAP_DIM);
+    m.height = irand(12, MAP_DIM);
+    m.clear_cost = irand(8, 60);
+    m.water_mover = irand(0, 4) == 0;
+    m.cells.assign(m.width * m.height, CELL_CLEAR);
+
+    const int density = irand(0, 3);
+
+    // long walls with a gap or two, the ones jump points have to turn around
+    const int num_walls = irand(0, density);
+    for(int i=0; i<num_walls; ++i) {
+        bool vertical = irand(0, 1) == 1;
+        int len = vertical ? m.height : m.width;
+        int at = irand(0, (vertical ? m.width : m.height) - 1);
+        int gap = irand(0, len - 1);
+        int gap_len = irand(1, 4);
+        for(int j=0; j<len; ++j) {
+            if(j >= gap && j < gap + gap_len)
+                continue;
+            if(vertical) m.at(j, at) = CELL_WALL;
+            else m.at(at, j) = CELL_WALL;
+        }
+    }
+
+    const int num_buildings = irand(0, 4 + density * 4);
+    for(int i=0; i<num_buildings; ++i)
+        fill_rect(m, irand(0, m.height - 1), irand(0, m.width - 1), irand(1, 6), irand(1, 6), CELL_WALL);
+
+    const int num_forests = irand(0, 2 + density);
+    for(int i=0; i<num_forests; ++i)
+        fill_blob(m, CELL_FOREST, irand(10, 120));
+
+    const int num_lakes = irand(0, 1 + density);
+    for(int i=0; i<num_lakes; ++i)
+        fill_blob(m, CELL_WATER, irand(10, 80));
+
+    const int num_roads = irand(0, 2);
+    for(int i=0; i<num_roads; ++i) {
+        if(irand(0, 1))
+            fill_rect(m, irand(0, m.height - 1), 0, irand(1, 2), m.width, CELL_ROAD);
+        else
+            fill_rect(m, 0, irand(0, m.width - 1), m.height, irand(1, 2), CELL_ROAD);
+    }
+
+    // another mover's path, and a few parked ones
+    const int num_locks = irand(0, 2);
+    for(int i=0; i<num_locks; ++i)
+        fill_blob(m, CELL_PATHLOCK, irand(5, 30));
+
+    const int num_movers = irand(0, 4 + density * 4);
+    for(int i=0; i<num_movers; ++i)
+        m.at(irand(0, m.height - 1), irand(0, m.width - 1)) = CELL_MOVER;
+
+    // start and goal somewhere we can stand, and not on top of each other
+    do {
+        m.start_r = irand(0, m.height - 1);
+        m.start_c = irand(0, m.width - 1);
+    } while(m.at(m.start_r, m.start_c) == CELL_WALL || m.at(m.start_r, m.start_c) == CELL_MOVER);
+    do {
+        m.goal_r = irand(0, m.height - 1);
+        m.goal_c = irand(0, m.width - 1);
+    } while(m.at(m.goal_r, m.goal_c) == CELL_WALL || m.at(m.goal_r, m.goal_c) == CELL_MOVER ||
+            (m.goal_r == m.start_r && m.goal_c == m.start_c));
+}
+
+// A simple path search on a mission map: the window around the start a mover
+// would search, and how that mover moves.
+struct MapWindow {
+    long ULr, ULc;
+    long start_r, start_c;          // mission map cells
+    long goal_r, goal_c;            // cells in the window
+    long level;
+    long clear_cost;
+    unsigned long params;
+};
+
+// The searches change costs and flags as they go, so every run starts from a
+// fresh copy of the test map, set up the way MoveMap::setUp and
+// PlaceStationaryMovers would have left it.
+class TestMoveMap : public MoveMap {
+    public:
+        void setUpTest(const TestMap& m, bool jumpPoints)
+        {
+            if(!map)
+                init(MAP_DIM, MAP_DIM);
+            width = m.width;
+            height = m.height;
+            clear();
+
+            ULr = ULc = 0;
+            minRow = minCol = 0;
+            maxRow = m.height - 1;
+            maxCol = m.width - 1;
+            moveLevel = 0;
+            thruAreas[0] = thruAreas[1] = -1;
+            travelOffMap = false;
+            cannotEnterOffMap = true;
+            setClearCost(m.clear_cost);
+            setJumpCost(0, 8);
+            setMover(0);
+
+            Stuff::Vector3D goalPos(0.0f, 0.0f, 0.0f);
+            setStart(NULL, m.start_r, m.start_c);
+            setGoal(goalPos, m.goal_r, m.goal_c);
+
+            long pathLockCost = m.clear_cost << 3;
+            for(int r=0; r<m.height; ++r) {
+                for(int c=0; c<m.width; ++c) {
+                    MoveMapNodePtr node = &map[r * maxWidth + c];
+                    switch(m.cells[r * m.width + c]) {
+                        case CELL_CLEAR:    node->cost = m.clear_cost; break;
+                        case CELL_WALL:     node->cost = COST_BLOCKED; break;
+                        case CELL_FOREST:   node->cost = m.clear_cost + forestCost; break;
+                        case CELL_WATER:    node->cost = m.water_mover ? m.clear_cost : COST_BLOCKED; break;
+                        case CELL_ROAD:     node->cost = m.clear_cost >> 2; break;
+                        case CELL_PATHLOCK: node->cost = m.clear_cost + pathLockCost; break;
+                        case CELL_MOVER:
+                            node->cost = m.clear_cost + COST_BLOCKED * 2;
+                            node->setFlag(MOVEFLAG_MOVER_HERE);
+                            break;
+                    }
+                    if(node->cost < 1)
+                        node->cost = 1;
+                }
+            }
+
+            jumpPointSearch = jumpPoints;
+            prepareSearch();
+            map[goalR * maxWidth + goalC].setFlag(MOVEFLAG_GOAL);
+        }
+
+        // Returns whether setUp picked jump point search for the window itself.
+        bool setUpWindow(const MapWindow& w, bool jumpPoints)
+        {
+            Stuff::Vector3D goalPos(0.0f, 0.0f, 0.0f);
+            setMover(0);
+            setUp(w.ULr, w.ULc, MAP_DIM, MAP_DIM, w.level, NULL, w.start_r, w.start_c, goalPos,
+                  w.goal_r, w.goal_c, w.clear_cost, 0, 8, w.params | (jumpPoints ? MOVEPARAM_JUMP_POINTS : 0));
+            bool picked = jumpPointSearch;
+            if(jumpPoints && !jumpPointSearch) {
+                jumpPointSearch = true;
+                prepareSearch();
+            }
+            return picked;
+        }
+
+        bool cellOpen(long r, long c)
+        {
+            return r >= 0 && r < height && c >= 0 && c < width && map[r * maxWidth + c].cost < COST_BLOCKED;
+        }
+};
+
+static bool cell_blocked(const TestMap& m, int r, int c)
+{
+    unsigned char type = m.cells[r * m.width + c];
+    return type == CELL_WALL || type == CELL_MOVER || (type == CELL_WATER && !m.water_mover);
+}
+
+// Every step has to be next to the one before it, on something we can walk on,
+// and the last one has to be the goal.
+static bool check_path(const TestMap& m, MovePathPtr path)
+{
+    int r = m.start_r;
+    int c = m.start_c;
+    for(long i=0; i<path->numSteps; ++i) {
+        int nr = path->stepList[i].cell[0];
+        int nc = path->stepList[i].cell[1];
+        if(abs(nr - r) > 1 || abs(nc - c) > 1 || (nr == r && nc == c)) {
+            printf("step %ld jumps from [%d, %d] to [%d, %d]\n", i, r, c, nr, nc);
+            return false;
+        }
+        if(nr < 0 || nr >= m.height || nc < 0 || nc >= m.width || cell_blocked(m, nr, nc)) {
+            printf("step %ld is on blocked cell [%d, %d]\n", i, nr, nc);
+            return false;
+        }
+        r = nr;
+        c = nc;
+    }
+    if(r != m.goal_r || c != m.goal_c) {
+        printf("path ends at [%d, %d], goal is [%d, %d]\n", r, c, m.goal_r, m.goal_c);
+        return false;
+    }
+    return true;
+}
+
+// Same as check_path, against the costs setUp gave the window.
+static bool check_window_path(TestMoveMap* mm, const MapWindow& w, MovePathPtr path)
+{
+    long r = w.start_r;
+    long c = w.start_c;
+    for(long i=0; i<path->numSteps; ++i) {
+        long nr = path->stepList[i].cell[0];
+        long nc = path->stepList[i].cell[1];
+        if(labs(nr - r) > 1 || labs(nc - c) > 1 || (nr == r && nc == c)) {
+            printf("step %ld jumps from [%ld, %ld] to [%ld, %ld]\n", i, r, c, nr, nc);
+            return false;
+        }
+        if(!mm->cellOpen(nr - w.ULr, nc - w.ULc)) {
+            printf("step %ld is on blocked cell [%ld, %ld]\n", i, nr, nc);
+            return false;
+        }
+        r = nr;
+        c = nc;
+    }
+    if(r != w.ULr + w.goal_r || c != w.ULc + w.goal_c) {
+        printf("path ends at [%ld, %ld], goal is [%ld, %ld]\n", r, c, w.ULr + w.goal_r, w.ULc + w.goal_c);
+        return false;
+    }
+    return true;
+}
+
+static double now_ms()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+}
+
+struct Totals {
+    long searches;
+    long num_paths;
+    long num_no_path;
+    long failures;
+    double old_ms;
+    double jps_ms;
+};
+
+// Searches whatever setUp(jumpPoints) leaves in the move map three ways: old
+// search only, jump point search as movers run it (linked path), and with
+// JumpPointCheck on, as -jpscheck does in game.
+template <class SetUp, class Check>
+static void compare_searches(TestMoveMap* mm, MovePathPtr path, SetUp setUp, Check check, const char* what, Totals& totals)
+{
+    Stuff::Vector3D goalWorldPos;
+    int goalCell[2];
+
+    // old search only
+    setUp(false);
+    path->init();
+    double start = now_ms();
+    mm->calcPath(path, &goalWorldPos, goalCell);
+    totals.old_ms += now_ms() - start;
+    long old_cost = path->numSteps ? path->cost : -1;
+
+    // jump point search, as movers run it
+    setUp(true);
+    path->init();
+    start = now_ms();
+    mm->calcPath(path, &goalWorldPos, goalCell);
+    totals.jps_ms += now_ms() - start;
+    long jps_cost = path->numSteps ? path->cost : -1;
+    bool ok = true;
+    if(jps_cost != old_cost) {
+        if(jps_cost < 0 || (old_cost > -1 && jps_cost > old_cost)) {
+            printf("%s: jump point path costs %ld, old search %ld\n", what, jps_cost, old_cost);
+            ok = false;
+        }
+    }
+    if(jps_cost > -1 && !check(path)) {
+        printf("%s: bad jump point path\n", what);
+        ok = false;
+    }
+
+    // and the way -jpscheck does it, which compares before linking
+    setUp(true);
+    path->init();
+    JumpPointCheck = true;
+    long worse = JumpPointWorse;
+    mm->calcPath(path, &goalWorldPos, goalCell);
+    JumpPointCheck = false;
+    if(JumpPointWorse != worse) {
+        printf("%s: -jpscheck counts the jump point path as worse\n", what);
+        ok = false;
+    }
+
+    ++totals.searches;
+    if(old_cost < 0)
+        ++totals.num_no_path;
+    else
+        ++totals.num_paths;
+    if(!ok)
+        ++totals.failures;
+}
+
+static void run_test_maps(TestMoveMap* mm, MovePathPtr path, int num_maps, unsigned int first_seed, Totals& totals)
+{
+    // calcPath looks up the area of every step it hands back
+    GlobalMap* globalMap = new GlobalMap;
+    globalMap->init();
+    globalMap->width = globalMap->height = MAP_DIM;
+    globalMap->areaMap = (short*)systemHeap->Malloc(MAP_DIM * MAP_DIM * sizeof(short));
+    for(int i=0; i<MAP_DIM * MAP_DIM; ++i)
+        globalMap->areaMap[i] = -1;
+    GlobalMoveMap[0] = globalMap;
+
+    for(int n=0; n<num_maps; ++n) {
+        unsigned int seed = first_seed + n;
+        g_seed = seed;
+        TestMap m;
+        make_map(m);
+
+        char what[32];
+        sprintf(what, "seed %u", seed);
+        compare_searches(mm, path,
+                         [&](bool jumpPoints) { mm->setUpTest(m, jumpPoints); },
+                         [&](MovePathPtr p) { return check_path(m, p); },
+                         what, totals);
+    }
+
+    delete globalMap;
+    GlobalMoveMap[0] = NULL;
+}
+
+static bool gate_disabled(int objectWID)
+{
+    return false;
+}
+
+// Loads the move data the way Mission::init does.  MissionMap::init fills in
+// Terrain's cell to world tables, which the terrain has allocated by then.
+static bool load_mission(const char* name)
+{
+    PacketFile pakFile;
+    if(pakFile.open(name) != NO_ERR) {
+        printf("can't open %s\n", name);
+        return false;
+    }
+    if(pakFile.seekPacket(4) != NO_ERR || pakFile.getPacketSize() == 0) {
+        printf("%s has no move data\n", name);
+        return false;
+    }
+
+    int32_t cells = 0;
+    pakFile.readPacket(4, (unsigned char*)&cells);
+    if(cells < MAPCELL_DIM || cells > MAX_MAP_CELL_WIDTH) {
+        printf("%s: bad map size %d\n", name, cells);
+        return false;
+    }
+    if(!Terrain::tileRowToWorldCoord) {
+        Terrain::tileRowToWorldCoord = (float*)systemHeap->Malloc(sizeof(float) * MAX_MAP_CELL_WIDTH / MAPCELL_DIM);
+        Terrain::tileColToWorldCoord = (float*)systemHeap->Malloc(sizeof(float) * MAX_MAP_CELL_WIDTH / MAPCELL_DIM);
+        Terrain::cellToWorldCoord = (float*)systemHeap->Malloc(sizeof(float) * MAPCELL_DIM);
+        Terrain::cellRowToWorldCoord = (float*)systemHeap->Malloc(sizeof(float) * MAX_MAP_CELL_WIDTH);
+        Terrain::cellColToWorldCoord = (float*)systemHeap->Malloc(sizeof(float) * MAX_MAP_CELL_WIDTH);
+    }
+    Terrain::realVerticesMapSide = cells / MAPCELL_DIM;
+    Terrain::worldUnitsMapSide = Terrain::realVerticesMapSide * Terrain::worldUnitsPerVertex;
+
+    MOVE_readData(&pakFile, 4);
+    if(GlobalMoveMap[0]->badLoad) {
+        printf("%s: old version of move data\n", name);
+        return false;
+    }
+    for(int i=0; i<3; ++i)
+        GlobalMoveMap[i]->isGateDisabledCallback = gate_disabled;
+    return true;
+}
+
+// Windows around random starts on the mission map, for a random mover: mechs
+// wade shallow water, hovercraft cross any, some follow roads.  Clear costs
+// cover the speeds from setUpSimplePath.
+static void run_mission(TestMoveMap* mm, MovePathPtr path, const char* name, int num_windows, unsigned int seed, Totals& totals)
+{
+    g_seed = seed;
+    long picked = 0, skipped = 0;
+    Totals mission;
+    memset(&mission, 0, sizeof(mission));
+
+    for(int n=0; n<num_windows; ++n) {
+        MapWindow w;
+        w.level = irand(0, 3) ? 0 : 1;
+        w.clear_cost = irand(14, 85);
+        w.params = 0;
+        if(w.level == 1)
+            w.params |= MOVEPARAM_WATER_SHALLOW + MOVEPARAM_WATER_DEEP;
+        else if(irand(0, 2))
+            w.params |= MOVEPARAM_WATER_SHALLOW;
+        if(irand(0, 1))
+            w.params |= MOVEPARAM_FOLLOW_ROADS;
+
+        w.start_r = irand(0, GameMap->height - 1);
+        w.start_c = irand(0, GameMap->width - 1);
+        w.ULr = w.start_r - SimpleMovePathRange;
+        if(w.ULr < 0)
+            w.ULr = 0;
+        w.ULc = w.start_c - SimpleMovePathRange;
+        if(w.ULc < 0)
+            w.ULc = 0;
+
+        // start and goal on cells the mover can stand on, inside the map
+        w.goal_r = w.start_r - w.ULr;
+        w.goal_c = w.start_c - w.ULc;
+        mm->setUpWindow(w, false);
+        long rows = GameMap->height - w.ULr < MAP_DIM ? GameMap->height - w.ULr : MAP_DIM;
+        long cols = GameMap->width - w.ULc < MAP_DIM ? GameMap->width - w.ULc : MAP_DIM;
+        if(!mm->cellOpen(w.start_r - w.ULr, w.start_c - w.ULc)) {
+            ++skipped;
+            continue;
+        }
+        int tries = 0;
+        do {
+            w.goal_r = irand(0, rows - 1);
+            w.goal_c = irand(0, cols - 1);
+        } while(++tries < 100 && (!mm->cellOpen(w.goal_r, w.goal_c) ||
+                (w.ULr + w.goal_r == w.start_r && w.ULc + w.goal_c == w.start_c)));
+        if(tries == 100) {
+            ++skipped;
+            continue;
+        }
+
+        char what[300];
+        snprintf(what, sizeof(what), "%s window %d", name, n);
+        compare_searches(mm, path,
+                         [&](bool jumpPoints) {
+                             if(mm->setUpWindow(w, jumpPoints))
+                                 ++picked;
+                         },
+                         [&](MovePathPtr p) { return check_window_path(mm, w, p); },
+                         what, mission);
+    }
+
+    // setUp runs twice with jump points for every window searched
+    printf("%s: %ld windows (%ld skipped, start or goal blocked), %ld paths, %ld without one, %ld failed, "
+           "setUp picked jump points for %ld\n",
+           name, mission.searches, skipped, mission.num_paths, mission.num_no_path, mission.failures, picked / 2);
+
+    totals.searches += mission.searches;
+    totals.num_paths += mission.num_paths;
+    totals.num_no_path += mission.num_no_path;
+    totals.failures += mission.failures;
+    totals.old_ms += mission.old_ms;
+    totals.jps_ms += mission.jps_ms;
+}
+
+int main(int argc, char** argv)
+{
+    int num_maps = 2000;
+    unsigned int first_seed = 1;
+    std::vector<const char*> missions;
+
+    for(int i=1; i<argc; ++i) {
+        if(0 == strcmp(argv[i], "-n") && i+1 < argc) {
+            num_maps = atoi(argv[++i]);
+        } else if(0 == strcmp(argv[i], "-s") && i+1 < argc) {
+            first_seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if(0 == strcmp(argv[i], "-map") && i+1 < argc) {
+            missions.push_back(argv[++i]);
+        } else if(0 == strcmp(argv[i], "-pqtrace") && i+1 < argc) {
+            g_pqtrace = fopen(argv[++i], "wb");
+            if(!g_pqtrace) {
+                printf("can't create %s\n", argv[i]);
+                return 1;
+            }
+            uint32_t trace_id = PQ_TRACE_ID;
+            fwrite(&trace_id, sizeof(trace_id), 1, g_pqtrace);
+            PriorityQueue::traceCallback = record_pq;
+        } else {
+            usage(argv);
+            return 1;
+        }
+    }
+
+    if(num_maps < 1) {
+        usage(argv);
+        return 1;
+    }
+
+    systemHeap = new UserHeap();
+    if(!systemHeap) {
+        STOP(("Failed to initialize system heap"));
+        return -1;
+    }
+    systemHeap->init(8*1024*1024);
+
+    TestMoveMap* mm = new TestMoveMap;
+    MovePathPtr path = new MovePath;
+    Totals totals;
+    memset(&totals, 0, sizeof(totals));
+
+    if(missions.empty()) {
+        run_test_maps(mm, path, num_maps, first_seed, totals);
+    } else {
+        MOVE_init(MAP_DIM / 2);
+        for(size_t m=0; m<missions.size(); ++m) {
+            if(!load_mission(missions[m])) {
+                ++totals.failures;
+                continue;
+            }
+            run_mission(mm, path, missions[m], num_maps, first_seed, totals);
+        }
+    }
+
+    long searches = totals.searches ? totals.searches : 1;
+    printf("%ld searches: %ld paths, %ld without one, %ld failed\n",
+           totals.searches, totals.num_paths, totals.num_no_path, totals.failures);
+    printf("old search %.3f ms/search, jump point search %.3f ms/search, -jpscheck %ld paths %ld worse\n",
+           totals.old_ms / searches, totals.jps_ms / searches, JumpPointChecks, JumpPointWorse);
+
+    delete path;
+    delete mm;
+
+    if(g_pqtrace) {
+        PriorityQueue::traceCallback = NULL;
+        fclose(g_pqtrace);
+    }
+
+    if(totals.failures) {
+        printf("FAILED: %ld jump point paths cost more than the old search or were broken\n", totals.failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
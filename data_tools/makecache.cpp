@@ -0,0 +1,138 @@
+#include <queue>
+#include "gameos.hpp"
+#include "toolos.hpp"
+
+#include "mclib.h"
+#include "datacache.h"
+#include <stdio.h>
+
+
+UserHeapPtr systemHeap = NULL;
+FastFile** fastFiles = NULL;
+long numFastFiles = 0;
+long maxFastFiles = 0;
+
+void usage(char** argv) {
+    printf("%s <-p data_path>\n", argv[0]);
+    printf("\\t-p - directory which is searched recursively for .fit and .csv files\n");
+    printf("\\tA data cache (.fitc/.csvc) is written next to every file whose cache is missing or out of date\n");
+}
+
+static bool has_extension(const char* fname, const char* ext)
+{
+    size_t len = strlen(fname);
+    size_t ext_len = strlen(ext);
+    return len > ext_len && 0 == S_stricmp(fname + len - ext_len, ext);
+}
+
+static long compile_file(const char* fname)
+{
+    // opening the file is enough, with writeDataCache set FitIniFile and CSVFile write the cache themselves
+    long result = -1;
+    if(has_extension(fname, ".fit")) {
+        FitIniFile fit;
+        result = fit.open(fname);
+        fit.close();
+    } else if(has_extension(fname, ".csv")) {
+        CSVFile csv;
+        result = csv.open(fname);
+        csv.close();
+    } else {
+        return 0;
+    }
+
+    if(result != NO_ERR)
+        printf("Failed to open %s (0x%lx)\n", fname, result);
+
+    return result == NO_ERR ? 1 : -1;
+}
+
+int make_cache(const char* in_path)
+{
+    std::queue<char*> dirs2process;
+    size_t num_files = 0;
+    size_t num_failed = 0;
+
+    char* findString = new char[strlen(in_path) + 1];
+    strcpy(findString, in_path);
+    dirs2process.push(findString);
+
+    while(!dirs2process.empty()) {
+
+        char* cur_dir = dirs2process.front();
+        dirs2process.pop();
+
+        char* cur_search_path = new char[strlen(cur_dir) + strlen(PATH_SEPARATOR) + strlen("*") + 1];
+        sprintf(cur_search_path, "%s" PATH_SEPARATOR "*", cur_dir);
+
+        WIN32_FIND_DATA	findResult;
+        HANDLE searchHandle = FindFirstFile(cur_search_path, &findResult);
+        if (searchHandle != INVALID_HANDLE_VALUE)
+        {
+            do
+            {
+                char* filename = new char[strlen(cur_dir) + strlen(PATH_SEPARATOR) + strlen(findResult.cFileName) + 1];
+                sprintf(filename, "%s" PATH_SEPARATOR "%s", cur_dir, findResult.cFileName);
+
+                if ((findResult.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+                {
+                    long result = compile_file(filename);
+                    if(result > 0)
+                        num_files++;
+                    else if(result < 0)
+                        num_failed++;
+                    delete[] filename;
+                } else {
+                    if(strcmp(findResult.cFileName, ".") && strcmp(findResult.cFileName, ".."))
+                        dirs2process.push(filename);
+                    else
+                        delete[] filename;
+                }
+            } while (FindNextFile(searchHandle, &findResult) != 0);
+
+            FindClose(searchHandle);
+        }
+
+        delete[] cur_search_path;
+        delete[] cur_dir;
+    }
+
+    printf("files: %zu (%zu failed to open)\n", num_files, num_failed);
+    printf("caches up to date: %ld, written: %ld, rejected: %ld\n", DataCacheFile::numLoaded, DataCacheFile::numWritten, DataCacheFile::numRejected);
+
+    return num_failed ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+    const char* in_path = nullptr;
+
+    if(argc < 2) {
+        usage(argv);
+        return 1;
+    }
+
+    systemHeap = new UserHeap();
+    if(!systemHeap) {
+        STOP(("Failed to initialize system heap"));
+        return -1;
+    }
+    systemHeap->init(32*1024*1024);
+
+    for(int i=1;i<argc;++i) {
+        if(0 == strcmp(argv[i], "-p") && i+1 < argc) {
+           in_path = argv[i+1];
+           ++i;
+        }
+    }
+
+    if(!in_path) {
+        usage(argv);
+        return 1;
+    }
+
+    DataCacheFile::useDataCache = true;
+    DataCacheFile::writeDataCache = true;
+
+    return make_cache(in_path);
+}
@@ -1,4 +1,8 @@
 #include <queue>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <zlib.h>
 #include "gameos.hpp"
 #include "toolos.hpp"
 
@@ -12,8 +16,9 @@ long numFastFiles = 0;
 long maxFastFiles = 0;
 
 void usage(char** argv) {
-    printf("%s [-d] [-c] <-f pak_file> [-p path] [-m mount_path]\n", argv[0]);
+    printf("%s [-d] [-c] [-t num_threads] <-f pak_file> [-p path] [-m mount_path]\n", argv[0]);
     printf("\\t-d - unpack\n");
+    printf("\\t-t - verify: read every file from num_threads threads at once and compare with a serial read\n");
     printf("\\t-c - compress (when packing)\n");
     printf("\\t-m - path under which files will be \"stored\" in fst\n");
 }
@@ -129,6 +134,84 @@ int unpack(const char* fst_file, const char* out_path)
     return 0;
 }
 
+// Reads every entry serially through the regular openFast/readFast path, then
+// hammers the archive from num_threads threads using the reentrant calls and
+// checks that every read gives back the same bytes.
+int verify(const char* fst_file, int num_threads)
+{
+    if(!fst_file || num_threads < 1)
+        return -1;
+
+	FastFile* ff = new FastFile;
+	if (0 != ff->open(fst_file)) {
+        PAUSE(("Error opening fast file\n"));
+        delete ff;
+		return -1;
+	}
+
+    const int numFiles = ff->getNumFiles();
+    const FILE_HANDLE* fh = ff->getFilesInfo();
+
+    std::vector<uLong> crcs(numFiles, 0);
+    std::vector<char> content;
+
+    for(int j=0; j<numFiles;++j)
+    {
+        long fHandle = ff->openFast(fh[j].pfe->hash, fh[j].pfe->name);
+        if(fHandle==-1) {
+            SPEW(("VERIFY", "Failed to find file: %s in fast file\n", fh[j].pfe->name));
+            continue;
+        }
+
+        const int file_len = ff->sizeFast(fHandle);
+        content.resize(file_len + 1);
+        ff->readFast(fHandle, &content[0], file_len);
+        ff->closeFast(fHandle);
+
+        crcs[j] = crc32(0, (const Bytef*)&content[0], file_len);
+    }
+
+    const int NUM_PASSES = 4;
+    std::atomic<int> num_reads(0);
+    std::atomic<int> num_errors(0);
+
+    std::vector<std::thread> threads;
+    for(int t=0; t<num_threads; ++t) {
+        threads.push_back(std::thread([&, t]() {
+            std::vector<char> buffer;
+            // every thread walks the archive from a different starting point
+            for(int k=0; k<numFiles*NUM_PASSES; ++k) {
+                const int j = (k + t*numFiles/num_threads) % numFiles;
+                long fIndex = ff->findFast(fh[j].pfe->hash, fh[j].pfe->name);
+                if(fIndex != j) {
+                    num_errors++;
+                    continue;
+                }
+
+                const int file_len = fh[j].pfe->realSize;
+                buffer.resize(file_len + 1);
+                if(ff->readFastEntry(fIndex, &buffer[0]) != file_len ||
+                        crc32(0, (const Bytef*)&buffer[0], file_len) != crcs[j]) {
+                    SPEW(("VERIFY", "Thread %d: mismatch reading %s\n", t, fh[j].pfe->name));
+                    num_errors++;
+                }
+                num_reads++;
+            }
+        }));
+    }
+
+    for(size_t t=0; t<threads.size(); ++t)
+        threads[t].join();
+
+    printf("%s: %d files, %d threads, %d reads, %d errors (%s)\n", fst_file, numFiles, num_threads,
+            (int)num_reads, (int)num_errors, ff->isMapped() ? "mapped" : "pread");
+
+    ff->close();
+    delete ff;
+
+    return num_errors ? 1 : 0;
+}
+
 int pack(const char* in_path, const char* fst_file, const char* mount, const char* rsp_file, bool b_compress) {
 
     if(!in_path || !fst_file)
@@ -338,6 +421,7 @@ int main(int argc, char** argv)
 
     bool b_unpack = false;
     bool b_compress = false;
+    int num_verify_threads = 0;
 
     for(int i=1;i<argc;++i) {
         if(0 == strcmp(argv[i], "-d"))
@@ -346,6 +430,11 @@ int main(int argc, char** argv)
         if(0 == strcmp(argv[i], "-c"))
             b_compress = true;
 
+        if(0 == strcmp(argv[i], "-t") && i+1 < argc) {
+           num_verify_threads = atoi(argv[i+1]);
+           ++i;
+        }
+
         if(0 == strcmp(argv[i], "-f") && i+1 < argc) {
            pak_file = argv[i+1];
            ++i;
@@ -370,6 +459,9 @@ int main(int argc, char** argv)
     // always compress, because no way to read uncompressed fast files yet
     b_compress = true;
 
+    if(num_verify_threads > 0)
+        return verify(pak_file, num_verify_threads);
+
     if(b_unpack)
         return unpack(pak_file, out_path);
     else
@@ -1,4 +1,8 @@
 #include <queue>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <zlib.h>
 #include "gameos.hpp"
 #include "toolos.hpp"
 
@@ -15,8 +19,9 @@ long maxFastFiles = 0;
 #define NULL_RECORD_STR "<NULL>"
 
 void usage(char** argv) {
-    printf("%s [-d] [-c] <-f pak_file> [-r rsp_file] [-p path]\n", argv[0]);
+    printf("%s [-d] [-c] [-t num_threads] <-f pak_file> [-r rsp_file] [-p path]\n", argv[0]);
     printf("\\t-d - unpack\n");
+    printf("\\t-t - verify: read every packet from num_threads threads at once and compare with a serial read\n");
     printf("\\t-c - compress (when packing)\n");
     printf("\\t-r - rsp file with file list\n");
 }
@@ -75,6 +80,80 @@ int unpack(const char* pak_file, const char* out_path)
     return 0;
 }
 
+// Reads every packet serially with seekPacket/readPacket, then reads them all
+// again from num_threads threads with readPacketAt and compares the results.
+int verify(const char* pak_file, int num_threads)
+{
+    if(!pak_file || num_threads < 1)
+        return -1;
+
+    PacketFile* pakFile = new PacketFile;
+    if (NO_ERR != pakFile->open(pak_file, READ, 50, true)) {
+        PAUSE(("Error opening packet file\n"));
+        delete pakFile;
+		return -1;
+	}
+
+    const int num_packets = pakFile->getNumPackets();
+
+    std::vector<int> sizes(num_packets, -1);
+    std::vector<uLong> crcs(num_packets, 0);
+    std::vector<unsigned char> packet_buffer;
+
+    for(int i=0; i<num_packets;++i) {
+        if(NO_ERR == pakFile->seekPacket(i)) {
+            const int messageSize = pakFile->getPacketSize();
+            packet_buffer.resize(messageSize + 1);
+            if(messageSize)
+                pakFile->readPacket(i, &packet_buffer[0]);
+
+            sizes[i] = messageSize;
+            crcs[i] = crc32(0, &packet_buffer[0], messageSize);
+        }
+    }
+
+    const int NUM_PASSES = 4;
+    std::atomic<int> num_reads(0);
+    std::atomic<int> num_errors(0);
+
+    std::vector<std::thread> threads;
+    for(int t=0; t<num_threads; ++t) {
+        threads.push_back(std::thread([&, t]() {
+            std::vector<unsigned char> buffer;
+            // every thread walks the file from a different starting point
+            for(int k=0; k<num_packets*NUM_PASSES; ++k) {
+                const int i = (k + t*num_packets/num_threads) % num_packets;
+                if(sizes[i] <= 0)
+                    continue;
+
+                if(pakFile->getPacketSizeAt(i) != sizes[i]) {
+                    num_errors++;
+                    continue;
+                }
+
+                buffer.resize(sizes[i]);
+                if(pakFile->readPacketAt(i, &buffer[0]) != sizes[i] ||
+                        crc32(0, &buffer[0], sizes[i]) != crcs[i]) {
+                    SPEW(("VERIFY", "Thread %d: mismatch reading packet %d\n", t, i));
+                    num_errors++;
+                }
+                num_reads++;
+            }
+        }));
+    }
+
+    for(size_t t=0; t<threads.size(); ++t)
+        threads[t].join();
+
+    printf("%s: %d packets, %d threads, %d reads, %d errors\n", pak_file, num_packets, num_threads,
+            (int)num_reads, (int)num_errors);
+
+    pakFile->close();
+    delete pakFile;
+
+    return num_errors ? 1 : 0;
+}
+
 int pack(const char* pak_file, const char* rsp_file, bool b_compress) {
 
 	if (!pak_file || !rsp_file)
@@ -259,6 +338,7 @@ int main(int argc, char** argv)
 
     bool b_unpack = false;
     bool b_compress = false;
+    int num_verify_threads = 0;
 
     for(int i=1;i<argc;++i) {
         if(0 == strcmp(argv[i], "-d"))
@@ -267,6 +347,11 @@ int main(int argc, char** argv)
         if(0 == strcmp(argv[i], "-c"))
             b_compress = true;
 
+        if(0 == strcmp(argv[i], "-t") && i+1 < argc) {
+           num_verify_threads = atoi(argv[i+1]);
+           ++i;
+        }
+
         if(0 == strcmp(argv[i], "-f") && i+1 < argc) {
            pak_file = argv[i+1];
            ++i;
@@ -292,6 +377,9 @@ int main(int argc, char** argv)
         return 1;
 	}
 
+	if(num_verify_threads > 0)
+        return verify(pak_file, num_verify_threads);
+
 	if(!rsp_file && false == b_unpack) {
         SPEW(("DBG", "No rsp file given\n"));
         usage(argv);
@@ -0,0 +1,338 @@
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include "gameos.hpp"
+#include "toolos.hpp"
+
+#include "mclib.h"
+#include "pqueue.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Replays open list traffic recorded from real searches (-pqtrace in game, or
+// jpstest -pqtrace, both record what MoveMap::calcPath and GlobalMap hand
+// their PriorityQueue) against the old binary heap with its linear find() and
+// against PriorityQueue (mclib/pqueue.cpp).  Every remove has to come back
+// with the node the search took when it was recorded.
+
+UserHeapPtr systemHeap = NULL;
+
+void usage(char** argv) {
+    printf("%s [-n passes] trace...\n", argv[0]);
+    printf("\t-n - how many times the recorded searches are replayed (default 20)\n");
+}
+
+// The queue as it was before the id index: binary heap with sentinels, and
+// find() walking the whole list.  Used as the reference.
+class OldPriorityQueue {
+    public:
+        PQNode* pqList;
+        int maxItems;
+        int numItems;
+        int keyMin;
+
+        OldPriorityQueue() : pqList(nullptr), maxItems(0), numItems(0), keyMin(0) {}
+        ~OldPriorityQueue() { free(pqList); }
+
+        void init(int max, int keyMinValue = -2000000) {
+            pqList = (PQNode*)malloc(sizeof(PQNode) * (max + 2));
+            maxItems = max + 2;
+            keyMin = keyMinValue;
+        }
+
+        void upHeap(int curIndex) {
+            PQNode startNode = pqList[curIndex];
+            long stopKey = startNode.key;
+            pqList[0].key = keyMin;
+            pqList[0].id = 0xFFFFFFFF;
+            while(pqList[curIndex/2].key >= stopKey) {
+                pqList[curIndex] = pqList[curIndex/2];
+                curIndex /= 2;
+            }
+            pqList[curIndex] = startNode;
+        }
+
+        int insert(PQNode& item) {
+            if(numItems == maxItems)
+                return 1;
+            pqList[++numItems] = item;
+            upHeap(numItems);
+            return 0;
+        }
+
+        void downHeap(int curIndex) {
+            PQNode startNode = pqList[curIndex];
+            int stopKey = startNode.key;
+            while(curIndex <= numItems/2) {
+                int nextIndex = curIndex << 1;
+                if((nextIndex < numItems) && (pqList[nextIndex].key > pqList[nextIndex + 1].key))
+                    nextIndex++;
+                if(stopKey <= pqList[nextIndex].key)
+                    break;
+                pqList[curIndex] = pqList[nextIndex];
+                curIndex = nextIndex;
+            }
+            pqList[curIndex] = startNode;
+        }
+
+        void remove(PQNode& item) {
+            item = pqList[1];
+            pqList[1] = pqList[numItems--];
+            downHeap(1);
+        }
+
+        void change(int itemIndex, int newValue) {
+            if(newValue > pqList[itemIndex].key) {
+                pqList[itemIndex].key = newValue;
+                downHeap(itemIndex);
+            } else if(newValue < pqList[itemIndex].key) {
+                pqList[itemIndex].key = newValue;
+                upHeap(itemIndex);
+            }
+        }
+
+        int find(unsigned int id) {
+            for(int index = 0; index <= numItems; index++)
+                if(pqList[index].id == id)
+                    return index;
+            return 0;
+        }
+
+        void clear() { numItems = 0; }
+};
+
+struct PQOp {
+    int op;
+    int32_t key;
+    uint32_t id;
+};
+
+struct TraceStats {
+    long queries;
+    long inserts;
+    long removes;
+    long changes;
+    long maxQueued;
+};
+
+static bool load_trace(const char* name, std::vector<PQOp>& ops, TraceStats& stats)
+{
+    FILE* f = fopen(name, "rb");
+    if(!f) {
+        printf("can't open %s\n", name);
+        return false;
+    }
+
+    uint32_t id = 0;
+    if(fread(&id, sizeof(id), 1, f) != 1 || id != PQ_TRACE_ID) {
+        printf("%s is not an open list trace\n", name);
+        fclose(f);
+        return false;
+    }
+
+    // every search clears its queue first, files may start in the middle of one
+    PQOp start = { PQ_TRACE_CLEAR, 0, 0 };
+    ops.push_back(start);
+
+    long queued = 0;
+    PQTraceRecord rec;
+    while(fread(&rec, sizeof(rec), 1, f) == 1) {
+        switch(rec.op) {
+            case PQ_TRACE_CLEAR:
+                queued = 0;
+                stats.queries++;
+                break;
+            case PQ_TRACE_INSERT:
+                stats.inserts++;
+                if(++queued > stats.maxQueued)
+                    stats.maxQueued = queued;
+                break;
+            case PQ_TRACE_REMOVE:
+                stats.removes++;
+                queued--;
+                break;
+            case PQ_TRACE_CHANGE:
+                stats.changes++;
+                break;
+            default:
+                printf("%s: bad record\n", name);
+                fclose(f);
+                return false;
+        }
+        PQOp o = { rec.op, rec.key, rec.id };
+        ops.push_back(o);
+    }
+    fclose(f);
+    return true;
+}
+
+// Real searches tie on keys all the time, and which of the tied nodes comes
+// out first depends on the heap.  So keys are replaced by their rank in
+// (key, time the search removed it), which keeps the order the recorded heap
+// gave them and has no ties: any correct queue then hands the nodes back in
+// exactly the order they were recorded in.
+static void make_keys_unique(std::vector<PQOp>& ops)
+{
+    struct Version {
+        int32_t key;
+        size_t removed;
+    };
+    std::vector<Version> versions;
+    std::vector<size_t> op_version(ops.size(), (size_t)-1);
+    std::vector<size_t> current;    // version of each queued id, by id
+    std::vector<uint32_t> queued;
+
+    const size_t never = (size_t)-1;
+    for(size_t i=0; i<ops.size(); ++i) {
+        const PQOp& o = ops[i];
+        if(o.op == PQ_TRACE_CLEAR) {
+            for(size_t q=0; q<queued.size(); ++q)
+                current[queued[q]] = never;
+            queued.clear();
+            continue;
+        }
+        if(o.id >= current.size())
+            current.resize(o.id + 1, never);
+        if(o.op == PQ_TRACE_REMOVE) {
+            op_version[i] = current[o.id];
+            if(current[o.id] != never)
+                versions[current[o.id]].removed = i;
+            current[o.id] = never;
+            continue;
+        }
+        Version v = { o.key, never };
+        if(o.op == PQ_TRACE_INSERT)
+            queued.push_back(o.id);
+        current[o.id] = versions.size();
+        op_version[i] = versions.size();
+        versions.push_back(v);
+    }
+
+    std::vector<size_t> order(versions.size());
+    for(size_t v=0; v<order.size(); ++v)
+        order[v] = v;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if(versions[a].key != versions[b].key)
+            return versions[a].key < versions[b].key;
+        return versions[a].removed < versions[b].removed;
+    });
+    std::vector<int32_t> rank(versions.size());
+    for(size_t r=0; r<order.size(); ++r)
+        rank[order[r]] = (int32_t)r;
+
+    for(size_t i=0; i<ops.size(); ++i)
+        if(op_version[i] != (size_t)-1)
+            ops[i].key = rank[op_version[i]];
+}
+
+// Returns the number of removes which didn't come back as recorded.
+template <class Queue>
+static long replay(Queue& queue, const std::vector<PQOp>& ops)
+{
+    long mismatches = 0;
+    for(size_t i=0; i<ops.size(); ++i) {
+        const PQOp& o = ops[i];
+        switch(o.op) {
+            case PQ_TRACE_CLEAR:
+                queue.clear();
+                break;
+            case PQ_TRACE_INSERT: {
+                PQNode node;
+                node.key = o.key;
+                node.id = o.id;
+                node.row = 0;
+                node.col = 0;
+                queue.insert(node);
+                break;
+            }
+            case PQ_TRACE_REMOVE: {
+                PQNode node;
+                queue.remove(node);
+                if(node.key != o.key || node.id != o.id)
+                    ++mismatches;
+                break;
+            }
+            case PQ_TRACE_CHANGE: {
+                int index = queue.find(o.id);
+                if(index)
+                    queue.change(index, o.key);
+                else
+                    ++mismatches;
+                break;
+            }
+        }
+    }
+    return mismatches;
+}
+
+static double now_ms()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char** argv)
+{
+    int passes = 20;
+    std::vector<const char*> traces;
+
+    for(int i=1; i<argc; ++i) {
+        if(0 == strcmp(argv[i], "-n") && i+1 < argc) {
+            passes = atoi(argv[++i]);
+        } else if(argv[i][0] != '-') {
+            traces.push_back(argv[i]);
+        } else {
+            usage(argv);
+            return 1;
+        }
+    }
+
+    if(traces.empty() || passes < 1) {
+        usage(argv);
+        return 1;
+    }
+
+    systemHeap = new UserHeap();
+    if(!systemHeap) {
+        STOP(("Failed to initialize system heap"));
+        return -1;
+    }
+    systemHeap->init(8*1024*1024);
+
+    std::vector<PQOp> ops;
+    TraceStats stats;
+    memset(&stats, 0, sizeof(stats));
+    for(size_t t=0; t<traces.size(); ++t)
+        if(!load_trace(traces[t], ops, stats))
+            return 1;
+    make_keys_unique(ops);
+
+    printf("searches: %ld, ops: %zu (%ld inserts, %ld removes, %ld changes), largest open list %ld\n",
+           stats.queries, ops.size(), stats.inserts, stats.removes, stats.changes, stats.maxQueued);
+
+    // same size MoveMap gives its open list
+    OldPriorityQueue old_queue;
+    old_queue.init(5000);
+    PriorityQueue new_queue;
+    new_queue.init(5000);
+
+    long old_mismatches = 0, new_mismatches = 0;
+    double old_ms = 0.0, new_ms = 0.0;
+    for(int p=0; p<passes; ++p) {
+        double start = now_ms();
+        old_mismatches += replay(old_queue, ops);
+        old_ms += now_ms() - start;
+
+        start = now_ms();
+        new_mismatches += replay(new_queue, ops);
+        new_ms += now_ms() - start;
+    }
+
+    printf("old binary heap: %8.3f ms per pass, %ld mismatches\n", old_ms / passes, old_mismatches);
+    printf("PriorityQueue:   %8.3f ms per pass, %ld mismatches\n", new_ms / passes, new_mismatches);
+    printf("speedup: %.2fx\n", new_ms > 0.0 ? old_ms / new_ms : 0.0);
+
+    new_queue.destroy();
+
+    return (old_mismatches || new_mismatches) ? 1 : 0;
+}
@@ -0,0 +1,222 @@
+#include <vector>
+#include <chrono>
+#include <math.h>
+#include "gameos.hpp"
+#include "toolos.hpp"
+
+#include "mclib.h"
+#include "spatialgrid.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Times the per frame sensor sweep the way SensorSystem::scanBattlefield used to
+// do it (every sensor looks at every mover) against SpatialGrid range queries
+// (mclib/spatialgrid.cpp), on synthetic movers spread over a full size map.
+// Both have to end up with exactly the same contact lists.
+
+UserHeapPtr systemHeap = NULL;
+
+static const float MAP_SIDE = 120.0f * 128.0f;     // 120 vertex map, world units
+static const float CELL_SIZE = 1280.0f;            // same as MOVER_GRID_CELL_SIZE
+static const float SLACK = 256.0f;                 // same as MOVER_GRID_SLACK
+
+void usage(char** argv) {
+    printf("%s [-f frames] [-n movers]\n", argv[0]);
+    printf("\t-f - frames simulated per mover count (default 200)\n");
+    printf("\t-n - only run this many movers (default 20 to 500)\n");
+}
+
+static unsigned int g_seed = 12345;
+
+static float frand(float lo, float hi)
+{
+    g_seed = g_seed * 1664525 + 1013904223;
+    return lo + (hi - lo) * (float)(g_seed >> 8) / (float)(1 << 24);
+}
+
+struct TestMover {
+    float x, y;
+    float dx, dy;       // world units per frame
+    float range;        // sensor or visual range, world units
+};
+
+static void make_movers(std::vector<TestMover>& movers, int count)
+{
+    // Movers come in lances, so put them in clumps like a real mission.
+    movers.resize(count);
+    float cx = 0.0f, cy = 0.0f;
+    for(int i=0; i<count; ++i) {
+        if(0 == (i & 3)) {
+            cx = frand(1000.0f, MAP_SIDE - 1000.0f);
+            cy = frand(1000.0f, MAP_SIDE - 1000.0f);
+        }
+        TestMover& m = movers[i];
+        m.x = cx + frand(-400.0f, 400.0f);
+        m.y = cy + frand(-400.0f, 400.0f);
+        m.dx = frand(-8.0f, 8.0f);
+        m.dy = frand(-8.0f, 8.0f);
+        m.range = frand(1500.0f, 3500.0f);
+    }
+}
+
+static void move_movers(std::vector<TestMover>& movers)
+{
+    for(size_t i=0; i<movers.size(); ++i) {
+        TestMover& m = movers[i];
+        m.x += m.dx;
+        m.y += m.dy;
+        if(m.x < 0.0f || m.x > MAP_SIDE) m.dx = -m.dx;
+        if(m.y < 0.0f || m.y > MAP_SIDE) m.dy = -m.dy;
+    }
+}
+
+static bool in_range(const TestMover& sensor, const TestMover& m)
+{
+    float dx = m.x - sensor.x;
+    float dy = m.y - sensor.y;
+    return sqrtf(dx*dx + dy*dy) <= sensor.range;
+}
+
+// What scanBattlefield does with each mover it looks at: find it in the
+// contact list (a straight search, like SensorSystem::isContact), then add,
+// keep or drop it.
+static void scan_mover(std::vector<long>& contacts, const TestMover& sensor, const TestMover& m, long index)
+{
+    size_t c = 0;
+    while(c < contacts.size() && contacts[c] != index)
+        ++c;
+
+    bool inRange = in_range(sensor, m);
+    if(c < contacts.size()) {
+        if(!inRange) {
+            contacts[c] = contacts.back();
+            contacts.pop_back();
+        }
+    } else if(inRange) {
+        contacts.push_back(index);
+    }
+}
+
+static double now_ms()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+}
+
+static bool run(int count, int frames)
+{
+    std::vector<TestMover> movers;
+    make_movers(movers, count);
+
+    SpatialGrid grid;
+    if(NO_ERR != grid.init(0.0f, 0.0f, MAP_SIDE, MAP_SIDE, CELL_SIZE, count)) {
+        printf("grid init failed\n");
+        return false;
+    }
+
+    std::vector<std::vector<long> > all_contacts(count);
+    std::vector<std::vector<long> > grid_contacts(count);
+    std::vector<DWORD> mask(SPATIAL_GRID_MASK_WORDS(count));
+    std::vector<long> scan_list(count);
+
+    double all_ms = 0.0, grid_ms = 0.0;
+    long long all_checks = 0, grid_checks = 0, hits = 0;
+    bool ok = true;
+
+    for(int f=0; f<frames && ok; ++f) {
+        move_movers(movers);
+
+        // old way, every sensor looks at every other mover
+        double start = now_ms();
+        for(int s=0; s<count; ++s) {
+            for(int i=0; i<count; ++i) {
+                if(i != s)
+                    scan_mover(all_contacts[s], movers[s], movers[i], i);
+            }
+        }
+        all_ms += now_ms() - start;
+        all_checks += (long long)count * (count - 1);
+
+        // grid, built once per frame like GameObjectManager::buildMoverGrid, and
+        // each sensor looks at what is near plus what it already has contact with
+        start = now_ms();
+        grid.clear(count);
+        for(int i=0; i<count; ++i)
+            grid.setEntry(i, movers[i].x, movers[i].y);
+        grid.build();
+
+        for(int s=0; s<count; ++s) {
+            memset(&mask[0], 0, sizeof(DWORD) * mask.size());
+            grid.markInRange(movers[s].x, movers[s].y, movers[s].range + SLACK, &mask[0]);
+            std::vector<long>& contacts = grid_contacts[s];
+            for(size_t c=0; c<contacts.size(); ++c)
+                mask[contacts[c] >> 5] |= ((DWORD)1 << (contacts[c] & 31));
+
+            long numScan = grid.listMarked(&mask[0], &scan_list[0], count);
+            for(long n=0; n<numScan; ++n) {
+                long i = scan_list[n];
+                if(i != s)
+                    scan_mover(contacts, movers[s], movers[i], i);
+            }
+            grid_checks += numScan;
+        }
+        grid_ms += now_ms() - start;
+
+        // Same movers looked at in the same order, so the lists have to match exactly.
+        for(int s=0; s<count && ok; ++s) {
+            if(all_contacts[s] != grid_contacts[s]) {
+                printf("frame %d sensor %d: all pairs has %zu contacts, grid has %zu\n", f, s, all_contacts[s].size(), grid_contacts[s].size());
+                ok = false;
+            }
+            hits += all_contacts[s].size();
+        }
+    }
+
+    grid.destroy();
+
+    printf("%4d movers: all pairs %8.3f ms/frame (%7lld checks), grid %8.3f ms/frame (%7lld checks), %5.1f contacts per sensor, %.2fx %s\n",
+           count, all_ms / frames, all_checks / frames, grid_ms / frames, grid_checks / frames,
+           (double)hits / ((double)frames * count), grid_ms > 0.0 ? all_ms / grid_ms : 0.0,
+           ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    int frames = 200;
+    int only = 0;
+
+    for(int i=1; i<argc; ++i) {
+        if(0 == strcmp(argv[i], "-f") && i+1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if(0 == strcmp(argv[i], "-n") && i+1 < argc) {
+            only = atoi(argv[++i]);
+        } else {
+            usage(argv);
+            return 1;
+        }
+    }
+
+    if(frames < 1) {
+        usage(argv);
+        return 1;
+    }
+
+    systemHeap = new UserHeap();
+    if(!systemHeap) {
+        STOP(("Failed to initialize system heap"));
+        return -1;
+    }
+    systemHeap->init(8*1024*1024);
+
+    static const int counts[] = { 20, 50, 100, 200, 255, 500 };
+    bool ok = true;
+    if(only > 0) {
+        ok = run(only, frames);
+    } else {
+        for(size_t i=0; i<sizeof(counts)/sizeof(counts[0]); ++i)
+            ok = run(counts[i], frames) && ok;
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,361 @@
+#include <vector>
+#include <chrono>
+#include <math.h>
+#include "gameos.hpp"
+#include "toolos.hpp"
+
+#include <stuff/stuff.hpp>
+#include "tglxform.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Checks the batched shape transform and vertex lighting (mclib/tglxform.cpp)
+// against the per vertex code TG_Shape::MultiTransformShape used to run, done here
+// the old way with Stuff types.  Results have to match bit for bit.
+
+void usage(char** argv) {
+    printf("%s [-n vertices] [-i iterations]\n", argv[0]);
+    printf("\t-n - vertices per test shape (default 1000)\n");
+    printf("\t-i - iterations of the timing run (default 1000)\n");
+}
+
+static unsigned int g_seed = 12345;
+
+static float frand(float lo, float hi)
+{
+    g_seed = g_seed * 1664525 + 1013904223;
+    return lo + (hi - lo) * (float)(g_seed >> 8) / (float)(1 << 24);
+}
+
+struct TestShape {
+    std::vector<Stuff::Point3D> positions;
+    std::vector<Stuff::Vector3D> normals;
+    std::vector<float> lane_memory;
+    TG_VertexLanes lanes;
+};
+
+static void make_shape(TestShape& shape, DWORD count)
+{
+    shape.positions.resize(count);
+    shape.normals.resize(count);
+    for(DWORD i=0; i<count; ++i) {
+        Stuff::Point3D& p = shape.positions[i];
+        p.x = frand(-40.0f, 40.0f);
+        p.y = frand(-10.0f, 60.0f);
+        p.z = frand(-40.0f, 40.0f);
+
+        Stuff::Vector3D& n = shape.normals[i];
+        n.x = frand(-1.0f, 1.0f);
+        n.y = frand(-1.0f, 1.0f);
+        n.z = frand(-1.0f, 1.0f);
+        float len = sqrtf(n.x*n.x + n.y*n.y + n.z*n.z);
+        if(len > 0.001f) {
+            n.x /= len; n.y /= len; n.z /= len;
+        }
+    }
+
+    // a few which land exactly on the camera plane to hit the w == 0 case
+    if(count > 2) {
+        shape.positions[1] = Stuff::Point3D(0.0f, 0.0f, 0.0f);
+        shape.positions[count - 1] = Stuff::Point3D(0.0f, 0.0f, 0.0f);
+    }
+
+    shape.lane_memory.resize(TG_VertexLanesSize(count) / sizeof(float) + 1);
+    TG_SetVertexLanes(shape.lanes, &shape.lane_memory[0], count);
+    for(DWORD i=0; i<count; ++i) {
+        shape.lanes.px[i] = shape.positions[i].x;
+        shape.lanes.py[i] = shape.positions[i].y;
+        shape.lanes.pz[i] = shape.positions[i].z;
+        shape.lanes.nx[i] = shape.normals[i].x;
+        shape.lanes.ny[i] = shape.normals[i].y;
+        shape.lanes.nz[i] = shape.normals[i].z;
+    }
+}
+
+// Something like a camera: rotation, translation and a projection with w = view z
+static void make_matrix(Stuff::Matrix4D& m, bool perspective)
+{
+    for(int r=0; r<4; ++r)
+        for(int c=0; c<4; ++c)
+            m(r,c) = frand(-0.2f, 0.2f);
+
+    m(0,0) += 1.2f;
+    m(1,1) += 1.6f;
+    m(2,2) += 1.0f;
+    m(3,2) += 40.0f;
+    if(perspective) {
+        // w row only depends on z so that the origin has w == 0
+        m(0,3) = 0.0f;
+        m(1,3) = 0.0f;
+        m(2,3) = 1.0f;
+        m(3,3) = 0.0f;
+    } else {
+        m(0,0) *= 0.01f;
+        m(1,1) *= 0.01f;
+        m(0,3) = m(1,3) = m(2,3) = 0.0f;
+        m(3,3) = 1.0f;
+    }
+}
+
+static void make_params(TG_XformParams& params, const Stuff::Matrix4D& m, float scale, bool perspective)
+{
+    for(int r=0; r<4; ++r)
+        for(int c=0; c<4; ++c)
+            params.m[r][c] = m(r,c);
+    params.scale = scale;
+    params.viewMulX = 640.0f;
+    params.viewAddX = 0.0f;
+    params.viewMulY = 480.0f;
+    params.viewAddY = 0.0f;
+    params.perspective = perspective;
+}
+
+static long make_lights(TG_XformLight* lights, long num_lights)
+{
+    for(long i=0; i<num_lights; ++i) {
+        Stuff::Vector3D dir(frand(-1.0f, 1.0f), frand(-1.0f, 0.2f), frand(-1.0f, 1.0f));
+        if(dir.GetLength() > Stuff::SMALL)
+            dir.Normalize(dir);
+        lights[i].dirX = dir.x;
+        lights[i].dirY = dir.y;
+        lights[i].dirZ = dir.z;
+
+        // point and spot lights come with their falloff already applied
+        float falloff = (i & 1) ? frand(0.0f, 1.0f) : 1.0f;
+        lights[i].red = float((DWORD)frand(0.0f, 255.0f)) * falloff;
+        lights[i].green = float((DWORD)frand(0.0f, 255.0f)) * falloff;
+        lights[i].blue = float((DWORD)frand(0.0f, 255.0f)) * falloff;
+        lights[i].specular = (i & 1) != 0;
+    }
+    return num_lights;
+}
+
+struct GoldenVertex {
+    float x, y, z, rhw;
+    DWORD redFinal, greenFinal, blueFinal;
+    DWORD redSpec, greenSpec, blueSpec;
+};
+
+// What MultiTransformShape did for every vertex before the lanes
+static long golden_shape(const TestShape& shape, const Stuff::Matrix4D& shapeToClip, const TG_XformParams& params,
+                         const TG_XformLight* lights, long num_lights, std::vector<GoldenVertex>& out)
+{
+    bool oneOff = false;
+    bool oneOn = false;
+
+    out.resize(shape.positions.size());
+    for(size_t j=0; j<shape.positions.size(); ++j) {
+        Stuff::Point3D pos = shape.positions[j];
+        if(params.scale > 0.0f)
+            pos *= params.scale;
+
+        Stuff::Vector4D xformCoords;
+        Stuff::Vector4D screen;
+        xformCoords.Multiply(pos, shapeToClip);
+
+        if(params.perspective) {
+            float rhw = 1.0f;
+            if(xformCoords.w != 0.0f)
+                rhw = 1.0f / xformCoords.w;
+
+            screen.x = (xformCoords.x * rhw) * params.viewMulX + params.viewAddX;
+            screen.y = (xformCoords.y * rhw) * params.viewMulY + params.viewAddY;
+            screen.z = (xformCoords.z * rhw);
+            screen.w = fabs(rhw);
+        } else {
+            screen.x = (1.0f - xformCoords.x) * params.viewMulX + params.viewAddX;
+            screen.y = (1.0f - xformCoords.y) * params.viewMulY + params.viewAddY;
+            screen.z = xformCoords.z;
+            screen.w = 0.000001f;
+        }
+
+        if((screen.x < 0) || (screen.y < 0) || (screen.x >= params.viewMulX) || (screen.y >= params.viewMulY))
+            oneOff = true;
+
+        if((screen.x >= 0) && (screen.y >= 0) && (screen.x < params.viewMulX) && (screen.y <= params.viewMulY))
+            oneOn = true;
+
+        GoldenVertex& v = out[j];
+        v.x = screen.x;
+        v.y = screen.y;
+        v.z = screen.z;
+        v.rhw = screen.w;
+        v.redFinal = v.greenFinal = v.blueFinal = 0;
+        v.redSpec = v.greenSpec = v.blueSpec = 0;
+
+        for(long i=0; i<num_lights; ++i) {
+            Stuff::Vector3D dir(lights[i].dirX, lights[i].dirY, lights[i].dirZ);
+            float cosine = dir * shape.normals[j];
+            if(cosine < 0.0f) {
+                cosine = fabs(cosine);
+                float red = lights[i].red * cosine;
+                float green = lights[i].green * cosine;
+                float blue = lights[i].blue * cosine;
+                if(lights[i].specular) {
+                    v.redSpec += (DWORD)red;
+                    v.greenSpec += (DWORD)green;
+                    v.blueSpec += (DWORD)blue;
+                } else {
+                    v.redFinal += (long)red;
+                    v.greenFinal += (long)green;
+                    v.blueFinal += (long)blue;
+                }
+            }
+        }
+    }
+
+    return (oneOff ? TG_XFORM_ONE_OFF : 0) | (oneOn ? TG_XFORM_ONE_ON : 0);
+}
+
+typedef long (*TransformFunc)(const TG_XformParams&, const TG_VertexLanes&, DWORD, DWORD, TG_XformBlock&);
+typedef void (*LightFunc)(const TG_XformLight*, long, const TG_VertexLanes&, DWORD, DWORD, TG_XformBlock&);
+
+static bool same_float(float a, float b)
+{
+    return 0 == memcmp(&a, &b, sizeof(float)) || (a != a && b != b);
+}
+
+static bool check_shape(const char* name, const TestShape& shape, const TG_XformParams& params,
+                        const TG_XformLight* lights, long num_lights, const std::vector<GoldenVertex>& golden,
+                        long golden_flags, TransformFunc transform, LightFunc light)
+{
+    TG_XformBlock block;
+    long flags = 0;
+    DWORD count = shape.lanes.count;
+    for(DWORD first=0; first<count; first+=TG_XFORM_BLOCK) {
+        DWORD block_count = count - first;
+        if(block_count > TG_XFORM_BLOCK)
+            block_count = TG_XFORM_BLOCK;
+
+        flags |= transform(params, shape.lanes, first, block_count, block);
+        light(lights, num_lights, shape.lanes, first, block_count, block);
+
+        for(DWORD b=0; b<block_count; ++b) {
+            const GoldenVertex& g = golden[first + b];
+            if(!same_float(g.x, block.x[b]) || !same_float(g.y, block.y[b]) ||
+               !same_float(g.z, block.z[b]) || !same_float(g.rhw, block.rhw[b])) {
+                printf("%s: vertex %u screen (%g %g %g %g) expected (%g %g %g %g)\n", name, first + b,
+                        block.x[b], block.y[b], block.z[b], block.rhw[b], g.x, g.y, g.z, g.rhw);
+                return false;
+            }
+            if(g.redFinal != block.redFinal[b] || g.greenFinal != block.greenFinal[b] || g.blueFinal != block.blueFinal[b] ||
+               g.redSpec != block.redSpec[b] || g.greenSpec != block.greenSpec[b] || g.blueSpec != block.blueSpec[b]) {
+                printf("%s: vertex %u light (%u %u %u / %u %u %u) expected (%u %u %u / %u %u %u)\n", name, first + b,
+                        block.redFinal[b], block.greenFinal[b], block.blueFinal[b],
+                        block.redSpec[b], block.greenSpec[b], block.blueSpec[b],
+                        g.redFinal, g.greenFinal, g.blueFinal, g.redSpec, g.greenSpec, g.blueSpec);
+                return false;
+            }
+        }
+    }
+
+    if(flags != golden_flags) {
+        printf("%s: on/off screen flags %ld expected %ld\n", name, flags, golden_flags);
+        return false;
+    }
+    return true;
+}
+
+static double time_shape(const TestShape& shape, const TG_XformParams& params, const TG_XformLight* lights,
+                         long num_lights, int iterations, TransformFunc transform, LightFunc light)
+{
+    TG_XformBlock block;
+    volatile float sink = 0.0f;
+    auto start = std::chrono::high_resolution_clock::now();
+    for(int it=0; it<iterations; ++it) {
+        DWORD count = shape.lanes.count;
+        for(DWORD first=0; first<count; first+=TG_XFORM_BLOCK) {
+            DWORD block_count = count - first;
+            if(block_count > TG_XFORM_BLOCK)
+                block_count = TG_XFORM_BLOCK;
+            transform(params, shape.lanes, first, block_count, block);
+            light(lights, num_lights, shape.lanes, first, block_count, block);
+            sink = sink + block.x[0];
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    int num_vertices = 1000;
+    int iterations = 1000;
+
+    for(int i=1;i<argc;++i) {
+        if(0 == strcmp(argv[i], "-n") && i+1 < argc) {
+            num_vertices = atoi(argv[++i]);
+        } else if(0 == strcmp(argv[i], "-i") && i+1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else {
+            usage(argv);
+            return 1;
+        }
+    }
+
+    if(num_vertices < 1 || iterations < 1) {
+        usage(argv);
+        return 1;
+    }
+
+    Stuff::InitializeClasses();
+
+    // odd sizes make sure partial steps and partial blocks are covered
+    const DWORD sizes[] = { 1, 3, 4, 5, 63, 64, 65, 130, (DWORD)num_vertices };
+    const long light_counts[] = { 0, 1, 3, 8 };
+    const float scales[] = { 0.0f, 1.5f };
+
+    int num_tests = 0;
+    for(size_t s=0; s<sizeof(sizes)/sizeof(sizes[0]); ++s) {
+        TestShape shape;
+        make_shape(shape, sizes[s]);
+
+        for(int perspective=0; perspective<2; ++perspective) {
+            Stuff::Matrix4D m;
+            make_matrix(m, perspective != 0);
+
+            for(size_t sc=0; sc<sizeof(scales)/sizeof(scales[0]); ++sc) {
+                TG_XformParams params;
+                make_params(params, m, scales[sc], perspective != 0);
+
+                for(size_t l=0; l<sizeof(light_counts)/sizeof(light_counts[0]); ++l) {
+                    TG_XformLight lights[8];
+                    long num_lights = make_lights(lights, light_counts[l]);
+
+                    std::vector<GoldenVertex> golden;
+                    long golden_flags = golden_shape(shape, m, params, lights, num_lights, golden);
+
+                    char name[128];
+                    snprintf(name, sizeof(name), "%u vertices, %s, scale %g, %ld lights", sizes[s],
+                            perspective ? "perspective" : "parallel", scales[sc], num_lights);
+
+                    if(!check_shape(name, shape, params, lights, num_lights, golden, golden_flags, TG_TransformBlockRef, TG_LightBlockRef) ||
+                       !check_shape(name, shape, params, lights, num_lights, golden, golden_flags, TG_TransformBlock, TG_LightBlock)) {
+                        printf("FAILED\n");
+                        return 1;
+                    }
+                    ++num_tests;
+                }
+            }
+        }
+    }
+    printf("OK: %d shapes match the per vertex transform\n", num_tests);
+
+    TestShape shape;
+    make_shape(shape, num_vertices);
+    Stuff::Matrix4D m;
+    make_matrix(m, true);
+    TG_XformParams params;
+    make_params(params, m, 0.0f, true);
+    TG_XformLight lights[4];
+    long num_lights = make_lights(lights, 4);
+
+    double ref_ms = time_shape(shape, params, lights, num_lights, iterations, TG_TransformBlockRef, TG_LightBlockRef);
+    double simd_ms = time_shape(shape, params, lights, num_lights, iterations, TG_TransformBlock, TG_LightBlock);
+    printf("%d vertices x %d, %ld lights: scalar %.3f ms, batched %.3f ms (%.2fx)\n", num_vertices, iterations,
+            num_lights, ref_ms, simd_ms, simd_ms > 0.0 ? ref_ms / simd_ms : 0.0);
+
+    Stuff::TerminateClasses();
+    return 0;
+}
@@ -106,6 +106,10 @@ void ABLi_close (void);
 
 bool ABLi_enabled (void);
 
+void ABLi_setVMMode (long mode);
+
+void ABLi_getVMStats (long& numCompiled, long& numRejected, long& numMismatches);
+
 void ABLi_addFunction (const char* name,
 					   bool isOrder,
 					   const char* paramList,
@@ -718,7 +718,7 @@ long Debugger::sprintSimpleValue (char* dest, SymTableNodePtr symbol) {
 				}
 				break;
 			case VAR_TYPE_ETERNAL:
-				dataPtr = (StackItemPtr)stack + symbol->defn.info.data.offset;
+				dataPtr = EternalDataPtr + symbol->defn.info.data.offset;
 				break;
 			case VAR_TYPE_STATIC:
 				dataPtr = (StackItemPtr)StaticDataPtr + symbol->defn.info.data.offset;
@@ -774,7 +774,7 @@ long Debugger::sprintArrayValue (char* dest, SymTableNodePtr symbol, char* subsc
 				}
 				break;
 			case VAR_TYPE_ETERNAL:
-				dataPtr = (StackItemPtr)stack + symbol->defn.info.data.offset;
+				dataPtr = EternalDataPtr + symbol->defn.info.data.offset;
 				break;
 			case VAR_TYPE_STATIC:
 				dataPtr = (StackItemPtr)StaticDataPtr + symbol->defn.info.data.offset;
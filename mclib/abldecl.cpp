@@ -657,7 +657,7 @@ void varOrFieldDeclarations (SymTableNodePtr routineIdPtr, long offset) {
 						idPtr->defn.info.data.offset = eternalOffset;
 						//-----------------------------------
 						// Initialize the variable to zero...
-						StackItemPtr dataPtr = (StackItemPtr)stack + eternalOffset;
+						StackItemPtr dataPtr = EternalDataPtr + eternalOffset;
 						if (typePtr->form == FRM_ARRAY) {
 							dataPtr->address = (Address)ABLStackMallocCallback((size_t)size);
 							if (!dataPtr->address)
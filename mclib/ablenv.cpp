@@ -107,9 +107,14 @@ extern TypePtr			BooleanTypePtr;
 extern unsigned long*	OrderCompletionFlags;
 extern StackItemPtr		StaticDataPtr;
 extern StackItem		returnValue;
+extern bool				AutoReturnFromOrders;
+extern bool				ExitWithReturn;
+extern bool				ExitFromTacOrder;
+extern bool				SkipOrder;
 
 extern DebuggerPtr		debugger;
 extern long*			EternalVariablesSizes;
+extern unsigned long	RuntimeStackSize;
 
 //-----------------------
 // CLASS static variables
@@ -135,6 +140,7 @@ extern int32_t	    numLibrariesLoaded;
 
 extern int32_t	    NumExecutions;
 int32_t				CallStackLevel = 0;
+ABLExecContextPtr	CurExecContext = NULL;
 
 #define	MAX_PROFILE_LINELEN		128
 #define MAX_PROFILE_LINES		256
@@ -435,6 +441,231 @@ void destroyLibraryRegistry (void) {
 	LibraryInstanceRegistry = NULL;
 }
 
+//***************************************************************************
+// ABLEXECCONTEXT class
+//***************************************************************************
+
+void* ABLExecContext::operator new (size_t mySize) {
+
+	void* result = NULL;
+	
+	result = ABLSystemMallocCallback(mySize);
+	
+	return(result);
+}
+
+//---------------------------------------------------------------------------
+
+void ABLExecContext::operator delete (void* us) {
+
+	ABLSystemFreeCallback(us);
+}
+
+//---------------------------------------------------------------------------
+
+void ABLExecContext::init (void) {
+
+	stack = NULL;
+	ownsStack = false;
+	running = false;
+	nested = NULL;
+
+	codeSegmentPtr = NULL;
+	codeSegmentLimit = NULL;
+	statementStartPtr = NULL;
+	codeToken = TKN_NONE;
+	execLineNumber = 0;
+	execStatementCount = 0;
+	tos = NULL;
+	stackFrameBasePtr = NULL;
+	StaticDataPtr = NULL;
+	OrderCompletionFlags = NULL;
+	memset(&returnValue, 0, sizeof(StackItem));
+
+	CurModule = NULL;
+	CurFSM = NULL;
+	CurModuleIdPtr = NULL;
+	CurRoutineIdPtr = NULL;
+	CurModuleHandle = 0;
+	level = 0;
+	CallStackLevel = 0;
+	FileNumber = 0;
+	NumStateTransitions = 0;
+	errorCount = 0;
+	CallModuleInit = false;
+	AutoReturnFromOrders = false;
+	NewStateSet = false;
+	ExitWithReturn = false;
+	ExitFromTacOrder = false;
+	SkipOrder = false;
+}
+
+//---------------------------------------------------------------------------
+
+long ABLExecContext::create (StackItemPtr runtimeStack) {
+
+	//-------------------------------------------------------------
+	// The main context runs on the stack ABLi_init() allocated. All
+	// others get one of the same size, since module frames start
+	// above eternalOffset on every stack...
+	if (runtimeStack)
+		stack = runtimeStack;
+	else {
+		stack = (StackItemPtr)ABLStackMallocCallback(sizeof(StackItem) * (RuntimeStackSize / sizeof(StackItem)));
+		if (!stack)
+			ABL_Fatal(0, " ABL: Unable to AblStackHeap->malloc context stack ");
+		ownsStack = true;
+	}
+	tos = stackFrameBasePtr = stack;
+	thread = std::this_thread::get_id();
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+
+void ABLExecContext::destroy (void) {
+
+	if (nested) {
+		delete nested;
+		nested = NULL;
+	}
+
+	if (stack && ownsStack)
+		ABLStackFreeCallback(stack);
+	stack = NULL;
+	ownsStack = false;
+}
+
+//---------------------------------------------------------------------------
+
+void ABLExecContext::save (void) {
+
+	stack = ::stack;
+	codeSegmentPtr = ::codeSegmentPtr;
+	codeSegmentLimit = ::codeSegmentLimit;
+	statementStartPtr = ::statementStartPtr;
+	codeToken = ::codeToken;
+	execLineNumber = ::execLineNumber;
+	execStatementCount = ::execStatementCount;
+	tos = ::tos;
+	stackFrameBasePtr = ::stackFrameBasePtr;
+	StaticDataPtr = ::StaticDataPtr;
+	OrderCompletionFlags = ::OrderCompletionFlags;
+	returnValue = ::returnValue;
+
+	CurModule = ::CurModule;
+	CurFSM = ::CurFSM;
+	CurModuleIdPtr = ::CurModuleIdPtr;
+	CurRoutineIdPtr = ::CurRoutineIdPtr;
+	CurModuleHandle = ::CurModuleHandle;
+	level = ::level;
+	CallStackLevel = ::CallStackLevel;
+	FileNumber = ::FileNumber;
+	NumStateTransitions = ::NumStateTransitions;
+	errorCount = ::errorCount;
+	CallModuleInit = ::CallModuleInit;
+	AutoReturnFromOrders = ::AutoReturnFromOrders;
+	NewStateSet = ::NewStateSet;
+	ExitWithReturn = ::ExitWithReturn;
+	ExitFromTacOrder = ::ExitFromTacOrder;
+	SkipOrder = ::SkipOrder;
+}
+
+//---------------------------------------------------------------------------
+
+void ABLExecContext::restore (void) {
+
+	::stack = stack;
+	::codeSegmentPtr = codeSegmentPtr;
+	::codeSegmentLimit = codeSegmentLimit;
+	::statementStartPtr = statementStartPtr;
+	::codeToken = codeToken;
+	::execLineNumber = execLineNumber;
+	::execStatementCount = execStatementCount;
+	::tos = tos;
+	::stackFrameBasePtr = stackFrameBasePtr;
+	::StaticDataPtr = StaticDataPtr;
+	::OrderCompletionFlags = OrderCompletionFlags;
+	::returnValue = returnValue;
+
+	::CurModule = CurModule;
+	::CurFSM = CurFSM;
+	::CurModuleIdPtr = CurModuleIdPtr;
+	::CurRoutineIdPtr = CurRoutineIdPtr;
+	::CurModuleHandle = CurModuleHandle;
+	::level = level;
+	::CallStackLevel = CallStackLevel;
+	::FileNumber = FileNumber;
+	::NumStateTransitions = NumStateTransitions;
+	::errorCount = errorCount;
+	::CallModuleInit = CallModuleInit;
+	::AutoReturnFromOrders = AutoReturnFromOrders;
+	::NewStateSet = NewStateSet;
+	::ExitWithReturn = ExitWithReturn;
+	::ExitFromTacOrder = ExitFromTacOrder;
+	::SkipOrder = SkipOrder;
+}
+
+//---------------------------------------------------------------------------
+
+ABLExecContextPtr ABLExecContext::getNested (void) {
+
+	if (!nested) {
+		nested = new ABLExecContext;
+		if (!nested)
+			ABL_Fatal(0, " ABL: Unable to malloc nested execution context ");
+		nested->create();
+	}
+	return(nested);
+}
+
+//---------------------------------------------------------------------------
+// A module executed while another one is still running on the same thread
+// (a brain alarm raised from inside a game callback, say) used to reset tos
+// to the bottom of the stack and trample its caller's frames. It now runs in
+// the current context's nested context, and the caller's registers are put
+// back when it returns...
+
+class ABLExecutionScope {
+
+	public:
+
+		ABLExecContextPtr		outerContext;
+		bool					switched;
+
+	public:
+
+		ABLExecutionScope (void) {
+			outerContext = CurExecContext;
+			switched = false;
+			if (outerContext) {
+				if (outerContext->thread != std::this_thread::get_id())
+					ABL_Fatal(0, " ABL: module executed off the thread ABL was initialized on ");
+				if (outerContext->running) {
+					ABLExecContextPtr context = outerContext->getNested();
+					outerContext->save();
+					context->restore();
+					CurExecContext = context;
+					switched = true;
+				}
+				CurExecContext->running = true;
+			}
+		}
+
+		~ABLExecutionScope (void) {
+			if (outerContext) {
+				CurExecContext->running = false;
+				if (switched) {
+					CurExecContext->save();
+					outerContext->restore();
+					CurExecContext = outerContext;
+					if (debugger)
+						debugger->setModule(CurModule);
+				}
+			}
+		}
+};
+
 //***************************************************************************
 // ABLMODULE class
 //***************************************************************************
@@ -790,6 +1021,8 @@ int ABLModule::getStateHandle (void) {
 
 long ABLModule::execute (ABLParamPtr paramList) {
 
+	ABLExecutionScope scope;
+
 	CurModule = this;
 	if (debugger)
 		debugger->setModule(this);
@@ -930,6 +1163,8 @@ long ABLModule::execute (ABLParamPtr paramList) {
 
 long ABLModule::execute (ABLParamPtr moduleParamList, SymTableNodePtr functionIdPtr) {
 
+	ABLExecutionScope scope;
+
 	CurModule = this;
 	if (debugger)
 		debugger->setModule(this);
@@ -1421,7 +1656,7 @@ void ABLi_saveEnvironment (ABLFile* ablFile) {
 	}
 	ablFile->writeInt(ABL_ENV_MARK);
 	for (int i = 0; i < eternalOffset; i++) {
-		StackItemPtr dataPtr = (StackItemPtr)stack + i;
+		StackItemPtr dataPtr = EternalDataPtr + i;
 		if (EternalVariablesSizes[i] > 0)
 			ablFile->write((unsigned char*)dataPtr->address, EternalVariablesSizes[i]);
 		else
@@ -1488,7 +1723,7 @@ void ABLi_loadEnvironment (ABLFile* ablFile, bool malloc) {
     }
 
 	for (int i = 0; i < eternalOffset; i++) {
-		StackItemPtr dataPtr = (StackItemPtr)stack + i;
+		StackItemPtr dataPtr = EternalDataPtr + i;
 		if (EternalVariablesSizes[i] > 0)
 			ablFile->read((unsigned char*)dataPtr->address, EternalVariablesSizes[i]);
 		else
@@ -11,6 +11,7 @@
 #define ABLENV_H
 
 #include<stdio.h>
+#include<thread>
 
 #ifndef DABLENV_H
 #include"dablenv.h"
@@ -350,6 +351,85 @@ class ABLModule {
 
 };
 
+//---------------------------------------------------------------------------
+// An execution context holds a copy of the executor's registers (the globals
+// execute() works in), plus a runtime stack of its own. The registers always
+// belong to the current context: switching to a nested one parks one set and
+// loads the other. Eternal variables are not on a context's stack--they live
+// in the shared EternalDataPtr area, so every context sees the same ones.
+//
+// Contexts give reentrancy, not threading: the registers are globals and
+// the ablmc2 callbacks write straight into game state, so all modules
+// (MechWarrior brains included) run on the thread which called ABLi_init().
+
+class ABLExecContext {
+
+	public:
+
+		StackItemPtr			stack;
+		bool					ownsStack;
+		bool					running;
+		ABLExecContextPtr		nested;
+		std::thread::id			thread;
+
+		char*					codeSegmentPtr;
+		char*					codeSegmentLimit;
+		char*					statementStartPtr;
+		TokenCodeType			codeToken;
+		int                     execLineNumber;
+		int                     execStatementCount;
+		StackItemPtr			tos;
+		StackItemPtr			stackFrameBasePtr;
+		StackItemPtr			StaticDataPtr;
+		unsigned long*			OrderCompletionFlags;
+		StackItem				returnValue;
+
+		ABLModulePtr			CurModule;
+		ABLModulePtr			CurFSM;
+		SymTableNodePtr			CurModuleIdPtr;
+		SymTableNodePtr			CurRoutineIdPtr;
+		long					CurModuleHandle;
+		int32_t					level;
+		int32_t					CallStackLevel;
+		int32_t					FileNumber;
+		int32_t					NumStateTransitions;
+		long					errorCount;
+		bool					CallModuleInit;
+		bool					AutoReturnFromOrders;
+		bool					NewStateSet;
+		bool					ExitWithReturn;
+		bool					ExitFromTacOrder;
+		bool					SkipOrder;
+
+	public:
+
+		void* operator new (size_t mySize);
+
+		void operator delete (void* us);
+
+		void init (void);
+
+		ABLExecContext (void) {
+			init();
+		}
+
+		long create (StackItemPtr runtimeStack = NULL);
+
+		void destroy (void);
+
+		~ABLExecContext (void) {
+			destroy();
+		}
+
+		void save (void);
+
+		void restore (void);
+
+		ABLExecContextPtr getNested (void);
+};
+
+extern ABLExecContextPtr	CurExecContext;
+
 //*************************************************************************
 
 void initModuleRegistry (long maxModules);
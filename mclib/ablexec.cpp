@@ -48,6 +48,7 @@ int                     execStatementCount = 0;
 StackItem*				stack = NULL;
 StackItemPtr			tos = NULL;
 StackItemPtr			stackFrameBasePtr = NULL;
+StackItemPtr			EternalDataPtr = NULL;
 StackItemPtr			StaticDataPtr = NULL;
 long*					StaticVariablesSizes = NULL;
 long*					EternalVariablesSizes = NULL;
@@ -126,6 +126,7 @@ extern int              execStatementCount;
 extern StackItem*		stack;
 extern StackItemPtr		tos;
 extern StackItemPtr		stackFrameBasePtr;
+extern StackItemPtr		EternalDataPtr;
 
 //***************************************************************************
 
@@ -213,6 +214,28 @@ TypePtr execFactor (void);
 TypePtr execTerm (void);
 TypePtr execSimpleExpression (void);
 TypePtr execExpression (void);
+TypePtr interpretExpression (void);
+
+//****************
+// EXECVM routines
+//****************
+
+//---------------------------------------------------------------------
+// The VM stays off unless asked for (-ablvm on|verify). Verify mode only
+// cross-checks expressions without routine calls, since those can't be
+// evaluated twice. data_tools/abldiff covers those by running each script
+// twice, and has to pass on the campaign before the VM becomes the default...
+#define	ABL_VM_OFF			0
+#define	ABL_VM_ON			1
+#define	ABL_VM_VERIFY		2
+
+extern long				ABLVMMode;
+extern long				ABLVMNumCompiled;
+extern long				ABLVMNumRejected;
+extern long				ABLVMNumMismatches;
+
+bool execCompiledExpression (TypePtr& resultTypePtr);
+void destroyCompiledExpressions (void);
 
 //*****************
 // EXECSTD routines
@@ -182,6 +182,8 @@ extern bool				DebugCodeEnabled;
 extern DebuggerPtr		debugger;
 
 bool					ABLenabled = false;
+unsigned long			RuntimeStackSize = 0;
+ABLExecContextPtr		MainExecContext = NULL;
 char					buffer[MAXLEN_PRINTLINE];
 
 extern int32_t          CallStackLevel;
@@ -511,9 +513,20 @@ profile = true;
 
 	//------------------------------
 	// Allocate the runtime stack...
+	RuntimeStackSize = runtimeStackSize;
 	stack = (StackItemPtr)ABLStackMallocCallback(sizeof(StackItem) * (runtimeStackSize / sizeof(StackItem)));
 	if (!stack)
 		ABL_Fatal(0, " ABL: Unable to AblStackHeap->malloc stack ");
+	EternalDataPtr = stack;
+
+	//--------------------------------------------------------------
+	// The main context runs on this stack. Modules executed while
+	// another is running get a nested context with its own...
+	MainExecContext = new ABLExecContext;
+	if (!MainExecContext)
+		ABL_Fatal(0, " ABL: Unable to malloc main execution context ");
+	MainExecContext->create(stack);
+	CurExecContext = MainExecContext;
 
 	//-----------------------------------
 	// Allocate Eternal Vars Size List...
@@ -929,6 +942,17 @@ void ABLi_close (void) {
 
 	UserFile::cleanup();
 
+	if ((ABLVMMode == ABL_VM_VERIFY) && ABLDebugPrintCallback) {
+		char s[255];
+		sprintf(s, "ABL VM: %ld expressions compiled, %ld interpreted, %ld mismatches\n", ABLVMNumCompiled, ABLVMNumRejected, ABLVMNumMismatches);
+		ABLDebugPrintCallback(s);
+	}
+
+	//------------------------------------------------------------
+	// Compiled expressions point into the code segments, so they
+	// go before the modules do...
+	destroyCompiledExpressions();
+
 	destroyModuleRegistry();
 
 	destroyLibraryRegistry();
@@ -948,10 +972,20 @@ void ABLi_close (void) {
 		codeBuffer = NULL;
 	}
 
-	if (stack) {
-		ABLStackFreeCallback(stack);
-		stack = NULL;
+	if (MainExecContext) {
+		delete MainExecContext;
+		MainExecContext = NULL;
 	}
+	CurExecContext = NULL;
+
+	//----------------------------------------------------------
+	// The main stack, which holds the eternals. The current one
+	// may belong to some other context by now...
+	if (EternalDataPtr) {
+		ABLStackFreeCallback(EternalDataPtr);
+		EternalDataPtr = NULL;
+	}
+	stack = NULL;
 
 	if (debugger) {
 		delete debugger;
@@ -1068,6 +1102,22 @@ bool ABLi_enabled (void) {
 
 //***************************************************************************
 
+void ABLi_setVMMode (long mode) {
+
+	ABLVMMode = mode;
+}
+
+//***************************************************************************
+
+void ABLi_getVMStats (long& numCompiled, long& numRejected, long& numMismatches) {
+
+	numCompiled = ABLVMNumCompiled;
+	numRejected = ABLVMNumRejected;
+	numMismatches = ABLVMNumMismatches;
+}
+
+//***************************************************************************
+
 void ABLi_addFunction (const char* name,
 					   bool isOrder,
 					   const char* paramList,
@@ -42,7 +42,7 @@ extern Literal			curLiteral;
 extern TokenCodeType	statementStartList[];
 extern TokenCodeType	statementEndList[];
 extern SymTableNodePtr	symTableDisplay[];
-extern long				level;
+extern int32_t				level;
 extern char*			codeBuffer;
 extern TypePtr			IntegerTypePtr;
 extern TypePtr			RealTypePtr;
@@ -0,0 +1,1161 @@
+//===========================================================================//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+//***************************************************************************
+//
+//								ABLVM.CPP
+//
+//***************************************************************************
+
+#include<stdio.h>
+#include<string.h>
+
+#ifndef ABLGEN_H
+#include"ablgen.h"
+#endif
+
+#ifndef ABLERR_H
+#include"ablerr.h"
+#endif
+
+#ifndef ABLSCAN_H
+#include"ablscan.h"
+#endif
+
+#ifndef ABLSYMT_H
+#include"ablsymt.h"
+#endif
+
+#ifndef ABLPARSE_H
+#include"ablparse.h"
+#endif
+
+#ifndef ABLEXEC_H
+#include"ablexec.h"
+#endif
+
+#ifndef ABLENV_H
+#include"ablenv.h"
+#endif
+
+#ifndef ABLDBUG_H
+#include"abldbug.h"
+#endif
+
+//***************************************************************************
+// Expressions are the hot spot of the executor: every brain re-walks the same
+// crunched tokens each frame, re-deciding operand types and symbol kinds that
+// never change. The first time an expression is executed, it is compiled into
+// a flat list of instructions with the types folded in and the variables
+// resolved to frame/static/eternal slots. The instructions run against the
+// regular ABL runtime stack, so routine calls, parameters and the ABLi_pop*
+// helpers see exactly what the token walker would have left there. Anything
+// the compiler doesn't understand is left to the token walker.
+//***************************************************************************
+
+//----------
+// EXTERNALS
+
+extern int32_t			level;
+extern char*			codeSegmentPtr;
+extern TokenCodeType	codeToken;
+extern int				execLineNumber;
+
+extern StackItem*		stack;
+extern StackItemPtr		tos;
+extern StackItemPtr		stackFrameBasePtr;
+extern StackItemPtr		StaticDataPtr;
+extern SymTableNodePtr	CurRoutineIdPtr;
+extern ABLModulePtr		CurModule;
+
+extern TypePtr			IntegerTypePtr;
+extern TypePtr			CharTypePtr;
+extern TypePtr			RealTypePtr;
+extern TypePtr			BooleanTypePtr;
+
+extern DebuggerPtr		debugger;
+
+extern void* (*ABLSystemMallocCallback) (unsigned long memSize);
+extern void (*ABLSystemFreeCallback) (void* memBlock);
+extern void (*ABLDebugPrintCallback) (const char* s);
+
+//***************************************************************************
+
+#define	MAX_VM_INSTRUCTIONS		256
+#define	VM_TABLE_MIN_SIZE		1024
+
+#define	VM_PROMOTE_FIRST		1
+#define	VM_PROMOTE_SECOND		2
+
+typedef enum {
+	VM_OP_PUSH_INTEGER,
+	VM_OP_PUSH_REAL,
+	VM_OP_PUSH_BYTE,
+	VM_OP_PUSH_ADDRESS,
+	VM_OP_ADDR_LOCAL,
+	VM_OP_ADDR_ETERNAL,
+	VM_OP_ADDR_STATIC,
+	VM_OP_ADDR_LIBRARY_STATIC,
+	VM_OP_ADDR_REGISTERED,
+	VM_OP_INDEX,
+	VM_OP_LOAD_INTEGER,
+	VM_OP_LOAD_BYTE,
+	VM_OP_LOAD_REAL,
+	VM_OP_TRACE,
+	VM_OP_CALL,
+	VM_OP_NOT,
+	VM_OP_NEG_INTEGER,
+	VM_OP_NEG_REAL,
+	VM_OP_PROMOTE,
+	VM_OP_AND,
+	VM_OP_OR,
+	VM_OP_ADD_INTEGER,
+	VM_OP_SUB_INTEGER,
+	VM_OP_MUL_INTEGER,
+	VM_OP_DIV_INTEGER,
+	VM_OP_MOD_INTEGER,
+	VM_OP_ADD_REAL,
+	VM_OP_SUB_REAL,
+	VM_OP_MUL_REAL,
+	VM_OP_DIV_REAL,
+	VM_OP_CMP_INTEGER,
+	VM_OP_CMP_BYTE,
+	VM_OP_CMP_REAL,
+	VM_OP_CMP_TRUE,
+	VM_OP_CMP_FALSE,
+	NUM_VM_OPS
+} VMOpCode;
+
+typedef struct {
+	unsigned char			opCode;
+	unsigned char			flags;			// deref, promote mask or relational token
+	unsigned char			level;			// VM_OP_ADDR_LOCAL: scope level of the variable
+	union {
+		int					integer;
+		float				real;
+		unsigned char		byte;
+		Address				address;
+		SymTableNodePtr		idPtr;
+		TypePtr				typePtr;
+	} operand;
+	union {
+		char*				resumePtr;		// VM_OP_CALL: code position following the routine id
+		TypePtr				typePtr;		// VM_OP_TRACE: type of the fetched data
+	} aux;
+} VMInstruction;
+
+typedef VMInstruction* VMInstructionPtr;
+
+typedef struct _VMChunk {
+	char*					startPtr;		// codeSegmentPtr on entry to execExpression()
+	char*					endPtr;			// codeSegmentPtr on exit...
+	TokenCodeType			endToken;		// ...and codeToken on exit
+	TypePtr					resultTypePtr;
+	bool					compiled;
+	bool					hasCalls;
+	long					numInstructions;
+	VMInstruction			code[1];
+} VMChunk;
+
+typedef VMChunk* VMChunkPtr;
+
+typedef struct {
+	char*					pc;
+	TokenCodeType			token;
+	VMInstruction			code[MAX_VM_INSTRUCTIONS];
+	long					numInstructions;
+	bool					failed;
+	bool					hasCalls;
+} VMCompiler;
+
+//--------
+// GLOBALS
+
+long					ABLVMMode = ABL_VM_OFF;
+long					ABLVMNumCompiled = 0;
+long					ABLVMNumRejected = 0;
+long					ABLVMNumMismatches = 0;
+
+static VMChunkPtr*		ChunkTable = NULL;
+static unsigned long	ChunkTableSize = 0;
+static unsigned long	NumChunks = 0;
+static long				VMSuspended = 0;
+
+//***************************************************************************
+// COMPILER
+//***************************************************************************
+
+inline void vmGetToken (VMCompiler& c) {
+
+	c.token = (TokenCodeType)*c.pc;
+	c.pc++;
+}
+
+//---------------------------------------------------------------------------
+
+inline SymTableNodePtr vmGetSymTableNodePtr (VMCompiler& c) {
+
+	SymTableNodePtr nodePtr = *((SymTableNodePtr*)c.pc);
+	c.pc += sizeof(SymTableNodePtr);
+	return(nodePtr);
+}
+
+//---------------------------------------------------------------------------
+
+VMInstructionPtr vmEmit (VMCompiler& c, VMOpCode opCode, unsigned char flags = 0) {
+
+	static VMInstruction scratch;
+
+	if (c.numInstructions == MAX_VM_INSTRUCTIONS) {
+		c.failed = true;
+		return(&scratch);
+	}
+	VMInstructionPtr instruction = &c.code[c.numInstructions++];
+	instruction->opCode = opCode;
+	instruction->flags = flags;
+	instruction->level = 0;
+	instruction->operand.address = NULL;
+	instruction->aux.resumePtr = NULL;
+	return(instruction);
+}
+
+//---------------------------------------------------------------------------
+
+TypePtr vmFail (VMCompiler& c) {
+
+	c.failed = true;
+	return(NULL);
+}
+
+//---------------------------------------------------------------------------
+
+unsigned char vmPromoteMask (TypePtr type1Ptr, TypePtr type2Ptr) {
+
+	unsigned char mask = 0;
+	if (type1Ptr == IntegerTypePtr)
+		mask |= VM_PROMOTE_FIRST;
+	if (type2Ptr == IntegerTypePtr)
+		mask |= VM_PROMOTE_SECOND;
+	return(mask);
+}
+
+//---------------------------------------------------------------------------
+
+void vmEmitTrace (VMCompiler& c, SymTableNodePtr idPtr, TypePtr typePtr) {
+
+	//---------------------------------------------------------------
+	// Always emitted: the debugger may be attached (and watches set)
+	// long after the expression was compiled, so whether anything is
+	// traced is decided when the instruction runs...
+	VMInstructionPtr instruction = vmEmit(c, VM_OP_TRACE, (typePtr->form == FRM_ARRAY) ? 1 : 0);
+	instruction->operand.idPtr = idPtr;
+	instruction->aux.typePtr = typePtr;
+}
+
+//---------------------------------------------------------------------------
+
+char* vmSkipParams (char* pc) {
+
+	//-------------------------------------------------------------------
+	// The parameters are compiled when the routine itself evaluates them,
+	// so just step over the parenthesized list. Only expression tokens
+	// may show up in here...
+	long depth = 0;
+	do {
+		TokenCodeType token = (TokenCodeType)*pc++;
+		switch (token) {
+			case TKN_IDENTIFIER:
+			case TKN_NUMBER:
+			case TKN_STRING:
+				pc += sizeof(SymTableNodePtr);
+				break;
+			case TKN_LPAREN:
+				depth++;
+				break;
+			case TKN_RPAREN:
+				depth--;
+				break;
+			case TKN_STAR:
+			case TKN_MINUS:
+			case TKN_PLUS:
+			case TKN_LBRACKET:
+			case TKN_RBRACKET:
+			case TKN_LT:
+			case TKN_GT:
+			case TKN_COMMA:
+			case TKN_FSLASH:
+			case TKN_EQUALEQUAL:
+			case TKN_LE:
+			case TKN_GE:
+			case TKN_NE:
+			case TKN_AND:
+			case TKN_DIV:
+			case TKN_MOD:
+			case TKN_NOT:
+			case TKN_OR:
+				break;
+			default:
+				return(NULL);
+		}
+	} while (depth > 0);
+	return(pc);
+}
+
+//---------------------------------------------------------------------------
+
+TypePtr vmCompileExpression (VMCompiler& c);
+
+//---------------------------------------------------------------------------
+
+TypePtr vmCompileCall (VMCompiler& c, SymTableNodePtr idPtr) {
+
+	char* resumePtr = c.pc;
+	TypePtr typePtr = NULL;
+
+	long key = idPtr->defn.info.routine.key;
+	if (key == RTN_DECLARED) {
+		if (*c.pc == TKN_LPAREN) {
+			if (!idPtr->defn.info.routine.params)
+				return(vmFail(c));
+			c.pc = vmSkipParams(c.pc);
+		}
+		typePtr = (TypePtr)(idPtr->typePtr);
+		}
+	else {
+		//-------------------------------------------------------------
+		// return, print and concat play games with the code stream and
+		// the stack, so leave them to execStandardRoutineCall()...
+		if ((key == RTN_FORWARD) || (key == RTN_RETURN) || (key == RTN_PRINT) ||
+			(key == RTN_CONCAT) || (key >= NumStandardFunctions))
+			return(vmFail(c));
+		if (FunctionInfoTable[key].numParams > 0) {
+			if (*c.pc != TKN_LPAREN)
+				return(vmFail(c));
+			c.pc = vmSkipParams(c.pc);
+			}
+		else if (*c.pc == TKN_LPAREN)
+			return(vmFail(c));
+		switch (FunctionInfoTable[key].returnType) {
+			case RETURN_TYPE_INTEGER:
+				typePtr = IntegerTypePtr;
+				break;
+			case RETURN_TYPE_REAL:
+				typePtr = RealTypePtr;
+				break;
+			case RETURN_TYPE_BOOLEAN:
+				typePtr = BooleanTypePtr;
+				break;
+			default:
+				break;
+		}
+	}
+
+	if (!c.pc || !typePtr)
+		return(vmFail(c));
+
+	VMInstructionPtr instruction = vmEmit(c, VM_OP_CALL);
+	instruction->operand.idPtr = idPtr;
+	instruction->aux.resumePtr = resumePtr;
+	c.hasCalls = true;
+
+	vmGetToken(c);
+	return(typePtr);
+}
+
+//---------------------------------------------------------------------------
+
+TypePtr vmCompileConstant (VMCompiler& c, SymTableNodePtr idPtr) {
+
+	TypePtr typePtr = idPtr->typePtr;
+	if (!typePtr)
+		return(vmFail(c));
+
+	if ((typePtr == IntegerTypePtr) || (typePtr->form == FRM_ENUM))
+		vmEmit(c, VM_OP_PUSH_INTEGER)->operand.integer = idPtr->defn.info.constant.value.integer;
+	else if (typePtr == RealTypePtr)
+		vmEmit(c, VM_OP_PUSH_REAL)->operand.real = idPtr->defn.info.constant.value.real;
+	else if (typePtr == CharTypePtr)
+		vmEmit(c, VM_OP_PUSH_INTEGER)->operand.integer = idPtr->defn.info.constant.value.character;
+	else if (typePtr->form == FRM_ARRAY)
+		vmEmit(c, VM_OP_PUSH_ADDRESS)->operand.address = idPtr->defn.info.constant.value.stringPtr;
+	else
+		return(vmFail(c));
+
+	vmEmitTrace(c, idPtr, typePtr);
+
+	vmGetToken(c);
+	return(typePtr);
+}
+
+//---------------------------------------------------------------------------
+
+TypePtr vmCompileSubscripts (VMCompiler& c, TypePtr typePtr) {
+
+	//-------------------------------------------------------------
+	// Same walk as execSubscripts(), including how the type steps.
+	// The element count and size are fetched when the instruction
+	// runs, since open array parameters get resized on each call...
+	while (c.token == TKN_LBRACKET) {
+		do {
+			if (!typePtr || (typePtr->form != FRM_ARRAY) || !typePtr->info.array.elementTypePtr)
+				return(vmFail(c));
+			vmGetToken(c);
+			if (!vmCompileExpression(c))
+				return(NULL);
+			vmEmit(c, VM_OP_INDEX)->operand.typePtr = typePtr;
+			if (c.token == TKN_COMMA)
+				typePtr = typePtr->info.array.elementTypePtr;
+		} while (c.token == TKN_COMMA);
+
+		vmGetToken(c);
+		if (c.token == TKN_LBRACKET)
+			typePtr = typePtr->info.array.elementTypePtr;
+	}
+	if (!typePtr || (typePtr->form != FRM_ARRAY))
+		return(vmFail(c));
+	return(typePtr->info.array.elementTypePtr);
+}
+
+//---------------------------------------------------------------------------
+
+TypePtr vmCompileVariable (VMCompiler& c, SymTableNodePtr idPtr) {
+
+	TypePtr typePtr = (TypePtr)(idPtr->typePtr);
+	if (!typePtr)
+		return(vmFail(c));
+
+	DefinitionType key = idPtr->defn.key;
+	if ((key != DFN_VAR) && (key != DFN_VALPARAM) && (key != DFN_REFPARAM))
+		return(vmFail(c));
+
+	//--------------------------------------------------------------
+	// Arrays and scalar reference parameters hold a pointer to the
+	// actual data, so their slot has to be dereferenced once more...
+	bool isArray = (typePtr->form == FRM_ARRAY);
+	unsigned char deref = (isArray || (key == DFN_REFPARAM)) ? 1 : 0;
+
+	VMInstructionPtr instruction = NULL;
+	switch (idPtr->defn.info.data.varType) {
+		case VAR_TYPE_NORMAL:
+			instruction = vmEmit(c, VM_OP_ADDR_LOCAL, deref);
+			instruction->operand.integer = idPtr->defn.info.data.offset;
+			instruction->level = idPtr->level;
+			break;
+		case VAR_TYPE_ETERNAL:
+			instruction = vmEmit(c, VM_OP_ADDR_ETERNAL, deref);
+			instruction->operand.integer = idPtr->defn.info.data.offset;
+			break;
+		case VAR_TYPE_STATIC:
+			if (idPtr->library) {
+				instruction = vmEmit(c, VM_OP_ADDR_LIBRARY_STATIC, deref);
+				instruction->operand.idPtr = idPtr;
+				}
+			else {
+				instruction = vmEmit(c, VM_OP_ADDR_STATIC, deref);
+				instruction->operand.integer = idPtr->defn.info.data.offset;
+			}
+			break;
+		case VAR_TYPE_REGISTERED:
+			if (key == DFN_REFPARAM)
+				return(vmFail(c));
+			vmEmit(c, VM_OP_ADDR_REGISTERED)->operand.idPtr = idPtr;
+			break;
+		default:
+			return(vmFail(c));
+	}
+
+	vmGetToken(c);
+	while (c.token == TKN_LBRACKET) {
+		typePtr = vmCompileSubscripts(c, typePtr);
+		if (!typePtr)
+			return(NULL);
+	}
+
+	if (typePtr->form != FRM_ARRAY) {
+		if ((typePtr == IntegerTypePtr) || (typePtr->form == FRM_ENUM))
+			vmEmit(c, VM_OP_LOAD_INTEGER);
+		else if (typePtr == CharTypePtr)
+			vmEmit(c, VM_OP_LOAD_BYTE);
+		else
+			vmEmit(c, VM_OP_LOAD_REAL);
+	}
+
+	vmEmitTrace(c, idPtr, typePtr);
+
+	return(typePtr);
+}
+
+//---------------------------------------------------------------------------
+
+TypePtr vmCompileFactor (VMCompiler& c) {
+
+	TypePtr resultTypePtr = NULL;
+
+	switch (c.token) {
+		case TKN_IDENTIFIER: {
+			SymTableNodePtr idPtr = vmGetSymTableNodePtr(c);
+			if (!idPtr)
+				return(vmFail(c));
+			if (idPtr->defn.key == DFN_FUNCTION)
+				resultTypePtr = vmCompileCall(c, idPtr);
+			else if (idPtr->defn.key == DFN_CONST)
+				resultTypePtr = vmCompileConstant(c, idPtr);
+			else
+				resultTypePtr = vmCompileVariable(c, idPtr);
+			}
+			break;
+		case TKN_NUMBER: {
+			SymTableNodePtr numberPtr = vmGetSymTableNodePtr(c);
+			if (numberPtr->typePtr == IntegerTypePtr) {
+				vmEmit(c, VM_OP_PUSH_INTEGER)->operand.integer = numberPtr->defn.info.constant.value.integer;
+				resultTypePtr = IntegerTypePtr;
+				}
+			else {
+				vmEmit(c, VM_OP_PUSH_REAL)->operand.real = numberPtr->defn.info.constant.value.real;
+				resultTypePtr = RealTypePtr;
+			}
+			vmGetToken(c);
+			}
+			break;
+		case TKN_STRING: {
+			SymTableNodePtr nodePtr = vmGetSymTableNodePtr(c);
+			if (strlen(nodePtr->name) > 1) {
+				vmEmit(c, VM_OP_PUSH_ADDRESS)->operand.address = nodePtr->info;
+				resultTypePtr = nodePtr->typePtr;
+				}
+			else {
+				vmEmit(c, VM_OP_PUSH_BYTE)->operand.byte = nodePtr->name[0];
+				resultTypePtr = CharTypePtr;
+			}
+			vmGetToken(c);
+			}
+			break;
+		case TKN_NOT:
+			vmGetToken(c);
+			resultTypePtr = vmCompileFactor(c);
+			vmEmit(c, VM_OP_NOT);
+			break;
+		case TKN_LPAREN:
+			vmGetToken(c);
+			resultTypePtr = vmCompileExpression(c);
+			vmGetToken(c);
+			break;
+		default:
+			break;
+	}
+
+	if (!resultTypePtr)
+		return(vmFail(c));
+	return(resultTypePtr);
+}
+
+//---------------------------------------------------------------------------
+
+TypePtr vmCompileTerm (VMCompiler& c) {
+
+	TypePtr resultTypePtr = vmCompileFactor(c);
+
+	while (!c.failed &&
+		   ((c.token == TKN_STAR) || (c.token == TKN_FSLASH) ||
+			(c.token == TKN_DIV) || (c.token == TKN_MOD) ||
+			(c.token == TKN_AND))) {
+
+		TokenCodeType op = c.token;
+		vmGetToken(c);
+		TypePtr type2Ptr = vmCompileFactor(c);
+		if (!type2Ptr)
+			return(NULL);
+
+		bool integerOperands = (resultTypePtr == IntegerTypePtr) && (type2Ptr == IntegerTypePtr);
+		switch (op) {
+			case TKN_AND:
+				vmEmit(c, VM_OP_AND);
+				resultTypePtr = BooleanTypePtr;
+				break;
+			case TKN_STAR:
+			case TKN_FSLASH:
+				if (integerOperands) {
+					vmEmit(c, (op == TKN_STAR) ? VM_OP_MUL_INTEGER : VM_OP_DIV_INTEGER);
+					resultTypePtr = IntegerTypePtr;
+					}
+				else {
+					unsigned char mask = vmPromoteMask(resultTypePtr, type2Ptr);
+					if (mask)
+						vmEmit(c, VM_OP_PROMOTE, mask);
+					vmEmit(c, (op == TKN_STAR) ? VM_OP_MUL_REAL : VM_OP_DIV_REAL);
+					resultTypePtr = RealTypePtr;
+				}
+				break;
+			case TKN_DIV:
+				vmEmit(c, VM_OP_DIV_INTEGER);
+				resultTypePtr = IntegerTypePtr;
+				break;
+			case TKN_MOD:
+				vmEmit(c, VM_OP_MOD_INTEGER);
+				resultTypePtr = IntegerTypePtr;
+				break;
+			default:
+				break;
+		}
+	}
+
+	return(c.failed ? NULL : resultTypePtr);
+}
+
+//---------------------------------------------------------------------------
+
+TypePtr vmCompileSimpleExpression (VMCompiler& c) {
+
+	TokenCodeType unaryOp = TKN_PLUS;
+	if ((c.token == TKN_PLUS) || (c.token == TKN_MINUS)) {
+		unaryOp = c.token;
+		vmGetToken(c);
+	}
+
+	TypePtr resultTypePtr = vmCompileTerm(c);
+	if (!resultTypePtr)
+		return(NULL);
+
+	if (unaryOp == TKN_MINUS)
+		vmEmit(c, (resultTypePtr == IntegerTypePtr) ? VM_OP_NEG_INTEGER : VM_OP_NEG_REAL);
+
+	while ((c.token == TKN_PLUS) || (c.token == TKN_MINUS) || (c.token == TKN_OR)) {
+		TokenCodeType op = c.token;
+		vmGetToken(c);
+		TypePtr type2Ptr = vmCompileTerm(c);
+		if (!type2Ptr)
+			return(NULL);
+
+		if (op == TKN_OR) {
+			vmEmit(c, VM_OP_OR);
+			resultTypePtr = BooleanTypePtr;
+			}
+		else if ((resultTypePtr == IntegerTypePtr) && (type2Ptr == IntegerTypePtr)) {
+			vmEmit(c, (op == TKN_PLUS) ? VM_OP_ADD_INTEGER : VM_OP_SUB_INTEGER);
+			resultTypePtr = IntegerTypePtr;
+			}
+		else {
+			unsigned char mask = vmPromoteMask(resultTypePtr, type2Ptr);
+			if (mask)
+				vmEmit(c, VM_OP_PROMOTE, mask);
+			vmEmit(c, (op == TKN_PLUS) ? VM_OP_ADD_REAL : VM_OP_SUB_REAL);
+			resultTypePtr = RealTypePtr;
+		}
+	}
+
+	return(c.failed ? NULL : resultTypePtr);
+}
+
+//---------------------------------------------------------------------------
+
+TypePtr vmCompileExpression (VMCompiler& c) {
+
+	TypePtr resultTypePtr = vmCompileSimpleExpression(c);
+	if (!resultTypePtr)
+		return(NULL);
+
+	if ((c.token == TKN_EQUALEQUAL) || (c.token == TKN_LT) ||
+		(c.token == TKN_GT) || (c.token == TKN_NE) ||
+		(c.token == TKN_LE) || (c.token == TKN_GE)) {
+		TokenCodeType op = c.token;
+		vmGetToken(c);
+		TypePtr type2Ptr = vmCompileSimpleExpression(c);
+		if (!type2Ptr)
+			return(NULL);
+
+		if (((resultTypePtr == IntegerTypePtr) && (type2Ptr == IntegerTypePtr)) ||
+			(resultTypePtr->form == FRM_ENUM))
+			vmEmit(c, VM_OP_CMP_INTEGER, (unsigned char)op);
+		else if (resultTypePtr == CharTypePtr)
+			vmEmit(c, VM_OP_CMP_BYTE, (unsigned char)op);
+		else if ((resultTypePtr->form == FRM_ARRAY) && (resultTypePtr->info.array.elementTypePtr == CharTypePtr))
+			vmEmit(c, VM_OP_CMP_TRUE);
+		else if ((resultTypePtr == RealTypePtr) || (type2Ptr == RealTypePtr)) {
+			unsigned char mask = vmPromoteMask(resultTypePtr, type2Ptr);
+			if (mask)
+				vmEmit(c, VM_OP_PROMOTE, mask);
+			vmEmit(c, VM_OP_CMP_REAL, (unsigned char)op);
+			}
+		else
+			vmEmit(c, VM_OP_CMP_FALSE);
+
+		resultTypePtr = BooleanTypePtr;
+	}
+
+	return(c.failed ? NULL : resultTypePtr);
+}
+
+//***************************************************************************
+// CHUNK TABLE
+//***************************************************************************
+
+inline unsigned long vmHash (char* startPtr) {
+
+	size_t key = (size_t)startPtr;
+	return((unsigned long)((key >> 2) ^ (key >> 13)));
+}
+
+//---------------------------------------------------------------------------
+
+VMChunkPtr vmFindChunk (char* startPtr) {
+
+	if (!ChunkTable)
+		return(NULL);
+
+	unsigned long mask = ChunkTableSize - 1;
+	for (unsigned long i = vmHash(startPtr) & mask; ChunkTable[i]; i = (i + 1) & mask)
+		if (ChunkTable[i]->startPtr == startPtr)
+			return(ChunkTable[i]);
+	return(NULL);
+}
+
+//---------------------------------------------------------------------------
+
+void vmInsertChunk (VMChunkPtr chunk) {
+
+	if ((NumChunks + 1) * 2 > ChunkTableSize) {
+		unsigned long newSize = ChunkTableSize ? (ChunkTableSize * 2) : VM_TABLE_MIN_SIZE;
+		VMChunkPtr* newTable = (VMChunkPtr*)ABLSystemMallocCallback(newSize * sizeof(VMChunkPtr));
+		if (!newTable)
+			ABL_Fatal(0, " ABL: Unable to malloc compiled expression table ");
+		memset(newTable, 0, newSize * sizeof(VMChunkPtr));
+		for (unsigned long i = 0; i < ChunkTableSize; i++)
+			if (ChunkTable[i]) {
+				unsigned long j = vmHash(ChunkTable[i]->startPtr) & (newSize - 1);
+				while (newTable[j])
+					j = (j + 1) & (newSize - 1);
+				newTable[j] = ChunkTable[i];
+			}
+		if (ChunkTable)
+			ABLSystemFreeCallback(ChunkTable);
+		ChunkTable = newTable;
+		ChunkTableSize = newSize;
+	}
+
+	unsigned long mask = ChunkTableSize - 1;
+	unsigned long i = vmHash(chunk->startPtr) & mask;
+	while (ChunkTable[i])
+		i = (i + 1) & mask;
+	ChunkTable[i] = chunk;
+	NumChunks++;
+}
+
+//---------------------------------------------------------------------------
+
+VMChunkPtr vmCompileChunk (char* startPtr, TokenCodeType startToken) {
+
+	VMCompiler* compiler = (VMCompiler*)ABLSystemMallocCallback(sizeof(VMCompiler));
+	if (!compiler)
+		ABL_Fatal(0, " ABL: Unable to malloc expression compiler ");
+	VMCompiler& c = *compiler;
+	c.pc = startPtr;
+	c.token = startToken;
+	c.numInstructions = 0;
+	c.failed = false;
+	c.hasCalls = false;
+
+	TypePtr resultTypePtr = vmCompileExpression(c);
+	if (!resultTypePtr)
+		c.failed = true;
+
+	//-------------------------------------------------------------
+	// Sites we can't compile still get an entry, so we don't try to
+	// compile them again every time they come around...
+	long numInstructions = c.failed ? 0 : c.numInstructions;
+	size_t chunkSize = sizeof(VMChunk) + (numInstructions ? (numInstructions - 1) : 0) * sizeof(VMInstruction);
+	VMChunkPtr chunk = (VMChunkPtr)ABLSystemMallocCallback(chunkSize);
+	if (!chunk)
+		ABL_Fatal(0, " ABL: Unable to malloc compiled expression ");
+	chunk->startPtr = startPtr;
+	chunk->compiled = !c.failed;
+	chunk->hasCalls = c.hasCalls;
+	chunk->numInstructions = numInstructions;
+	if (chunk->compiled) {
+		chunk->endPtr = c.pc;
+		chunk->endToken = c.token;
+		chunk->resultTypePtr = resultTypePtr;
+		memcpy(chunk->code, c.code, numInstructions * sizeof(VMInstruction));
+		ABLVMNumCompiled++;
+		}
+	else {
+		chunk->endPtr = NULL;
+		chunk->endToken = TKN_NONE;
+		chunk->resultTypePtr = NULL;
+		ABLVMNumRejected++;
+	}
+
+	ABLSystemFreeCallback(compiler);
+
+	vmInsertChunk(chunk);
+	return(chunk);
+}
+
+//***************************************************************************
+// VIRTUAL MACHINE
+//***************************************************************************
+
+#define	VM_PUSH() \
+	if (++sp >= stackLimit) \
+		vmRuntimeError(sp, ABL_ERR_RUNTIME_STACK_OVERFLOW)
+
+inline void vmRuntimeError (StackItemPtr sp, int errCode) {
+
+	tos = sp;
+	runtimeError(errCode);
+}
+
+//---------------------------------------------------------------------------
+
+inline bool vmCompare (unsigned char op, int result) {
+
+	switch (op) {
+		case TKN_EQUALEQUAL:
+			return(result == 0);
+		case TKN_LT:
+			return(result < 0);
+		case TKN_GT:
+			return(result > 0);
+		case TKN_NE:
+			return(result != 0);
+		case TKN_LE:
+			return(result <= 0);
+		case TKN_GE:
+			return(result >= 0);
+	}
+	return(false);
+}
+
+//---------------------------------------------------------------------------
+
+void vmRun (VMChunkPtr chunk) {
+
+	VMInstructionPtr instruction = chunk->code;
+	VMInstructionPtr lastInstruction = chunk->code + chunk->numInstructions;
+
+	//-----------------------------------------------------------------
+	// Keep the stack top in a local, so it can live in a register, and
+	// only hand it back to tos when someone else gets to look at the stack...
+	StackItemPtr sp = tos;
+	StackItemPtr stackLimit = &stack[MAXSIZE_STACK];
+
+	for (; instruction < lastInstruction; instruction++) {
+		switch (instruction->opCode) {
+			case VM_OP_PUSH_INTEGER:
+				VM_PUSH();
+				sp->integer = instruction->operand.integer;
+				break;
+			case VM_OP_PUSH_REAL:
+				VM_PUSH();
+				sp->real = instruction->operand.real;
+				break;
+			case VM_OP_PUSH_BYTE:
+				VM_PUSH();
+				sp->byte = instruction->operand.byte;
+				break;
+			case VM_OP_PUSH_ADDRESS:
+				VM_PUSH();
+				sp->address = instruction->operand.address;
+				break;
+			case VM_OP_ADDR_LOCAL: {
+				StackFrameHeaderPtr headerPtr = (StackFrameHeaderPtr)stackFrameBasePtr;
+				long delta = level - instruction->level;
+				while (delta-- > 0)
+					headerPtr = (StackFrameHeaderPtr)headerPtr->staticLink.address;
+				StackItemPtr dataPtr = (StackItemPtr)headerPtr + instruction->operand.integer;
+				VM_PUSH();
+				sp->address = instruction->flags ? dataPtr->address : (Address)dataPtr;
+				}
+				break;
+			case VM_OP_ADDR_ETERNAL: {
+				StackItemPtr dataPtr = EternalDataPtr + instruction->operand.integer;
+				VM_PUSH();
+				sp->address = instruction->flags ? dataPtr->address : (Address)dataPtr;
+				}
+				break;
+			case VM_OP_ADDR_STATIC: {
+				StackItemPtr dataPtr = (StackItemPtr)StaticDataPtr + instruction->operand.integer;
+				VM_PUSH();
+				sp->address = instruction->flags ? dataPtr->address : (Address)dataPtr;
+				}
+				break;
+			case VM_OP_ADDR_LIBRARY_STATIC: {
+				SymTableNodePtr idPtr = instruction->operand.idPtr;
+				if (idPtr->library != CurModule)
+					StaticDataPtr = idPtr->library->getStaticData();
+				StackItemPtr dataPtr = (StackItemPtr)StaticDataPtr + idPtr->defn.info.data.offset;
+				if (idPtr->library != CurModule)
+					StaticDataPtr = CurModule->getStaticData();
+				VM_PUSH();
+				sp->address = instruction->flags ? dataPtr->address : (Address)dataPtr;
+				}
+				break;
+			case VM_OP_ADDR_REGISTERED:
+				VM_PUSH();
+				sp->address = (Address)instruction->operand.idPtr->defn.info.data.registeredData;
+				break;
+			case VM_OP_INDEX: {
+				TypePtr typePtr = instruction->operand.typePtr;
+				int subscriptValue = sp->integer;
+				--sp;
+				if ((subscriptValue < 0) || (subscriptValue >= typePtr->info.array.elementCount))
+					vmRuntimeError(sp, ABL_ERR_RUNTIME_VALUE_OUT_OF_RANGE);
+				sp->address += (subscriptValue * typePtr->info.array.elementTypePtr->size);
+				}
+				break;
+			case VM_OP_LOAD_INTEGER:
+				sp->integer = *((int*)sp->address);
+				break;
+			case VM_OP_LOAD_BYTE:
+				sp->byte = *((char*)sp->address);
+				break;
+			case VM_OP_LOAD_REAL:
+				sp->real = *((float*)sp->address);
+				break;
+			case VM_OP_TRACE:
+				if (debugger) {
+					if (instruction->flags)
+						debugger->traceDataFetch(instruction->operand.idPtr, instruction->aux.typePtr, (StackItemPtr)sp->address);
+					else
+						debugger->traceDataFetch(instruction->operand.idPtr, instruction->aux.typePtr, sp);
+				}
+				break;
+			case VM_OP_CALL: {
+				//-----------------------------------------------------------
+				// Hand the routine the code stream just as execFactor() would
+				// have: positioned right after the routine's id...
+				SymTableNodePtr thisRoutineIdPtr = CurRoutineIdPtr;
+				codeSegmentPtr = instruction->aux.resumePtr;
+				codeToken = TKN_IDENTIFIER;
+				tos = sp;
+				execRoutineCall(instruction->operand.idPtr, false);
+				sp = tos;
+				CurRoutineIdPtr = thisRoutineIdPtr;
+				}
+				break;
+			case VM_OP_NOT:
+				sp->integer = 1 - sp->integer;
+				break;
+			case VM_OP_NEG_INTEGER:
+				sp->integer = -(sp->integer);
+				break;
+			case VM_OP_NEG_REAL:
+				sp->real = -(sp->real);
+				break;
+			case VM_OP_PROMOTE:
+				if (instruction->flags & VM_PROMOTE_FIRST)
+					sp[-1].real = (float)(sp[-1].integer);
+				if (instruction->flags & VM_PROMOTE_SECOND)
+					sp->real = (float)(sp->integer);
+				break;
+			case VM_OP_AND:
+				sp[-1].integer = sp[-1].integer && sp->integer;
+				--sp;
+				break;
+			case VM_OP_OR:
+				sp[-1].integer = sp[-1].integer || sp->integer;
+				--sp;
+				break;
+			case VM_OP_ADD_INTEGER:
+				sp[-1].integer = sp[-1].integer + sp->integer;
+				--sp;
+				break;
+			case VM_OP_SUB_INTEGER:
+				sp[-1].integer = sp[-1].integer - sp->integer;
+				--sp;
+				break;
+			case VM_OP_MUL_INTEGER:
+				sp[-1].integer = sp[-1].integer * sp->integer;
+				--sp;
+				break;
+			case VM_OP_DIV_INTEGER:
+				if (sp->integer == 0)
+#ifdef _DEBUG
+					vmRuntimeError(sp, ABL_ERR_RUNTIME_DIVISION_BY_ZERO);
+#else
+					sp[-1].integer = 0;
+#endif
+				else
+					sp[-1].integer = sp[-1].integer / sp->integer;
+				--sp;
+				break;
+			case VM_OP_MOD_INTEGER:
+				if (sp->integer == 0)
+#ifdef _DEBUG
+					vmRuntimeError(sp, ABL_ERR_RUNTIME_DIVISION_BY_ZERO);
+#else
+					sp[-1].integer = 0;
+#endif
+				else
+					sp[-1].integer = sp[-1].integer % sp->integer;
+				--sp;
+				break;
+			case VM_OP_ADD_REAL:
+				sp[-1].real = sp[-1].real + sp->real;
+				--sp;
+				break;
+			case VM_OP_SUB_REAL:
+				sp[-1].real = sp[-1].real - sp->real;
+				--sp;
+				break;
+			case VM_OP_MUL_REAL:
+				sp[-1].real = sp[-1].real * sp->real;
+				--sp;
+				break;
+			case VM_OP_DIV_REAL:
+				if (sp->real == 0.0)
+#ifdef _DEBUG
+					vmRuntimeError(sp, ABL_ERR_RUNTIME_DIVISION_BY_ZERO);
+#else
+					sp[-1].real = 0.0;
+#endif
+				else
+					sp[-1].real = sp[-1].real / sp->real;
+				--sp;
+				break;
+			case VM_OP_CMP_INTEGER: {
+				int op1 = sp[-1].integer;
+				int op2 = sp->integer;
+				sp[-1].integer = vmCompare(instruction->flags, (op1 < op2) ? -1 : ((op1 > op2) ? 1 : 0)) ? 1 : 0;
+				--sp;
+				}
+				break;
+			case VM_OP_CMP_BYTE: {
+				unsigned char op1 = sp[-1].byte;
+				unsigned char op2 = sp->byte;
+				sp[-1].integer = vmCompare(instruction->flags, (op1 < op2) ? -1 : ((op1 > op2) ? 1 : 0)) ? 1 : 0;
+				--sp;
+				}
+				break;
+			case VM_OP_CMP_REAL: {
+				//-----------------------------------------------------
+				// Not folded into vmCompare(), so NaNs compare the way
+				// they do in execExpression()...
+				float op1 = sp[-1].real;
+				float op2 = sp->real;
+				bool result = false;
+				switch (instruction->flags) {
+					case TKN_EQUALEQUAL:
+						result = op1 == op2;
+						break;
+					case TKN_LT:
+						result = op1 < op2;
+						break;
+					case TKN_GT:
+						result = op1 > op2;
+						break;
+					case TKN_NE:
+						result = op1 != op2;
+						break;
+					case TKN_LE:
+						result = op1 <= op2;
+						break;
+					case TKN_GE:
+						result = op1 >= op2;
+						break;
+				}
+				sp[-1].integer = result ? 1 : 0;
+				--sp;
+				}
+				break;
+			case VM_OP_CMP_TRUE:
+				sp[-1].integer = 1;
+				--sp;
+				break;
+			case VM_OP_CMP_FALSE:
+				sp[-1].integer = 0;
+				--sp;
+				break;
+		}
+	}
+
+	tos = sp;
+	codeSegmentPtr = chunk->endPtr;
+	codeToken = chunk->endToken;
+}
+
+//---------------------------------------------------------------------------
+
+void vmVerify (VMChunkPtr chunk, TypePtr& resultTypePtr) {
+
+	//-------------------------------------------------------------------
+	// Run the compiled code, rewind, and run the token walker over the
+	// same expression. Only done for expressions without routine calls,
+	// which are free of side effects and can safely be evaluated twice.
+	// The token walker's result is the one that's kept...
+	char* startPtr = codeSegmentPtr;
+	TokenCodeType startToken = codeToken;
+	StackItemPtr startTos = tos;
+
+	vmRun(chunk);
+	StackItemPtr vmTos = tos;
+	StackItem vmResult = *tos;
+
+	tos = startTos;
+	codeSegmentPtr = startPtr;
+	codeToken = startToken;
+
+	VMSuspended++;
+	resultTypePtr = interpretExpression();
+	VMSuspended--;
+
+	if ((resultTypePtr != chunk->resultTypePtr) || (tos != vmTos) ||
+		(codeSegmentPtr != chunk->endPtr) || (codeToken != chunk->endToken) ||
+		memcmp(&vmResult, tos, sizeof(StackItem))) {
+		ABLVMNumMismatches++;
+		if (ABLDebugPrintCallback) {
+			char message[255];
+			sprintf(message, "ABL VM MISMATCH: %s [line %d] - vm 0x%08x, interpreter 0x%08x\n",
+					CurModule ? CurModule->getName() : "unavailable", execLineNumber, vmResult.integer, tos->integer);
+			ABLDebugPrintCallback(message);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+
+bool execCompiledExpression (TypePtr& resultTypePtr) {
+
+	if (VMSuspended)
+		return(false);
+
+	//------------------------------------------------------------
+	// The crunched code always has the current token right behind
+	// the code pointer. If not, somebody is feeding us a token by
+	// hand and we'd better not guess...
+	char* startPtr = codeSegmentPtr;
+	if (codeToken != (TokenCodeType)startPtr[-1])
+		return(false);
+
+	VMChunkPtr chunk = vmFindChunk(startPtr);
+	if (!chunk)
+		chunk = vmCompileChunk(startPtr, codeToken);
+	if (!chunk->compiled)
+		return(false);
+
+	if ((ABLVMMode == ABL_VM_VERIFY) && !chunk->hasCalls) {
+		vmVerify(chunk, resultTypePtr);
+		return(true);
+	}
+
+	vmRun(chunk);
+	resultTypePtr = chunk->resultTypePtr;
+	return(true);
+}
+
+//---------------------------------------------------------------------------
+
+void destroyCompiledExpressions (void) {
+
+	if (ChunkTable) {
+		for (unsigned long i = 0; i < ChunkTableSize; i++)
+			if (ChunkTable[i])
+				ABLSystemFreeCallback(ChunkTable[i]);
+		ABLSystemFreeCallback(ChunkTable);
+		ChunkTable = NULL;
+	}
+	ChunkTableSize = 0;
+	NumChunks = 0;
+	VMSuspended = 0;
+}
+
+//***************************************************************************
@@ -147,7 +147,7 @@ TypePtr execVariable (SymTableNodePtr idPtr, UseType use) {
 			}
 			break;
 		case VAR_TYPE_ETERNAL:
-			dataPtr = (StackItemPtr)stack + idPtr->defn.info.data.offset;
+			dataPtr = EternalDataPtr + idPtr->defn.info.data.offset;
 			break;
 		case VAR_TYPE_STATIC:
 			//---------------------------------------------------------
@@ -466,7 +466,7 @@ TypePtr execSimpleExpression (void) {
 
 //***************************************************************************
 
-TypePtr execExpression (void) {
+TypePtr interpretExpression (void) {
 
 	StackItemPtr		operand1Ptr;
 	StackItemPtr		operand2Ptr;
@@ -587,6 +587,17 @@ TypePtr execExpression (void) {
 
 //***************************************************************************
 
+TypePtr execExpression (void) {
 
+	//--------------------------------------------------------------
+	// Run the compiled form of the expression, if it has one (see
+	// ablvm.cpp). Otherwise, walk the tokens...
+	if (ABLVMMode != ABL_VM_OFF) {
+		TypePtr resultTypePtr = NULL;
+		if (execCompiledExpression(resultTypePtr))
+			return(resultTypePtr);
+	}
+	return(interpretExpression());
+}
 
-
+//***************************************************************************
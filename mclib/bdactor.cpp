@@ -2889,14 +2889,13 @@ long BldgAppearance::markMoveMap (bool passable, long* lineOfSightRect, bool use
 						
 					//----------------
 					// Mark the map...
-					MapCellPtr curCell = GameMap->getCell(cellR, cellC);
 					if (appearType->isForestClump) {
 						if (vertexPos.z <= 1.0f)
-							curCell->setPassable(passable);
+							GameMap->setPassable(cellR, cellC, passable);
 						}
 					else {
 						if (vertexPos.z >= 1.0f)
-							curCell->setPassable(passable);
+							GameMap->setPassable(cellR, cellC, passable);
 					}
 				}
 			}
@@ -2972,11 +2971,11 @@ void BldgAppearance::markLOS (bool clearIt)
 						cellLocalHeight = 15.0f;
 
 					if (cellLocalHeight > currentCellHeight)
-						curCell->setLocalHeight(cellLocalHeight+0.5f);
+						GameMap->setLocalHeight(cellR, cellC, cellLocalHeight+0.5f);
 				}
 				else	//We want to clear all LOS height INFO.  We're about to change shape!!
 				{
-					curCell->setLocalHeight(0.0f);
+					GameMap->setLocalHeight(cellR, cellC, 0.0f);
 				}
 			}
 		}
@@ -4293,11 +4292,11 @@ void TreeAppearance::markLOS (bool clearIt)
 				if (!clearIt)
 				{
 					if (cellLocalHeight > currentCellHeight)
-						curCell->setLocalHeight(cellLocalHeight+0.5f);
+						GameMap->setLocalHeight(cellR, cellC, cellLocalHeight+0.5f);
 				}
 				else	//We want to clear all LOS height INFO.  We're about to change shape!!
 				{
-					curCell->setLocalHeight(0.0f);
+					GameMap->setLocalHeight(cellR, cellC, 0.0f);
 				}
 			}
 		}
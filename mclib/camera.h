@@ -574,6 +574,11 @@ class Camera
 			return screenResolution;
 		}
 
+		const Stuff::Matrix4D &getWorldToClip (void)
+		{
+			return worldToClip;
+		}
+
 		bool getIsNight (void)
 		{
 			return isNight;
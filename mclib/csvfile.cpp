@@ -21,6 +21,10 @@
 #include"heap.h"
 #endif
 
+#ifndef DATACACHE_H
+#include"datacache.h"
+#endif
+
 #include<stdio.h>
 #include<stdlib.h>
 #include<math.h>
@@ -46,6 +50,15 @@
 CSVFile::CSVFile (void) : File()
 {
 	totalRows = totalCols = 0L;
+
+	cacheFile = NULL;
+	cacheCells = NULL;
+	cacheStrings = NULL;
+	cacheCols = 0;
+
+	indexCells = NULL;
+	indexText = NULL;
+	indexTextSize = 0;
 }
 
 //---------------------------------------------------------------------------
@@ -109,7 +122,151 @@ long CSVFile::countCols (void)
 }
 
 //---------------------------------------------------------------------------
-long CSVFile::getNextWord (char *&line, char *buffer, unsigned long bufLen)
+long CSVFile::loadCache (const char *cacheName, DWORD sourceSize, DWORD sourceStamp)
+{
+	cacheFile = new DataCacheFile;
+	gosASSERT(cacheFile != NULL);
+
+	long result = cacheFile->openCache(cacheName,DATA_CACHE_CSV,sourceSize,sourceStamp);
+	if (result == NO_ERR)
+	{
+		DWORD numCells = 0, numChars = 0;
+		totalRows = cacheFile->getInfo(0);
+		totalCols = cacheFile->getInfo(1);
+		cacheCols = totalCols ? totalCols : 1;
+		cacheCells = (CSVCellNode *)cacheFile->getSection(0,sizeof(CSVCellNode),numCells);
+		cacheStrings = (char *)cacheFile->getSection(1,sizeof(char),numChars);
+
+		if (cacheCells && cacheStrings && numChars && (cacheStrings[numChars-1] == '\0') &&
+			(numCells == totalRows * cacheCols))
+		{
+			return(NO_ERR);
+		}
+
+		result = DATA_CACHE_BAD_SECTION;
+	}
+
+	totalRows = totalCols = 0;
+	cacheCells = NULL;
+	cacheStrings = NULL;
+	cacheCols = 0;
+
+	delete cacheFile;
+	cacheFile = NULL;
+
+	return(result);
+}
+
+//---------------------------------------------------------------------------
+void CSVFile::buildIndex (void)
+{
+	//------------------------------------------------------------------
+	// Run what the reads used to do for every cell, but in one pass over
+	// the file, so that finding a cell later is just a table lookup.
+	// Column 0 reads the same as column 1, so it isn't stored.
+	//
+	// Each line is kept as is and its commas turned into NULLs once its
+	// cells are found.  A word runs to the next comma, so that leaves
+	// every cell's text NULL terminated right where it sits in the line.
+	DWORD numCols = totalCols ? totalCols : 1;
+	DWORD numCells = totalRows * numCols;
+
+	indexCells = (CSVCellNode *)systemHeap->Malloc(sizeof(CSVCellNode) * (numCells + 1));
+	indexText = (char *)systemHeap->Malloc(getLength() + totalRows + 1);
+	gosASSERT((indexCells != NULL) && (indexText != NULL));
+
+	indexTextSize = 0;
+	indexText[indexTextSize++] = '\0';
+
+	long oldPosition = logicalPosition;
+	seek(0);
+
+	char tmp[2048];
+	for (DWORD row=0;row<totalRows;row++)
+	{
+		//-------------------------------------------------------------
+		// readLine can fill all of its buffer before it cuts the line,
+		// so it can't read straight into the index.
+		readLine((MemoryPtr)tmp,2047);
+		unsigned long lineLength = strlen(tmp);
+
+		char *line = indexText + indexTextSize;
+		memcpy(line,tmp,lineLength + 1);
+
+		char *currentChk = line;
+		for (DWORD col=0;col<numCols;col++)
+		{
+			if (col && currentChk)
+			{
+				currentChk = strstr(currentChk,",");
+				if (currentChk)
+					currentChk++;
+			}
+
+			CSVCellNode &cell = indexCells[row * numCols + col];
+			cell.textOffset = 0;
+			cell.result = -1;
+			cell.floatValue = 0.0f;
+			cell.longValue = 0;
+			cell.boolValue = false;
+
+			if (currentChk)
+			{
+				char *word = currentChk;
+				char *startOfWord = NULL;
+				unsigned long wordLength = 0;
+				cell.result = findNextWord(word,startOfWord,wordLength,2047);
+				if (cell.result == NO_ERR)
+					cell.textOffset = startOfWord - indexText;
+			}
+		}
+
+		for (unsigned long i=0;i<lineLength;i++)
+		{
+			if (line[i] == ',')
+				line[i] = '\0';
+		}
+
+		//-------------------------------------------------------------
+		// Now each cell's text ends where the cell does, convert it the
+		// way the read* calls would.
+		for (DWORD col=0;col<numCols;col++)
+		{
+			CSVCellNode &cell = indexCells[row * numCols + col];
+			if (cell.result == NO_ERR)
+			{
+				char *text = indexText + cell.textOffset;
+				cell.floatValue = textToFloat(text);
+				cell.longValue = textToLong(text);
+				cell.boolValue = booleanToLong(text);
+			}
+		}
+
+		indexTextSize += lineLength + 1;
+	}
+
+	seek(oldPosition);
+
+	cacheCells = indexCells;
+	cacheStrings = indexText;
+	cacheCols = numCols;
+}
+
+//---------------------------------------------------------------------------
+void CSVFile::saveCache (const char *cacheName, DWORD sourceSize, DWORD sourceStamp)
+{
+	//-----------------------------------------------------------
+	// The index already has every cell split out, write it as is.
+	DWORD info[DATA_CACHE_MAX_INFO] = {totalRows, totalCols, 0, 0};
+	MemoryPtr data[2] = {(MemoryPtr)indexCells, (MemoryPtr)indexText};
+	DWORD recordSize[2] = {sizeof(CSVCellNode), sizeof(char)};
+	DWORD count[2] = {totalRows * cacheCols, indexTextSize};
+
+	DataCacheFile::writeCache(cacheName,DATA_CACHE_CSV,sourceSize,sourceStamp,info,2,data,recordSize,count);
+}
+
+//---------------------------------------------------------------------------
+long CSVFile::findNextWord (char *&line, char *&startOfWord, unsigned long &wordLength, unsigned long bufLen)
 {
 	//--------------------------------------------------
 	// Check to see if we are at end of line
@@ -143,8 +300,8 @@ long CSVFile::getNextWord (char *&line, char *buffer, unsigned long bufLen)
 		
 	//-------------------------------------------
 	// Find length of word from current location
-	char *startOfWord = line;
-	unsigned long wordLength = 0;
+	startOfWord = line;
+	wordLength = 0;
 	while ((*line != '\0') && ((*line != ',')))
 	{
 		line++;
@@ -154,6 +311,18 @@ long CSVFile::getNextWord (char *&line, char *buffer, unsigned long bufLen)
 	if (wordLength > bufLen)
 		return(-2);
 		
+	return(NO_ERR);
+}
+
+//---------------------------------------------------------------------------
+long CSVFile::getNextWord (char *&line, char *buffer, unsigned long bufLen)
+{
+	char *startOfWord = NULL;
+	unsigned long wordLength = 0;
+	long result = findNextWord(line,startOfWord,wordLength,bufLen);
+	if (result != NO_ERR)
+		return(result);
+
 	strncpy(buffer, startOfWord, wordLength);
 	buffer[wordLength] = '\0';
 	
@@ -172,10 +341,26 @@ long CSVFile::afterOpen (void)
 	}
 	else
 	{
+		//------------------------------------------------------
+		// If there is an up to date data cache for this file,
+		// every cell is already split out in it.
+		char cacheName[1024];
+		DWORD sourceSize = 0, sourceStamp = 0;
+		bool useCache = DataCacheFile::makeCacheName(this,cacheName,1023) &&
+						(DataCacheFile::stampSource(this,sourceSize,sourceStamp) == NO_ERR);
+
+		if (useCache && (loadCache(cacheName,sourceSize,sourceStamp) == NO_ERR))
+			return(NO_ERR);
+
 		//------------------------------------------------------
 		// Find out how many Rows and cols we have
 		totalRows = countRows();
 		totalCols = countCols();
+
+		buildIndex();
+
+		if (useCache && DataCacheFile::writeDataCache)
+			saveCache(cacheName,sourceSize,sourceStamp);
 	}
 
 	return(NO_ERR);
@@ -192,6 +377,30 @@ void CSVFile::atClose (void)
 	}
 
 	totalRows = totalCols = 0;
+
+	if (cacheFile)
+	{
+		delete cacheFile;
+		cacheFile = NULL;
+	}
+
+	if (indexCells)
+	{
+		systemHeap->Free(indexCells);
+		indexCells = NULL;
+	}
+
+	if (indexText)
+	{
+		systemHeap->Free(indexText);
+		indexText = NULL;
+	}
+
+	indexTextSize = 0;
+
+	cacheCells = NULL;
+	cacheStrings = NULL;
+	cacheCols = 0;
 }
 
 //---------------------------------------------------------------------------
@@ -216,16 +425,10 @@ long CSVFile::textToLong (char *num)
 	else
 	{
 		hexOffset += 2;
-		long numDigits = strlen(hexOffset)-1;
-		for (int i=0; i<=numDigits; i++)
-		{
-			if (!isalnum(hexOffset[i]) || (isalpha(hexOffset[i]) && toupper(hexOffset[i]) > 'F'))
-			{
-				hexOffset[i] = 0;	// we've reach a "wrong" character. Either start of a comment or something illegal. Either way, stop evaluation here.
-				break;
-			}
-		}
-		numDigits = strlen(hexOffset)-1;
+		long numDigits = 0;
+		while (isalnum(hexOffset[numDigits]) && !(isalpha(hexOffset[numDigits]) && toupper(hexOffset[numDigits]) > 'F'))
+			numDigits++;	// stop at a "wrong" character. Either start of a comment or something illegal.
+		numDigits--;
 		long power = 0;
 		for (long count = numDigits;count >= 0;count--,power++)
 		{
@@ -269,16 +472,10 @@ short CSVFile::textToShort (char *num)
 	else
 	{
 		hexOffset += 2;
-		long numDigits = strlen(hexOffset)-1;
-		for (int i=0; i<=numDigits; i++)
-		{
-			if (!isalnum(hexOffset[i]) || (isalpha(hexOffset[i]) && toupper(hexOffset[i]) > 'F'))
-			{
-				hexOffset[i] = 0;	// we've reach a "wrong" character. Either start of a comment or something illegal. Either way, stop evaluation here.
-				break;
-			}
-		}
-		numDigits = strlen(hexOffset)-1;
+		long numDigits = 0;
+		while (isalnum(hexOffset[numDigits]) && !(isalpha(hexOffset[numDigits]) && toupper(hexOffset[numDigits]) > 'F'))
+			numDigits++;	// stop at a "wrong" character. Either start of a comment or something illegal.
+		numDigits--;
 		long power = 0;
 		for (long count = numDigits;count >= 0;count--,power++)
 		{
@@ -321,16 +518,10 @@ char CSVFile::textToChar (char *num)
 	else
 	{
 		hexOffset += 2;
-		long numDigits = strlen(hexOffset)-1;
-		for (int i=0; i<=numDigits; i++)
-		{
-			if (!isalnum(hexOffset[i]) || (isalpha(hexOffset[i]) && toupper(hexOffset[i]) > 'F'))
-			{
-				hexOffset[i] = 0;	// we've reach a "wrong" character. Either start of a comment or something illegal. Either way, stop evaluation here.
-				break;
-			}
-		}
-		numDigits = strlen(hexOffset)-1;
+		long numDigits = 0;
+		while (isalnum(hexOffset[numDigits]) && !(isalpha(hexOffset[numDigits]) && toupper(hexOffset[numDigits]) > 'F'))
+			numDigits++;	// stop at a "wrong" character. Either start of a comment or something illegal.
+		numDigits--;
 		long power = 0;
 		for (long count = numDigits;count >= 0;count--,power++)
 		{
@@ -372,16 +563,10 @@ unsigned long CSVFile::textToULong (char *num)
 	else
 	{
 		hexOffset += 2;
-		long numDigits = strlen(hexOffset)-1;
-		for (int i=0; i<=numDigits; i++)
-		{
-			if (!isalnum(hexOffset[i]) || (isalpha(hexOffset[i]) && toupper(hexOffset[i]) > 'F'))
-			{
-				hexOffset[i] = 0;	// we've reach a "wrong" character. Either start of a comment or something illegal. Either way, stop evaluation here.
-				break;
-			}
-		}
-		numDigits = strlen(hexOffset)-1;
+		long numDigits = 0;
+		while (isalnum(hexOffset[numDigits]) && !(isalpha(hexOffset[numDigits]) && toupper(hexOffset[numDigits]) > 'F'))
+			numDigits++;	// stop at a "wrong" character. Either start of a comment or something illegal.
+		numDigits--;
 		long power = 0;
 		for (long count = numDigits;count >= 0;count--,power++)
 		{
@@ -424,16 +609,10 @@ unsigned short CSVFile::textToUShort (char *num)
 	else
 	{
 		hexOffset += 2;
-		long numDigits = strlen(hexOffset)-1;
-		for (int i=0; i<=numDigits; i++)
-		{
-			if (!isalnum(hexOffset[i]) || (isalpha(hexOffset[i]) && toupper(hexOffset[i]) > 'F'))
-			{
-				hexOffset[i] = 0;	// we've reach a "wrong" character. Either start of a comment or something illegal. Either way, stop evaluation here.
-				break;
-			}
-		}
-		numDigits = strlen(hexOffset)-1;
+		long numDigits = 0;
+		while (isalnum(hexOffset[numDigits]) && !(isalpha(hexOffset[numDigits]) && toupper(hexOffset[numDigits]) > 'F'))
+			numDigits++;	// stop at a "wrong" character. Either start of a comment or something illegal.
+		numDigits--;
 		long power = 0;
 		for (long count = numDigits;count >= 0;count--,power++)
 		{
@@ -476,16 +655,10 @@ unsigned char CSVFile::textToUChar (char *num)
 	else
 	{
 		hexOffset += 2;
-		long numDigits = strlen(hexOffset)-1;
-		for (int i=0; i<=numDigits; i++)
-		{
-			if (!isalnum(hexOffset[i]) || (isalpha(hexOffset[i]) && toupper(hexOffset[i]) > 'F'))
-			{
-				hexOffset[i] = 0;	// we've reach a "wrong" character. Either start of a comment or something illegal. Either way, stop evaluation here.
-				break;
-			}
-		}
-		numDigits = strlen(hexOffset)-1;
+		long numDigits = 0;
+		while (isalnum(hexOffset[numDigits]) && !(isalpha(hexOffset[numDigits]) && toupper(hexOffset[numDigits]) > 'F'))
+			numDigits++;	// stop at a "wrong" character. Either start of a comment or something illegal.
+		numDigits--;
 		long power = 0;
 		for (long count = numDigits;count >= 0;count--,power++)
 		{
@@ -684,61 +857,48 @@ void CSVFile::close (void)
 }
 
 //---------------------------------------------------------------------------
-long CSVFile::seekRowCol (DWORD row, DWORD col)
+CSVCellNode *CSVFile::getCell (DWORD row, DWORD col)
 {
-	if ((row > totalRows) || (col > totalCols))
-		return -1;
-		
-	DWORD rowCount = 0;
-	
-	seek(0);		//Start at the top.
-	char tmp[2048];
-	
-	do
-	{
-		rowCount++;
-		readLine((MemoryPtr)tmp,2047);
-	} while (rowCount != row);  
-	
-	char *currentChk = tmp;
-	if (col)
-	{
-		DWORD colCount = 1;
-		
-		while (currentChk && (colCount != col))
-		{
-			colCount++;
-			currentChk = strstr(currentChk,",");
-			if ( currentChk ) // if we increment to one, bad things happen
-				currentChk++;
+	if ((row == 0) || (row > totalRows) || (col > totalCols) || !cacheCells)
+		return NULL;
 
-		}
-	}
-	
-	//---------------------------------------------------
-	// We are now pointing at the row and col specified.
-	if (currentChk)
-	{
-		char *data = dataBuffer;
-		return getNextWord(currentChk,data,2047);
-	}
-	else
-	{
+	return &cacheCells[(row-1) * cacheCols + (col ? col-1 : 0)];
+}
+
+//---------------------------------------------------------------------------
+long CSVFile::findCell (DWORD row, DWORD col, char *&text)
+{
+	//---------------------------------------------------------------
+	// Points text at the cell's text in the index or the data cache.
+	// Nothing is copied, so readers must not write to it.
+	CSVCellNode *cell = getCell(row,col);
+	if (!cell)
 		return -1;
-		// CAN'T do this, for some reason excel writes out empty rows.
-		//STOP(("Unable to parse CSV %s, ROW %d, COL %D, ERROR: NULL",getFilename(),row,col));
-	}
-	
-	//return(NO_ERR);
+
+	if (cell->result == NO_ERR)
+		text = cacheStrings + cell->textOffset;
+
+	return cell->result;
 }
 
 //---------------------------------------------------------------------------
-long CSVFile::readFloat (DWORD row, DWORD col, float &value)
+long CSVFile::seekRowCol (DWORD row, DWORD col)
 {
-	long result = seekRowCol(row,col);
+	char *text = NULL;
+	long result = findCell(row,col,text);
 	if (result == NO_ERR)
+		strcpy(dataBuffer,text);
+
+	return result;
+}
+
+//---------------------------------------------------------------------------
+long CSVFile::readFloat (DWORD row, DWORD col, float &value)
+{
+	CSVCellNode *cell = getCell(row,col);
+	if (cell && (cell->result == NO_ERR))
 	{
-		value = textToFloat(dataBuffer);
+		value = cell->floatValue;
 	}
 	else
 		value = 0.0f;
@@ -758,10 +918,10 @@ long CSVFile::readInt (DWORD row, DWORD col, int &value)
 //---------------------------------------------------------------------------
 long CSVFile::readLong (DWORD row, DWORD col, long &value)
 {
-	long result = seekRowCol(row,col);
-	if (result == NO_ERR)
+	CSVCellNode *cell = getCell(row,col);
+	if (cell && (cell->result == NO_ERR))
 	{
-		value = textToLong(dataBuffer);
+		value = cell->longValue;
 	}
 	else
 		value = 0.0f;
@@ -772,10 +932,10 @@ long CSVFile::readLong (DWORD row, DWORD col, long &value)
 //---------------------------------------------------------------------------
 long CSVFile::readBoolean (DWORD row, DWORD col, bool &value)
 {
-	long result = seekRowCol(row,col);
-	if (result == NO_ERR)
+	CSVCellNode *cell = getCell(row,col);
+	if (cell && (cell->result == NO_ERR))
 	{
-		value = booleanToLong(dataBuffer);
+		value = cell->boolValue;
 	}
 	else
 		value = 0;
@@ -786,10 +946,10 @@ long CSVFile::readBoolean (DWORD row, DWORD col, bool &value)
 //---------------------------------------------------------------------------
 long CSVFile::readShort (DWORD row, DWORD col, short &value)
 {
-	long result = seekRowCol(row,col);
-	if (result == NO_ERR)
+	CSVCellNode *cell = getCell(row,col);
+	if (cell && (cell->result == NO_ERR))
 	{
-		value = textToShort(dataBuffer);
+		value = (short)cell->longValue;
 	}
 	else
 		value = 0.0f;
@@ -800,10 +960,10 @@ long CSVFile::readShort (DWORD row, DWORD col, short &value)
 //---------------------------------------------------------------------------
 long CSVFile::readChar (DWORD row, DWORD col, char &value)
 {
-	long result = seekRowCol(row,col);
-	if (result == NO_ERR)
+	CSVCellNode *cell = getCell(row,col);
+	if (cell && (cell->result == NO_ERR))
 	{
-		value = textToChar(dataBuffer);
+		value = (char)cell->longValue;
 	}
 	else
 		value = 0.0f;
@@ -814,10 +974,10 @@ long CSVFile::readChar (DWORD row, DWORD col, char &value)
 //---------------------------------------------------------------------------
 long CSVFile::readULong (DWORD row, DWORD col, unsigned long &value)
 {
-	long result = seekRowCol(row,col);
-	if (result == NO_ERR)
+	CSVCellNode *cell = getCell(row,col);
+	if (cell && (cell->result == NO_ERR))
 	{
-		value = textToULong(dataBuffer);
+		value = (unsigned long)cell->longValue;
 	}
 	else
 		value = 0.0f;
@@ -828,10 +988,10 @@ long CSVFile::readULong (DWORD row, DWORD col, unsigned long &value)
 //---------------------------------------------------------------------------
 long CSVFile::readUShort (DWORD row, DWORD col, unsigned short &value)
 {
-	long result = seekRowCol(row,col);
-	if (result == NO_ERR)
+	CSVCellNode *cell = getCell(row,col);
+	if (cell && (cell->result == NO_ERR))
 	{
-		value = textToUShort(dataBuffer);
+		value = (unsigned short)cell->longValue;
 	}
 	else
 		value = 0.0f;
@@ -842,10 +1002,10 @@ long CSVFile::readUShort (DWORD row, DWORD col, unsigned short &value)
 //---------------------------------------------------------------------------
 long CSVFile::readUChar (DWORD row, DWORD col, unsigned char &value)
 {
-	long result = seekRowCol(row,col);
-	if (result == NO_ERR)
+	CSVCellNode *cell = getCell(row,col);
+	if (cell && (cell->result == NO_ERR))
 	{
-		value = textToUChar(dataBuffer);
+		value = (unsigned char)cell->longValue;
 	}
 	else
 		value = 0.0f;
@@ -882,10 +1042,11 @@ long CSVFile::copyString (char *dest, char *src, unsigned long bufLen)
 //---------------------------------------------------------------------------
 long CSVFile::readString (DWORD row, DWORD col, char *result, unsigned long bufferSize)
 {
-	long res = seekRowCol(row,col);
+	char *text = NULL;
+	long res = findCell(row,col,text);
 	if (res == NO_ERR)
 	{
-		long errorCode = copyString(result,dataBuffer,bufferSize);
+		long errorCode = copyString(result,text,bufferSize);
 		if (errorCode != NO_ERR)
 			return(errorCode);
 	}
@@ -27,6 +27,10 @@
 #include"file.h"
 #endif
 
+#ifndef DDATACACHE_H
+#include"ddatacache.h"
+#endif
+
 //---------------------------------------------------------------------------
 // Macro Definitions
 
@@ -36,6 +40,19 @@
 //---------------------------------------------------------------------------
 // Structs
 
+//---------------------------------------------------------------------------
+// What seekRowCol finds for one cell.  afterOpen splits the whole file into a
+// rows x cols table of these, and a data cache stores that same table.  The
+// numbers are converted once, so the read* calls don't parse text.
+struct CSVCellNode
+{
+	long result;								//What getNextWord returned
+	DWORD textOffset;							//Into the text of the file, if result is NO_ERR
+	float floatValue;							//As textToFloat reads the cell
+	long longValue;								//As textToLong does.  The smaller integer reads truncate it.
+	bool boolValue;
+};
+
 //---------------------------------------------------------------------------
 //									CSVFile
 class CSVFile : public File
@@ -48,6 +65,15 @@ class CSVFile : public File
 		
 		char dataBuffer[2048];
 
+		DataCacheFilePtr	cacheFile;				//Set if the file was loaded from a data cache
+		CSVCellNode			*cacheCells;			//From the data cache or the index, every cell of the file
+		char				*cacheStrings;			//Each cell's text, NULL terminated in place
+		DWORD				cacheCols;
+
+		CSVCellNode			*indexCells;			//Set if the cells were split out of the text on open
+		char				*indexText;
+		DWORD				indexTextSize;
+
 	// Member Functions
 	//------------------
 	protected:
@@ -56,9 +82,18 @@ class CSVFile : public File
 		
 		long countRows (void);
 		long countCols (void);
+
+		void buildIndex (void);
+
+		long loadCache (const char *cacheName, DWORD sourceSize, DWORD sourceStamp);
+		void saveCache (const char *cacheName, DWORD sourceSize, DWORD sourceStamp);
 		
+		long findNextWord (char *&line, char *&startOfWord, unsigned long &wordLength, unsigned long bufLen);
 		long getNextWord (char *&line, char *buffer, unsigned long bufLen);
 
+		CSVCellNode *getCell (DWORD row, DWORD col);
+		long findCell (DWORD row, DWORD col, char *&text);
+
 		float textToFloat (char *num);
 		
 		long textToLong (char *num);
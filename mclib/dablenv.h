@@ -11,9 +11,11 @@
 
 class ABLModule;
 class UserFile;
+class ABLExecContext;
 
 typedef ABLModule* ABLModulePtr;
 typedef UserFile* UserFilePtr;
+typedef ABLExecContext* ABLExecContextPtr;
 
 #endif
 
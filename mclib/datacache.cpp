@@ -0,0 +1,335 @@
+//---------------------------------------------------------------------------
+//
+// datacache.cpp - This file contains the class functions for DataCacheFile
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+//---------------------------------------------------------------------------
+// Include files
+
+#ifndef DATACACHE_H
+#include"datacache.h"
+#endif
+
+#ifndef HEAP_H
+#include"heap.h"
+#endif
+
+#ifndef FFILE_H
+#include"ffile.h"
+#endif
+
+#include"platform_windows.h"
+#include"platform_io.h"
+
+#include<string.h>
+#include"platform_str.h"
+#include<gameos.hpp>
+
+#ifndef PLATFORM_WINDOWS
+#include<sys/mman.h>
+#endif
+
+//---------------------------------------------------------------------------
+// Static Globals
+bool DataCacheFile::useDataCache = true;
+bool DataCacheFile::writeDataCache = false;
+long DataCacheFile::numLoaded = 0;
+long DataCacheFile::numWritten = 0;
+long DataCacheFile::numRejected = 0;
+
+#define DATA_CACHE_ALIGN(x)		(((x) + 7) & ~7)
+
+//---------------------------------------------------------------------------
+// class DataCacheFile
+DataCacheFile::DataCacheFile (void) : File()
+{
+	cacheImage = NULL;
+	cacheMapped = false;
+	header = NULL;
+}
+
+//---------------------------------------------------------------------------
+DataCacheFile::~DataCacheFile (void)
+{
+	close();
+}
+
+//---------------------------------------------------------------------------
+void DataCacheFile::mapImage (void)
+{
+	//------------------------------------------------------------------
+	// Only loose files can be mapped.  Caches which were packed into a
+	// fastfile come back thru read() into systemHeap instead.
+	if (fastFile || inRAM || (handle < 0))
+		return;
+
+#ifdef PLATFORM_WINDOWS
+	HANDLE fileMapping = CreateFileMapping((HANDLE)_get_osfhandle(handle),NULL,PAGE_READONLY,0,0,NULL);
+	if (fileMapping)
+	{
+		cacheImage = (MemoryPtr)MapViewOfFile(fileMapping,FILE_MAP_READ,0,0,0);
+		CloseHandle(fileMapping);		//View keeps the mapping alive
+	}
+#else
+	void* view = mmap(NULL,length,PROT_READ,MAP_PRIVATE,handle,0);
+	if (view != MAP_FAILED)
+		cacheImage = (MemoryPtr)view;
+#endif
+
+	cacheMapped = (cacheImage != NULL);
+}
+
+//---------------------------------------------------------------------------
+long DataCacheFile::openCache (const char *cacheName, DWORD kind, DWORD sourceSize, DWORD sourceStamp)
+{
+	//---------------------------------------------------------------
+	// Check first so File::open doesn't go looking for it on the CD.
+	if (!fileExists(cacheName))
+		return(DATA_CACHE_NOT_FOUND);
+
+	if (File::open(cacheName) != NO_ERR)
+		return(DATA_CACHE_NOT_FOUND);
+
+	unsigned long cacheSize = getLength();
+	if (cacheSize < sizeof(DataCacheHeader))
+	{
+		close();
+		numRejected++;
+		return(DATA_CACHE_BAD_HEADER);
+	}
+
+	mapImage();
+	if (!cacheImage)
+	{
+		cacheImage = (MemoryPtr)systemHeap->Malloc(cacheSize);
+		gosASSERT(cacheImage != NULL);
+
+		seek(0);
+		if (read(cacheImage,cacheSize) != (long)cacheSize)
+		{
+			close();
+			numRejected++;
+			return(DATA_CACHE_BAD_HEADER);
+		}
+	}
+
+	header = (DataCacheHeader *)cacheImage;
+	if ((header->id != DATA_CACHE_ID) || (header->version != DATA_CACHE_VERSION) ||
+		(header->kind != kind) || (header->numSections > DATA_CACHE_MAX_SECTIONS))
+	{
+		close();
+		numRejected++;
+		return(DATA_CACHE_BAD_HEADER);
+	}
+
+	//--------------------------------------------------------------
+	// Record layouts differ between 32 and 64 bit builds.  Say so,
+	// or a cache shared by both would silently never be used.
+	if (header->pointerSize != sizeof(void *))
+	{
+		SPEW(("DATACACHE", "%s was written by a %d bit build, ignored\n",cacheName,(int)header->pointerSize * 8));
+		close();
+		numRejected++;
+		return(DATA_CACHE_WRONG_BUILD);
+	}
+
+	if ((header->sourceSize != sourceSize) || (header->sourceStamp != sourceStamp))
+	{
+		close();
+		return(DATA_CACHE_OUT_OF_DATE);
+	}
+
+	for (DWORD i=0;i<header->numSections;i++)
+	{
+		DataCacheSection &section = header->sections[i];
+		if ((section.offset > cacheSize) || (section.size > (cacheSize - section.offset)))
+		{
+			close();
+			numRejected++;
+			return(DATA_CACHE_BAD_SECTION);
+		}
+	}
+
+	numLoaded++;
+
+	return(NO_ERR);
+}
+
+//---------------------------------------------------------------------------
+void DataCacheFile::close (void)
+{
+	if (cacheImage)
+	{
+		if (cacheMapped)
+		{
+#ifdef PLATFORM_WINDOWS
+			UnmapViewOfFile(cacheImage);
+#else
+			munmap(cacheImage,length);
+#endif
+		}
+		else
+		{
+			systemHeap->Free(cacheImage);
+		}
+	}
+
+	cacheImage = NULL;
+	cacheMapped = false;
+	header = NULL;
+
+	File::close();
+}
+
+//---------------------------------------------------------------------------
+MemoryPtr DataCacheFile::getSection (DWORD section, DWORD recordSize, DWORD &count)
+{
+	count = 0;
+	if (!header || (section >= header->numSections))
+		return(NULL);
+
+	//-------------------------------------------------------------------
+	// openCache already turned away caches of the other word size, so a
+	// record size which doesn't match means the record layout changed
+	// without DATA_CACHE_VERSION being bumped.
+	DataCacheSection &info = header->sections[section];
+	if (((unsigned long long)info.count * recordSize) != info.size)
+	{
+		SPEW(("DATACACHE", "%s section %d holds %d byte records, expected %d\n",getFilename(),(int)section,
+			info.count ? (int)(info.size / info.count) : 0,(int)recordSize));
+		numRejected++;
+		return(NULL);
+	}
+
+	count = info.count;
+	return(cacheImage + info.offset);
+}
+
+//---------------------------------------------------------------------------
+long DataCacheFile::writeCache (const char *cacheName, DWORD kind, DWORD sourceSize, DWORD sourceStamp,
+								DWORD *info, DWORD numSections, MemoryPtr *data, DWORD *recordSize, DWORD *count)
+{
+	gosASSERT(numSections <= DATA_CACHE_MAX_SECTIONS);
+
+	DataCacheHeader cacheHeader;
+	memset(&cacheHeader,0,sizeof(DataCacheHeader));
+	cacheHeader.id = DATA_CACHE_ID;
+	cacheHeader.version = DATA_CACHE_VERSION;
+	cacheHeader.kind = kind;
+	cacheHeader.pointerSize = sizeof(void *);
+	cacheHeader.sourceSize = sourceSize;
+	cacheHeader.sourceStamp = sourceStamp;
+	cacheHeader.numSections = numSections;
+	if (info)
+		memcpy(cacheHeader.info,info,sizeof(DWORD) * DATA_CACHE_MAX_INFO);
+
+	//--------------------------------------------------------
+	// Lay the sections out 8 byte aligned after the header so
+	// the records can be used in place from a mapping.
+	DWORD cacheSize = DATA_CACHE_ALIGN(sizeof(DataCacheHeader));
+	for (DWORD i=0;i<numSections;i++)
+	{
+		cacheHeader.sections[i].offset = cacheSize;
+		cacheHeader.sections[i].size = recordSize[i] * count[i];
+		cacheHeader.sections[i].count = count[i];
+		cacheSize += DATA_CACHE_ALIGN(cacheHeader.sections[i].size);
+	}
+
+	MemoryPtr cacheImage = (MemoryPtr)systemHeap->Malloc(cacheSize);
+	gosASSERT(cacheImage != NULL);
+	memset(cacheImage,0,cacheSize);
+
+	memcpy(cacheImage,&cacheHeader,sizeof(DataCacheHeader));
+	for (DWORD i=0;i<numSections;i++)
+	{
+		if (cacheHeader.sections[i].size)
+			memcpy(cacheImage + cacheHeader.sections[i].offset,data[i],cacheHeader.sections[i].size);
+	}
+
+	//--------------------------------------------------------------
+	// Write it under a temporary name and rename it into place, so
+	// nothing opening the cache meanwhile can see half of it.
+	char tempName[1024];
+	if ((strlen(cacheName) + 5) > sizeof(tempName))
+	{
+		systemHeap->Free(cacheImage);
+		return(BAD_WRITE_ERR);
+	}
+
+	sprintf(tempName,"%s.tmp",cacheName);
+
+	File cacheFile;
+	long result = cacheFile.create(tempName);
+	if (result == NO_ERR)
+	{
+		if (cacheFile.write(cacheImage,cacheSize) != (long)cacheSize)
+			result = BAD_WRITE_ERR;
+
+		cacheFile.close();
+
+#ifdef PLATFORM_WINDOWS
+		if (result == NO_ERR)
+			remove(cacheName);
+#endif
+		if ((result == NO_ERR) && (rename(tempName,cacheName) != 0))
+			result = BAD_WRITE_ERR;
+
+		if (result == NO_ERR)
+			numWritten++;
+		else
+			remove(tempName);
+	}
+
+	systemHeap->Free(cacheImage);
+
+	return(result);
+}
+
+//---------------------------------------------------------------------------
+long DataCacheFile::stampSource (FilePtr source, DWORD &size, DWORD &stamp)
+{
+	//-------------------------------------------------------------------
+	// Like make, a source counts as changed when its size or time stamp
+	// does.  Hashing it meant reading the whole source on every open,
+	// which cost about as much as the tokenizing the cache saves.  Files
+	// packed into a fastfile go by the time stamp of the fastfile.
+	size = source->getLength();
+
+	const char *stampName = source->getFilename();
+	if (source->getFastFile())
+		stampName = source->getFastFile()->getFileName();
+
+	struct _stat st;
+	if (!stampName || (_stat(stampName,&st) != 0))
+		return(FILE_NOT_FOUND_ERR);
+
+	stamp = (DWORD)st.st_mtime;
+
+	return(NO_ERR);
+}
+
+//---------------------------------------------------------------------------
+bool DataCacheFile::makeCacheName (FilePtr source, char *cacheName, unsigned long bufLen)
+{
+	//------------------------------------------------------------
+	// Children of packet files have no name of their own, so they
+	// can't have a cache.  The cache sits next to the source.
+	if (!useDataCache || source->getParent() || !source->getFilename())
+		return(false);
+
+	if ((strlen(source->getFilename()) + 2) > bufLen)
+		return(false);
+
+	sprintf(cacheName,"%sc",source->getFilename());
+
+	return(true);
+}
+
+//---------------------------------------------------------------------------
+//
+// Edit log
+//
+//---------------------------------------------------------------------------
@@ -0,0 +1,132 @@
+//---------------------------------------------------------------------------
+//
+// datacache.h - This file contains the class declaration for DataCacheFile
+//
+//				A data cache is the compiled form of a text data file
+//				(FitIni or CSV).  It sits next to the source, is written by
+//				the makecache tool and is only used while the size and time
+//				stamp of the source still match.  The game itself only writes
+//				caches when writeDataCache is set.
+//
+//				The cache is a header followed by flat arrays with no
+//				pointers in them, so it can be used straight out of a
+//				memory mapping.
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#ifndef DATACACHE_H
+#define DATACACHE_H
+//---------------------------------------------------------------------------
+// Include files
+
+#ifndef DSTD_H
+#include"dstd.h"
+#endif
+
+#ifndef DDATACACHE_H
+#include"ddatacache.h"
+#endif
+
+#ifndef FILE_H
+#include"file.h"
+#endif
+
+//---------------------------------------------------------------------------
+// Macro Definitions
+#define DATA_CACHE_ID					0x4344434D		//"MCDC"
+#define DATA_CACHE_VERSION				3
+
+#define DATA_CACHE_FITINI				1
+#define DATA_CACHE_CSV					2
+
+#define DATA_CACHE_MAX_SECTIONS		8
+#define DATA_CACHE_MAX_INFO			4
+
+#define DATA_CACHE_NOT_FOUND			0xDCCA0001
+#define DATA_CACHE_BAD_HEADER			0xDCCA0002
+#define DATA_CACHE_OUT_OF_DATE			0xDCCA0003
+#define DATA_CACHE_BAD_SECTION			0xDCCA0004
+#define DATA_CACHE_WRONG_BUILD			0xDCCA0005
+
+//---------------------------------------------------------------------------
+// Structs
+struct DataCacheSection
+{
+	DWORD offset;							//From start of cache file
+	DWORD size;								//In bytes
+	DWORD count;							//Number of records
+};
+
+struct DataCacheHeader
+{
+	DWORD id;
+	DWORD version;
+	DWORD kind;								//DATA_CACHE_FITINI or DATA_CACHE_CSV
+	DWORD pointerSize;						//Of the build which wrote it.  Records differ between 32 and 64 bit.
+	DWORD sourceSize;
+	DWORD sourceStamp;						//Time stamp of the source, or of the fastfile it is in
+	DWORD numSections;
+	DWORD info[DATA_CACHE_MAX_INFO];		//Whatever else the owner needs to restore its state
+	DataCacheSection sections[DATA_CACHE_MAX_SECTIONS];
+};
+
+//---------------------------------------------------------------------------
+//									DataCacheFile
+class DataCacheFile : public File
+{
+	// Data Members
+	//--------------
+	protected:
+		MemoryPtr			cacheImage;				//Whole cache, mapped or read into systemHeap
+		bool				cacheMapped;
+		DataCacheHeader		*header;
+
+	public:
+		static bool			useDataCache;			//Look for caches when opening text data
+		static bool			writeDataCache;			//Write a cache when none was usable.  Off in the game.
+		static long			numLoaded;
+		static long			numWritten;
+		static long			numRejected;			//Caches there but not usable, e.g. written by the other word size
+
+	// Member Functions
+	//------------------
+	protected:
+		void mapImage (void);
+
+	public:
+		DataCacheFile (void);
+		~DataCacheFile (void);
+
+		long openCache (const char *cacheName, DWORD kind, DWORD sourceSize, DWORD sourceStamp);
+
+		virtual void close (void);
+
+		virtual FileClass getFileClass (void)
+		{
+			return DATACACHEFILE;
+		}
+
+		DWORD getInfo (DWORD index)
+		{
+			return (header && (index < DATA_CACHE_MAX_INFO)) ? header->info[index] : 0;
+		}
+
+		MemoryPtr getSection (DWORD section, DWORD recordSize, DWORD &count);
+
+		static long writeCache (const char *cacheName, DWORD kind, DWORD sourceSize, DWORD sourceStamp,
+								DWORD *info, DWORD numSections, MemoryPtr *data, DWORD *recordSize, DWORD *count);
+
+		static long stampSource (FilePtr source, DWORD &size, DWORD &stamp);
+		static bool makeCacheName (FilePtr source, char *cacheName, unsigned long bufLen);
+};
+
+//---------------------------------------------------------------------------
+#endif
+
+//---------------------------------------------------------------------------
+//
+// Edit Log
+//
+//---------------------------------------------------------------------------
@@ -0,0 +1,19 @@
+//---------------------------------------------------------------------------
+//
+// ddatacache.h - This file contains the class declaratrions for the data caches
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#ifndef DDATACACHE_H
+#define DDATACACHE_H
+//---------------------------------------------------------------------------
+// Include files
+
+//---------------------------------------------------------------------------
+class DataCacheFile;
+typedef DataCacheFile *DataCacheFilePtr;
+
+//---------------------------------------------------------------------------
+#endif
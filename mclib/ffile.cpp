@@ -31,9 +31,49 @@
 #include"platform_str.h"
 #include<gameos.hpp>
 
+#ifndef PLATFORM_WINDOWS
+#include<sys/mman.h>
+#endif
+
 MemoryPtr 		LZPacketBuffer = NULL;
 unsigned int	LZPacketBufferSize = 512000;
 
+//---------------------------------------------------------------------------
+// LZPacketBuffer is only ever used by the main thread. Threads reading thru
+// the reentrant calls get one of these instead.
+struct LZThreadBuffer
+{
+	MemoryPtr		buffer;
+	unsigned int	size;
+
+	LZThreadBuffer (void)
+	{
+		buffer = NULL;
+		size = 0;
+	}
+
+	~LZThreadBuffer (void)
+	{
+		free(buffer);
+	}
+};
+
+static thread_local LZThreadBuffer lzThreadBuffer;
+
+MemoryPtr GetLZThreadBuffer (unsigned int size)
+{
+	if (lzThreadBuffer.size < size)
+	{
+		free(lzThreadBuffer.buffer);
+		lzThreadBuffer.size = (size > LZPacketBufferSize) ? size : LZPacketBufferSize;
+		lzThreadBuffer.buffer = (MemoryPtr)malloc(lzThreadBuffer.size);
+		if (!lzThreadBuffer.buffer)
+			lzThreadBuffer.size = 0;
+	}
+
+	return lzThreadBuffer.buffer;
+}
+
 extern char CDInstallPath[];
 void EnterWindowMode();
 void EnterFullScreenMode();
@@ -72,6 +112,10 @@ FastFile::FastFile (void)
 
 	useLZCompress = false;
 
+	mapping = NULL;
+	hashIndex = NULL;
+	hashIndexMask = 0;
+
 	numWrittenFiles = 0;
 }
 			
@@ -241,8 +285,76 @@ long FastFile::open (const char* fName)
 		files[i].pos = 0;
 	}
 
+	buildHashIndex();
+	mapFile();
+
 	return (0);
 }
+
+//---------------------------------------------------------------------------
+void FastFile::buildHashIndex (void)
+{
+	//-----------------------------------------------------------------
+	// Table is at least twice the number of files, so probes stay short.
+	// Files are inserted in order, so duplicate names still resolve to
+	// the first entry like the old linear search did.
+	DWORD tableSize = 16;
+	while (tableSize < numFiles * 2)
+		tableSize <<= 1;
+
+	hashIndex = (long*)malloc(sizeof(long) * tableSize);
+	hashIndexMask = tableSize - 1;
+	for (DWORD i=0;i<tableSize;i++)
+		hashIndex[i] = -1;
+
+	for (DWORD i=0;i<numFiles;i++)
+	{
+		DWORD slot = files[i].pfe->hash & hashIndexMask;
+		while (hashIndex[slot] != -1)
+			slot = (slot + 1) & hashIndexMask;
+		hashIndex[slot] = i;
+	}
+}
+
+//---------------------------------------------------------------------------
+void FastFile::mapFile (void)
+{
+	//---------------------------------------------------------------------
+	// If the archive can't be mapped (or an entry lies outside of it) we
+	// just fall back to seeking and reading thru the FILE handle.
+	if (!isOpen() || (fileSize() == 0))
+		return;
+
+#ifdef PLATFORM_WINDOWS
+	HANDLE fileMapping = CreateFileMapping((HANDLE)_get_osfhandle(_fileno(handle)),NULL,PAGE_READONLY,0,0,NULL);
+	if (fileMapping)
+	{
+		mapping = (MemoryPtr)MapViewOfFile(fileMapping,FILE_MAP_READ,0,0,0);
+		CloseHandle(fileMapping);		//View keeps the mapping alive
+	}
+#else
+	void* view = mmap(NULL,length,PROT_READ,MAP_PRIVATE,fileno(handle),0);
+	if (view != MAP_FAILED)
+		mapping = (MemoryPtr)view;
+#endif
+
+	if (!mapping)
+		return;
+
+	for (DWORD i=0;i<numFiles;i++)
+	{
+		if (((unsigned long long)files[i].pfe->offset + files[i].pfe->size) > length)
+		{
+#ifdef PLATFORM_WINDOWS
+			UnmapViewOfFile(mapping);
+#else
+			munmap(mapping,length);
+#endif
+			mapping = NULL;
+			return;
+		}
+	}
+}
 		
 //---------------------------------------------------------------------------
 void FastFile::close (void)
@@ -254,8 +366,25 @@ void FastFile::close (void)
 		delete [] fileName;	//	this was free, which didn't match the new allocation.
 							//	neither new nor free were overridden. Should they have been?
 	fileName = NULL;
+
+	if (mapping)
+	{
+#ifdef PLATFORM_WINDOWS
+		UnmapViewOfFile(mapping);
+#else
+		munmap(mapping,length);
+#endif
+		mapping = NULL;
+	}
 	length = 0;
 
+	if (hashIndex)
+	{
+		free(hashIndex);
+		hashIndex = NULL;
+		hashIndexMask = 0;
+	}
+
 	if (isOpen())
 	{
 		fclose(handle);
@@ -349,17 +478,33 @@ long FastFile::reserve(int num_files)
 
 //---------------------------------------------------------------------------
 long FastFile::openFast (DWORD hash, const char *fName)
+{
+	long i = findFast(hash,fName);
+	if (i != -1)
+	{
+		files[i].inuse = TRUE;
+		files[i].pos = 0;
+	}
+
+	return i;
+}
+
+//---------------------------------------------------------------------------
+long FastFile::findFast (DWORD hash, const char *fName)
 {
 	//------------------------------------------------------------------
 	//-- In order to use this, the file name must be part of the index.
-	for (DWORD i=0;i<numFiles;i++)
+	if (!hashIndex)
+		return -1;
+
+	DWORD slot = hash & hashIndexMask;
+	while (hashIndex[slot] != -1)
 	{
+		long i = hashIndex[slot];
 		if ((hash == files[i].pfe->hash) && (S_stricmp(files[i].pfe->name,fName) == 0))
-		{
-			files[i].inuse = TRUE;
-			files[i].pos = 0;
 			return i;
-		}
+
+		slot = (slot + 1) & hashIndexMask;
 	}
 
 	return -1;
@@ -430,7 +575,7 @@ long FastFile::seekFast (DWORD fastFileHandle, DWORD off, DWORD how)
 
 		//-----------------------------------
 		//-- Now macro seek the entire file.
-		if (fseek(handle,files[fastFileHandle].pos + files[fastFileHandle].pfe->offset,SEEK_SET) == 0)
+		if (!mapping && fseek(handle,files[fastFileHandle].pos + files[fastFileHandle].pfe->offset,SEEK_SET) == 0)
 			logicalPosition = ftell(handle);
 
 		return (files[fastFileHandle].pos);
@@ -448,107 +593,121 @@ long FastFile::readFast (DWORD fastFileHandle, void *bfr, DWORD size)
 
 	if ((fastFileHandle >= 0) && (fastFileHandle < numFiles) && files[fastFileHandle].inuse)
 	{
-		logicalPosition = fseek(handle,files[fastFileHandle].pos + files[fastFileHandle].pfe->offset,SEEK_SET);
-
 		//ALL files in the fast file are now zLib compressed. NO EXCEPTIONS!!
 		// This fixes a bug where the zLib Compressed version is the same length
 		// as the raw version.  Yikes but this is rare.  Finally happened though!
 		// -fs
-		/*
-		if (files[fastFileHandle].pfe->size == files[fastFileHandle].pfe->realSize)
-		{
-			result = fread(bfr,1,size,handle);
-			logicalPosition += size;
 
-			if (result != size)
-			{
-				long lastError = errno;
-				return lastError;
-			}
-		}
-		else			//File is NOW zLib Compressed.  Read In Appropriately
-		*/
+		//--------------------------------------------------------------
+		// Mapped archives decompress straight from the mapping, with no
+		// seek, read or copy into the packet buffer.
+		if (mapping)
+			return decompressFast(fastFileHandle,mapping + files[fastFileHandle].pfe->offset + files[fastFileHandle].pos,bfr);
+
+		logicalPosition = fseek(handle,files[fastFileHandle].pos + files[fastFileHandle].pfe->offset,SEEK_SET);
+
+		if (!LZPacketBuffer)
 		{
+			LZPacketBuffer = (MemoryPtr)malloc(LZPacketBufferSize);
 			if (!LZPacketBuffer)
-			{
-				LZPacketBuffer = (MemoryPtr)malloc(LZPacketBufferSize);
-				if (!LZPacketBuffer)
-					return 0;
-			}
-				
-			if ((DWORD)LZPacketBufferSize < files[fastFileHandle].pfe->size)
-			{
-				LZPacketBufferSize = files[fastFileHandle].pfe->size;
-				
-				free(LZPacketBuffer);
-				LZPacketBuffer = (MemoryPtr)malloc(LZPacketBufferSize);
-				if (!LZPacketBuffer)
-					return 0;
-			}
+				return 0;
+		}
 			
-			if (LZPacketBuffer)
-			{
-				result = fread(LZPacketBuffer,1,files[fastFileHandle].pfe->size,handle);
-				logicalPosition += files[fastFileHandle].pfe->size;
-
-				//sebi: second condition to handle zero-length files
-				if (result != files[fastFileHandle].pfe->size && files[fastFileHandle].pfe->size>0)
-				{
-					//READ Error.  Maybe the CD is missing?
-					bool openFailed = false;
-					bool alreadyFullScreen = (Environment.fullScreen != 0);
-					while (result != files[fastFileHandle].pfe->size)
-					{
-						openFailed = true;
-						EnterWindowMode();
-		
-						char data[2048];
-						sprintf(data,FileMissingString,fileName,CDMissingString);
-						DWORD result1 = MessageBox(NULL,data,MissingTitleString,MB_OKCANCEL | MB_ICONWARNING);
-						if (result1 == IDCANCEL)
-						{
-							ExitGameOS();
-							return (2);		//File not found.  Never returns though!
-						}
-		
-						logicalPosition = fseek(handle,files[fastFileHandle].pos + files[fastFileHandle].pfe->offset,SEEK_SET);
-						result = fread(LZPacketBuffer,1,files[fastFileHandle].pfe->size,handle);
-						logicalPosition += files[fastFileHandle].pfe->size;
-					}
+		if ((DWORD)LZPacketBufferSize < files[fastFileHandle].pfe->size)
+		{
+			LZPacketBufferSize = files[fastFileHandle].pfe->size;
+			
+			free(LZPacketBuffer);
+			LZPacketBuffer = (MemoryPtr)malloc(LZPacketBufferSize);
+			if (!LZPacketBuffer)
+				return 0;
+		}
 		
-					if (openFailed && (Environment.fullScreen == 0) && alreadyFullScreen)
-						EnterFullScreenMode();
-				}
+		result = fread(LZPacketBuffer,1,files[fastFileHandle].pfe->size,handle);
+		logicalPosition += files[fastFileHandle].pfe->size;
 
-				//--------------------------------------------------------
-				//USED to LZ Compress here.  It is NOW zLib Compression.
-				//  We should not try to use old fastfiles becuase version check above should fail when trying to open!!
-				unsigned long decompLength = 0;
-				if (useLZCompress)
-				{
-					decompLength = LZDecomp((MemoryPtr)bfr,LZPacketBuffer,files[fastFileHandle].pfe->size);
-				}
-				else
+		//sebi: second condition to handle zero-length files
+		if (result != files[fastFileHandle].pfe->size && files[fastFileHandle].pfe->size>0)
+		{
+			//READ Error.  Maybe the CD is missing?
+			bool openFailed = false;
+			bool alreadyFullScreen = (Environment.fullScreen != 0);
+			while (result != files[fastFileHandle].pfe->size)
+			{
+				openFailed = true;
+				EnterWindowMode();
+
+				char data[2048];
+				sprintf(data,FileMissingString,fileName,CDMissingString);
+				DWORD result1 = MessageBox(NULL,data,MissingTitleString,MB_OKCANCEL | MB_ICONWARNING);
+				if (result1 == IDCANCEL)
 				{
-					decompLength = files[fastFileHandle].pfe->realSize;
-					long error = uncompress((MemoryPtr)bfr,&decompLength,LZPacketBuffer,files[fastFileHandle].pfe->size);
-					if (error != Z_OK)
-						STOP(("Error %d UnCompressing File %s from FastFile %s",error,files[fastFileHandle].pfe->name,fileName));
+					ExitGameOS();
+					return (2);		//File not found.  Never returns though!
 				}
 
-				if ((long)decompLength != files[fastFileHandle].pfe->realSize)
-					result = 0;
-				else
-					result = decompLength;
+				logicalPosition = fseek(handle,files[fastFileHandle].pos + files[fastFileHandle].pfe->offset,SEEK_SET);
+				result = fread(LZPacketBuffer,1,files[fastFileHandle].pfe->size,handle);
+				logicalPosition += files[fastFileHandle].pfe->size;
 			}
+
+			if (openFailed && (Environment.fullScreen == 0) && alreadyFullScreen)
+				EnterFullScreenMode();
 		}
 
-		return result;
+		return decompressFast(fastFileHandle,LZPacketBuffer,bfr);
 	}
 
 	return FILE_NOT_OPEN;
 }
 
+//---------------------------------------------------------------------------
+long FastFile::readFastEntry (long fileIndex, void *bfr)
+{
+	if ((fileIndex < 0) || ((DWORD)fileIndex >= numFiles))
+		return FILE_NOT_OPEN;
+
+	if (mapping)
+		return decompressFast(fileIndex,mapping + files[fileIndex].pfe->offset,bfr);
+
+	//------------------------------------------------------------
+	// Positional read, so the shared FILE* position is untouched.
+	MemoryPtr packedData = GetLZThreadBuffer(files[fileIndex].pfe->size);
+	if (!packedData)
+		return 0;
+
+	long result = pread(fileno(handle),packedData,files[fileIndex].pfe->size,files[fileIndex].pfe->offset);
+	if (result != (long)files[fileIndex].pfe->size)
+		return 0;
+
+	return decompressFast(fileIndex,packedData,bfr);
+}
+
+//---------------------------------------------------------------------------
+long FastFile::decompressFast (DWORD fastFileHandle, MemoryPtr packedData, void *bfr)
+{
+	//--------------------------------------------------------
+	//USED to LZ Compress here.  It is NOW zLib Compression.
+	//  We should not try to use old fastfiles becuase version check above should fail when trying to open!!
+	unsigned long decompLength = 0;
+	if (useLZCompress)
+	{
+		decompLength = LZDecomp((MemoryPtr)bfr,packedData,files[fastFileHandle].pfe->size);
+	}
+	else
+	{
+		decompLength = files[fastFileHandle].pfe->realSize;
+		long error = uncompress((MemoryPtr)bfr,&decompLength,packedData,files[fastFileHandle].pfe->size);
+		if (error != Z_OK)
+			STOP(("Error %d UnCompressing File %s from FastFile %s",error,files[fastFileHandle].pfe->name,fileName));
+	}
+
+	if ((long)decompLength != files[fastFileHandle].pfe->realSize)
+		return 0;
+
+	return decompLength;
+}
+
 //---------------------------------------------------------------------------
 long FastFile::writeFast (const char* fastFileName, void* buffer, int nbytes)
 {
@@ -661,6 +820,15 @@ long FastFile::readFastRAW (DWORD fastFileHandle, void *bfr, DWORD size)
 
 	if ((fastFileHandle >= 0) && (fastFileHandle < numFiles) && files[fastFileHandle].inuse)
 	{
+		if (mapping)
+		{
+			if (size < files[fastFileHandle].pfe->size)
+				return 0;
+
+			memcpy(bfr,mapping + files[fastFileHandle].pfe->offset + files[fastFileHandle].pos,files[fastFileHandle].pfe->size);
+			return files[fastFileHandle].pfe->size;
+		}
+
 		logicalPosition = fseek(handle,files[fastFileHandle].pos + files[fastFileHandle].pfe->offset,SEEK_SET);
 
 		if (size >= files[fastFileHandle].pfe->size)
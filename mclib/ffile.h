@@ -68,6 +68,13 @@ class FastFile
 
 		bool		useLZCompress;
 
+		//---------------------------------------------------------------
+		// Opened archives are mapped read-only when possible, and entries
+		// are found thru an open-addressed hash table over FILEENTRY hash.
+		MemoryPtr	mapping;
+		long*		hashIndex;			// file index per slot, -1 if empty
+		DWORD		hashIndexMask;
+
 		// used when creating fast file
 		int						numWrittenFiles;
 
@@ -75,6 +82,10 @@ class FastFile
 		long writeNumFiles(FILE* handle, int num_files);
 		long writeFileEntries(FILE* handle, FILE_HANDLE* files, int num_files, int offset);
 
+		void buildHashIndex (void);
+		void mapFile (void);
+		long decompressFast (DWORD fastFileHandle, MemoryPtr packedData, void *bfr);
+
 	public:
 		FastFile (void);
 		~FastFile (void);
@@ -112,6 +123,13 @@ class FastFile
 
 		long openFast (DWORD hash, const char *fName);
 
+		//-------------------------------------------------------------------
+		// Reentrant access for loader threads. These never touch the shared
+		// FILE_HANDLE pos/inuse state, the FILE* position or LZPacketBuffer,
+		// so any number of threads may read the same archive at once.
+		long findFast (DWORD hash, const char *fName);
+		long readFastEntry (long fileIndex, void *bfr);
+
 		void closeFast (DWORD localHandle);
 
 		long seekFast (DWORD fastFileHandle, DWORD off, DWORD from = SEEK_SET);
@@ -126,12 +144,21 @@ class FastFile
 			return useLZCompress;
 		}
 
+		bool isMapped (void)
+		{
+			return (mapping != NULL);
+		}
+
 
 		long create(const char* fName, bool compressed);
 		long reserve(int num_files);
 		long writeFast (const char* fastFileName, void* buffer, int nbytes);
 };
 
+//---------------------------------------------------------------------------
+// Per-thread scratch buffer for packed data, grown as needed.
+MemoryPtr GetLZThreadBuffer (unsigned int size);
+
 //---------------------------------------------------------------------------
 extern FastFile 	**fastFiles;
 extern long 		numFastFiles;
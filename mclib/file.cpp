@@ -34,6 +34,10 @@
 #include"fastfile.h"
 #endif
 
+#ifndef LOADGRAPH_H
+#include"loadgraph.h"
+#endif
+
 #ifndef UTILITIES_H
 #include"utilities.h"
 #endif
@@ -367,7 +371,10 @@ long File::open (const char* fName, FileMode _mode, long numChild, bool doNotLow
 			fileImage = (unsigned char *)malloc(fileSize());
 			if (fileImage)
 			{
-				fastFile->readFast(fastFileHandle,fileImage,fileSize());
+				//----------------------------------------------------------
+				//-- A mission load may have read and unpacked it already.
+				if (!LoadGraph::copyFile(fileName,fileImage,fileSize()))
+					fastFile->readFast(fastFileHandle,fileImage,fileSize());
 
 				physicalLength = getLength();
 				//------------------------------------
@@ -847,6 +854,27 @@ long File::read (unsigned long pos, MemoryPtr buffer, long length)
 	return(result);
 }
 
+//---------------------------------------------------------------------------
+long File::readAt (unsigned long pos, MemoryPtr buffer, long length)
+{
+	if (inRAM && fileImage)
+	{
+		memcpy((char *)buffer,(char *)fileImage+pos,length);
+		return(length);
+	}
+
+	//-----------------------------------------------------------------
+	// Streamed fastfile entries only have the one shared read position.
+	if (fastFile || !isOpen())
+		return 0;
+
+	long result = pread(handle,buffer,length,pos+parentOffset);
+	if (result < 0)
+		result = 0;
+
+	return(result);
+}
+
 //---------------------------------------------------------------------------
 unsigned char File::readByte (void)
 {
@@ -54,7 +54,8 @@ enum FileClass
 	BASEFILE = 0,
 	INIFILE,
 	PACKETFILE,
-	CSVFILE
+	CSVFILE,
+	DATACACHEFILE
 };
 
 //---------------------------------------------------------------------------
@@ -169,6 +170,10 @@ class File
 			long read (unsigned long pos, MemoryPtr buffer, long length);
 			long read (MemoryPtr buffer, long length);
 
+			//Positional read which leaves logicalPosition and the OS file
+			//pointer alone. Safe to call from several threads at once.
+			long readAt (unsigned long pos, MemoryPtr buffer, long length);
+
 			//Used to dig the LZ data directly out of the fastfiles.
 			// For textures.
 			//long readRAW (unsigned long * &buffer, UserHeapPtr heap);
@@ -235,6 +240,11 @@ class File
 				return(handle);
 			}
 
+			FastFilePtr getFastFile (void)
+			{
+				return(fastFile);
+			}
+
 			time_t getFileMTime (void);
 			
 			long addChild (FilePtr child);
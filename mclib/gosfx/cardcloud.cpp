@@ -373,9 +373,9 @@ void
 	Particle *particle = GetParticle(index);
 	Check_Object(particle);
 	particle->m_halfY =
-		spec->m_halfHeight.ComputeValue(m_age, particle->m_seed);
+		spec->m_halfHeight.ComputeValue(m_age, m_P_seed[index]);
 	particle->m_halfX =
-		particle->m_halfY * spec->m_aspectRatio.ComputeValue(m_age, particle->m_seed);
+		particle->m_halfY * spec->m_aspectRatio.ComputeValue(m_age, m_P_seed[index]);
 	particle->m_radius =
 		Stuff::Sqrt(
 			particle->m_halfX * particle->m_halfX
@@ -385,9 +385,10 @@ void
 
 //------------------------------------------------------------------------------
 //
-bool
-	gosFX::CardCloud::AnimateParticle(
-		unsigned index,
+void
+	gosFX::CardCloud::AnimateParticles(
+		unsigned first,
+		unsigned end,
 		const Stuff::LinearMatrix4D *world_to_new_local,
 		Stuff::Time till
 	)
@@ -399,72 +400,88 @@ bool
 	// Animate the parent then get our pointers
 	//-----------------------------------------
 	//
-	if (!SpinningCloud::AnimateParticle(index, world_to_new_local, till))
-		return false;
-	Set_Statistic(Card_Count, Card_Count+1);
+	SpinningCloud::AnimateParticles(first, end, world_to_new_local, till);
 	Specification *spec = GetSpecification();
 	Check_Object(spec);
-	Particle *particle = GetParticle(index);
-	Check_Object(particle);
-	Stuff::Scalar seed = particle->m_seed;
-	Stuff::Scalar age = particle->m_age;
 
 	//
-	//------------------
-	// Animate the color
-	//------------------
+	//---------------------------------------------------------------
+	// Run the color and index curves for all the particles at once
+	//---------------------------------------------------------------
 	//
-	Check_Pointer(m_P_color);
-	m_P_color[index].red = spec->m_pRed.ComputeValue(age, seed);
-	m_P_color[index].green = spec->m_pGreen.ComputeValue(age, seed);
-	m_P_color[index].blue = spec->m_pBlue.ComputeValue(age, seed);
-	m_P_color[index].alpha = spec->m_pAlpha.ComputeValue(age, seed);
+	Stuff::Scalar *red = GetLane(FirstScratchLane);
+	Stuff::Scalar *green = GetLane(FirstScratchLane+1);
+	Stuff::Scalar *blue = GetLane(FirstScratchLane+2);
+	Stuff::Scalar *alpha = GetLane(FirstScratchLane+3);
+	Stuff::Scalar *frame = GetLane(FirstScratchLane+4);
+	ComputeColors(first, end, red, green, blue, alpha);
+	if (spec->m_animated)
+		spec->m_pIndex.ComputeValues(m_P_age, m_P_seed, frame, first, end);
 
 	//
-	//----------------
-	// Animate the uvs
-	//----------------
+	//---------------------------------------------------
+	// The uv offsets and sizes are the same for every card
+	//---------------------------------------------------
 	//
-	Stuff::Scalar u = spec->m_UOffset.ComputeValue(age, seed);
-	Stuff::Scalar v = spec->m_VOffset.ComputeValue(age, seed);
-	Stuff::Scalar u2 = spec->m_USize.ComputeValue(age, seed);
-	Stuff::Scalar v2 = spec->m_VSize.ComputeValue(age, seed);
+	Stuff::Scalar u_offset = spec->m_UOffset.ComputeValue(0.0f, 0.0f);
+	Stuff::Scalar v_offset = spec->m_VOffset.ComputeValue(0.0f, 0.0f);
+	Stuff::Scalar u_size = spec->m_USize.ComputeValue(0.0f, 0.0f);
+	Stuff::Scalar v_size = spec->m_VSize.ComputeValue(0.0f, 0.0f);
 
-	//
-	//--------------------------------------------------------------
-	// If we are animated, figure out the row/column to be displayed
-	//--------------------------------------------------------------
-	//
-	if (spec->m_animated)
+	Check_Pointer(m_P_color);
+	Check_Pointer(m_P_uvs);
+	unsigned live = 0;
+	for (unsigned i=first; i<end; ++i)
 	{
-		BYTE columns =
-			Stuff::Truncate_Float_To_Byte(
-				spec->m_pIndex.ComputeValue(age, seed)
-			);
-		BYTE rows = static_cast<BYTE>(columns / spec->m_width);
-		columns = static_cast<BYTE>(columns - rows*spec->m_width);
+		if (m_P_age[i] >= 1.0f)
+			continue;
+		++live;
+
+		//
+		//------------------
+		// Animate the color
+		//------------------
+		//
+		m_P_color[i].red = red[i];
+		m_P_color[i].green = green[i];
+		m_P_color[i].blue = blue[i];
+		m_P_color[i].alpha = alpha[i];
 
 		//
-		//---------------------------
-		// Now compute the end points
-		//---------------------------
+		//--------------------------------------------------------------
+		// If we are animated, figure out the row/column to be displayed
+		//--------------------------------------------------------------
 		//
-		u += u2*columns;
-		v += v2*rows;
+		Stuff::Scalar u = u_offset;
+		Stuff::Scalar v = v_offset;
+		if (spec->m_animated)
+		{
+			BYTE columns = Stuff::Truncate_Float_To_Byte(frame[i]);
+			BYTE rows = static_cast<BYTE>(columns / spec->m_width);
+			columns = static_cast<BYTE>(columns - rows*spec->m_width);
+
+			//
+			//---------------------------
+			// Now compute the end points
+			//---------------------------
+			//
+			u += u_size*columns;
+			v += v_size*rows;
+		}
+		Stuff::Scalar u2 = u + u_size;
+		Stuff::Scalar v2 = v + v_size;
+
+		unsigned index = i*4;
+		m_P_uvs[index].x = u;
+		m_P_uvs[index].y = v2;
+		m_P_uvs[++index].x = u2;
+		m_P_uvs[index].y = v2;
+		m_P_uvs[++index].x = u2;
+		m_P_uvs[index].y = v;
+		m_P_uvs[++index].x = u;
+		m_P_uvs[index].y = v;
 	}
-	u2 += u;
-	v2 += v;
-
-	index *= 4;
-	m_P_uvs[index].x = u;
-	m_P_uvs[index].y = v2;
-	m_P_uvs[++index].x = u2;
-	m_P_uvs[index].y = v2;
-	m_P_uvs[++index].x = u2;
-	m_P_uvs[index].y = v;
-	m_P_uvs[++index].x = u;
-	m_P_uvs[index].y = v;
-	return true;
+	Set_Statistic(Card_Count, Card_Count+live);
 }
 
 //------------------------------------------------------------------------------
@@ -535,7 +552,7 @@ void gosFX::CardCloud::Draw(DrawInfo *info)
 				{
 					Particle *particle = GetParticle(i);
 					Check_Object(particle);
-					if (particle->m_age < 1.0f)
+					if (m_P_age[i] < 1.0f)
 					{
 
 						//
@@ -546,7 +563,7 @@ void gosFX::CardCloud::Draw(DrawInfo *info)
 						Stuff::Vector3D direction_in_cloud;
 						direction_in_cloud.Subtract(
 							camera_in_cloud,
-							particle->m_localTranslation
+							GetLocalTranslation(i)
 						);
 						Stuff::LinearMatrix4D card_to_cloud;
 						card_to_cloud.BuildRotation(particle->m_localRotation);
@@ -557,7 +574,7 @@ void gosFX::CardCloud::Draw(DrawInfo *info)
 							Stuff::X_Axis
 						);
 						card_to_cloud.BuildTranslation(
-							particle->m_localTranslation
+							GetLocalTranslation(i)
 						);
 
 						//
@@ -633,7 +650,7 @@ void gosFX::CardCloud::Draw(DrawInfo *info)
 				{
 					Particle *particle = GetParticle(i);
 					Check_Object(particle);
-					if (particle->m_age < 1.0f)
+					if (m_P_age[i] < 1.0f)
 					{
 
 						//
@@ -644,7 +661,7 @@ void gosFX::CardCloud::Draw(DrawInfo *info)
 						Stuff::Vector3D direction_in_cloud;
 						direction_in_cloud.Subtract(
 							camera_in_cloud,
-							particle->m_localTranslation
+							GetLocalTranslation(i)
 						);
 						Stuff::LinearMatrix4D card_to_cloud;
 						card_to_cloud.BuildRotation(particle->m_localRotation);
@@ -654,7 +671,7 @@ void gosFX::CardCloud::Draw(DrawInfo *info)
 							Stuff::X_Axis,
 							-1
 						);
-						card_to_cloud.BuildTranslation(particle->m_localTranslation);
+						card_to_cloud.BuildTranslation(GetLocalTranslation(i));
 
 						//
 						//-------------------------------------------------
@@ -730,7 +747,7 @@ void gosFX::CardCloud::Draw(DrawInfo *info)
 			{
 				Particle *particle = GetParticle(i);
 				Check_Object(particle);
-				if (particle->m_age < 1.0f)
+				if (m_P_age[i] < 1.0f)
 				{
 
 					//
@@ -741,7 +758,7 @@ void gosFX::CardCloud::Draw(DrawInfo *info)
 					Stuff::Vector3D direction_in_cloud;
 					direction_in_cloud.Subtract(
 						camera_in_cloud,
-						particle->m_localTranslation
+						GetLocalTranslation(i)
 					);
 					Stuff::LinearMatrix4D card_to_cloud;
 					card_to_cloud.BuildRotation(particle->m_localRotation);
@@ -751,7 +768,7 @@ void gosFX::CardCloud::Draw(DrawInfo *info)
 						Stuff::Y_Axis,
 						-1
 					);
-					card_to_cloud.BuildTranslation(particle->m_localTranslation);
+					card_to_cloud.BuildTranslation(GetLocalTranslation(i));
 
 					//
 					//-------------------------------------------------
@@ -809,7 +826,7 @@ void gosFX::CardCloud::Draw(DrawInfo *info)
 			{
 				Particle *particle = GetParticle(i);
 				Check_Object(particle);
-				if (particle->m_age < 1.0f)
+				if (m_P_age[i] < 1.0f)
 				{
 
 					//
@@ -819,7 +836,7 @@ void gosFX::CardCloud::Draw(DrawInfo *info)
 					//
 					Stuff::LinearMatrix4D card_to_cloud;
 					card_to_cloud.BuildRotation(particle->m_localRotation);
-					card_to_cloud.BuildTranslation(particle->m_localTranslation);
+					card_to_cloud.BuildTranslation(GetLocalTranslation(i));
 
 					//
 					//-------------------------------------------------
@@ -202,76 +202,95 @@ void
 	// Set the transform on the effect, then start the child effect
 	//-------------------------------------------------------------
 	//
-	effect->m_localToParent.BuildTranslation(particle->m_localTranslation);
+	effect->m_localToParent.BuildTranslation(GetLocalTranslation(index));
 	effect->m_localToParent.BuildRotation(particle->m_localRotation);
 	ExecuteInfo
 		local_info(
 			m_lastRan,
 			&m_localToWorld,
 			NULL,
-			particle->m_seed
+			m_P_seed[index]
 		);
-	local_info.m_age = particle->m_age;
-	local_info.m_ageRate = particle->m_ageRate;
+	local_info.m_age = m_P_age[index];
+	local_info.m_ageRate = m_P_ageRate[index];
 	effect->Start(&local_info);
 }
 
 //------------------------------------------------------------------------------
 //
-bool
-	gosFX::EffectCloud::AnimateParticle(
-		unsigned index,
-		const Stuff::LinearMatrix4D *world_to_new_local,
-		Stuff::Time till
-	)
+void
+	gosFX::EffectCloud::AgeParticles(Stuff::Scalar dT)
 {
 	Check_Object(this);
 
 	//
 	//--------------------------------------------------------------------
 	// Make sure that we don't blow the age counters out of the base cloud
-	// effects
+	// effects.  Our particles only die when their effects are finished
 	//--------------------------------------------------------------------
 	//
-	Particle *particle = GetParticle(index);
-	Check_Object(particle);
-	if (particle->m_age >= 1.0f)
-		particle->m_age = 1.0f - Stuff::SMALL;
-	SpinningCloud::AnimateParticle(index, world_to_new_local, till);
+	for (int i=0; i<m_activeParticleCount; ++i)
+	{
+		if (m_P_age[i] >= 1.0f)
+			continue;
+		m_P_age[i] += dT*m_P_ageRate[i];
+		if (m_P_age[i] >= 1.0f)
+			m_P_age[i] = 1.0f - Stuff::SMALL;
+	}
+}
 
-	//
-	//---------------------------------
-	// Update the location of the cloud
-	//---------------------------------
-	//
-	Effect *effect = particle->m_effect;
-	Check_Object(effect);
-	effect->m_localToParent.BuildTranslation(particle->m_localTranslation);
-	effect->m_localToParent.BuildRotation(particle->m_localRotation);
+//------------------------------------------------------------------------------
+//
+void
+	gosFX::EffectCloud::AnimateParticles(
+		unsigned first,
+		unsigned end,
+		const Stuff::LinearMatrix4D *world_to_new_local,
+		Stuff::Time till
+	)
+{
+	Check_Object(this);
 
-	//
-	//-----------------------
-	// Execute all the effect
-	//-----------------------
-	//
-	Stuff::OBB bounds;
-	ExecuteInfo
-		info(
-			till,
-			&m_localToWorld,
-			&bounds
-		);
-	if (effect->Execute(&info))
+	SpinningCloud::AnimateParticles(first, end, world_to_new_local, till);
+	for (unsigned i=first; i<end; ++i)
 	{
-		Stuff::Point3D center(bounds.localToParent);
-		particle->m_radius = center.GetLength() + bounds.sphereRadius;
-		return true;
-	}
+		if (m_P_age[i] >= 1.0f)
+			continue;
+
+		//
+		//---------------------------------
+		// Update the location of the cloud
+		//---------------------------------
+		//
+		Particle *particle = GetParticle(i);
+		Check_Object(particle);
+		Effect *effect = particle->m_effect;
+		Check_Object(effect);
+		effect->m_localToParent.BuildTranslation(GetLocalTranslation(i));
+		effect->m_localToParent.BuildRotation(particle->m_localRotation);
+
+		//
+		//-----------------------
+		// Execute all the effect
+		//-----------------------
+		//
+		Stuff::OBB bounds;
+		ExecuteInfo
+			info(
+				till,
+				&m_localToWorld,
+				&bounds
+			);
+		if (effect->Execute(&info))
+		{
+			Stuff::Point3D center(bounds.localToParent);
+			particle->m_radius = center.GetLength() + bounds.sphereRadius;
+			continue;
+		}
 
-	particle->m_radius = 0.0f;
-	delete particle->m_effect;
-	particle->m_effect = NULL;
-	return false;
+		particle->m_radius = 0.0f;
+		DestroyParticle(i);
+	}
 }
 
 //------------------------------------------------------------------------------
@@ -316,7 +335,7 @@ void gosFX::EffectCloud::Draw(DrawInfo *info)
 			// issue the draw command
 			//-----------------------------------------------------------------
 			//
-			if (particle->m_age < 1.0f)
+			if (m_P_age[i] < 1.0f)
 			{
 				if (particle->m_effect)
 				{
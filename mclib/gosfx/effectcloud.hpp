@@ -130,9 +130,12 @@ namespace gosFX
 	// API
 	//
 	protected:
-		bool
-			AnimateParticle(
-				unsigned index,
+		void
+			AgeParticles(Stuff::Scalar dT);
+		void
+			AnimateParticles(
+				unsigned first,
+				unsigned end,
 				const Stuff::LinearMatrix4D *world_to_new_local,
 				Stuff::Time till
 			);
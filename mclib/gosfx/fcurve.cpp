@@ -1921,3 +1921,51 @@ gosFX::ComplexCurve::ComputeRange(
 			*low = l;
 	}
 }
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+void
+gosFX::ComplexCurve::ComputeValues(
+								   const Stuff::Scalar *t,
+								   const Stuff::Scalar *,
+								   Stuff::Scalar *values,
+								   unsigned first,
+								   unsigned end
+								   )
+{
+	Check_Object(this);
+	Check_Pointer(t);
+	Check_Pointer(values);
+
+	//
+	//---------------------------------------------------------------------
+	// Most curves are built by SetCurve() and have just the one key, which
+	// makes them a line
+	//---------------------------------------------------------------------
+	//
+	const int key_count = (int)m_keys.GetLength();
+	Verify(key_count > 0);
+	if (key_count == 1)
+	{
+		const CurveKey &key = m_keys[0];
+		for (unsigned i=first; i<end; ++i)
+			values[i] = key.m_slope*(t[i] - key.m_time) + key.m_value;
+		return;
+	}
+
+	//
+	//---------------------------------------------------
+	// Otherwise find the key each of the times falls in
+	//---------------------------------------------------
+	//
+	const CurveKey *keys = &m_keys[0];
+	for (unsigned i=first; i<end; ++i)
+	{
+		const Stuff::Scalar time = t[i];
+		int k = 1;
+		while (k<key_count && keys[k].m_time <= time)
+			++k;
+		const CurveKey &key = keys[k-1];
+		values[i] = key.m_slope*(time - key.m_time) + key.m_value;
+	}
+}
@@ -129,6 +129,24 @@ namespace gosFX {
 		Stuff::Scalar
 			ComputeValue(Stuff::Scalar, Stuff::Scalar)
 				{Check_Object(this); return m_value;}
+
+		//-----------------------------------------------------------------
+		// Batched ComputeValue(), fills values[first..end) from t[first..end),
+		// used to animate all particles of a cloud at once
+		//-----------------------------------------------------------------
+		void
+			ComputeValues(
+				const Stuff::Scalar *,
+				const Stuff::Scalar *,
+				Stuff::Scalar *values,
+				unsigned first,
+				unsigned end
+			)
+				{
+					Check_Object(this); Check_Pointer(values);
+					for (unsigned i=first; i<end; ++i)
+						values[i] = m_value;
+				}
 		Stuff::Scalar
 			ComputeSlope(Stuff::Scalar)
 				{Check_Object(this); return 0.0f;}
@@ -185,6 +203,19 @@ namespace gosFX {
 		Stuff::Scalar
 			ComputeValue(Stuff::Scalar t, Stuff::Scalar)
 				{Check_Object(this); return m_slope*t + m_value;}
+		void
+			ComputeValues(
+				const Stuff::Scalar *t,
+				const Stuff::Scalar *,
+				Stuff::Scalar *values,
+				unsigned first,
+				unsigned end
+			)
+				{
+					Check_Object(this); Check_Pointer(t); Check_Pointer(values);
+					for (unsigned i=first; i<end; ++i)
+						values[i] = m_slope*t[i] + m_value;
+				}
 		Stuff::Scalar
 			ComputeSlope(Stuff::Scalar)
 				{Check_Object(this); return m_slope;}
@@ -244,6 +275,19 @@ namespace gosFX {
 		Stuff::Scalar
 			ComputeValue(Stuff::Scalar t, Stuff::Scalar)
 				{Check_Object(this); return ((m_a*t + m_b)*t + m_slope)*t + m_value;}
+		void
+			ComputeValues(
+				const Stuff::Scalar *t,
+				const Stuff::Scalar *,
+				Stuff::Scalar *values,
+				unsigned first,
+				unsigned end
+			)
+				{
+					Check_Object(this); Check_Pointer(t); Check_Pointer(values);
+					for (unsigned i=first; i<end; ++i)
+						values[i] = ((m_a*t[i] + m_b)*t[i] + m_slope)*t[i] + m_value;
+				}
 		Stuff::Scalar
 			ComputeSlope(Stuff::Scalar t)
 				{Check_Object(this); return (3.0f*m_a*t + 2.0f*m_b)*t + m_slope;}
@@ -375,6 +419,14 @@ namespace gosFX {
 					CurveKey &key = (*this)[GetKeyIndex(time)];
 					return key.ComputeValue(time - key.m_time);
 				}
+		void
+			ComputeValues(
+				const Stuff::Scalar *t,
+				const Stuff::Scalar *,
+				Stuff::Scalar *values,
+				unsigned first,
+				unsigned end
+			);
 		Stuff::Scalar
 			ComputeSlope(Stuff::Scalar time)
 				{
@@ -431,6 +483,24 @@ namespace gosFX {
 						result *= m_seedCurve.ComputeValue(seed, 0.0f);
 					return result;
 				}
+		void
+			ComputeValues(
+				const Stuff::Scalar *ages,
+				const Stuff::Scalar *seeds,
+				Stuff::Scalar *values,
+				unsigned first,
+				unsigned end
+			)
+				{
+					Check_Object(this);
+					m_ageCurve.ComputeValues(ages, NULL, values, first, end);
+					if (m_seeded)
+					{
+						Check_Pointer(seeds);
+						for (unsigned i=first; i<end; ++i)
+							values[i] *= m_seedCurve.ComputeValue(seeds[i], 0.0f);
+					}
+				}
 		void
 			ComputeRange(
 				Stuff::Scalar *low,
@@ -1,5 +1,15 @@
 #include"gosfxheaders.hpp"
 
+//
+// SSE is always there on x64, elsewhere lanes are processed one by one
+//
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define GOSFX_USE_SSE 1
+#include<xmmintrin.h>
+#else
+#define GOSFX_USE_SSE 0
+#endif
+
 //==========================================================================//
 // File:	 gosFX_ParticleCloud.cpp										//
 // Contents: Base gosFX::ParticleCloud Component							//
@@ -322,6 +332,22 @@ gosFX::ParticleCloud::ParticleCloud(
 	//
 	m_data.SetLength(spec->m_maxParticleCount*spec->m_totalParticleSize);
 
+	//
+	//---------------------------------------------------------------------
+	// Lanes are padded to whole SSE vectors, dead particles are always aged
+	// one, so that they are skipped by the kernels
+	//---------------------------------------------------------------------
+	//
+	m_laneStride = (spec->m_maxParticleCount + 3) & ~3;
+	m_lanes.SetLength(LaneCount*m_laneStride);
+	m_P_age = GetLane(AgeLane);
+	m_P_ageRate = GetLane(AgeRateLane);
+	m_P_seed = GetLane(SeedLane);
+	for (unsigned i=0; i<LaneCount*m_laneStride; ++i)
+		m_lanes[i] = 0.0f;
+	for (unsigned i=0; i<m_laneStride; ++i)
+		m_P_age[i] = 1.0f;
+
 	//
 	//-------------------------------
 	// Set up an empty particle cloud
@@ -402,50 +428,27 @@ bool gosFX::ParticleCloud::Execute(ExecuteInfo *info)
 	}
 
 	//
-	//-----------------------------------
-	// Deal with all the active particles
-	//-----------------------------------
+	//-------------------------------------------------------------------
+	// Age all the active particles at once, the ones which got too old
+	// are destroyed
+	//-------------------------------------------------------------------
+	//
+	AgeParticles(dT);
+
+	//
+	//--------------------------------------------------------------------
+	// If there are new particles to be born, put them into the free slots
+	//--------------------------------------------------------------------
 	//
 	int i;
-	int last_real = -1;
-	for (i = 0; i < m_activeParticleCount; i++)
+	for (i = 0; i < m_activeParticleCount && m_birthAccumulator >= 1.0f; i++)
 	{
-		//
-		//--------------------------------------------------------------------
-		// If the particle is active, age it and if it is not yet time to die,
-		// go to the next particle, otherwise kill it
-		//--------------------------------------------------------------------
-		//
-		Particle *particle = GetParticle(i);
-		Check_Object(particle);
-		if (particle->m_age < 1.0f)
-		{
-			particle->m_age += dT*particle->m_ageRate;
-			if (AnimateParticle(i, matrix, info->m_time))
-			{
-				last_real = i;
-				continue;
-			}
-			DestroyParticle(i);
-		}
-
-		//
-		//--------------------------------------------------------------------
-		// If there are new particles to be born, go ahead and create them now
-		//--------------------------------------------------------------------
-		//
-		if (m_birthAccumulator >= 1.0f)
-		{
-			Stuff::Point3D translation;
-			CreateNewParticle(i, &translation);
-			if (AnimateParticle(i, matrix, info->m_time))
-				last_real = i;
-			else
-				DestroyParticle(i);
-			m_birthAccumulator -= 1.0f;
-		}
+		if (m_P_age[i] < 1.0f)
+			continue;
+		Stuff::Point3D translation;
+		CreateNewParticle(i, &translation);
+		m_birthAccumulator -= 1.0f;
 	}
-	m_activeParticleCount = last_real + 1;
 
 	//
 	//----------------------------------------------------------------------
@@ -461,14 +464,19 @@ bool gosFX::ParticleCloud::Execute(ExecuteInfo *info)
 		i = m_activeParticleCount++;
 		Stuff::Point3D translation;
 		CreateNewParticle(i, &translation);
-		if (!AnimateParticle(i, matrix, info->m_time))
-		{
-			DestroyParticle(i);
-			--m_activeParticleCount;
-		}
 		m_birthAccumulator -= 1.0f;
 	}
 
+	//
+	//-----------------------------------------------------------------
+	// Animate everything which is alive, newborns included, then trim
+	// the dead particles off the end of the cloud
+	//-----------------------------------------------------------------
+	//
+	AnimateParticles(0, m_activeParticleCount, matrix, info->m_time);
+	while (m_activeParticleCount > 0 && m_P_age[m_activeParticleCount-1] >= 1.0f)
+		--m_activeParticleCount;
+
 	//
 	//---------------------------------------------------------
 	// Only allow fractional births to carry over to next frame
@@ -534,9 +542,7 @@ void
 	//
 	Specification *spec = GetSpecification();
 	Check_Object(spec);
-	Particle *particle = GetParticle(index);
-	Check_Object(particle);
-	particle->m_age = 0.0f;
+	m_P_age[index] = 0.0f;
 	Stuff::Scalar min_seed =
 		spec->m_minimumChildSeed.ComputeValue(m_age, m_seed);
 	Stuff::Scalar seed_range =
@@ -544,11 +550,11 @@ void
 	Stuff::Scalar seed =
 		Stuff::Random::GetFraction()*seed_range + min_seed;
 	Clamp(seed, 0.0f, 1.0f);
-	particle->m_seed = seed;
+	m_P_seed[index] = seed;
 	Stuff::Scalar lifetime =
 		spec->m_pLifeSpan.ComputeValue(m_age, seed);
 	Min_Clamp(lifetime, 0.0333333f);
-	particle->m_ageRate = 1.0f / lifetime;
+	m_P_ageRate[index] = 1.0f / lifetime;
 
 	//
 	//--------------------------------
@@ -568,6 +574,9 @@ void
 		position.y * spec->m_emitterSizeY.ComputeValue(m_age, seed);
 	translation->z =
 		position.z * spec->m_emitterSizeZ.ComputeValue(m_age, seed);
+	GetLane(TranslationXLane)[index] = translation->x;
+	GetLane(TranslationYLane)[index] = translation->y;
+	GetLane(TranslationZLane)[index] = translation->z;
 
 	//
 	//--------------------------------
@@ -588,16 +597,422 @@ void
 			pitch_min,
 			spec->m_startingSpeed.ComputeValue(m_age, seed)
 		);
-	particle->m_localLinearVelocity = initial_v;
+	Stuff::Vector3D velocity(initial_v);
+	GetLane(VelocityXLane)[index] = velocity.x;
+	GetLane(VelocityYLane)[index] = velocity.y;
+	GetLane(VelocityZLane)[index] = velocity.z;
 }
 
 //------------------------------------------------------------------------------
 //
 void gosFX::ParticleCloud::DestroyParticle(unsigned index)
 {
-	Particle *particle = GetParticle(index);
-	Check_Object(particle);
-	particle->m_age = 1.0f;
+	Check_Object(this);
+	m_P_age[index] = 1.0f;
+}
+
+//############################################################################
+//#########################  Particle lane kernels  ##########################
+//############################################################################
+
+namespace {
+
+	//
+	// Rotation and translation of a LinearMatrix4D, laid out so that the lane
+	// kernels do not have to go through the matrix accessors
+	//
+	struct LaneTransform
+	{
+		Stuff::Scalar
+			m_rotation[3][3],
+			m_translation[3];
+
+		void
+			BuildFrom(const Stuff::LinearMatrix4D &m, bool with_translation)
+				{
+					for (int i=0; i<3; ++i)
+					{
+						for (int j=0; j<3; ++j)
+							m_rotation[i][j] = m(i,j);
+						m_translation[i] = with_translation ? m(3,i) : 0.0f;
+					}
+				}
+		void
+			BuildFromInverseRotation(const Stuff::LinearMatrix4D &m)
+				{
+					for (int i=0; i<3; ++i)
+					{
+						for (int j=0; j<3; ++j)
+							m_rotation[i][j] = m(j,i);
+						m_translation[i] = 0.0f;
+					}
+				}
+	};
+
+	//
+	//------------------------------------------------------------------------
+	// Transforms the vectors held in x/y/z lanes in place, the same way
+	// Point3D::Multiply() does
+	//------------------------------------------------------------------------
+	//
+	void
+		TransformLanes(
+			const LaneTransform &m,
+			Stuff::Scalar *x,
+			Stuff::Scalar *y,
+			Stuff::Scalar *z,
+			unsigned first,
+			unsigned end
+		)
+	{
+		unsigned i = first;
+#if GOSFX_USE_SSE
+		__m128 m00 = _mm_set1_ps(m.m_rotation[0][0]);
+		__m128 m01 = _mm_set1_ps(m.m_rotation[0][1]);
+		__m128 m02 = _mm_set1_ps(m.m_rotation[0][2]);
+		__m128 m10 = _mm_set1_ps(m.m_rotation[1][0]);
+		__m128 m11 = _mm_set1_ps(m.m_rotation[1][1]);
+		__m128 m12 = _mm_set1_ps(m.m_rotation[1][2]);
+		__m128 m20 = _mm_set1_ps(m.m_rotation[2][0]);
+		__m128 m21 = _mm_set1_ps(m.m_rotation[2][1]);
+		__m128 m22 = _mm_set1_ps(m.m_rotation[2][2]);
+		__m128 t0 = _mm_set1_ps(m.m_translation[0]);
+		__m128 t1 = _mm_set1_ps(m.m_translation[1]);
+		__m128 t2 = _mm_set1_ps(m.m_translation[2]);
+		for (; i+4<=end; i+=4)
+		{
+			__m128 vx = _mm_loadu_ps(x+i);
+			__m128 vy = _mm_loadu_ps(y+i);
+			__m128 vz = _mm_loadu_ps(z+i);
+			__m128 rx =
+				_mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(vx, m00), _mm_mul_ps(vy, m10)),
+					_mm_add_ps(_mm_mul_ps(vz, m20), t0)
+				);
+			__m128 ry =
+				_mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(vx, m01), _mm_mul_ps(vy, m11)),
+					_mm_add_ps(_mm_mul_ps(vz, m21), t1)
+				);
+			__m128 rz =
+				_mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(vx, m02), _mm_mul_ps(vy, m12)),
+					_mm_add_ps(_mm_mul_ps(vz, m22), t2)
+				);
+			_mm_storeu_ps(x+i, rx);
+			_mm_storeu_ps(y+i, ry);
+			_mm_storeu_ps(z+i, rz);
+		}
+#endif
+		for (; i<end; ++i)
+		{
+			Stuff::Scalar vx = x[i], vy = y[i], vz = z[i];
+			x[i] =
+				vx*m.m_rotation[0][0] + vy*m.m_rotation[1][0]
+				 + vz*m.m_rotation[2][0] + m.m_translation[0];
+			y[i] =
+				vx*m.m_rotation[0][1] + vy*m.m_rotation[1][1]
+				 + vz*m.m_rotation[2][1] + m.m_translation[1];
+			z[i] =
+				vx*m.m_rotation[0][2] + vy*m.m_rotation[1][2]
+				 + vz*m.m_rotation[2][2] + m.m_translation[2];
+		}
+	}
+
+	//
+	//------------------------------------------------------------------------
+	// Applies drag towards the ether velocity plus acceleration to the live
+	// particles, then moves them.  Drag can never assist velocity
+	//------------------------------------------------------------------------
+	//
+	void
+		IntegrateLanes(
+			const Stuff::Scalar *age,
+			Stuff::Scalar *const *velocity,
+			Stuff::Scalar *const *translation,
+			const Stuff::Scalar *drag,
+			const Stuff::Scalar *const *ether,
+			const Stuff::Scalar *const *accel,
+			Stuff::Scalar time_slice,
+			unsigned first,
+			unsigned end
+		)
+	{
+		unsigned i = first;
+#if GOSFX_USE_SSE
+		__m128 one = _mm_set1_ps(1.0f);
+		__m128 zero = _mm_setzero_ps();
+		__m128 dt = _mm_set1_ps(time_slice);
+		for (; i+4<=end; i+=4)
+		{
+			__m128 alive = _mm_cmplt_ps(_mm_loadu_ps(age+i), one);
+			if (!_mm_movemask_ps(alive))
+				continue;
+			__m128 d = _mm_min_ps(_mm_sub_ps(zero, _mm_loadu_ps(drag+i)), zero);
+			for (int c=0; c<3; ++c)
+			{
+				__m128 v = _mm_loadu_ps(velocity[c]+i);
+				__m128 p = _mm_loadu_ps(translation[c]+i);
+				__m128 a =
+					_mm_add_ps(
+						_mm_mul_ps(_mm_sub_ps(v, _mm_loadu_ps(ether[c]+i)), d),
+						_mm_loadu_ps(accel[c]+i)
+					);
+				__m128 new_v = _mm_add_ps(v, _mm_mul_ps(a, dt));
+				__m128 new_p = _mm_add_ps(p, _mm_mul_ps(new_v, dt));
+				_mm_storeu_ps(
+					velocity[c]+i,
+					_mm_or_ps(_mm_and_ps(alive, new_v), _mm_andnot_ps(alive, v))
+				);
+				_mm_storeu_ps(
+					translation[c]+i,
+					_mm_or_ps(_mm_and_ps(alive, new_p), _mm_andnot_ps(alive, p))
+				);
+			}
+		}
+#endif
+		for (; i<end; ++i)
+		{
+			if (age[i] >= 1.0f)
+				continue;
+			Stuff::Scalar d = -drag[i];
+			Max_Clamp(d, 0.0f);
+			for (int c=0; c<3; ++c)
+			{
+				Stuff::Scalar a = (velocity[c][i] - ether[c][i])*d + accel[c][i];
+				velocity[c][i] += a*time_slice;
+				translation[c][i] += velocity[c][i]*time_slice;
+			}
+		}
+	}
+
+}
+
+//------------------------------------------------------------------------------
+//
+void
+	gosFX::ParticleCloud::AgeParticles(Stuff::Scalar dT)
+{
+	Check_Object(this);
+
+	//
+	//-------------------------------------------------------------------
+	// Age every live particle, and destroy the ones which crossed over to
+	// one this frame.  Dead particles sit at one and are left alone
+	//-------------------------------------------------------------------
+	//
+	unsigned end = m_activeParticleCount;
+	unsigned i = 0;
+#if GOSFX_USE_SSE
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 delta = _mm_set1_ps(dT);
+	for (; i+4<=end; i+=4)
+	{
+		__m128 age = _mm_loadu_ps(m_P_age+i);
+		__m128 alive = _mm_cmplt_ps(age, one);
+		int alive_mask = _mm_movemask_ps(alive);
+		if (!alive_mask)
+			continue;
+		__m128 new_age =
+			_mm_add_ps(age, _mm_mul_ps(delta, _mm_loadu_ps(m_P_ageRate+i)));
+		_mm_storeu_ps(
+			m_P_age+i,
+			_mm_or_ps(_mm_and_ps(alive, new_age), _mm_andnot_ps(alive, age))
+		);
+		int expired = alive_mask & _mm_movemask_ps(_mm_cmpge_ps(new_age, one));
+		for (int j=0; expired; ++j, expired>>=1)
+			if (expired & 1)
+				DestroyParticle(i+j);
+	}
+#endif
+	for (; i<end; ++i)
+	{
+		if (m_P_age[i] >= 1.0f)
+			continue;
+		m_P_age[i] += dT*m_P_ageRate[i];
+		if (m_P_age[i] >= 1.0f)
+			DestroyParticle(i);
+	}
+}
+
+//------------------------------------------------------------------------------
+//
+void
+	gosFX::ParticleCloud::AnimateParticles(
+		unsigned first,
+		unsigned end,
+		const Stuff::LinearMatrix4D *world_to_new_local,
+		Stuff::Time till
+	)
+{
+	Check_Object(this);
+
+	for (unsigned i=first; i<end; ++i)
+	{
+		if (m_P_age[i] < 1.0f && !AnimateParticle(i, world_to_new_local, till))
+			DestroyParticle(i);
+	}
+}
+
+//------------------------------------------------------------------------------
+//
+unsigned
+	gosFX::ParticleCloud::AnimateLinearMotion(
+		unsigned first,
+		unsigned end,
+		const Stuff::LinearMatrix4D *world_to_new_local,
+		Stuff::Time till
+	)
+{
+	Check_Object(this);
+	Verify(end <= m_laneStride);
+
+	unsigned live = 0;
+	for (unsigned i=first; i<end; ++i)
+		if (m_P_age[i] < 1.0f)
+			++live;
+	if (!live)
+		return 0;
+
+	//
+	//--------------------------------------------------------------------
+	// Run the motion curves for the whole range into the scratch lanes
+	//--------------------------------------------------------------------
+	//
+	Specification *spec = GetSpecification();
+	Check_Object(spec);
+	Stuff::Scalar *drag = GetLane(FirstScratchLane);
+	Stuff::Scalar *ether[3] = {
+		GetLane(FirstScratchLane+1),
+		GetLane(FirstScratchLane+2),
+		GetLane(FirstScratchLane+3)
+	};
+	Stuff::Scalar *accel[3] = {
+		GetLane(FirstScratchLane+4),
+		GetLane(FirstScratchLane+5),
+		GetLane(FirstScratchLane+6)
+	};
+	spec->m_pDrag.ComputeValues(m_P_age, m_P_seed, drag, first, end);
+	spec->m_pEtherVelocityX.ComputeValues(m_P_age, m_P_seed, ether[0], first, end);
+	spec->m_pEtherVelocityY.ComputeValues(m_P_age, m_P_seed, ether[1], first, end);
+	spec->m_pEtherVelocityZ.ComputeValues(m_P_age, m_P_seed, ether[2], first, end);
+	spec->m_pAccelerationX.ComputeValues(m_P_age, m_P_seed, accel[0], first, end);
+	spec->m_pAccelerationY.ComputeValues(m_P_age, m_P_seed, accel[1], first, end);
+	spec->m_pAccelerationZ.ComputeValues(m_P_age, m_P_seed, accel[2], first, end);
+
+	Stuff::Scalar *velocity[3] = {
+		GetLane(VelocityXLane),
+		GetLane(VelocityYLane),
+		GetLane(VelocityZLane)
+	};
+	Stuff::Scalar *translation[3] = {
+		GetLane(TranslationXLane),
+		GetLane(TranslationYLane),
+		GetLane(TranslationZLane)
+	};
+
+	//
+	//-----------------------------------------------------------------------
+	// If this cloud is unparented, the particles are simulated in world space
+	//-----------------------------------------------------------------------
+	//
+	int sim_mode = GetSimulationMode();
+	LaneTransform transform;
+	if (sim_mode == DynamicWorldSpaceSimulationMode)
+	{
+		transform.BuildFrom(m_localToWorld, false);
+		TransformLanes(transform, velocity[0], velocity[1], velocity[2], first, end);
+		transform.BuildFrom(m_localToWorld, true);
+		TransformLanes(
+			transform,
+			translation[0],
+			translation[1],
+			translation[2],
+			first,
+			end
+		);
+	}
+
+	//
+	//-------------------------------------------------------------------
+	// Deal with pseudo-world simulation.  In this mode, we interpret the
+	// forces as if they are already in worldspace, and we transform them
+	// back to local space
+	//-------------------------------------------------------------------
+	//
+	else if (sim_mode == StaticWorldSpaceSimulationMode)
+	{
+		Stuff::LinearMatrix4D world_to_effect;
+		world_to_effect.Invert(m_localToWorld);
+		transform.BuildFromInverseRotation(world_to_effect);
+		TransformLanes(transform, ether[0], ether[1], ether[2], first, end);
+		transform.BuildFrom(world_to_effect, false);
+		TransformLanes(transform, accel[0], accel[1], accel[2], first, end);
+	}
+
+	//
+	//-------------------------------------------------
+	// Compute the particles' new velocity and position
+	//-------------------------------------------------
+	//
+	Stuff::Scalar time_slice =
+		static_cast<Stuff::Scalar>(till - m_lastRan);
+	IntegrateLanes(
+		m_P_age,
+		velocity,
+		translation,
+		drag,
+		ether,
+		accel,
+		time_slice,
+		first,
+		end
+	);
+
+	//
+	//---------------------------------------------------------------------
+	// If we are unparented, we need to transform the velocity and position
+	// data back into the NEW local space
+	//---------------------------------------------------------------------
+	//
+	if (sim_mode == DynamicWorldSpaceSimulationMode)
+	{
+		Check_Object(world_to_new_local);
+		transform.BuildFrom(*world_to_new_local, false);
+		TransformLanes(transform, velocity[0], velocity[1], velocity[2], first, end);
+		transform.BuildFrom(*world_to_new_local, true);
+		TransformLanes(
+			transform,
+			translation[0],
+			translation[1],
+			translation[2],
+			first,
+			end
+		);
+	}
+	return live;
+}
+
+//------------------------------------------------------------------------------
+//
+void
+	gosFX::ParticleCloud::ComputeColors(
+		unsigned first,
+		unsigned end,
+		Stuff::Scalar *red,
+		Stuff::Scalar *green,
+		Stuff::Scalar *blue,
+		Stuff::Scalar *alpha
+	)
+{
+	Check_Object(this);
+
+	Specification *spec = GetSpecification();
+	Check_Object(spec);
+	spec->m_pRed.ComputeValues(m_P_age, m_P_seed, red, first, end);
+	spec->m_pGreen.ComputeValues(m_P_age, m_P_seed, green, first, end);
+	spec->m_pBlue.ComputeValues(m_P_age, m_P_seed, blue, first, end);
+	spec->m_pAlpha.ComputeValues(m_P_age, m_P_seed, alpha, first, end);
 }
 
 //------------------------------------------------------------------------------
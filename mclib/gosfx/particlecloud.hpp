@@ -94,17 +94,14 @@ namespace gosFX
 	//########################  ParticleCloud__Particle  #############################
 	//############################################################################
 
+	//
+	// Age, seed, velocity and position of the particles are not kept here but
+	// in the lanes of the cloud (see ParticleCloud::GetLane()), so that whole
+	// clouds can be aged, integrated and run through their curves at once
+	//
 	class ParticleCloud__Particle
 	{
 	public:
-		Stuff::Vector3D
-			m_localLinearVelocity,
-			m_worldLinearVelocity;
-		Stuff::Scalar
-			m_seed,
-			m_age,
-			m_ageRate;
-
 		void
 			TestInstance() const
 				{}
@@ -129,6 +126,26 @@ namespace gosFX
 		typedef ParticleCloud__Specification Specification;
 		typedef ParticleCloud__Particle Particle;
 
+		//
+		// Per particle values stored structure of arrays, each lane holds
+		// one value for every particle.  Scratch lanes are free for use by
+		// AnimateParticles() for batched curve evaluation
+		//
+		enum {
+			AgeLane = 0,
+			AgeRateLane,
+			SeedLane,
+			VelocityXLane,
+			VelocityYLane,
+			VelocityZLane,
+			TranslationXLane,
+			TranslationYLane,
+			TranslationZLane,
+			FirstScratchLane,
+			ScratchLaneCount = 8,
+			LaneCount = FirstScratchLane + ScratchLaneCount
+		};
+
 	protected:
 		int
 			m_activeParticleCount;
@@ -138,6 +155,15 @@ namespace gosFX
 		Stuff::DynamicArrayOf<char>
 			m_data;
 
+		Stuff::DynamicArrayOf<Stuff::Scalar>
+			m_lanes;
+		unsigned
+			m_laneStride;
+		Stuff::Scalar
+			*m_P_age,
+			*m_P_ageRate,
+			*m_P_seed;
+
 		ParticleCloud(
 			ClassData *class_data,
 			Specification *spec,
@@ -165,6 +191,37 @@ namespace gosFX
 							&m_data[index*GetSpecification()->m_particleClassSize]
 						);
 				}
+		Stuff::Scalar*
+			GetLane(int lane)
+				{
+					Check_Object(this); Verify(lane >= 0 && lane < LaneCount);
+					return &m_lanes[lane*m_laneStride];
+				}
+		bool
+			IsParticleAlive(unsigned index)
+				{Check_Object(this); return m_P_age[index] < 1.0f;}
+		Stuff::Point3D
+			GetLocalTranslation(unsigned index)
+				{
+					Check_Object(this);
+					return
+						Stuff::Point3D(
+							m_lanes[TranslationXLane*m_laneStride + index],
+							m_lanes[TranslationYLane*m_laneStride + index],
+							m_lanes[TranslationZLane*m_laneStride + index]
+						);
+				}
+		Stuff::Vector3D
+			GetLocalLinearVelocity(unsigned index)
+				{
+					Check_Object(this);
+					return
+						Stuff::Vector3D(
+							m_lanes[VelocityXLane*m_laneStride + index],
+							m_lanes[VelocityYLane*m_laneStride + index],
+							m_lanes[VelocityZLane*m_laneStride + index]
+						);
+				}
 
 	//----------------------------------------------------------------------------
 	// Testing
@@ -179,12 +236,25 @@ namespace gosFX
 	protected:
 		bool
 			Execute(ExecuteInfo *info);
+		virtual void
+			AgeParticles(Stuff::Scalar dT);
 		virtual bool
 			AnimateParticle(
 				unsigned index,
 				const Stuff::LinearMatrix4D *world_to_new_local,
 				Stuff::Time till
 			)=0;
+		//
+		// Animates live particles in [first, end), particles which can not be
+		// animated any more are destroyed.  Default animates them one by one
+		//
+		virtual void
+			AnimateParticles(
+				unsigned first,
+				unsigned end,
+				const Stuff::LinearMatrix4D *world_to_new_local,
+				Stuff::Time till
+			);
 		virtual void
 			CreateNewParticle(
 				unsigned index,
@@ -192,10 +262,26 @@ namespace gosFX
 			);
 		virtual void
 			DestroyParticle(unsigned index);
+
+		//
+		// Moves live particles in [first, end) through drag, ether and
+		// acceleration curves, returns number of particles moved
+		//
+		unsigned
+			AnimateLinearMotion(
+				unsigned first,
+				unsigned end,
+				const Stuff::LinearMatrix4D *world_to_new_local,
+				Stuff::Time till
+			);
 		void
-			ComputeNewLinearVelocity(
-				Particle *particle,
-				Stuff::Scalar time_slice
+			ComputeColors(
+				unsigned first,
+				unsigned end,
+				Stuff::Scalar *red,
+				Stuff::Scalar *green,
+				Stuff::Scalar *blue,
+				Stuff::Scalar *alpha
 			);
 
 	public:
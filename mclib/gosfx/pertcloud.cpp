@@ -275,9 +275,10 @@ gosFX::PertCloud*
 
 //------------------------------------------------------------------------------
 //
-bool
-	gosFX::PertCloud::AnimateParticle(
-		unsigned index,
+void
+	gosFX::PertCloud::AnimateParticles(
+		unsigned first,
+		unsigned end,
 		const Stuff::LinearMatrix4D *world_to_new_local,
 		Stuff::Time till
 	)
@@ -289,15 +290,28 @@ bool
 	// Animate the parent then get our pointers
 	//-----------------------------------------
 	//
-	if (!SpinningCloud::AnimateParticle(index, world_to_new_local, till))
-		return false;
-	Set_Statistic(Pert_Count, Pert_Count+1);
+	SpinningCloud::AnimateParticles(first, end, world_to_new_local, till);
 	Specification *spec = GetSpecification();
 	Check_Object(spec);
-	Particle *particle = GetParticle(index);
-	Check_Object(particle);
-	Stuff::Scalar seed = particle->m_seed;
-	Stuff::Scalar age = particle->m_age;
+
+	//
+	//-------------------------------------------------------------
+	// Run the center and edge color curves for all the particles
+	//-------------------------------------------------------------
+	//
+	Stuff::Scalar *red = GetLane(FirstScratchLane);
+	Stuff::Scalar *green = GetLane(FirstScratchLane+1);
+	Stuff::Scalar *blue = GetLane(FirstScratchLane+2);
+	Stuff::Scalar *alpha = GetLane(FirstScratchLane+3);
+	Stuff::Scalar *center_red = GetLane(FirstScratchLane+4);
+	Stuff::Scalar *center_green = GetLane(FirstScratchLane+5);
+	Stuff::Scalar *center_blue = GetLane(FirstScratchLane+6);
+	Stuff::Scalar *center_alpha = GetLane(FirstScratchLane+7);
+	ComputeColors(first, end, red, green, blue, alpha);
+	spec->m_pCenterRed.ComputeValues(m_P_age, m_P_seed, center_red, first, end);
+	spec->m_pCenterGreen.ComputeValues(m_P_age, m_P_seed, center_green, first, end);
+	spec->m_pCenterBlue.ComputeValues(m_P_age, m_P_seed, center_blue, first, end);
+	spec->m_pCenterAlpha.ComputeValues(m_P_age, m_P_seed, center_alpha, first, end);
 
 	//
 	//------------------
@@ -305,18 +319,25 @@ bool
 	//------------------
 	//
 	Check_Pointer(m_P_color);
-	index *= 2;
-	m_P_color[index].red = spec->m_pCenterRed.ComputeValue(age, seed);
-	m_P_color[index].green = spec->m_pCenterGreen.ComputeValue(age, seed);
-	m_P_color[index].blue = spec->m_pCenterBlue.ComputeValue(age, seed);
-	m_P_color[index].alpha = spec->m_pCenterAlpha.ComputeValue(age, seed);
-
-	++index;
-	m_P_color[index].red = spec->m_pRed.ComputeValue(age, seed);
-	m_P_color[index].green = spec->m_pGreen.ComputeValue(age, seed);
-	m_P_color[index].blue = spec->m_pBlue.ComputeValue(age, seed);
-	m_P_color[index].alpha = spec->m_pAlpha.ComputeValue(age, seed);
-	return true;
+	unsigned live = 0;
+	for (unsigned i=first; i<end; ++i)
+	{
+		if (m_P_age[i] >= 1.0f)
+			continue;
+		++live;
+		unsigned index = i*2;
+		m_P_color[index].red = center_red[i];
+		m_P_color[index].green = center_green[i];
+		m_P_color[index].blue = center_blue[i];
+		m_P_color[index].alpha = center_alpha[i];
+
+		++index;
+		m_P_color[index].red = red[i];
+		m_P_color[index].green = green[i];
+		m_P_color[index].blue = blue[i];
+		m_P_color[index].alpha = alpha[i];
+	}
+	Set_Statistic(Pert_Count, Pert_Count+live);
 }
 
 //------------------------------------------------------------------------------
@@ -355,7 +376,7 @@ void
 	//
 	Verify(spec->m_vertices > 4);
 	Stuff::Scalar angle_between = Stuff::Two_Pi/(spec->m_vertices-2);
-	Stuff::Scalar radius = spec->m_size.ComputeValue(m_age, particle->m_seed);
+	Stuff::Scalar radius = spec->m_size.ComputeValue(m_age, m_P_seed[index]);
 	int even = 1;
 	particle->m_vertices[0] = Stuff::Point3D::Identity;
 	Stuff::Scalar bound = 0.0f;
@@ -363,7 +384,7 @@ void
 	for (; j<spec->m_vertices-1; j++)
 	{
 		Stuff::Scalar perturbance =
-			even * spec->m_perturbation.ComputeValue(m_age, particle->m_seed);
+			even * spec->m_perturbation.ComputeValue(m_age, m_P_seed[index]);
 		Stuff::Scalar temp = perturbance + radius;
 		particle->m_vertices[j] =
 			Stuff::Point3D(
@@ -446,7 +467,7 @@ void gosFX::PertCloud::Draw(DrawInfo *info)
 				{
 					Particle *particle = GetParticle(i);
 					Check_Object(particle);
-					if (particle->m_age < 1.0f)
+					if (m_P_age[i] < 1.0f)
 					{
 
 						//
@@ -457,7 +478,7 @@ void gosFX::PertCloud::Draw(DrawInfo *info)
 						Stuff::Vector3D direction_in_cloud;
 						direction_in_cloud.Subtract(
 							camera_in_cloud,
-							particle->m_localTranslation
+							GetLocalTranslation(i)
 						);
 						Stuff::LinearMatrix4D pert_to_cloud;
 						pert_to_cloud.BuildRotation(particle->m_localRotation);
@@ -467,7 +488,7 @@ void gosFX::PertCloud::Draw(DrawInfo *info)
 							Stuff::Y_Axis,
 							Stuff::X_Axis
 						);
-						pert_to_cloud.BuildTranslation(particle->m_localTranslation);
+						pert_to_cloud.BuildTranslation(GetLocalTranslation(i));
 
 						//
 						//----------------------------------------------------
@@ -516,7 +537,7 @@ void gosFX::PertCloud::Draw(DrawInfo *info)
 				{
 					Particle *particle = GetParticle(i);
 					Check_Object(particle);
-					if (particle->m_age < 1.0f)
+					if (m_P_age[i] < 1.0f)
 					{
 
 						//
@@ -527,7 +548,7 @@ void gosFX::PertCloud::Draw(DrawInfo *info)
 						Stuff::Vector3D direction_in_cloud;
 						direction_in_cloud.Subtract(
 							camera_in_cloud,
-							particle->m_localTranslation
+							GetLocalTranslation(i)
 						);
 						Stuff::LinearMatrix4D pert_to_cloud;
 						pert_to_cloud.BuildRotation(particle->m_localRotation);
@@ -537,7 +558,7 @@ void gosFX::PertCloud::Draw(DrawInfo *info)
 							Stuff::X_Axis,
 							-1
 						);
-						pert_to_cloud.BuildTranslation(particle->m_localTranslation);
+						pert_to_cloud.BuildTranslation(GetLocalTranslation(i));
 
 						//
 						//----------------------------------------------------
@@ -587,7 +608,7 @@ void gosFX::PertCloud::Draw(DrawInfo *info)
 			{
 				Particle *particle = GetParticle(i);
 				Check_Object(particle);
-				if (particle->m_age < 1.0f)
+				if (m_P_age[i] < 1.0f)
 				{
 
 					//
@@ -598,7 +619,7 @@ void gosFX::PertCloud::Draw(DrawInfo *info)
 					Stuff::Vector3D direction_in_cloud;
 					direction_in_cloud.Subtract(
 						camera_in_cloud,
-						particle->m_localTranslation
+						GetLocalTranslation(i)
 					);
 					Stuff::LinearMatrix4D pert_to_cloud;
 					pert_to_cloud.BuildRotation(particle->m_localRotation);
@@ -608,7 +629,7 @@ void gosFX::PertCloud::Draw(DrawInfo *info)
 						Stuff::Y_Axis,
 						-1
 					);
-					pert_to_cloud.BuildTranslation(particle->m_localTranslation);
+					pert_to_cloud.BuildTranslation(GetLocalTranslation(i));
 
 					//
 					//----------------------------------------------------
@@ -640,7 +661,7 @@ void gosFX::PertCloud::Draw(DrawInfo *info)
 			{
 				Particle *particle = GetParticle(i);
 				Check_Object(particle);
-				if (particle->m_age < 1.0f)
+				if (m_P_age[i] < 1.0f)
 				{
 
 					//
@@ -650,7 +671,7 @@ void gosFX::PertCloud::Draw(DrawInfo *info)
 					//
 					Stuff::LinearMatrix4D pert_to_cloud;
 					pert_to_cloud.BuildRotation(particle->m_localRotation);
-					pert_to_cloud.BuildTranslation(particle->m_localTranslation);
+					pert_to_cloud.BuildTranslation(GetLocalTranslation(i));
 
 					//
 					//----------------------------------------------------
@@ -189,9 +189,7 @@ bool
 		//
 		while (i<m_activeParticleCount)
 		{
-			Particle *particle = GetParticle(i);
-			Check_Object(particle);
-			if (particle->m_age < 1.0f)
+			if (m_P_age[i] < 1.0f)
 			{
 				Check_Object(vertex);
 				box.maxX = vertex->x;
@@ -215,9 +213,7 @@ bool
 		//
 		while (i<m_activeParticleCount)
 		{
-			Particle *particle = GetParticle(i);
-			Check_Object(particle);
-			if (particle->m_age < 1.0f)
+			if (m_P_age[i] < 1.0f)
 			{
 				Check_Object(vertex);
 				if (vertex->x > box.maxX)
@@ -304,143 +300,54 @@ bool
 {
 	Check_Object(this);
 
-	//
-	//-----------------------------------------------------------------------
-	// If this cloud is unparented, we need to transform the point from local
-	// space into world space and set the internal position/velocity pointers
-	// to these temporary values
-	//-----------------------------------------------------------------------
-	//
-	Particle *particle = GetParticle(index);
-	Check_Object(particle);
-	Stuff::Scalar age = particle->m_age;
-	if (age >= 1.0f)
-		return false;
-	Set_Statistic(Point_Count, Point_Count+1);
-	Stuff::Vector3D *velocity = &particle->m_localLinearVelocity;
-	Stuff::Point3D *translation = &m_P_localTranslation[index];
-	int sim_mode = GetSimulationMode();
-	if (sim_mode == DynamicWorldSpaceSimulationMode)
-	{
-		Check_Object(translation);
-		Check_Object(velocity);
-		particle->m_worldLinearVelocity.Multiply(*velocity, m_localToWorld);
-		particle->m_worldTranslation.Multiply(*translation, m_localToWorld);
-		translation = &particle->m_worldTranslation;
-		velocity = &particle->m_worldLinearVelocity;
-	}
-	Check_Object(translation);
-	Check_Object(velocity);
+	AnimateParticles(index, index+1, world_to_new_local, till);
+	return IsParticleAlive(index);
+}
 
-	//
-	//------------------------------------------------------------------
-	// First, calculate the drag on the particle.  Drag can never assist
-	// velocity
-	//------------------------------------------------------------------
-	//
-	Stuff::Scalar seed = particle->m_seed;
-	Specification *spec = GetSpecification();
-	Check_Object(spec);
-	Stuff::Vector3D ether;
-	ether.x = spec->m_pEtherVelocityX.ComputeValue(age, seed);
-	ether.y = spec->m_pEtherVelocityY.ComputeValue(age, seed);
-	ether.z = spec->m_pEtherVelocityZ.ComputeValue(age, seed);
-	Stuff::Vector3D accel(Stuff::Vector3D::Identity);
+//------------------------------------------------------------------------------
+//
+void
+	gosFX::PointCloud::AnimateParticles(
+		unsigned first,
+		unsigned end,
+		const Stuff::LinearMatrix4D *world_to_new_local,
+		Stuff::Time till
+	)
+{
+	Check_Object(this);
 
 	//
 	//-------------------------------------------------------------------
-	// Deal with pseudo-world simulation.  In this mode, we interpret the
-	// forces as if they are already in worldspace, and we transform them
-	// back to local space
+	// Move all the particles at once, then run the color curves for them
 	//-------------------------------------------------------------------
 	//
-	Stuff::Scalar drag = -spec->m_pDrag.ComputeValue(age, seed);
-	Max_Clamp(drag, 0.0f);
-	if (sim_mode == StaticWorldSpaceSimulationMode)
-	{
-		Stuff::LinearMatrix4D world_to_effect;
-		world_to_effect.Invert(m_localToWorld);
-		Stuff::Vector3D local_ether;
-		local_ether.MultiplyByInverse(ether, world_to_effect);
-		Stuff::Vector3D rel_vel;
-		rel_vel.Subtract(*velocity, local_ether);
-		accel.Multiply(rel_vel, drag);
-
-		//
-		//-----------------------------------------
-		// Now, add in acceleration of the particle
-		//-----------------------------------------
-		//
-		Stuff::Vector3D world_accel;
-		world_accel.x = spec->m_pAccelerationX.ComputeValue(age, seed);
-		world_accel.y = spec->m_pAccelerationY.ComputeValue(age, seed);
-		world_accel.z = spec->m_pAccelerationZ.ComputeValue(age, seed);
-		Stuff::Vector3D local_accel;
-		local_accel.Multiply(world_accel, world_to_effect);
-		accel += local_accel;
-	}
-
-	//
-	//----------------------------------------------------------------------
-	// Otherwise, just add the forces in the same space the particles are in
-	//----------------------------------------------------------------------
-	//
-	else
-	{
-		Stuff::Vector3D rel_vel;
-		rel_vel.Subtract(*velocity, ether);
-		accel.Multiply(rel_vel, drag);
-
-		//
-		//-----------------------------------------
-		// Now, add in acceleration of the particle
-		//-----------------------------------------
-		//
-		accel.x += spec->m_pAccelerationX.ComputeValue(age, seed);
-		accel.y += spec->m_pAccelerationY.ComputeValue(age, seed);
-		accel.z += spec->m_pAccelerationZ.ComputeValue(age, seed);
-	}
+	unsigned live = AnimateLinearMotion(first, end, world_to_new_local, till);
+	if (!live)
+		return;
+	Set_Statistic(Point_Count, Point_Count+live);
+	Stuff::Scalar *red = GetLane(FirstScratchLane);
+	Stuff::Scalar *green = GetLane(FirstScratchLane+1);
+	Stuff::Scalar *blue = GetLane(FirstScratchLane+2);
+	Stuff::Scalar *alpha = GetLane(FirstScratchLane+3);
+	ComputeColors(first, end, red, green, blue, alpha);
 
 	//
-	//-------------------------------------------------
-	// Compute the particle's new velocity and position
-	//-------------------------------------------------
+	//----------------------------------------------------------------
+	// Copy the results out to the arrays the point cloud is drawn from
+	//----------------------------------------------------------------
 	//
-	Stuff::Scalar time_slice =
-		static_cast<Stuff::Scalar>(till - m_lastRan);
-	velocity->AddScaled(*velocity, accel, time_slice);
-	translation->AddScaled(*translation, *velocity, time_slice);
-
-	//
-	//---------------------------------------------------------------------
-	// If we are unparented, we need to transform the velocity and position
-	// data back into the NEW local space
-	//---------------------------------------------------------------------
-	//
-	if (sim_mode == DynamicWorldSpaceSimulationMode)
+	Check_Pointer(m_P_color);
+	Check_Pointer(m_P_localTranslation);
+	for (unsigned i=first; i<end; ++i)
 	{
-		Check_Object(world_to_new_local);
-		particle->m_localLinearVelocity.Multiply(
-			particle->m_worldLinearVelocity,
-			*world_to_new_local
-		);
-		m_P_localTranslation[index].Multiply(
-			particle->m_worldTranslation,
-			*world_to_new_local
-		);
+		if (m_P_age[i] >= 1.0f)
+			continue;
+		m_P_localTranslation[i] = GetLocalTranslation(i);
+		m_P_color[i].red = red[i];
+		m_P_color[i].green = green[i];
+		m_P_color[i].blue = blue[i];
+		m_P_color[i].alpha = alpha[i];
 	}
-
-	//
-	//------------------
-	// Animate the color
-	//------------------
-	//
-	Check_Pointer(m_P_color);
-	m_P_color[index].red = spec->m_pRed.ComputeValue(age, seed);
-	m_P_color[index].green = spec->m_pGreen.ComputeValue(age, seed);
-	m_P_color[index].blue = spec->m_pBlue.ComputeValue(age, seed);
-	m_P_color[index].alpha = spec->m_pAlpha.ComputeValue(age, seed);
-	return true;
 }
 
 //------------------------------------------------------------------------------
@@ -48,9 +48,6 @@ namespace gosFX
 	class PointCloud__Particle:
 		public ParticleCloud__Particle
 	{
-	public:
-		Stuff::Point3D
-			m_worldTranslation;
 	};
 
 //############################################################################
@@ -137,6 +134,13 @@ namespace gosFX
 				const Stuff::LinearMatrix4D *world_to_new_local,
 				Stuff::Time till
 			);
+		void
+			AnimateParticles(
+				unsigned first,
+				unsigned end,
+				const Stuff::LinearMatrix4D *world_to_new_local,
+				Stuff::Time till
+			);
 		void
 			CreateNewParticle(
 				unsigned index,
@@ -264,9 +264,10 @@ void
 
 //------------------------------------------------------------------------------
 //
-bool
-	gosFX::ShapeCloud::AnimateParticle(
-		unsigned index,
+void
+	gosFX::ShapeCloud::AnimateParticles(
+		unsigned first,
+		unsigned end,
 		const Stuff::LinearMatrix4D *world_to_new_local,
 		Stuff::Time till
 	)
@@ -278,26 +279,32 @@ bool
 	// Animate the parent then get our pointers
 	//-----------------------------------------
 	//
-	if (!SpinningCloud::AnimateParticle(index, world_to_new_local, till))
-		return false;
-	Set_Statistic(Shape_Count, Shape_Count+1);
-	Specification *spec = GetSpecification();
-	Check_Object(spec);
-	Particle *particle = GetParticle(index);
-	Check_Object(particle);
-	Stuff::Scalar seed = particle->m_seed;
-	Stuff::Scalar age = particle->m_age;
+	SpinningCloud::AnimateParticles(first, end, world_to_new_local, till);
+	Stuff::Scalar *red = GetLane(FirstScratchLane);
+	Stuff::Scalar *green = GetLane(FirstScratchLane+1);
+	Stuff::Scalar *blue = GetLane(FirstScratchLane+2);
+	Stuff::Scalar *alpha = GetLane(FirstScratchLane+3);
+	ComputeColors(first, end, red, green, blue, alpha);
 
 	//
 	//------------------
 	// Animate the color
 	//------------------
 	//
-	particle->m_color.red = spec->m_pRed.ComputeValue(age, seed);
-	particle->m_color.green = spec->m_pGreen.ComputeValue(age, seed);
-	particle->m_color.blue = spec->m_pBlue.ComputeValue(age, seed);
-	particle->m_color.alpha = spec->m_pAlpha.ComputeValue(age, seed);
-	return true;
+	unsigned live = 0;
+	for (unsigned i=first; i<end; ++i)
+	{
+		if (m_P_age[i] >= 1.0f)
+			continue;
+		++live;
+		Particle *particle = GetParticle(i);
+		Check_Object(particle);
+		particle->m_color.red = red[i];
+		particle->m_color.green = green[i];
+		particle->m_color.blue = blue[i];
+		particle->m_color.alpha = alpha[i];
+	}
+	Set_Statistic(Shape_Count, Shape_Count+live);
 }
 
 //------------------------------------------------------------------------------
@@ -361,12 +368,12 @@ void gosFX::ShapeCloud::Draw(DrawInfo *info)
 					// issue the draw command
 					//-----------------------------------------------------------------
 					//
-					if (particle->m_age < 1.0f)
+					if (m_P_age[i] < 1.0f)
 					{
 						Stuff::Vector3D direction_in_cloud;
 						direction_in_cloud.Subtract(
 							camera_in_cloud,
-							particle->m_localTranslation
+							GetLocalTranslation(i)
 						);
 						Stuff::LinearMatrix4D shape_to_cloud;
 						shape_to_cloud.BuildRotation(particle->m_localRotation);
@@ -376,7 +383,7 @@ void gosFX::ShapeCloud::Draw(DrawInfo *info)
 							Stuff::Y_Axis,
 							Stuff::X_Axis
 						);
-						shape_to_cloud.BuildTranslation(particle->m_localTranslation);
+						shape_to_cloud.BuildTranslation(GetLocalTranslation(i));
 						Stuff::LinearMatrix4D shape_to_world;
 						shape_to_world.Multiply(
 							shape_to_cloud,
@@ -426,12 +433,12 @@ void gosFX::ShapeCloud::Draw(DrawInfo *info)
 					// issue the draw command
 					//-----------------------------------------------------------------
 					//
-					if (particle->m_age < 1.0f)
+					if (m_P_age[i] < 1.0f)
 					{
 						Stuff::Vector3D direction_in_cloud;
 						direction_in_cloud.Subtract(
 							camera_in_cloud,
-							particle->m_localTranslation
+							GetLocalTranslation(i)
 						);
 						Stuff::LinearMatrix4D shape_to_cloud;
 						shape_to_cloud.BuildRotation(particle->m_localRotation);
@@ -441,7 +448,7 @@ void gosFX::ShapeCloud::Draw(DrawInfo *info)
 							Stuff::X_Axis,
 							-1
 						);
-						shape_to_cloud.BuildTranslation(particle->m_localTranslation);
+						shape_to_cloud.BuildTranslation(GetLocalTranslation(i));
 						Stuff::LinearMatrix4D shape_to_world;
 						shape_to_world.Multiply(
 							shape_to_cloud,
@@ -492,12 +499,12 @@ void gosFX::ShapeCloud::Draw(DrawInfo *info)
 				// issue the draw command
 				//-----------------------------------------------------------------
 				//
-				if (particle->m_age < 1.0f)
+				if (m_P_age[i] < 1.0f)
 				{
 					Stuff::Vector3D direction_in_cloud;
 					direction_in_cloud.Subtract(
 						camera_in_cloud,
-						particle->m_localTranslation
+						GetLocalTranslation(i)
 					);
 					Stuff::LinearMatrix4D shape_to_cloud;
 					shape_to_cloud.BuildRotation(particle->m_localRotation);
@@ -507,7 +514,7 @@ void gosFX::ShapeCloud::Draw(DrawInfo *info)
 						Stuff::Y_Axis,
 						-1
 					);
-					shape_to_cloud.BuildTranslation(particle->m_localTranslation);
+					shape_to_cloud.BuildTranslation(GetLocalTranslation(i));
 					Stuff::LinearMatrix4D shape_to_world;
 					shape_to_world.Multiply(
 						shape_to_cloud,
@@ -546,10 +553,10 @@ void gosFX::ShapeCloud::Draw(DrawInfo *info)
 				// issue the draw command
 				//-----------------------------------------------------------------
 				//
-				if (particle->m_age < 1.0f)
+				if (m_P_age[i] < 1.0f)
 				{
 					Stuff::LinearMatrix4D shape_to_cloud;
-					shape_to_cloud.BuildTranslation(particle->m_localTranslation);
+					shape_to_cloud.BuildTranslation(GetLocalTranslation(i));
 					shape_to_cloud.BuildRotation(particle->m_localRotation);
 					Stuff::LinearMatrix4D shape_to_world;
 					shape_to_world.Multiply(
@@ -137,9 +137,10 @@ namespace gosFX
 	// API
 	//
 	protected:
-		bool
-			AnimateParticle(
-				unsigned index,
+		void
+			AnimateParticles(
+				unsigned first,
+				unsigned end,
 				const Stuff::LinearMatrix4D *world_to_new_local,
 				Stuff::Time till
 			);
@@ -215,9 +215,10 @@ gosFX::ShardCloud*
 
 //------------------------------------------------------------------------------
 //
-bool
-	gosFX::ShardCloud::AnimateParticle(
-		unsigned index,
+void
+	gosFX::ShardCloud::AnimateParticles(
+		unsigned first,
+		unsigned end,
 		const Stuff::LinearMatrix4D *world_to_new_local,
 		Stuff::Time till
 	)
@@ -229,15 +230,12 @@ bool
 	// Animate the parent then get our pointers
 	//-----------------------------------------
 	//
-	if (!SpinningCloud::AnimateParticle(index, world_to_new_local, till))
-		return false;
-	Set_Statistic(Shard_Count, Shard_Count+1);
-	Specification *spec = GetSpecification();
-	Check_Object(spec);
-	Particle *particle = GetParticle(index);
-	Check_Object(particle);
-	Stuff::Scalar seed = particle->m_seed;
-	Stuff::Scalar age = particle->m_age;
+	SpinningCloud::AnimateParticles(first, end, world_to_new_local, till);
+	Stuff::Scalar *red = GetLane(FirstScratchLane);
+	Stuff::Scalar *green = GetLane(FirstScratchLane+1);
+	Stuff::Scalar *blue = GetLane(FirstScratchLane+2);
+	Stuff::Scalar *alpha = GetLane(FirstScratchLane+3);
+	ComputeColors(first, end, red, green, blue, alpha);
 
 	//
 	//------------------
@@ -245,13 +243,20 @@ bool
 	//------------------
 	//
 	Check_Pointer(m_P_color);
-	index *= 3;
-	m_P_color[index].red = spec->m_pRed.ComputeValue(age, seed);
-	m_P_color[index].green = spec->m_pGreen.ComputeValue(age, seed);
-	m_P_color[index].blue = spec->m_pBlue.ComputeValue(age, seed);
-	m_P_color[index].alpha = spec->m_pAlpha.ComputeValue(age, seed);
-	m_P_color[index+2] = m_P_color[index+1] = m_P_color[index];
-	return true;
+	unsigned live = 0;
+	for (unsigned i=first; i<end; ++i)
+	{
+		if (m_P_age[i] >= 1.0f)
+			continue;
+		++live;
+		unsigned index = i*3;
+		m_P_color[index].red = red[i];
+		m_P_color[index].green = green[i];
+		m_P_color[index].blue = blue[i];
+		m_P_color[index].alpha = alpha[i];
+		m_P_color[index+2] = m_P_color[index+1] = m_P_color[index];
+	}
+	Set_Statistic(Shard_Count, Shard_Count+live);
 }
 
 //------------------------------------------------------------------------------
@@ -282,9 +287,9 @@ void
 	Check_Object(spec);
 	Particle *particle = GetParticle(index);
 	Check_Object(particle);
-	particle->m_radius = spec->m_size.ComputeValue(m_age, particle->m_seed);
+	particle->m_radius = spec->m_size.ComputeValue(m_age, m_P_seed[index]);
 	particle->m_angle =
-		Stuff::Sin(spec->m_angularity.ComputeValue(m_age, particle->m_seed));
+		Stuff::Sin(spec->m_angularity.ComputeValue(m_age, m_P_seed[index]));
 }
 
 //------------------------------------------------------------------------------
@@ -355,7 +360,7 @@ void gosFX::ShardCloud::Draw(DrawInfo *info)
 				{
 					Particle *particle = GetParticle(i);
 					Check_Object(particle);
-					if (particle->m_age < 1.0f)
+					if (m_P_age[i] < 1.0f)
 					{
 
 						//
@@ -366,7 +371,7 @@ void gosFX::ShardCloud::Draw(DrawInfo *info)
 						Stuff::Vector3D direction_in_cloud;
 						direction_in_cloud.Subtract(
 							camera_in_cloud,
-							particle->m_localTranslation
+							GetLocalTranslation(i)
 						);
 						Stuff::LinearMatrix4D shard_to_cloud;
 						shard_to_cloud.BuildRotation(particle->m_localRotation);
@@ -376,7 +381,7 @@ void gosFX::ShardCloud::Draw(DrawInfo *info)
 							Stuff::Y_Axis,
 							Stuff::X_Axis
 						);
-						shard_to_cloud.BuildTranslation(particle->m_localTranslation);
+						shard_to_cloud.BuildTranslation(GetLocalTranslation(i));
 
 						//
 						//--------------------------------------------------
@@ -443,7 +448,7 @@ void gosFX::ShardCloud::Draw(DrawInfo *info)
 				{
 					Particle *particle = GetParticle(i);
 					Check_Object(particle);
-					if (particle->m_age < 1.0f)
+					if (m_P_age[i] < 1.0f)
 					{
 
 						//
@@ -454,7 +459,7 @@ void gosFX::ShardCloud::Draw(DrawInfo *info)
 						Stuff::Vector3D direction_in_cloud;
 						direction_in_cloud.Subtract(
 							camera_in_cloud,
-							particle->m_localTranslation
+							GetLocalTranslation(i)
 						);
 						Stuff::LinearMatrix4D shard_to_cloud;
 						shard_to_cloud.BuildRotation(particle->m_localRotation);
@@ -464,7 +469,7 @@ void gosFX::ShardCloud::Draw(DrawInfo *info)
 							Stuff::X_Axis,
 							-1
 						);
-						shard_to_cloud.BuildTranslation(particle->m_localTranslation);
+						shard_to_cloud.BuildTranslation(GetLocalTranslation(i));
 
 						//
 						//--------------------------------------------------
@@ -532,7 +537,7 @@ void gosFX::ShardCloud::Draw(DrawInfo *info)
 			{
 				Particle *particle = GetParticle(i);
 				Check_Object(particle);
-				if (particle->m_age < 1.0f)
+				if (m_P_age[i] < 1.0f)
 				{
 
 					//
@@ -543,7 +548,7 @@ void gosFX::ShardCloud::Draw(DrawInfo *info)
 					Stuff::Vector3D direction_in_cloud;
 					direction_in_cloud.Subtract(
 						camera_in_cloud,
-						particle->m_localTranslation
+						GetLocalTranslation(i)
 					);
 					Stuff::LinearMatrix4D shard_to_cloud;
 					shard_to_cloud.BuildRotation(particle->m_localRotation);
@@ -553,7 +558,7 @@ void gosFX::ShardCloud::Draw(DrawInfo *info)
 						Stuff::Y_Axis,
 						-1
 					);
-					shard_to_cloud.BuildTranslation(particle->m_localTranslation);
+					shard_to_cloud.BuildTranslation(GetLocalTranslation(i));
 
 					//
 					//--------------------------------------------------
@@ -603,7 +608,7 @@ void gosFX::ShardCloud::Draw(DrawInfo *info)
 			{
 				Particle *particle = GetParticle(i);
 				Check_Object(particle);
-				if (particle->m_age < 1.0f)
+				if (m_P_age[i] < 1.0f)
 				{
 
 					//
@@ -613,7 +618,7 @@ void gosFX::ShardCloud::Draw(DrawInfo *info)
 					//
 					Stuff::LinearMatrix4D shard_to_cloud;
 					shard_to_cloud.BuildRotation(particle->m_localRotation);
-					shard_to_cloud.BuildTranslation(particle->m_localTranslation);
+					shard_to_cloud.BuildTranslation(GetLocalTranslation(i));
 
 					//
 					//--------------------------------------------------
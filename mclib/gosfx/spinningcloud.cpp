@@ -235,7 +235,8 @@ bool
 		//
 		while (i<m_activeParticleCount)
 		{
-			Particle *particle = GetParticle(i++);
+			unsigned index = i++;
+			Particle *particle = GetParticle(index);
 			Check_Object(particle);
 
 			//
@@ -243,25 +244,26 @@ bool
 			// We have found our first particle, so put the box around it
 			//-----------------------------------------------------------
 			//
-			if (particle->m_age < 1.0f)
+			if (m_P_age[index] < 1.0f)
 			{
+				Stuff::Point3D translation(GetLocalTranslation(index));
 				box.maxX =
-					particle->m_localTranslation.x
+					translation.x
 					 + particle->m_radius*particle->m_scale;
 				box.minX =
-					particle->m_localTranslation.x
+					translation.x
 					 - particle->m_radius*particle->m_scale;
 				box.maxY =
-					particle->m_localTranslation.y
+					translation.y
 					 + particle->m_radius*particle->m_scale;
 				box.minY =
-					particle->m_localTranslation.y
+					translation.y
 					 - particle->m_radius*particle->m_scale;
 				box.maxZ =
-					particle->m_localTranslation.z
+					translation.z
 					 + particle->m_radius*particle->m_scale;
 				box.minZ =
-					particle->m_localTranslation.z
+					translation.z
 					 - particle->m_radius*particle->m_scale;
 				break;
 			}
@@ -274,28 +276,30 @@ bool
 		//
 		while (i<m_activeParticleCount)
 		{
-			Particle *particle = GetParticle(i++);
+			unsigned index = i++;
+			Particle *particle = GetParticle(index);
 			Check_Object(particle);
-			if (particle->m_age < 1.0f)
+			if (m_P_age[index] < 1.0f)
 			{
+				Stuff::Point3D translation(GetLocalTranslation(index));
 				Stuff::ExtentBox local_box;
 				local_box.minX =
-					particle->m_localTranslation.x
+					translation.x
 					 - particle->m_radius*particle->m_scale;
 				local_box.maxX =
-					particle->m_localTranslation.x
+					translation.x
 					 + particle->m_radius*particle->m_scale;
 				local_box.minY =
-					particle->m_localTranslation.y
+					translation.y
 					 - particle->m_radius*particle->m_scale;
 				local_box.maxY =
-					particle->m_localTranslation.y
+					translation.y
 					 + particle->m_radius*particle->m_scale;
 				local_box.minZ =
-					particle->m_localTranslation.z
+					translation.z
 					 - particle->m_radius*particle->m_scale;
 				local_box.maxZ =
-					particle->m_localTranslation.z
+					translation.z
 					 + particle->m_radius*particle->m_scale;
 				box.Union(box, local_box);
 			}
@@ -356,9 +360,8 @@ void
 	Check_Object(spec);
 	Particle *particle = GetParticle(index);
 	Check_Object(particle);
-	Stuff::Scalar seed = particle->m_seed;
+	Stuff::Scalar seed = m_P_seed[index];
 	Stuff::Scalar age = m_age;
-	particle->m_localTranslation = *translation;
 
 	//
 	//---------------------------------
@@ -378,7 +381,7 @@ void
 	{
 		Stuff::LinearMatrix4D basis(true);
 		basis.AlignLocalAxisToWorldVector(
-			particle->m_localLinearVelocity,
+			GetLocalLinearVelocity(index),
 			Stuff::Y_Axis,
 			Stuff::X_Axis,
 			Stuff::Z_Axis
@@ -410,164 +413,97 @@ bool
 {
 	Check_Object(this);
 
+	AnimateParticles(index, index+1, world_to_new_local, till);
+	return IsParticleAlive(index);
+}
+
+//------------------------------------------------------------------------------
+//
+void
+	gosFX::SpinningCloud::AnimateParticles(
+		unsigned first,
+		unsigned end,
+		const Stuff::LinearMatrix4D *world_to_new_local,
+		Stuff::Time till
+	)
+{
+	Check_Object(this);
+
 	//
-	//-----------------------------------------------------------------------
-	// If this cloud is unparented, we need to transform the point from local
-	// space into world space and set the internal position/velocity pointers
-	// to these temporary values
-	//-----------------------------------------------------------------------
+	//----------------------------------------------------------------
+	// Move all the particles at once, if none of them are alive we are
+	// done
+	//----------------------------------------------------------------
 	//
-	Particle *particle = GetParticle(index);
-	Check_Object(particle);
-	Stuff::Scalar age = particle->m_age;
-	if (age >= 1.0f)
-		return false;
-	Stuff::Point3D *translation = &particle->m_localTranslation;
-	Stuff::UnitQuaternion *rotation = &particle->m_localRotation;
-	Stuff::Vector3D *velocity = &particle->m_localLinearVelocity;
-	int sim_mode = GetSimulationMode();
-	if (sim_mode == DynamicWorldSpaceSimulationMode)
-	{
-		particle->m_worldTranslation.Multiply(*translation, m_localToWorld);
-		Stuff::LinearMatrix4D local_rot(*rotation);
-		Stuff::LinearMatrix4D world_rot;
-		world_rot.Multiply(local_rot, m_localToWorld);
-		particle->m_worldRotation = world_rot;
-		particle->m_worldLinearVelocity.Multiply(*velocity, m_localToWorld);
-		translation = &particle->m_worldTranslation;
-		rotation = &particle->m_worldRotation;
-		velocity = &particle->m_worldLinearVelocity;
-	}
-	Check_Object(translation);
-	Check_Object(rotation);
-	Check_Object(velocity);
+	if (!AnimateLinearMotion(first, end, world_to_new_local, till))
+		return;
 
 	//
-	//------------------------------------------------------------------
-	// First, calculate the drag on the particle.  Drag can never assist
-	// velocity
-	//------------------------------------------------------------------
+	//-----------------------
+	// Deal with the rotation
+	//-----------------------
 	//
-	Stuff::Scalar seed = particle->m_seed;
 	Specification *spec = GetSpecification();
 	Check_Object(spec);
-	Stuff::Scalar drag = -spec->m_pDrag.ComputeValue(age, seed);
-	Max_Clamp(drag, 0.0f);
-	Stuff::Vector3D ether;
-	ether.x = spec->m_pEtherVelocityX.ComputeValue(age, seed);
-	ether.y = spec->m_pEtherVelocityY.ComputeValue(age, seed);
-	ether.z = spec->m_pEtherVelocityZ.ComputeValue(age, seed);
-	Stuff::Vector3D accel(Stuff::Vector3D::Identity);
-
-	//
-	//-------------------------------------------------------------------
-	// Deal with pseudo-world simulation.  In this mode, we interpret the
-	// forces as if they are already in worldspace, and we transform them
-	// back to local space
-	//-------------------------------------------------------------------
-	//
-	if (sim_mode == StaticWorldSpaceSimulationMode)
+	int sim_mode = GetSimulationMode();
+	Stuff::Scalar time_slice =
+		static_cast<Stuff::Scalar>(till - m_lastRan);
+	unsigned i;
+	for (i=first; i<end; ++i)
 	{
-		Stuff::LinearMatrix4D world_to_effect;
-		world_to_effect.Invert(m_localToWorld);
-		Stuff::Vector3D local_ether;
-		local_ether.MultiplyByInverse(ether, world_to_effect);
-		Stuff::Vector3D rel_vel;
-		rel_vel.Subtract(*velocity, local_ether);
-		accel.Multiply(rel_vel, drag);
+		if (m_P_age[i] >= 1.0f)
+			continue;
+		Particle *particle = GetParticle(i);
+		Check_Object(particle);
 
 		//
-		//-----------------------------------------
-		// Now, add in acceleration of the particle
-		//-----------------------------------------
+		//------------------------------------------------------------
+		// If we are aligning Y using velocity, the new local velocity
+		// gives us the rotation
+		//------------------------------------------------------------
 		//
-		Stuff::Vector3D world_accel;
-		world_accel.x = spec->m_pAccelerationX.ComputeValue(age, seed);
-		world_accel.y = spec->m_pAccelerationY.ComputeValue(age, seed);
-		world_accel.z = spec->m_pAccelerationZ.ComputeValue(age, seed);
-		Stuff::Vector3D local_accel;
-		local_accel.Multiply(world_accel, world_to_effect);
-		accel += local_accel;
-	}
-
-	//
-	//----------------------------------------------------------------------
-	// Otherwise, just add the forces in the same space the particles are in
-	//----------------------------------------------------------------------
-	//
-	else
-	{
-		Stuff::Vector3D rel_vel;
-		rel_vel.Subtract(*velocity, ether);
-		accel.Multiply(rel_vel, drag);
+		if (spec->m_alignYUsingVelocity)
+		{
+			Stuff::LinearMatrix4D basis(true);
+			basis.AlignLocalAxisToWorldVector(
+				GetLocalLinearVelocity(i),
+				Stuff::Y_Axis,
+				Stuff::X_Axis,
+				Stuff::Z_Axis
+			);
+			particle->m_localRotation = basis;
+			continue;
+		}
 
 		//
-		//-----------------------------------------
-		// Now, add in acceleration of the particle
-		//-----------------------------------------
+		//-----------------------------------------------------------------
+		// Otherwise spin the particle, in world space if we are unparented
+		//-----------------------------------------------------------------
 		//
-		accel.x += spec->m_pAccelerationX.ComputeValue(age, seed);
-		accel.y += spec->m_pAccelerationY.ComputeValue(age, seed);
-		accel.z += spec->m_pAccelerationZ.ComputeValue(age, seed);
-	}
-
-	//
-	//-------------------------------------------------
-	// Compute the particle's new velocity and position
-	//-------------------------------------------------
-	//
-	Stuff::Scalar time_slice =
-		static_cast<Stuff::Scalar>(till - m_lastRan);
-	velocity->AddScaled(*velocity, accel, time_slice);
-	translation->AddScaled(*translation, *velocity, time_slice);
-
-	//
-	//-----------------------
-	// Deal with the rotation
-	//-----------------------
-	//
-	if (!spec->m_alignYUsingVelocity)
-	{
 		Stuff::Vector3D omega(particle->m_angularVelocity);
 		omega *= time_slice;
 		Stuff::UnitQuaternion omega_q;
 		omega_q = omega;
-		rotation->Multiply(omega_q, Stuff::UnitQuaternion(*rotation));
-		rotation->Normalize();
-	}
-
-	//
-	//---------------------------------------------------------------------
-	// If we are unparented, we need to transform the velocity and position
-	// data back into the NEW local space
-	//---------------------------------------------------------------------
-	//
-	if (sim_mode == DynamicWorldSpaceSimulationMode)
-	{
-		Check_Object(world_to_new_local);
-		particle->m_localLinearVelocity.Multiply(*velocity, *world_to_new_local);
-		particle->m_localTranslation.Multiply(*translation, *world_to_new_local);
-		Stuff::LinearMatrix4D world_rot(*rotation);
-		Stuff::LinearMatrix4D local_rot;
-		local_rot.Multiply(world_rot, *world_to_new_local);
-		particle->m_localRotation = local_rot;
-	}
-
-	//
-	//------------------------------------------------------------
-	// If we are aligning Y using velocity, do the calculation now
-	//------------------------------------------------------------
-	//
-	if (spec->m_alignYUsingVelocity)
-	{
-		Stuff::LinearMatrix4D basis(true);
-		basis.AlignLocalAxisToWorldVector(
-			particle->m_localLinearVelocity,
-			Stuff::Y_Axis,
-			Stuff::X_Axis,
-			Stuff::Z_Axis
-		);
-		particle->m_localRotation = basis;
+		if (sim_mode == DynamicWorldSpaceSimulationMode)
+		{
+			Check_Object(world_to_new_local);
+			Stuff::LinearMatrix4D local_rot(particle->m_localRotation);
+			Stuff::LinearMatrix4D world_rot;
+			world_rot.Multiply(local_rot, m_localToWorld);
+			Stuff::UnitQuaternion rotation;
+			rotation = world_rot;
+			rotation.Multiply(omega_q, Stuff::UnitQuaternion(rotation));
+			rotation.Normalize();
+			world_rot = rotation;
+			local_rot.Multiply(world_rot, *world_to_new_local);
+			particle->m_localRotation = local_rot;
+		}
+		else
+		{
+			Stuff::UnitQuaternion *rotation = &particle->m_localRotation;
+			rotation->Multiply(omega_q, Stuff::UnitQuaternion(*rotation));
+			rotation->Normalize();
+		}
 	}
 
 	//
@@ -575,8 +511,13 @@ bool
 	// Animate the scale
 	//------------------
 	//
-	particle->m_scale = spec->m_pScale.ComputeValue(age, seed);
-	return true;
+	Stuff::Scalar *scale = GetLane(FirstScratchLane);
+	spec->m_pScale.ComputeValues(m_P_age, m_P_seed, scale, first, end);
+	for (i=first; i<end; ++i)
+	{
+		if (m_P_age[i] < 1.0f)
+			GetParticle(i)->m_scale = scale[i];
+	}
 }
 
 //------------------------------------------------------------------------------
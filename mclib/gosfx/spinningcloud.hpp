@@ -74,12 +74,8 @@ namespace gosFX
 	public:
 		Stuff::Vector3D
 			m_angularVelocity;
-		Stuff::Point3D
-			m_localTranslation,
-			m_worldTranslation;
 		Stuff::UnitQuaternion
-			m_localRotation,
-			m_worldRotation;
+			m_localRotation;
 		Stuff::Scalar
 			m_radius,
 			m_scale;
@@ -152,6 +148,13 @@ namespace gosFX
 				const Stuff::LinearMatrix4D *world_to_new_local,
 				Stuff::Time till
 			);
+		void
+			AnimateParticles(
+				unsigned first,
+				unsigned end,
+				const Stuff::LinearMatrix4D *world_to_new_local,
+				Stuff::Time till
+			);
 		void
 			CreateNewParticle(
 				unsigned index,
@@ -19,6 +19,10 @@
 #include"heap.h"
 #endif
 
+#ifndef DATACACHE_H
+#include"datacache.h"
+#endif
+
 #include<stdio.h>
 #include<stdlib.h>
 #include<math.h>
@@ -55,6 +59,18 @@ FitIniFile::FitIniFile (void) : File()
 	currentBlockId = NULL;
 	currentBlockOffset = 0;
 	currentBlockSize = 0;
+	currentBlockNum = -1;
+
+	totalEntries = 0;
+	fileEntries = NULL;
+	blockBuckets = NULL;
+	blockBucketMask = 0;
+	entryBuckets = NULL;
+	entryBucketMask = 0;
+	fileKeys = NULL;
+	totalKeyBytes = 0;
+
+	cacheFile = NULL;
 }
 
 //---------------------------------------------------------------------------
@@ -64,50 +80,425 @@ FitIniFile::~FitIniFile (void)
 }
 
 //---------------------------------------------------------------------------
-long FitIniFile::findNextBlockStart (char *line, unsigned long lineLen)
+DWORD FitIniFile::hashId (unsigned long blockNum, const char *typeId, const char *name, unsigned long nameLen)
 {
-	char thisLine[255];
-	char *common = NULL;
-	
-	do
+	//-----------------------------------------------
+	// FNV-1a.  Case insensitive, like the S_strnicmp
+	// the old line by line search used.
+	DWORD hash = 2166136261u;
+	for (unsigned long i=0;i<sizeof(blockNum);i++)
+	{
+		hash ^= (blockNum >> (i * 8)) & 0xff;
+		hash *= 16777619u;
+	}
+
+	for (const char *c = typeId;*c;c++)
+	{
+		hash ^= (DWORD)tolower(*c);
+		hash *= 16777619u;
+	}
+
+	hash ^= ' ';
+	hash *= 16777619u;
+
+	for (unsigned long i=0;i<nameLen && name[i];i++)
+	{
+		hash ^= (DWORD)tolower(name[i]);
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+//---------------------------------------------------------------------------
+long FitIniFile::indexLines (bool fillIn)
+{
+	//---------------------------------------------------------------
+	// Reads the whole file once.  With fillIn false, just counts the
+	// blocks and entries so we know how much RAM to get.
+	char line[2048];
+	unsigned long blockNum = 0;
+	unsigned long entryNum = 0;
+	unsigned long keyBytes = 0;
+
+	while (!eof())
 	{
-		if (line)
+		unsigned long lineOffset = logicalPosition;
+		readLine((MemoryPtr)line,2047);
+
+		if (line[0] == '[')
+		{
+			//--------------------------------------------
+			// Block on the very last line has no data.
+			if (eof())
+				break;
+
+			if (fillIn)
+			{
+				//----------------------------------------------------
+				// If we write too many fileBlocks, we will trash RAM
+				// Shouldn't be able to happen but...
+				if (blockNum == totalBlocks)
+					return(TOO_MANY_BLOCKS);
+
+				long count = 1;
+				while (line[count] != ']' && line[count] != '\n' && line[count] != '\0' && count < 50)
+				{
+					fileBlocks[blockNum].blockId[count-1] = line[count];
+					count++;
+				}
+				if (count >= 49)
+					STOP(("BlockId To large in Fit File %s",fileName));
+
+				if (line[count] != ']')
+				{
+					char error[256];
+					sprintf( error, "couldn't resolve block %s in file %s", line, getFilename() );
+					Assert( 0, 0, error );
+					return SYNTAX_ERROR;
+				}
+
+				fileBlocks[blockNum].blockId[count-1] = '\0';
+
+				//----------------------------------------------------------------------
+				// Since we just read all of last line, we now point to start of data
+				fileBlocks[blockNum].blockOffset = logicalPosition;
+			}
+
+			blockNum++;
+			continue;
+		}
+
+		//---------------------------------------------------------
+		// Anything before the first block, comments, blank lines
+		// and continuation lines are not entries.
+		if (!blockNum || (line[0] == '\0') || (line[0] == '/') || isspace(line[0]))
+			continue;
+
+		//---------------------------------------------------------
+		// "type name = value" or "type[count] name = value".
+		char *typeEnd = line;
+		while (*typeEnd && (*typeEnd != ' ') && (*typeEnd != '[') && (*typeEnd != '\t') && (*typeEnd != '='))
+			typeEnd++;
+
+		unsigned long typeLen = typeEnd - line;
+		if (!typeLen || (typeLen > 3))
+			continue;
+
+		char *name = NULL;
+		if (*typeEnd == ' ')
 		{
-			readLine((MemoryPtr)line,lineLen);
-			common = line;
+			name = typeEnd + 1;
 		}
-		else
+		else if (*typeEnd == '[')
+		{
+			typeLen++;
+			char *close = strchr(typeEnd,']');
+			if (close && (close[1] == ' '))
+				name = close + 2;
+		}
+
+		if (!name)
+			continue;
+
+		char *nameEnd = name;
+		while (*nameEnd && !isspace(*nameEnd) && (*nameEnd != '='))
+			nameEnd++;
+
+		if (nameEnd == name)
+			continue;
+
+		char typeId[5];
+		strncpy(typeId,line,typeLen);
+		typeId[typeLen] = '\0';
+
+		//---------------------------------------------------------------
+		// The scalar reads match "type name" followed by '=', and only
+		// ever see the first 254 characters of the line.
+		unsigned char scalar = INI_ENTRY_NOT_SCALAR;
+		unsigned long keyLength = 0;
+		if (*typeEnd == ' ')
+		{
+			char *equalSign = nameEnd;
+			while (isspace(*equalSign))
+				equalSign++;
+
+			if (*equalSign == '=')
+			{
+				scalar = (strlen(line) < 250) ? INI_ENTRY_SCALAR : INI_ENTRY_READ_LINE;
+				keyLength = nameEnd - line;
+			}
+		}
+
+		IniEntryNode values;
+		if (fillIn && (scalar == INI_ENTRY_SCALAR))
+		{
+			for (unsigned long i=0;i<keyLength;i++)
+				fileKeys[keyBytes + i] = tolower((unsigned char)line[i]);
+
+			//------------------------------------------------------
+			// Same conversions the readId* calls make.  textToLong
+			// may cut the line short, so it goes last.
+			char *value = strstr(line,"=") + 1;
+			values.boolValue = booleanToLong(value);
+			values.floatValue = textToDouble(value);
+			values.longValue = textToLong(value);
+		}
+
+		//---------------------------------------------------------------
+		// The array search always used strstr, so "l[" also found "ul["
+		// arrays and so on.  Index those under both so nothing changes.
+		long numKeys = ((typeId[0] == 'u') && (typeLen == 3)) ? 2 : 1;
+		for (long key=0;key<numKeys;key++)
 		{
-			readLine((MemoryPtr)thisLine,254);
-			common = thisLine;
+			if (fillIn)
+			{
+				IniEntryNode &entry = fileEntries[entryNum];
+				entry.hash = hashId(blockNum-1,typeId+key,name,nameEnd-name);
+				entry.blockNum = blockNum-1;
+				entry.lineOffset = lineOffset;
+				entry.lineEnd = logicalPosition;
+				entry.nextEntry = -1;
+
+				//-------------------------------------------------------
+				// Only the full type can match a scalar read.
+				entry.scalar = key ? INI_ENTRY_NOT_SCALAR : scalar;
+				entry.keyOffset = keyBytes;
+				entry.keyLength = 0;
+				entry.floatValue = 0.0;
+				entry.longValue = 0;
+				entry.boolValue = false;
+				if (entry.scalar == INI_ENTRY_SCALAR)
+				{
+					entry.keyLength = keyLength;
+					entry.floatValue = values.floatValue;
+					entry.longValue = values.longValue;
+					entry.boolValue = values.boolValue;
+				}
+			}
+
+			entryNum++;
 		}
+
+		if (scalar == INI_ENTRY_SCALAR)
+			keyBytes += keyLength;
 	}
-	while(!eof() && (common[0] != '['));
-	
-	if (eof())
+
+	if (!fillIn)
+	{
+		totalBlocks = blockNum;
+		totalEntries = entryNum;
+		totalKeyBytes = keyBytes;
+	}
+	else if (blockNum != totalBlocks)
 	{
-		return(NO_MORE_BLOCKS);
+		//------------------------------------------------------
+		// If we didn't read in enough, CD-ROM error?
+		return(NOT_ENOUGH_BLOCKS);
 	}
 
 	return(NO_ERR);
-}	
+}
 
 //---------------------------------------------------------------------------
-long FitIniFile::countBlocks (void)
+void FitIniFile::buildIndex (void)
 {
-	long count = 0;
-	long oldPosition = logicalPosition;
-	
-	while (findNextBlockStart() != NO_MORE_BLOCKS)
+	//---------------------------------------------------------------
+	// Tables are at least twice as big as what goes in them.  Chains
+	// are built back to front so the first one in the file wins, just
+	// like the old linear searches.
+	blockBucketMask = 15;
+	while (blockBucketMask < totalBlocks * 2)
+		blockBucketMask = (blockBucketMask << 1) | 1;
+
+	blockBuckets = (long *)systemHeap->Malloc(sizeof(long) * (blockBucketMask + 1));
+	gosASSERT(blockBuckets != NULL);
+	memset(blockBuckets,0xff,sizeof(long) * (blockBucketMask + 1));
+
+	for (long i=totalBlocks-1;i>=0;i--)
 	{
-		count++;
+		DWORD bucket = hashId(0,"",fileBlocks[i].blockId,strlen(fileBlocks[i].blockId)) & blockBucketMask;
+		fileBlocks[i].nextBlock = blockBuckets[bucket];
+		blockBuckets[bucket] = i;
 	}
-	
-	//----------------------------------
-	// Move back to where we were.
-	seek(oldPosition);
-	
-	return(count);
+
+	entryBucketMask = 15;
+	while (entryBucketMask < totalEntries * 2)
+		entryBucketMask = (entryBucketMask << 1) | 1;
+
+	entryBuckets = (long *)systemHeap->Malloc(sizeof(long) * (entryBucketMask + 1));
+	gosASSERT(entryBuckets != NULL);
+	memset(entryBuckets,0xff,sizeof(long) * (entryBucketMask + 1));
+
+	for (long i=totalEntries-1;i>=0;i--)
+	{
+		DWORD bucket = fileEntries[i].hash & entryBucketMask;
+		fileEntries[i].nextEntry = entryBuckets[bucket];
+		entryBuckets[bucket] = i;
+	}
+}
+
+//---------------------------------------------------------------------------
+long FitIniFile::loadCache (const char *cacheName, DWORD sourceSize, DWORD sourceStamp)
+{
+	cacheFile = new DataCacheFile;
+	gosASSERT(cacheFile != NULL);
+
+	long result = cacheFile->openCache(cacheName,DATA_CACHE_FITINI,sourceSize,sourceStamp);
+	if (result == NO_ERR)
+	{
+		//----------------------------------------------------------
+		// Point the tables straight into the cache.  Nothing in them
+		// is written after buildIndex so they can stay read only.
+		DWORD numBlocks = 0, numEntries = 0, numBlockBuckets = 0, numEntryBuckets = 0, numKeyBytes = 0;
+		fileBlocks = (IniBlockNode *)cacheFile->getSection(0,sizeof(IniBlockNode),numBlocks);
+		fileEntries = (IniEntryNode *)cacheFile->getSection(1,sizeof(IniEntryNode),numEntries);
+		blockBuckets = (long *)cacheFile->getSection(2,sizeof(long),numBlockBuckets);
+		entryBuckets = (long *)cacheFile->getSection(3,sizeof(long),numEntryBuckets);
+		fileKeys = (char *)cacheFile->getSection(4,sizeof(char),numKeyBytes);
+
+		bool keysFit = true;
+		for (DWORD i=0;fileEntries && (i<numEntries);i++)
+		{
+			if ((fileEntries[i].keyOffset > numKeyBytes) || (fileEntries[i].keyLength > (numKeyBytes - fileEntries[i].keyOffset)))
+				keysFit = false;
+		}
+
+		if (fileBlocks && fileEntries && blockBuckets && entryBuckets && fileKeys && keysFit &&
+			numBlockBuckets && ((numBlockBuckets & (numBlockBuckets - 1)) == 0) &&
+			numEntryBuckets && ((numEntryBuckets & (numEntryBuckets - 1)) == 0))
+		{
+			totalBlocks = numBlocks;
+			totalEntries = numEntries;
+			totalKeyBytes = numKeyBytes;
+			blockBucketMask = numBlockBuckets - 1;
+			entryBucketMask = numEntryBuckets - 1;
+			return(NO_ERR);
+		}
+
+		result = DATA_CACHE_BAD_SECTION;
+	}
+
+	fileBlocks = NULL;
+	fileEntries = NULL;
+	blockBuckets = NULL;
+	entryBuckets = NULL;
+	fileKeys = NULL;
+
+	delete cacheFile;
+	cacheFile = NULL;
+
+	return(result);
+}
+
+//---------------------------------------------------------------------------
+void FitIniFile::saveCache (const char *cacheName, DWORD sourceSize, DWORD sourceStamp)
+{
+	MemoryPtr data[5] = {(MemoryPtr)fileBlocks, (MemoryPtr)fileEntries, (MemoryPtr)blockBuckets, (MemoryPtr)entryBuckets, (MemoryPtr)fileKeys};
+	DWORD recordSize[5] = {sizeof(IniBlockNode), sizeof(IniEntryNode), sizeof(long), sizeof(long), sizeof(char)};
+	DWORD count[5] = {(DWORD)totalBlocks, (DWORD)totalEntries, (DWORD)(blockBucketMask + 1), (DWORD)(entryBucketMask + 1), (DWORD)totalKeyBytes};
+
+	//--------------------------------------------------------------
+	// Not being able to write the cache (read only install, etc.) is
+	// fine.  We just parse the text again next time.
+	DataCacheFile::writeCache(cacheName,DATA_CACHE_FITINI,sourceSize,sourceStamp,NULL,5,data,recordSize,count);
+}
+
+//---------------------------------------------------------------------------
+long FitIniFile::findId (const char *typeId, const char *varName, char *line, unsigned long lineLen)
+{
+	if ((currentBlockNum == -1) || !entryBuckets)
+		return(VARIABLE_NOT_FOUND);
+
+	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
+	DWORD hash = hashId(currentBlockNum,typeId,varName,strlen(varName));
+
+	//------------------------------------------------------------
+	// Same tests the line by line search did, just on fewer lines.
+	char searchString[255];
+	bool isArray = (typeId[strlen(typeId)-1] == '[');
+	if (isArray)
+		sprintf(searchString,"] %s",varName);
+	else
+		sprintf(searchString,"%s %s",typeId,varName);
+
+	unsigned long searchLen = strlen(searchString);
+
+	for (long i=entryBuckets[hash & entryBucketMask];i != -1;i=fileEntries[i].nextEntry)
+	{
+		if ((fileEntries[i].hash != hash) || (fileEntries[i].blockNum != (unsigned long)currentBlockNum) ||
+			(fileEntries[i].lineEnd >= endOfBlock))
+		{
+			continue;
+		}
+
+		seek(fileEntries[i].lineOffset);
+		readLine((MemoryPtr)line,lineLen);
+
+		if (isArray)
+		{
+			if (strstr(line,typeId) && strstr(line,searchString))
+				return(NO_ERR);
+		}
+		else if (S_strnicmp(line,searchString,searchLen) == 0)
+		{
+			char* tc = &line[searchLen];
+			while (isspace(*tc))
+				tc++;
+			if (*tc == '=')
+				return(NO_ERR);
+		}
+	}
+
+	return(VARIABLE_NOT_FOUND);
+}
+
+//---------------------------------------------------------------------------
+long FitIniFile::findValue (const char *typeId, const char *varName)
+{
+	//---------------------------------------------------------------
+	// Walks the same chain findId does, comparing the stored keys
+	// instead of reading lines.  Gives up on the first line it can't
+	// tell that way and leaves it to findId.
+	if ((currentBlockNum == -1) || !entryBuckets)
+		return(INI_VALUE_NOT_FOUND);
+
+	char key[255];
+	unsigned long typeLen = strlen(typeId);
+	unsigned long nameLen = strlen(varName);
+	if (((typeLen + nameLen + 1) > sizeof(key)) || strpbrk(varName," \t="))
+		return(INI_VALUE_READ_LINE);
+
+	unsigned long keyLength = 0;
+	for (unsigned long i=0;i<typeLen;i++)
+		key[keyLength++] = tolower((unsigned char)typeId[i]);
+	key[keyLength++] = ' ';
+	for (unsigned long i=0;i<nameLen;i++)
+		key[keyLength++] = tolower((unsigned char)varName[i]);
+
+	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
+	DWORD hash = hashId(currentBlockNum,typeId,varName,nameLen);
+
+	for (long i=entryBuckets[hash & entryBucketMask];i != -1;i=fileEntries[i].nextEntry)
+	{
+		IniEntryNode &entry = fileEntries[i];
+		if ((entry.hash != hash) || (entry.blockNum != (unsigned long)currentBlockNum) ||
+			(entry.lineEnd >= endOfBlock))
+		{
+			continue;
+		}
+
+		if (entry.scalar == INI_ENTRY_READ_LINE)
+			return(INI_VALUE_READ_LINE);
+
+		if ((entry.scalar == INI_ENTRY_SCALAR) && (entry.keyLength == keyLength) &&
+			(memcmp(fileKeys + entry.keyOffset,key,keyLength) == 0))
+		{
+			return(i);
+		}
+	}
+
+	return(INI_VALUE_NOT_FOUND);
 }
 
 //---------------------------------------------------------------------------
@@ -184,10 +575,24 @@ long FitIniFile::afterOpen (void)
 		if (strstr(chkHeader,fitIniHeader) == NULL)
 			return(NOT_A_FITINIFILE);
 
-				//------------------------------------------------------
-		// Find out how many blocks we have	
-		totalBlocks = countBlocks();
-		
+		//------------------------------------------------------
+		// If there is an up to date data cache for this file,
+		// take the block and line index from it and we're done.
+		char cacheName[1024];
+		DWORD sourceSize = 0, sourceStamp = 0;
+		bool useCache = DataCacheFile::makeCacheName(this,cacheName,1023) &&
+						(DataCacheFile::stampSource(this,sourceSize,sourceStamp) == NO_ERR);
+
+		if (useCache && (loadCache(cacheName,sourceSize,sourceStamp) == NO_ERR))
+			return(NO_ERR);
+
+		//------------------------------------------------------
+		// Find out how many blocks and entries we have
+		unsigned long dataStart = logicalPosition;
+		long result = indexLines(false);
+		if (result != NO_ERR)
+			return(result);
+
 		//--------------------------------------------------------------------------
 		// Allocate RAM for the BlockInfoNodes.  Check if system Heap is available
 		fileBlocks = (IniBlockNode *)systemHeap->Malloc(sizeof(IniBlockNode) * totalBlocks);
@@ -195,48 +600,27 @@ long FitIniFile::afterOpen (void)
 		gosASSERT(fileBlocks != NULL);
 
 		memset(fileBlocks,0,sizeof(IniBlockNode) * totalBlocks);
+
+		if (totalEntries)
+		{
+			fileEntries = (IniEntryNode *)systemHeap->Malloc(sizeof(IniEntryNode) * totalEntries);
+			gosASSERT(fileEntries != NULL);
+		}
+
+		fileKeys = (char *)systemHeap->Malloc(totalKeyBytes + 1);
+		gosASSERT(fileKeys != NULL);
 		
 		//--------------------------------------------------------------------------
-		// Put Info into fileBlocks.
-		
-		unsigned long currentBlockNum = 0;
-		while (findNextBlockStart(line,254) != NO_MORE_BLOCKS)
-		{
-			//----------------------------------------------------
-			// If we write too many fileBlocks, we will trash RAM
-			// Shouldn't be able to happen but...
-			if (currentBlockNum == totalBlocks)
-				return(TOO_MANY_BLOCKS);
-
-			long count = 1;
-			while (line[count] != ']' && line[count] != '\n')
-			{
-				fileBlocks[currentBlockNum].blockId[count-1] = line[count];
-				count++;
-			}
-			if (count >= 49)
-				STOP(("BlockId To large in Fit File %s",fileName));
+		// Put Info into fileBlocks and fileEntries.
+		seek(dataStart);
+		result = indexLines(true);
+		if (result != NO_ERR)
+			return(result);
 
-			if (line[count] == '\n')
-			{
-				char error[256];
-				sprintf( error, "couldn't resolve block %s in file %s", line, getFilename() );
-				Assert( 0, 0, error );
-				return SYNTAX_ERROR;
-			}
-			
-			fileBlocks[currentBlockNum].blockId[count-1] = '\0';
-			
-			//----------------------------------------------------------------------
-			// Since we just read all of last line, we now point to start of data
-			fileBlocks[currentBlockNum].blockOffset = logicalPosition;
-			currentBlockNum++;
-		}
+		buildIndex();
 
-		//------------------------------------------------------
-		// If we didn't read in enough, CD-ROM error?
-		if (currentBlockNum != totalBlocks)
-			return(NOT_ENOUGH_BLOCKS);
+		if (useCache && DataCacheFile::writeDataCache)
+			saveCache(cacheName,sourceSize,sourceStamp);
 	}
 
 	return(NO_ERR);
@@ -257,8 +641,30 @@ void FitIniFile::atClose (void)
 
 	//-----------------------------
 	// Free up the fileBlocks
-	systemHeap->Free(fileBlocks);
+	if (cacheFile)
+	{
+		//-------------------------------------------
+		// Tables belong to the cache, not the heap.
+		delete cacheFile;
+		cacheFile = NULL;
+	}
+	else
+	{
+		systemHeap->Free(fileBlocks);
+		systemHeap->Free(fileEntries);
+		systemHeap->Free(blockBuckets);
+		systemHeap->Free(entryBuckets);
+		systemHeap->Free(fileKeys);
+	}
+
 	fileBlocks = NULL;
+	fileEntries = NULL;
+	blockBuckets = NULL;
+	entryBuckets = NULL;
+	fileKeys = NULL;
+
+	totalBlocks = totalEntries = totalKeyBytes = 0;
+	currentBlockNum = -1;
 }
 
 //---------------------------------------------------------------------------
@@ -818,14 +1224,16 @@ void FitIniFile::close (void)
 //---------------------------------------------------------------------------
 long FitIniFile::seekBlock (const char *blockId)
 {
-	unsigned long blockNum = 0;
-	
-	while ((blockNum < totalBlocks) && (strcmp(fileBlocks[blockNum].blockId,blockId) != 0))
+	if (!blockBuckets)
+		return(BLOCK_NOT_FOUND);
+
+	long blockNum = blockBuckets[hashId(0,"",blockId,strlen(blockId)) & blockBucketMask];
+	while ((blockNum != -1) && (strcmp(fileBlocks[blockNum].blockId,blockId) != 0))
 	{
-		blockNum++;
+		blockNum = fileBlocks[blockNum].nextBlock;
 	}
 	
-	if (blockNum == totalBlocks)
+	if (blockNum == -1)
 	{
 		return(BLOCK_NOT_FOUND);
 	}
@@ -838,9 +1246,10 @@ long FitIniFile::seekBlock (const char *blockId)
 	// Setup all current Block Info
 	currentBlockId = fileBlocks[blockNum].blockId;
 	currentBlockOffset = fileBlocks[blockNum].blockOffset;
+	currentBlockNum = blockNum;
 	
 	blockNum++;
-	if (blockNum == totalBlocks)
+	if (blockNum == (long)totalBlocks)
 	{
 		currentBlockSize = getLength() - currentBlockOffset;
 	}
@@ -855,37 +1264,23 @@ long FitIniFile::seekBlock (const char *blockId)
 //---------------------------------------------------------------------------
 long FitIniFile::readIdFloat (const char *varName, float &value)
 {
-	char line[255];
-	char searchString[255];
-	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------
-	// Put prefix on varName.
-	sprintf(searchString,"f %s",varName);
-	
-	//--------------------------------
-	// Search line by line for varName
-	int	testy;
-	do
+	long entry = findValue("f",varName);
+	if (entry >= 0)
 	{
-		readLine((MemoryPtr)line,254);
-		testy = S_strnicmp(line, searchString, strlen(searchString));
-		if (testy == 0)
-		{
-		char* tc = &line[strlen(searchString)];
-			while (isspace(*tc))
-				tc++;
-			if (*tc != '=')
-				testy = 1;
-		}
+		value = (float)fileEntries[entry].floatValue;
+		return(NO_ERR);
+	}
+	else if (entry == INI_VALUE_NOT_FOUND)
+	{
+		value = 0.0;
+		return(VARIABLE_NOT_FOUND);
 	}
-	while((testy != 0) && (logicalPosition < endOfBlock));
+
+	char line[255];
 	
-	if (logicalPosition >= endOfBlock)
+	//--------------------------------
+	// Look varName up in the block index.
+	if (findId("f",varName,line,254) != NO_ERR)
 	{
 		value = 0.0;
 		return(VARIABLE_NOT_FOUND);
@@ -908,37 +1303,23 @@ long FitIniFile::readIdFloat (const char *varName, float &value)
 //---------------------------------------------------------------------------
 long FitIniFile::readIdDouble (const char *varName, double &value)
 {
-	char line[255];
-	char searchString[255];
-	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------
-	// Put prefix on varName.
-	sprintf(searchString,"f %s",varName);
-	
-	//--------------------------------
-	// Search line by line for varName
-	int	testy;
-	do
+	long entry = findValue("f",varName);
+	if (entry >= 0)
 	{
-		readLine((MemoryPtr)line,254);
-		testy = S_strnicmp(line, searchString, strlen(searchString));
-		if (testy == 0)
-		{
-		char* tc = &line[strlen(searchString)];
-			while (isspace(*tc))
-				tc++;
-			if (*tc != '=')
-				testy = 1;
-		}
+		value = fileEntries[entry].floatValue;
+		return(NO_ERR);
+	}
+	else if (entry == INI_VALUE_NOT_FOUND)
+	{
+		value = 0.0;
+		return(VARIABLE_NOT_FOUND);
 	}
-	while((testy != 0) && (logicalPosition < endOfBlock));
+
+	char line[255];
 	
-	if (logicalPosition >= endOfBlock)
+	//--------------------------------
+	// Look varName up in the block index.
+	if (findId("f",varName,line,254) != NO_ERR)
 	{
 		value = 0.0;
 		return(VARIABLE_NOT_FOUND);
@@ -969,37 +1350,23 @@ long FitIniFile::readIdInt(const char *varName, int &value)
 //---------------------------------------------------------------------------
 long FitIniFile::readIdLong (const char *varName, long &value)
 {
-	char line[255];
-	char searchString[255];
-	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------
-	// Put prefix on varName.
-	sprintf(searchString,"l %s",varName);
-	
-	//--------------------------------
-	// Search line by line for varName
-	int	testy;
-	do
+	long entry = findValue("l",varName);
+	if (entry >= 0)
 	{
-		readLine((MemoryPtr)line,254);
-		testy = S_strnicmp(line, searchString, strlen(searchString));
-		if (testy == 0)
-		{
-		char* tc = &line[strlen(searchString)];
-			while (isspace(*tc))
-				tc++;
-			if (*tc != '=')
-				testy = 1;
-		}
+		value = fileEntries[entry].longValue;
+		return(NO_ERR);
 	}
-	while((testy != 0) && (logicalPosition < endOfBlock));
+	else if (entry == INI_VALUE_NOT_FOUND)
+	{
+		value = 0;
+		return(VARIABLE_NOT_FOUND);
+	}
+
+	char line[255];
 	
-	if (logicalPosition >= endOfBlock)
+	//--------------------------------
+	// Look varName up in the block index.
+	if (findId("l",varName,line,254) != NO_ERR)
 	{
 		value = 0;
 		return(VARIABLE_NOT_FOUND);
@@ -1022,44 +1389,30 @@ long FitIniFile::readIdLong (const char *varName, long &value)
 //---------------------------------------------------------------------------
 long FitIniFile::readIdBoolean (const char *varName, bool &value)
 {
-	char line[255];
-	char searchString[255];
-	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------
-	// Put prefix on varName.
-	sprintf(searchString,"b %s",varName);
-	
-	//--------------------------------
-	// Search line by line for varName
-	int	testy;
-	do
+	long entry = findValue("b",varName);
+	if (entry >= 0)
 	{
-		readLine((MemoryPtr)line,254);
-		testy = S_strnicmp(line, searchString, strlen(searchString));
-		if (testy == 0)
-		{
-		char* tc = &line[strlen(searchString)];
-			while (isspace(*tc))
-				tc++;
-			if (*tc != '=')
-				testy = 1;
-		}
+		value = fileEntries[entry].boolValue;
+		return(NO_ERR);
 	}
-	while((testy != 0) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
+	else if (entry == INI_VALUE_NOT_FOUND)
 	{
 		value = 0;
 		return(VARIABLE_NOT_FOUND);
 	}
+
+	char line[255];
 	
-	char *equalSign = strstr(line, "=");
-	if (equalSign)
+	//--------------------------------
+	// Look varName up in the block index.
+	if (findId("b",varName,line,254) != NO_ERR)
+	{
+		value = 0;
+		return(VARIABLE_NOT_FOUND);
+	}
+	
+	char *equalSign = strstr(line, "=");
+	if (equalSign)
 	{
 		equalSign++;
 		value = booleanToLong(equalSign);
@@ -1075,37 +1428,23 @@ long FitIniFile::readIdBoolean (const char *varName, bool &value)
 //---------------------------------------------------------------------------
 long FitIniFile::readIdShort (const char *varName, short &value)
 {
-	char line[255];
-	char searchString[255];
-	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------
-	// Put prefix on varName.
-	sprintf(searchString,"s %s",varName);
-	
-	//--------------------------------
-	// Search line by line for varName
-	int	testy;
-	do
+	long entry = findValue("s",varName);
+	if (entry >= 0)
 	{
-		readLine((MemoryPtr)line,254);
-		testy = S_strnicmp(line, searchString, strlen(searchString));
-		if (testy == 0)
-		{
-		char* tc = &line[strlen(searchString)];
-			while (isspace(*tc))
-				tc++;
-			if (*tc != '=')
-				testy = 1;
-		}
+		value = (short)fileEntries[entry].longValue;
+		return(NO_ERR);
+	}
+	else if (entry == INI_VALUE_NOT_FOUND)
+	{
+		value = 0;
+		return(VARIABLE_NOT_FOUND);
 	}
-	while((testy != 0) && (logicalPosition < endOfBlock));
+
+	char line[255];
 	
-	if (logicalPosition >= endOfBlock)
+	//--------------------------------
+	// Look varName up in the block index.
+	if (findId("s",varName,line,254) != NO_ERR)
 	{
 		value = 0;
 		return(VARIABLE_NOT_FOUND);
@@ -1128,37 +1467,23 @@ long FitIniFile::readIdShort (const char *varName, short &value)
 //---------------------------------------------------------------------------
 long FitIniFile::readIdChar (const char *varName, char &value)
 {
-	char line[255];
-	char searchString[255];
-	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------
-	// Put prefix on varName.
-	sprintf(searchString,"c %s",varName);
-	
-	//--------------------------------
-	// Search line by line for varName
-	int	testy;
-	do
+	long entry = findValue("c",varName);
+	if (entry >= 0)
 	{
-		readLine((MemoryPtr)line,254);
-		testy = S_strnicmp(line, searchString, strlen(searchString));
-		if (testy == 0)
-		{
-		char* tc = &line[strlen(searchString)];
-			while (isspace(*tc))
-				tc++;
-			if (*tc != '=')
-				testy = 1;
-		}
+		value = (char)fileEntries[entry].longValue;
+		return(NO_ERR);
+	}
+	else if (entry == INI_VALUE_NOT_FOUND)
+	{
+		value = 0;
+		return(VARIABLE_NOT_FOUND);
 	}
-	while((testy != 0) && (logicalPosition < endOfBlock));
+
+	char line[255];
 	
-	if (logicalPosition >= endOfBlock)
+	//--------------------------------
+	// Look varName up in the block index.
+	if (findId("c",varName,line,254) != NO_ERR)
 	{
 		value = 0;
 		return(VARIABLE_NOT_FOUND);
@@ -1189,39 +1514,23 @@ long FitIniFile::readIdULong (const char *varName, DWORD &value)
 //---------------------------------------------------------------------------
 long FitIniFile::readIdULong (const char *varName, uint64_t &value)
 {
-	char line[255];
-	char searchString[255];
-	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------
-	// Put prefix on varName.
-	sprintf(searchString,"ul %s",varName);
-	
-	//--------------------------------
-	// Search line by line for varName
-	int	testy;
-	do
+	long entry = findValue("ul",varName);
+	if (entry >= 0)
 	{
-		readLine((MemoryPtr)line,254);
-		testy = S_strnicmp(line, searchString, strlen(searchString));
-		if (testy == 0)
-		{
-			char* tc = &line[strlen(searchString)];
-			
-			while (isspace(*tc))
-				tc++;
-				
-			if (*tc != '=')
-				testy = 1;
-		}
+		value = (unsigned long)fileEntries[entry].longValue;
+		return(NO_ERR);
+	}
+	else if (entry == INI_VALUE_NOT_FOUND)
+	{
+		value = 0;
+		return(VARIABLE_NOT_FOUND);
 	}
-	while((testy != 0) && (logicalPosition < endOfBlock));
+
+	char line[255];
 	
-	if (logicalPosition >= endOfBlock)
+	//--------------------------------
+	// Look varName up in the block index.
+	if (findId("ul",varName,line,254) != NO_ERR)
 	{
 		value = 0;
 		return(VARIABLE_NOT_FOUND);
@@ -1244,37 +1553,23 @@ long FitIniFile::readIdULong (const char *varName, uint64_t &value)
 //---------------------------------------------------------------------------
 long FitIniFile::readIdUShort (const char *varName, unsigned short &value)
 {
-	char line[255];
-	char searchString[255];
-	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------
-	// Put prefix on varName.
-	sprintf(searchString,"us %s",varName);
-	
-	//--------------------------------
-	// Search line by line for varName
-	int	testy;
-	do
+	long entry = findValue("us",varName);
+	if (entry >= 0)
 	{
-		readLine((MemoryPtr)line,254);
-		testy = S_strnicmp(line, searchString, strlen(searchString));
-		if (testy == 0)
-		{
-		char* tc = &line[strlen(searchString)];
-			while (isspace(*tc))
-				tc++;
-			if (*tc != '=')
-				testy = 1;
-		}
+		value = (unsigned short)fileEntries[entry].longValue;
+		return(NO_ERR);
 	}
-	while((testy != 0) && (logicalPosition < endOfBlock));
+	else if (entry == INI_VALUE_NOT_FOUND)
+	{
+		value = 0;
+		return(VARIABLE_NOT_FOUND);
+	}
+
+	char line[255];
 	
-	if (logicalPosition >= endOfBlock)
+	//--------------------------------
+	// Look varName up in the block index.
+	if (findId("us",varName,line,254) != NO_ERR)
 	{
 		value = 0;
 		return(VARIABLE_NOT_FOUND);
@@ -1297,37 +1592,23 @@ long FitIniFile::readIdUShort (const char *varName, unsigned short &value)
 //---------------------------------------------------------------------------
 long FitIniFile::readIdUChar (const char *varName, unsigned char &value)
 {
-	char line[255];
-	char searchString[255];
-	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------
-	// Put prefix on varName.
-	sprintf(searchString,"uc %s",varName);
-	
-	//--------------------------------
-	// Search line by line for varName
-	int	testy;
-	do
+	long entry = findValue("uc",varName);
+	if (entry >= 0)
 	{
-		readLine((MemoryPtr)line,254);
-		testy = S_strnicmp(line, searchString, strlen(searchString));
-		if (testy == 0)
-		{
-		char* tc = &line[strlen(searchString)];
-			while (isspace(*tc))
-				tc++;
-			if (*tc != '=')
-				testy = 1;
-		}
+		value = (unsigned char)fileEntries[entry].longValue;
+		return(NO_ERR);
+	}
+	else if (entry == INI_VALUE_NOT_FOUND)
+	{
+		value = 0;
+		return(VARIABLE_NOT_FOUND);
 	}
-	while((testy != 0) && (logicalPosition < endOfBlock));
+
+	char line[255];
 	
-	if (logicalPosition >= endOfBlock)
+	//--------------------------------
+	// Look varName up in the block index.
+	if (findId("uc",varName,line,254) != NO_ERR)
 	{
 		value = 0;
 		return(VARIABLE_NOT_FOUND);
@@ -1386,36 +1667,11 @@ long FitIniFile::copyString (char *dest, char *src, unsigned long bufLen)
 long FitIniFile::readIdString (const char *varName, char *result, unsigned long bufferSize)
 {
 	char line[2048];
-	char searchString[255];
-	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
 	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
 	
-	//------------------------
-	// Put prefix on varName.
-	sprintf(searchString,"st %s",varName);
-	
 	//--------------------------------
-	// Search line by line for varName
-	int	testy;
-	do
-	{
-		readLine((MemoryPtr)line,2047);
-		testy = S_strnicmp(line, searchString, strlen(searchString));
-		if (testy == 0)
-		{
-		char* tc = &line[strlen(searchString)];
-			while (isspace(*tc))
-				tc++;
-			if (*tc != '=')
-				testy = 1;
-		}
-	}
-	while((testy != 0) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
+	// Look varName up in the block index.
+	if (findId("st",varName,line,2047) != NO_ERR)
 	{
 		return(VARIABLE_NOT_FOUND);
 	}
@@ -1469,36 +1725,10 @@ long FitIniFile::readIdString (const char *varName, char *result, unsigned long
 long FitIniFile::getIdStringLength (const char *varName)
 {
 	char line[255];
-	char searchString[255];
-	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------
-	// Put prefix on varName.
-	sprintf(searchString,"st %s",varName);
 	
 	//--------------------------------
-	// Search line by line for varName
-	int	testy;
-	do
-	{
-		readLine((MemoryPtr)line,254);
-		testy = S_strnicmp(line, searchString, strlen(searchString));
-		if (testy == 0)
-		{
-		char* tc = &line[strlen(searchString)];
-			while (isspace(*tc))
-				tc++;
-			if (*tc != '=')
-				testy = 1;
-		}
-	}
-	while((testy != 0) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
+	// Look varName up in the block index.
+	if (findId("st",varName,line,254) != NO_ERR)
 	{
 		return(VARIABLE_NOT_FOUND);
 	}
@@ -1526,35 +1756,22 @@ long FitIniFile::readIdFloatArray (const char *varName, float *result, unsigned
 	char frontSearch[10];
 	char searchString[255];
 	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
 	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------------------------------------------------
-	// Create two search strings so that we can match any number in []
-	sprintf(frontSearch,"f[");
-	sprintf(searchString,"] %s",varName);
-	
+
 	//--------------------------------
-	// Search line by line for varName
-	char *fSearch = NULL;
-	char *bSearch = NULL;
-	
-	do
-	{
-		readLine((MemoryPtr)line,254);
-		
-		fSearch = strstr(line,frontSearch);
-		bSearch = strstr(line,searchString);
-	}
-	while(((fSearch == NULL) || (bSearch == NULL)) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
+	// Look varName up in the block index.
+	if (findId("f[",varName,line,254) != NO_ERR)
 	{
 		return(VARIABLE_NOT_FOUND);
 	}
 
+	//------------------------------------------------------------------
+	// Create two search strings so that we can match any number in []
+	sprintf(frontSearch,"f[");
+	sprintf(searchString,"] %s",varName);
+	char *fSearch = strstr(line,frontSearch);
+	char *bSearch = strstr(line,searchString);
+
 	//--------------------------------------
 	// Get number of elements in array.
 	char elementString[10];
@@ -1622,35 +1839,22 @@ long FitIniFile::readIdIntArray (const char *varName, int *result, unsigned int
 	char frontSearch[10];
 	char searchString[255];
 	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
 	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------------------------------------------------
-	// Create two search strings so that we can match any number in []
-	sprintf(frontSearch,"l[");
-	sprintf(searchString,"] %s",varName);
-	
+
 	//--------------------------------
-	// Search line by line for varName
-	char *fSearch = NULL;
-	char *bSearch = NULL;
-	
-	do
-	{
-		readLine((MemoryPtr)line,254);
-		
-		fSearch = strstr(line,frontSearch);
-		bSearch = strstr(line,searchString);
-	}
-	while(((fSearch == NULL) || (bSearch == NULL)) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
+	// Look varName up in the block index.
+	if (findId("l[",varName,line,254) != NO_ERR)
 	{
 		return(VARIABLE_NOT_FOUND);
 	}
 
+	//------------------------------------------------------------------
+	// Create two search strings so that we can match any number in []
+	sprintf(frontSearch,"l[");
+	sprintf(searchString,"] %s",varName);
+	char *fSearch = strstr(line,frontSearch);
+	char *bSearch = strstr(line,searchString);
+
 	//--------------------------------------
 	// Get number of elements in array.
 	char elementString[10];
@@ -1717,35 +1921,22 @@ long FitIniFile::readIdLongArray (const char *varName, long *result, unsigned lo
 	char frontSearch[10];
 	char searchString[255];
 	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
 	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------------------------------------------------
-	// Create two search strings so that we can match any number in []
-	sprintf(frontSearch,"l[");
-	sprintf(searchString,"] %s",varName);
-	
+
 	//--------------------------------
-	// Search line by line for varName
-	char *fSearch = NULL;
-	char *bSearch = NULL;
-	
-	do
-	{
-		readLine((MemoryPtr)line,254);
-		
-		fSearch = strstr(line,frontSearch);
-		bSearch = strstr(line,searchString);
-	}
-	while(((fSearch == NULL) || (bSearch == NULL)) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
+	// Look varName up in the block index.
+	if (findId("l[",varName,line,254) != NO_ERR)
 	{
 		return(VARIABLE_NOT_FOUND);
 	}
 
+	//------------------------------------------------------------------
+	// Create two search strings so that we can match any number in []
+	sprintf(frontSearch,"l[");
+	sprintf(searchString,"] %s",varName);
+	char *fSearch = strstr(line,frontSearch);
+	char *bSearch = strstr(line,searchString);
+
 	//--------------------------------------
 	// Get number of elements in array.
 	char elementString[10];
@@ -1812,35 +2003,22 @@ long FitIniFile::readIdULongArray (const char *varName, unsigned long *result, u
 	char frontSearch[10];
 	char searchString[255];
 	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
 	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------------------------------------------------
-	// Create two search strings so that we can match any number in []
-	sprintf(frontSearch,"ul[");
-	sprintf(searchString,"] %s",varName);
-	
+
 	//--------------------------------
-	// Search line by line for varName
-	char *fSearch = NULL;
-	char *bSearch = NULL;
-	
-	do
-	{
-		readLine((MemoryPtr)line,254);
-		
-		fSearch = strstr(line,frontSearch);
-		bSearch = strstr(line,searchString);
-	}
-	while(((fSearch == NULL) || (bSearch == NULL)) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
+	// Look varName up in the block index.
+	if (findId("ul[",varName,line,254) != NO_ERR)
 	{
 		return(VARIABLE_NOT_FOUND);
 	}
 
+	//------------------------------------------------------------------
+	// Create two search strings so that we can match any number in []
+	sprintf(frontSearch,"ul[");
+	sprintf(searchString,"] %s",varName);
+	char *fSearch = strstr(line,frontSearch);
+	char *bSearch = strstr(line,searchString);
+
 	//--------------------------------------
 	// Get number of elements in array.
 	char elementString[10];
@@ -1907,35 +2085,22 @@ long FitIniFile::readIdShortArray (const char *varName, short *result, unsigned
 	char frontSearch[10];
 	char searchString[255];
 	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
 	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------------------------------------------------
-	// Create two search strings so that we can match any number in []
-	sprintf(frontSearch,"s[");
-	sprintf(searchString,"] %s",varName);
-	
+
 	//--------------------------------
-	// Search line by line for varName
-	char *fSearch = NULL;
-	char *bSearch = NULL;
-	
-	do
-	{
-		readLine((MemoryPtr)line,254);
-		
-		fSearch = strstr(line,frontSearch);
-		bSearch = strstr(line,searchString);
-	}
-	while(((fSearch == NULL) || (bSearch == NULL)) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
+	// Look varName up in the block index.
+	if (findId("s[",varName,line,254) != NO_ERR)
 	{
 		return(VARIABLE_NOT_FOUND);
 	}
 
+	//------------------------------------------------------------------
+	// Create two search strings so that we can match any number in []
+	sprintf(frontSearch,"s[");
+	sprintf(searchString,"] %s",varName);
+	char *fSearch = strstr(line,frontSearch);
+	char *bSearch = strstr(line,searchString);
+
 	//--------------------------------------
 	// Get number of elements in array.
 	char elementString[10];
@@ -2002,35 +2167,22 @@ long FitIniFile::readIdUShortArray (const char *varName, unsigned short *result,
 	char frontSearch[10];
 	char searchString[255];
 	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
 	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------------------------------------------------
-	// Create two search strings so that we can match any number in []
-	sprintf(frontSearch,"us[");
-	sprintf(searchString,"] %s",varName);
-	
+
 	//--------------------------------
-	// Search line by line for varName
-	char *fSearch = NULL;
-	char *bSearch = NULL;
-	
-	do
-	{
-		readLine((MemoryPtr)line,254);
-		
-		fSearch = strstr(line,frontSearch);
-		bSearch = strstr(line,searchString);
-	}
-	while(((fSearch == NULL) || (bSearch == NULL)) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
+	// Look varName up in the block index.
+	if (findId("us[",varName,line,254) != NO_ERR)
 	{
 		return(VARIABLE_NOT_FOUND);
 	}
 
+	//------------------------------------------------------------------
+	// Create two search strings so that we can match any number in []
+	sprintf(frontSearch,"us[");
+	sprintf(searchString,"] %s",varName);
+	char *fSearch = strstr(line,frontSearch);
+	char *bSearch = strstr(line,searchString);
+
 	//--------------------------------------
 	// Get number of elements in array.
 	char elementString[10];
@@ -2097,35 +2249,22 @@ long FitIniFile::readIdCharArray (const char *varName, char *result, unsigned lo
 	char frontSearch[10];
 	char searchString[255];
 	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
 	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------------------------------------------------
-	// Create two search strings so that we can match any number in []
-	sprintf(frontSearch,"c[");
-	sprintf(searchString,"] %s",varName);
-	
+
 	//--------------------------------
-	// Search line by line for varName
-	char *fSearch = NULL;
-	char *bSearch = NULL;
-	
-	do
-	{
-		readLine((MemoryPtr)line,254);
-		
-		fSearch = strstr(line,frontSearch);
-		bSearch = strstr(line,searchString);
-	}
-	while(((fSearch == NULL) || (bSearch == NULL)) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
+	// Look varName up in the block index.
+	if (findId("c[",varName,line,254) != NO_ERR)
 	{
 		return(VARIABLE_NOT_FOUND);
 	}
 
+	//------------------------------------------------------------------
+	// Create two search strings so that we can match any number in []
+	sprintf(frontSearch,"c[");
+	sprintf(searchString,"] %s",varName);
+	char *fSearch = strstr(line,frontSearch);
+	char *bSearch = strstr(line,searchString);
+
 	//--------------------------------------
 	// Get number of elements in array.
 	char elementString[10];
@@ -2192,35 +2331,22 @@ long FitIniFile::readIdUCharArray (const char *varName, unsigned char *result, u
 	char frontSearch[10];
 	char searchString[255];
 	
-	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
 	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
-	//------------------------------------------------------------------
-	// Create two search strings so that we can match any number in []
-	sprintf(frontSearch,"uc[");
-	sprintf(searchString,"] %s",varName);
-	
+
 	//--------------------------------
-	// Search line by line for varName
-	char *fSearch = NULL;
-	char *bSearch = NULL;
-	
-	do
-	{
-		readLine((MemoryPtr)line,254);
-		
-		fSearch = strstr(line,frontSearch);
-		bSearch = strstr(line,searchString);
-	}
-	while(((fSearch == NULL) || (bSearch == NULL)) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
+	// Look varName up in the block index.
+	if (findId("uc[",varName,line,254) != NO_ERR)
 	{
 		return(VARIABLE_NOT_FOUND);
 	}
 
+	//------------------------------------------------------------------
+	// Create two search strings so that we can match any number in []
+	sprintf(frontSearch,"uc[");
+	sprintf(searchString,"] %s",varName);
+	char *fSearch = strstr(line,frontSearch);
+	char *bSearch = strstr(line,searchString);
+
 	//--------------------------------------
 	// Get number of elements in array.
 	char elementString[10];
@@ -2288,33 +2414,18 @@ unsigned long FitIniFile::getIdFloatArrayElements (const char *varName)
 	char searchString[255];
 	
 	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
+	// Look varName up in the block index.
+	if (findId("f[",varName,line,254) != NO_ERR)
+	{
+		return(VARIABLE_NOT_FOUND);
+	}
+
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
 	sprintf(frontSearch,"f[");
 	sprintf(searchString,"] %s",varName);
-	
-	//--------------------------------
-	// Search line by line for varName
-	char *fSearch = NULL;
-	char *bSearch = NULL;
-	
-	do
-	{
-		readLine((MemoryPtr)line,254);
-		
-		fSearch = strstr(line,frontSearch);
-		bSearch = strstr(line,searchString);
-	}
-	while(((fSearch == NULL) || (bSearch == NULL)) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
-	{
-		return(VARIABLE_NOT_FOUND);
-	}
+	char *fSearch = strstr(line,frontSearch);
+	char *bSearch = strstr(line,searchString);
 
 	//--------------------------------------
 	// Get number of elements in array.
@@ -2343,33 +2454,18 @@ unsigned long FitIniFile::getIdLongArrayElements (const char *varName)
 	char searchString[255];
 	
 	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
+	// Look varName up in the block index.
+	if (findId("l[",varName,line,254) != NO_ERR)
+	{
+		return(VARIABLE_NOT_FOUND);
+	}
+
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
 	sprintf(frontSearch,"l[");
 	sprintf(searchString,"] %s",varName);
-	
-	//--------------------------------
-	// Search line by line for varName
-	char *fSearch = NULL;
-	char *bSearch = NULL;
-	
-	do
-	{
-		readLine((MemoryPtr)line,254);
-		
-		fSearch = strstr(line,frontSearch);
-		bSearch = strstr(line,searchString);
-	}
-	while(((fSearch == NULL) || (bSearch == NULL)) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
-	{
-		return(VARIABLE_NOT_FOUND);
-	}
+	char *fSearch = strstr(line,frontSearch);
+	char *bSearch = strstr(line,searchString);
 
 	//--------------------------------------
 	// Get number of elements in array.
@@ -2398,33 +2494,18 @@ unsigned long FitIniFile::getIdULongArrayElements (const char *varName)
 	char searchString[255];
 	
 	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
+	// Look varName up in the block index.
+	if (findId("ul[",varName,line,254) != NO_ERR)
+	{
+		return(VARIABLE_NOT_FOUND);
+	}
+
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
 	sprintf(frontSearch,"ul[");
 	sprintf(searchString,"] %s",varName);
-	
-	//--------------------------------
-	// Search line by line for varName
-	char *fSearch = NULL;
-	char *bSearch = NULL;
-	
-	do
-	{
-		readLine((MemoryPtr)line,254);
-		
-		fSearch = strstr(line,frontSearch);
-		bSearch = strstr(line,searchString);
-	}
-	while(((fSearch == NULL) || (bSearch == NULL)) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
-	{
-		return(VARIABLE_NOT_FOUND);
-	}
+	char *fSearch = strstr(line,frontSearch);
+	char *bSearch = strstr(line,searchString);
 
 	//--------------------------------------
 	// Get number of elements in array.
@@ -2453,33 +2534,18 @@ unsigned long FitIniFile::getIdShortArrayElements (const char *varName)
 	char searchString[255];
 	
 	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
+	// Look varName up in the block index.
+	if (findId("s[",varName,line,254) != NO_ERR)
+	{
+		return(VARIABLE_NOT_FOUND);
+	}
+
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
 	sprintf(frontSearch,"s[");
 	sprintf(searchString,"] %s",varName);
-	
-	//--------------------------------
-	// Search line by line for varName
-	char *fSearch = NULL;
-	char *bSearch = NULL;
-	
-	do
-	{
-		readLine((MemoryPtr)line,254);
-		
-		fSearch = strstr(line,frontSearch);
-		bSearch = strstr(line,searchString);
-	}
-	while(((fSearch == NULL) || (bSearch == NULL)) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
-	{
-		return(VARIABLE_NOT_FOUND);
-	}
+	char *fSearch = strstr(line,frontSearch);
+	char *bSearch = strstr(line,searchString);
 
 	//--------------------------------------
 	// Get number of elements in array.
@@ -2508,33 +2574,18 @@ unsigned long FitIniFile::getIdUShortArrayElements (const char *varName)
 	char searchString[255];
 	
 	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
+	// Look varName up in the block index.
+	if (findId("us[",varName,line,254) != NO_ERR)
+	{
+		return(VARIABLE_NOT_FOUND);
+	}
+
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
 	sprintf(frontSearch,"us[");
 	sprintf(searchString,"] %s",varName);
-	
-	//--------------------------------
-	// Search line by line for varName
-	char *fSearch = NULL;
-	char *bSearch = NULL;
-	
-	do
-	{
-		readLine((MemoryPtr)line,254);
-		
-		fSearch = strstr(line,frontSearch);
-		bSearch = strstr(line,searchString);
-	}
-	while(((fSearch == NULL) || (bSearch == NULL)) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
-	{
-		return(VARIABLE_NOT_FOUND);
-	}
+	char *fSearch = strstr(line,frontSearch);
+	char *bSearch = strstr(line,searchString);
 
 	//--------------------------------------
 	// Get number of elements in array.
@@ -2563,33 +2614,18 @@ unsigned long FitIniFile::getIdCharArrayElements (const char *varName)
 	char searchString[255];
 	
 	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
+	// Look varName up in the block index.
+	if (findId("c[",varName,line,254) != NO_ERR)
+	{
+		return(VARIABLE_NOT_FOUND);
+	}
+
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
 	sprintf(frontSearch,"c[");
 	sprintf(searchString,"] %s",varName);
-	
-	//--------------------------------
-	// Search line by line for varName
-	char *fSearch = NULL;
-	char *bSearch = NULL;
-	
-	do
-	{
-		readLine((MemoryPtr)line,254);
-		
-		fSearch = strstr(line,frontSearch);
-		bSearch = strstr(line,searchString);
-	}
-	while(((fSearch == NULL) || (bSearch == NULL)) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
-	{
-		return(VARIABLE_NOT_FOUND);
-	}
+	char *fSearch = strstr(line,frontSearch);
+	char *bSearch = strstr(line,searchString);
 
 	//--------------------------------------
 	// Get number of elements in array.
@@ -2618,33 +2654,18 @@ unsigned long FitIniFile::getIdUCharArrayElements (const char *varName)
 	char searchString[255];
 	
 	//--------------------------------
-	// Always read from top of Block.
-	seek(currentBlockOffset);
-	unsigned long endOfBlock = currentBlockOffset+currentBlockSize;
-	
+	// Look varName up in the block index.
+	if (findId("uc[",varName,line,254) != NO_ERR)
+	{
+		return(VARIABLE_NOT_FOUND);
+	}
+
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
 	sprintf(frontSearch,"uc[");
 	sprintf(searchString,"] %s",varName);
-	
-	//--------------------------------
-	// Search line by line for varName
-	char *fSearch = NULL;
-	char *bSearch = NULL;
-	
-	do
-	{
-		readLine((MemoryPtr)line,254);
-		
-		fSearch = strstr(line,frontSearch);
-		bSearch = strstr(line,searchString);
-	}
-	while(((fSearch == NULL) || (bSearch == NULL)) && (logicalPosition < endOfBlock));
-	
-	if (logicalPosition >= endOfBlock)
-	{
-		return(VARIABLE_NOT_FOUND);
-	}
+	char *fSearch = strstr(line,frontSearch);
+	char *bSearch = strstr(line,searchString);
 
 	//--------------------------------------
 	// Get number of elements in array.
@@ -25,6 +25,10 @@
 #include"file.h"
 #endif
 
+#ifndef DDATACACHE_H
+#include"ddatacache.h"
+#endif
+
 //---------------------------------------------------------------------------
 // Macro Definitions
 #ifndef 	NO_ERR
@@ -47,6 +51,13 @@
 #define USER_ARRAY_TOO_SMALL				0xFADA000D
 #define TOO_MANY_ELEMENTS					0xFADA000E
 
+#define INI_ENTRY_NOT_SCALAR				0			//No readIdFloat, readIdLong, etc. can match the line
+#define INI_ENTRY_SCALAR					1			//Key and values are filled in
+#define INI_ENTRY_READ_LINE					2			//Too long to tell without reading the line
+
+#define INI_VALUE_NOT_FOUND					-1			//From findValue
+#define INI_VALUE_READ_LINE					-2
+
 //---------------------------------------------------------------------------
 // Enums
 
@@ -56,6 +67,28 @@ struct IniBlockNode
 {
 	char blockId[50];
 	unsigned long blockOffset;
+	long nextBlock;								//Next block in the same hash bucket.  -1 ends the chain.
+};
+
+//---------------------------------------------------------------------------
+// One of these for every "type name = value" line found by afterOpen.
+// Hashed on (block, type, name) so readId* can go straight to the line.
+// Lines the scalar readId* calls can match also keep their lower case
+// "type name" and the value already converted, so those calls never
+// read the line.
+struct IniEntryNode
+{
+	DWORD hash;
+	unsigned long blockNum;
+	unsigned long lineOffset;					//Start of the line in the file
+	unsigned long lineEnd;						//File position after reading the line
+	long nextEntry;								//Next entry in the same hash bucket.  -1 ends the chain.
+	unsigned long keyOffset;					//Into fileKeys
+	unsigned long keyLength;
+	double floatValue;							//As textToDouble reads the value
+	long longValue;								//As textToLong does.  The smaller integer reads truncate it.
+	bool boolValue;
+	unsigned char scalar;						//INI_ENTRY_xxx
 };
 
 //---------------------------------------------------------------------------
@@ -70,6 +103,18 @@ class FitIniFile : public File
 		char 				*currentBlockId;				//Id of current block
 		unsigned long 	currentBlockOffset;			//Offset into file of block start
 		unsigned long 	currentBlockSize;				//Length of current block
+		long			currentBlockNum;				//Index of current block in fileBlocks, -1 if none
+
+		unsigned long	totalEntries;					//Total number of indexed lines in file
+		IniEntryNode	*fileEntries;
+		long			*blockBuckets;					//Hash heads for seekBlock
+		unsigned long	blockBucketMask;
+		long			*entryBuckets;					//Hash heads for readId*
+		unsigned long	entryBucketMask;
+		char			*fileKeys;						//Every scalar entry's key, one after the other
+		unsigned long	totalKeyBytes;
+
+		DataCacheFilePtr	cacheFile;					//Set if the tables above live in a data cache
 
 	// Member Functions
 	//------------------
@@ -77,8 +122,14 @@ class FitIniFile : public File
 		long afterOpen (void);
 		void atClose (void);
 		
-		long findNextBlockStart (char *line = NULL, unsigned long lineLen = 0);
-		long countBlocks (void);
+		static DWORD hashId (unsigned long blockNum, const char *typeId, const char *name, unsigned long nameLen);
+		long indexLines (bool fillIn);
+		void buildIndex (void);
+		long findId (const char *typeId, const char *varName, char *line, unsigned long lineLen);
+		long findValue (const char *typeId, const char *varName);
+
+		long loadCache (const char *cacheName, DWORD sourceSize, DWORD sourceStamp);
+		void saveCache (const char *cacheName, DWORD sourceSize, DWORD sourceStamp);
 		
 		long getNextWord (char *&line, char *buffer, unsigned long bufLen);
 
@@ -141,6 +192,16 @@ class FitIniFile : public File
 
 		long seekBlock (const char *blockId);
 
+		unsigned long getNumBlocks (void)
+		{
+			return totalBlocks;
+		}
+
+		const char *getBlockId (unsigned long blockNum)
+		{
+			return (blockNum < totalBlocks) ? fileBlocks[blockNum].blockId : NULL;
+		}
+
 		long readIdFloat (const char *varName, float &value);
 		long readIdDouble (const char *varName, double &value);
 		
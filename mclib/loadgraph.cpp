@@ -0,0 +1,619 @@
+//---------------------------------------------------------------------------
+//
+// loadgraph.cpp - This file contains the class functions for LoadGraph
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+//---------------------------------------------------------------------------
+// Include files
+
+#ifndef LOADGRAPH_H
+#include"loadgraph.h"
+#endif
+
+#ifndef FFILE_H
+#include"ffile.h"
+#endif
+
+#ifndef FASTFILE_H
+#include"fastfile.h"
+#endif
+
+#ifndef PACKET_H
+#include"packet.h"
+#endif
+
+#include<string.h>
+#include<stdlib.h>
+#include<gameos.hpp>
+
+#include"platform_io.h"
+#include"platform_str.h"
+
+#include<string>
+#include<vector>
+#include<deque>
+#include<map>
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+
+//---------------------------------------------------------------------------
+// Macro Definitions
+#define LOAD_TASK_WAITING			0				//Dependencies not done yet
+#define LOAD_TASK_READY				1				//Queued
+#define LOAD_TASK_RUNNING			2
+#define LOAD_TASK_DONE				3
+
+//---------------------------------------------------------------------------
+struct LoadTask
+{
+	LoadTaskFunc		func;
+	void				*data;
+	bool				mainThread;
+	long				status;
+	long				numDepsLeft;
+	std::vector<long>	dependents;
+};
+
+//---------------------------------------------------------------------------
+// One prefetched file or packet.  The task fills in data and size, after
+// that the entry only changes under the lock when a use frees the data.
+struct LoadPrefetch
+{
+	long				task;
+	std::string			fileName;
+	PacketFile			*packetFile;
+	long				packet;
+
+	MemoryPtr			data;
+	long				size;
+	long				usesLeft;				//0 keeps the data until destroy.
+};
+
+typedef std::pair<PacketFile*,long> LoadPacketKey;
+
+//---------------------------------------------------------------------------
+struct LoadGraphState
+{
+	std::vector<std::thread>					workers;
+	std::mutex									lock;
+	std::condition_variable						wakeUp;			//Workers: a task is ready or we quit.
+	std::condition_variable						taskDone;		//Anyone waiting for a task.
+	std::vector<LoadTask*>						tasks;
+	std::deque<long>							ready;
+	std::deque<long>							readyMain;
+	long										numDone;
+	bool										quit;
+
+	std::vector<LoadPrefetch*>					prefetches;
+	std::map<std::string,LoadPrefetch*>			files;
+	std::map<LoadPacketKey,LoadPrefetch*>		packets;
+};
+
+LoadGraph *LoadGraph::active = NULL;
+
+//---------------------------------------------------------------------------
+// The lock is held on entry and on return, but not while func runs.
+static void RunLoadTask (LoadGraph *graph, LoadGraphState *state, std::unique_lock<std::mutex> &guard, long id)
+{
+	LoadTask *task = state->tasks[id];
+	task->status = LOAD_TASK_RUNNING;
+
+	guard.unlock();
+	task->func(graph,task->data);
+	guard.lock();
+
+	task->status = LOAD_TASK_DONE;
+	state->numDone++;
+
+	bool wakeWorkers = false;
+	for (size_t i=0;i<task->dependents.size();i++)
+	{
+		LoadTask *dependent = state->tasks[task->dependents[i]];
+		if (--dependent->numDepsLeft == 0)
+		{
+			dependent->status = LOAD_TASK_READY;
+			if (dependent->mainThread)
+			{
+				state->readyMain.push_back(task->dependents[i]);
+			}
+			else
+			{
+				state->ready.push_back(task->dependents[i]);
+				wakeWorkers = true;
+			}
+		}
+	}
+
+	if (wakeWorkers)
+		state->wakeUp.notify_all();
+
+	state->taskDone.notify_all();
+}
+
+//---------------------------------------------------------------------------
+static bool RemoveLoadTask (std::deque<long> &queue, long id)
+{
+	for (std::deque<long>::iterator i=queue.begin();i!=queue.end();i++)
+	{
+		if (*i == id)
+		{
+			queue.erase(i);
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+//---------------------------------------------------------------------------
+static void LoadWorker (LoadGraph *graph, LoadGraphState *state)
+{
+	if (gos_ProfilerActive)
+		gos_ProfilerSetThreadName("Load Worker");
+
+	std::unique_lock<std::mutex> guard(state->lock);
+	for (;;)
+	{
+		while (!state->quit && state->ready.empty())
+			state->wakeUp.wait(guard);
+
+		if (state->quit)
+			return;
+
+		long id = state->ready.front();
+		state->ready.pop_front();
+
+		RunLoadTask(graph,state,guard,id);
+	}
+}
+
+//---------------------------------------------------------------------------
+static void PrefetchFileTask (LoadGraph *graph, void *data)
+{
+	GOS_PROFILE_ZONE("LoadGraph::prefetchFile");
+
+	LoadPrefetch *entry = (LoadPrefetch *)data;
+	const char *fileName = entry->fileName.c_str();
+
+	//----------------------------------------------------------------
+	// File::open reads loose files first, so patches win.  Leave those
+	// alone.  FastFileFind isn't safe here, go to the archives directly.
+	struct _stat st;
+	if (_stat(fileName,&st) != -1)
+		return;
+
+	DWORD hash = elfHash(fileName);
+	for (long i=0;i<numFastFiles;i++)
+	{
+		long index = fastFiles[i]->findFast(hash,fileName);
+		if (index == -1)
+			continue;
+
+		long realSize = fastFiles[i]->getFilesInfo()[index].pfe->realSize;
+		if (realSize <= 0)
+			return;
+
+		MemoryPtr image = (MemoryPtr)malloc(realSize);
+		if (!image)
+			return;
+
+		if (fastFiles[i]->readFastEntry(index,image) != realSize)
+		{
+			free(image);
+			return;
+		}
+
+		entry->data = image;
+		entry->size = realSize;
+		return;
+	}
+}
+
+//---------------------------------------------------------------------------
+static void PrefetchPacketTask (LoadGraph *graph, void *data)
+{
+	GOS_PROFILE_ZONE("LoadGraph::prefetchPacket");
+
+	LoadPrefetch *entry = (LoadPrefetch *)data;
+
+	long size = entry->packetFile->getPacketSizeAt(entry->packet);
+	if (size <= 0)
+		return;
+
+	MemoryPtr image = (MemoryPtr)malloc(size);
+	if (!image)
+		return;
+
+	if (entry->packetFile->readPacketAt(entry->packet,image) != size)
+	{
+		free(image);
+		return;
+	}
+
+	entry->data = image;
+	entry->size = size;
+}
+
+//---------------------------------------------------------------------------
+// Makes sure the entry's task is done, running it here if no worker has
+// picked it up yet.  Lock held.
+static bool WaitForPrefetch (LoadGraph *graph, LoadGraphState *state, std::unique_lock<std::mutex> &guard, LoadPrefetch *entry)
+{
+	LoadTask *task = state->tasks[entry->task];
+	if ((task->status == LOAD_TASK_READY) && RemoveLoadTask(state->ready,entry->task))
+		RunLoadTask(graph,state,guard,entry->task);
+
+	if (task->status == LOAD_TASK_RUNNING)
+	{
+		GOS_PROFILE_ZONE("LoadGraph::wait");
+		while (task->status != LOAD_TASK_DONE)
+			state->taskDone.wait(guard);
+	}
+
+	return(task->status == LOAD_TASK_DONE);
+}
+
+//---------------------------------------------------------------------------
+// Lock held.
+static bool CopyPrefetch (LoadGraph *graph, LoadGraphState *state, std::unique_lock<std::mutex> &guard, LoadPrefetch *entry, MemoryPtr buffer, long size)
+{
+	if (!WaitForPrefetch(graph,state,guard,entry) || !entry->data || (entry->size != size))
+		return(false);
+
+	memcpy(buffer,entry->data,size);
+
+	if (entry->usesLeft && (--entry->usesLeft == 0))
+	{
+		free(entry->data);
+		entry->data = NULL;
+	}
+
+	return(true);
+}
+
+//---------------------------------------------------------------------------
+// class LoadGraph
+bool LoadGraph::start (long numThreads)
+{
+	destroy();
+
+	if (numThreads < 0)
+	{
+		//-----------------------------------------------------------------
+		// Leave one core for the game itself.
+		numThreads = std::thread::hardware_concurrency() - 1;
+		if (numThreads > LOAD_GRAPH_MAX_THREADS)
+			numThreads = LOAD_GRAPH_MAX_THREADS;
+	}
+
+	if (numThreads <= 0)
+		return(false);
+
+	state = new LoadGraphState;
+	state->numDone = 0;
+	state->quit = false;
+
+	for (long i=0;i<numThreads;i++)
+		state->workers.push_back(std::thread(LoadWorker,this,state));
+
+	if (!active)
+		active = this;
+
+	return(true);
+}
+
+//---------------------------------------------------------------------------
+void LoadGraph::destroy (void)
+{
+	if (!state)
+		return;
+
+	//---------------------------------------------------------------
+	// Tasks point at files the caller is about to close, so every one
+	// of them has to finish before we go.
+	float progress = 0.0f;
+	waitAll(progress,0.0f);
+
+	{
+		std::lock_guard<std::mutex> guard(state->lock);
+		state->quit = true;
+	}
+	state->wakeUp.notify_all();
+
+	for (size_t i=0;i<state->workers.size();i++)
+		state->workers[i].join();
+
+	for (size_t i=0;i<state->tasks.size();i++)
+		delete state->tasks[i];
+
+	for (size_t i=0;i<state->prefetches.size();i++)
+	{
+		if (state->prefetches[i]->data)
+			free(state->prefetches[i]->data);
+		delete state->prefetches[i];
+	}
+
+	delete state;
+	state = NULL;
+
+	if (active == this)
+		active = NULL;
+}
+
+//---------------------------------------------------------------------------
+long LoadGraph::addTask (LoadTaskFunc func, void *data, bool mainThread, long numDeps, const long *deps)
+{
+	if (!state)
+	{
+		func(this,data);
+		return(-1);
+	}
+
+	long id;
+	bool wakeWorker = false;
+	{
+		std::lock_guard<std::mutex> guard(state->lock);
+
+		LoadTask *task = new LoadTask;
+		task->func = func;
+		task->data = data;
+		task->mainThread = mainThread;
+		task->numDepsLeft = 0;
+
+		id = state->tasks.size();
+		state->tasks.push_back(task);
+
+		for (long i=0;i<numDeps;i++)
+		{
+			if ((deps[i] < 0) || (state->tasks[deps[i]]->status == LOAD_TASK_DONE))
+				continue;
+
+			state->tasks[deps[i]]->dependents.push_back(id);
+			task->numDepsLeft++;
+		}
+
+		if (task->numDepsLeft)
+		{
+			task->status = LOAD_TASK_WAITING;
+		}
+		else
+		{
+			task->status = LOAD_TASK_READY;
+			if (mainThread)
+			{
+				state->readyMain.push_back(id);
+			}
+			else
+			{
+				state->ready.push_back(id);
+				wakeWorker = true;
+			}
+		}
+	}
+
+	if (wakeWorker)
+		state->wakeUp.notify_one();
+
+	return(id);
+}
+
+//---------------------------------------------------------------------------
+long LoadGraph::prefetchFile (const char *fileName, long numUses)
+{
+	if (!state || !fileName || !fastFiles)
+		return(-1);
+
+	//-----------------------------------------------------
+	// Same name File::open ends up looking for.
+	std::string name(fileName);
+	S_strlwr(&name[0]);
+
+	LoadPrefetch *entry = NULL;
+	{
+		std::lock_guard<std::mutex> guard(state->lock);
+
+		std::map<std::string,LoadPrefetch*>::iterator i = state->files.find(name);
+		if (i != state->files.end())
+			return(i->second->task);
+
+		entry = new LoadPrefetch;
+		entry->task = -1;
+		entry->fileName = name;
+		entry->packetFile = NULL;
+		entry->packet = -1;
+		entry->data = NULL;
+		entry->size = 0;
+		entry->usesLeft = numUses;
+
+		state->prefetches.push_back(entry);
+		state->files[name] = entry;
+	}
+
+	//------------------------------------------------------------------
+	// Hooks skip entries until the task is there, which it is before
+	// anything else on this thread can open the file.
+	long task = addTask(PrefetchFileTask,entry);
+
+	std::lock_guard<std::mutex> guard(state->lock);
+	entry->task = task;
+	return(task);
+}
+
+//---------------------------------------------------------------------------
+long LoadGraph::prefetchPacket (PacketFile *file, long packet, long numUses)
+{
+	if (!state || !file || (packet < 0) || (packet >= file->getNumPackets()))
+		return(-1);
+
+	//----------------------------------------------------------------
+	// Raw packets are a plain read, no point doing those up front.
+	int type = 0;
+	file->readPacketOffset(packet,&type);
+	if ((type != STORAGE_TYPE_LZD) && (type != STORAGE_TYPE_ZLIB))
+		return(-1);
+
+	LoadPacketKey key(file,packet);
+	LoadPrefetch *entry = NULL;
+	{
+		std::lock_guard<std::mutex> guard(state->lock);
+
+		std::map<LoadPacketKey,LoadPrefetch*>::iterator i = state->packets.find(key);
+		if (i != state->packets.end())
+			return(i->second->task);
+
+		entry = new LoadPrefetch;
+		entry->task = -1;
+		entry->packetFile = file;
+		entry->packet = packet;
+		entry->data = NULL;
+		entry->size = 0;
+		entry->usesLeft = numUses;
+
+		state->prefetches.push_back(entry);
+		state->packets[key] = entry;
+	}
+
+	long task = addTask(PrefetchPacketTask,entry);
+
+	std::lock_guard<std::mutex> guard(state->lock);
+	entry->task = task;
+	return(task);
+}
+
+//---------------------------------------------------------------------------
+MemoryPtr LoadGraph::getPacketData (PacketFile *file, long packet, long &size)
+{
+	size = 0;
+	if (!state)
+		return(NULL);
+
+	std::lock_guard<std::mutex> guard(state->lock);
+
+	std::map<LoadPacketKey,LoadPrefetch*>::iterator i = state->packets.find(LoadPacketKey(file,packet));
+	if ((i == state->packets.end()) || (i->second->task < 0) || (state->tasks[i->second->task]->status != LOAD_TASK_DONE))
+		return(NULL);
+
+	LoadPrefetch *entry = i->second;
+	if (!entry->data)
+		return(NULL);
+
+	//----------------------------------------------------------------
+	// From here on it stays put, no more uses means no more freeing.
+	entry->usesLeft = 0;
+	size = entry->size;
+	return(entry->data);
+}
+
+//---------------------------------------------------------------------------
+void LoadGraph::runMainTasks (void)
+{
+	if (!state)
+		return;
+
+	std::unique_lock<std::mutex> guard(state->lock);
+	while (!state->readyMain.empty())
+	{
+		long id = state->readyMain.front();
+		state->readyMain.pop_front();
+
+		RunLoadTask(this,state,guard,id);
+	}
+}
+
+//---------------------------------------------------------------------------
+void LoadGraph::waitAll (volatile float &progress, float progressRange)
+{
+	if (!state)
+	{
+		progress += progressRange;
+		return;
+	}
+
+	float startProgress = progress;
+	float done = 0.0f;
+
+	std::unique_lock<std::mutex> guard(state->lock);
+	long startDone = state->numDone;
+	for (;;)
+	{
+		//--------------------------------------------------------------
+		// Tasks can still be added as we go, so never move backwards.
+		long numTasks = state->tasks.size() - startDone;
+		if (numTasks > 0)
+		{
+			float fraction = float(state->numDone - startDone) / float(numTasks);
+			if (fraction > done)
+			{
+				done = fraction;
+				progress = startProgress + progressRange * done;
+			}
+		}
+
+		if (state->numDone == (long)state->tasks.size())
+			break;
+
+		//-------------------------------------------------------------
+		// Rather than sit here, help out.
+		long id = -1;
+		if (!state->readyMain.empty())
+		{
+			id = state->readyMain.front();
+			state->readyMain.pop_front();
+		}
+		else if (!state->ready.empty())
+		{
+			id = state->ready.front();
+			state->ready.pop_front();
+		}
+
+		if (id != -1)
+		{
+			RunLoadTask(this,state,guard,id);
+		}
+		else
+		{
+			GOS_PROFILE_ZONE("LoadGraph::wait");
+			state->taskDone.wait(guard);
+		}
+	}
+
+	progress = startProgress + progressRange;
+}
+
+//---------------------------------------------------------------------------
+bool LoadGraph::copyFile (const char *fileName, MemoryPtr buffer, long size)
+{
+	if (!active || !active->state || !fileName)
+		return(false);
+
+	LoadGraphState *state = active->state;
+	std::unique_lock<std::mutex> guard(state->lock);
+
+	std::map<std::string,LoadPrefetch*>::iterator i = state->files.find(fileName);
+	if ((i == state->files.end()) || (i->second->task < 0))
+		return(false);
+
+	return(CopyPrefetch(active,state,guard,i->second,buffer,size));
+}
+
+//---------------------------------------------------------------------------
+bool LoadGraph::copyPacket (PacketFile *file, long packet, MemoryPtr buffer, long size)
+{
+	if (!active || !active->state)
+		return(false);
+
+	LoadGraphState *state = active->state;
+	std::unique_lock<std::mutex> guard(state->lock);
+
+	std::map<LoadPacketKey,LoadPrefetch*>::iterator i = state->packets.find(LoadPacketKey(file,packet));
+	if ((i == state->packets.end()) || (i->second->task < 0))
+		return(false);
+
+	return(CopyPrefetch(active,state,guard,i->second,buffer,size));
+}
+
+//---------------------------------------------------------------------------
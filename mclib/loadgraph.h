@@ -0,0 +1,126 @@
+//---------------------------------------------------------------------------
+//
+// loadgraph.h - This file contains the class declaration for LoadGraph
+//
+//				A LoadGraph runs load work on a pool of worker threads.
+//				Tasks may depend on other tasks and are only started once
+//				those are done.  Tasks marked mainThread are only run by
+//				the thread which owns the graph, from runMainTasks and
+//				waitAll, for anything which touches the heaps or the
+//				managers.
+//
+//				Most of what the workers do is prefetch: read a fastfile
+//				entry or a compressed packet and decompress it.  While a
+//				graph is active File::open and PacketFile::readPacket copy
+//				a prefetched image if there is one, waiting for it (or
+//				running it right there) if it isn't done yet.  Everything
+//				which parses the data runs just like before, in the same
+//				order, it simply doesn't wait on the disk anymore.
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#ifndef LOADGRAPH_H
+#define LOADGRAPH_H
+//---------------------------------------------------------------------------
+// Include files
+
+#ifndef DSTD_H
+#include"dstd.h"
+#endif
+
+//---------------------------------------------------------------------------
+// Macro Definitions
+#define LOAD_GRAPH_MAX_THREADS		4				//Worker threads.  One core is always left for the main thread.
+
+//---------------------------------------------------------------------------
+class LoadGraph;
+class PacketFile;
+struct LoadGraphState;
+
+typedef void (*LoadTaskFunc) (LoadGraph *graph, void *data);
+
+//---------------------------------------------------------------------------
+class LoadGraph
+{
+	//Data Members
+	//-------------
+	protected:
+		LoadGraphState		*state;					//NULL unless the workers are running.
+
+	public:
+		static LoadGraph	*active;				//Graph File::open and PacketFile::readPacket look in.
+
+	//Member Functions
+	//----------------
+	public:
+
+		void init (void)
+		{
+			state = NULL;
+		}
+
+		LoadGraph (void)
+		{
+			init();
+		}
+
+		~LoadGraph (void)
+		{
+			destroy();
+		}
+
+		//-----------------------------------------------------------------
+		// numThreads < 0 uses a thread per core but one.  Returns false,
+		// and leaves the graph stopped, if that comes to no threads at all.
+		bool start (long numThreads = -1);
+
+		//-----------------------------------------------------------------
+		// Finishes every task, stops the workers and frees whatever was
+		// prefetched but never read.
+		void destroy (void);
+
+		bool isRunning (void)
+		{
+			return(state != NULL);
+		}
+
+		//-----------------------------------------------------------------
+		// Returns the task's id for use as a dependency, or -1 when the
+		// graph is stopped, in which case the task has already been run
+		// right here.  Dependencies of -1 are ignored.  May be called from
+		// tasks.
+		long addTask (LoadTaskFunc func, void *data, bool mainThread = false, long numDeps = 0, const long *deps = NULL);
+
+		//-----------------------------------------------------------------
+		// The prefetched image is freed after numUses reads, or kept until
+		// destroy when numUses is 0.  Asking for the same file or packet
+		// again just returns the task already reading it.
+		long prefetchFile (const char *fileName, long numUses = 1);
+		long prefetchPacket (PacketFile *file, long packet, long numUses = 1);
+
+		//-----------------------------------------------------------------
+		// For tasks which depend on the prefetch of this packet.  The data
+		// stays valid until destroy and does not count as a use.
+		MemoryPtr getPacketData (PacketFile *file, long packet, long &size);
+
+		//-----------------------------------------------------------------
+		// Runs the mainThread tasks which are ready and returns.
+		void runMainTasks (void);
+
+		//-----------------------------------------------------------------
+		// Runs and waits for every task, advancing progress by
+		// progressRange as they complete.
+		void waitAll (volatile float &progress, float progressRange);
+
+		//-----------------------------------------------------------------
+		// Hooks for File and PacketFile.  Copy the prefetched image into
+		// buffer and return true, or return false to have the caller read
+		// it the usual way.
+		static bool copyFile (const char *fileName, MemoryPtr buffer, long size);
+		static bool copyPacket (PacketFile *file, long packet, MemoryPtr buffer, long size);
+};
+
+//---------------------------------------------------------------------------
+#endif
@@ -26,6 +26,10 @@
 #include"timing.h"
 #endif
 
+#include<thread>
+#include<atomic>
+#include<vector>
+
 //---------------------------------------------------------------------------
 // c'tors for postCompVertex
 PostcompVertex& PostcompVertex::operator=( const PostcompVertex& src )
@@ -136,6 +140,7 @@ void MapData::newInit (long numVertices)
 		pTmp++;
 	}
 
+	normalsValid = false;
 	Terrain::recalcLight = true;
 	Terrain::recalcShadows = false;
 	
@@ -148,6 +153,7 @@ void MapData::newInit (PacketFile* newFile, long numVertices)
 	newInit( numVertices );
 
 	newFile->readPacket(newFile->getCurrentPacket(), (MemoryPtr)blocks );
+	normalsValid = false;
 
 	calcTransitions();
 }
@@ -366,7 +372,11 @@ float SCROLL_RATE =	0.005f;
 //---------------------------------------------------------------------------
 void MapData::setVertexHeight( int VertexIndex, float Val )
 {
-	blocks[VertexIndex].elevation = Val;
+	if (blocks[VertexIndex].elevation != Val)
+	{
+		blocks[VertexIndex].elevation = Val;
+		normalsValid = false;
+	}
 }
 
 
@@ -377,30 +387,100 @@ float MapData::getVertexHeight( int VertexIndex )
 }
 
 #define ContrastEnhance 1.0f
+#define LIGHT_BAND_ROWS		16			//Rows of vertices a lighting thread takes at a time
+//---------------------------------------------------------------------------
+struct LightBandJob
+{
+	MapData				*map;
+	Stuff::Vector3D		lightDir;
+	bool				doNormals;
+	bool				doShadows;
+	long				numRows;
+	std::atomic<long>	nextBand;
+};
+
+//---------------------------------------------------------------------------
+static void calcLightWorker (LightBandJob *job)
+{
+	//-------------------------------------------------------------
+	// Bands are handed out one at a time because the shadow rays
+	// cost far more on the hilly parts of the map than the flat.
+	long band;
+	while ((band = job->nextBand++) * LIGHT_BAND_ROWS < job->numRows)
+	{
+		long firstRow = band * LIGHT_BAND_ROWS;
+		long lastRow = firstRow + LIGHT_BAND_ROWS;
+		if (lastRow > job->numRows)
+			lastRow = job->numRows;
+
+		job->map->calcLightRows(firstRow,lastRow,job->lightDir,job->doNormals,job->doShadows);
+	}
+}
+
 //---------------------------------------------------------------------------
 void MapData::calcLight (void)
 {
 	Terrain::recalcLight = false;
 
+	//----------------------------------------------------------------
+	// Normals only depend on the elevations and the sun direction and
+	// colour are applied per frame in TerrainQuad::setupTextures, so
+	// unless a height changed or shadows were asked for there is
+	// nothing to redo here.
+	bool doNormals = !normalsValid;
+	bool doShadows = Terrain::recalcShadows;
+	if (!doNormals && !doShadows)
+		return;
+
+	LightBandJob job;
+	job.map = this;
+	job.lightDir.x = job.lightDir.y = 0.0f;
+	job.lightDir.z = 1.0f;
+	
+	if (eye)
+		job.lightDir = eye->lightDirection;
+		
+	job.lightDir *= 64.0f;
+	job.doNormals = doNormals;
+	job.doShadows = doShadows;
+	job.numRows = Terrain::verticesBlockSide * Terrain::blocksMapSide;
+	job.nextBand = 0;
+
+	//--------------------------------------------------------------
+	// Each vertex only writes its own normal and shadow and only
+	// reads elevations, so the rows can go to as many threads as
+	// we have.
+	long numBands = (job.numRows + LIGHT_BAND_ROWS - 1) / LIGHT_BAND_ROWS;
+	long numThreads = std::thread::hardware_concurrency();
+	if (numThreads > numBands)
+		numThreads = numBands;
+
+	std::vector<std::thread> workers;
+	for (long i=1;i<numThreads;i++)
+		workers.push_back(std::thread(calcLightWorker,&job));
+
+	calcLightWorker(&job);
+
+	for (long i=0;i<(long)workers.size();i++)
+		workers[i].join();
+
+	normalsValid = true;
+	Terrain::recalcShadows = false;
+}
+
+//---------------------------------------------------------------------------
+void MapData::calcLightRows (long firstRow, long lastRow, const Stuff::Vector3D &lightDir, bool doNormals, bool doShadows)
+{
 	//----------------------------------------
 	// Let's calc the map dimensions...
 	long height, width;
 	height = width = Terrain::verticesBlockSide * Terrain::blocksMapSide;
 	long totalVertices = height * width;
 
-	Stuff::Vector3D lightDir;
-	lightDir.x = lightDir.y = 0.0f;
-	lightDir.z = 1.0f;
-	
-	if (eye)
-		lightDir = eye->lightDirection;
-		
-	lightDir *= 64.0f;
-	
 	//---------------------
 	//Lighting Pass Here
-	PostcompVertexPtr currentVertex = blocks;
-	for (long i=0;i<totalVertices;i++)
+	PostcompVertexPtr currentVertex = blocks + firstRow * width;
+	for (long i=firstRow * width;i<lastRow * width;i++)
 	{
 		long diskMapIndex = i;
 
@@ -444,7 +524,7 @@ void MapData::calcLight (void)
 
 			//-----------------------------------------------------
 			// Try and project shadow lines.
-			if (Terrain::recalcShadows)
+			if (doShadows)
 			{
 				Stuff::Vector3D vertexPos;
 				vertexPos.x = ((float(x) * Terrain::worldUnitsPerVertex) + Terrain::mapTopLeft3d.x);
@@ -470,144 +550,145 @@ void MapData::calcLight (void)
 				}
 			}
 				
-			Stuff::Vector3D		normals[8];
-			Stuff::Vector3D		triVect[2];
+			if (doNormals)
+			{
+				Stuff::Vector3D		normals[8];
+				Stuff::Vector3D		triVect[2];
 			
-			//-------------------------------------
-			// Tri 021
-			triVect[0].x = 0.0;
-			triVect[0].y = Terrain::worldUnitsPerVertex;
-			triVect[0].z = (v2->getElevation() - v0->getElevation()) * ContrastEnhance;
+				//-------------------------------------
+				// Tri 021
+				triVect[0].x = 0.0;
+				triVect[0].y = Terrain::worldUnitsPerVertex;
+				triVect[0].z = (v2->getElevation() - v0->getElevation()) * ContrastEnhance;
 			
-			triVect[1].x = -Terrain::worldUnitsPerVertex;
-			triVect[1].y = Terrain::worldUnitsPerVertex;
-			triVect[1].z = (v1->getElevation() - v0->getElevation()) * ContrastEnhance;
+				triVect[1].x = -Terrain::worldUnitsPerVertex;
+				triVect[1].y = Terrain::worldUnitsPerVertex;
+				triVect[1].z = (v1->getElevation() - v0->getElevation()) * ContrastEnhance;
 			
-			normals[0].Cross(triVect[0],triVect[1]);
-			gosASSERT(normals[0].z > 0.0);
+				normals[0].Cross(triVect[0],triVect[1]);
+				gosASSERT(normals[0].z > 0.0);
 			
-			normals[0].Normalize(normals[0]);
+				normals[0].Normalize(normals[0]);
 			
-			//-------------------------------------
-			// Tri 032
-			triVect[0].x = Terrain::worldUnitsPerVertex;
-			triVect[0].y = 0.0;
-			triVect[0].z = (v3->getElevation() - v0->getElevation()) * ContrastEnhance;
+				//-------------------------------------
+				// Tri 032
+				triVect[0].x = Terrain::worldUnitsPerVertex;
+				triVect[0].y = 0.0;
+				triVect[0].z = (v3->getElevation() - v0->getElevation()) * ContrastEnhance;
 			
-			triVect[1].x = 0.0;
-			triVect[1].y = Terrain::worldUnitsPerVertex;
-			triVect[1].z = (v2->getElevation() - v0->getElevation()) * ContrastEnhance;
+				triVect[1].x = 0.0;
+				triVect[1].y = Terrain::worldUnitsPerVertex;
+				triVect[1].z = (v2->getElevation() - v0->getElevation()) * ContrastEnhance;
 			
-			normals[1].Cross(triVect[0],triVect[1]);
-			gosASSERT(normals[1].z > 0.0);
+				normals[1].Cross(triVect[0],triVect[1]);
+				gosASSERT(normals[1].z > 0.0);
 			
-			normals[1].Normalize(normals[1]);
+				normals[1].Normalize(normals[1]);
 			
-			//-------------------------------------
-			// Tri 043
-			triVect[0].x = Terrain::worldUnitsPerVertex;
-			triVect[0].y = -Terrain::worldUnitsPerVertex;
-			triVect[0].z = (v4->getElevation() - v0->getElevation()) * ContrastEnhance;
-
-			triVect[1].x = Terrain::worldUnitsPerVertex;
-			triVect[1].y = 0.0;
-			triVect[1].z = (v3->getElevation() - v0->getElevation()) * ContrastEnhance;
+				//-------------------------------------
+				// Tri 043
+				triVect[0].x = Terrain::worldUnitsPerVertex;
+				triVect[0].y = -Terrain::worldUnitsPerVertex;
+				triVect[0].z = (v4->getElevation() - v0->getElevation()) * ContrastEnhance;
+
+				triVect[1].x = Terrain::worldUnitsPerVertex;
+				triVect[1].y = 0.0;
+				triVect[1].z = (v3->getElevation() - v0->getElevation()) * ContrastEnhance;
 			
 		
-			normals[2].Cross(triVect[0],triVect[1]);
-			gosASSERT(normals[2].z > 0.0);
+				normals[2].Cross(triVect[0],triVect[1]);
+				gosASSERT(normals[2].z > 0.0);
 			
-			normals[2].Normalize(normals[2]);
+				normals[2].Normalize(normals[2]);
 			
-			//-------------------------------------
-			// Tri 054
-			triVect[0].x = 0.0;
-			triVect[0].y = -Terrain::worldUnitsPerVertex;
-			triVect[0].z = (v5->getElevation() - v0->getElevation()) * ContrastEnhance;
+				//-------------------------------------
+				// Tri 054
+				triVect[0].x = 0.0;
+				triVect[0].y = -Terrain::worldUnitsPerVertex;
+				triVect[0].z = (v5->getElevation() - v0->getElevation()) * ContrastEnhance;
 			
-			triVect[1].x = Terrain::worldUnitsPerVertex;
-			triVect[1].y = -Terrain::worldUnitsPerVertex;
-			triVect[1].z = (v4->getElevation() - v0->getElevation()) * ContrastEnhance;
+				triVect[1].x = Terrain::worldUnitsPerVertex;
+				triVect[1].y = -Terrain::worldUnitsPerVertex;
+				triVect[1].z = (v4->getElevation() - v0->getElevation()) * ContrastEnhance;
 			
-			normals[3].Cross(triVect[0],triVect[1]);
-			gosASSERT(normals[3].z > 0.0);
+				normals[3].Cross(triVect[0],triVect[1]);
+				gosASSERT(normals[3].z > 0.0);
 			
-			normals[3].Normalize(normals[3]);
+				normals[3].Normalize(normals[3]);
 				
-			//-------------------------------------
-			// Tri 065
-			triVect[0].x = -Terrain::worldUnitsPerVertex;
-			triVect[0].y = 0.0;
-			triVect[0].z = (v6->getElevation() - v0->getElevation()) * ContrastEnhance;
+				//-------------------------------------
+				// Tri 065
+				triVect[0].x = -Terrain::worldUnitsPerVertex;
+				triVect[0].y = 0.0;
+				triVect[0].z = (v6->getElevation() - v0->getElevation()) * ContrastEnhance;
 			
-			triVect[1].x = 0.0;
-			triVect[1].y = -Terrain::worldUnitsPerVertex;
-			triVect[1].z = (v5->getElevation() - v0->getElevation()) * ContrastEnhance;
+				triVect[1].x = 0.0;
+				triVect[1].y = -Terrain::worldUnitsPerVertex;
+				triVect[1].z = (v5->getElevation() - v0->getElevation()) * ContrastEnhance;
 			
-			normals[4].Cross(triVect[0],triVect[1]);
-			gosASSERT(normals[4].z > 0.0);
+				normals[4].Cross(triVect[0],triVect[1]);
+				gosASSERT(normals[4].z > 0.0);
 			
-			normals[4].Normalize(normals[4]);
+				normals[4].Normalize(normals[4]);
 			
-			//-------------------------------------
-			// Tri 076
-			triVect[0].x = -Terrain::worldUnitsPerVertex;
-			triVect[0].y = 0.0;
-			triVect[0].z = (v7->getElevation() - v0->getElevation()) * ContrastEnhance;
+				//-------------------------------------
+				// Tri 076
+				triVect[0].x = -Terrain::worldUnitsPerVertex;
+				triVect[0].y = 0.0;
+				triVect[0].z = (v7->getElevation() - v0->getElevation()) * ContrastEnhance;
 			
-			triVect[1].x = 0.0;
-			triVect[1].y = -Terrain::worldUnitsPerVertex;
-			triVect[1].z = (v6->getElevation() - v0->getElevation()) * ContrastEnhance;
+				triVect[1].x = 0.0;
+				triVect[1].y = -Terrain::worldUnitsPerVertex;
+				triVect[1].z = (v6->getElevation() - v0->getElevation()) * ContrastEnhance;
 			
-			normals[5].Cross(triVect[0],triVect[1]);
-			gosASSERT(normals[5].z > 0.0);
+				normals[5].Cross(triVect[0],triVect[1]);
+				gosASSERT(normals[5].z > 0.0);
 			
-			normals[5].Normalize(normals[5]);
+				normals[5].Normalize(normals[5]);
 	
-			//-------------------------------------
-			// Tri 087
-			triVect[0].x = -Terrain::worldUnitsPerVertex;
-			triVect[0].y = 0.0;
-			triVect[0].z = (v8->getElevation() - v0->getElevation()) * ContrastEnhance;
+				//-------------------------------------
+				// Tri 087
+				triVect[0].x = -Terrain::worldUnitsPerVertex;
+				triVect[0].y = 0.0;
+				triVect[0].z = (v8->getElevation() - v0->getElevation()) * ContrastEnhance;
 			
-			triVect[1].x = 0.0;
-			triVect[1].y = -Terrain::worldUnitsPerVertex;
-			triVect[1].z = (v7->getElevation() - v0->getElevation()) * ContrastEnhance;
+				triVect[1].x = 0.0;
+				triVect[1].y = -Terrain::worldUnitsPerVertex;
+				triVect[1].z = (v7->getElevation() - v0->getElevation()) * ContrastEnhance;
 			
-			normals[6].Cross(triVect[0],triVect[1]);
-			gosASSERT(normals[6].z > 0.0);
+				normals[6].Cross(triVect[0],triVect[1]);
+				gosASSERT(normals[6].z > 0.0);
 			
-			normals[6].Normalize(normals[6]);
+				normals[6].Normalize(normals[6]);
 	
-			//-------------------------------------
-			// Tri 018
-			triVect[0].x = -Terrain::worldUnitsPerVertex;
-			triVect[0].y = Terrain::worldUnitsPerVertex;
-			triVect[0].z = (v1->getElevation() - v0->getElevation()) * ContrastEnhance;
+				//-------------------------------------
+				// Tri 018
+				triVect[0].x = -Terrain::worldUnitsPerVertex;
+				triVect[0].y = Terrain::worldUnitsPerVertex;
+				triVect[0].z = (v1->getElevation() - v0->getElevation()) * ContrastEnhance;
 			
-			triVect[1].x = -Terrain::worldUnitsPerVertex;
-			triVect[1].y = 0.0;
-			triVect[1].z = (v8->getElevation() - v0->getElevation()) * ContrastEnhance;
+				triVect[1].x = -Terrain::worldUnitsPerVertex;
+				triVect[1].y = 0.0;
+				triVect[1].z = (v8->getElevation() - v0->getElevation()) * ContrastEnhance;
 			
-			normals[7].Cross(triVect[0],triVect[1]);
-			gosASSERT(normals[7].z > 0.0);
+				normals[7].Cross(triVect[0],triVect[1]);
+				gosASSERT(normals[7].z > 0.0);
 			
-			normals[7].Normalize(normals[7]);
+				normals[7].Normalize(normals[7]);
 			
-			currentVertex->vertexNormal.x = normals[0].x + normals[1].x + normals[2].x + normals[3].x + normals[4].x + normals[5].x + normals[6].x + normals[7].x;
-			currentVertex->vertexNormal.y = normals[0].y + normals[1].y + normals[2].y + normals[3].y + normals[4].y + normals[5].y + normals[6].y + normals[7].y;
-			currentVertex->vertexNormal.z = normals[0].z + normals[1].z + normals[2].z + normals[3].z + normals[4].z + normals[5].z + normals[6].z + normals[7].z;
-			currentVertex->vertexNormal.x /= 8.0;
-			currentVertex->vertexNormal.y /= 8.0;
-			currentVertex->vertexNormal.z /= 8.0;
-
-			gosASSERT(currentVertex->vertexNormal.z > 0.0);
+				currentVertex->vertexNormal.x = normals[0].x + normals[1].x + normals[2].x + normals[3].x + normals[4].x + normals[5].x + normals[6].x + normals[7].x;
+				currentVertex->vertexNormal.y = normals[0].y + normals[1].y + normals[2].y + normals[3].y + normals[4].y + normals[5].y + normals[6].y + normals[7].y;
+				currentVertex->vertexNormal.z = normals[0].z + normals[1].z + normals[2].z + normals[3].z + normals[4].z + normals[5].z + normals[6].z + normals[7].z;
+				currentVertex->vertexNormal.x /= 8.0;
+				currentVertex->vertexNormal.y /= 8.0;
+				currentVertex->vertexNormal.z /= 8.0;
+
+				gosASSERT(currentVertex->vertexNormal.z > 0.0);
+			}
 		}
 
 		currentVertex++;
 	}
-	
-	Terrain::recalcShadows = false;
 }	
 
 //---------------------------------------------------------------------------
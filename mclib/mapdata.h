@@ -69,6 +69,7 @@ class MapData : public HeapManager
 		PostcompVertexPtr			blocks;
 		PostcompVertexPtr			blankVertex;
 		int							hasSelection;
+		bool						normalsValid;			//Vertex normals match the elevations.  Cleared when a height changes
 									
 	public:
 		Stuff::Vector2DOf<float>	topLeftVertex;
@@ -97,6 +98,8 @@ class MapData : public HeapManager
 
 			hasSelection = false;
 
+			normalsValid = false;
+
 			shallowDepth = 0.0f;
 			waterDepth = 0.0f;
 			alphaDepth = 0.0f;
@@ -129,7 +132,10 @@ class MapData : public HeapManager
 			return topLeftVertex;
 		}
 
+		//Recomputes vertex normals if the elevations changed and shadows if Terrain::recalcShadows.
+		//Rows are split into bands across threads.
 		void calcLight (void);
+		void calcLightRows (long firstRow, long lastRow, const Stuff::Vector3D &lightDir, bool doNormals, bool doShadows);
 		void clearShadows();
 		
 		float terrainElevation (const Stuff::Vector3D &position);
@@ -187,6 +187,10 @@
 #include"csvfile.h"
 #endif
 
+#ifndef LOADGRAPH_H
+#include"loadgraph.h"
+#endif
+
 #ifndef GENACTOR_H
 #include"genactor.h"
 #endif
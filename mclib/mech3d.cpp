@@ -78,6 +78,10 @@
 #include"gvactor.h"
 #endif
 
+#ifndef LOADGRAPH_H
+#include"loadgraph.h"
+#endif
+
 //-------------------------------------------------------------------------------
 // Static Globals
 extern float worldUnitsPerMeter;
@@ -182,8 +186,123 @@ extern int ObjectTextureSize;
 
 bool Mech3DAppearanceType::animationLoadingEnabled = true;
 
+//-------------------------------------------------------------------------------
+// The shape loaders open the binary named after the .ase they are given, once
+// to check its version and once more to load it.
+static void PrefetchShape (LoadGraph *graph, const char *shapeName, const char *binaryExt, long numLoads)
+{
+	FullPathFileName aseName;
+	aseName.init(tglPath,shapeName,".ase");
+
+	char drive[MAX_PATH];
+	char dir[MAX_PATH];
+	char name[MAX_PATH];
+	char ext[MAX_PATH];
+	_splitpath(aseName,drive,dir,name,ext);
+
+	FullPathFileName binaryName;
+	binaryName.init(tglPath,name,binaryExt);
+
+	graph->prefetchFile(binaryName,numLoads * 2);
+}
+
+//-------------------------------------------------------------------------------
+// Runs on the main thread once the .ini is in.  Only the .ini knows the names
+// of the body and shadow shapes.
+static void PrefetchMechShapes (LoadGraph *graph, void *data)
+{
+	char *fileName = (char *)data;
+
+	FullPathFileName mechIniName;
+	mechIniName.init(tglPath,fileName,".ini");
+
+	FitIniFile mechFile;
+	if ((mechFile.open(mechIniName) == NO_ERR) && (mechFile.seekBlock("TGLData") == NO_ERR))
+	{
+		char aseFileName[512];
+		if (mechFile.readIdString("FileName",aseFileName,511) == NO_ERR)
+		{
+			PrefetchShape(graph,aseFileName,".tgl",1);
+		}
+		else
+		{
+			for (long i=0;i<MAX_LODS;i++)
+			{
+				char baseName[256];
+				sprintf(baseName,"FileName%d",i);
+
+				if (mechFile.readIdString(baseName,aseFileName,511) == NO_ERR)
+					PrefetchShape(graph,aseFileName,".tgl",1);
+			}
+		}
+
+		if (mechFile.readIdString("ShadowName",aseFileName,511) == NO_ERR)
+			PrefetchShape(graph,aseFileName,".tgl",1);
+	}
+
+	systemHeap->Free(fileName);
+}
+
 //-------------------------------------------------------------------------------
 // class Mech3DAppearanceType
+void Mech3DAppearanceType::prefetch (LoadGraph *graph, const char *fileName)
+{
+	if (!graph || !graph->isRunning() || !fileName)
+		return;
+
+	//--------------------------------------------------------------
+	// The .ini is read here by PrefetchMechShapes and again by init.
+	FullPathFileName mechIniName;
+	mechIniName.init(tglPath,fileName,".ini");
+
+	long iniTask = graph->prefetchFile(mechIniName,2);
+
+	char *iniFileName = (char *)systemHeap->Malloc(strlen(fileName) + 1);
+	gosASSERT(iniFileName != NULL);
+	strcpy(iniFileName,fileName);
+
+	graph->addTask(PrefetchMechShapes,iniFileName,true,1,&iniTask);
+
+	char shapeName[1024];
+	sprintf(shapeName,"%sLeftArm",fileName);
+	PrefetchShape(graph,shapeName,".tgl",1);
+
+	sprintf(shapeName,"%sRightArm",fileName);
+	PrefetchShape(graph,shapeName,".tgl",1);
+
+	//--------------------------------------------------------
+	// init loads the forward damage shape for both directions.
+	sprintf(shapeName,"%sFallForwardDam",fileName);
+	PrefetchShape(graph,shapeName,".tgl",2);
+
+	if (animationLoadingEnabled)
+	{
+		//------------------------------------------------------
+		// Several gestures share an animation, count its loads.
+		for (long i=0;i<MAX_ANIMATION_FILES;i++)
+		{
+			bool firstUse = true;
+			long numLoads = 1;
+			for (long j=0;j<MAX_ANIMATION_FILES;j++)
+			{
+				if ((j != i) && (S_stricmp(MechAnimationNames[j],MechAnimationNames[i]) == 0))
+				{
+					if (j < i)
+						firstUse = false;
+					numLoads++;
+				}
+			}
+
+			if (!firstUse)
+				continue;
+
+			sprintf(shapeName,"%s%s",fileName,MechAnimationNames[i]);
+			PrefetchShape(graph,shapeName,".agl",numLoads);
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------
 void Mech3DAppearanceType::init (const char * fileName)
 {
 	AppearanceType::init(fileName);
@@ -2864,7 +2983,6 @@ long Mech3DAppearance::renderShadows (void)
 bool oneMechPlease = false;
 #ifdef LAB_ONLY
 __int64 MCTimeAnimationCalc = 0;
-__int64 x;
 #endif
 
 //-----------------------------------------------------------------------------
@@ -2970,9 +3088,8 @@ void Mech3DAppearance::setObjStatus (long oStatus)
 //-----------------------------------------------------------------------------
 void Mech3DAppearance::updateGeometry (void)
 {
-	#ifdef LAB_ONLY
-	x=GetCycles();
-	#endif
+	GOS_PROFILE_STAT("Mech3DAppearance::updateGeometry",MCTimeAnimationCalc);
+
 	//Always override with our local instance.
 	mechShape->SetTextureHandle(0,localTextureHandle);
 	
@@ -3647,11 +3764,6 @@ void Mech3DAppearance::updateGeometry (void)
 			isDusting = false;
 		}
 	}
-	 
-	#ifdef LAB_ONLY
-	x=GetCycles()-x;
-	MCTimeAnimationCalc += x;
-	#endif
 }	
 
 #ifdef _DEBUG
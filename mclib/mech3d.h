@@ -99,6 +99,9 @@ typedef PaintSchemata *PaintSchemataPtr;
 
 extern char MechStateByGesture[];
 
+//-------------------------------------------------------------------------------
+class LoadGraph;
+
 //-------------------------------------------------------------------------------
 // class Mech3DAppearance
 class Mech3DAppearanceType: public AppearanceType
@@ -188,6 +191,10 @@ class Mech3DAppearanceType: public AppearanceType
 		}
 		
 		virtual void init (const char *fileName);
+
+		//-------------------------------------------------------------
+		// Has graph read ahead the files init(fileName) is going to open.
+		static void prefetch (LoadGraph *graph, const char *fileName);
 		
 		long getTotalNodes (void)
 		{
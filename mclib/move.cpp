@@ -24,10 +24,17 @@
 #endif
 #endif
 
+#include<atomic>
+
 //***************************************************************************
 
 #define	USE_SEPARATE_WATER_MAPS	FALSE
 
+//---------------------------------------------------------------------------
+// The jump and escape searches use row * MAX_MAPWIDTH + col as the open
+// list id, rather than the cell index.
+#define MAX_MAPWIDTH		1000
+
 #ifndef TEAM_H
 typedef enum {
 	RELATION_FRIENDLY,
@@ -70,6 +77,16 @@ long RamObjectWID = 0;
 PriorityQueuePtr openList = NULL;
 bool JumpOnBlocked = false;
 bool FindingEscapePath = false;
+
+//---------------------------------------------------------------------------
+// UseJumpPointSearch makes movers ask for MOVEPARAM_JUMP_POINTS. With
+// JumpPointCheck on, every jump point search is followed by the old search
+// (whose path is the one used) and JumpPointWorse counts the paths the jump
+// point search missed or found a costlier way for.
+bool UseJumpPointSearch = false;
+bool JumpPointCheck = false;
+long JumpPointChecks = 0;
+long JumpPointWorse = 0;
 bool BlockWallTiles = true;
 MissionMapPtr GameMap = NULL;
 GlobalMapPtr GlobalMoveMap[3] = {NULL, NULL, NULL};
@@ -314,7 +331,6 @@ char TeamRelations[MAX_TEAMS][MAX_TEAMS] = {
 bool GoalIsDoor = false;
 long numNodesVisited = 0;
 long topOpenNodes = 0;
-long MaxHPrime = 1000;
 bool PreserveMapTiles = false;
 
 MoveMapPtr PathFindMap[2] = {NULL, NULL};
@@ -326,7 +342,6 @@ int MoveMap::forestCost = 50;
 #ifdef LAB_ONLY
 __int64 MCTimeCalcPath1Update = 0;
 __int64 MCTimeCalcPath2Update = 0;
-__int64 MCTimeCalcPath3Update = 0;
 __int64 MCTimeCalcPath4Update = 0;
 __int64 MCTimeCalcPath5Update = 0;
 #endif
@@ -828,6 +843,7 @@ void MissionMap::init (long h, long w) {
 	for (int i = 0; i < width; i++)
 		Terrain::cellColToWorldCoord[i] = (i * Terrain::worldUnitsPerCell) - (Terrain::worldUnitsMapSide / 2.0);
 
+	destroyMoveClasses();
 	if (map) {
 		systemHeap->Free(map);
 		map = NULL;
@@ -916,6 +932,7 @@ long MissionMap::init (long cellHeight, long cellWidth, long curPlanet, MissionM
 
 	//---------------------------------------------------------------------------
 	// Be damned sure map is empty.  This is required or mines will NOT go away.
+	destroyMoveClasses();
 	memset(map, 0, sizeof(MapCell) * width * height);
 
 	long terrainTypes[1024];
@@ -1001,11 +1018,8 @@ void MissionMap::setPassable (long row, long col, char* footPrint, bool passable
 	long c = col + *data++;
 	long len = *data++;
 	while (len != -1) {
-		MapCellPtr cell = &map[r * width + c];
-		for (long i = 0; i < len; i++) {
-			cell->setPassable(passable);
-			cell++;
-		}
+		for (long i = 0; i < len; i++)
+			setPassable(r, c + i, passable);
 		r = row + *data++;
 		c = col + *data++;
 		len = *data++;
@@ -1025,7 +1039,7 @@ void MissionMap::spreadState (long cellRow, long cellCol, long radius) {
 		// preserve the cell states of this tile...
 		if (!getPreserved(cellRow, cellCol))
 			setPreserved(cellRow, cellCol, true);
-		map[cellRow * width + cellCol].setPassable(false);
+		setPassable(cellRow, cellCol, false);
 		for (long dir = 0; dir < NUM_DIRECTIONS; dir++) {
 			long adjR = cellRow;
 			long adjC = cellCol;
@@ -1235,8 +1249,139 @@ void MissionMap::print (char* fileName) {
 
 //---------------------------------------------------------------------------
 
+void MissionMap::buildLOSHeights (void) {
+
+	destroyLOSHeights();
+
+	long tilesHigh = height / MAPCELL_DIM;
+	losTilesWide = width / MAPCELL_DIM;
+	losBlocksWide = (width + LOS_BLOCK_DIM - 1) / LOS_BLOCK_DIM;
+	losBlocksHigh = (height + LOS_BLOCK_DIM - 1) / LOS_BLOCK_DIM;
+
+	losTileHeight = (float*)systemHeap->Malloc(sizeof(float) * losTilesWide * tilesHigh);
+	gosASSERT(losTileHeight != NULL);
+	losBlockHeight = (float*)systemHeap->Malloc(sizeof(float) * losBlocksWide * losBlocksHigh);
+	gosASSERT(losBlockHeight != NULL);
+
+	//------------------------------------------------------------------
+	// terrainElevation is a plane through three of the tile's corners,
+	// so it never gets above the highest one.  Off the map and along
+	// the far edges it returns zero instead, so zero is always allowed.
+	long lastVertex = Terrain::realVerticesMapSide - 1;
+	for (long tileR = 0; tileR < tilesHigh; tileR++) {
+		for (long tileC = 0; tileC < losTilesWide; tileC++) {
+			float tileHeight = 0.0f;
+			for (long r = tileR; (r <= (tileR + 1)) && (r <= lastVertex); r++)
+				for (long c = tileC; (c <= (tileC + 1)) && (c <= lastVertex); c++) {
+					float elevation = land->getTerrainElevation(r, c);
+					if (elevation > tileHeight)
+						tileHeight = elevation;
+				}
+			losTileHeight[tileR * losTilesWide + tileC] = tileHeight + LOS_HEIGHT_SLOP;
+		}
+	}
+
+	for (long blockR = 0; blockR < losBlocksHigh; blockR++)
+		for (long blockC = 0; blockC < losBlocksWide; blockC++)
+			losBlockHeight[blockR * losBlocksWide + blockC] = calcLOSBlockHeight(blockR, blockC);
+}
+
+//---------------------------------------------------------------------------
+
+void MissionMap::destroyLOSHeights (void) {
+
+	if (losTileHeight) {
+		systemHeap->Free(losTileHeight);
+		losTileHeight = NULL;
+	}
+
+	if (losBlockHeight) {
+		systemHeap->Free(losBlockHeight);
+		losBlockHeight = NULL;
+	}
+
+	losTilesWide = 0;
+	losBlocksWide = 0;
+	losBlocksHigh = 0;
+}
+
+//---------------------------------------------------------------------------
+
+float MissionMap::calcLOSBlockHeight (long blockRow, long blockCol) {
+
+	long lastRow = (blockRow + 1) * LOS_BLOCK_DIM;
+	if (lastRow > height)
+		lastRow = height;
+	long lastCol = (blockCol + 1) * LOS_BLOCK_DIM;
+	if (lastCol > width)
+		lastCol = width;
+
+	//--------------------------------------------------------------
+	// Same sum Team::lineOfSight does per cell, so the block height
+	// can never come out below one of its cells.
+	float blockHeight = -3.402823466e+38f;
+	for (long row = blockRow * LOS_BLOCK_DIM; row < lastRow; row++)
+		for (long col = blockCol * LOS_BLOCK_DIM; col < lastCol; col++) {
+			float localElev = (worldUnitsPerMeter * 4.0f * (float)map[row * width + col].getLocalHeight());
+			float cellHeight = losTileHeight[(row / MAPCELL_DIM) * losTilesWide + (col / MAPCELL_DIM)] + localElev;
+			if (cellHeight > blockHeight)
+				blockHeight = cellHeight;
+		}
+
+	return(blockHeight);
+}
+
+//---------------------------------------------------------------------------
+
+void MissionMap::updateLOSHeight (long row, long col) {
+
+	//------------------------------------------------------------
+	// Something was built or knocked down.  Growing only needs a
+	// max, shrinking means looking over the whole block again.
+	long block = (row / LOS_BLOCK_DIM) * losBlocksWide + (col / LOS_BLOCK_DIM);
+	float localElev = (worldUnitsPerMeter * 4.0f * (float)map[row * width + col].getLocalHeight());
+	float cellHeight = losTileHeight[(row / MAPCELL_DIM) * losTilesWide + (col / MAPCELL_DIM)] + localElev;
+	if (cellHeight >= losBlockHeight[block])
+		losBlockHeight[block] = cellHeight;
+	else
+		losBlockHeight[block] = calcLOSBlockHeight(row / LOS_BLOCK_DIM, col / LOS_BLOCK_DIM);
+}
+
+//---------------------------------------------------------------------------
+
+void MissionMap::buildMoveClasses (void) {
+
+	destroyMoveClasses();
+
+	long numCells = height * width;
+	for (long i = 0; i < NUM_MOVE_LEVELS; i++) {
+		moveClass[i] = (unsigned char*)systemHeap->Malloc(numCells);
+		gosASSERT(moveClass[i] != NULL);
+	}
+
+	for (long index = 0; index < numCells; index++)
+		for (long i = 0; i < NUM_MOVE_LEVELS; i++)
+			moveClass[i][index] = map[index].getMoveClass(i);
+}
+
+//---------------------------------------------------------------------------
+
+void MissionMap::destroyMoveClasses (void) {
+
+	for (long i = 0; i < NUM_MOVE_LEVELS; i++)
+		if (moveClass[i]) {
+			systemHeap->Free(moveClass[i]);
+			moveClass[i] = NULL;
+		}
+}
+
+//---------------------------------------------------------------------------
+
 void MissionMap::destroy (void) {
 
+	destroyLOSHeights();
+	destroyMoveClasses();
+
 	if (map) {
 		systemHeap->Free(map);
 		map = NULL;
@@ -1266,10 +1411,15 @@ void MovePath::operator delete (void* us) {
 long MovePath::init (long numberOfSteps) {
 
 	numSteps = numStepsWhenNotPaused = numberOfSteps;
-	static long maxNumberOfSteps = 0;
-	if (numberOfSteps > maxNumberOfSteps) {
-		maxNumberOfSteps = numberOfSteps;
-		return(maxNumberOfSteps);
+
+	//---------------------------------------------------------------
+	// Path searches call this from the path manager's threads, so the
+	// high mark is only raised by whichever of them gets there first.
+	static std::atomic<long> maxNumberOfSteps(0);
+	long prevMax = maxNumberOfSteps.load(std::memory_order_relaxed);
+	while (numberOfSteps > prevMax) {
+		if (maxNumberOfSteps.compare_exchange_weak(prevMax, numberOfSteps, std::memory_order_relaxed))
+			return(numberOfSteps);
 	}
 	for (int i = 0; i < MAX_STEPS_PER_MOVEPATH; i++) {
 		stepList[i].distanceToGoal = 0.0;
@@ -1483,9 +1633,7 @@ void GlobalMap::init (long w, long h) {
 	doors = NULL;
 	doorBuildList = NULL;
 	pathExistsTable = NULL;
-#ifdef USE_PATH_COST_TABLE
-	pathCostTable = NULL;
-#endif
+	clearPathCache();
 	blank = false;
 }
 
@@ -1538,12 +1686,7 @@ long GlobalMap::init (PacketFilePtr packetFile, long whichPacket) {
 		//---------------------------------------------------------
 		// Bad version map, so return number of packets but bail...
 		badLoad = true;
-#ifdef USE_PATH_COST_TABLE
-		pathCostTable = NULL;
-		return(14 + numDoorInfos + (numDoors + NUM_DOOR_OFFSETS) * 2);
-#else
 		return(13 + numDoorInfos + (numDoors + NUM_DOOR_OFFSETS) * 2);
-#endif
 	}
 
 	areaMap = (short*)systemHeap->Malloc(sizeof(short) * height * width);
@@ -1684,11 +1827,7 @@ long GlobalMap::write (PacketFilePtr packetFile, long whichPacket) {
 	for (long i = 0; i < numAreas; i++)
 		if (areas[i].numDoors)
 			numDrInfos++;
-#ifdef USE_PATH_COST_TABLE
-		long numPackets = 14 + numDrInfos + (numDoors + NUM_DOOR_OFFSETS) * 2;
-#else
-		long numPackets = 13 + numDrInfos + (numDoors + NUM_DOOR_OFFSETS) * 2;
-#endif
+	long numPackets = 13 + numDrInfos + (numDoors + NUM_DOOR_OFFSETS) * 2;
 
 	if (!packetFile)
 		return(numPackets);
@@ -1831,15 +1970,6 @@ long GlobalMap::write (PacketFilePtr packetFile, long whichPacket) {
 	if (numberL != numDoorLinks)
 		PAUSE(("Number of DoorLinks Calculated does not match numDoorLinks"));
 
-#ifdef USE_PATH_COST_TABLE
-	if (blank)
-		calcPathCostTable();
-	else
-		initPathCostTable();
-	result = packetFile->writePacket(whichPacket++, (unsigned char*)pathCostTable, numAreas * numAreas);
-	if (result <= 0)
-		Fatal(result, " GlobalMap.write: Unable to write doors packet ");
-#endif
 	return(numPackets);
 }
 
@@ -2581,6 +2711,11 @@ void GlobalMap::changeAreaLinkCost (long area, long cost) {
 		for (long j = 0; j < curDoor->numLinks[doorSide]; j++)
 			curDoor_links[doorSide][j].cost = cost;
 	}
+
+	//----------------------------------------------------------------
+	// A cheaper area may open up better routes for any cached path...
+	if (!pathCacheLocked)
+		clearPathCache();
 }
 
 //------------------------------------------------------------------------------------------
@@ -2679,7 +2814,6 @@ long GlobalMap::getPathCost (int startArea, int goalArea, bool withSpecialAreas,
 	if (startArea == goalArea)
 		return(1);
 
-#if 1
 	GlobalPathStep path[MAX_GLOBAL_PATH];
 	if (withSpecialAreas)
 		useClosedAreas = true;
@@ -2689,216 +2823,8 @@ long GlobalMap::getPathCost (int startArea, int goalArea, bool withSpecialAreas,
 	useClosedAreas = false;
 	confidence = GLOBAL_CONFIDENCE_GOOD;
 	return(cost);
-#else
-	calcedPathCost = false;
-	unsigned char data = pathCostTable[startArea * numAreas + goalArea];
-	if (withSpecialAreas) {
-		unsigned char cost = (data & 0x0C) >> 2;
-		if (data & GLOBAL_FLAG_SPECIAL_IMPOSSIBLE) {
-			cost = 0;
-			confidence = GLOBAL_CONFIDENCE_GOOD;
-			}
-		else if (data & GLOBAL_FLAG_SPECIAL_CALC) {
-			if (calcIt) {
-				GlobalPathStep path[MAX_GLOBAL_PATH];
-				useClosedAreas = true;
-				calcPath(startArea, goalArea, path);
-				useClosedAreas = false;
-				cost = getPathCost(startArea, goalArea, true, confidence, false);
-				calcedPathCost = true;
-				confidence = GLOBAL_CONFIDENCE_GOOD;
-				}
-			else
-				confidence = GLOBAL_CONFIDENCE_BAD;
-			}
-		else
-			confidence = GLOBAL_CONFIDENCE_GOOD;
-		return(cost);
-		}
-	else {
-		unsigned char cost = (data & 0x03);
-		if (data & GLOBAL_FLAG_SPECIAL_IMPOSSIBLE) {
-			cost = 0;
-			confidence = GLOBAL_CONFIDENCE_GOOD;
-			}
-		else if (data & GLOBAL_FLAG_NORMAL_CLOSES) {
-			if (calcIt) {
-				GlobalPathStep path[MAX_GLOBAL_PATH];
-				calcPath(startArea, goalArea, path);
-				cost = getPathCost(startArea, goalArea, false, confidence, false);
-				calcedPathCost = true;
-				confidence = GLOBAL_CONFIDENCE_GOOD;
-				}
-			else if (cost)
-				confidence = GLOBAL_CONFIDENCE_BAD;
-			else
-				confidence = GLOBAL_CONFIDENCE_GOOD;
-			}
-		else if (data & GLOBAL_FLAG_NORMAL_OPENS) {
-			if (calcIt) {
-				GlobalPathStep path[MAX_GLOBAL_PATH];
-				calcPath(startArea, goalArea, path);
-				cost = getPathCost(startArea, goalArea, false, confidence, false);
-				calcedPathCost = true;
-				confidence = GLOBAL_CONFIDENCE_GOOD;
-				}
-			else
-				confidence = GLOBAL_CONFIDENCE_AT_LEAST;
-			}
-		else
-			confidence = GLOBAL_CONFIDENCE_GOOD;
-		return(cost);
-	}
-	return(0);
-#endif
-}
-
-//---------------------------------------------------------------------------
-
-#if USE_PATH_COST_TABLE
-
-void GlobalMap::setPathFlag (long startArea, long goalArea, unsigned char flag, bool set) {
-
-	long index = startArea * numAreas + goalArea;
-	pathCostTable[index] &= (flag ^ 0xFF);
-	if (set)
-		pathCostTable[index] |= flag;
-}
-
-//---------------------------------------------------------------------------
-
-long GlobalMap::getPathFlag (long startArea, long goalArea, unsigned char flag) {
-
-	return(pathCostTable[startArea * numAreas + goalArea] & flag);
-}
-
-//---------------------------------------------------------------------------
-
-void GlobalMap::setPathCost (long startArea, long goalArea, bool withSpecialAreas, unsigned char cost) {
-
-	if (cost > 0) {
-		if (cost < 6) 
-			cost = 1;
-		else if (cost < 11)
-			cost = 2;
-		else
-			cost = 3;
-	}
-	long index = startArea * numAreas + goalArea;
-	if (withSpecialAreas) {
-		pathCostTable[index] &= 0xF3;
-		cost <<= 2;
-		}
-	else
-		pathCostTable[index] &= 0xFC;
-	pathCostTable[index] |= cost;
-}
-
-//------------------------------------------------------------------------------------------
-
-void GlobalMap::initPathCostTable (void) {
-
-	if (pathCostTable) {
-		systemHeap->Free(pathCostTable);
-		pathCostTable = NULL;
-	}
-
-	long oldNumAreas = numAreas;
-//	if (numAreas > 600)
-//		numAreas = 600;
-
-	pathCostTable = (unsigned char*)systemHeap->Malloc(numAreas * numAreas);
-	gosASSERT(pathCostTable != NULL);
-
-	for (long startArea = 0; startArea < numAreas; startArea++)
-		for (goalArea = 0; goalArea < numAreas; goalArea++) {
-			setPathCost(startArea, goalArea, false, 0);
-			setPathCost(startArea, goalArea, true, 0);
-			setPathFlag(startArea, goalArea, GLOBAL_FLAG_SPECIAL_IMPOSSIBLE, false);
-			setPathFlag(startArea, goalArea, GLOBAL_FLAG_SPECIAL_CALC, true);
-			setPathFlag(startArea, goalArea, GLOBAL_FLAG_NORMAL_OPENS, true);
-			setPathFlag(startArea, goalArea, GLOBAL_FLAG_NORMAL_CLOSES, true);
-		}
-	closes = false;
-	opens = false;
-
-	numAreas = oldNumAreas;
-}
-
-//------------------------------------------------------------------------------------------
-
-void GlobalMap::resetPathCostTable (void) {
-
-	if (!pathCostTable)
-		return;
-
-	if (!closes && !opens)
-		return;
-
-	for (long startArea = 0; startArea < numAreas; startArea++)
-		for (goalArea = 0; goalArea < numAreas; goalArea++) {
-			setPathFlag(startArea, goalArea, GLOBAL_FLAG_NORMAL_OPENS, opens);
-			setPathFlag(startArea, goalArea, GLOBAL_FLAG_NORMAL_CLOSES, closes);
-		}
-	closes = false;
-	opens = false;
-
-}
-
-//------------------------------------------------------------------------------------------
-
-void GlobalMap::calcPathCostTable (void) {
-
-	if (pathCostTable) {
-		systemHeap->Free(pathCostTable);
-		pathCostTable = NULL;
-	}
-	pathCostTable = (unsigned char*)systemHeap->Malloc(numAreas * numAreas);
-	gosASSERT(pathCostTable != NULL);
-
-	for (long i = 0; i < numAreas; i++)
-		openArea(i);
-
-	GlobalPathStep globalPath[MAX_GLOBAL_PATH];
-	for (long startArea = 0; startArea < numAreas; startArea++)
-		for (goalArea = 0; goalArea < numAreas; goalArea++) {
-
-			long numSteps = calcPath(startArea, goalArea, globalPath);
-			//----------------------------------------------------------
-			// For now, we'll just store the number of area steps in the
-			// table. If no path (or start and goal are the same), we'll store 0.
-			// 255 is reserved to mark the need to re-calc during the game...
-			setPathCost(startArea, goalArea, true, numSteps);
-			setPathFlag(startArea, goalArea, GLOBAL_FLAG_SPECIAL_IMPOSSIBLE, false);
-			setPathFlag(startArea, goalArea, GLOBAL_FLAG_SPECIAL_CALC, true);
-			setPathFlag(startArea, goalArea, GLOBAL_FLAG_NORMAL_OPENS, false);
-			setPathFlag(startArea, goalArea, GLOBAL_FLAG_NORMAL_CLOSES, false);
-		}
-
-	for (i = 0; i < numAreas; i++)
-		if ((areas[i].type == AREA_TYPE_WALL) || (areas[i].type == AREA_TYPE_GATE) || (areas[i].type == AREA_TYPE_FOREST))
-			openArea(i);
-
-	for (startArea = 0; startArea < numAreas; startArea++)
-		for (goalArea = 0; goalArea < numAreas; goalArea++) {
-
-			long numSteps = calcPath(startArea, goalArea, globalPath);
-			//----------------------------------------------------------
-			// For now, we'll just store the number of area steps in the
-			// table. If no path (or start and goal are the same), we'll store 0.
-			// 255 is reserved to mark the need to re-calc during the game...
-			setPathCost(startArea, goalArea, true, numSteps);
-		}
-
-	for (i = 0; i < numAreas; i++)
-		if ((areas[i].type == AREA_TYPE_WALL) || (areas[i].type == AREA_TYPE_GATE) || (areas[i].type == AREA_TYPE_FOREST))
-			closeArea(i);
-
-	closes = false;
-	opens = false;
 }
 
-#endif
 //------------------------------------------------------------------------------------------
 
 void GlobalMap::clearPathExistsTable (void) {
@@ -2949,6 +2875,127 @@ unsigned char GlobalMap::getPathExists (long fromArea, long toArea) {
 
 //------------------------------------------------------------------------------------------
 
+void GlobalMap::clearPathCache (void) {
+
+	if (!pathCache)
+		return;
+
+	for (long i = 0; i < GLOBAL_PATH_CACHE_SIZE; i++)
+		pathCache[i].valid = false;
+}
+
+//------------------------------------------------------------------------------------------
+
+void GlobalMap::invalidatePathCache (long area) {
+
+	//------------------------------------------------------------------
+	// Closing an area only makes routes thru it more expensive, so just
+	// the cached routes that start, end or pass thru it are dropped...
+	if (!pathCache)
+		return;
+
+	for (long i = 0; i < GLOBAL_PATH_CACHE_SIZE; i++) {
+		GlobalPathCacheEntryPtr entry = &pathCache[i];
+		if (!entry->valid)
+			continue;
+		if ((entry->startArea == area) || (entry->goalArea == area)) {
+			entry->valid = false;
+			continue;
+		}
+		for (long j = 0; j < entry->numSteps; j++)
+			if (entry->steps[j].thruArea == area) {
+				entry->valid = false;
+				break;
+			}
+	}
+}
+
+//------------------------------------------------------------------------------------------
+
+uint32_t GlobalMap::calcGateSignature (void) {
+
+	//---------------------------------------------------------------------
+	// Gates are re-opened/closed by calcPath for every request, based upon
+	// the mover's team. Hash the state they'll be in for this team, so a
+	// cached route is only reused while the gates it was planned with are
+	// unchanged...
+	uint32_t signature = 2166136261u;
+	for (long i = 0; i < numAreas; i++)
+		if (areas[i].type == AREA_TYPE_GATE) {
+			bool gateOpen;
+			if ((areas[i].teamID == moverTeamID) || (areas[i].teamID == -1))
+				gateOpen = (areas[i].ownerWID <= 0) || !isGateDisabledCallback(areas[i].ownerWID);
+			else
+				gateOpen = isGateOpenCallback(areas[i].ownerWID);
+			signature = (signature ^ (uint32_t)((i << 1) | gateOpen)) * 16777619u;
+		}
+	return(signature);
+}
+
+//------------------------------------------------------------------------------------------
+
+GlobalPathCacheEntryPtr GlobalMap::findCachedPath (long startArea, long goalArea, uint32_t gateSignature) {
+
+	if (!pathCache)
+		return(NULL);
+
+	for (long i = 0; i < GLOBAL_PATH_CACHE_SIZE; i++) {
+		GlobalPathCacheEntryPtr entry = &pathCache[i];
+		if (entry->valid &&
+			(entry->startArea == startArea) &&
+			(entry->goalArea == goalArea) &&
+			(entry->moverTeamID == moverTeamID) &&
+			(entry->useClosedAreas == useClosedAreas) &&
+			(entry->gateSignature == gateSignature)) {
+			entry->lastUsed = ++pathCacheTime;
+			return(entry);
+		}
+	}
+	return(NULL);
+}
+
+//------------------------------------------------------------------------------------------
+
+void GlobalMap::addCachedPath (long startArea, long goalArea, uint32_t gateSignature, GlobalPathStepPtr path, long numSteps) {
+
+	if (!pathCache) {
+		pathCache = (GlobalPathCacheEntryPtr)systemHeap->Malloc(sizeof(GlobalPathCacheEntry) * GLOBAL_PATH_CACHE_SIZE);
+		gosASSERT(pathCache != NULL);
+		for (long i = 0; i < GLOBAL_PATH_CACHE_SIZE; i++) {
+			pathCache[i].valid = false;
+			pathCache[i].lastUsed = 0;
+		}
+	}
+
+	//--------------------------------------------------------
+	// Take a free slot, else the least recently used one...
+	GlobalPathCacheEntryPtr entry = &pathCache[0];
+	for (long i = 0; i < GLOBAL_PATH_CACHE_SIZE; i++) {
+		if (!pathCache[i].valid) {
+			entry = &pathCache[i];
+			break;
+		}
+		if (pathCache[i].lastUsed < entry->lastUsed)
+			entry = &pathCache[i];
+	}
+
+	entry->valid = true;
+	entry->startArea = startArea;
+	entry->goalArea = goalArea;
+	entry->moverTeamID = moverTeamID;
+	entry->useClosedAreas = useClosedAreas;
+	entry->gateSignature = gateSignature;
+	entry->lastUsed = ++pathCacheTime;
+	entry->numSteps = numSteps;
+	for (long i = 0; i < numSteps; i++) {
+		entry->steps[i].thruArea = path[i].thruArea;
+		entry->steps[i].goalDoor = path[i].goalDoor;
+		entry->steps[i].costToGoal = path[i].costToGoal;
+	}
+}
+
+//------------------------------------------------------------------------------------------
+
 long GlobalMap::exitDirection (long doorIndex, long fromArea) {
 
 	if (doors[doorIndex].area[0] == fromArea)
@@ -3211,6 +3258,8 @@ void GlobalMap::setAreaTeamID (long area, char teamID) {
 
 	GlobalMapAreaPtr curArea = &areas[area];
 	const DoorInfoPtr curArea_doors = areas_doors[area];
+	if (curArea->teamID != teamID)
+		clearPathCache();
 	curArea->teamID = teamID;
 	for (long d = 0; d < curArea->numDoors; d++) {
 		doors[curArea_doors[d].doorIndex].teamID = teamID;
@@ -3347,7 +3396,8 @@ inline void GlobalMap::propogateCost (long door, long cost, long fromAreaIndex,
 				sprintf(s, "GlobalMap.propogateCost: Cannot find globalmap door [%d, %d, %d, %d] for change\n", door, cost, fromAreaIndex, g);
 				gosASSERT(openIndex != 0);
 			}
-			openList->change(door, curMapDoor->fPrime);
+			else
+				openList->change(openIndex, curMapDoor->fPrime);
 			}
 		else {
 			long toAreaIndex = 1 - fromAreaIndex;
@@ -3435,6 +3485,34 @@ long GlobalMap::calcPath (long startArea,
 		openList->init(5000);
 	}
 
+	if (!isGateOpenCallback || !isGateDisabledCallback)
+		STOP(("Globalmap.calcPath: NULL gate callback"));
+
+	//-------------------------------------------------------------------
+	// Someone on this team may already have asked for this route (e.g.
+	// the rest of a lance given the same move order)...
+	uint32_t gateSignature = calcGateSignature();
+	GlobalPathCacheEntryPtr cachedPath = findCachedPath(startArea, goalArea, gateSignature);
+	if (cachedPath) {
+		for (long i = 0; i < cachedPath->numSteps; i++) {
+			path[i].thruArea = cachedPath->steps[i].thruArea;
+			path[i].goalDoor = cachedPath->steps[i].goalDoor;
+			path[i].costToGoal = cachedPath->steps[i].costToGoal;
+		}
+		if (logEnabled) {
+			char s[50];
+			sprintf(s, "     CACHED PATH: %d steps", cachedPath->numSteps);
+			log->write(s);
+			log->write(" ");
+		}
+		return(cachedPath->numSteps);
+	}
+
+	//-------------------------------------------------------------------
+	// The gate and offmap area toggling below is per-request, so it must
+	// not flush the cache...
+	pathCacheLocked = true;
+
 	//---------------------------------------------------------------
 	// NOTE: The last 6 doors are reserved for use by the pathfinder:
 	//			numDoors + 0 = startArea
@@ -3464,9 +3542,6 @@ long GlobalMap::calcPath (long startArea,
 	if (areas[goalArea].offMap)
 		openArea(goalArea);
 
-	if (!isGateOpenCallback || !isGateDisabledCallback)
-		STOP(("Globalmap.calcPath: NULL gate callback"));
-
 	for (long i = 0; i < numAreas; i++)
 		if (areas[i].type == AREA_TYPE_GATE) {
 			if ((areas[i].teamID == moverTeamID) || (areas[i].teamID == -1)) {
@@ -3666,6 +3741,8 @@ long GlobalMap::calcPath (long startArea,
 	if (areas[goalArea].offMap)
 		closeArea(goalArea);
 
+	pathCacheLocked = false;
+
 	if (goalFound) {
 		//-------------------------------------------
 		// First, let's count how long the path is...
@@ -3703,19 +3780,8 @@ long GlobalMap::calcPath (long startArea,
 		//systemHeap->walkHeap(false,false,"GlobalMap:calc BAD HEAP2\n");
 		#endif
 
-#ifdef USE_PATH_COST_TABLE
-		if (pathCostTable) {
-			setPathCost(startArea, goalArea, useClosedAreas, numDoors);
-			if (useClosedAreas) {
-				setPathFlag(startArea, goalArea, GLOBAL_FLAG_SPECIAL_IMPOSSIBLE, false);
-				setPathFlag(startArea, goalArea, GLOBAL_FLAG_SPECIAL_CALC, false);
-				}
-			else {
-				setPathFlag(startArea, goalArea, GLOBAL_FLAG_NORMAL_OPENS, false);
-				setPathFlag(startArea, goalArea, GLOBAL_FLAG_SPECIAL_CALC, false);
-			}
-		}
-#endif
+		addCachedPath(startArea, goalArea, gateSignature, path, numDoors);
+
 		if (logEnabled) {
 			char s[50];
 			sprintf(s, "     PATH FOUND: %d steps", numDoors);
@@ -3725,19 +3791,7 @@ long GlobalMap::calcPath (long startArea,
 		return(numDoors);
 		}
 	else {
-#ifdef USE_PATH_COST_TABLE
-		if (pathCostTable) {
-			setPathCost(startArea, goalArea, useClosedAreas, 0);
-			if (useClosedAreas) {
-				setPathFlag(startArea, goalArea, GLOBAL_FLAG_SPECIAL_IMPOSSIBLE, true);
-				setPathFlag(startArea, goalArea, GLOBAL_FLAG_SPECIAL_CALC, false);
-				}
-			else {
-				setPathFlag(startArea, goalArea, GLOBAL_FLAG_NORMAL_OPENS, false);
-				setPathFlag(startArea, goalArea, GLOBAL_FLAG_SPECIAL_CALC, false);
-			}
-		}
-#endif
+		addCachedPath(startArea, goalArea, gateSignature, path, 0);
 		if (logEnabled)
 			log->write("     NO PATH FOUND");
 	}
@@ -3784,6 +3838,8 @@ void GlobalMap::closeArea (long area) {
 
 	GlobalMapAreaPtr closedArea = &areas[area];
     const DoorInfoPtr& closedArea_doors = areas_doors[area];
+	if (closedArea->open && !pathCacheLocked)
+		invalidatePathCache(area);
 	closedArea->open = false;
 	for (long d = 0; d < closedArea->numDoors; d++)
 		closeDoor(closedArea_doors[d].doorIndex);
@@ -3809,6 +3865,9 @@ void GlobalMap::openArea (long area) {
 	GlobalMapAreaPtr openedArea = &areas[area];
     const DoorInfoPtr& openedArea_doors = areas_doors[area];
 
+	//-------------------------------------------------------------
+	// A newly opened area may shorten any route, so drop them all...
+	bool wasOpen = openedArea->open;
 	openedArea->open = true;
 	for (long d = 0; d < openedArea->numDoors; d++) {
 		long areaSide1 = doors[openedArea_doors[d].doorIndex].area[0];
@@ -3821,10 +3880,16 @@ void GlobalMap::openArea (long area) {
 		GlobalMapDoorPtr curDoor = &doors[openedArea_doors[i].doorIndex];
 		DoorInfoLinksPtr& curDoor_links = doors_links[openedArea_doors[i].doorIndex];
 		long doorSide = openedArea_doors[i].doorSide;
-		for (long j = 0; j < curDoor->numLinks[doorSide]; j++)
+		for (long j = 0; j < curDoor->numLinks[doorSide]; j++) {
+			if (curDoor_links[doorSide][j].cost != curDoor_links[doorSide][j].openCost)
+				wasOpen = false;
 			curDoor_links[doorSide][j].cost = curDoor_links[doorSide][j].openCost;
+		}
 	}
 
+	if (!wasOpen && !pathCacheLocked)
+		clearPathCache();
+
 	opens = true;
 }
 
@@ -3923,12 +3988,10 @@ void GlobalMap::destroy (void) {
 		pathExistsTable = NULL;
 	}
 
-#ifdef USE_PATH_COST_TABLE
-	if (pathCostTable) {
-		systemHeap->Free(pathCostTable);
-		pathCostTable = NULL;
+	if (pathCache) {
+		systemHeap->Free(pathCache);
+		pathCache = NULL;
 	}
-#endif
 }
 
 //----------------------------------------------------------------------------------
@@ -4062,6 +4125,8 @@ void MoveMap::init (long maxW, long maxH) {
 			distanceFloat[i][j] = agsqrt(i, j) * cellLength;
 			distanceInt[i][j] = (int)distanceFloat[i][j];
 		}
+	for (long i = 0; i < NUM_CELL_OFFSETS; i++)
+		cellShiftDistance[i] = agsqrt(cellShift[i * 2], cellShift[i * 2 + 1]) * cellLength;
 
 	clear();
 }
@@ -4354,23 +4419,175 @@ inline long MoveMap::markEscapeGoals (Stuff::Vector3D finalGoal) {
 
 //---------------------------------------------------------------------------
 
-long MoveMap::setUp (long mapULr,
-					 long mapULc,
-					 long mapWidth,
-					 long mapHeight,
-					 long level,
-					 Stuff::Vector3D* startPos,
-					 long startRow,
-					 long startCol,
-					 Stuff::Vector3D goalPos,
-					 long goalRow,
-					 long goalCol,
-					 long clearCellCost,
-					 long jumpCellCost,
-					 long offsets,
-					 unsigned long params) {
+long MoveMap::calcGateCost (long row, long col, long cellClass, bool followRoads) {
+
+	long cost = clearCost;
+	long areaID = GlobalMoveMap[moveLevel]->calcArea(row, col);
+	long teamID = -1;
+	if (areaID > -1) {
+		teamID = GlobalMoveMap[moveLevel]->areas[areaID].teamID;
+		//Its possible for the ownerWIDs to be invalid for one or two frames after a quick save.
+		// We handle this ok later on!!  OwnerWIDs restablish themselves right after the first unpaused update!
+	}
+	if (!EditorSave && (areaID > -1) && GlobalMoveMap[moveLevel]->isGateDisabledCallback(GlobalMoveMap[moveLevel]->areas[areaID].ownerWID))
+		cost = COST_BLOCKED;
+	else if ((teamID > -1) && (TeamRelations[teamID][moverTeamID] != RELATION_FRIENDLY)) {
+		if (!(cellClass & MOVECLASS_IMPASSABLE))
+			cost <<= 2;
+		else
+			cost = COST_BLOCKED;
+		}
+	else if ((cellClass & MOVECLASS_ROAD) && followRoads)
+		cost >>= 2;
+	if (cellClass & MOVECLASS_FOREST)
+		cost += forestCost;
+	return(cost);
+}
 
-	//-----------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+
+inline bool MoveMap::inThruArea (long row, long col) {
+
+	long areaID = GlobalMoveMap[moveLevel]->calcArea(row, col);
+	return((areaID == thruAreas[0]) || (areaID == thruAreas[1]));
+}
+
+//---------------------------------------------------------------------------
+
+#define	MOVECLASS_COST_GATE		-1
+
+void MoveMap::setCellCosts (unsigned long params, bool cullAreas) {
+
+	if (!GameMap->moveClass[0])
+		GameMap->buildMoveClasses();
+
+	bool followRoads = ((params & MOVEPARAM_FOLLOW_ROADS) != 0);
+	bool traverseShallowWater = ((params & (MOVEPARAM_WATER_SHALLOW + MOVEPARAM_WATER_DEEP)) != 0);
+	bool traverseDeepWater = ((params & MOVEPARAM_WATER_DEEP) != 0);
+	long pathLockCost = clearCost << 3;
+
+	//-----------------------------------------------------------------
+	// Cost of each move class for this mover.  Gates depend on who owns
+	// them, so they are left for calcGateCost to do cell by cell...
+	long classCost[NUM_MOVECLASS_COSTS];
+	bool groundMover = ((moveLevel == 0) || (moveLevel == 1));
+	for (long cellClass = 0; cellClass < NUM_MOVECLASS_COSTS; cellClass++) {
+		bool passable = !(cellClass & MOVECLASS_IMPASSABLE);
+		long cost = clearCost;
+		if ((cellClass & MOVECLASS_OFFMAP) && !travelOffMap)
+			cost = COST_BLOCKED;
+		else if (groundMover) {
+			if (cellClass & MOVECLASS_SHALLOW) {
+				if (!traverseShallowWater || !passable)
+					cost = COST_BLOCKED;
+				}
+			else if (cellClass & MOVECLASS_DEEP) {
+				if (!traverseDeepWater || !passable)
+					cost = COST_BLOCKED;
+				}
+			else if (cellClass & MOVECLASS_GATE) {
+				classCost[cellClass] = MOVECLASS_COST_GATE;
+				continue;
+				}
+			else {
+				if (!passable)
+					cost = COST_BLOCKED;
+				else if ((cellClass & MOVECLASS_ROAD) && followRoads)
+					cost >>= 2;
+			}
+			if (cellClass & MOVECLASS_FOREST)
+				cost += forestCost;
+		}
+		classCost[cellClass] = cost;
+	}
+
+	//--------------------------------------------------------------
+	// Then it's a copy of the map rectangle through the cost table,
+	// with gates and pathlocks on top...
+	long firstRow = (ULr < 0) ? -ULr : 0;
+	long lastRow = maxRow + 1;
+	if ((ULr + lastRow) > GameMap->height)
+		lastRow = GameMap->height - ULr;
+	long firstCol = (ULc < 0) ? -ULc : 0;
+	long lastCol = maxCol + 1;
+	if ((ULc + lastCol) > GameMap->width)
+		lastCol = GameMap->width - ULc;
+
+	long numClearCells = 0;
+	unsigned char* moveClass = GameMap->moveClass[moveLevel == 2];
+	for (long cellRow = firstRow; cellRow < lastRow; cellRow++) {
+		unsigned char* cellClassRow = &moveClass[(ULr + cellRow) * GameMap->width + ULc];
+		MoveMapNodePtr node = &map[cellRow * maxWidth];
+		for (long cellCol = firstCol; cellCol < lastCol; cellCol++) {
+			long cellClass = cellClassRow[cellCol];
+			if (cellClass & MOVECLASS_OFFMAP)
+				node[cellCol].setFlag(MOVEFLAG_OFFMAP);
+
+			long cost = classCost[cellClass & MOVECLASS_TERRAIN_MASK];
+			if (cullAreas && !inThruArea(ULr + cellRow, ULc + cellCol))
+				cost = COST_BLOCKED;
+			else if (cost == MOVECLASS_COST_GATE)
+				cost = calcGateCost(ULr + cellRow, ULc + cellCol, cellClass, followRoads);
+			node[cellCol].cost = cost;
+
+			//---------------------------------------------------------------
+			// NOTE: With gates, we may want them to set the cell cost rather
+			// than just adjust it. Let's see how they play. Since they're
+			// set as an overlay, we'll just treat them as such for now.
+			if (cellClass & MOVECLASS_PATHLOCK)
+				adjustMoveMapCellCost(&node[cellCol], pathLockCost);
+
+			if (node[cellCol].cost == clearCost)
+				numClearCells++;
+		}
+	}
+
+	//---------------------------------------------------------------
+	// Jump point search only pays off when most of the map is clear.
+	// Anywhere else it spends its time falling back to the old search.
+	long numCells = (lastRow - firstRow) * (lastCol - firstCol);
+	jumpPointSearch = ((params & MOVEPARAM_JUMP_POINTS) != 0) && (numCells > 0) && ((numClearCells * 4) >= (numCells * 3));
+}
+
+//---------------------------------------------------------------------------
+
+void MoveMap::prepareSearch (void) {
+
+	//------------------------------------------------------------------
+	// The search itself allocates nothing and only reads the map, so a
+	// map which has been set up can be searched on any thread...
+	jumpOnBlocked = JumpOnBlocked;
+	if (!openList) {
+		openList = new PriorityQueue;
+		gosASSERT(openList != NULL);
+		openList->init(5000);
+	}
+	openList->reserveIds(maxHeight * MAX_MAPWIDTH);
+	if (jumpPointSearch && !jumpParent) {
+		jumpParent = (int*)systemHeap->Malloc(maxWidth * maxHeight * sizeof(int));
+		gosASSERT(jumpParent != NULL);
+	}
+}
+
+//---------------------------------------------------------------------------
+
+long MoveMap::setUp (long mapULr,
+					 long mapULc,
+					 long mapWidth,
+					 long mapHeight,
+					 long level,
+					 Stuff::Vector3D* startPos,
+					 long startRow,
+					 long startCol,
+					 Stuff::Vector3D goalPos,
+					 long goalRow,
+					 long goalCol,
+					 long clearCellCost,
+					 long jumpCellCost,
+					 long offsets,
+					 unsigned long params) {
+
+	//-----------------------------------------------------------------------------
 	// If the map has not been allocated yet, then the tile height and width passed
 	// is used as both the max and current dimensions. Otherwise, they are only
 	// used as the current dimensions...
@@ -4422,111 +4639,21 @@ long MoveMap::setUp (long mapULr,
 		cannotEnterOffMap = false;
 	}
 
-	bool followRoads = ((params & MOVEPARAM_FOLLOW_ROADS) != 0);
-	bool traverseShallowWater = ((params & (MOVEPARAM_WATER_SHALLOW + MOVEPARAM_WATER_DEEP)) != 0);
-	bool traverseDeepWater = ((params & MOVEPARAM_WATER_DEEP) != 0);
-	bool avoidMines = true;
-	if (params & MOVEPARAM_SWEEP_MINES)
-		avoidMines = false;
-
 	//-------------------------------------------------
 	// Now that the params are set up, build the map...
-	long pathLockCost = clearCost << 3;
-
-	//--------------------------------------------------------------
-	// Set the map costs based upon the tiles in the scenario map...
-	bool groundMover = ((moveLevel == 0) || (moveLevel == 1));
-	for (long cellRow = 0; cellRow < height; cellRow++)
-		for (long cellCol = 0; cellCol < width; cellCol++) {			
-			if (GameMap->inBounds(ULr + cellRow, ULc + cellCol)) {
-				MapCellPtr mapCell = GameMap->getCell(ULr + cellRow, ULc + cellCol);
-				long moveMapIndex = cellRow * maxWidth + cellCol;
-
-				long cost = clearCost;
-				bool offMapCell = mapCell->getOffMap();
-				if (offMapCell)
-					map[moveMapIndex].setFlag(MOVEFLAG_OFFMAP);
-
-				//-----------------------
-				// Tile (terrain) type...
-				//long tileType = curTile.getTileType();
-				if (offMapCell && !travelOffMap)
-					cost = COST_BLOCKED;
-				else if (groundMover) {
-					if (mapCell->getShallowWater()) {
-						if (!traverseShallowWater)
-							cost = COST_BLOCKED;
-						else if (!mapCell->getPassable())
-							cost = COST_BLOCKED;
-						}
-					else if (mapCell->getDeepWater()) {
-						if (!traverseDeepWater)
-							cost = COST_BLOCKED;
-						else if (!mapCell->getPassable())
-							cost = COST_BLOCKED;
-						}
-					else if (mapCell->getGate()) 
-					{
-						long areaID = GlobalMoveMap[moveLevel]->calcArea(ULr + cellRow, ULc + cellCol);
-						long teamID = -1;
-						if (areaID > -1) 
-						{
-							teamID = GlobalMoveMap[moveLevel]->areas[areaID].teamID;
-							//Its possible for the ownerWIDs to be invalid for one or two frames after a quick save.
-							// We handle this ok later on!!  OwnerWIDs restablish themselves right after the first unpaused update!
-							/*
-							if (!EditorSave)
-								if (GlobalMoveMap[moveLevel]->areas[areaID].ownerWID < 1)
-									PAUSE(("Gate has no ownerWID.  CellR: %d, CellC: %d, WID: %d, MoveLvl: %d",cellRow,cellCol,GlobalMoveMap[moveLevel]->areas[areaID].ownerWID,moveLevel));
-							*/
-						}
-						if (!EditorSave && (areaID > -1) && GlobalMoveMap[moveLevel]->isGateDisabledCallback(GlobalMoveMap[moveLevel]->areas[areaID].ownerWID))
-							cost = COST_BLOCKED;
-						else if ((teamID > -1) && (TeamRelations[teamID][moverTeamID] != RELATION_FRIENDLY)) {
-							if (mapCell->getPassable())
-								cost <<= 2;
-							else
-								cost = COST_BLOCKED;
-							}
-						else if (mapCell->getRoad() && followRoads)
-							cost >>= 2;
-						}
-					else {
-						if (!mapCell->getPassable())
-							cost = COST_BLOCKED;
-						else if (mapCell->getRoad() && followRoads)
-							cost >>= 2;
-					}
-					if (mapCell->getForest())
-						cost += forestCost;
-				}
-				map[moveMapIndex].cost = cost;
-
-				//---------------------------------------------------------------
-				// NOTE: With gates, we may want them to set the cell cost rather
-				// than just adjust it. Let's see how they play. Since they're
-				// set as an overlay, we'll just treat them as such for now.
-				
-				if (mapCell->getPathlock(moveLevel == 2))
-					adjustMoveMapCellCost(&map[cellRow * maxWidth + cellCol], pathLockCost);
-			}
-		}
-
+	setCellCosts(params, false);
+	prepareSearch();
 
 	if (FindingEscapePath)
 		markEscapeGoals(goalPos);
 	else
 		map[goalR * maxWidth + goalC].setFlag(MOVEFLAG_GOAL);
 
-	__int64 startTime = GetCycles();
-
+	GOS_PROFILE_STAT("MoveMap::setUp stationary movers",MCTimeCalcPath1Update);
 	if (params & MOVEPARAM_STATIONARY_MOVERS)
 		if (placeStationaryMoversCallback)
 			(*placeStationaryMoversCallback)(this);
 
-#ifdef LAB_ONLY
-	MCTimeCalcPath1Update += (GetCycles() - startTime);
-#endif
 
 	return(NO_ERR);
 }
@@ -4545,7 +4672,7 @@ long MoveMap::setUp (long level,
 					 long offsets,
 					 unsigned long params) {
 
-	__int64 startTime = GetCycles();
+	GOS_PROFILE_STAT("MoveMap::setUp",MCTimeCalcPath2Update);
 
 	//-----------------------------------------------------------------------------
 	// If the map has not been allocated yet, then the tile height and width passed
@@ -4645,8 +4772,6 @@ long MoveMap::setUp (long level,
 	else
 		setGoal(thruArea[1], goalDoor);
 
-	long pathLockCost = clearCost << 3;
-
 	travelOffMap = false;
 	cannotEnterOffMap = true;
 	if (GameMap->getOffMap(ULr + startRow, ULc + startCol))
@@ -4658,83 +4783,8 @@ long MoveMap::setUp (long level,
 
 	//-------------------------------------------------
 	// Now that the params are set up, build the map...
-	bool followRoads = ((params & MOVEPARAM_FOLLOW_ROADS) != 0);
-	bool traverseShallowWater = ((params & (MOVEPARAM_WATER_SHALLOW + MOVEPARAM_WATER_DEEP)) != 0);
-	bool traverseDeepWater = ((params & MOVEPARAM_WATER_DEEP) != 0);
-	bool avoidMines = true;
-	if (params & MOVEPARAM_SWEEP_MINES)
-		avoidMines = false;
-
-	//--------------------------------------------------------------
-	// Set the map costs based upon the tiles in the scenario map...
-	bool groundMover = ((moveLevel == 0) || (moveLevel == 1));
-	for (long cellRow = 0; cellRow < height; cellRow++)
-		for (long cellCol = 0; cellCol < width; cellCol++) {			
-			if (GameMap->inBounds(ULr + cellRow, ULc + cellCol) && inBounds(cellRow, cellCol)) {
-				MapCellPtr mapCell = GameMap->getCell(ULr + cellRow, ULc + cellCol);
-
-				long moveMapIndex = cellRow * maxWidth + cellCol;
-
-				long cost = clearCost;
-				bool offMapCell = mapCell->getOffMap();
-				if (offMapCell)
-					map[moveMapIndex].setFlag(MOVEFLAG_OFFMAP);
-
-				long areaID = GlobalMoveMap[moveLevel]->calcArea(ULr + cellRow, ULc + cellCol);
-				if (CullPathAreas && (areaID != thruAreas[0]) && (areaID != thruAreas[1]))
-					cost = COST_BLOCKED;
-				else if (offMapCell && !travelOffMap)
-					cost = COST_BLOCKED;
-				else if (groundMover) {
-					if (mapCell->getShallowWater()) {
-						if (!traverseShallowWater)
-							cost = COST_BLOCKED;
-						else if (!mapCell->getPassable())
-							cost = COST_BLOCKED;
-						}
-					else if (mapCell->getDeepWater()) {
-						if (!traverseDeepWater)
-							cost = COST_BLOCKED;
-						else if (!mapCell->getPassable())
-							cost = COST_BLOCKED;
-						}
-					else if (mapCell->getGate()) {
-						long areaID = GlobalMoveMap[moveLevel]->calcArea(ULr + cellRow, ULc + cellCol);
-						long teamID = -1;
-						if (areaID > -1) {
-							teamID = GlobalMoveMap[moveLevel]->areas[areaID].teamID;
-							/*  See Above
-							if (!EditorSave)
-								if (GlobalMoveMap[moveLevel]->areas[areaID].ownerWID < 1)
-									PAUSE(("Gate has no ownerWID"));
-							*/
-						}
-						if (!EditorSave && (areaID > -1) && GlobalMoveMap[moveLevel]->isGateDisabledCallback(GlobalMoveMap[moveLevel]->areas[areaID].ownerWID))
-							cost = COST_BLOCKED;
-						else if ((teamID > -1) && (TeamRelations[teamID][moverTeamID] != RELATION_FRIENDLY)) {
-							if (mapCell->getPassable())
-								cost <<= 2;
-							else
-								cost = COST_BLOCKED;
-							}
-						else if (mapCell->getRoad() && followRoads)
-							cost >>= 2;
-						}
-					else {
-						if (!mapCell->getPassable())
-							cost = COST_BLOCKED;
-						else if (mapCell->getRoad() && followRoads)
-							cost >>= 2;
-					}
-					if (mapCell->getForest())
-						cost += forestCost;
-				}
-				setCost(cellRow, cellCol, cost);
-
-				if (mapCell->getPathlock(moveLevel == 2))
-					adjustMoveMapCellCost(&map[cellRow * maxWidth + cellCol], pathLockCost);
-			}
-		}
+	setCellCosts(params, CullPathAreas);
+	prepareSearch();
 
 	if (markGoals(finalGoal) == 0)
 		return(-1);
@@ -4743,9 +4793,6 @@ long MoveMap::setUp (long level,
 		if (placeStationaryMoversCallback)
 			(*placeStationaryMoversCallback)(this);
 
-#ifdef LAB_ONLY
-	MCTimeCalcPath2Update += (GetCycles() - startTime);
-#endif
 	return(NO_ERR);
 }
 
@@ -4805,7 +4852,6 @@ inline bool MoveMap::adjacentCellOpenJUMP (long r, long c, long dir) {
 //---------------------------------------------------------------------------
 
 inline int MoveMap::calcHPrime (int r, int c) {
-	__int64 startTime = GetCycles();
 	long sum = 0;
 	if (r > goalR)
 		sum += (r - goalR);
@@ -4816,14 +4862,9 @@ inline int MoveMap::calcHPrime (int r, int c) {
 		sum += (c - goalC);
 	else
 		sum += (goalC - c);
-#ifdef LAB_ONLY
-	MCTimeCalcPath3Update += (GetCycles() - startTime);		
-#endif
 	return(sum);
 }
 
-#define MAX_MAPWIDTH		1000
-
 //---------------------------------------------------------------------------
 
 inline void MoveMap::propogateCost (long mapCellIndex, long cost, long g) {
@@ -4881,7 +4922,7 @@ inline void MoveMap::propogateCost (long mapCellIndex, long cost, long g) {
 				if (succCellIndex > -1) {
 					MoveMapNodePtr succMapNode = &map[succCellIndex];
 					if (succMapNode->cost < COST_BLOCKED)
-						if ((succMapNode->hPrime != HPRIME_NOT_CALCED) && (succMapNode->hPrime < MaxHPrime)) {
+						if ((succMapNode->hPrime != HPRIME_NOT_CALCED) && (succMapNode->hPrime < maxHPrime)) {
 							char dirToParent = reverseShift[dir];
 							long cost = succMapNode->cost;
 							//------------------------------------
@@ -4946,7 +4987,7 @@ inline void MoveMap::propogateCostJUMP (long r, long c, long cost, long g) {
 				if (inMapBounds(succRow, succCol, height, width)) {
 					MoveMapNodePtr succMapNode = &map[succRow * maxWidth + succCol];
 					if (succMapNode->cost < COST_BLOCKED)
-						if ((succMapNode->hPrime != HPRIME_NOT_CALCED) && (succMapNode->hPrime < MaxHPrime)) {
+						if ((succMapNode->hPrime != HPRIME_NOT_CALCED) && (succMapNode->hPrime < maxHPrime)) {
 							char dirToParent = reverseShift[dir];
 
 							bool jumping = false;
@@ -4957,7 +4998,7 @@ inline void MoveMap::propogateCostJUMP (long r, long c, long cost, long g) {
 							gosASSERT(cost > 0);
 							if (dir > 7) {
 								jumping = true;
-								if (JumpOnBlocked)
+								if (jumpOnBlocked)
 									cost = jumpCost;
 								else
 									cost += jumpCost;
@@ -4980,6 +5021,334 @@ inline void MoveMap::propogateCostJUMP (long r, long c, long cost, long g) {
 
 //---------------------------------------------------------------------------
 
+//---------------------------------------------------------------------------
+// Jump point search.  On clear ground every cell costs the same, so the old
+// search opens nearly every cell between start and goal to pick one of many
+// equally good paths.  This only opens the cells where the path might turn
+// (jump points) and runs along straight and diagonal lines between them.
+//
+// A cell is only jumped over if it and all its neighbours are either clear
+// (clearCost, no mover, not the goal, etc.) or blocked.  Any other cell is
+// a jump point and is expanded just like the old search does, so forests,
+// water, pathlocks, movers and goals get exactly the old treatment.
+//---------------------------------------------------------------------------
+
+inline bool MoveMap::canStep (long cellIndex, long dir) {
+
+	//----------------------------------------------------
+	// Same tests calcPath makes before stepping in dir...
+	if (IsDiagonalStep[dir]) {
+		bool adj1Open = false;
+		long adjCellIndex = map[cellIndex].adjCells[StepAdjDir[dir]];
+		if (adjCellIndex > -1)
+			if ((map[adjCellIndex].flags & MOVEFLAG_MOVER_HERE) == 0)
+				adj1Open = (map[adjCellIndex].cost < COST_BLOCKED);
+
+		bool adj2Open = false;
+		adjCellIndex = map[cellIndex].adjCells[StepAdjDir[dir + 1]];
+		if (adjCellIndex > -1)
+			if ((map[adjCellIndex].flags & MOVEFLAG_MOVER_HERE) == 0)
+				adj2Open = (map[adjCellIndex].cost < COST_BLOCKED);
+
+		if (!adj1Open && !adj2Open)
+			return(false);
+	}
+
+	long succCellIndex = map[cellIndex].adjCells[dir];
+	if (succCellIndex < 0)
+		return(false);
+
+	MoveMapNodePtr succMapNode = &map[succCellIndex];
+	if (succMapNode->flags & MOVEFLAG_OFFMAP)
+		if (cannotEnterOffMap)
+			if ((map[cellIndex].flags & MOVEFLAG_OFFMAP) == 0)
+				return(false);
+
+	if (!inBounds(mapRowTable[succCellIndex], mapColTable[succCellIndex]))
+		return(false);
+
+	if (succMapNode->cost >= COST_BLOCKED)
+		return(false);
+
+	if (succMapNode->hPrime == HPRIME_NOT_CALCED)
+		succMapNode->hPrime = calcHPrime(mapRowTable[succCellIndex], mapColTable[succCellIndex]);
+	return(succMapNode->hPrime < maxHPrime);
+}
+
+//---------------------------------------------------------------------------
+
+inline bool MoveMap::jumpCellBlocked (long cellIndex) {
+
+	return((cellIndex < 0) || (map[cellIndex].cost >= COST_BLOCKED));
+}
+
+//---------------------------------------------------------------------------
+
+bool MoveMap::jumpCellUniform (long cellIndex) {
+
+	MoveMapNodePtr curMapNode = &map[cellIndex];
+	if ((curMapNode->flags & MOVEFLAG_JUMP_TESTED) == 0) {
+		curMapNode->setFlag(MOVEFLAG_JUMP_TESTED);
+		for (long dir = -1; dir < 8; dir++) {
+			long adjCellIndex = (dir < 0) ? cellIndex : curMapNode->adjCells[dir];
+			if (jumpCellBlocked(adjCellIndex)) {
+				if (dir < 0)
+					return(false);
+				continue;
+			}
+			MoveMapNodePtr adjMapNode = &map[adjCellIndex];
+			if (adjMapNode->cost != clearCost)
+				return(false);
+			if (adjMapNode->flags & (MOVEFLAG_GOAL + MOVEFLAG_MOVER_HERE + MOVEFLAG_OFFMAP))
+				return(false);
+			if (!inBounds(mapRowTable[adjCellIndex], mapColTable[adjCellIndex]))
+				return(false);
+			if (adjMapNode->hPrime == HPRIME_NOT_CALCED)
+				adjMapNode->hPrime = calcHPrime(mapRowTable[adjCellIndex], mapColTable[adjCellIndex]);
+			if (adjMapNode->hPrime >= maxHPrime)
+				return(false);
+		}
+		curMapNode->setFlag(MOVEFLAG_JUMP_UNIFORM);
+	}
+	return((curMapNode->flags & MOVEFLAG_JUMP_UNIFORM) != 0);
+}
+
+//---------------------------------------------------------------------------
+
+long MoveMap::jumpStraight (long cellIndex, long dir) {
+
+	long leftDir = (dir + 6) & 7;
+	long rightDir = (dir + 2) & 7;
+	while (canStep(cellIndex, dir)) {
+		cellIndex = map[cellIndex].adjCells[dir];
+		if (!jumpCellUniform(cellIndex))
+			return(cellIndex);
+
+		//-------------------------------------------------------------
+		// A wall beside us ending means the path could turn round it...
+		short* adjCells = map[cellIndex].adjCells;
+		if (!jumpCellBlocked(adjCells[dir])) {
+			if (jumpCellBlocked(adjCells[leftDir]) && !jumpCellBlocked(adjCells[(dir + 7) & 7]))
+				return(cellIndex);
+			if (jumpCellBlocked(adjCells[rightDir]) && !jumpCellBlocked(adjCells[(dir + 1) & 7]))
+				return(cellIndex);
+		}
+	}
+	return(-1);
+}
+
+//---------------------------------------------------------------------------
+
+long MoveMap::jumpDiagonal (long cellIndex, long dir) {
+
+	long leftDir = (dir + 7) & 7;
+	long rightDir = (dir + 1) & 7;
+	while (canStep(cellIndex, dir)) {
+		cellIndex = map[cellIndex].adjCells[dir];
+		if (!jumpCellUniform(cellIndex))
+			return(cellIndex);
+
+		short* adjCells = map[cellIndex].adjCells;
+		if (jumpCellBlocked(adjCells[(rightDir + 4) & 7]) && !jumpCellBlocked(adjCells[leftDir]) && !jumpCellBlocked(adjCells[(dir + 6) & 7]))
+			return(cellIndex);
+		if (jumpCellBlocked(adjCells[(leftDir + 4) & 7]) && !jumpCellBlocked(adjCells[rightDir]) && !jumpCellBlocked(adjCells[(dir + 2) & 7]))
+			return(cellIndex);
+
+		//--------------------------------------------------------------
+		// Every diagonal step also looks along the two straight lines...
+		if ((jumpStraight(cellIndex, leftDir) > -1) || (jumpStraight(cellIndex, rightDir) > -1))
+			return(cellIndex);
+	}
+	return(-1);
+}
+
+//---------------------------------------------------------------------------
+
+void MoveMap::addJumpPoint (long cellIndex, long fromCellIndex, long dir, long numSteps) {
+
+	//-------------------------------------------------------------
+	// Every step but the last is onto a clear cell, and diagonal
+	// steps cost half again, the same as in calcPath...
+	MoveMapNodePtr succMapNode = &map[cellIndex];
+	long stepCost = clearCost;
+	long cost = succMapNode->cost;
+	gosASSERT(cost > 0);
+	if (IsDiagonalStep[dir]) {
+		stepCost += (stepCost / 2);
+		cost += (cost / 2);
+	}
+	long succNodeG = map[fromCellIndex].g + (numSteps - 1) * stepCost + cost;
+
+	if (succMapNode->flags & MOVEFLAG_OPEN) {
+		if (succNodeG < succMapNode->g) {
+			succMapNode->parent = reverseShift[dir];
+			succMapNode->g = succNodeG;
+			succMapNode->fPrime = succNodeG + succMapNode->hPrime;
+			jumpParent[cellIndex] = fromCellIndex;
+			long openIndex = openList->find(cellIndex);
+			gosASSERT(openIndex != 0);
+			if (openIndex)
+				openList->change(openIndex, succMapNode->fPrime);
+		}
+		return;
+	}
+
+	//-------------------------------------------------------------
+	// A closed node we now have a cheaper way to is simply reopened
+	// rather than propogating the new cost thru everything after it...
+	if (succMapNode->flags & MOVEFLAG_CLOSED) {
+		if (succNodeG >= succMapNode->g)
+			return;
+		succMapNode->clearFlag(MOVEFLAG_CLOSED);
+	}
+
+	succMapNode->parent = reverseShift[dir];
+	succMapNode->g = succNodeG;
+	succMapNode->fPrime = succNodeG + succMapNode->hPrime;
+	jumpParent[cellIndex] = fromCellIndex;
+	PQNode succPQNode;
+	succPQNode.key = succMapNode->fPrime;
+	succPQNode.id = cellIndex;
+	succPQNode.row = mapRowTable[cellIndex];
+	succPQNode.col = mapColTable[cellIndex];
+#ifdef _DEBUG
+	long insertErr = 
+#endif
+		openList->insert(succPQNode);
+	gosASSERT(insertErr == NO_ERR);
+	succMapNode->setFlag(MOVEFLAG_OPEN);
+}
+
+//---------------------------------------------------------------------------
+
+bool MoveMap::calcJumpPointPath (int& goalRow, int& goalCol) {
+
+	GOS_PROFILE_ZONE("MoveMap::calcJumpPointPath");
+
+	while (!openList->isEmpty()) {
+		PQNode bestPQNode;
+		openList->remove(bestPQNode);
+		long bestCellIndex = bestPQNode.id;
+		MoveMapNodePtr bestMapNode = &map[bestCellIndex];
+		bestMapNode->clearFlag(MOVEFLAG_OPEN);
+		bestMapNode->setFlag(MOVEFLAG_CLOSED);
+
+		if (bestMapNode->flags & MOVEFLAG_GOAL) {
+			goalRow = bestPQNode.row;
+			goalCol = bestPQNode.col;
+			return(true);
+		}
+
+		if ((bestMapNode->parent < 0) || !jumpCellUniform(bestCellIndex)) {
+			//--------------------------------------------------------
+			// Start node, or something besides clear ground nearby...
+			for (long dir = 0; dir < 8; dir++)
+				if (canStep(bestCellIndex, dir))
+					addJumpPoint(bestMapNode->adjCells[dir], bestCellIndex, dir, 1);
+			continue;
+		}
+
+		//------------------------------------------------------------------
+		// Open ground. Keep going the way we came, plus any turns a blocked
+		// cell beside us forces...
+		long dirs[5];
+		long numDirs = 0;
+		long dir = reverseShift[bestMapNode->parent];
+		short* adjCells = bestMapNode->adjCells;
+		dirs[numDirs++] = dir;
+		if (IsDiagonalStep[dir]) {
+			long leftDir = (dir + 7) & 7;
+			long rightDir = (dir + 1) & 7;
+			dirs[numDirs++] = leftDir;
+			dirs[numDirs++] = rightDir;
+			if (jumpCellBlocked(adjCells[(rightDir + 4) & 7]))
+				dirs[numDirs++] = (dir + 6) & 7;
+			if (jumpCellBlocked(adjCells[(leftDir + 4) & 7]))
+				dirs[numDirs++] = (dir + 2) & 7;
+			}
+		else {
+			if (jumpCellBlocked(adjCells[(dir + 6) & 7]))
+				dirs[numDirs++] = (dir + 7) & 7;
+			if (jumpCellBlocked(adjCells[(dir + 2) & 7]))
+				dirs[numDirs++] = (dir + 1) & 7;
+		}
+
+		long bestRow = bestPQNode.row;
+		long bestCol = bestPQNode.col;
+		for (long i = 0; i < numDirs; i++) {
+			long succCellIndex = IsDiagonalStep[dirs[i]] ? jumpDiagonal(bestCellIndex, dirs[i]) : jumpStraight(bestCellIndex, dirs[i]);
+			if (succCellIndex > -1) {
+				long rowSteps = abs(mapRowTable[succCellIndex] - bestRow);
+				long colSteps = abs(mapColTable[succCellIndex] - bestCol);
+				addJumpPoint(succCellIndex, bestCellIndex, dirs[i], (rowSteps > colSteps) ? rowSteps : colSteps);
+			}
+		}
+	}
+	return(false);
+}
+
+//---------------------------------------------------------------------------
+
+bool MoveMap::linkJumpPoints (long goalCellIndex) {
+
+	//------------------------------------------------------------------
+	// Fill in the parent of every cell jumped over, so the path can be
+	// read back one step at a time. Fails if the path crosses itself.
+	long startCellIndex = mapRowStartTable[startR] + startC;
+	long cellIndex = goalCellIndex;
+	while (cellIndex != startCellIndex) {
+		long parentCellIndex = jumpParent[cellIndex];
+		long dirToParent = map[cellIndex].parent;
+		map[cellIndex].setFlag(MOVEFLAG_JUMP_LINKED);
+		long stepCellIndex = map[cellIndex].adjCells[dirToParent];
+		while (stepCellIndex != parentCellIndex) {
+			if ((stepCellIndex < 0) || (map[stepCellIndex].flags & MOVEFLAG_JUMP_LINKED))
+				return(false);
+			map[stepCellIndex].parent = dirToParent;
+			map[stepCellIndex].setFlag(MOVEFLAG_JUMP_LINKED);
+			stepCellIndex = map[stepCellIndex].adjCells[dirToParent];
+		}
+		if (map[parentCellIndex].flags & MOVEFLAG_JUMP_LINKED)
+			return(false);
+		cellIndex = parentCellIndex;
+	}
+	return(true);
+}
+
+//---------------------------------------------------------------------------
+
+void MoveMap::resetSearch (void) {
+
+	//--------------------------------------------------------------
+	// Forget the last search but keep the costs and goals, and put
+	// the start back on the OPEN list...
+	int numMapCells = maxWidth * height;
+	unsigned int searchFlags = MOVEFLAG_OPEN + MOVEFLAG_CLOSED + MOVEFLAG_STEP + MOVEFLAG_JUMP_LINKED;
+	for (int i = 0; i < numMapCells; i++) {
+		map[i].clearFlag(searchFlags);
+		map[i].parent = -1;
+	}
+
+	MoveMapNodePtr startMapNode = &map[mapRowStartTable[startR] + startC];
+	startMapNode->g = 0;
+	startMapNode->fPrime = startMapNode->hPrime;
+
+	PQNode initialVertex;
+	initialVertex.key = startMapNode->fPrime;
+	initialVertex.id = mapRowStartTable[startR] + startC;
+	initialVertex.row = startR;
+	initialVertex.col = startC;
+	openList->clear();
+#ifdef _DEBUG
+	int insertErr = 
+#endif
+		openList->insert(initialVertex);
+	gosASSERT(insertErr == NO_ERR);
+	startMapNode->setFlag(MOVEFLAG_OPEN);
+}
+
+//---------------------------------------------------------------------------
+
 //#define DEBUG_PATH
 //#define BLOCKED_PATH_TEST
 //#define TIME_PATH
@@ -4987,6 +5356,8 @@ inline void MoveMap::propogateCostJUMP (long r, long c, long cost, long g) {
 
 long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* goalCell) {
 
+	GOS_PROFILE_ZONE("MoveMap::calcPath");
+
 	#ifdef TIME_PATH
 		L_INTEGER calcStart, calcStop;
 		QueryPerformanceCounter(calcStart);
@@ -5005,18 +5376,10 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 
 	//------------------------------------------------------------------
 	// Let's use their hPrime as a barrier for cutting off the search...
-	MaxHPrime = calcHPrime(startR, startC) * 2.5;
-	if (MaxHPrime < 500)
-		MaxHPrime = 500;
+	maxHPrime = calcHPrime(startR, startC) * 2.5;
+	if (maxHPrime < 500)
+		maxHPrime = 500;
 	
-	//-----------------------------------------------
-	// If we haven't already, create the OPEN list...
-	if (!openList) {
-		openList = new PriorityQueue;
-		gosASSERT(openList != NULL);
-		openList->init(5000);
-	}
-		
 	int curCol = startC;
 	int curRow = startR;
 	
@@ -5050,7 +5413,28 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 		numNodesVisited = 1;
 	#endif
 
-	while (!openList->isEmpty()) {
+	//-------------------------------------------------------------------
+	// If setUp picked jump point search, try that first. The search below
+	// is only run again to check it, or if the path it found can't be
+	// read back...
+	long jumpPointG = -1;
+	if (jumpPointSearch) {
+		goalFound = calcJumpPointPath(bestRow, bestCol);
+		bool researchPath = false;
+		if (JumpPointCheck) {
+			if (goalFound)
+				jumpPointG = map[mapRowStartTable[bestRow] + bestCol].g;
+			researchPath = true;
+			}
+		else if (goalFound)
+			researchPath = !linkJumpPoints(mapRowStartTable[bestRow] + bestCol);
+		if (researchPath) {
+			goalFound = false;
+			resetSearch();
+		}
+	}
+
+	while (!goalFound && !openList->isEmpty()) {
 
 		#ifdef DEBUG_MOVE_MAP
 			if (debugMoveMap) {
@@ -5142,7 +5526,7 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 					if (succMapNode->hPrime == HPRIME_NOT_CALCED)
 						succMapNode->hPrime = calcHPrime(mapRowTable[succCellIndex/*bestPQNode.id*/], mapColTable[succCellIndex/*bestPQNode.id*/]);
 
-					if (succMapNode->hPrime < MaxHPrime) {
+					if (succMapNode->hPrime < maxHPrime) {
 
 						#ifdef DEBUG_PATH
 							numNodesVisited++;
@@ -5238,6 +5622,13 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 			pathDebugFile = NULL;
 		}
 	#endif
+
+	if (jumpPointSearch && JumpPointCheck) {
+		long pathG = goalFound ? map[mapRowStartTable[bestRow] + bestCol].g : -1;
+		JumpPointChecks++;
+		if ((pathG > -1) && ((jumpPointG < 0) || (jumpPointG > pathG)))
+			JumpPointWorse++;
+	}
 	
 	if (goalFound) {
 		//-------------------------------------------
@@ -5343,18 +5734,6 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 				}
 			}
 			
-			//---------------------------------------------------------
-			// We need to set this table up our first time thru here...
-			static bool setTable = false;
-			if (!setTable) {
-				float cellLength = Terrain::worldUnitsPerCell * metersPerWorldUnit;
-				for (int i = 0; i < NUM_CELL_OFFSETS; i++) {
-					float distance = agsqrt( cellShift[i * 2], cellShift[i * 2 + 1] ) * cellLength;
-					cellShiftDistance[i] = distance;
-				}
-				setTable = true;
-			}
-			
 			while ((curRow != startR) || (curCol != startC)) {
 				curCell--;
 				long parent = reverseShift[map[mapRowStartTable[curRow] + curCol].parent];
@@ -5452,6 +5831,8 @@ long MoveMap::calcPath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* go
 
 long MoveMap::calcPathJUMP (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* goalCell) {
 
+	GOS_PROFILE_ZONE("MoveMap::calcPathJUMP");
+
 	#ifdef TIME_PATH
 		L_INTEGER calcStart, calcStop;
 		QueryPerformanceCounter(calcStart);
@@ -5489,17 +5870,9 @@ long MoveMap::calcPathJUMP (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int
 
 	//------------------------------------------------------------------
 	// Let's use their hPrime as a barrier for cutting off the search...
-	MaxHPrime = calcHPrime(startR, startC) * 2.5;
-	if (MaxHPrime < 500)
-		MaxHPrime = 500;
-	
-	//-----------------------------------------------
-	// If we haven't already, create the OPEN list...
-	if (!openList) {
-		openList = new PriorityQueue;
-		gosASSERT(openList != NULL);
-		openList->init(5000);
-	}
+	maxHPrime = calcHPrime(startR, startC) * 2.5;
+	if (maxHPrime < 500)
+		maxHPrime = 500;
 
     int curCol = startC;
 	int curRow = startR;
@@ -5611,7 +5984,7 @@ long MoveMap::calcPathJUMP (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int
 					if (succMapNode->hPrime == HPRIME_NOT_CALCED)
 						succMapNode->hPrime = calcHPrime(succRow, succCol);
 
-					if (succMapNode->hPrime < MaxHPrime) {
+					if (succMapNode->hPrime < maxHPrime) {
 
 						#ifdef DEBUG_PATH
 							numNodesVisited++;
@@ -5629,7 +6002,7 @@ long MoveMap::calcPathJUMP (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int
 						gosASSERT(cost > 0);
 						if (dir > 7) {
 							jumping = true;
-							if (JumpOnBlocked)
+							if (jumpOnBlocked)
 								cost = jump_cost_loc;
 							else
 								cost += jump_cost_loc;
@@ -5836,18 +6209,6 @@ long MoveMap::calcPathJUMP (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int
 				}
 			}
 			
-			//---------------------------------------------------------
-			// We need to set this table up our first time thru here...
-			static bool setTable = false;
-			if (!setTable) {
-				float cellLength = Terrain::worldUnitsPerCell * metersPerWorldUnit;
-				for (int i = 0; i < NUM_CELL_OFFSETS; i++) {
-					float distance = agsqrt( cellShift[i * 2], cellShift[i * 2 + 1] ) * cellLength;
-					cellShiftDistance[i] = distance;
-				}
-				setTable = true;
-			}
-			
 			while ((curRow != startR) || (curCol != startC)) {
 				curCell--;
 				int parent = reverseShift[map[curRow * maxWidth + curCol].parent];
@@ -5925,6 +6286,8 @@ long MoveMap::calcPathJUMP (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int
 
 long MoveMap::calcEscapePath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, long* goalCell) {
 
+	GOS_PROFILE_ZONE("MoveMap::calcEscapePath");
+
 	#ifdef TIME_PATH
 		L_INTEGER calcStart, calcStop;
 		QueryPerformanceCounter(calcStart);
@@ -5964,18 +6327,10 @@ long MoveMap::calcEscapePath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, l
 
 	//------------------------------------------------------------------
 	// Let's use their hPrime as a barrier for cutting off the search...
-	MaxHPrime = 500; //float2short(calcHPrime(startR, startC) * 2.5);
-	if (MaxHPrime < 500)
-		MaxHPrime = 500;
+	maxHPrime = 500; //float2short(calcHPrime(startR, startC) * 2.5);
+	if (maxHPrime < 500)
+		maxHPrime = 500;
 	
-	//-----------------------------------------------
-	// If we haven't already, create the OPEN list...
-	if (!openList) {
-		openList = new PriorityQueue;
-		gosASSERT(openList != NULL);
-		openList->init(5000);
-	}
-		
 	long curCol = startC;
 	long curRow = startR;
 	
@@ -6076,7 +6431,7 @@ long MoveMap::calcEscapePath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, l
 					if (succMapNode->hPrime == HPRIME_NOT_CALCED)
 						succMapNode->hPrime = 10; //calcHPrime(succRow, succCol);
 
-					if (succMapNode->hPrime < MaxHPrime) {
+					if (succMapNode->hPrime < maxHPrime) {
 
 						#ifdef DEBUG_PATH
 							numNodesVisited++;
@@ -6094,7 +6449,7 @@ long MoveMap::calcEscapePath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, l
 						// Diagonal movement is more costly...
 						if (dir > 7) {
 							jumping = true;
-							if (JumpOnBlocked)
+							if (jumpOnBlocked)
 								cost = jumpCost;
 							else
 								cost += jumpCost;
@@ -6298,18 +6653,6 @@ long MoveMap::calcEscapePath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, l
 				}
 			}
 			
-			//---------------------------------------------------------
-			// We need to set this table up our first time thru here...
-			static bool setTable = false;
-			if (!setTable) {
-				float cellLength = Terrain::worldUnitsPerCell * metersPerWorldUnit;
-				for (long i = 0; i < NUM_CELL_OFFSETS; i++) {
-					float distance = agsqrt( cellShift[i * 2], cellShift[i * 2 + 1] ) * cellLength;
-					cellShiftDistance[i] = distance;
-				}
-				setTable = true;
-			}
-			
 			while ((curRow != startR) || (curCol != startC)) {
 				curCell--;
 				long parent = reverseShift[map[curRow * maxWidth + curCol].parent];
@@ -6496,6 +6839,18 @@ void MoveMap::destroy (void) {
 		mapColTable = NULL;
 	}
 
+	if (jumpParent)
+	{
+		systemHeap->Free(jumpParent);
+		jumpParent = NULL;
+	}
+
+	if (openList)
+	{
+		delete openList;
+		openList = NULL;
+	}
+
 }
 
 //***************************************************************************
@@ -80,6 +80,9 @@ typedef enum {
 #define	MOVEFLAG_MOVER_HERE		16
 #define	MOVEFLAG_GOAL_BLOCKED	32
 #define	MOVEFLAG_OFFMAP			64
+#define	MOVEFLAG_JUMP_TESTED	128			// jump point search has looked at this cell's neighbours
+#define	MOVEFLAG_JUMP_UNIFORM	256			// ...and they, and the cell, are all clear or blocked
+#define	MOVEFLAG_JUMP_LINKED	512			// cell is on the path being linked up after a jump point search
 
 #define	CELLSTATE_OPEN			0
 #define	CELLSTATE_BLOCKED		1
@@ -135,6 +138,7 @@ typedef enum {
 #define	MOVEPARAM_WATER_DEEP				262144
 #define	MOVEPARAM_RANDOM_OPTIMAL			524288
 #define	MOVEPARAM_JUMP						1048576
+#define	MOVEPARAM_JUMP_POINTS				2097152
 
 #define	TACORDER_PARAM_NONE					0
 #define	TACORDER_PARAM_RUN					(1<<0)
@@ -290,6 +294,22 @@ typedef struct _ScenarioMapCellInfo {
 #define	MAPCELL_BUILD_NOT_SET_SHIFT		31
 #define	MAPCELL_BUILD_NOT_SET_MASK		0x80000000
 
+//---------------------------------------------------------------------
+// Move classes are the cell bits MoveMap::setUp bases a cell's cost on,
+// packed into a byte.  Paths get the cost of each class up front rather
+// than looking at the bits of every cell.
+#define	MOVECLASS_OFFMAP				0x01
+#define	MOVECLASS_IMPASSABLE			0x02
+#define	MOVECLASS_SHALLOW				0x04
+#define	MOVECLASS_DEEP					0x08
+#define	MOVECLASS_GATE					0x10
+#define	MOVECLASS_ROAD					0x20
+#define	MOVECLASS_FOREST				0x40
+#define	MOVECLASS_PATHLOCK				0x80
+
+#define	MOVECLASS_TERRAIN_MASK			0x7F
+#define	NUM_MOVECLASS_COSTS				128
+
 typedef struct _MapCell {
 	unsigned int data;
 
@@ -492,6 +512,27 @@ typedef struct _MapCell {
 			data |= MAPCELL_BUILD_NOT_SET_MASK;
 	}
 
+	unsigned char getMoveClass (DWORD level) {
+		unsigned char moveClass = 0;
+		if (data & MAPCELL_OFFMAP_MASK)
+			moveClass |= MOVECLASS_OFFMAP;
+		if (!(data & MAPCELL_PASSABLE_MASK))
+			moveClass |= MOVECLASS_IMPASSABLE;
+		if (data & MAPCELL_SHALLOW_MASK)
+			moveClass |= MOVECLASS_SHALLOW;
+		if (data & MAPCELL_DEEP_MASK)
+			moveClass |= MOVECLASS_DEEP;
+		if (data & MAPCELL_GATE_MASK)
+			moveClass |= MOVECLASS_GATE;
+		if (data & MAPCELL_ROAD_MASK)
+			moveClass |= MOVECLASS_ROAD;
+		if (data & MAPCELL_FOREST_MASK)
+			moveClass |= MOVECLASS_FOREST;
+		if (data & (MAPCELL_PATHLOCK_BASE << level))
+			moveClass |= MOVECLASS_PATHLOCK;
+		return(moveClass);
+	}
+
 } MapCell;
 
 typedef MapCell* MapCellPtr;
@@ -510,9 +551,13 @@ typedef PreservedCell* PreservedCellPtr;
 
 extern float VerticesMapSideDivTwo;
 extern float MetersMapSideDivTwo;
+extern float worldUnitsPerMeter;
 
 #define	MAX_DEBUG_CELLS		1000
 
+#define	LOS_BLOCK_DIM		15			//Cells per side of an LOS height block (five tiles)
+#define	LOS_HEIGHT_SLOP		1.0f		//World units added to every tile height.  Covers rounding in terrainElevation.
+
 class MissionMap {
 
 	public:
@@ -529,6 +574,23 @@ class MissionMap {
 		long				debugCells[MAX_DEBUG_CELLS][3];
 
 		void				(*placeMoversCallback) (void);
+
+		//------------------------------------------------------------------
+		// Highest point a line of sight can hit, for Team::lineOfSight.
+		// losTileHeight is the highest terrain vertex of each tile and never
+		// changes.  losBlockHeight adds the cells' local heights and is kept
+		// up to date by setLocalHeight.
+		float*				losTileHeight;
+		float*				losBlockHeight;
+		long				losTilesWide;
+		long				losBlocksWide;
+		long				losBlocksHigh;
+
+		//------------------------------------------------------------------
+		// Move class of every cell, one layer per pathlock level (the only
+		// bit that differs between them).  Built by buildMoveClasses and
+		// kept up to date by the setters of the bits that go into it.
+		unsigned char*		moveClass[NUM_MOVE_LEVELS];
 		
 	public:
 
@@ -544,6 +606,13 @@ class MissionMap {
 			numPreservedCells = 0;
 			placeMoversCallback = NULL;
 			numDebugCells = 0;  
+			losTileHeight = NULL;
+			losBlockHeight = NULL;
+			losTilesWide = 0;
+			losBlocksWide = 0;
+			losBlocksHigh = 0;
+			for (long i = 0; i < NUM_MOVE_LEVELS; i++)
+				moveClass[i] = NULL;
 		}
 		
 		MissionMap (void) {
@@ -598,6 +667,8 @@ class MissionMap {
 
 		void setGate (long row, long col, unsigned long gate) {
 			map[row * width + col].setGate(gate);
+			if (moveClass[0])
+				updateMoveClass(row, col);
 		}
 
 		bool getPassable (long row, long col) {
@@ -606,6 +677,8 @@ class MissionMap {
 
 		void setPassable (long row, long col, bool passable) {
 			map[row * width + col].setPassable(passable);
+			if (moveClass[0])
+				updateMoveClass(row, col);
 		}
 
 		bool getPassable (Stuff::Vector3D cellPosition);
@@ -616,6 +689,8 @@ class MissionMap {
 
 		void setPathlock (long level, long row, long col, bool pathlock) {
 			map[row * width + col].setPathlock(level, pathlock);
+			if (moveClass[0])
+				updateMoveClass(row, col);
 		}
 
 		unsigned long getMine (long row, long col) {
@@ -635,7 +710,10 @@ class MissionMap {
 		}
 
 		void setLocalHeight (long row, long col, DWORD localElevation) {
+			DWORD oldElevation = map[row * width + col].getLocalHeight();
 			map[row * width + col].setLocalHeight(localElevation);
+			if (losBlockHeight && (map[row * width + col].getLocalHeight() != oldElevation))
+				updateLOSHeight(row, col);
 		}
 
 		DWORD getLocalHeight (long row, long col) {
@@ -701,6 +779,36 @@ class MissionMap {
 			}
 		}
 
+		void buildLOSHeights (void);
+
+		void destroyLOSHeights (void);
+
+		void updateLOSHeight (long row, long col);
+
+		float calcLOSBlockHeight (long blockRow, long blockCol);
+
+		void buildMoveClasses (void);
+
+		void destroyMoveClasses (void);
+
+		void updateMoveClass (long row, long col) {
+			long index = row * width + col;
+			for (long i = 0; i < NUM_MOVE_LEVELS; i++)
+				moveClass[i][index] = map[index].getMoveClass(i);
+		}
+
+		//-------------------------------------------------------------------
+		// True if a line of sight at height is above everything in the cell,
+		// so Team::lineOfSight need not look up the terrain there.
+		bool isAboveLOSHeight (long row, long col, float losHeight) {
+			if (!losBlockHeight || (row < 0) || (row >= height) || (col < 0) || (col >= width))
+				return(false);
+			if (losHeight >= losBlockHeight[(row / LOS_BLOCK_DIM) * losBlocksWide + (col / LOS_BLOCK_DIM)])
+				return(true);
+			float localElev = (worldUnitsPerMeter * 4.0f * (float)map[row * width + col].getLocalHeight());
+			return(losHeight >= (losTileHeight[(row / MAPCELL_DIM) * losTilesWide + (col / MAPCELL_DIM)] + localElev));
+		}
+
 		DWORD getCellDebug (long row, long col) {
 			return(map[row * width + col].getDebug());
 		}
@@ -719,6 +827,8 @@ class MissionMap {
 
 		void setRoad (long row, long col, bool roadHere) {
 			map[row * width + col].setRoad(roadHere);
+			if (moveClass[0])
+				updateMoveClass(row, col);
 		}
 
 		bool getShallowWater (long row, long col) {
@@ -727,6 +837,8 @@ class MissionMap {
 
 		void setShallowWater (long row, long col, bool shallowWaterHere) {
 			map[row * width + col].setShallowWater(shallowWaterHere);
+			if (moveClass[0])
+				updateMoveClass(row, col);
 		}
 
 		bool getDeepWater (long row, long col) {
@@ -735,6 +847,8 @@ class MissionMap {
 
 		void setDeepWater (long row, long col, bool deepWaterHere) {
 			map[row * width + col].setDeepWater(deepWaterHere);
+			if (moveClass[0])
+				updateMoveClass(row, col);
 		}
 
 		bool getBuildGate (long row, long col) {
@@ -767,6 +881,8 @@ class MissionMap {
 
 		void setForest (long row, long col, bool set) {
 			map[row * width + col].setForest(set);
+			if (moveClass[0])
+				updateMoveClass(row, col);
 		}
 
 		bool getOffMap (long row, long col) {
@@ -775,6 +891,8 @@ class MissionMap {
 
 		void setOffMap (long row, long col, bool set) {
 			map[row * width + col].setOffMap(set);
+			if (moveClass[0])
+				updateMoveClass(row, col);
 		}
 
 		bool getBuildSpecial (long row, long col) {
@@ -964,11 +1082,6 @@ class MovePath {
 
 
 //******************************************************************************************
-#define	GLOBAL_FLAG_SPECIAL_IMPOSSIBLE	0x80
-#define	GLOBAL_FLAG_SPECIAL_CALC		0x40
-#define	GLOBAL_FLAG_NORMAL_OPENS		0x20
-#define	GLOBAL_FLAG_NORMAL_CLOSES		0x10
-
 #define	GLOBAL_CONFIDENCE_BAD			0
 #define GLOBAL_CONFIDENCE_AT_LEAST		1
 #define	GLOBAL_CONFIDENCE_GOOD			2
@@ -1072,6 +1185,34 @@ typedef struct _GlobalPathStep {
 
 typedef GlobalPathStep* GlobalPathStepPtr;
 
+//---------------------------------------------------------------------------
+// Door-to-door routes are cached per GlobalMap (so hover and normal movers
+// never share entries), keyed by start/goal area, mover team and whether
+// closed areas may be used. The start and goal cells only bias which door of
+// the start/goal area is picked, so they are not part of the key.
+
+#define	GLOBAL_PATH_CACHE_SIZE			64
+
+typedef struct _GlobalPathCacheStep {
+	int					thruArea;
+	int					goalDoor;
+	int					costToGoal;
+} GlobalPathCacheStep;
+
+typedef struct _GlobalPathCacheEntry {
+	int					startArea;
+	int					goalArea;
+	char				moverTeamID;
+	bool				useClosedAreas;
+	bool				valid;
+	uint32_t			gateSignature;		// state of gate areas for this team
+	uint32_t			lastUsed;
+	int					numSteps;
+	GlobalPathCacheStep	steps[MAX_GLOBAL_PATH];
+} GlobalPathCacheEntry;
+
+typedef GlobalPathCacheEntry* GlobalPathCacheEntryPtr;
+
 #define	MAX_SPECIAL_AREAS		1500
 #define	MAX_SPECIAL_SUB_AREAS	25
 #define	MAX_CELLS_PER_SUB_AREA	49
@@ -1123,11 +1264,12 @@ class GlobalMap {
 		DoorLinkPtr					doorLinks;
 		GlobalMapDoorPtr			doorBuildList;
         DoorInfoLinksPtr*           doorBuildList_links;
-#ifdef USE_PATH_COST_TABLE
-		unsigned char*				pathCostTable;
-#endif
 		unsigned char*				pathExistsTable;
 
+		GlobalPathCacheEntryPtr		pathCache;
+		uint32_t					pathCacheTime;
+		bool						pathCacheLocked;	// set while calcPath toggles gates
+
 		int						    numSpecialAreas;
 		GlobalSpecialAreaInfo*		specialAreas;	// used when building data
 
@@ -1211,6 +1353,10 @@ class GlobalMap {
 
 			isGateDisabledCallback = NULL;
 			isGateOpenCallback = NULL;
+
+			pathCache = NULL;
+			pathCacheTime = 0;
+			pathCacheLocked = false;
 		}
 
 		GlobalMap (void) {
@@ -1277,19 +1423,16 @@ class GlobalMap {
 
         long getPathCost (int startArea, int goalArea, bool withSpecialAreas, int& confidence, bool calcIt);
 
-#ifdef USE_PATH_COST_TABLE
-		void initPathCostTable (void);
+		void clearPathCache (void);
 
-		void resetPathCostTable (void);
+		void invalidatePathCache (long area);
 
-		void calcPathCostTable (void);
+		uint32_t calcGateSignature (void);
 
-		void setPathCost (long startArea, long goalArea, bool withSpecialAreas, unsigned char cost);
+		GlobalPathCacheEntryPtr findCachedPath (long startArea, long goalArea, uint32_t gateSignature);
 
-		void setPathFlag (long startArea, long goalArea, unsigned char flag, bool set);
+		void addCachedPath (long startArea, long goalArea, uint32_t gateSignature, GlobalPathStepPtr path, long numSteps);
 
-		long getPathFlag (long startArea, long goalArea, unsigned char flag);
-#endif
 		void clearPathExistsTable (void);
 
 		void setPathExists (long fromArea, long toArea, unsigned char set);
@@ -1460,6 +1603,11 @@ class MoveMap {
 		bool				moverWithdrawing;
 		bool				travelOffMap;
 		bool				cannotEnterOffMap;
+		bool				jumpPointSearch;	// set by setUp, calcPath uses jump point search
+		int*				jumpParent;			// jump point each node was reached from
+		bool				jumpOnBlocked;		// JumpOnBlocked, as it was when setUp ran
+		long				maxHPrime;			// search cutoff, set by calcPath
+		PriorityQueuePtr	openList;			// our own, so maps on different threads can search at once
 
 		void				(*blockedDoorCallback) (int moveLevel, int door, char* openCells);
 		void				(*placeStationaryMoversCallback) (MoveMapPtr map);
@@ -1475,6 +1623,19 @@ class MoveMap {
 		void propogateCost (long mapCellIndex, long cost, long g);
 		void propogateCostJUMP (long r, long c, long cost, long g);
 		int calcHPrime (int r, int c);
+		bool inThruArea (long row, long col);
+		long calcGateCost (long row, long col, long cellClass, bool followRoads);
+		void setCellCosts (unsigned long params, bool cullAreas);
+		bool canStep (long cellIndex, long dir);
+		bool jumpCellBlocked (long cellIndex);
+		bool jumpCellUniform (long cellIndex);
+		long jumpStraight (long cellIndex, long dir);
+		long jumpDiagonal (long cellIndex, long dir);
+		void addJumpPoint (long cellIndex, long fromCellIndex, long dir, long numSteps);
+		bool calcJumpPointPath (int& goalRow, int& goalCol);
+		bool linkJumpPoints (long goalCellIndex);
+		void resetSearch (void);
+		void prepareSearch (void);
 		
 	public:
 
@@ -1514,6 +1675,11 @@ class MoveMap {
 			calcTime = 0.0;
 			travelOffMap = false;
 			cannotEnterOffMap = true;
+			jumpPointSearch = false;
+			jumpParent = NULL;
+			jumpOnBlocked = false;
+			maxHPrime = 1000;
+			openList = NULL;
 			overlayWeightTable = NULL;
 			blockedDoorCallback = NULL;
 			placeStationaryMoversCallback = NULL;
@@ -1620,6 +1786,15 @@ class MoveMap {
 
 		long calcPathJUMP (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* goalCell);
 
+		//-----------------------------------------------------------
+		// Runs the search setUp's jump costs call for. Once setUp is
+		// done this may be called from any thread.
+		long search (MovePathPtr path, Stuff::Vector3D* goalWorldPos, int* goalCell) {
+			if (numOffsets > 8)
+				return(calcPathJUMP(path, goalWorldPos, goalCell));
+			return(calcPath(path, goalWorldPos, goalCell));
+		}
+
 		long calcEscapePath (MovePathPtr path, Stuff::Vector3D* goalWorldPos, long* goalCell);
 
 		float getDistanceFloat (long rowDelta, long colDelta) {
@@ -1666,6 +1841,10 @@ extern MissionMapPtr		GameMap;
 extern GlobalMapPtr			GlobalMoveMap[3];
 extern MoveMapPtr			PathFindMap[2];
 extern long					SimpleMovePathRange;
+extern bool					UseJumpPointSearch;
+extern bool					JumpPointCheck;
+extern long					JumpPointChecks;
+extern long					JumpPointWorse;
 
 //***************************************************************************
 
@@ -1280,17 +1280,12 @@ float yawRotation = 0.0f;
 
 #ifdef LAB_ONLY
 __int64 MCTimeTransformandLight 	= 0;
-__int64 MCTimeAnimationandMatrix	= 0;
-__int64 MCTimePerShapeTransform		= 0;
 #endif
 
 long TG_MultiShape::TransformMultiShape (Stuff::Point3D *pos, Stuff::UnitQuaternion *rot)
 {
     //Profile T&L so I can break out GameLogic from T&L
-#ifdef LAB_ONLY
-    __int64 x;
-    x=GetCycles();
-#endif
+    GOS_PROFILE_STAT("TG_MultiShape::TransformMultiShape",MCTimeTransformandLight);
 
     Stuff::LinearMatrix4D 	shapeOrigin;
     Stuff::LinearMatrix4D	shadowOrigin;
@@ -1633,29 +1628,14 @@ long TG_MultiShape::TransformMultiShape (Stuff::Point3D *pos, Stuff::UnitQuatern
         shapeToClip.Multiply(listOfShapes[i].shapeToWorld,TG_Shape::s_worldToClip);
         backFacePoint.Multiply(camPosition,listOfShapes[i].worldToShape);
 
-#ifdef LAB_ONLY
-        x=GetCycles()-x;
-        MCTimeAnimationandMatrix += x;
-        x=GetCycles();
-#endif
-
         listOfShapes[i].node->MultiTransformShape(&shapeToClip,&backFacePoint,listOfShapes[i].parentNode,isHudElement,alphaValue,isClamped);
 
         if (useShadows && d_useShadows)
         {
             listOfShapes[i].node->MultiTransformShadows(pos, &(listOfShapes[i].shapeToWorld),yawRotation);
         }
-
-#ifdef LAB_ONLY
-        x=GetCycles()-x;
-        MCTimePerShapeTransform += x;
-        x=GetCycles();
-#endif
     }
 
-#ifdef LAB_ONLY
-    MCTimeTransformandLight = MCTimeAnimationandMatrix + MCTimePerShapeTransform;
-#endif
     return(0);
 }	
 
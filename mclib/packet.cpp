@@ -20,6 +20,10 @@
 #include"lz.h"
 #endif
 
+#ifndef LOADGRAPH_H
+#include"loadgraph.h"
+#endif
+
 #include<zlib.h>
 
 //#ifndef _MBCS
@@ -35,6 +39,8 @@
 //---------------------------------------------------------------------------
 extern MemoryPtr 	LZPacketBuffer;
 extern unsigned int LZPacketBufferSize;
+
+MemoryPtr GetLZThreadBuffer (unsigned int size);
 //---------------------------------------------------------------------------
 // class PacketFile
 void PacketFile::clear (void)
@@ -293,6 +299,12 @@ int PacketFile::readPacket (int packet, unsigned char *buffer)
 			seek(packetBase);
 			result = read(buffer, packetSize);
 		}
+		else if (LoadGraph::copyPacket(this,currentPacket,buffer,packetUnpackedSize))
+		{
+			//-------------------------------------------------------
+			// Already unpacked on a worker during a mission load.
+			result = packetUnpackedSize;
+		}
 		else
 		{
 			switch (getStorageType())
@@ -411,6 +423,106 @@ int PacketFile::readPackedPacket (int packet, unsigned char *buffer)
 	return result;
 }
 
+//---------------------------------------------------------------------------
+int PacketFile::locatePacket (int packet, int &base, int &size, int &type, int &unpackedSize)
+{
+	if ((packet < 0) || (packet >= numPackets))
+		return(PACKET_OUT_OF_RANGE);
+
+	base = readPacketOffset(packet, &type);
+	if (base <= 0)
+		return(PACKET_OUT_OF_RANGE);
+
+	int next;
+	if ((packet + 1) == numPackets)
+		next = getLength();
+	else
+		next = readPacketOffset(packet + 1);
+
+	size = next - base;
+
+	switch (type)
+	{
+		case STORAGE_TYPE_LZD:
+		case STORAGE_TYPE_ZLIB:
+		{
+			// the first DWORD of a compressed packet is the unpacked length
+			unsigned int header = 0;
+			if (readAt(base,(MemoryPtr)&header,sizeof(header)) != sizeof(header))
+				return(READ_PAST_EOF_ERR);
+
+			unpackedSize = header;
+		}
+		break;
+
+		case STORAGE_TYPE_RAW:
+		case STORAGE_TYPE_FWF:
+			unpackedSize = size;
+			break;
+
+		case STORAGE_TYPE_NUL:
+			unpackedSize = 0;
+			break;
+
+		default:
+			return(BAD_PACKET_VERSION);
+	}
+
+	return(NO_ERR);
+}
+
+//---------------------------------------------------------------------------
+int PacketFile::getPacketSizeAt (int packet)
+{
+	int base, size, type, unpackedSize;
+	if (locatePacket(packet,base,size,type,unpackedSize) != NO_ERR)
+		return 0;
+
+	return unpackedSize;
+}
+
+//---------------------------------------------------------------------------
+int PacketFile::readPacketAt (int packet, unsigned char *buffer)
+{
+	int base, size, type, unpackedSize;
+	if (locatePacket(packet,base,size,type,unpackedSize) != NO_ERR)
+		return 0;
+
+	switch (type)
+	{
+		case STORAGE_TYPE_RAW:
+		case STORAGE_TYPE_FWF:
+			return readAt(base,buffer,size);
+
+		case STORAGE_TYPE_LZD:
+		case STORAGE_TYPE_ZLIB:
+		{
+			int packedSize = size - sizeof(unsigned int);
+			MemoryPtr packedData = GetLZThreadBuffer(packedSize);
+			if (!packedData || (readAt(base+sizeof(unsigned int),packedData,packedSize) != packedSize))
+				return 0;
+
+			if (type == STORAGE_TYPE_LZD)
+			{
+				long decompLength = LZDecomp(buffer,packedData,packedSize);
+				return (decompLength == unpackedSize) ? decompLength : 0;
+			}
+
+			unsigned long decompLength = unpackedSize;
+			if ((uncompress(buffer,&decompLength,packedData,packedSize) != Z_OK) || (decompLength != (unsigned long)unpackedSize))
+				return 0;
+
+			return decompLength;
+		}
+
+		case STORAGE_TYPE_HF:
+			STOP(("Tried to read a Huffman Compressed Packet.  No Longer Supported!!"));
+			break;
+	}
+
+	return 0;
+}
+
 //---------------------------------------------------------------------------
 int PacketFile::seekPacket (int packet)
 {
@@ -77,6 +77,8 @@ class PacketFile : public File
 		void atClose (void);
 		long afterOpen (void);
 
+		int locatePacket (int packet, int &base, int &size, int &type, int &unpackedSize);
+
 	public:
 
 		PacketFile (void);
@@ -98,6 +100,13 @@ class PacketFile : public File
 		int readPacket (int packet, unsigned char *buffer);
 		int readPackedPacket (int packet, unsigned char *buffer);
 
+		//-------------------------------------------------------------
+		// Reentrant versions for loader threads. These do not change the
+		// current packet or file position, so the main thread can keep
+		// using the calls above on the same PacketFile.
+		int getPacketSizeAt (int packet);
+		int readPacketAt (int packet, unsigned char *buffer);
+
 		int seekPacket (int packet);
 
 		void operator ++ (void);
@@ -24,42 +24,71 @@
 #endif
 
 #include<gameos.hpp>
+#include<string.h>
 //***************************************************************************
 // Class PriorityQueue
 //***************************************************************************
 
+PQTraceCallback PriorityQueue::traceCallback = NULL;
+
+//---------------------------------------------------------------------------
+
 int PriorityQueue::init (int max, int keyMinValue) {
 
 	//-------------------------
 	// Create the queue list...
-	pqList = (PQNode*)systemHeap->Malloc(sizeof(PQNode) * (max + 2));
+	pqList = (PQNode*)systemHeap->Malloc(sizeof(PQNode) * (max + 1));
 	gosASSERT (pqList != NULL);
 
-	//----------------------------------------------------------------------
-	// Note that two additional nodes are added, as the first and last nodes
-	// of the queue list are used as sentinels (to assist implementation
-	// execution speed)...
-	maxItems = max + 2;
+	//--------------------------------------------------------------------
+	// Heap is 1-based, so the first node of the list is never used. The
+	// id index starts empty and grows to fit the largest id inserted...
+	maxItems = max;
+	numItems = 0;
 	keyMin = keyMinValue;
+	idIndex = NULL;
+	idIndexSize = 0;
 	return(0);
 }
 
 //---------------------------------------------------------------------------
 
+void PriorityQueue::growIdIndex (uint32_t id) {
+
+	uint32_t newSize = idIndexSize ? idIndexSize : 1024;
+	while (newSize <= id)
+		newSize <<= 1;
+
+	int32_t* newIndex = (int32_t*)systemHeap->Malloc(sizeof(int32_t) * newSize);
+	gosASSERT(newIndex != NULL);
+	if (idIndex) {
+		memcpy(newIndex, idIndex, sizeof(int32_t) * idIndexSize);
+		systemHeap->Free(idIndex);
+	}
+	memset(newIndex + idIndexSize, 0, sizeof(int32_t) * (newSize - idIndexSize));
+	idIndex = newIndex;
+	idIndexSize = newSize;
+}
+
+//---------------------------------------------------------------------------
+
 void PriorityQueue::upHeap (int curIndex) {
 
 	PQNode startNode = pqList[curIndex];
-	long stopKey = startNode.key;
-	pqList[0].key = keyMin;
-	pqList[0].id = 0xFFFFFFFF;
-	
+	int32_t stopKey = startNode.key;
+
 	//--------------------
 	// sort up the heap...
-	while (pqList[curIndex/2].key >= stopKey) {
-		pqList[curIndex] = pqList[curIndex/2];
-		curIndex /= 2;
+	while (curIndex > 1) {
+		int parentIndex = curIndex >> 1;
+		if (pqList[parentIndex].key < stopKey)
+			break;
+		pqList[curIndex] = pqList[parentIndex];
+		setIndex(curIndex);
+		curIndex = parentIndex;
 	}
 	pqList[curIndex] = startNode;
+	setIndex(curIndex);
 }
 
 //---------------------------------------------------------------------------
@@ -69,6 +98,12 @@ int PriorityQueue::insert (PQNode& item) {
 	if (numItems == maxItems)
 		return(1);
 
+	if (traceCallback)
+		(*traceCallback)(PQ_TRACE_INSERT, item.key, item.id);
+
+	if (item.id >= idIndexSize)
+		growIdIndex(item.id);
+
 	pqList[++numItems] = item;
 	upHeap(numItems);
 	return(0);
@@ -81,20 +116,22 @@ void PriorityQueue::downHeap (int curIndex) {
 	//----------------------------------
 	// Start at the top from curIndex...
 	PQNode startNode = pqList[curIndex];
-	int stopKey = startNode.key;
+	int32_t stopKey = startNode.key;
 
 	//----------------------
 	// Sort down the heap...
-	while (curIndex <= numItems/2) {
+	while (curIndex <= numItems / 2) {
 		int nextIndex = curIndex << 1;
 		if ((nextIndex < numItems) && (pqList[nextIndex].key > pqList[nextIndex + 1].key))
 			nextIndex++;
 		if (stopKey <= pqList[nextIndex].key)
 			break;
 		pqList[curIndex] = pqList[nextIndex];
+		setIndex(curIndex);
 		curIndex = nextIndex;
 	}
 	pqList[curIndex] = startNode;
+	setIndex(curIndex);
 }
 
 //---------------------------------------------------------------------------
@@ -102,14 +139,22 @@ void PriorityQueue::downHeap (int curIndex) {
 void PriorityQueue::remove (PQNode& item) {
 
 	item = pqList[1];
-	pqList[1] = pqList[numItems--];
-	downHeap(1);
+	if (traceCallback)
+		(*traceCallback)(PQ_TRACE_REMOVE, item.key, item.id);
+	idIndex[item.id] = 0;
+	if (--numItems > 0) {
+		pqList[1] = pqList[numItems + 1];
+		downHeap(1);
+	}
 }
 
 //---------------------------------------------------------------------------
 
 void PriorityQueue::change (int itemIndex, int newValue) {
 
+	gosASSERT((itemIndex > 0) && (itemIndex <= numItems));
+	if (traceCallback)
+		(*traceCallback)(PQ_TRACE_CHANGE, newValue, pqList[itemIndex].id);
 	if (newValue > pqList[itemIndex].key) {
 		pqList[itemIndex].key = newValue;
 		downHeap(itemIndex);
@@ -122,50 +167,39 @@ void PriorityQueue::change (int itemIndex, int newValue) {
 
 //---------------------------------------------------------------------------
 
-int PriorityQueue::find (unsigned int id) {
+int PriorityQueue::findByKey (int32_t key, uint32_t id, int /*startIndex = 1*/) {
 
-	for (int index = 0; index <= numItems; index++)
-		if (pqList[index].id == id)
-        {
-			return(index);
-        }
+	int index = find(id);
+	if (index && (pqList[index].key == key))
+		return(index);
 	return(0);
 }
 
 //---------------------------------------------------------------------------
 
-int PriorityQueue::findByKey (int32_t key, uint32_t id, int startIndex/* = 1*/) {
-
-    int curIndex = startIndex;
+void PriorityQueue::clear (void) {
 
-    if(key == pqList[curIndex].key && pqList[curIndex].id == id)
-        return curIndex;
-
-    int nextIndex = curIndex << 1;
-    if(nextIndex <= numItems && pqList[nextIndex].key <= key)
-    {
-        int idx = findByKey(key, id, nextIndex);
-        if(idx != 0)
-            return idx;
-    }
-    nextIndex++;
-	// no need for this check because last item is at index numItems (see e.g. find())
-    if(nextIndex <= numItems && pqList[nextIndex].key <= key)
-    {
-        int idx = findByKey(key, id, nextIndex);
-        if(idx != 0)
-            return idx;
-    }
-
-    return(0);
+	//-----------------------------------------------------------------
+	// Only the ids still queued have a live index entry, so reset just
+	// those rather than the whole table...
+	if (traceCallback)
+		(*traceCallback)(PQ_TRACE_CLEAR, 0, 0);
+	for (int index = 1; index <= numItems; index++)
+		idIndex[pqList[index].id] = 0;
+	numItems = 0;
 }
 
 //---------------------------------------------------------------------------
 	
 void PriorityQueue::destroy (void) {
 
-	systemHeap->Free(pqList);
+	if (pqList)
+		systemHeap->Free(pqList);
 	pqList = NULL;
+	if (idIndex)
+		systemHeap->Free(idIndex);
+	idIndex = NULL;
+	idIndexSize = 0;
 	maxItems = 0;
 	numItems = 0;
 }
@@ -17,6 +17,11 @@
 //--------------------------------
 // Structure and Class Definitions
 
+//---------------------------------------------------------------------------
+// Open list for the MoveMap/GlobalMap A* searches. Binary min-heap (1-based,
+// pqList[0] unused) with a position table indexed by node id, so find() and
+// change() no longer scan the list.
+
 typedef struct _PQNode {
 	int32_t         key;			// sort value
 	uint32_t        id;				// hash value for this map position
@@ -24,6 +29,25 @@ typedef struct _PQNode {
 	int32_t         col;			// HB-specific
 } PQNode;
 
+//---------------------------------------------------------------------------
+// Open list traffic can be recorded (-pqtrace in game, jpstest) and replayed
+// by pqbench.  Each search starts with a clear.
+
+#define	PQ_TRACE_CLEAR		0
+#define	PQ_TRACE_INSERT		1
+#define	PQ_TRACE_REMOVE		2
+#define	PQ_TRACE_CHANGE		3
+
+#define	PQ_TRACE_ID			0x52545150		// "PQTR", start of a trace file
+
+typedef struct _PQTraceRecord {
+	int32_t			op;
+	int32_t			key;
+	uint32_t		id;
+} PQTraceRecord;
+
+typedef void (*PQTraceCallback)(int op, int32_t key, uint32_t id);
+
 class PriorityQueue {
 
 	protected:
@@ -33,15 +57,29 @@ class PriorityQueue {
 		int32_t     numItems;
 		int32_t     keyMin;
 
+		int32_t*	idIndex;		// id -> heap index (0 == not queued)
+		uint32_t	idIndexSize;
+
 		void downHeap (int curIndex);
 
 		void upHeap (int curIndex);
 
+		void growIdIndex (uint32_t id);
+
+		void setIndex (int index) {
+			idIndex[pqList[index].id] = index;
+		}
+
 	public:
 
+		static PQTraceCallback	traceCallback;		// NULL unless traffic is being recorded
+
 		void init (void) {
 			pqList = NULL;
+			maxItems = 0;
 			numItems = 0;
+			idIndex = NULL;
+			idIndexSize = 0;
 		}
 
 		PriorityQueue (void) {
@@ -50,19 +88,27 @@ class PriorityQueue {
 
 		int init (int maxItems, int keyMinValue = -2000000);
 
+		//-----------------------------------------------------------------
+		// Sizes the id index for ids below numIds up front, so insert()
+		// doesn't allocate for them.  Searches on other threads need this.
+		void reserveIds (uint32_t numIds) {
+			if (numIds > idIndexSize)
+				growIdIndex(numIds - 1);
+		}
+
 		int insert (PQNode& item);
 
 		void remove (PQNode& item);
 
 		void change (int itemIndex, int newValue);
 
-		int find (unsigned int id);
+		int find (unsigned int id) {
+			return((id < idIndexSize) ? idIndex[id] : 0);
+		}
 
 		int findByKey (int32_t key, uint32_t id, int startIndex = 1);
 		
-		void clear (void) {
-			numItems = 0;
-		}
+		void clear (void);
 
 		int getNumItems (void) { return(numItems); }
 		
@@ -0,0 +1,213 @@
+//---------------------------------------------------------------------------
+//
+// spatialgrid.cpp - This file contains the class functions for SpatialGrid
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+//---------------------------------------------------------------------------
+// Include files
+
+#ifndef SPATIALGRID_H
+#include"spatialgrid.h"
+#endif
+
+#ifndef HEAP_H
+#include"heap.h"
+#endif
+
+#include<string.h>
+#include<gameos.hpp>
+
+//---------------------------------------------------------------------------
+// class SpatialGrid
+long SpatialGrid::init (float left, float bottom, float width, float height, float newCellSize, long newMaxEntries)
+{
+	destroy();
+
+	gosASSERT((newCellSize > 0.0f) && (newMaxEntries > 0));
+
+	originX = left;
+	originY = bottom;
+	cellSize = newCellSize;
+	oneOverCellSize = 1.0f / newCellSize;
+
+	cellsWide = long(width * oneOverCellSize) + 1;
+	cellsHigh = long(height * oneOverCellSize) + 1;
+	if (cellsWide < 1)
+		cellsWide = 1;
+	if (cellsHigh < 1)
+		cellsHigh = 1;
+
+	maxEntries = newMaxEntries;
+	numEntries = 0;
+
+	long numCells = cellsWide * cellsHigh;
+	cellStart = (long *)systemHeap->Malloc(sizeof(long) * (numCells + 1));
+	cellEntries = (long *)systemHeap->Malloc(sizeof(long) * maxEntries);
+	entryCell = (long *)systemHeap->Malloc(sizeof(long) * maxEntries);
+	entryX = (float *)systemHeap->Malloc(sizeof(float) * maxEntries);
+	entryY = (float *)systemHeap->Malloc(sizeof(float) * maxEntries);
+
+	if (!cellStart || !cellEntries || !entryCell || !entryX || !entryY)
+	{
+		destroy();
+		return(-1);
+	}
+
+	memset(cellStart,0,sizeof(long) * (numCells + 1));
+	return(NO_ERR);
+}
+
+//---------------------------------------------------------------------------
+void SpatialGrid::destroy (void)
+{
+	if (cellStart)
+		systemHeap->Free(cellStart);
+
+	if (cellEntries)
+		systemHeap->Free(cellEntries);
+
+	if (entryCell)
+		systemHeap->Free(entryCell);
+
+	if (entryX)
+		systemHeap->Free(entryX);
+
+	if (entryY)
+		systemHeap->Free(entryY);
+
+	init();
+}
+
+//---------------------------------------------------------------------------
+long SpatialGrid::cellX (float x)
+{
+	long result = long((x - originX) * oneOverCellSize);
+	if (result < 0)
+		result = 0;
+	else if (result >= cellsWide)
+		result = cellsWide - 1;
+	return(result);
+}
+
+//---------------------------------------------------------------------------
+long SpatialGrid::cellY (float y)
+{
+	long result = long((y - originY) * oneOverCellSize);
+	if (result < 0)
+		result = 0;
+	else if (result >= cellsHigh)
+		result = cellsHigh - 1;
+	return(result);
+}
+
+//---------------------------------------------------------------------------
+void SpatialGrid::clear (long newNumEntries)
+{
+	gosASSERT((newNumEntries >= 0) && (newNumEntries <= maxEntries));
+
+	numEntries = newNumEntries;
+	for (long i=0;i<numEntries;i++)
+		entryCell[i] = -1;
+}
+
+//---------------------------------------------------------------------------
+void SpatialGrid::setEntry (long entry, float x, float y)
+{
+	gosASSERT((entry >= 0) && (entry < numEntries));
+
+	entryX[entry] = x;
+	entryY[entry] = y;
+	entryCell[entry] = cellX(x) + cellY(y) * cellsWide;
+}
+
+//---------------------------------------------------------------------------
+void SpatialGrid::build (void)
+{
+	long numCells = cellsWide * cellsHigh;
+
+	//--------------------------------------------------------
+	// Count each cell, then turn the counts into end offsets.
+	memset(cellStart,0,sizeof(long) * (numCells + 1));
+	for (long i=0;i<numEntries;i++)
+	{
+		if (entryCell[i] > -1)
+			cellStart[entryCell[i]]++;
+	}
+
+	for (long c=1;c<numCells;c++)
+		cellStart[c] += cellStart[c - 1];
+	cellStart[numCells] = cellStart[numCells - 1];
+
+	//------------------------------------------------------------
+	// Fill back to front so each cell ends up in ascending order
+	// and cellStart ends up pointing at the start of each cell.
+	for (long i=numEntries-1;i>=0;i--)
+	{
+		if (entryCell[i] > -1)
+			cellEntries[--cellStart[entryCell[i]]] = i;
+	}
+}
+
+//---------------------------------------------------------------------------
+void SpatialGrid::markInRange (float x, float y, float radius, DWORD *mask)
+{
+	long left = cellX(x - radius);
+	long right = cellX(x + radius);
+	long bottom = cellY(y - radius);
+	long top = cellY(y + radius);
+
+	//---------------------------------------------------------------
+	// The cells of a row sit next to each other in cellEntries, so
+	// each row of the box is one run.
+	float radiusSquared = radius * radius;
+	for (long cy=bottom;cy<=top;cy++)
+	{
+		long first = cellStart[left + cy * cellsWide];
+		long last = cellStart[right + 1 + cy * cellsWide];
+		for (long i=first;i<last;i++)
+		{
+			long entry = cellEntries[i];
+			float dx = entryX[entry] - x;
+			float dy = entryY[entry] - y;
+			DWORD inRange = ((dx * dx + dy * dy) <= radiusSquared);
+			mask[entry >> 5] |= (inRange << (entry & 31));
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+long SpatialGrid::listMarked (const DWORD *mask, long *results, long maxResults)
+{
+	long numResults = 0;
+	long numWords = SPATIAL_GRID_MASK_WORDS(numEntries);
+	for (long w=0;w<numWords;w++)
+	{
+		DWORD bits = mask[w];
+		long entry = w << 5;
+		while (bits && (numResults < maxResults))
+		{
+			if (!(bits & 0xFF))
+			{
+				bits >>= 8;
+				entry += 8;
+				continue;
+			}
+
+			if (bits & 1)
+			{
+				if (entry < numEntries)
+					results[numResults++] = entry;
+			}
+
+			bits >>= 1;
+			entry++;
+		}
+	}
+
+	return(numResults);
+}
+
+//---------------------------------------------------------------------------
@@ -0,0 +1,123 @@
+//---------------------------------------------------------------------------
+//
+// spatialgrid.h - This file contains the class declaration for SpatialGrid
+//
+//				A SpatialGrid is a uniform 2D grid over the map holding
+//				numbered points (the game uses it for movers).  It is
+//				rebuilt from scratch with setEntry/build, which is a
+//				counting sort, and answers "which entries are within this
+//				radius" by only looking at the cells the circle touches.
+//				Results are bit masks so several queries can be merged.
+//
+//				listMarked gives entries back in ascending order so code
+//				which used to walk the whole list visits things in the
+//				same order it always did.
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+//---------------------------------------------------------------------------
+// Include files
+
+#ifndef DSTD_H
+#include"dstd.h"
+#endif
+
+//---------------------------------------------------------------------------
+// Macro Definitions
+#define SPATIAL_GRID_MASK_WORDS(n)		(((n) + 31) >> 5)
+
+//---------------------------------------------------------------------------
+class SpatialGrid
+{
+	//Data Members
+	//-------------
+	protected:
+		float			originX;				//World position of the low x, low y corner
+		float			originY;
+		float			cellSize;				//World units across each cell
+		float			oneOverCellSize;
+		long			cellsWide;
+		long			cellsHigh;
+
+		long			maxEntries;
+		long			numEntries;
+
+		long			*cellStart;				//cellsWide * cellsHigh + 1.  Entries of cell c are cellEntries[cellStart[c]..cellStart[c+1])
+		long			*cellEntries;			//Entry numbers sorted by cell, ascending inside each cell
+		long			*entryCell;				//Cell of each entry, -1 if it was left out
+		float			*entryX;				//Position of each entry as of last setEntry
+		float			*entryY;
+
+	//Member Functions
+	//-----------------
+	public:
+
+		void init (void)
+		{
+			originX = originY = 0.0f;
+			cellSize = oneOverCellSize = 0.0f;
+			cellsWide = cellsHigh = 0;
+
+			maxEntries = numEntries = 0;
+
+			cellStart = cellEntries = entryCell = NULL;
+			entryX = entryY = NULL;
+		}
+
+		SpatialGrid (void)
+		{
+			init();
+		}
+
+		//Covers [left, left + width) x [bottom, bottom + height).  Points outside go into the edge cells.
+		long init (float left, float bottom, float width, float height, float newCellSize, long newMaxEntries);
+
+		void destroy (void);
+
+		~SpatialGrid (void)
+		{
+			destroy();
+		}
+
+		bool isReady (void)
+		{
+			return(cellStart != NULL);
+		}
+
+		long getMaxEntries (void)
+		{
+			return(maxEntries);
+		}
+
+		long getNumEntries (void)
+		{
+			return(numEntries);
+		}
+
+		//Starts a rebuild with entries [0, newNumEntries), all left out until set.
+		void clear (long newNumEntries);
+
+		void setEntry (long entry, float x, float y);
+
+		//Sorts the entries set since clear into their cells.
+		void build (void);
+
+		//Sets the bit of every entry within radius of x, y in mask, which must have
+		//SPATIAL_GRID_MASK_WORDS(getMaxEntries()) words.  Bits already set are kept.
+		void markInRange (float x, float y, float radius, DWORD *mask);
+
+		//Lists the entries whose bit is set in mask in ascending order.
+		long listMarked (const DWORD *mask, long *results, long maxResults);
+
+	protected:
+
+		long cellX (float x);
+		long cellY (float y);
+};
+
+//---------------------------------------------------------------------------
+#endif
@@ -618,6 +618,8 @@ void TG_TypeShape::destroy (void)
 		TG_Shape::tglHeap->Free(listOfTextures);
 	listOfTextures = NULL;
 
+	FreeVertexLanes();
+
 	numTypeVertices = numTypeTriangles = numTextures = 0;
 
 	if (vb_) {
@@ -1606,6 +1608,41 @@ void TG_TypeShape::movePosRelativeCenterNode (void)
 	{
 		listOfTypeVertices[i].position -= nodeCenter;
 	}
+
+	FreeVertexLanes();		//Positions changed, rebuild on next transform.
+}
+
+//-------------------------------------------------------------------------------
+//Returns the SoA copy of the type vertices the batched transform reads from.
+//Type vertices only change at load time so this is built once per shape.
+const TG_VertexLanes &TG_TypeShape::GetVertexLanes (void)
+{
+	if (!vertexLanes.px && numTypeVertices)
+	{
+		void *laneMemory = TG_Shape::tglHeap->Malloc(TG_VertexLanesSize(numTypeVertices));
+		gosASSERT(laneMemory != NULL);
+
+		TG_SetVertexLanes(vertexLanes,laneMemory,numTypeVertices);
+		for (long i=0;i<numTypeVertices;i++)
+		{
+			vertexLanes.px[i] = listOfTypeVertices[i].position.x;
+			vertexLanes.py[i] = listOfTypeVertices[i].position.y;
+			vertexLanes.pz[i] = listOfTypeVertices[i].position.z;
+			vertexLanes.nx[i] = listOfTypeVertices[i].normal.x;
+			vertexLanes.ny[i] = listOfTypeVertices[i].normal.y;
+			vertexLanes.nz[i] = listOfTypeVertices[i].normal.z;
+		}
+	}
+
+	return vertexLanes;
+}
+
+//-------------------------------------------------------------------------------
+void TG_TypeShape::FreeVertexLanes (void)
+{
+	if (vertexLanes.px)
+		TG_Shape::tglHeap->Free(vertexLanes.px);
+	memset(&vertexLanes,0,sizeof(vertexLanes));
 }
 
 
@@ -1674,51 +1711,151 @@ long TG_Shape::MultiTransformShape (Stuff::Matrix4D *shapeToClip, Stuff::Point3D
 
 	lastTurnTransformed = turn;
 
-	
-	for (long j=0;j<numVertices;j++)
+	//-------------------------------------------------
+	// Vertices are transformed and lit in blocks of
+	// TG_XFORM_BLOCK from the SoA copy of the type vertices.
+	// See tglxform.cpp.
+	const TG_VertexLanes &lanes = theShape->GetVertexLanes();
+	gosASSERT(lanes.count >= (DWORD)numVertices);
+
+	TG_XformParams xformParams;
+	for (long r=0;r<4;r++)
 	{
-		Stuff::Point3D pos = theShape->listOfTypeVertices[j].position;
-		if (shapeScalar > 0.0f)
-			pos *= shapeScalar;
-			
-		Stuff::Vector4D xformCoords;
-		Stuff::Vector4D screen;
+		for (long c=0;c<4;c++)
+			xformParams.m[r][c] = (*shapeToClip)(r,c);
+	}
+
+	xformParams.scale = shapeScalar;
+	xformParams.viewMulX = viewMulX;
+	xformParams.viewAddX = viewAddX;
+	xformParams.viewMulY = viewMulY;
+	xformParams.viewAddY = viewAddY;
+	xformParams.perspective = eye->usePerspective;
 
-		xformCoords.Multiply(pos,*shapeToClip);
+	//-------------------------------------------------
+	// Lights which only depend on the vertex normal are
+	// summed by TG_LightBlock.  The rest are done below
+	// one vertex at a time.
+	bool useBlockLighting = useVertexLighting && (Environment.Renderer != 3) && !isSpotlight && !isWindow;
 
-		if (eye->usePerspective)
+	TG_XformLight blockLights[MAX_LIGHTS_IN_WORLD];
+	long numBlockLights = 0;
+
+	long vertexLights[MAX_LIGHTS_IN_WORLD];
+	long numVertexLights = 0;
+
+	if (useBlockLighting)
+	{
+		for (long i=0;i<s_numLights;i++)
 		{
-			//---------------------------------------
-			// Perspective Transform
-			float rhw = 1.0f;
-			if (xformCoords.w != 0.0f)
-				rhw = 1.0f / xformCoords.w;
-			
-			screen.x = (xformCoords.x * rhw) * viewMulX + viewAddX;
-			screen.y = (xformCoords.y * rhw) * viewMulY + viewAddY;
-			screen.z = (xformCoords.z * rhw);
-			screen.w = fabs(rhw);
+			if ((s_listOfLights[i] == NULL) || !(s_listOfLights[i]->active))
+				continue;
+
+			DWORD startLight = s_listOfLights[i]->GetaRGB();
+			switch (s_listOfLights[i]->lightType)
+			{
+				case TG_LIGHT_INFINITE:
+				{
+					TG_XformLight &light = blockLights[numBlockLights++];
+					light.dirX = s_lightDir[i].x;
+					light.dirY = s_lightDir[i].y;
+					light.dirZ = s_lightDir[i].z;
+					light.red = float((startLight>>16) & 0x000000ff);
+					light.green = float((startLight>>8) & 0x000000ff);
+					light.blue = float((startLight) & 0x000000ff);
+					light.specular = false;
+				}
+				break;
+
+				case TG_LIGHT_POINT:
+				{
+					Stuff::Point3D vertexToLight;
+					vertexToLight = s_lightDir[i];
+					float length = vertexToLight.GetApproximateLength();
+
+					//Object in center of light gets nothing.  Never did!
+					float falloff = 1.0f;
+					if ((length > Stuff::SMALL) && s_listOfLights[i]->GetFalloff(length, falloff))
+					{
+						vertexToLight.Normalize(vertexToLight);
+
+						TG_XformLight &light = blockLights[numBlockLights++];
+						light.dirX = vertexToLight.x;
+						light.dirY = vertexToLight.y;
+						light.dirZ = vertexToLight.z;
+						light.red = float((startLight>>16) & 0x000000ff) * falloff;
+						light.green = float((startLight>>8) & 0x000000ff) * falloff;
+						light.blue = float((startLight) & 0x000000ff) * falloff;
+						light.specular = true;
+					}
+				}
+				break;
+
+				case TG_LIGHT_SPOT:
+				{
+					Stuff::Point3D vertexToLight;
+					vertexToLight = s_lightDir[i];
+
+					//-------------------------------------------------
+					// Defines the actual spot of light on the ground
+					float length = vertexToLight.GetApproximateLength();
+
+					//-------------------------------------------------
+					// Defines the REAL direction of the spot light.
+					vertexToLight = s_spotDir[i];
+					if (vertexToLight.GetApproximateLength() > Stuff::SMALL)
+						vertexToLight.Normalize(vertexToLight);
+					else
+						length = 99999999999999.0f;
+
+					float falloff = 1.0f;
+					if (s_listOfLights[i]->GetFalloff(length, falloff))
+					{
+						TG_XformLight &light = blockLights[numBlockLights++];
+						light.dirX = vertexToLight.x;
+						light.dirY = vertexToLight.y;
+						light.dirZ = vertexToLight.z;
+						light.red = float((startLight>>16) & 0x000000ff) * falloff;
+						light.green = float((startLight>>8) & 0x000000ff) * falloff;
+						light.blue = float((startLight) & 0x000000ff) * falloff;
+						light.specular = true;
+					}
+				}
+				break;
+
+				default:
+					vertexLights[numVertexLights++] = i;
+				break;
+			}
 		}
-		else
+	}
+
+	TG_XformBlock xformBlock;
+
+	for (long j=0;j<numVertices;j++)
+	{
+		long b = j & (TG_XFORM_BLOCK - 1);
+		if (b == 0)
 		{
-			//---------------------------------------
-			// Parallel Transform	
-			screen.x = (1.0f - xformCoords.x) * viewMulX + viewAddX;
-			screen.y = (1.0f - xformCoords.y) * viewMulY + viewAddY;
-			screen.z = xformCoords.z;
-			screen.w = 0.000001f;
-		}
+			DWORD blockCount = numVertices - j;
+			if (blockCount > TG_XFORM_BLOCK)
+				blockCount = TG_XFORM_BLOCK;
+
+			long xformFlags = TG_TransformBlock(xformParams,lanes,j,blockCount,xformBlock);
+			if (xformFlags & TG_XFORM_ONE_OFF)
+				oneOff = TRUE;
 
-		if ((screen.x < 0) || (screen.y < 0) || (screen.x >= viewMulX) || (screen.y >= viewMulY))
-			oneOff = TRUE;
+			if (xformFlags & TG_XFORM_ONE_ON)
+				oneOn = TRUE;
 
-		if ((screen.x >= 0) && (screen.y >= 0) && (screen.x < viewMulX) && (screen.y <= viewMulY))
-			oneOn = TRUE;
+			if (useBlockLighting)
+				TG_LightBlock(blockLights,numBlockLights,lanes,j,blockCount,xformBlock);
+		}
 
-		listOfVertices[j].x = screen.x;
-		listOfVertices[j].y = screen.y;
-		listOfVertices[j].z = screen.z;
-		listOfVertices[j].rhw = screen.w;
+		listOfVertices[j].x = xformBlock.x[b];
+		listOfVertices[j].y = xformBlock.y[b];
+		listOfVertices[j].z = xformBlock.z[b];
+		listOfVertices[j].rhw = xformBlock.rhw[b];
 		listOfVertices[j].frgb = fogRGB;
 		memset(&listOfColors[j],0,sizeof(listOfColors[j]));
 
@@ -1841,256 +1978,95 @@ long TG_Shape::MultiTransformShape (Stuff::Matrix4D *shapeToClip, Stuff::Point3D
 		{
 			if (!isSpotlight && !isWindow)
 			{
-				for (long i=0;i<s_numLights;i++)
+				for (long v=0;v<numVertexLights;v++)
 				{
-					if ((s_listOfLights[i] != NULL) && (s_listOfLights[i]->active))
+					long i = vertexLights[v];
+					DWORD startLight = s_listOfLights[i]->GetaRGB();
+					switch (s_listOfLights[i]->lightType)
 					{
-						DWORD startLight = s_listOfLights[i]->GetaRGB();
-						switch (s_listOfLights[i]->lightType)
+						case TG_LIGHT_AMBIENT:
 						{
-							case TG_LIGHT_AMBIENT:
-							{
-								redAmb = ((startLight>>16) & 0x000000ff);
-								greenAmb = ((startLight>>8) & 0x000000ff);
-								blueAmb = ((startLight) & 0x000000ff);
-							}
-							break;
-	
-							case TG_LIGHT_INFINITE:
-							{
-								float cosine = s_lightDir[i].x * theShape->listOfTypeVertices[j].normal.x;
-								cosine += s_lightDir[i].y * theShape->listOfTypeVertices[j].normal.y;
-								cosine += s_lightDir[i].z * theShape->listOfTypeVertices[j].normal.z;
+							redAmb = ((startLight>>16) & 0x000000ff);
+							greenAmb = ((startLight>>8) & 0x000000ff);
+							blueAmb = ((startLight) & 0x000000ff);
+						}
+						break;
 
-								if (cosine < 0.0f)
-								{
-									float cos = fabs(cosine);
-									float red = float((startLight>>16) & 0x000000ff) * cos;
-									float green = float((startLight>>8) & 0x000000ff) * cos;
-									float blue = float((startLight) & 0x000000ff) * cos;
+						case TG_LIGHT_INFINITEWITHFALLOFF:
+						{
+							Stuff::Point3D vertexToLight;
+							vertexToLight = s_lightToShape[i];
+							vertexToLight -= theShape->listOfTypeVertices[j].position;
 
-									redFinal += float2long(red);
-									greenFinal += float2long(green);
-									blueFinal += float2long(blue);
+							float length = vertexToLight.GetApproximateLength();
 
-									/*
-									//-----------------------
-									// Run Specular next.
-									// Mirror the Light vector.
-									// Then DOT with Camera vector.
-									// Mul Result by itself 4 times.
-									// Mul that result by shinyness.
-									// Multiply THAT through color and apply!
-									float mirrorScalar = cosine * 2.0f;
-									Stuff::Vector3D MirrorVector(listOfVertices[i].normal);
-									MirrorVector *= mirrorScalar;
-									MirrorVector.Subtract(MirrorVector,s_lightDir[i]);
-									MirrorVector.Normalize(MirrorVector);
-
-									Stuff::Vector3D SpecPoint;
-									if (turn > 3)
-										SpecPoint.Normalize(*backFacePoint);
-									float specular = SpecPoint.x * MirrorVector.x;
-									specular += SpecPoint.y * MirrorVector.y;
-									specular += SpecPoint.z * MirrorVector.z;
-
-									if (specular < 0.0f)
-									{
-										//specular = fabs(specular);
-										specular *= specular;
-										specular *= specular;
-										specular *= specular;
-										specular *= specular;
-
-										specular *= 1.0f;	
-										// For now, a shinyness of 1.0f.  Perfect reflection!
-										// Multiplies will make specular positive!
-										float red = float((startLight>>16) & 0x000000ff) * specular;
-										float green = float((startLight>>8) & 0x000000ff) * specular;
-										float blue = float((startLight) & 0x000000ff) * specular;
+							float falloff = 1.0f;
 
-										redSpec += (DWORD)red;
-										greenSpec += (DWORD)green;
-										blueSpec += (DWORD)blue;
-									}
-									*/
-								}
-							}
-							break;
-	
-							case TG_LIGHT_INFINITEWITHFALLOFF:
+							float red,green,blue;
+
+							if (s_listOfLights[i]->GetFalloff(length, falloff))
 							{
-								Stuff::Point3D vertexToLight;
-								vertexToLight = s_lightToShape[i];
-								vertexToLight -= theShape->listOfTypeVertices[j].position;
-	
-								float length = vertexToLight.GetApproximateLength();
-	
-								float falloff = 1.0f;
-	
-								float red,green,blue;
-	
-								if (s_listOfLights[i]->GetFalloff(length, falloff))
-								{
-									float cosine = -(s_lightDir[i] * (theShape->listOfTypeVertices[j].normal));
-	
-									red = float((startLight>>16) & 0x000000ff) * falloff;
-									green = float((startLight>>8) & 0x000000ff) * falloff;
-									blue = float((startLight) & 0x000000ff) * falloff;
-	
-									red *= cosine;
-									green *= cosine;
-									blue *= cosine;
-	
-									redFinal += (DWORD)red;
-									greenFinal += (DWORD)green;
-									blueFinal += (DWORD)blue;
-								}
+								float cosine = -(s_lightDir[i] * (theShape->listOfTypeVertices[j].normal));
+
+								red = float((startLight>>16) & 0x000000ff) * falloff;
+								green = float((startLight>>8) & 0x000000ff) * falloff;
+								blue = float((startLight) & 0x000000ff) * falloff;
+
+								red *= cosine;
+								green *= cosine;
+								blue *= cosine;
+
+								redFinal += (DWORD)red;
+								greenFinal += (DWORD)green;
+								blueFinal += (DWORD)blue;
 							}
-							break;
-	
-							case TG_LIGHT_POINT:
+						}
+						break;
+							  
+						case TG_LIGHT_TERRAIN:
+						{
+							if (useShadows)
 							{
 								Stuff::Point3D vertexToLight;
-								vertexToLight = s_lightDir[i];
+								Stuff::Vector3D pos = theShape->listOfTypeVertices[j].position;
+								RotateLight(pos,yawRotation);
+								vertexToLight.Add(s_lightDir[i],pos);
 								float length = vertexToLight.GetApproximateLength();
 	
 								if (length > Stuff::SMALL)
 								{	
-									vertexToLight.Normalize(vertexToLight);
-		
 									float falloff = 1.0f;
-		
 									if (s_listOfLights[i]->GetFalloff(length, falloff))
 									{
-										float cosine = vertexToLight * (theShape->listOfTypeVertices[j].normal);
-		
 										float red,green,blue;
 		
-										if (cosine < 0.0f)
-										{
-											cosine = fabs(cosine);
-											red = float((startLight>>16) & 0x000000ff) * falloff;
-											green = float((startLight>>8) & 0x000000ff) * falloff;
-											blue = float((startLight) & 0x000000ff) * falloff;
-		
-											red *= cosine;
-											green *= cosine;
-											blue *= cosine;
-		
-											redSpec += (DWORD)red;
-											greenSpec += (DWORD)green;
-											blueSpec += (DWORD)blue;
-										}
-									}
-								}
-								else
-								{
-									//Object is in center of light.  BLOW IT OUT!
-									float cosine = 1.0f;
-	
-									float red,green,blue;
-	
-									if (cosine < 0.0f)
-									{
-										cosine = fabs(cosine);
-										red = float((startLight>>16) & 0x000000ff);
-										green = float((startLight>>8) & 0x000000ff);
-										blue = float((startLight) & 0x000000ff);
-	
-										red *= cosine;
-										green *= cosine;
-										blue *= cosine;
-	
-										redSpec += (DWORD)red;
-										greenSpec += (DWORD)green;
-										blueSpec += (DWORD)blue;
-									}
-								}
-							}
-							break;
-								  
-							case TG_LIGHT_TERRAIN:
-							{
-								if (useShadows)
-								{
-									Stuff::Point3D vertexToLight;
-									Stuff::Vector3D pos = theShape->listOfTypeVertices[j].position;
-									RotateLight(pos,yawRotation);
-									vertexToLight.Add(s_lightDir[i],pos);
-									float length = vertexToLight.GetApproximateLength();
+										red = float((startLight>>16) & 0x000000ff) * falloff;
+										green = float((startLight>>8) & 0x000000ff) * falloff;
+										blue = float((startLight) & 0x000000ff) * falloff;
 		
-									if (length > Stuff::SMALL)
-									{	
-										float falloff = 1.0f;
-										if (s_listOfLights[i]->GetFalloff(length, falloff))
-										{
-											float red,green,blue;
-			
-											red = float((startLight>>16) & 0x000000ff) * falloff;
-											green = float((startLight>>8) & 0x000000ff) * falloff;
-											blue = float((startLight) & 0x000000ff) * falloff;
-			
-											listOfColors[j].redSpec = (DWORD)red;
-											listOfColors[j].greenSpec = (DWORD)green;
-											listOfColors[j].blueSpec = (DWORD)blue;
-										}
-									}
-									else
-									{
-										//Object is in center of light.  NOTHING HAPPENS WITH THIS KIND!!!
-										//Light is already burned in!
+										listOfColors[j].redSpec = (DWORD)red;
+										listOfColors[j].greenSpec = (DWORD)green;
+										listOfColors[j].blueSpec = (DWORD)blue;
 									}
 								}
-							}
-							break;
-							
- 							case TG_LIGHT_SPOT:
-							{
-								Stuff::Point3D vertexToLight;
-								vertexToLight = s_lightDir[i];
-								
-								//-------------------------------------------------
-								// Defines the actual spot of light on the ground
-								float length = vertexToLight.GetApproximateLength();
-	
-								//-------------------------------------------------
-								// Defines the REAL direction of the spot light.
-								vertexToLight = s_spotDir[i];
-								if (vertexToLight.GetApproximateLength() > Stuff::SMALL)
-									vertexToLight.Normalize(vertexToLight);
 								else
-									length = 99999999999999.0f;
-	
-								float falloff = 1.0f;
-	
-								if (s_listOfLights[i]->GetFalloff(length, falloff))
 								{
-									float cosine = vertexToLight * (theShape->listOfTypeVertices[j].normal);
-	
-									float red,green,blue;
-	
-									if (cosine < 0.0f)
-									{
-										cosine = fabs(cosine);
-										red = float((startLight>>16) & 0x000000ff) * falloff;
-										green = float((startLight>>8) & 0x000000ff) * falloff;
-										blue = float((startLight) & 0x000000ff) * falloff;
-	
-										red *= cosine;
-										green *= cosine;
-										blue *= cosine;
-	
-										redSpec += (DWORD)red;
-										greenSpec += (DWORD)green;
-										blueSpec += (DWORD)blue;
-									}
+									//Object is in center of light.  NOTHING HAPPENS WITH THIS KIND!!!
+									//Light is already burned in!
 								}
 							}
-							break;
 						}
+						break;
 					}
 				}
+
+				redFinal += xformBlock.redFinal[b];
+				greenFinal += xformBlock.greenFinal[b];
+				blueFinal += xformBlock.blueFinal[b];
+
+				redSpec += xformBlock.redSpec[b];
+				greenSpec += xformBlock.greenSpec[b];
+				blueSpec += xformBlock.blueSpec[b];
 				
 				redFinal += redAmb;
 				blueFinal += blueAmb;
@@ -20,6 +20,10 @@
 #include"file.h"
 #endif
 
+#ifndef TGLXFORM_H
+#include"tglxform.h"
+#endif
+
 #include<stuff/stuff.hpp>
 #include<gameos.hpp>
 
@@ -559,16 +563,22 @@ class TG_TypeShape : public TG_TypeNode
 		HGOSBUFFER				ib_;
 		HGOSVERTEXDECLARATION	vdecl_;
 
+		TG_VertexLanes			vertexLanes;				//SoA copy of listOfTypeVertices for MultiTransformShape.  Built on first use.
+
 	//-----------------
 	//Member Functions
 	protected:
 
+		const TG_VertexLanes &GetVertexLanes (void);
+		void FreeVertexLanes (void);
+
 	public:
 		virtual void init (void)
 		{
 			numTypeVertices = numTypeTriangles = numTextures = 0;
 
 			listOfTypeVertices = NULL;
+			memset(&vertexLanes,0,sizeof(vertexLanes));
 			listOfTypeTriangles = NULL;
 			listOfTextures = NULL;
 
@@ -0,0 +1,320 @@
+//---------------------------------------------------------------------------
+//
+// tglxform.cpp - Batched vertex transform and vertex lighting for TGL shapes
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+//---------------------------------------------------------------------------
+// Include files
+
+#ifndef TGLXFORM_H
+#include"tglxform.h"
+#endif
+
+#include<math.h>
+#include<string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TGL_USE_SSE 1
+#include<emmintrin.h>
+#else
+#define TGL_USE_SSE 0
+#endif
+
+//---------------------------------------------------------------------------
+// The SSE versions do exactly the same float operations in exactly the same
+// order as the Ref versions (which are what MultiTransformShape used to do
+// per vertex) so results match bit for bit.  Keep them that way!
+//---------------------------------------------------------------------------
+DWORD TG_VertexLanesSize (DWORD count)
+{
+	DWORD stride = (count + TG_XFORM_WIDTH - 1) & ~(TG_XFORM_WIDTH - 1);
+	return sizeof(float) * stride * 6;
+}
+
+//---------------------------------------------------------------------------
+void TG_SetVertexLanes (TG_VertexLanes &lanes, void *memory, DWORD count)
+{
+	lanes.count = count;
+	lanes.stride = (count + TG_XFORM_WIDTH - 1) & ~(TG_XFORM_WIDTH - 1);
+
+	memset(memory,0,TG_VertexLanesSize(count));
+
+	float *lane = (float *)memory;
+	lanes.px = lane;	lane += lanes.stride;
+	lanes.py = lane;	lane += lanes.stride;
+	lanes.pz = lane;	lane += lanes.stride;
+	lanes.nx = lane;	lane += lanes.stride;
+	lanes.ny = lane;	lane += lanes.stride;
+	lanes.nz = lane;
+}
+
+//---------------------------------------------------------------------------
+long TG_TransformBlockRef (const TG_XformParams &params, const TG_VertexLanes &lanes, DWORD first, DWORD count, TG_XformBlock &out)
+{
+	long result = 0;
+	for (DWORD k=0;k<count;k++)
+	{
+		DWORD j = first + k;
+
+		float px = lanes.px[j];
+		float py = lanes.py[j];
+		float pz = lanes.pz[j];
+		if (params.scale > 0.0f)
+		{
+			px *= params.scale;
+			py *= params.scale;
+			pz *= params.scale;
+		}
+
+		float x = px * params.m[0][0] + py * params.m[1][0] + pz * params.m[2][0] + params.m[3][0];
+		float y = px * params.m[0][1] + py * params.m[1][1] + pz * params.m[2][1] + params.m[3][1];
+		float z = px * params.m[0][2] + py * params.m[1][2] + pz * params.m[2][2] + params.m[3][2];
+		float w = px * params.m[0][3] + py * params.m[1][3] + pz * params.m[2][3] + params.m[3][3];
+
+		float sx, sy, sz, sw;
+		if (params.perspective)
+		{
+			//---------------------------------------
+			// Perspective Transform
+			float rhw = 1.0f;
+			if (w != 0.0f)
+				rhw = 1.0f / w;
+
+			sx = (x * rhw) * params.viewMulX + params.viewAddX;
+			sy = (y * rhw) * params.viewMulY + params.viewAddY;
+			sz = (z * rhw);
+			sw = fabs(rhw);
+		}
+		else
+		{
+			//---------------------------------------
+			// Parallel Transform
+			sx = (1.0f - x) * params.viewMulX + params.viewAddX;
+			sy = (1.0f - y) * params.viewMulY + params.viewAddY;
+			sz = z;
+			sw = 0.000001f;
+		}
+
+		if ((sx < 0) || (sy < 0) || (sx >= params.viewMulX) || (sy >= params.viewMulY))
+			result |= TG_XFORM_ONE_OFF;
+
+		if ((sx >= 0) && (sy >= 0) && (sx < params.viewMulX) && (sy <= params.viewMulY))
+			result |= TG_XFORM_ONE_ON;
+
+		out.x[k] = sx;
+		out.y[k] = sy;
+		out.z[k] = sz;
+		out.rhw[k] = sw;
+	}
+
+	return result;
+}
+
+//---------------------------------------------------------------------------
+void TG_LightBlockRef (const TG_XformLight *lights, long numLights, const TG_VertexLanes &lanes, DWORD first, DWORD count, TG_XformBlock &out)
+{
+	for (DWORD k=0;k<count;k++)
+	{
+		DWORD j = first + k;
+
+		DWORD redFinal = 0, greenFinal = 0, blueFinal = 0;
+		DWORD redSpec = 0, greenSpec = 0, blueSpec = 0;
+
+		for (long i=0;i<numLights;i++)
+		{
+			float cosine = lights[i].dirX * lanes.nx[j];
+			cosine += lights[i].dirY * lanes.ny[j];
+			cosine += lights[i].dirZ * lanes.nz[j];
+
+			if (cosine < 0.0f)
+			{
+				float cos = fabs(cosine);
+				float red = lights[i].red * cos;
+				float green = lights[i].green * cos;
+				float blue = lights[i].blue * cos;
+
+				if (lights[i].specular)
+				{
+					redSpec += (DWORD)red;
+					greenSpec += (DWORD)green;
+					blueSpec += (DWORD)blue;
+				}
+				else
+				{
+					redFinal += long(red);
+					greenFinal += long(green);
+					blueFinal += long(blue);
+				}
+			}
+		}
+
+		out.redFinal[k] = redFinal;
+		out.greenFinal[k] = greenFinal;
+		out.blueFinal[k] = blueFinal;
+		out.redSpec[k] = redSpec;
+		out.greenSpec[k] = greenSpec;
+		out.blueSpec[k] = blueSpec;
+	}
+}
+
+#if TGL_USE_SSE
+//---------------------------------------------------------------------------
+long TG_TransformBlock (const TG_XformParams &params, const TG_VertexLanes &lanes, DWORD first, DWORD count, TG_XformBlock &out)
+{
+	const __m128 m00 = _mm_set1_ps(params.m[0][0]), m01 = _mm_set1_ps(params.m[0][1]), m02 = _mm_set1_ps(params.m[0][2]), m03 = _mm_set1_ps(params.m[0][3]);
+	const __m128 m10 = _mm_set1_ps(params.m[1][0]), m11 = _mm_set1_ps(params.m[1][1]), m12 = _mm_set1_ps(params.m[1][2]), m13 = _mm_set1_ps(params.m[1][3]);
+	const __m128 m20 = _mm_set1_ps(params.m[2][0]), m21 = _mm_set1_ps(params.m[2][1]), m22 = _mm_set1_ps(params.m[2][2]), m23 = _mm_set1_ps(params.m[2][3]);
+	const __m128 m30 = _mm_set1_ps(params.m[3][0]), m31 = _mm_set1_ps(params.m[3][1]), m32 = _mm_set1_ps(params.m[3][2]), m33 = _mm_set1_ps(params.m[3][3]);
+
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+	const __m128 scale = _mm_set1_ps(params.scale);
+	const __m128 mulX = _mm_set1_ps(params.viewMulX);
+	const __m128 addX = _mm_set1_ps(params.viewAddX);
+	const __m128 mulY = _mm_set1_ps(params.viewMulY);
+	const __m128 addY = _mm_set1_ps(params.viewAddY);
+	const __m128 parallelRhw = _mm_set1_ps(0.000001f);
+	const bool scaled = (params.scale > 0.0f);
+
+	long result = 0;
+	//Lanes are padded, so the last step may run past count.  Those vertices are zero
+	//and never copied out, but must not count towards the on/off screen flags.
+	for (DWORD k=0;k<count;k+=TG_XFORM_WIDTH)
+	{
+		DWORD j = first + k;
+
+		__m128 px = _mm_loadu_ps(lanes.px + j);
+		__m128 py = _mm_loadu_ps(lanes.py + j);
+		__m128 pz = _mm_loadu_ps(lanes.pz + j);
+		if (scaled)
+		{
+			px = _mm_mul_ps(px,scale);
+			py = _mm_mul_ps(py,scale);
+			pz = _mm_mul_ps(pz,scale);
+		}
+
+		__m128 x = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px,m00),_mm_mul_ps(py,m10)),_mm_mul_ps(pz,m20)),m30);
+		__m128 y = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px,m01),_mm_mul_ps(py,m11)),_mm_mul_ps(pz,m21)),m31);
+		__m128 z = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px,m02),_mm_mul_ps(py,m12)),_mm_mul_ps(pz,m22)),m32);
+
+		__m128 sx, sy, sz, sw;
+		if (params.perspective)
+		{
+			__m128 w = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px,m03),_mm_mul_ps(py,m13)),_mm_mul_ps(pz,m23)),m33);
+
+			__m128 wZero = _mm_cmpeq_ps(w,zero);
+			__m128 rhw = _mm_div_ps(one,w);
+			rhw = _mm_or_ps(_mm_and_ps(wZero,one),_mm_andnot_ps(wZero,rhw));
+
+			sx = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(x,rhw),mulX),addX);
+			sy = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(y,rhw),mulY),addY);
+			sz = _mm_mul_ps(z,rhw);
+			sw = _mm_andnot_ps(signBit,rhw);
+		}
+		else
+		{
+			sx = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(one,x),mulX),addX);
+			sy = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(one,y),mulY),addY);
+			sz = z;
+			sw = parallelRhw;
+		}
+
+		_mm_storeu_ps(out.x + k,sx);
+		_mm_storeu_ps(out.y + k,sy);
+		_mm_storeu_ps(out.z + k,sz);
+		_mm_storeu_ps(out.rhw + k,sw);
+
+		__m128 off = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(sx,zero),_mm_cmplt_ps(sy,zero)),
+							   _mm_or_ps(_mm_cmpge_ps(sx,mulX),_mm_cmpge_ps(sy,mulY)));
+		__m128 on = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(sx,zero),_mm_cmpge_ps(sy,zero)),
+							   _mm_and_ps(_mm_cmplt_ps(sx,mulX),_mm_cmple_ps(sy,mulY)));
+
+		int valid = 0x0f;
+		if (count - k < TG_XFORM_WIDTH)
+			valid = (1 << (count - k)) - 1;
+
+		if (_mm_movemask_ps(off) & valid)
+			result |= TG_XFORM_ONE_OFF;
+
+		if (_mm_movemask_ps(on) & valid)
+			result |= TG_XFORM_ONE_ON;
+	}
+
+	return result;
+}
+
+//---------------------------------------------------------------------------
+void TG_LightBlock (const TG_XformLight *lights, long numLights, const TG_VertexLanes &lanes, DWORD first, DWORD count, TG_XformBlock &out)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+
+	for (DWORD k=0;k<count;k+=TG_XFORM_WIDTH)
+	{
+		DWORD j = first + k;
+
+		__m128 nx = _mm_loadu_ps(lanes.nx + j);
+		__m128 ny = _mm_loadu_ps(lanes.ny + j);
+		__m128 nz = _mm_loadu_ps(lanes.nz + j);
+
+		__m128i redFinal = _mm_setzero_si128(), greenFinal = _mm_setzero_si128(), blueFinal = _mm_setzero_si128();
+		__m128i redSpec = _mm_setzero_si128(), greenSpec = _mm_setzero_si128(), blueSpec = _mm_setzero_si128();
+
+		for (long i=0;i<numLights;i++)
+		{
+			__m128 cosine = _mm_mul_ps(_mm_set1_ps(lights[i].dirX),nx);
+			cosine = _mm_add_ps(cosine,_mm_mul_ps(_mm_set1_ps(lights[i].dirY),ny));
+			cosine = _mm_add_ps(cosine,_mm_mul_ps(_mm_set1_ps(lights[i].dirZ),nz));
+
+			__m128 lit = _mm_cmplt_ps(cosine,zero);
+			if (!_mm_movemask_ps(lit))
+				continue;
+
+			__m128 cos = _mm_andnot_ps(signBit,cosine);
+			__m128i litMask = _mm_castps_si128(lit);
+			__m128i red = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(_mm_set1_ps(lights[i].red),cos)),litMask);
+			__m128i green = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(_mm_set1_ps(lights[i].green),cos)),litMask);
+			__m128i blue = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(_mm_set1_ps(lights[i].blue),cos)),litMask);
+
+			if (lights[i].specular)
+			{
+				redSpec = _mm_add_epi32(redSpec,red);
+				greenSpec = _mm_add_epi32(greenSpec,green);
+				blueSpec = _mm_add_epi32(blueSpec,blue);
+			}
+			else
+			{
+				redFinal = _mm_add_epi32(redFinal,red);
+				greenFinal = _mm_add_epi32(greenFinal,green);
+				blueFinal = _mm_add_epi32(blueFinal,blue);
+			}
+		}
+
+		_mm_storeu_si128((__m128i *)(out.redFinal + k),redFinal);
+		_mm_storeu_si128((__m128i *)(out.greenFinal + k),greenFinal);
+		_mm_storeu_si128((__m128i *)(out.blueFinal + k),blueFinal);
+		_mm_storeu_si128((__m128i *)(out.redSpec + k),redSpec);
+		_mm_storeu_si128((__m128i *)(out.greenSpec + k),greenSpec);
+		_mm_storeu_si128((__m128i *)(out.blueSpec + k),blueSpec);
+	}
+}
+
+#else
+//---------------------------------------------------------------------------
+long TG_TransformBlock (const TG_XformParams &params, const TG_VertexLanes &lanes, DWORD first, DWORD count, TG_XformBlock &out)
+{
+	return TG_TransformBlockRef(params,lanes,first,count,out);
+}
+
+//---------------------------------------------------------------------------
+void TG_LightBlock (const TG_XformLight *lights, long numLights, const TG_VertexLanes &lanes, DWORD first, DWORD count, TG_XformBlock &out)
+{
+	TG_LightBlockRef(lights,numLights,lanes,first,count,out);
+}
+#endif
+
+//---------------------------------------------------------------------------
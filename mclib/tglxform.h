@@ -0,0 +1,103 @@
+//---------------------------------------------------------------------------
+//
+// tglxform.h - Batched vertex transform and vertex lighting for TGL shapes
+//
+//				TG_Shape::MultiTransformShape hands blocks of up to
+//				TG_XFORM_BLOCK vertices to these functions instead of
+//				transforming and lighting one vertex at a time.  The vertex
+//				data is read from a structure of arrays copy of the
+//				shape's type vertices so four vertices are done per step.
+//
+//				The Ref functions are the plain C versions.  They are used
+//				when SSE2 is not available and by the tglxformtest tool to
+//				check that both versions give the same answers.
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#ifndef TGLXFORM_H
+#define TGLXFORM_H
+//---------------------------------------------------------------------------
+// Include files
+
+#ifndef DSTD_H
+#include"dstd.h"
+#endif
+
+//---------------------------------------------------------------------------
+// Macro Definitions
+#define TG_XFORM_WIDTH				4			//Vertices per step.  Lanes are padded to this
+#define TG_XFORM_BLOCK				64			//Vertices per call.  MUST be a multiple of TG_XFORM_WIDTH
+
+#define TG_XFORM_ONE_OFF			0x01		//At least one vertex is off screen
+#define TG_XFORM_ONE_ON				0x02		//At least one vertex is on screen
+
+//---------------------------------------------------------------------------
+// Structs
+
+//Structure of arrays copy of a shape's type vertices.
+//Every array holds stride floats, the ones past count are zero.
+struct TG_VertexLanes
+{
+	DWORD			count;
+	DWORD			stride;
+	float			*px, *py, *pz;				//Position
+	float			*nx, *ny, *nz;				//Normal
+};
+
+struct TG_XformParams
+{
+	float			m[4][4];					//ShapeToClip.  m[row][col], vertex is a row vector
+	float			scale;						//shapeScalar, not applied if <= 0
+	float			viewMulX, viewAddX;
+	float			viewMulY, viewAddY;
+	bool			perspective;
+};
+
+//A light whose contribution only depends on the vertex normal.
+//INFINITE lights, and POINT and SPOT lights after the shape
+//relative direction and falloff have been worked out for the frame.
+struct TG_XformLight
+{
+	float			dirX, dirY, dirZ;
+	float			red, green, blue;			//Light color already scaled by falloff
+	bool			specular;					//Adds into the specular sums instead of the diffuse ones
+};
+
+struct TG_XformBlock
+{
+	float			x[TG_XFORM_BLOCK];			//Screen position
+	float			y[TG_XFORM_BLOCK];
+	float			z[TG_XFORM_BLOCK];
+	float			rhw[TG_XFORM_BLOCK];
+
+	DWORD			redFinal[TG_XFORM_BLOCK];	//Diffuse sums, not clamped
+	DWORD			greenFinal[TG_XFORM_BLOCK];
+	DWORD			blueFinal[TG_XFORM_BLOCK];
+	DWORD			redSpec[TG_XFORM_BLOCK];	//Specular sums, not clamped
+	DWORD			greenSpec[TG_XFORM_BLOCK];
+	DWORD			blueSpec[TG_XFORM_BLOCK];
+};
+
+//---------------------------------------------------------------------------
+// Functions
+
+//Bytes needed for the lanes of count vertices
+DWORD TG_VertexLanesSize (DWORD count);
+
+//Points the lanes into memory (TG_VertexLanesSize bytes) and zeroes it.
+void TG_SetVertexLanes (TG_VertexLanes &lanes, void *memory, DWORD count);
+
+//Transforms vertices [first, first + count) to the screen.  first must be a multiple
+//of TG_XFORM_BLOCK and count no more than TG_XFORM_BLOCK.
+//Returns TG_XFORM_ONE_OFF and/or TG_XFORM_ONE_ON.
+long TG_TransformBlock (const TG_XformParams &params, const TG_VertexLanes &lanes, DWORD first, DWORD count, TG_XformBlock &out);
+long TG_TransformBlockRef (const TG_XformParams &params, const TG_VertexLanes &lanes, DWORD first, DWORD count, TG_XformBlock &out);
+
+//Sums the lights for vertices [first, first + count) into the Final and Spec arrays of out.
+void TG_LightBlock (const TG_XformLight *lights, long numLights, const TG_VertexLanes &lanes, DWORD first, DWORD count, TG_XformBlock &out);
+void TG_LightBlockRef (const TG_XformLight *lights, long numLights, const TG_VertexLanes &lanes, DWORD first, DWORD count, TG_XformBlock &out);
+
+//---------------------------------------------------------------------------
+#endif
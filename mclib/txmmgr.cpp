@@ -12,6 +12,12 @@
 // Copyright (C) Microsoft Corporation. All rights reserved.                 //
 //===========================================================================//
 
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+#include<deque>
+#include<vector>
+
 #ifndef TXMMGR_H
 #include"txmmgr.h"
 #endif
@@ -67,6 +73,173 @@ DWORD compressedTextureSize = 0;
 
 #define MAX_SENDDOWN		10002
 
+//----------------------------------------------------------------------
+// TextureStreamer
+//
+// Decoding a cached out texture (LZDecomp and then the TGA decode inside
+// GOS) used to happen right in the middle of renderLists.  Now the draw
+// path queues the node here, worker threads do the decoding and the main
+// thread uploads a few finished ones per frame.
+//
+// Jobs own copies of everything they touch so a node can be flushed or
+// reused while its job is in flight.  The serial catches that case.
+struct TextureStreamJob
+{
+	DWORD					nodeId;
+	DWORD					serial;
+	gos_TextureFormat		key;
+	char					*name;
+	MemoryPtr				packedData;
+	DWORD					packedSize;
+	DWORD					origSize;
+	HGOSDECODEDTEXTURE		decoded;
+
+	TextureStreamJob (void)
+	{
+		nodeId = serial = 0;
+		key = gos_Texture_Solid;
+		name = NULL;
+		packedData = NULL;
+		packedSize = origSize = 0;
+		decoded = NULL;
+	}
+
+	~TextureStreamJob (void)
+	{
+		gos_FreeDecodedTexture(decoded);
+		delete [] packedData;
+		delete [] name;
+	}
+};
+
+class TextureStreamer
+{
+	protected:
+
+		std::vector<std::thread>		workers;
+		std::mutex						lock;
+		std::condition_variable			wakeUp;
+		std::deque<TextureStreamJob*>	requests;
+		std::deque<TextureStreamJob*>	finished;
+		bool							quit;
+
+		void workerLoop (void);
+		static void decode (TextureStreamJob *job);
+
+	public:
+
+		TextureStreamer (long numThreads);
+		~TextureStreamer (void);
+
+		void request (TextureStreamJob *job);
+		TextureStreamJob *popFinished (void);
+};
+
+//----------------------------------------------------------------------
+TextureStreamer::TextureStreamer (long numThreads)
+{
+	quit = false;
+	for (long i=0;i<numThreads;i++)
+		workers.push_back(std::thread(&TextureStreamer::workerLoop,this));
+}
+
+//----------------------------------------------------------------------
+TextureStreamer::~TextureStreamer (void)
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		quit = true;
+	}
+	wakeUp.notify_all();
+
+	for (size_t i=0;i<workers.size();i++)
+		workers[i].join();
+
+	for (size_t i=0;i<requests.size();i++)
+		delete requests[i];
+
+	for (size_t i=0;i<finished.size();i++)
+		delete finished[i];
+}
+
+//----------------------------------------------------------------------
+void TextureStreamer::request (TextureStreamJob *job)
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		requests.push_back(job);
+	}
+	wakeUp.notify_one();
+}
+
+//----------------------------------------------------------------------
+TextureStreamJob *TextureStreamer::popFinished (void)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	if (finished.empty())
+		return NULL;
+
+	TextureStreamJob *job = finished.front();
+	finished.pop_front();
+	return job;
+}
+
+//----------------------------------------------------------------------
+void TextureStreamer::workerLoop (void)
+{
+	for (;;)
+	{
+		TextureStreamJob *job = NULL;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			while (!quit && requests.empty())
+				wakeUp.wait(guard);
+
+			if (quit)
+				return;
+
+			job = requests.front();
+			requests.pop_front();
+		}
+
+		decode(job);
+
+		std::lock_guard<std::mutex> guard(lock);
+		finished.push_back(job);
+	}
+}
+
+//----------------------------------------------------------------------
+void TextureStreamer::decode (TextureStreamJob *job)
+{
+	//-----------------------------------------------------------------
+	// Any failure just leaves decoded NULL.  The main thread then falls
+	// back to the synchronous path which reports the error properly.
+	MemoryPtr fileImage = new BYTE[job->origSize + 1024];
+	long origSize = LZDecomp(fileImage,job->packedData,job->packedSize);
+	if (origSize == (long)job->origSize)
+		job->decoded = gos_DecodeTextureFromMemory(job->key,job->name,fileImage,origSize);
+
+	delete [] fileImage;
+
+	delete [] job->packedData;
+	job->packedData = NULL;
+}
+
+//----------------------------------------------------------------------
+static DWORD makePlaceholder (gos_TextureFormat key, const char *name, DWORD argb)
+{
+	DWORD handle = gos_NewEmptyTexture(key,name,MC_PLACEHOLDER_SIZE,gosHint_DisableMipmap);
+
+	TEXTUREPTR pTextureData;
+	gos_LockTexture(handle, 0, 0, &pTextureData);
+	for (DWORD i=0;i<pTextureData.Width * pTextureData.Height;i++)
+		pTextureData.pTexture[i] = argb;
+	gos_UnLockTexture(handle);
+
+	return(handle);
+}
+
 //------------------------------------------------------
 // Frees up gos_VERTEX manager memory
 void MC_TextureManager::freeVertices(void)
@@ -147,6 +320,29 @@ void MC_TextureManager::start (void)
 	textureStringHeap = new UserHeap;
 	textureStringHeap->init(512000,"TXMString");
 
+	nameBuckets = (long *)systemHeap->Malloc(sizeof(long) * MC_TEXTURE_NAME_BUCKETS);
+	gosASSERT(nameBuckets != NULL);
+	for (long i=0;i<MC_TEXTURE_NAME_BUCKETS;i++)
+		nameBuckets[i] = -1;
+
+	//-----------------------------------------------------------------
+	// Leave one core for the game itself.
+	long numStreamThreads = std::thread::hardware_concurrency() - 1;
+	if (numStreamThreads > MC_MAX_STREAM_THREADS)
+		numStreamThreads = MC_MAX_STREAM_THREADS;
+
+	if (numStreamThreads > 0)
+	{
+		streamer = new TextureStreamer(numStreamThreads);
+
+		placeholderHandle = makePlaceholder(gos_Texture_Solid,"TXMPlaceholder",0xff808080);
+
+		//--------------------------------------------------------------
+		// Grey would show up as solid squares over the see through parts
+		// of keyed and alpha textures, so those get nothing at all.
+		alphaPlaceholderHandle = makePlaceholder(gos_Texture_Alpha,"TXMAlphaPlaceholder",0x00808080);
+	}
+
 	if (!textureManagerInstrumented)
 	{
 		StatisticFormat( "" );
@@ -232,10 +428,26 @@ void MC_TextureManager::destroy (void)
 
 	gos_PopCurrentHeap();
 
+	//------------------------------------------
+	// Stop the workers before the nodes go away.
+	delete streamer;
+	streamer = NULL;
+
+	if (placeholderHandle)
+		gos_DestroyTexture(placeholderHandle);
+	placeholderHandle = 0;
+
+	if (alphaPlaceholderHandle)
+		gos_DestroyTexture(alphaPlaceholderHandle);
+	alphaPlaceholderHandle = 0;
+
 	//------------------------------------------
 	// free SystemHeap Memory
 	systemHeap->Free(masterTextureNodes);
 	masterTextureNodes = NULL;
+
+	systemHeap->Free(nameBuckets);
+	nameBuckets = NULL;
 	
 	systemHeap->Free(masterVertexNodes);
 	masterVertexNodes = NULL;
@@ -940,6 +1152,8 @@ void MC_TextureManager::renderLists (void)
 
 	static bool bSkip = true;
 
+	uploadStreamedTextures(MC_MAX_UPLOADS_PER_FRAME);
+
 	gos_SetRenderState(gos_State_Culling, gos_Cull_CW);
 
     // copy global list of light data into GPU buffer
@@ -1003,7 +1217,7 @@ void MC_TextureManager::renderLists (void)
 				static bool b_old_way = false;
 				if (b_old_way)
 				{
-					gos_SetRenderState(gos_State_Texture, masterTextureNodes[textureIndex].get_gosTextureHandle());
+					gos_SetRenderState(gos_State_Texture, masterTextureNodes[textureIndex].get_gosTextureHandleStreamed());
 					TG_RenderShape* rs = masterHardwareVertexNodes[i].shapes + sh;
 					gos_SetRenderViewport(rs->viewport_[2], rs->viewport_[3], rs->viewport_[0], rs->viewport_[1]);
 
@@ -1014,7 +1228,7 @@ void MC_TextureManager::renderLists (void)
 				}
 				else
 				{
-					DWORD texture = masterTextureNodes[textureIndex].get_gosTextureHandle();
+					DWORD texture = masterTextureNodes[textureIndex].get_gosTextureHandleStreamed();
 					TG_RenderShape* rs = masterHardwareVertexNodes[i].shapes + sh;
 
 					
@@ -1061,12 +1275,12 @@ void MC_TextureManager::renderLists (void)
 
 			if (totalVertices && (totalVertices < MAX_SENDDOWN))
 			{
-				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 				gos_RenderIndexedArray( masterVertexNodes[i].vertices, totalVertices, indexArray, totalVertices );
 			}
 			else if (totalVertices > MAX_SENDDOWN)
 			{
-				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 				
 				//Must divide up vertices into batches of 10,000 each to send down.
 				// Somewhere around 20000 to 30000 it really gets screwy!!!
@@ -1122,12 +1336,12 @@ void MC_TextureManager::renderLists (void)
 
                 if (totalVertices && (totalVertices < MAX_SENDDOWN))
                 {
-                    gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+                    gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
                     gos_RenderIndexedArray( masterVertexNodes[i].vertices, totalVertices, indexArray, totalVertices );
                 }
                 else if (totalVertices > MAX_SENDDOWN)
                 {
-                    gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+                    gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 
                     //Must divide up vertices into batches of 10,000 each to send down.
                     // Somewhere around 20000 to 30000 it really gets screwy!!!
@@ -1162,6 +1376,9 @@ void MC_TextureManager::renderLists (void)
 		gos_SetRenderState(	gos_State_ZWrite, 1);
 	}
 
+	//Cement tiles meet the terrain drawn above at exactly the same depth, keep them after it.
+	gos_DrawBarrier();
+
 	for (int i=0;i<nextAvailableVertexNode;i++)
 	{
 		if ((masterVertexNodes[i].flags & MC2_ISTERRAIN) &&
@@ -1177,12 +1394,12 @@ void MC_TextureManager::renderLists (void)
 	
 			if (totalVertices && (totalVertices < MAX_SENDDOWN))
 			{
-				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 				gos_RenderIndexedArray( masterVertexNodes[i].vertices, totalVertices, indexArray, totalVertices );
 			}
 			else if (totalVertices > MAX_SENDDOWN)
 			{
-				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 				
 				//Must divide up vertices into batches of 10,000 each to send down.
 				// Somewhere around 20000 to 30000 it really gets screwy!!!
@@ -1242,12 +1459,12 @@ void MC_TextureManager::renderLists (void)
 
                 if (totalVertices && (totalVertices < MAX_SENDDOWN))
                 {
-                    gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+                    gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
                     gos_RenderIndexedArray( masterVertexNodes[i].vertices, totalVertices, indexArray, totalVertices );
                 }
                 else if (totalVertices > MAX_SENDDOWN)
                 {
-                    gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+                    gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 
                     //Must divide up vertices into batches of 10,000 each to send down.
                     // Somewhere around 20000 to 30000 it really gets screwy!!!
@@ -1299,12 +1516,12 @@ void MC_TextureManager::renderLists (void)
 		
 				if (totalVertices && (totalVertices < MAX_SENDDOWN))
 				{
-					gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+					gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 					gos_RenderIndexedArray( masterVertexNodes[i].vertices, totalVertices, indexArray, totalVertices );
 				}
 				else if (totalVertices > MAX_SENDDOWN)
 				{
-					gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+					gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 					
 					//Must divide up vertices into batches of 10,000 each to send down.
 					// Somewhere around 20000 to 30000 it really gets screwy!!!
@@ -1365,12 +1582,12 @@ void MC_TextureManager::renderLists (void)
 			
 				if (totalVertices && (totalVertices < MAX_SENDDOWN))
 				{
-					gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+					gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 					gos_RenderIndexedArray( masterVertexNodes[i].vertices, totalVertices, indexArray, totalVertices );
 				}
 				else if (totalVertices > MAX_SENDDOWN)
 				{
-					gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+					gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 					
 					//Must divide up vertices into batches of 10,000 each to send down.
 					// Somewhere around 20000 to 30000 it really gets screwy!!!
@@ -1425,12 +1642,12 @@ void MC_TextureManager::renderLists (void)
 
                 if (totalVertices && (totalVertices < MAX_SENDDOWN))
                 {
-                    gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+                    gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
                     gos_RenderIndexedArray( masterVertexNodes[i].vertices, totalVertices, indexArray, totalVertices );
                 }
                 else if (totalVertices > MAX_SENDDOWN)
                 {
-                    gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+                    gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 
                     //Must divide up vertices into batches of 10,000 each to send down.
                     // Somewhere around 20000 to 30000 it really gets screwy!!!
@@ -1494,12 +1711,12 @@ void MC_TextureManager::renderLists (void)
 			
 			if (totalVertices && (totalVertices < MAX_SENDDOWN))
 			{
-				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 				gos_RenderIndexedArray( masterVertexNodes[i].vertices, totalVertices, indexArray, totalVertices );
 			}
 			else if (totalVertices > MAX_SENDDOWN)
 			{
-				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 				
 				//Must divide up vertices into batches of 10,000 each to send down.
 				// Somewhere around 20000 to 30000 it really gets screwy!!!
@@ -1538,12 +1755,12 @@ void MC_TextureManager::renderLists (void)
 			
 			if (totalVertices && (totalVertices < MAX_SENDDOWN))
 			{
-				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 				gos_RenderIndexedArray( masterVertexNodes[i].vertices, totalVertices, indexArray, totalVertices );
 			}
 			else if (totalVertices > MAX_SENDDOWN)
 			{
-				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 				
 				//Must divide up vertices into batches of 10,000 each to send down.
 				// Somewhere around 20000 to 30000 it really gets screwy!!!
@@ -1586,12 +1803,12 @@ void MC_TextureManager::renderLists (void)
 			
 			if (totalVertices && (totalVertices < MAX_SENDDOWN))
 			{
-				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 				gos_RenderIndexedArray( masterVertexNodes[i].vertices, totalVertices, indexArray, totalVertices );
 			}
 			else if (totalVertices > MAX_SENDDOWN)
 			{
-				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 				
 				//Must divide up vertices into batches of 10,000 each to send down.
 				// Somewhere around 20000 to 30000 it really gets screwy!!!
@@ -1630,12 +1847,12 @@ void MC_TextureManager::renderLists (void)
 			
 			if (totalVertices && (totalVertices < MAX_SENDDOWN))
 			{
-				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 				gos_RenderIndexedArray( masterVertexNodes[i].vertices, totalVertices, indexArray, totalVertices );
 			}
 			else if (totalVertices > MAX_SENDDOWN)
 			{
-				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandle());
+				gos_SetRenderState( gos_State_Texture, masterTextureNodes[masterVertexNodes[i].textureIndex].get_gosTextureHandleStreamed());
 				
 				//Must divide up vertices into batches of 10,000 each to send down.
 				// Somewhere around 20000 to 30000 it really gets screwy!!!
@@ -1699,6 +1916,141 @@ DWORD MC_TextureManager::update (void)
 	return numTexturesFreed;
 }
 
+//----------------------------------------------------------------------
+DWORD MC_TextureManager::hashNodeName (const char *name)
+{
+	//-------------------------------------------------
+	// Case insensitive, like the S_stricmp it replaces.
+	DWORD hash = 2166136261u;
+	for (const char *c = name;*c;c++)
+	{
+		hash ^= (DWORD)tolower((unsigned char)*c);
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+//----------------------------------------------------------------------
+long MC_TextureManager::findTextureNode (const char *textureFullPathName, DWORD uniqueInstance)
+{
+	long i = nameBuckets[hashNodeName(textureFullPathName) & (MC_TEXTURE_NAME_BUCKETS - 1)];
+	while (i != -1)
+	{
+		if ((uniqueInstance == masterTextureNodes[i].uniqueInstance) &&
+			(S_stricmp(masterTextureNodes[i].nodeName,textureFullPathName) == 0))
+		{
+			return i;
+		}
+
+		i = masterTextureNodes[i].nextNameNode;
+	}
+
+	return -1;
+}
+
+//----------------------------------------------------------------------
+void MC_TextureManager::addNodeName (DWORD nodeId)
+{
+	gosASSERT(masterTextureNodes[nodeId].nodeName != NULL);
+
+	DWORD bucket = hashNodeName(masterTextureNodes[nodeId].nodeName) & (MC_TEXTURE_NAME_BUCKETS - 1);
+	masterTextureNodes[nodeId].nextNameNode = nameBuckets[bucket];
+	nameBuckets[bucket] = nodeId;
+}
+
+//----------------------------------------------------------------------
+void MC_TextureManager::removeNodeName (DWORD nodeId)
+{
+	if (!nameBuckets)
+		return;
+
+	long *link = &nameBuckets[hashNodeName(masterTextureNodes[nodeId].nodeName) & (MC_TEXTURE_NAME_BUCKETS - 1)];
+	while (*link != -1)
+	{
+		if (*link == (long)nodeId)
+		{
+			*link = masterTextureNodes[nodeId].nextNameNode;
+			break;
+		}
+
+		link = &(masterTextureNodes[*link].nextNameNode);
+	}
+
+	masterTextureNodes[nodeId].nextNameNode = -1;
+}
+
+//----------------------------------------------------------------------
+void MC_TextureManager::requestStreamedTexture (DWORD nodeId)
+{
+	MC_TextureNode &node = masterTextureNodes[nodeId];
+
+	TextureStreamJob *job = new TextureStreamJob;
+	job->nodeId = nodeId;
+	job->serial = ++lastStreamSerial;
+	if (!job->serial)
+		job->serial = ++lastStreamSerial;		//Zero means nothing pending.
+
+	job->key = node.key;
+	if (node.nodeName)
+	{
+		job->name = new char[strlen(node.nodeName) + 1];
+		strcpy(job->name,node.nodeName);
+	}
+
+	//---------------------------------------------------------
+	// The cache heap is not thread safe and the node may be
+	// flushed before the job runs.  Hand the worker a copy.
+	job->packedSize = node.lzCompSize;
+	job->origSize = node.width & 0x0fffffff;
+	job->packedData = new BYTE[job->packedSize];
+	memcpy(job->packedData,node.textureData,job->packedSize);
+
+	node.pendingLoad = job->serial;
+	streamer->request(job);
+}
+
+//----------------------------------------------------------------------
+void MC_TextureManager::uploadStreamedTextures (DWORD maxUploads)
+{
+	if (!streamer)
+		return;
+
+	for (DWORD n=0;n<maxUploads;n++)
+	{
+		TextureStreamJob *job = streamer->popFinished();
+		if (!job)
+			break;
+
+		MC_TextureNode &node = masterTextureNodes[job->nodeId];
+
+		//-----------------------------------------------------------
+		// Node was flushed, reused or synchronously cached in since.
+		if ((node.pendingLoad != job->serial) || (node.gosTextureHandle != CACHED_OUT_HANDLE))
+		{
+			delete job;
+			continue;
+		}
+
+		node.pendingLoad = 0;
+
+		if (!job->decoded)
+		{
+			//Let the normal path STOP with the real reason.
+			node.get_gosTextureHandle();
+		}
+		else if ((currentUsedTextures < MAX_MC2_GOS_TEXTURES) || flushCache())
+		{
+			node.gosTextureHandle = gos_NewTextureFromDecoded(job->decoded,node.hints);
+			job->decoded = NULL;
+			currentUsedTextures++;
+			node.releaseLowMipHandle();
+		}
+
+		delete job;
+	}
+}
+
 //----------------------------------------------------------------------
 DWORD MC_TextureManager::textureFromMemory (DWORD *data, gos_TextureFormat key, DWORD hints, DWORD width, DWORD bitDepth)
 {
@@ -1768,60 +2120,28 @@ DWORD MC_TextureManager::textureFromMemory (DWORD *data, gos_TextureFormat key,
 //----------------------------------------------------------------------
 DWORD MC_TextureManager::textureInstanceExists (const char *textureFullPathName, gos_TextureFormat key, DWORD hints, DWORD uniqueInstance, DWORD nFlush)
 {
-	long i=0;
-
 	//--------------------------------------
 	// Is this texture already Loaded?
-	for (i=0;i<MC_MAXTEXTURES;i++)
+	long i = findTextureNode(textureFullPathName,uniqueInstance);
+	if (i != -1)
 	{
-		if (masterTextureNodes[i].nodeName)
-		{
-			if (S_stricmp(masterTextureNodes[i].nodeName,textureFullPathName) == 0)
-			{
-				if (uniqueInstance == masterTextureNodes[i].uniqueInstance)
-				{
-					masterTextureNodes[i].numUsers++;
-					return(i);							//Return the texture Node Id Now.
-				}
-				else
-				{
-					//------------------------------------------------
-					// Copy the texture from old Handle to a new one.
-					// Return the NEW handle.
-					//
-					// There should be no code here!!!
-				}
-			}
-		}
+		masterTextureNodes[i].numUsers++;
+		return(i);							//Return the texture Node Id Now.
 	}
+
 	return 0;
 }
 
 //----------------------------------------------------------------------
 DWORD MC_TextureManager::loadTexture (const char *textureFullPathName, gos_TextureFormat key, DWORD hints, DWORD uniqueInstance, DWORD nFlush)
 {
-	long i=0;
-
 	//--------------------------------------
 	// Is this texture already Loaded?
-	for (i=0;i<MC_MAXTEXTURES;i++)
+	long i = findTextureNode(textureFullPathName,uniqueInstance);
+	if (i != -1)
 	{
-		if (masterTextureNodes[i].nodeName && (S_stricmp(masterTextureNodes[i].nodeName,textureFullPathName) == 0))
-		{
-			if (uniqueInstance == masterTextureNodes[i].uniqueInstance)
-			{
-				masterTextureNodes[i].numUsers++;
-				return(i);							//Return the texture Node Id Now.
-			}
-			else
-			{
-				//------------------------------------------------
-				// Copy the texture from old Handle to a new one.
-				// Return the NEW handle.
-				//
-				// There should be no code here!!!
-			}
-		}
+		masterTextureNodes[i].numUsers++;
+		return(i);							//Return the texture Node Id Now.
 	}
 
 	//--------------------------------------------------
@@ -1853,6 +2173,8 @@ DWORD MC_TextureManager::loadTexture (const char *textureFullPathName, gos_Textu
 	gosASSERT(masterTextureNodes[i].nodeName != NULL);
 
 	strcpy(masterTextureNodes[i].nodeName,textureFullPathName);
+	addNodeName(i);
+
 	masterTextureNodes[i].numUsers = 1;
 	masterTextureNodes[i].key = key;
 	masterTextureNodes[i].hints = hints;
@@ -1884,11 +2206,13 @@ DWORD MC_TextureManager::loadTexture (const char *textureFullPathName, gos_Textu
 	//Try reading the RAW data out of the fastFile.
 	// If it succeeds, we just saved a complete compress, decompress and two memcpys!!
 	//
+	MemoryPtr fileImage = NULL;
 	long result = textureFile.readRAW(masterTextureNodes[i].textureData,textureCacheHeap);
 	if (!result)
 	{
 		gosASSERT(txmSize <= MAX_LZ_BUFFER_SIZE);
 		textureFile.read(lzBuffer1,txmSize);
+		fileImage = lzBuffer1;
 
 		textureFile.close();
 
@@ -1911,10 +2235,40 @@ DWORD MC_TextureManager::loadTexture (const char *textureFullPathName, gos_Textu
 
 	masterTextureNodes[i].width = 0xf0000000 + txmSize;
 
+	//----------------------------------------------------------------
+	// Cached out textures are drawn as their low mip while they are
+	// decoded in the background.  Make it now, while we are loading.
+	if (streamer && masterTextureNodes[i].textureData)
+	{
+		if (!fileImage && (LZDecomp(lzBuffer1,(MemoryPtr)masterTextureNodes[i].textureData,masterTextureNodes[i].lzCompSize) == txmSize))
+			fileImage = lzBuffer1;
+
+		if (fileImage)
+			makeLowMip(i,fileImage,txmSize);
+	}
+
  	//-------------------
 	return(i);
 }
 
+//----------------------------------------------------------------------
+void MC_TextureManager::makeLowMip (DWORD nodeId, MemoryPtr fileImage, DWORD fileSize)
+{
+	//-------------------------------------------------------------
+	// TGAs have no mips, so it takes a whole decode.  If anything
+	// fails the node just gets the flat placeholder instead.
+	MC_TextureNode &node = masterTextureNodes[nodeId];
+	HGOSDECODEDTEXTURE decoded = gos_DecodeTextureFromMemory(node.key,node.nodeName,fileImage,fileSize);
+	if (!decoded)
+		return;
+
+	node.lowMip = (DWORD *)textureCacheHeap->Malloc(sizeof(DWORD) * MC_PLACEHOLDER_SIZE * MC_PLACEHOLDER_SIZE);
+	if (node.lowMip)
+		gos_GetDecodedTextureLowMip(decoded,MC_PLACEHOLDER_SIZE,node.lowMip);
+
+	gos_FreeDecodedTexture(decoded);
+}
+
 //----------------------------------------------------------------------
 long MC_TextureManager::saveTexture (DWORD textureIndex, const char *textureFullPathName)
 {
@@ -1990,6 +2344,11 @@ DWORD MC_TextureNode::get_gosTextureHandle (void)	//If texture is not in VidRAM,
 	}
 	else
 	{
+		//------------------------------------------------------------
+		// If a background decode is in flight, it loses.  We need it NOW.
+		pendingLoad = 0;
+		releaseLowMipHandle();
+
 		if ((mcTextureManager->currentUsedTextures >= MAX_MC2_GOS_TEXTURES) && !mcTextureManager->flushCache())
 		{
 			PAUSE(("txmmgr: Out of texture handles!"));
@@ -2055,16 +2414,70 @@ DWORD MC_TextureNode::get_gosTextureHandle (void)	//If texture is not in VidRAM,
 	}
 }
 
+//----------------------------------------------------------------------
+DWORD MC_TextureNode::get_gosTextureHandleStreamed (void)
+{
+	//-------------------------------------------------------------------
+	// Only file images get decoded in the background.  Anything else, or
+	// no streamer at all, goes thru the normal path.
+	if ((gosTextureHandle != CACHED_OUT_HANDLE) || !mcTextureManager->streamer ||
+		(width <= 0xf0000000) || !textureData)
+	{
+		return get_gosTextureHandle();
+	}
+
+	if (!pendingLoad)
+		mcTextureManager->requestStreamedTexture(this - mcTextureManager->masterTextureNodes);
+
+	lastUsed = turn;
+
+	//------------------------------------------------------------------
+	// A low mip upload costs next to nothing, so it goes in right away
+	// and stays until the real texture replaces it.
+	if (lowMip && !lowMipHandle)
+	{
+		lowMipHandle = gos_NewEmptyTexture(key,nodeName,MC_PLACEHOLDER_SIZE,gosHint_DisableMipmap);
+
+		TEXTUREPTR pTextureData;
+		gos_LockTexture(lowMipHandle, 0, 0, &pTextureData);
+		memcpy(pTextureData.pTexture,lowMip,sizeof(DWORD) * MC_PLACEHOLDER_SIZE * MC_PLACEHOLDER_SIZE);
+		gos_UnLockTexture(lowMipHandle);
+	}
+
+	if (lowMipHandle)
+		return lowMipHandle;
+
+	if (key == gos_Texture_Solid)
+		return mcTextureManager->placeholderHandle;
+
+	return mcTextureManager->alphaPlaceholderHandle;
+}
+
+//----------------------------------------------------------------------
+void MC_TextureNode::releaseLowMipHandle (void)
+{
+	if (lowMipHandle)
+		gos_DestroyTexture(lowMipHandle);
+
+	lowMipHandle = 0;
+}
+
 //----------------------------------------------------------------------
 void MC_TextureNode::destroy (void)
 {
+	if (nodeName)
+		mcTextureManager->removeNodeName(this - mcTextureManager->masterTextureNodes);
+
 	if ((gosTextureHandle != CACHED_OUT_HANDLE) && (gosTextureHandle != 0xffffffff) && (gosTextureHandle != 0x0))
 	{
 		gos_DestroyTexture(gosTextureHandle);
 	}
 	
+	releaseLowMipHandle();
+
 	mcTextureManager->textureStringHeap->Free(nodeName);
 	mcTextureManager->textureCacheHeap->Free(textureData);
+	mcTextureManager->textureCacheHeap->Free(lowMip);
 	init();
 }
 
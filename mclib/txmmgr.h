@@ -49,6 +49,11 @@ enum MC_TextureKey
 #define MC_MAXFACES					50000
 #define MAX_LZ_BUFFER_SIZE			((256*256*4) + 1024)
 
+#define MC_TEXTURE_NAME_BUCKETS		2048			//Must be a power of two.
+#define MC_MAX_STREAM_THREADS		4				//Background decode threads for cached out textures.
+#define MC_MAX_UPLOADS_PER_FRAME	8				//Decoded textures handed to GOS per renderLists.
+#define MC_PLACEHOLDER_SIZE			16				//Low mip drawn while a streamed texture is still decoding.
+
 #define MC2_ISTERRAIN				1
 #define MC2_DRAWSOLID				2
 #define MC2_DRAWALPHA				4
@@ -153,6 +158,11 @@ struct MC_TextureNode
 		MC_HardwareVertexArrayNode	*hardwareVertexData2;
 		MC_HardwareVertexArrayNode	*hardwareVertexData3;
 
+		long				nextNameNode;				//Next node in the same name hash bucket.  -1 ends the chain.
+		DWORD				pendingLoad;				//Serial of the background decode in flight for this node.  0 if none.
+		DWORD				*lowMip;					//MC_PLACEHOLDER_SIZE square ARGB copy made at load.  NULL if none.
+		DWORD				lowMipHandle;				//GOS handle of lowMip while the texture streams in.  0 if none.
+
 	void init (void)
 	{
 		gosTextureHandle = 0xffffffff;
@@ -173,6 +183,11 @@ struct MC_TextureNode
 		hardwareVertexData = NULL;
 		hardwareVertexData2 = NULL;
 		hardwareVertexData3 = NULL;
+
+		nextNameNode = -1;
+		pendingLoad = 0;
+		lowMip = NULL;
+		lowMipHandle = 0;
 	}
 
 	DWORD findFirstAvailableBlock (void);
@@ -185,6 +200,10 @@ struct MC_TextureNode
 	
 	DWORD get_gosTextureHandle (void);				//If texture is not in VidRAM, cache a texture out and cache this one in.
 
+	DWORD get_gosTextureHandleStreamed (void);		//Same, but decodes cached out textures in the background
+													//and returns a placeholder until they are ready.  Draw only!
+
+	void releaseLowMipHandle (void);
 };
 
 //---------------------------------------------------------------------------
@@ -327,6 +346,8 @@ struct TG_HWSceneData {
 typedef TG_HWSceneData* TG_HWSceneDataPtr;
 
 //----------------------------------------------------------------------
+class TextureStreamer;
+
 class MC_TextureManager
 {
 	friend struct MC_TextureNode;
@@ -346,6 +367,12 @@ class MC_TextureManager
 													
 		UserHeapPtr						textureCacheHeap;			//Heap used to cache textures from vidCard to system RAM.
 		UserHeapPtr						textureStringHeap;			//Heap used to store filenames of textures so no dupes.
+		long							*nameBuckets;				//Heads of nodeName hash chains, linked thru MC_TextureNode::nextNameNode.
+
+		TextureStreamer					*streamer;					//Decodes cached out textures on worker threads.
+		DWORD							placeholderHandle;			//GOS handle drawn while a texture without a low mip is streaming in.
+		DWORD							alphaPlaceholderHandle;		//Same, but fully transparent, for keyed and alpha textures.
+		DWORD							lastStreamSerial;
 		bool 							textureManagerInstrumented;	//Texture Manager Instrumented.
 		long							totalCacheMisses;			//NUmber of times flush has been called.
 		
@@ -390,6 +417,11 @@ class MC_TextureManager
 
 			textureCacheHeap = NULL;
 			textureStringHeap = NULL;
+			nameBuckets = NULL;
+			streamer = NULL;
+			placeholderHandle = 0;
+			alphaPlaceholderHandle = 0;
+			lastStreamSerial = 0;
 			textureManagerInstrumented = false;
 			totalCacheMisses = 0;
 			currentUsedTextures = 0;
@@ -481,6 +513,21 @@ class MC_TextureManager
 		
         void resetLightData();
 
+	protected:
+		//-----------------------------------------------------------------
+		// Name lookup.  Replaces the linear S_stricmp scans of all nodes.
+		static DWORD hashNodeName (const char *name);
+		long findTextureNode (const char *textureFullPathName, DWORD uniqueInstance);
+		void addNodeName (DWORD nodeId);
+		void removeNodeName (DWORD nodeId);
+
+		//-----------------------------------------------------------------
+		// Background decode of cached out textures.
+		void requestStreamedTexture (DWORD nodeId);
+		void uploadStreamedTextures (DWORD maxUploads);
+		void makeLowMip (DWORD nodeId, MemoryPtr fileImage, DWORD fileSize);
+
+	public:
  		//-----------------------------------------------------------------
 		// Gets gosTextureHandle for Node ID.  Does all caching necessary.
 		DWORD get_gosTextureHandle (DWORD nodeId)
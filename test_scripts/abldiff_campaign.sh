@@ -0,0 +1,28 @@
+#!/bin/sh
+# Runs the campaign's ABL scripts (mission scripts and pilot brains) through
+# abldiff, which compares the expression VM against the token walker.  The VM
+# may only be made the default (ABLVMMode, mclib/ablvm.cpp) while this passes.
+# Run from the game data directory:
+#   abldiff_campaign.sh path/to/abldiff [frames] [seed ...]
+# Each seed is a separate pass with different answers from the library stubs.
+# Exits 1 on any mismatch or on a script which did not load.
+
+ABLDIFF=${1:?usage: $0 path/to/abldiff [frames] [seed ...]}
+FRAMES=${2:-200}
+shift
+[ $# -gt 0 ] && shift
+
+SEEDS="$*"
+if [ -z "$SEEDS" ]; then
+    SEEDS="1 2 3"
+fi
+
+LIBS="-lib data/missions/orders.abx -lib data/missions/miscfunc.abx -lib data/missions/corebrain.abx"
+
+failed=0
+for s in $SEEDS; do
+    echo "seed $s:"
+    "$ABLDIFF" -n "$FRAMES" -s "$s" $LIBS data/missions/*.abl data/missions/profiles/*.abl || failed=1
+done
+
+[ "$failed" -eq 0 ]
@@ -0,0 +1,38 @@
+#!/bin/sh
+# Loads missions headless with -loscheck and sums up the rays where GameMap's
+# LOS heights gave a different answer than the full terrain walk.
+# Run from the game data directory:
+#   loscheck_missions.sh path/to/mc2 [rays] [mission ...]
+# Missions default to the campaign, mc2_01 to mc2_24.  Exits 1 on any mismatch
+# or on a mission which did not report.
+
+MC2=${1:?usage: $0 path/to/mc2 [rays] [mission ...]}
+RAYS=${2:-10000}
+shift
+[ $# -gt 0 ] && shift
+
+MISSIONS="$*"
+if [ -z "$MISSIONS" ]; then
+    MISSIONS=$(seq -f "mc2_%02g" 1 24)
+fi
+
+RESULTS=$(mktemp)
+total=0
+failed=0
+for m in $MISSIONS; do
+    rm -f "$RESULTS"
+    "$MC2" --headless -mission "$m" -maxtime 1 -loscheck "$RAYS" -results "$RESULTS" > /dev/null 2>&1
+    line=$(grep "^losCheck" "$RESULTS" 2>/dev/null)
+    if [ -z "$line" ]; then
+        echo "$m: no losCheck result"
+        failed=1
+        continue
+    fi
+    n=$(echo "$line" | awk '{ print $5 }')
+    echo "$m: $line"
+    total=$((total + n))
+done
+rm -f "$RESULTS"
+
+echo "total mismatches: $total"
+[ "$total" -eq 0 ] && [ "$failed" -eq 0 ]